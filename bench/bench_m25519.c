@@ -0,0 +1,387 @@
+///////////////////////////////////////////////////////////////////////////////
+// bench_m25519.c: Benchmarks of the arithmetic and high-level functions.    //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdio.h>
+#include <string.h>
+#include "cyclecnt.h"
+#include "../src/mpiarith.h"
+#include "../src/gfparith.h"
+#include "../src/moncurve.h"
+#include "../src/tedcurve.h"
+#include "../src/x25519.h"
+#include "../src/ed25519.h"
+
+
+// Number of runs (i.e., measurements) per function; the minimum and median of
+// the measured values are reported
+
+#ifndef BENCH_RUNS
+#define BENCH_RUNS 11
+#endif
+#define BENCH_MAXRUNS 255
+
+// Name of the arithmetic backend that has been compiled in; the C and the ASM
+// version of a function are compared by running the benchmark twice (with and
+// without `M25519_USE_ASM`) and matching the records by function name
+
+#if defined(M25519_OPSTBL)
+#define BENCH_BACKEND "table"
+#elif (defined(M25519_ASSEMBLY) && defined(__riscv_zba) && defined(__riscv_zbs))
+#define BENCH_BACKEND "asm_rvb"
+#elif defined(M25519_ASSEMBLY)
+#define BENCH_BACKEND "asm"
+#elif defined(M25519_HOST64)
+#define BENCH_BACKEND "host64"
+#else
+#define BENCH_BACKEND "c99"
+#endif
+
+
+// The macro `BENCH` executes the statement `stmt` `runs` times, measures each
+// execution with the cycle counter, and prints a record with the results. The
+// overhead of reading the cycle counter is subtracted.
+
+static uint32_t smp[BENCH_MAXRUNS];  // measured values
+static uint32_t ovh = 0;  // overhead of `cyc_read`
+
+#define BENCH(name, runs, stmt) do {       \
+  uint32_t t_;                             \
+  int i_;                                  \
+  for (i_ = 0; i_ < (runs); i_++) {        \
+    t_ = cyc_read();                       \
+    stmt;                                  \
+    smp[i_] = cyc_read() - t_;             \
+  }                                        \
+  bench_report((name), (runs));            \
+} while (0)
+
+
+// Test-vectors for X25519 (RFC 7748, Section 6.1) and Ed25519 (RFC 8032,
+// Section 7.1, TEST 2, key-pair and public key) in little-Endian byte order
+
+static const Byte bsk[32] = {
+  0x77, 0x07, 0x6d, 0x0a, 0x73, 0x18, 0xa5, 0x7d, 0x3c, 0x16, 0xc1, 0x72,
+  0x51, 0xb2, 0x66, 0x45, 0xdf, 0x4c, 0x2f, 0x87, 0xeb, 0xc0, 0x99, 0x2a,
+  0xb1, 0x77, 0xfb, 0xa5, 0x1d, 0xb9, 0x2c, 0x2a
+};
+
+static const Byte bpk[32] = {
+  0xde, 0x9e, 0xdb, 0x7d, 0x7b, 0x7d, 0xc1, 0xb4, 0xd3, 0x5b, 0x61, 0xc2,
+  0xec, 0xe4, 0x35, 0x37, 0x3f, 0x83, 0x43, 0xc8, 0x5b, 0x78, 0x67, 0x4d,
+  0xad, 0xfc, 0x7e, 0x14, 0x6f, 0x88, 0x2b, 0x4f
+};
+
+static const Byte ekp[64] = {
+  0x4c, 0xcd, 0x08, 0x9b, 0x28, 0xff, 0x96, 0xda, 0x9d, 0xb6, 0xc3, 0x46,
+  0xec, 0x11, 0x4e, 0x0f, 0x5b, 0x8a, 0x31, 0x9f, 0x35, 0xab, 0xa6, 0x24,
+  0xda, 0x8c, 0xf6, 0xed, 0x4f, 0xb8, 0xa6, 0xfb, 0x3d, 0x40, 0x17, 0xc3,
+  0xe8, 0x43, 0x89, 0x5a, 0x92, 0xb7, 0x0a, 0xa7, 0x4d, 0x1b, 0x7e, 0xbc,
+  0x9c, 0x98, 0x2c, 0xcf, 0x2e, 0xc4, 0x96, 0x8c, 0xc0, 0xcd, 0x55, 0xf1,
+  0x2a, 0xf4, 0x66, 0x0c
+};
+
+static const Byte epk[32] = {
+  0x3d, 0x40, 0x17, 0xc3, 0xe8, 0x43, 0x89, 0x5a, 0x92, 0xb7, 0x0a, 0xa7,
+  0x4d, 0x1b, 0x7e, 0xbc, 0x9c, 0x98, 0x2c, 0xcf, 0x2e, 0xc4, 0x96, 0x8c,
+  0xc0, 0xcd, 0x55, 0xf1, 0x2a, 0xf4, 0x66, 0x0c
+};
+
+static const Byte emsg[1] = { 0x72 };
+
+static const Byte esig[64] = {
+  0x92, 0xa0, 0x09, 0xa9, 0xf0, 0xd4, 0xca, 0xb8, 0x72, 0x0e, 0x82, 0x0b,
+  0x5f, 0x64, 0x25, 0x40, 0xa2, 0xb2, 0x7b, 0x54, 0x16, 0x50, 0x3f, 0x8f,
+  0xb3, 0x76, 0x22, 0x23, 0xeb, 0xdb, 0x69, 0xda, 0x08, 0x5a, 0xc1, 0xe4,
+  0x3e, 0x15, 0x99, 0x6e, 0x45, 0x8f, 0x36, 0x13, 0xd0, 0xf1, 0x1d, 0x8c,
+  0x38, 0x7b, 0x2e, 0xae, 0xb4, 0x30, 0x2a, 0xee, 0xb0, 0x0d, 0x29, 0x16,
+  0x12, 0xbb, 0x0c, 0x00
+};
+
+
+// Operands of the arithmetic functions; the verification context is large
+// and, therefore, not placed on the stack
+
+static Word opa[LEN], opb[LEN], res[2*LEN], tmp[8*LEN], scr[8*LEN];
+static Word pt0[6*LEN], pt1[3*LEN];
+static Ed25519VCtx vctx;
+
+
+// Sorting of the measured values (insertion sort) and printing of a record in
+// the form "backend,counter,function,runs,min,median,unit"
+
+static void bench_report(const char *name, int runs)
+{
+  uint32_t val, min, med;
+  int i, j;
+  
+  for (i = 1; i < runs; i++) {
+    val = smp[i];
+    for (j = i; (j > 0) && (smp[j-1] > val); j--) smp[j] = smp[j-1];
+    smp[j] = val;
+  }
+  min = (smp[0] > ovh) ? (smp[0] - ovh) : 0;
+  med = (smp[runs/2] > ovh) ? (smp[runs/2] - ovh) : 0;
+  printf("%s,%s,%s,%i,%lu,%lu,%s\n", BENCH_BACKEND, CYC_SOURCE, name, runs, \
+    (unsigned long) min, (unsigned long) med, CYC_UNIT);
+}
+
+
+// Initialization of a field-element with pseudo-random words (xorshift32); the
+// most-significant bit is cleared so that the operands also satisfy the bounds
+// of the non-reducing functions `gfp_add_nr` and `gfp_sub_nr`
+
+static void bench_rand(Word *r, int len)
+{
+  static uint32_t x = 0x12345678UL;
+  int i;
+  
+  for (i = 0; i < len; i++) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    r[i] = (Word) x;
+  }
+  r[len-1] &= 0x7FFFFFFFUL;
+}
+
+
+// Benchmarks of the MPI arithmetic (and of the reduction modulo the group
+// order, which is based on `mpi_mul9`)
+
+static void bench_mpi(int runs)
+{
+  mpi_copy(tmp, opa, LEN);
+  tmp[LEN] = 1;
+  mpi_copy(&tmp[LEN+1], opb, LEN);
+  tmp[2*LEN+1] = 1;
+  BENCH("mpi_copy", runs, mpi_copy(res, opa, LEN));
+  BENCH("mpi_setw", runs, mpi_setw(res, 1, LEN));
+  BENCH("mpi_cmpw", runs, mpi_cmpw(opa, 1, LEN));
+  BENCH("mpi_cmp", runs, mpi_cmp(opa, opb, LEN));
+  BENCH("mpi_add", runs, mpi_add(res, opa, opb, LEN));
+  BENCH("mpi_cadd", runs, mpi_cadd(res, opa, opb, 1, LEN));
+  BENCH("mpi_sub", runs, mpi_sub(res, opa, opb, LEN));
+  BENCH("mpi_shr", runs, mpi_shr(res, opa, LEN));
+  BENCH("mpi_mul", runs, mpi_mul(res, opa, opb, LEN));
+  BENCH("mpi_mul8", runs, mpi_mul8(res, opa, opb));
+  BENCH("mpi_mul9", runs, mpi_mul9(scr, tmp, &tmp[LEN+1]));
+  BENCH("ed25519_mod_order", runs, \
+    ed25519_mod_order(res, scr, &ECDOMPAR25519));
+  BENCH("mpi_select", runs, \
+    mpi_select(res, ECDOMPAR25519.tbl, 5, TED_COMBSIZE, 3*LEN));
+  BENCH("mpi_divsteps", runs, mpi_divsteps(tmp, opa[0] | 1, opb[0], 1));
+}
+
+
+// Benchmarks of the prime-field arithmetic
+
+static void bench_gfp(int runs)
+{
+  int i;
+  
+  BENCH("gfp_setp", runs, gfp_setp(res));
+  BENCH("gfp_cmpp", runs, gfp_cmpp(opa));
+  BENCH("gfp_add", runs, gfp_add(res, opa, opb));
+  BENCH("gfp_add_nr", runs, gfp_add_nr(res, opa, opb));
+  BENCH("gfp_sub", runs, gfp_sub(res, opa, opb));
+  BENCH("gfp_sub_nr", runs, gfp_sub_nr(res, opa, opb));
+  BENCH("gfp_cneg", runs, gfp_cneg(res, opa, 1));
+  BENCH("gfp_hlv", runs, gfp_hlv(res, opa));
+  BENCH("gfp_mul", runs, gfp_mul(res, opa, opb));
+  BENCH("gfp_mul32", runs, gfp_mul32(res, opa, opb));
+  BENCH("gfp_sqr", runs, gfp_sqr(res, opa));
+  BENCH("gfp_sqrn_n10", runs, gfp_sqrn(res, opa, 10));
+  BENCH("gfp_fred", runs, gfp_fred(res, opa));
+  BENCH("gfp_cmp", runs, gfp_cmp(opa, opb));
+  BENCH("gfp_cswap", runs, gfp_cswap(opa, opb, 1));
+  BENCH("gfp_inv", runs, gfp_inv(res, opa));
+  for (i = 0; i < 8; i++) bench_rand(&tmp[i*LEN], LEN);
+  BENCH("gfp_inv_batch_n8", runs, gfp_inv_batch(tmp, tmp, 8, scr));
+  BENCH("gfp_exp_p58", runs, gfp_exp_p58(res, opa));
+}
+
+
+// Benchmarks of the point arithmetic and scalar multiplication
+
+static void bench_ecc(int runs)
+{
+  Point p6 = { 6, pt0 }, p3 = { 3, pt1 }, p2 = { 2, res }, pa = { 2, tmp };
+  const ECDomPar *d = &ECDOMPAR25519;
+  
+  mpi_copy(tmp, opa, LEN);
+  mpi_copy(&tmp[LEN], opb, LEN);
+  mpi_setw(&tmp[2*LEN], 1, LEN);
+  mpi_setw(&tmp[3*LEN], 0, LEN);
+  BENCH("mon_ladder_step", runs, mon_ladder_step(tmp, opa, d->a24, 1));
+  BENCH("ted_load_point", runs, ted_load_point(&p3, d->tbl, 1));
+  BENCH("ted_load_point_ep", runs, ted_load_point_ep(&p6, d->tbl, 1));
+  ted_conv_ea2ep(&p6, &p3);
+  BENCH("ted_add", runs, ted_add(&p6, &p3));
+  BENCH("ted_double", runs, ted_double(&p6));
+  BENCH("ted_conv_p2a", runs, ted_conv_p2a(&p2, &p6, d));
+  BENCH("ted_mul_fixbase", runs, ted_mul_fixbase(&p2, opa, d));
+  BENCH("ted_mul_fixbase_proj", runs, ted_mul_fixbase_proj(&p6, opa, d));
+  mpi_copy(tmp, res, 2*LEN);
+  BENCH("ted_mul_varbase", runs, ted_mul_varbase(&p2, opa, &pa, d));
+  BENCH("ted_mul_dblbase", runs, ted_mul_dblbase(&p2, opa, opb, &pa, d));
+}
+
+
+// Benchmarks of the high-level X25519 and Ed25519 functions
+
+static void bench_hlf(int runs)
+{
+  Byte ss[4][32];
+  Byte *shared[4] = { ss[0], ss[1], ss[2], ss[3] };
+  const Byte *sk[4] = { bsk, bsk, bsk, bsk };
+  const Byte *pk[4] = { bpk, bpk, bpk, bpk };
+  int err[4];
+  X25519Pool pool;
+  Ed25519SCtx sctx;
+  Byte sig[64];
+  
+  BENCH("x25519", runs, x25519_batch(shared, sk, pk, 1, err));
+  BENCH("x25519_batch_n4", runs, x25519_batch(shared, sk, pk, 4, err));
+  x25519_pool_init(&pool);
+  BENCH("x25519_pool_refill", runs, \
+    (x25519_pool_refill(&pool, bsk), x25519_pool_take(&pool, ss[0], ss[1])));
+  BENCH("ed25519_sign", runs, ed25519_sign(sig, emsg, 1, ekp));
+  BENCH("ed25519_sign_ctx_init", runs, \
+    ed25519_sign_ctx_init(&sctx, ekp, NULL));
+  BENCH("ed25519_sign_ctx", runs, ed25519_sign_ctx(sig, emsg, 1, &sctx));
+  ed25519_sign_ctx_wipe(&sctx);
+  BENCH("ed25519_verify", runs, ed25519_verify(esig, emsg, 1, epk));
+  BENCH("ed25519_verify_ctx_init", runs, ed25519_verify_ctx_init(&vctx, epk));
+  BENCH("ed25519_verify_ctx", runs, ed25519_verify_ctx(esig, emsg, 1, &vctx));
+}
+
+
+#if defined(M25519_PROFILE)
+// Number of executed operations of the high-level functions, printed in the
+// form "prof,function,operation,count" (only counters that are not 0)
+
+static void bench_prof_report(const char *name)
+{
+  int i;
+  
+  for (i = 0; i < M25519_PROF_NUM; i++) {
+    if (m25519_prof_get(i) != 0) printf("prof,%s,%s,%lu\n", name, \
+      m25519_prof_name(i), (unsigned long) m25519_prof_get(i));
+  }
+}
+
+
+static void bench_prof(void)
+{
+  Byte ss[32];
+  Byte *shared[1] = { ss };
+  const Byte *sk[1] = { bsk }, *pk[1] = { bpk };
+  Word r[2*LEN];
+  Point p2 = { 2, r };
+  Byte sig[64];
+  
+  printf("# prof,function,operation,count\n");
+  m25519_prof_reset();
+  x25519_batch(shared, sk, pk, 1, NULL);
+  bench_prof_report("x25519");
+  m25519_prof_reset();
+  ted_mul_fixbase(&p2, opa, &ECDOMPAR25519);
+  bench_prof_report("ted_mul_fixbase");
+  m25519_prof_reset();
+  ed25519_sign(sig, emsg, 1, ekp);
+  bench_prof_report("ed25519_sign");
+  m25519_prof_reset();
+  ed25519_verify(esig, emsg, 1, epk);
+  bench_prof_report("ed25519_verify");
+  m25519_prof_reset();
+  ed25519_verify_ctx(esig, emsg, 1, &vctx);
+  bench_prof_report("ed25519_verify_ctx");
+}
+#endif
+
+
+// Execution of all benchmarks with `runs` measurements per function; the
+// return value is 0, or -1 if the number of runs is invalid or the checks of
+// the results of the high-level functions fail (i.e., the benchmark must not
+// be trusted)
+
+#if defined(M25519_OPSTBL)
+// In ops-table mode, the fastest of the built-in kernels are selected with the
+// cycle counter before the benchmarks are executed, and the backend of each
+// installed kernel is printed in records of the form `ops,kernel,backend`
+
+static void bench_ops(void)
+{
+  const char *kname[M25519_KRN_NUM] = { "gfp_add", "gfp_sub", "gfp_cneg", \
+    "gfp_hlv", "gfp_mul", "gfp_mul32", "gfp_sqr" };
+  int k;
+  
+  if (m25519_select_backend(NULL, 0, cyc_read) != M25519_NO_ERROR)
+    printf("# a built-in kernel failed the known-answer test!\n");
+  for (k = 0; k < M25519_KRN_NUM; k++)
+    printf("ops,%s,%s\n", kname[k], m25519_backend_name(k));
+}
+#endif
+
+
+int bench_m25519(int runs)
+{
+  Byte sig[64], diff = 0;
+  int err = 0, i;
+  
+  if ((runs < 1) || (runs > BENCH_MAXRUNS)) return -1;
+  
+  cyc_init();
+  bench_rand(opa, LEN);
+  bench_rand(opb, LEN);
+  printf("backend,counter,function,runs,min,median,unit\n");
+  ovh = 0;
+  BENCH("cyc_read", runs, (void) 0);
+  ovh = smp[0];
+#if defined(M25519_OPSTBL)
+  bench_ops();
+#endif
+  bench_mpi(runs);
+  bench_gfp(runs);
+  bench_ecc(runs);
+  bench_hlf(runs);
+#if defined(M25519_PROFILE)
+  bench_prof();
+#endif
+  
+  // sanity checks of the high-level functions
+  if (ed25519_verify(esig, emsg, 1, epk) != M25519_NO_ERROR) err = -1;
+  if (ed25519_verify_ctx(esig, emsg, 1, &vctx) != M25519_NO_ERROR) err = -1;
+  if (err != 0) printf("# verification of the test signature failed!\n");
+  ed25519_sign(sig, emsg, 1, ekp);
+  for (i = 0; i < 64; i++) diff |= sig[i] ^ esig[i];
+  if (diff != 0) printf("# generation of the test signature failed!\n");
+  if (diff != 0) err = -1;
+  
+  return err;
+}
+
+
+#if !defined(BENCH_NO_MAIN)
+int main(void)
+{
+  return (bench_m25519(BENCH_RUNS) == 0) ? 0 : 1;
+}
+#endif
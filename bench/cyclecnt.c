@@ -0,0 +1,236 @@
+///////////////////////////////////////////////////////////////////////////////
+// cyclecnt.c: Cycle counters of the supported target platforms.             //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// `clock_gettime` is a POSIX function, which is not declared in <time.h> when
+// compiling in strict ISO C99 mode unless the POSIX version is specified.
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "cyclecnt.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+#if defined(CYC_RDCYCLE) //////////// RISC-V: CYCLE CSR ///////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// The `cycle` CSR is read with the `rdcycle` pseudo-instruction, which yields
+// the lower 32 bits of the counter. Some cores (e.g., the Nuclei Bumblebee of
+// the GD32VF103) start with the counter inhibited; in this case, bit 0 of the
+// `mcountinhibit` CSR has to be cleared in machine mode, which is done when
+// `CYC_CLEAR_MCOUNTINHIBIT` is defined.
+
+void cyc_init(void)
+{
+#if defined(CYC_CLEAR_MCOUNTINHIBIT)
+  __asm__ volatile ("csrci 0x320, 1");  // mcountinhibit.CY = 0
+#endif
+}
+
+
+uint32_t cyc_read(void)
+{
+  uint32_t cyc;
+  
+  __asm__ volatile ("rdcycle %0" : "=r" (cyc));
+  return cyc;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+#elif defined(CYC_DWT) ///////// CORTEX-M: DWT CYCLE COUNTER //////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Register addresses of the Data Watchpoint and Trace (DWT) unit and of the
+// Debug Exception and Monitor Control Register (DEMCR), see the ARMv7-M
+// Architecture Reference Manual. The lock access register only exists on some
+// implementations (e.g., Cortex-M7), but writing to it does no harm.
+
+#define DEMCR      (*(volatile uint32_t *) 0xE000EDFCUL)
+#define DWT_CTRL   (*(volatile uint32_t *) 0xE0001000UL)
+#define DWT_CYCCNT (*(volatile uint32_t *) 0xE0001004UL)
+#define DWT_LAR    (*(volatile uint32_t *) 0xE0001FB0UL)
+
+void cyc_init(void)
+{
+  DEMCR |= (1UL << 24);  // TRCENA = 1
+  DWT_LAR = 0xC5ACCE55UL;
+  DWT_CYCCNT = 0;
+  DWT_CTRL |= 1UL;  // CYCCNTENA = 1
+}
+
+
+uint32_t cyc_read(void)
+{
+  return DWT_CYCCNT;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+#elif defined(CYC_AVRTIMER) ////// AVR: TIMER1 WITH OVERFLOW COUNTER //////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// The 16-bit Timer1 is clocked with the CPU clock (i.e., no prescaler) and its
+// overflows are counted in an interrupt service routine, which extends the
+// counter to 32 bits. An overflow that happened while interrupts are disabled
+// in `cyc_read` is detected via the TOV1 flag.
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#if !defined(TIMSK1)  // older devices (e.g., ATmega128)
+#define TIMSK1 TIMSK
+#define TIFR1 TIFR
+#endif
+
+static volatile uint16_t cyc_ovf = 0;
+
+ISR(TIMER1_OVF_vect)
+{
+  cyc_ovf++;
+}
+
+
+void cyc_init(void)
+{
+  TCCR1A = 0;
+  TCCR1B = (1 << CS10);  // normal mode, no prescaler
+  TCNT1 = 0;
+  TIMSK1 |= (1 << TOIE1);
+  sei();
+}
+
+
+uint32_t cyc_read(void)
+{
+  uint8_t sreg = SREG;
+  uint16_t lo, hi;
+  
+  cli();
+  lo = TCNT1;
+  hi = cyc_ovf;
+  if ((TIFR1 & (1 << TOV1)) && (lo < 0x8000)) hi++;
+  SREG = sreg;
+  return (((uint32_t) hi) << 16) | lo;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+#elif defined(CYC_MSPTIMER) //// MSP430: TIMER_A WITH OVERFLOW COUNTER ////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Timer_A0 is clocked with SMCLK in continuous mode and its overflows are
+// counted by an interrupt service routine, similar as on AVR. The counted
+// values correspond to clock cycles only when SMCLK has the same frequency as
+// MCLK, which is the default after reset for most MSP430 devices.
+
+#include <msp430.h>
+
+static volatile uint16_t cyc_ovf = 0;
+
+#if defined(__ICC430__)
+#pragma vector = TIMER0_A1_VECTOR
+__interrupt void cyc_isr(void)
+#else
+void __attribute__((interrupt(TIMER0_A1_VECTOR))) cyc_isr(void)
+#endif
+{
+  if (TA0IV == TA0IV_TAIFG) cyc_ovf++;
+}
+
+
+void cyc_init(void)
+{
+  TA0CTL = TASSEL_2 | MC_2 | TACLR | TAIE;  // SMCLK, continuous mode
+  __enable_interrupt();
+}
+
+
+uint32_t cyc_read(void)
+{
+  uint16_t sr = __get_SR_register();
+  uint16_t lo, hi;
+  
+  __disable_interrupt();
+  lo = TA0R;
+  hi = cyc_ovf;
+  if ((TA0CTL & TAIFG) && (lo < 0x8000)) hi++;
+  if (sr & GIE) __enable_interrupt();
+  return (((uint32_t) hi) << 16) | lo;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+#elif defined(CYC_RDTSC) ///////// X86: TIME-STAMP COUNTER ////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// The time-stamp counter of modern x86 processors runs at a constant rate (the
+// nominal frequency), which can differ from the actual core frequency when
+// frequency scaling or "turbo boost" is active. For stable results, these
+// features should be disabled.
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+void cyc_init(void)
+{
+}
+
+
+uint32_t cyc_read(void)
+{
+  return (uint32_t) __rdtsc();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+#else ///////////////////// OTHER HOSTS: CLOCK_GETTIME ////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// On all other platforms, the monotonic clock of the operating system is read
+// and the measured values are in nanoseconds (see `CYC_UNIT`).
+
+#include <time.h>
+
+void cyc_init(void)
+{
+}
+
+
+uint32_t cyc_read(void)
+{
+  struct timespec ts;
+  
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t) (((uint64_t) ts.tv_sec)*1000000000ULL + ts.tv_nsec);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+#endif ////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,65 @@
+///////////////////////////////////////////////////////////////////////////////
+// cyclecnt.h: Portable access to cycle counters for benchmarking.           //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _CYCLECNT_H
+#define _CYCLECNT_H
+
+#include <stdint.h>
+
+// The cycle counter is selected according to the target platform: `rdcycle`
+// on RISC-V, the DWT cycle counter on Cortex-M (ARMv7-M and higher), Timer1
+// (AVR) or Timer_A (MSP430) extended by an overflow counter, the time-stamp
+// counter (`rdtsc`) on x86 and x86-64, and `clock_gettime` on all other host
+// platforms. In the latter case, the unit of the measured values is not clock
+// cycles but nanoseconds, which is indicated by `CYC_UNIT`.
+
+#if (defined(__riscv) && (__riscv_xlen == 32))
+#define CYC_SOURCE "rdcycle"
+#define CYC_RDCYCLE
+#elif (defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || \
+  defined(__ARM_ARCH_8M_MAIN__))
+#define CYC_SOURCE "dwt"
+#define CYC_DWT
+#elif (defined(__AVR) || defined(__AVR__))
+#define CYC_SOURCE "timer1"
+#define CYC_AVRTIMER
+#elif (defined(__MSP430__) || defined(__ICC430__))
+#define CYC_SOURCE "timera"
+#define CYC_MSPTIMER
+#elif (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+  defined(_M_IX86))
+#define CYC_SOURCE "rdtsc"
+#define CYC_RDTSC
+#else
+#define CYC_SOURCE "clock_gettime"
+#define CYC_CLOCK_GETTIME
+#endif
+
+#if defined(CYC_CLOCK_GETTIME)
+#define CYC_UNIT "ns"
+#else
+#define CYC_UNIT "cycles"
+#endif
+
+// prototypes of functions for accessing the cycle counter
+void cyc_init(void);
+uint32_t cyc_read(void);
+
+#endif
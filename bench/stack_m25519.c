@@ -0,0 +1,355 @@
+///////////////////////////////////////////////////////////////////////////////
+// stack_m25519.c: Peak stack usage of the high-level and API functions.     //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdio.h>
+#include <string.h>
+#include "../src/mpiarith.h"
+#include "../src/gfparith.h"
+#include "../src/moncurve.h"
+#include "../src/tedcurve.h"
+#include "../src/x25519.h"
+#include "../src/ed25519.h"
+
+
+// Size of the painted stack area in bytes; it must be larger than the peak
+// stack usage of every measured function (the batch verification needs the
+// most, see `ed25519_verify_batch`) and smaller than the free stack space of
+// the target
+
+#ifndef STACK_PAINT_BYTES
+#define STACK_PAINT_BYTES 32768
+#endif
+#define STACK_WORDS (STACK_PAINT_BYTES/4)
+#define STACK_PATTERN 0xC5A3E17BUL
+
+// Stack budget in bytes for the functions with a fixed-size RAM footprint and
+// for the batch functions, whose footprint grows with `X25519_MAXBATCH` and
+// `TED_MAXMULTI`; the return value of the program is non-zero when a budget is
+// exceeded (a budget of 0 means no check)
+
+#ifndef STACK_BUDGET
+#define STACK_BUDGET 0
+#endif
+#ifndef STACK_BUDGET_BATCH
+#define STACK_BUDGET_BATCH 0
+#endif
+
+// Name of the arithmetic backend that has been compiled in (the same names as
+// in `bench_m25519.c`)
+
+#if defined(M25519_OPSTBL)
+#define STACK_BACKEND "table"
+#elif (defined(M25519_ASSEMBLY) && defined(__riscv_zba) && defined(__riscv_zbs))
+#define STACK_BACKEND "asm_rvb"
+#elif defined(M25519_ASSEMBLY)
+#define STACK_BACKEND "asm"
+#elif defined(M25519_HOST64)
+#define STACK_BACKEND "host64"
+#else
+#define STACK_BACKEND "c99"
+#endif
+
+// The function for painting and scanning must not be inlined, since its local
+// array has to be placed at the same address of the stack in both calls
+
+#if defined(__GNUC__)
+#define NOINLINE __attribute__((noinline))
+#else
+#define NOINLINE
+#endif
+
+
+// The macro `STACK` fills an area of the stack below the frame of the calling
+// function with a pattern, executes the statement `stmt`, and determines how
+// many bytes of the area have been overwritten. The value measured for an
+// empty statement is subtracted. The statement is executed once before the
+// area is painted so that the lazy binding of C library functions on hosts
+// (e.g., of `memset`, which the compiler may call in `mpi_setw`) is not
+// counted.
+
+static int ovh = 0;  // value for the empty statement
+static int fail = 0;  // number of exceeded budgets
+
+#define STACK(name, budget, stmt) do { \
+  int u_;                              \
+  stmt;                                \
+  (void) stack_area(0);                \
+  stmt;                                \
+  u_ = stack_area(1);                  \
+  stack_report((name), u_, (budget));  \
+} while (0)
+
+
+// Test-vectors for X25519 (RFC 7748, Section 6.1) and Ed25519 (RFC 8032,
+// Section 7.1, TEST 2, key-pair and public key) in little-Endian byte order
+
+static const Byte bsk[32] = {
+  0x77, 0x07, 0x6d, 0x0a, 0x73, 0x18, 0xa5, 0x7d, 0x3c, 0x16, 0xc1, 0x72,
+  0x51, 0xb2, 0x66, 0x45, 0xdf, 0x4c, 0x2f, 0x87, 0xeb, 0xc0, 0x99, 0x2a,
+  0xb1, 0x77, 0xfb, 0xa5, 0x1d, 0xb9, 0x2c, 0x2a
+};
+
+static const Byte bpk[32] = {
+  0xde, 0x9e, 0xdb, 0x7d, 0x7b, 0x7d, 0xc1, 0xb4, 0xd3, 0x5b, 0x61, 0xc2,
+  0xec, 0xe4, 0x35, 0x37, 0x3f, 0x83, 0x43, 0xc8, 0x5b, 0x78, 0x67, 0x4d,
+  0xad, 0xfc, 0x7e, 0x14, 0x6f, 0x88, 0x2b, 0x4f
+};
+
+static const Byte ekp[64] = {
+  0x4c, 0xcd, 0x08, 0x9b, 0x28, 0xff, 0x96, 0xda, 0x9d, 0xb6, 0xc3, 0x46,
+  0xec, 0x11, 0x4e, 0x0f, 0x5b, 0x8a, 0x31, 0x9f, 0x35, 0xab, 0xa6, 0x24,
+  0xda, 0x8c, 0xf6, 0xed, 0x4f, 0xb8, 0xa6, 0xfb, 0x3d, 0x40, 0x17, 0xc3,
+  0xe8, 0x43, 0x89, 0x5a, 0x92, 0xb7, 0x0a, 0xa7, 0x4d, 0x1b, 0x7e, 0xbc,
+  0x9c, 0x98, 0x2c, 0xcf, 0x2e, 0xc4, 0x96, 0x8c, 0xc0, 0xcd, 0x55, 0xf1,
+  0x2a, 0xf4, 0x66, 0x0c
+};
+
+static const Byte epk[32] = {
+  0x3d, 0x40, 0x17, 0xc3, 0xe8, 0x43, 0x89, 0x5a, 0x92, 0xb7, 0x0a, 0xa7,
+  0x4d, 0x1b, 0x7e, 0xbc, 0x9c, 0x98, 0x2c, 0xcf, 0x2e, 0xc4, 0x96, 0x8c,
+  0xc0, 0xcd, 0x55, 0xf1, 0x2a, 0xf4, 0x66, 0x0c
+};
+
+static const Byte emsg[1] = { 0x72 };
+
+static const Byte esig[64] = {
+  0x92, 0xa0, 0x09, 0xa9, 0xf0, 0xd4, 0xca, 0xb8, 0x72, 0x0e, 0x82, 0x0b,
+  0x5f, 0x64, 0x25, 0x40, 0xa2, 0xb2, 0x7b, 0x54, 0x16, 0x50, 0x3f, 0x8f,
+  0xb3, 0x76, 0x22, 0x23, 0xeb, 0xdb, 0x69, 0xda, 0x08, 0x5a, 0xc1, 0xe4,
+  0x3e, 0x15, 0x99, 0x6e, 0x45, 0x8f, 0x36, 0x13, 0xd0, 0xf1, 0x1d, 0x8c,
+  0x38, 0x7b, 0x2e, 0xae, 0xb4, 0x30, 0x2a, 0xee, 0xb0, 0x0d, 0x29, 0x16,
+  0x12, 0xbb, 0x0c, 0x00
+};
+
+
+// Operands and contexts of the measured functions; they are static so that
+// they do not contribute to the stack usage
+
+static Word opa[LEN], opb[LEN], res[2*LEN], tmp[8*LEN];
+static Word pt0[6*LEN], pt1[3*LEN];
+static Byte ss[X25519_MAXBATCH][32], sig[64];
+static const Byte *bskv[X25519_MAXBATCH], *bpkv[X25519_MAXBATCH];
+static Byte *ssv[X25519_MAXBATCH];
+static const Byte *sigv[ED25519_MAXBATCH], *msgv[ED25519_MAXBATCH];
+static const Byte *epkv[ED25519_MAXBATCH];
+static size_t mlenv[ED25519_MAXBATCH];
+static int errv[ED25519_MAXBATCH + X25519_MAXBATCH];
+static Word bscr[ED25519_BATCHWORDS];
+static X25519Pool pool;
+static X25519Ctx xctx;
+static TedFixCtx fctx;
+static TedDblCtx dctx;
+static Ed25519SCtx sctx;
+static Ed25519SStream sstr;
+static Ed25519VStream vstr;
+static Ed25519VCtx vctx;
+
+
+// Initialization of a field-element with pseudo-random words (xorshift32, as
+// in `bench_m25519.c`)
+
+static void stack_rand(Word *r, int len)
+{
+  static uint32_t x = 0x12345678UL;
+  int i;
+  
+  for (i = 0; i < len; i++) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    r[i] = (Word) x;
+  }
+  r[len-1] &= 0x7FFFFFFFUL;
+}
+
+
+// Painting (`scan` = 0) and scanning (`scan` = 1) of the stack area. Both are
+// done by the same function so that the array occupies the same addresses of
+// the stack in both cases. The scan returns the number of bytes from the first
+// overwritten word (seen from the deep end of the stack) to the end of the
+// area, or -1 when the deepest word has been overwritten (i.e., the area was
+// too small or the stack grows upwards). The array is accessed through a
+// pointer to volatile so that the compiler can neither remove the painting
+// nor assume that the array is uninitialized when it is scanned.
+
+static NOINLINE int stack_area(int scan)
+{
+  uint32_t area[STACK_WORDS];
+  volatile uint32_t *p = area;
+  int i;
+  
+  if (scan == 0) {
+    for (i = 0; i < STACK_WORDS; i++) p[i] = STACK_PATTERN;
+    return 0;
+  }
+  for (i = 0; i < STACK_WORDS; i++) {
+    if (p[i] != STACK_PATTERN) break;
+  }
+  
+  return (i == 0) ? -1 : 4*(STACK_WORDS - i);
+}
+
+
+// Printing of a record in the form "backend,method,function,stack,budget,
+// status", where the status is "ok", "over" (budget exceeded), or "overflow"
+// (the painted area was too small)
+
+static void stack_report(const char *name, int used, int budget)
+{
+  const char *status = "ok";
+  
+  if (used < 0) {
+    status = "overflow";
+    fail++;
+  } else {
+    used = (used > ovh) ? (used - ovh) : 0;
+    if ((budget > 0) && (used > budget)) {
+      status = "over";
+      fail++;
+    }
+  }
+  printf("%s,paint,%s,%i,%i,%s\n", STACK_BACKEND, name, used, budget, \
+    status);
+}
+
+
+// Measurement of the field arithmetic and of the scalar multiplications
+
+static void stack_ecc(void)
+{
+  Point p6 = { 6, pt0 }, p3 = { 3, pt1 }, p2 = { 2, res }, pa = { 2, tmp };
+  const ECDomPar *d = &ECDOMPAR25519;
+  
+  STACK("gfp_mul", STACK_BUDGET, gfp_mul(res, opa, opb));
+  STACK("gfp_sqr", STACK_BUDGET, gfp_sqr(res, opa));
+  STACK("gfp_inv", STACK_BUDGET, gfp_inv(res, opa));
+  mpi_copy(tmp, opa, LEN);
+  mpi_copy(&tmp[LEN], opb, LEN);
+  mpi_setw(&tmp[2*LEN], 1, LEN);
+  mpi_setw(&tmp[3*LEN], 0, LEN);
+  STACK("mon_ladder_step", STACK_BUDGET, \
+    mon_ladder_step(tmp, opa, d->a24, 1));
+  ted_load_point(&p3, d->tbl, 1);
+  ted_conv_ea2ep(&p6, &p3);
+  STACK("ted_add", STACK_BUDGET, ted_add(&p6, &p3));
+  STACK("ted_double", STACK_BUDGET, ted_double(&p6));
+  STACK("ted_conv_p2a", STACK_BUDGET, ted_conv_p2a(&p2, &p6, d));
+  STACK("ted_mul_fixbase", STACK_BUDGET, ted_mul_fixbase(&p2, opa, d));
+  mpi_copy(tmp, res, 2*LEN);
+  STACK("ted_mul_varbase", STACK_BUDGET, ted_mul_varbase(&p2, opa, &pa, d));
+  STACK("ted_mul_dblbase", STACK_BUDGET, \
+    ted_mul_dblbase(&p2, opa, opb, &pa, d));
+  STACK("ted_mul_fixbase_step", STACK_BUDGET, \
+    (ted_mul_fixbase_init(&fctx, opa, d), ted_mul_fixbase_step(&fctx, 8, d), \
+    ted_mul_fixbase_final(&p2, &fctx, d)));
+  mpi_copy(tmp, res, 2*LEN);
+  STACK("ted_mul_dblbase_step", STACK_BUDGET, \
+    (ted_mul_dblbase_init(&dctx, opa, opb, &pa, d), \
+    ted_mul_dblbase_step(&dctx, 8, d), ted_mul_dblbase_final(&p2, &dctx, d)));
+}
+
+
+// Measurement of the high-level X25519 and Ed25519 functions
+
+static void stack_hlf(void)
+{
+  int i;
+  
+  for (i = 0; i < X25519_MAXBATCH; i++) {
+    bskv[i] = bsk; bpkv[i] = bpk; ssv[i] = ss[i];
+  }
+  for (i = 0; i < ED25519_MAXBATCH; i++) {
+    sigv[i] = esig; msgv[i] = emsg; epkv[i] = epk; mlenv[i] = 1;
+  }
+  STACK("x25519_step", STACK_BUDGET, (x25519_init(&xctx, bsk, bpk), \
+    x25519_step(&xctx, 16), x25519_final(ss[0], &xctx)));
+  x25519_pool_init(&pool);
+  STACK("x25519_pool_refill", STACK_BUDGET, \
+    (x25519_pool_refill(&pool, bsk), x25519_pool_take(&pool, ss[0], ss[1])));
+  STACK("ed25519_sign", STACK_BUDGET, ed25519_sign(sig, emsg, 1, ekp));
+  STACK("ed25519_sign_ctx_init", STACK_BUDGET, \
+    ed25519_sign_ctx_init(&sctx, ekp, NULL));
+  STACK("ed25519_sign_ctx", STACK_BUDGET, \
+    ed25519_sign_ctx(sig, emsg, 1, &sctx));
+  ed25519_sign_ctx_wipe(&sctx);
+  STACK("ed25519_sign_stream", STACK_BUDGET, (ed25519_sign_init(&sstr, ekp), \
+    ed25519_sign_update(&sstr, emsg, 1), ed25519_sign_commit(&sstr), \
+    ed25519_sign_update(&sstr, emsg, 1), ed25519_sign_final(&sstr, sig)));
+  STACK("ed25519_verify", STACK_BUDGET, ed25519_verify(esig, emsg, 1, epk));
+  STACK("ed25519_verify_stream", STACK_BUDGET, \
+    (ed25519_verify_init(&vstr, esig, epk), \
+    ed25519_verify_update(&vstr, emsg, 1), ed25519_verify_final(&vstr)));
+  STACK("ed25519_verify_ctx_init", STACK_BUDGET, \
+    ed25519_verify_ctx_init(&vctx, epk));
+  STACK("ed25519_verify_ctx", STACK_BUDGET, \
+    ed25519_verify_ctx(esig, emsg, 1, &vctx));
+  // the footprint of the batch functions does not depend on `n`, which means
+  // `x25519_batch` with n = 1 is also the footprint of a single X25519
+  STACK("x25519_batch", STACK_BUDGET_BATCH, \
+    x25519_batch(ssv, bskv, bpkv, 1, errv));
+  STACK("ed25519_verify_batch", STACK_BUDGET_BATCH, \
+    ed25519_verify_batch(sigv, msgv, mlenv, epkv, ED25519_MAXBATCH, errv, \
+    bscr));
+}
+
+
+// RAM footprint of the contexts and tables that an application has to keep
+// outside the stack, printed in the form "ram,type,bytes"
+
+static void stack_ram(void)
+{
+  printf("ram,X25519Ctx,%i\n", (int) sizeof(X25519Ctx));
+  printf("ram,X25519Pool,%i\n", (int) sizeof(X25519Pool));
+  printf("ram,TedFixCtx,%i\n", (int) sizeof(TedFixCtx));
+  printf("ram,TedDblCtx,%i\n", (int) sizeof(TedDblCtx));
+  printf("ram,Ed25519SCtx,%i\n", (int) sizeof(Ed25519SCtx));
+  printf("ram,Ed25519SStream,%i\n", (int) sizeof(Ed25519SStream));
+  printf("ram,Ed25519VStream,%i\n", (int) sizeof(Ed25519VStream));
+  printf("ram,Ed25519VCtx,%i\n", (int) sizeof(Ed25519VCtx));
+  printf("ram,ED25519_BATCHWORDS,%i\n", (int) sizeof(bscr));
+}
+
+
+int stack_m25519(void)
+{
+  int used;
+  
+  stack_rand(opa, LEN);
+  stack_rand(opb, LEN);
+  printf("backend,method,function,stack,budget,status\n");
+  (void) stack_area(0);
+  used = stack_area(1);
+  ovh = (used > 0) ? used : 0;
+  fail = 0;
+  stack_ecc();
+  stack_hlf();
+  stack_ram();
+  if (fail != 0) printf("# %i function(s) exceeded the stack budget!\n", fail);
+  
+  return (fail == 0) ? 0 : -1;
+}
+
+
+#if !defined(STACK_NO_MAIN)
+int main(void)
+{
+  return (stack_m25519() == 0) ? 0 : 1;
+}
+#endif
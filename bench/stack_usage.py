@@ -0,0 +1,171 @@
+###############################################################################
+###### Worst-Case Stack Usage of Micro25519 from GCC's Call-Graph Output ######
+###############################################################################
+
+# Usage: python3 stack_usage.py [options] file.ci [file.ci ...]
+# The `.ci` files are generated by GCC (version 10 or later) when the library
+# is compiled with `-fcallgraph-info=su`; they contain the call graph of each
+# translation unit and the size of the stack frame of every function (the
+# same value as reported by `-fstack-usage`). The worst-case stack usage of a
+# function is the size of its own frame plus the maximum of the worst-case
+# stack usage of its callees. Indirect calls (i.e., the kernels called via
+# the ops table when `M25519_USE_OPS_TABLE` is defined, or the hooks for the
+# second core) are resolved to the maximum over the functions given with
+# `--indirect`, and functions that are not contained in any `.ci` file (e.g.,
+# Assembly functions) are assigned the size given with `--extern`. A record
+# "function,stack,budget,status" is printed for each public function, where
+# the status is "ok", "over" (the budget is exceeded), or "bound" when the
+# value is only a lower bound (dynamic frames, recursion, or unknown callees,
+# which are listed in a comment line). The exit status is 1 when a budget is
+# exceeded or a required value is only a lower bound.
+#
+# Options:
+#   --budget N            stack budget in bytes (default 0, i.e., no check)
+#   --func NAME[,NAME]    only report the given functions
+#   --extern NAME=BYTES   stack usage of an external (e.g., Assembly) function
+#   --indirect NAME[,..]  possible targets of indirect calls
+#   --backend NAME        name printed in the first column (default "c99")
+
+import re
+import sys
+
+NODE = re.compile(r'node: \{ title: "([^"]+)" label: "([^"]*)"(.*)\}')
+EDGE = re.compile(r'edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+FRAME = re.compile(r'\\n(\d+) bytes \(([a-z,]+)\)')
+INDIRECT = "__indirect_call"
+
+# Functions of the C library that the compiler may call for loops that clear
+# or copy arrays; they are leaf functions and counted with 0 bytes unless a
+# value is given with `--extern` (calls of `printf` or `__assert_fail` are
+# not resolved, i.e., the library should be compiled with `-DNDEBUG`)
+LIBC = {"memset": 0, "memcpy": 0, "memmove": 0, "memcmp": 0}
+
+# Kernels of the ops table (see `src/backend.h`)
+OPSKERNELS = ["gfp_add", "gfp_sub", "gfp_cneg", "gfp_hlv", "gfp_mul",
+              "gfp_mul32", "gfp_sqr"]
+
+
+def short_name(title):
+    # local functions have the title "file:name", and GCC appends suffixes
+    # such as `.isra.0` or `.constprop.0` to specialized clones
+    name = title.rsplit(":", 1)[-1]
+    return name.split(".", 1)[0]
+
+
+def read_graph(files):
+    frames, kinds, edges, public = {}, {}, {}, set()
+    for filename in files:
+        with open(filename) as f:
+            for line in f:
+                m = NODE.match(line)
+                if m:
+                    title, label = m.group(1), m.group(2)
+                    fm = FRAME.search(label)
+                    if fm:
+                        frames[title] = int(fm.group(1))
+                        kinds[title] = fm.group(2)
+                        if ":" not in title:
+                            public.add(title)
+                    edges.setdefault(title, set())
+                    continue
+                m = EDGE.match(line)
+                if m:
+                    edges.setdefault(m.group(1), set()).add(m.group(2))
+    return frames, kinds, edges, public
+
+
+class Analysis:
+    def __init__(self, frames, kinds, edges, externs, indirect):
+        self.frames, self.kinds, self.edges = frames, kinds, edges
+        self.externs, self.indirect = externs, indirect
+        self.memo = {}
+
+    def usage(self, title, active):
+        # returns (bytes, path, set of reasons why the value is a lower bound)
+        if title in self.memo:
+            return self.memo[title]
+        if title == INDIRECT:
+            targets = [t for t in self.indirect if t in self.frames
+                       or t in self.externs]
+            if not targets:
+                return (0, [title], {"indirect call"})
+            callees = targets
+            own, notes = 0, set()
+        elif title in self.frames:
+            callees = sorted(self.edges.get(title, ()))
+            own, notes = self.frames[title], set()
+            if self.kinds[title] != "static":
+                notes.add(short_name(title) + " (" + self.kinds[title] + ")")
+        elif title in self.externs:
+            return (self.externs[title], [title], set())
+        else:
+            return (0, [title], {short_name(title) + " (unknown)"})
+        best, path = 0, []
+        for callee in callees:
+            if callee in active:
+                notes.add(short_name(title) + " (recursion)")
+                continue
+            active.add(callee)
+            val, cpath, cnotes = self.usage(callee, active)
+            active.discard(callee)
+            notes |= cnotes
+            if val > best or not path:
+                best, path = val, cpath
+        result = (own + best, [title] + path, notes)
+        # values that depend on the current call path are not memorized
+        if not any(n.endswith("(recursion)") for n in notes):
+            self.memo[title] = result
+        return result
+
+
+def main():
+    args = sys.argv[1:]
+    budget, funcs, externs, backend = 0, None, dict(LIBC), "c99"
+    indirect = list(OPSKERNELS)
+    files = []
+    while args:
+        arg = args.pop(0)
+        if arg == "--budget":
+            budget = int(args.pop(0))
+        elif arg == "--func":
+            funcs = args.pop(0).split(",")
+        elif arg == "--extern":
+            name, val = args.pop(0).split("=")
+            externs[name] = int(val)
+        elif arg == "--indirect":
+            indirect = args.pop(0).split(",")
+        elif arg == "--backend":
+            backend = args.pop(0)
+        else:
+            files.append(arg)
+    if not files:
+        print("usage: python3 stack_usage.py [options] file.ci [file.ci ...]")
+        sys.exit(2)
+    frames, kinds, edges, public = read_graph(files)
+    ana = Analysis(frames, kinds, edges, externs, indirect)
+    names = sorted(public) if funcs is None else funcs
+    fail = 0
+    print("backend,method,function,stack,budget,status")
+    for name in names:
+        if name not in frames:
+            print("# " + name + ": not found in the call graph")
+            fail = 1
+            continue
+        val, path, notes = ana.usage(name, {name})
+        status = "ok"
+        if notes:
+            status = "bound"
+            fail = 1
+        elif budget > 0 and val > budget:
+            status = "over"
+            fail = 1
+        print("%s,callgraph,%s,%i,%i,%s" % (backend, name, val, budget, status))
+        if notes:
+            print("# " + name + ": lower bound due to " + ", ".join(sorted(notes)))
+        if funcs is not None:
+            print("# " + name + ": " + " -> ".join(short_name(t) for t in path))
+    sys.exit(fail)
+
+
+if __name__ == "__main__":
+    main()
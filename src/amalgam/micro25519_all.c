@@ -0,0 +1,7232 @@
+///////////////////////////////////////////////////////////////////////////////
+// micro25519_all.c: All C source files of Micro25519 (amalgamation).        //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// DO NOT EDIT: generated by `test/gen_amalgam.py` from the files in `src`.  //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+///////////////////////////////////////////////////////////////////////////////
+
+#include "micro25519_all.h"
+
+// Specifier for short functions that should be inlined into their callers
+#ifndef M25519_INLINE
+#define M25519_INLINE inline
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+// src/profile.c                                                             //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+// The operation counters are only available when `M25519_PROFILE` is defined
+// in `config.h` (or on the command line of the compiler). Each counter is
+// incremented at the start of the C implementation of the respective function
+// or, for functions with an ASM implementation, by the macro that maps the
+// name of the function to its ASM version (see `gfparith.h`). The counters are
+// plain global variables, which means profiling is not thread-safe and should
+// be used in single-threaded test programs only.
+
+
+
+
+#if defined(M25519_PROFILE)
+
+
+// Counters and their names (i.e., the names of the counted functions)
+
+uint32_t m25519_prof_cnt[M25519_PROF_NUM];
+
+static const char *m25519_prof_str[M25519_PROF_NUM] = {
+  "gfp_add", "gfp_add_nr", "gfp_sub", "gfp_sub_nr", "gfp_cneg", "gfp_hlv",
+  "gfp_mul", "gfp_mul32", "gfp_sqr", "gfp_sqrn", "gfp_inv", "gfp_inv_iter",
+  "mpi_sub", "mpi_shr", "mpi_divsteps", "mon_ladder_step", "mpi_mul8",
+  "mpi_mul9", "mpi_select"
+};
+
+
+// Current value of a counter
+// --------------------------
+// This function returns the current value of the counter with index `id`
+// (i.e., `M25519_PROF_GFP_ADD` to `M25519_PROF_NUM-1`), or 0 when `id` is not
+// a valid index.
+
+uint32_t m25519_prof_get(int id)
+{
+  if ((id < 0) || (id >= M25519_PROF_NUM)) return 0;
+  
+  return m25519_prof_cnt[id];
+}
+
+
+// Name of a counter
+// -----------------
+// This function returns the name of the function counted by the counter with
+// index `id`, or `NULL` when `id` is not a valid index.
+
+const char *m25519_prof_name(int id)
+{
+  if ((id < 0) || (id >= M25519_PROF_NUM)) return (const char *) 0;
+  
+  return m25519_prof_str[id];
+}
+
+
+// Reset of all counters
+// ---------------------
+// This function sets all counters to 0.
+
+void m25519_prof_reset(void)
+{
+  int i;
+  
+  for (i = 0; i < M25519_PROF_NUM; i++) m25519_prof_cnt[i] = 0;
+}
+
+
+#endif  // #if defined(M25519_PROFILE)
+
+///////////////////////////////////////////////////////////////////////////////
+// src/mpiarith.c                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+// A Multi-Precision Integer (MPI) is represented by an array of type `Word`,
+// which is defined in `config.h` as an unsigned 32-bit integer (`uint32_t`),
+// whereby the word with index `0` is the least-significant one. Most of the
+// MPI functions below are not really performance-critical; therefore, their
+// implementation emphasizes flexibility over speed. This means, for example,
+// that the length of the arrays is not fixed but can be passed via parameter
+// `len` to the function. Each function is written such that it can process
+// MPIs of arbitrary length, in steps of `WSIZE` bits.
+
+
+#include <assert.h>  // assert()
+#include <stdio.h>   // printf()
+#include <string.h>  // strlen()
+
+
+// Minimum of two integers
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+// Uppercase letter -> lowercase letter
+#define TOLOWER(a) (((a) <= 'Z') ? ((a) + 32) : (a)) 
+
+
+// Starting with ISO C23 (i.e., ISO/IEC 9899:2024), two's complement is the
+// standard representation for signed integers. However, older revisions of C
+// also allowed signed integers in one's complement and sign-magnitude form,
+// respectively. Some of the arithmetic functions in this file are optimized
+// for (and, thus, require) two's complement representation. The pre-processor
+// statements below check whether the compiler uses the two's complement form
+// (which should be the case for virtually all decent C compilers).
+
+#if ((-1) != ((~1) + 1))
+#error "Compiler does not represent a signed integer in two's complement form!"
+#endif
+
+
+// The result of a right-shift of a signed integer is not specified by the ISO
+// C standard and, therefore, depends on the compiler. However, the majority of
+// modern compilers perform a sign-preserving (i.e., arithmetic) right-shift.
+// Some of the arithmetic functions in this file are optimized for (and, thus,
+// require) the sign to be preserved. The pre-processor statements below check
+// whether the right-shift is an arithmetic or a logical shift. In the latter
+// case (which should be *very* unlikely), the alternative implementations at
+// the bottom of this file can be used.
+
+#if (((-1) >> 1) != (-1))
+#error "Compiler does not right-shift signed integers via an arithmetic shift!"
+#endif
+
+
+// Some utility functions (e.g., the printing fuction `mpi_print`) use arrays
+// allocated on the stack as temporary storage for intermediate results. Since
+// these functions support operands of varying length (specified by the `len`
+// parameter), the actual array-length can be determined only at run-time. The
+// preprocessor statements below set the length of these arrays to either the
+// value of the `len` parameter, making these arrays to Variable-Length Arrays
+// (VLAs), or twice the `LEN` value defined in `config.h`.
+// NOTE: Support of VLAs is a conditional feature of many C compilers and may
+// need to be specifically enabled. For example, in IAR Embedded Workbench for
+// MSP430, VLAs have to be activated in C/C++ Compiler Options -> "Allow VLA".
+
+#ifdef M25519_USE_VLA
+#define _len len  // length parameter
+#else  // temp arrays 
+#define _len (2*LEN)
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+/////// UTILITY FUNCTIONS: INITIALIZATION, COMPARISON, COPYING, PRINTING //////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Conversion of a hex-string to an MPI
+// ------------------------------------
+
+int mpi_from_hex(Word *r, const char *hexstr, int len)
+{
+  Word w = 0;
+  size_t hlen, i = 0, j, m;
+  unsigned char c;
+  
+  // some format checks
+  if (hexstr == NULL) return M25519_ERR_HEXSTR;
+  if ((hlen = strlen(hexstr)) < 3) return M25519_ERR_HEXSTR;
+  if ((hexstr[0] != '0') || (TOLOWER(hexstr[1]) != 'x'))
+    return M25519_ERR_HEXSTR;
+  
+  while ((hlen > 2) && (i < len)) {
+    m = MIN(hlen - 2, 2*sizeof(Word));
+    for (j = hlen - m; j < hlen; j++) {
+      c = (unsigned char) hexstr[j];
+      // the 3 LSBs of 'a' and 'A' are 0b001
+      c = (c <= '9') ? c - '0' : (c & 7) + 9;
+      w = (w << 4) | c;
+    }
+    r[i++] = w;
+    hlen -= m;
+    w = 0;
+  }
+  
+  while (i < len) r[i++] = 0;
+  
+  return M25519_NO_ERROR;
+}
+
+
+// Conversion of an MPI to a hex-string
+// ------------------------------------
+
+void mpi_to_hex(char *hexstr, const Word *a, int len)
+{
+  Word w;
+  size_t hlen, i = 0, j;
+  unsigned char c;
+
+  hexstr[0] = '0';
+  hexstr[1] = 'x';
+  hlen = 1 + len*(sizeof(Word) << 1);
+  hexstr[hlen+1] = '\0';
+  
+  while ((hlen >= 2) && (i < len)) {
+    w = a[i++];  // from a[0] to a[len-1]
+    for (j = 0; j < 2*sizeof(Word); j++) {
+      c = ((unsigned char) w) & 0xf;
+      // replace 55 by 87 for lowercase letters
+      hexstr[hlen-j] = c + ((c < 10) ? 48 : 55);
+      w >>= 4;  // go to next nibble
+    }
+    hlen -= j;
+  }
+}
+
+
+// Printing of an MPI as hex-string to `stdout`
+// --------------------------------------------
+
+void mpi_print(const char *prefix, const Word *a, int len)
+{
+  char hexstr[(WSIZE/4)*_len+3];
+  
+  if ((prefix != NULL) && (strlen(prefix) > 0)) printf("%s", prefix);
+  mpi_to_hex(hexstr, a, len);
+  printf("%s", hexstr);
+  printf("\n");
+}
+
+
+// Initialization of an MPI with a word: $r = [0, \ldots, 0, a]$
+// -------------------------------------------------------------
+
+M25519_INLINE void mpi_setw(Word *r, Word a, int len)
+{
+  int i;
+  
+  for (i = len - 1; i > 0; i--) r[i] = 0;
+  r[0] = a;
+}
+
+
+// Comparison of an MPI with a word: $a \stackrel{?}{=} [0, \ldots, 0, b]$
+// -----------------------------------------------------------------------
+
+M25519_INLINE int mpi_cmpw(const Word *a, Word b, int len)
+{
+  Word is0 = 0;
+  int i, r = 0;
+  
+  for (i = len - 1; i > 0; i--) is0 |= a[i];
+  r += ((b > a[0]) | (is0 != 0));
+  r -= ((b < a[0]) & (is0 == 0));
+  
+  return r;  // r = 0 if a equals [0,..,0,b]
+}
+
+
+// Comparison of two MPIs: $a \stackrel{?}{=} b$
+// ---------------------------------------------
+
+int mpi_cmp(const Word *a, const Word *b, int len)
+{
+  Word lt = 0, gt = 0;  // less-than, greater-than
+  int i, r = 0;
+  
+  assert(len <= WSIZE);
+  
+  for (i = len - 1; i >= 0; i--) {
+    lt = (lt << 1) | (a[i] < b[i]);
+    gt = (gt << 1) | (a[i] > b[i]);
+  }
+  r += (gt > lt);  // r = +1 if a is greater than b
+  r -= (lt > gt);  // r = -1 of a is less than b
+  
+  return r;  // r = 0 if a equals b
+}
+
+
+// Copying an MPI: $r = a$
+// -----------------------
+
+M25519_INLINE void mpi_copy(Word *r, const Word *a, int len)
+{
+  int i;
+  
+  for (i = len - 1; i >= 0; i--) r[i] = a[i];
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+////////////// MULTI-PRECISION ARITHMETIC AND LOGICAL OPERATIONS //////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Addition of two MPIs: $r = a + b$
+// ---------------------------------
+
+int mpi_add(Word *r, const Word *a, const Word *b, int len)
+{
+  DWord sum = 0;
+  int i;
+  
+  for (i = 0; i < len; i++) {
+    sum += (DWord) a[i] + b[i];
+    r[i] = (Word) sum;
+    sum >>= WSIZE;
+  }
+  
+  return (int) sum;  // carry bit
+}
+
+
+// Conditional addition of an MPI to another MPI: $r = a + b$ or $r = a$
+// ---------------------------------------------------------------------
+
+int mpi_cadd(Word *r, const Word *a, const Word *b, int add, int len)
+{
+  DWord sum = 0;
+  Word mask = 0 - (add & 1);  // 0 or all-1
+  int i;
+  
+  for (i = 0; i < len; i++) {
+    sum += (DWord) a[i] + (b[i] & mask);
+    r[i] = (Word) sum;
+    sum >>= WSIZE;
+  }
+  
+  return (int) sum;  // carry bit
+}
+
+
+// Multiplication of two MPIs: $r = a \times b$
+// --------------------------------------------
+
+void mpi_mul(Word *r, const Word *a, const Word *b, int len)
+{
+  DWord prod = 0;
+  int i, j;
+  
+  assert((r != a) && (r != b));
+  
+  // multiplication of A by b[0]
+  for (j = 0; j < len; j++) {
+    prod += (DWord) a[j]*b[0];
+    r[j] = (Word) prod;
+    prod >>= WSIZE;
+  }
+  r[j] = (Word) prod;
+  
+  // multiplication of A by b[i] for 1 <= i < len
+  for (i = 1; i < len; i++) {
+    prod = 0;
+    for (j = 0; j < len; j++) {
+      prod += (DWord) a[j]*b[i];
+      prod += r[i+j];
+      r[i+j] = (Word) prod;
+      prod >>= WSIZE;
+    }
+    r[i+j] = (Word) prod;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+#if !defined(M25519_ASSEMBLY) // PERFORMANCE-CRITICAL A/L OPERATIONS //////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// The following functions are performance-critical since they are executed in
+// the main loop of the inversion in GF(p) based on the EEA or, in the case of
+// `mpi_divsteps`, the constant-time inversion based on Bernstein-Yang divsteps
+// (see `M25519_SAFEGCD_INV` in `config.h`), or, in the case of `mpi_mul8` and
+// `mpi_mul9`, in the arithmetic modulo the group order of Edwards25519, and,
+// in the case of `mpi_select`, in the table look-ups of the scalar
+// multiplications on Edwards25519. In
+// addition to the C versions, there exist also highly-optimized Assembly
+// versions of these functions (for certain target architectures like AVR,
+// MSP430, ARMv6-M, ARMv7-M or RV32IM); the Assembly versions of the last four
+// functions are only available for RV32IM (see `M25519_ASSEMBLY_EXT`).
+
+
+// 1-bit right-shift of an MPI: $r = a \gg 1$
+// ------------------------------------------
+
+int mpi_shr(Word *r, const Word *a, int len)
+{
+  int i, retval;
+  
+  M25519_PROF_INC(MPI_SHR);
+  retval = a[0] & 1;  // return value
+  for (i = 0; i < len - 1; i++) r[i] = (a[i+1] << (WSIZE - 1)) | (a[i] >> 1);
+  r[len-1] = a[len-1] >> 1;
+  
+  return retval;
+}
+
+
+// Subtraction of an MPI from another MPI: $r = a - b$
+// ---------------------------------------------------
+
+int mpi_sub(Word *r, const Word *a, const Word *b, int len)
+{
+  DWord dif = 1;
+  int i;
+  
+  M25519_PROF_INC(MPI_SUB);
+  for (i = 0; i < len; i++) {
+    dif += (DWord) a[i] + (~b[i]);
+    r[i] = (Word) dif;
+    dif >>= WSIZE;
+  }
+  
+  return (1 - ((int) dif));  // borrow bit
+}
+
+
+#endif  // #if !defined(M25519_ASSEMBLY)
+#if !defined(M25519_ASSEMBLY_EXT)
+
+
+// Batch of $WSIZE-2$ constant-time divsteps on the lowest words of $f$ and $g$
+// ----------------------------------------------------------------------------
+
+int mpi_divsteps(Word *t, Word f0, Word g0, int zeta)
+{
+  Word u = 1, v = 0, q = 0, r = 1;
+  Word f = f0, g = g0, x, y, z, mask1, mask2;
+  int32_t zt = (int32_t) zeta;
+  int i;
+  
+  M25519_PROF_INC(MPI_DIVSTEPS);
+  for (i = 0; i < WSIZE - 2; i++) {
+    mask1 = (Word) (zt >> 31);  // all-1 if zeta < 0
+    mask2 = 0 - (g & 1);        // all-1 if g is odd
+    // conditional negation of f, u, v
+    x = (f ^ mask1) - mask1;
+    y = (u ^ mask1) - mask1;
+    z = (v ^ mask1) - mask1;
+    // conditional addition of (-)f, u, v to g, q, r
+    g += x & mask2;
+    q += y & mask2;
+    r += z & mask2;
+    // mask1 is all-1 if zeta < 0 and g is odd
+    mask1 &= mask2;
+    zt = (zt ^ ((int32_t) mask1)) - 1;
+    // conditional addition of g, q, r to f, u, v
+    f += g & mask1;
+    u += q & mask1;
+    v += r & mask1;
+    // halving of g (resp., doubling of u, v)
+    g >>= 1;
+    u <<= 1;
+    v <<= 1;
+  }
+  t[0] = u; t[1] = v;
+  t[2] = q; t[3] = r;
+  
+  return (int) zt;
+}
+
+
+// Multiplication of two 8-word MPIs: $r = a \times b$
+// ---------------------------------------------------
+// The 16-word product is not reduced. The array `r` must not overlap with `a`
+// or `b`.
+
+void mpi_mul8(Word *r, const Word *a, const Word *b)
+{
+  M25519_PROF_INC(MPI_MUL8);
+  mpi_mul(r, a, b, LEN);
+}
+
+
+// Multiplication of two 9-word MPIs: $r = a \times b$
+// ---------------------------------------------------
+// The 18-word product is not reduced. The array `r` must not overlap with `a`
+// or `b`.
+
+void mpi_mul9(Word *r, const Word *a, const Word *b)
+{
+  M25519_PROF_INC(MPI_MUL9);
+  mpi_mul(r, a, b, LEN + 1);
+}
+
+
+// Constant-time selection of an MPI from a table: $r = \mathrm{Tbl}[i]$
+// ---------------------------------------------------------------------
+// The table `tbl` consists of `num` MPIs of `len` words each. All MPIs of the
+// table are read and the one with index `idx` is selected via AND-masks, so
+// that neither the memory-access pattern nor the execution time depends on
+// `idx`, which must be in the range [0, `num`-1]. The MPIs are processed in
+// blocks of four words, which are accumulated in local variables (i.e., in
+// registers) so that each word of the table is loaded exactly once and each
+// word of `r` is written exactly once. `len` must be a multiple of 4 (and a
+// multiple of 8 for the Assembly versions).
+
+void mpi_select(Word *r, const Word *tbl, int idx, int num, int len)
+{
+  Word mask, w[4];
+  int i, j, k;
+  
+  M25519_PROF_INC(MPI_SELECT);
+  for (j = 0; j < len; j += 4) {
+    w[0] = w[1] = w[2] = w[3] = 0;
+    for (i = 0; i < num; i++) {
+      mask = (Word) (i ^ idx);  // mask is 0 if i equals idx
+      mask = 0 - ((mask - 1) >> (WSIZE - 1));  // all-1 if i equals idx
+      for (k = 0; k < 4; k++) w[k] |= (tbl[i*len+j+k] & mask);
+    }
+    for (k = 0; k < 4; k++) r[j+k] = w[k];
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+#endif /////////// ADDITIONAL OR ALTERNATIVE IMPLEMENTATIONS //////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+// Multiplication of an MPI by a 32-bit value: $r = a \cdot b$
+// -----------------------------------------------------------
+
+void mpi_mul32(Word *r, const Word *a, const Word *b, int len)
+{
+  DWord prod = 0;
+  int i;
+  
+  // multiplication of A by b[0] (to avoid r <- 0)
+  for (i = 0; i < len; i++) {
+    prod += (DWord) a[i]*b[0];
+    r[i] = (Word) prod;
+    prod >>= WSIZE;
+  }
+  r[i] = (Word) prod;
+}
+
+
+// Squaring of an MPI: $r = a^2$
+// -----------------------------
+
+void mpi_sqr(Word *r, const Word *a, int len)
+{
+  DWord prod = 0, sum = 0;
+  int i, j;
+  
+  assert(r != a);
+  
+  // multiplication of A[1,...,len-1] by a[0] (to avoid r <- 0)
+  r[0] = 0;
+  for (j = 1; j < len; j++) {
+    prod += (DWord) a[j]*a[0];
+    r[j] = (Word) prod;
+    prod >>= WSIZE;
+  }
+  r[j] = (Word) prod;
+  
+  // multiplication of A[i+1,...,len-1] by a[i] for 1 <= i < len
+  for (i = 1; i < len; i++) {
+    prod = 0;
+    for (j = i + 1; j < len; j++) {
+      prod += (DWord) a[j]*a[i];
+      prod += r[i+j];
+      r[i+j] = (Word) prod;
+      prod >>= WSIZE;
+    }
+    r[i+j] = (Word) prod;
+  }
+  
+  // double existing result, add squares a[i]^2 for 0 <= i < len
+  for (i = 0; i < len; i++) {
+    prod = (DWord) a[i]*a[i];
+    sum += (Word) prod;
+    sum += (DWord) r[2*i] + r[2*i];
+    r[2*i] = (Word) sum;
+    sum >>= WSIZE;
+    sum += ((Word) (prod >> WSIZE));
+    sum += (DWord) r[2*i+1] + r[2*i+1];
+    r[2*i+1] = (Word) sum;
+    sum >>= WSIZE;
+  }
+}
+*/
+
+#undef MIN
+#undef TOLOWER
+#undef _len
+
+///////////////////////////////////////////////////////////////////////////////
+// src/gfparith.c                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+// Each arithmetic function below operates in a prime field GF(p) given by a
+// pseudo-Mersenne $p = 2^k - c$, namely the prime with $k = 255$ and $c = 19$.
+// An element of this field is represented as an array of type `Word`, which is
+// defined in `config.h` as an unsigned 32-bit integer (`uint32_t`), whereby
+// the word with index `0` is the least-significant one. These arrays have a
+// fixed length of eight words and can, therefore, accommodate up to 256 bits.
+
+// Each arithmetic function accepts incompletely reduced operands as inputs,
+// i.e., a field-element does not necessarily need to be the least non-negative
+// residue modulo $p$. In fact, the functions can handle any input in the range
+// $[0, 2^{256}-1]$ properly. The result of an arithmetic function is also not
+// necessarily fully reduced but is guaranteed to be in the range $[0, 2p-1]$,
+// which means that the least non-negative residue can be obtained by (at most)
+// one subtraction of $p$.
+
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+
+// All-1 Mask: 0xFFFFFFFF
+#define ALL1MASK ((Word) -1L)
+// MSB-1 Mask: 0x80000000
+#define MSB1MASK ((Word) (1UL << (WSIZE - 1)))
+// MSB-0 Mask: 0x7FFFFFFF
+#define MSB0MASK (ALL1MASK >> 1)
+// Minus-4 Mask: 0xFFFFFFFC
+#define MIN4MASK ((Word) -4L)
+// 4*p[LEN-1]: 0x1FFFFFFFC (33 bits long)
+#define FOURXPHI (((DWord) MSB0MASK) << 2)
+// 4*p[i], 1 <= i < len-1: 0x3FFFFFFFC (34 bits long)
+#define FOURXPMI (((DWord) ALL1MASK) << 2)
+// 4*p[0]: 0x3FFFFFFB4 (34 bits long)
+#define FOURXPLO (((DWord) (ALL1MASK - (CONSTC - 1))) << 2)
+
+// Maximum of two integers
+#define MAX(a, b) (((a) >= (b)) ? (a) : (b))
+
+
+// Starting with ISO C23 (i.e., ISO/IEC 9899:2024), two's complement is the
+// standard representation for signed integers. However, older revisions of C
+// also allowed signed integers in one's complement and sign-magnitude form,
+// respectively. Some of the arithmetic functions in this file are optimized
+// for (and, thus, require) two's complement representation. The pre-processor
+// statements below check whether the compiler uses the two's complement form
+// (which should be the case for virtually all decent C compilers).
+
+#if ((-1) != ((~1) + 1))
+#error "Compiler does not represent a signed integer in two's complement form!"
+#endif
+
+
+// The result of a right-shift of a signed integer is not specified by the ISO
+// C standard and, therefore, depends on the compiler. However, the majority of
+// modern compilers perform a sign-preserving (i.e., arithmetic) right-shift.
+// Some of the arithmetic functions in this file are optimized for (and, thus,
+// require) the sign to be preserved. The pre-processor statements below check
+// whether the right-shift is an arithmetic or a logical shift. In the latter
+// case (which should be *very* unlikely), the alternative implementations at
+// the bottom of this file can be used.
+
+#if (((-1) >> 1) != (-1))
+#error "Compiler does not right-shift signed integers via an arithmetic shift!"
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+/////////// SIMPLE (NON-PERFORMANCE-CRITICAL) PRIME-FIELD OPERATIONS //////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Initialization of a field-element with p: $r = p$
+// -------------------------------------------------
+// This function sets a field-element to the prime $p = 2^k - c$.
+
+void gfp_setp(Word *r)
+{
+  int i;
+
+  r[LEN-1] = MSB0MASK;  // 0x7FFFFFFF
+  for (i = LEN - 2; i > 0; i--) r[i] = ALL1MASK;  // 0xFFFFFFFF
+  r[0] = (Word) (0 - CONSTC);
+}
+
+
+// Comparison of a field-element with p: $a \stackrel{?}{=} p$
+// -----------------------------------------------------------
+// This function compares a (potentially incompletely reduced) field-element
+// with the prime $p = 2^k - c$. The return value is `1` when $a > p$, `0` when
+// $a = p$, or `-1` when $a < p$. The comparison is implemented with the goal
+// of having constant (i.e., operand-independent) execution time.
+
+int gfp_cmpp(const Word *a)
+{
+  Word lt = 0, gt = 0;  // less-than, greater-than
+  int i, r = 0;
+
+  // assert(len <= WSIZE);
+  
+  lt = (a[LEN-1] < MSB0MASK);  // 0x7FFFFFFF
+  gt = (a[LEN-1] > MSB0MASK);  // 0x7FFFFFFF
+  
+  for (i = LEN - 2; i > 0; i--) {
+    lt = (lt << 1) | (a[i] < ALL1MASK);  // 0xFFFFFFFF
+    gt = (gt << 1);
+  }
+  lt = (lt << 1) | (a[0] < (Word) (0 - CONSTC));  // 2's comp
+  gt = (gt << 1) | (a[0] > (Word) (0 - CONSTC));  // 2's comp
+  
+  r += (gt > lt);  // r = +1 if a is greater than p
+  r -= (lt > gt);  // r = -1 if a is less than p
+  
+  return r;  // r = 0 if a equals p
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//////////////////// PERFORMANCE-CRITICAL PRIME-FIELD OPERATIONS //////////////
+#if ((!defined(M25519_ASSEMBLY) && !defined(M25519_HOST64)) || \
+     defined(M25519_OPSTBL)) //////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// The following functions are performance-critical since they are executed in
+// the main loop of a scalar multiplication algorithm (e.g., Montgomery ladder
+// or fixed-base comb method) or the main loop of the inversion in GF(p) based
+// on the extended Euclidean algorithm. In addition to the C implementations,
+// there exist also highly-optimized Assembly versions of these functions (for
+// certain target architectures like AVR, MSP430, ARMv7-M or RV32IM) and a
+// 64-bit C implementation for x86-64 and AArch64 in `host64/gfparith51.c`.
+// In ops-table mode (`M25519_OPSTBL`), the C functions are always compiled
+// and are part of the C99 backend, even when Assembly versions are available.
+// Their names are put in parentheses so that the function-like macros that
+// call the kernels via the ops table (see `gfparith.h`) are not expanded.
+
+
+#if !defined(M25519_C_UNROLLED)  // rolled (size-optimized) variants
+
+
+// Addition of two field-elements: $r = a + b \bmod p$
+// ---------------------------------------------------
+// A straightforward approach for addition in GF(p) consists of a conventional
+// long-integer addition, followed by a subtraction of $p$ if the sum is bigger
+// than or equal to $p$. However, a scalable (or size-optimized) implementation
+// of this approach requires executing two loops. To avoid the second loop, an
+// implementation has to start the addition at the two most-significant words
+// and integrate the reduction modulo $p$ in the addition. More concretely, the
+// sum of a[len-1] and b[len-1] is split up into a $WSIZE-1$-bit lower part and
+// an upper part that is at most 2 bits long. This upper part is multiplied by
+// the constant `c` and the product, which fits in a single word, is included
+// in the addition of the two operands.
+
+M25519_INLINE void (gfp_add)(Word *r, const Word *a, const Word *b)
+{
+  DWord sum;
+  Word msw;
+  int i;
+
+  M25519_PROF_KINC(GFP_ADD);
+  sum = (DWord) a[LEN-1] + b[LEN-1];
+  msw = ((Word) sum) & MSB0MASK;  // 0x7FFFFFFF
+  sum = (DWord) CONSTC*((Word) (sum >> (WSIZE - 1)));
+  // sum is in [0, 3*c]
+  
+  for (i = 0; i < LEN - 1; i++) {
+    sum += (DWord) a[i] + b[i];
+    r[i] = (Word) sum;
+    sum >>= WSIZE;
+    // sum is in [0, 2]
+  }
+  r[LEN-1] = msw + ((Word) sum);
+}
+
+
+// Subtraction of one field-element from another: $r = a - b \bmod p$
+// ------------------------------------------------------------------
+// Similar to the addition in GF(p), the subtraction is executed with a single
+// loop. To ensure that the final result is positive, the subtraction in GF(p)
+// is implemented as $r = 4p + a - b \bmod p = 2^{k+2} + a - b - 4c \bmod p$,
+// i.e., an addition of $4p = 2^{k+2} - 4c$ is included in the subtraction. In
+// this way, the subtraction-loop consists of the same number of instructions
+// as the loop of the addition in GF(p) if (i) the sum in the loop is a signed
+// integer and (ii) the right-shift is an arithmetic right-shift (to preserve
+// the sign). The most-significant word of $4p$, i.e., $2^{WSIZE+1}$, is split
+// up into $2^{WSIZE+1} - 4$ and $4$. The former part, which is $WSIZE+1$ bits
+// long, is included in the subtraction of b[len-1] from a[len-1], while the
+// latter part is added after the subtraction-loop (to ensure that a negative
+// sum from the loop does not make r[len-1] negative).
+
+M25519_INLINE void (gfp_sub)(Word *r, const Word *a, const Word *b)
+{
+  SDWord sum;  // signed!
+  Word msw;
+  int i;
+
+  M25519_PROF_KINC(GFP_SUB);
+  sum = (SDWord) FOURXPHI + a[LEN-1] - b[LEN-1];  // 0x1FFFFFFFC
+  msw = ((Word) sum) & MSB0MASK;  // 0x7FFFFFFF
+  sum = (SDWord) CONSTC*((Word) (sum >> (WSIZE - 1)));
+  sum = sum - (CONSTC << 2);
+  // sum is in [-3*c, c]
+  
+  for (i = 0; i < LEN - 1; i++) {
+    sum += (SDWord) a[i] - b[i];
+    r[i] = (Word) sum;
+    sum >>= WSIZE;  // arithmetic shift!
+    // sum is in [-2, 1]
+  }
+  r[LEN-1] = msw + ((Word) sum) + 4;
+  // 0x1FFFFFFFC + 4 = 0x200000000 = MSW of 2^(k+2)
+}
+
+
+// Conditional negation of a field-element: $r = -a \bmod p$ or $r = a \bmod p$
+// ----------------------------------------------------------------------------
+// The goal is to execute this function with one loop and as few instructions
+// per iteration as possible. When operand `neg` is 1, the function computes
+// $r = 2p + t + 1 - 2c \bmod p = 2^{k+1} - 2c + t - (2c - 1) \bmod p$, where
+// $t$ is the ($k+1$)-bit one's complement (or bit-wise inverse) of $a$, i.e.,
+// $t = 2^{k+1} - a - 1$. The result $r = 2^{k+1} + 2^{k+1} - a - 4c \bmod p$
+// can be written as $r = 4p - a \bmod p$, which means $a$ gets negated. This
+// negation is implemented similarly as the subtraction in GF(p). On the other
+// hand, when `neg` is 0, the result $r = 2p + a = 2^{k+1} - 2c + a \bmod p$ is
+// computed. These two cases (i.e., `neg` = 1 and `neg` = 0) can be unified by
+// XORing a[i] with an "all-1" mask, thereby producing the one's complement of
+// `a`, or 0, which leaves operand $a$ unmodified. Furthermore, a conditional
+// (i.e., AND-masked) subtraction of $2c - 1$ is included in the computation.
+
+M25519_INLINE void (gfp_cneg)(Word *r, const Word *a, int neg)
+{
+  SDWord sum;  // signed!
+  Word msw, mask;
+  int i;
+
+  M25519_PROF_KINC(GFP_CNEG);
+  mask = 0 - (Word) (neg & 1);  // 0 or all-1
+  sum = (SDWord) MIN4MASK + (mask ^ a[LEN-1]);  // 0xFFFFFFFC
+  msw = ((Word) sum) & MSB0MASK;  // 0x7FFFFFFF
+  sum = (SDWord) CONSTC*((Word) (sum >> (WSIZE - 1)));
+  sum = sum - (CONSTC << 1) - (mask & ((CONSTC << 1) - 1));
+  // sum is in [-3*c+1, -c+1] if neg is 1
+  // sum is in [-c, c] if neg is 0
+  
+  for (i = 0; i < LEN - 1; i++) {
+    sum += (SDWord) (mask ^ a[i]);
+    r[i] = (Word) sum;
+    sum >>= WSIZE;  // arithmetic shift!
+    // sum is in [-1, 1]
+  }
+  r[LEN-1] = msw + ((Word) sum) + 4;
+}
+
+
+// Halving of a field-element: $r = a/2 \bmod p$
+// ---------------------------------------------
+// The halving function performs a conventional 1-bit right-shift when the LSB
+// of operand $a$ is 0; otherwise, it first adds the prime $p$ to $a$ to make
+// it even and executes the shift thereafter. Similar to the other operations
+// in GF(p) described above, the addition of the prime $p$ can be optimized by
+// subtracting $c$ from the least-significant word a[i] (which can introduce a
+// borrow-bit that has to be propagated) and adding $2^{WSIZE-1}$ to the most-
+// significant word a[len-1]. The loop has to compute not only a sum, but also
+// maintain a temporary copy of the least-significant word of the previous sum
+// (i.e., the sum of the last iteration) to be able to perform the 1-bit right-
+// shift. Due to the right-shift, the result will always fit into $len$ words.
+
+M25519_INLINE void (gfp_hlv)(Word *r, const Word *a)
+{
+  SDWord sum;  // signed!
+  Word tmp, mask;
+  int i;
+
+  M25519_PROF_KINC(GFP_HLV);
+  // masked addition of prime p to a
+  mask = 0 - (a[0] & 1);  // 0 or all-1
+  sum = (SDWord) a[0] - (CONSTC & mask);
+  tmp = (Word) sum;
+  sum >>= WSIZE;  // arithmetic shift!
+  // sum is in [-1, 0]
+  
+  for (i = 1; i < LEN - 1; i++) {
+    sum += (SDWord) a[i];
+    r[i-1] = (((Word) sum) << (WSIZE - 1)) | (tmp >> 1);
+    tmp = (Word) sum;
+    sum >>= WSIZE;  // arithmetic shift!
+    // sum is in [-1, 0]
+  }
+  sum += (SDWord) a[LEN-1] + (MSB1MASK & mask);  // 0x80000000
+  r[LEN-2] = (((Word) sum) << (WSIZE - 1)) | (tmp >> 1);
+  r[LEN-1] = (Word) (sum >> 1);
+}
+
+
+#if !defined(M25519_COMBA_MUL)  // operand-scanning variants
+
+
+// Multiplication of two field-elements: $r = a \cdot b \bmod p$
+// -------------------------------------------------------------
+// The multiplication in GF(p) consists of an "ordinary" multiplication of the
+// two $len$-word operands, yielding a product of $2len$ words (which is stored
+// in a temporary array `t` on the stack), succeeded by a reduction modulo $p$.
+// Following the operand-scanning technique, the $len$-word multiplication has
+// a nested-loop structure, whereby the very first iteration of the outer loop
+// (in which the words a[i] of $a$ are multiplied by word b[0]) is peeled off
+// to avoid an explicit initialization of array `t` to 0. The modular reduction
+// consists of two steps; the first step involves multiplying the higher $len$
+// words of `t` by $2c$ and adding the product to the lower $len$ words of `t`.
+// The obtained intermediate result comprises $len+1$ words, of which the most-
+// significant word is up to $WSIZE-1$ bits long. Thereafter, the second step
+// is similar to the reduction-step of the addition in GF(p).
+
+void (gfp_mul)(Word *r, const Word *a, const Word *b)
+{
+  Word t[2*LEN];
+  DWord prod = 0;
+  Word msw;
+  int i, j;
+
+  M25519_PROF_KINC(GFP_MUL);
+  // multiplication of A by b[0]
+  for (j = 0; j < LEN; j++) {
+    prod += (DWord) a[j]*b[0];
+    t[j] = (Word) prod;
+    prod >>= WSIZE;
+  }
+  t[j] = (Word) prod;
+  
+  // multiplication of A by b[i] for 1 <= i < LEN
+  for (i = 1; i < LEN; i++) {
+    prod = 0;
+    for (j = 0; j < LEN; j++) {
+      prod += (DWord) a[j]*b[i];
+      prod += t[i+j];
+      t[i+j] = (Word) prod;
+      prod >>= WSIZE;
+    }
+    t[i+j] = (Word) prod;
+  }
+  
+  // first step of modular reduction
+  prod = 0;
+  for (i = 0; i < LEN - 1; i++) {
+    prod += (DWord) t[i+LEN]*(CONSTC << 1) + t[i];
+    t[i] = (Word) prod;
+    prod >>= WSIZE;
+  }
+  prod += (DWord) t[2*LEN-1]*(CONSTC << 1) + t[LEN-1];
+  // prod is in [0, 2^(2*WSIZE-1)-1]
+  
+  // second step of modular reduction
+  msw = ((Word) prod) & MSB0MASK;  // 0x7FFFFFFF
+  prod = (DWord) CONSTC*(prod >> (WSIZE - 1));
+  for (i = 0; i < LEN - 1; i++) {
+    prod += t[i];
+    r[i] = (Word) prod;
+    prod >>= WSIZE;
+  }
+  r[LEN-1] = msw + ((Word) prod);
+}
+
+
+// Squaring of a field-element: $r = a^2 \bmod p$
+// ----------------------------------------------
+// Similar to the multiplication, the implementation of the squaring is based
+// on the operand-scanning method. To minimize the execution time, all partial-
+// products a[j]*a[i] with j != i are computed only once and then doubled in a
+// separate loop. Compared to the multiplication, the nested loop computes less
+// than half of the number of partial products since the loop-counter j of the
+// inner loop starts with j = i + 1 instead of j = 0. The very first iteration
+// of the outer loop is peeled off to avoid an explicit initialization of array
+// `t` (in which the square is stored) to 0. After the nested loop follows the
+// doubling of the intermediate result obtained so far along with the addition
+// of the (un-doubled) partial-products a[i]*a[i] located in main diagonal. The
+// reduction modulo $p$ is performed in the same way as for the multiplication
+// in GF(p).
+
+void (gfp_sqr)(Word *r, const Word *a)
+{
+  Word t[2*LEN];
+  DWord prod = 0, sum = 0;
+  Word msw;
+  int i, j;
+
+  M25519_PROF_KINC(GFP_SQR);
+  // multiplication of A[1,...,LEN-1] by a[0] (to avoid r <- 0)
+  t[0] = 0;
+  for (j = 1; j < LEN; j++) {
+    prod += (DWord) a[j]*a[0];
+    t[j] = (Word) prod;
+    prod >>= WSIZE;
+  }
+  t[j] = (Word) prod;
+  
+  // multiplication of A[i+1,...,LEN-1] by a[i] for 1 <= i < LEN
+  for (i = 1; i < LEN; i++) {
+    prod = 0;
+    for (j = i + 1; j < LEN; j++) {
+      prod += (DWord) a[j]*a[i];
+      prod += t[i+j];
+      t[i+j] = (Word) prod;
+      prod >>= WSIZE;
+    }
+    t[i+j] = (Word) prod;
+  }
+  
+  // double existing result, add squares a[i]^2 for 0 <= i < LEN
+  for (i = 0; i < LEN; i++) {
+    prod = (DWord) a[i]*a[i];
+    sum += (Word) prod;
+    sum += (DWord) t[2*i] + t[2*i];
+    t[2*i] = (Word) sum;
+    sum >>= WSIZE;
+    sum += ((Word) (prod >> WSIZE));
+    sum += (DWord) t[2*i+1] + t[2*i+1];
+    t[2*i+1] = (Word) sum;
+    sum >>= WSIZE;
+  }
+  
+  // first step of modular reduction
+  prod = 0;
+  for (i = 0; i < LEN - 1; i++) {
+    prod += (DWord) t[i+LEN]*(CONSTC << 1) + t[i];
+    t[i] = (Word) prod;
+    prod >>= WSIZE;
+  }
+  prod += (DWord) t[2*LEN-1]*(CONSTC << 1) + t[LEN-1];
+  // prod is in [0, 2^(2*WSIZE-1)-1]
+  
+  // second step of modular reduction
+  msw = ((Word) prod) & MSB0MASK;  // 0x7FFFFFFF
+  prod = (DWord) CONSTC*(prod >> (WSIZE - 1));
+  for (i = 0; i < LEN - 1; i++) {
+    prod += t[i];
+    r[i] = (Word) prod;
+    prod >>= WSIZE;
+  }
+  r[LEN-1] = msw + ((Word) prod);
+}
+
+#else  // product-scanning (Comba) multiplication and squaring
+
+
+// Multiplication of two field-elements: $r = a \cdot b \bmod p$
+// -------------------------------------------------------------
+// This variant of the multiplication in GF(p), which is used when the macro
+// `M25519_COMBA_MUL` is defined, is based on the product-scanning technique
+// and integrates the first step of the modular reduction into the computation
+// of the partial products. In each iteration $k$ of the outer loop, column $k$
+// (i.e., the partial products a[i]*b[j] with $i + j = k$) is accumulated in a
+// three-word accumulator, which also holds the carry from the previous column.
+// Then, column $k+len$ is computed in a second three-word accumulator and its
+// sum is multiplied by $2c$ and added to the first one, after which the lowest
+// word of the first accumulator is stored in `t[k]` and the accumulator is
+// shifted one word to the right. Consequently, only $len$ words of temporary
+// space are needed on the stack (for the case that `r` is the same array as
+// `a` or `b`) instead of $2len$ words, and the partial products are not loaded
+// from and stored to RAM, which reduces the memory traffic on 8/16-bit targets.
+// The second step of the modular reduction is the same as in the operand-
+// scanning variant, whereby the carry from the last column is included.
+
+void (gfp_mul)(Word *r, const Word *a, const Word *b)
+{
+  Word t[LEN];
+  DWord prod, accl = 0, suml;
+  Word acce = 0, sume, tmp, msw;
+  int i, k;
+  
+  M25519_PROF_KINC(GFP_MUL);
+  for (k = 0; k < LEN; k++) {
+    // column k of the product: a[i]*b[k-i] for 0 <= i <= k
+    for (i = 0; i <= k; i++) {
+      prod = (DWord) a[i]*b[k-i];
+      accl += prod;
+      acce += (accl < prod);
+    }
+    // column k+LEN of the product: a[i]*b[k+LEN-i] for k < i < LEN
+    suml = 0; sume = 0;
+    for (i = k + 1; i < LEN; i++) {
+      prod = (DWord) a[i]*b[k+LEN-i];
+      suml += prod;
+      sume += (suml < prod);
+    }
+    // first step of modular reduction: column k+LEN times 2c plus column k
+    prod = (DWord) ((Word) suml)*(CONSTC << 1) + ((Word) accl);
+    t[k] = (Word) prod;
+    prod >>= WSIZE;
+    prod += (DWord) ((Word) (suml >> WSIZE))*(CONSTC << 1) + (accl >> WSIZE);
+    tmp = (Word) prod;
+    prod >>= WSIZE;
+    prod += (DWord) sume*(CONSTC << 1) + acce;
+    accl = (prod << WSIZE) | tmp;
+    acce = (Word) (prod >> WSIZE);
+  }
+  // accl is in [0, 2^(WSIZE+4)-1] and acce is 0
+  
+  // second step of modular reduction
+  msw = t[LEN-1] & MSB0MASK;  // 0x7FFFFFFF
+  prod = (DWord) CONSTC*((accl << 1) | (t[LEN-1] >> (WSIZE - 1)));
+  for (i = 0; i < LEN - 1; i++) {
+    prod += t[i];
+    r[i] = (Word) prod;
+    prod >>= WSIZE;
+  }
+  r[LEN-1] = msw + ((Word) prod);
+}
+
+
+// Squaring of a field-element: $r = a^2 \bmod p$
+// ----------------------------------------------
+// The product-scanning variant of the squaring has the same structure as the
+// multiplication above, but computes each partial product a[i]*a[j] with $i <
+// j$ only once. These partial products are summed up in the second three-word
+// accumulator, which is then doubled and added to the first accumulator (for
+// column $k$) or multiplied by $2c$ after the addition of the square in the
+// main diagonal (for column $k+len$).
+
+void (gfp_sqr)(Word *r, const Word *a)
+{
+  Word t[LEN];
+  DWord prod, accl = 0, suml;
+  Word acce = 0, sume, tmp, msw;
+  int i, k;
+  
+  M25519_PROF_KINC(GFP_SQR);
+  for (k = 0; k < LEN; k++) {
+    // column k of the square: 2*a[i]*a[k-i] for 0 <= i < k-i and a[k/2]^2
+    suml = 0; sume = 0;
+    for (i = 0; 2*i < k; i++) {
+      prod = (DWord) a[i]*a[k-i];
+      suml += prod;
+      sume += (suml < prod);
+    }
+    sume = (sume << 1) | ((Word) (suml >> (2*WSIZE - 1)));
+    suml <<= 1;
+    accl += suml;
+    acce += sume + (accl < suml);
+    if ((k & 1) == 0) {
+      prod = (DWord) a[k>>1]*a[k>>1];
+      accl += prod;
+      acce += (accl < prod);
+    }
+    // column k+LEN of the square: 2*a[i]*a[k+LEN-i] for k < i < k+LEN-i and
+    // a[(k+LEN)/2]^2
+    suml = 0; sume = 0;
+    for (i = k + 1; 2*i < k + LEN; i++) {
+      prod = (DWord) a[i]*a[k+LEN-i];
+      suml += prod;
+      sume += (suml < prod);
+    }
+    sume = (sume << 1) | ((Word) (suml >> (2*WSIZE - 1)));
+    suml <<= 1;
+    if ((((k + LEN) & 1) == 0) && (k < LEN - 1)) {
+      prod = (DWord) a[(k+LEN)>>1]*a[(k+LEN)>>1];
+      suml += prod;
+      sume += (suml < prod);
+    }
+    // first step of modular reduction: column k+LEN times 2c plus column k
+    prod = (DWord) ((Word) suml)*(CONSTC << 1) + ((Word) accl);
+    t[k] = (Word) prod;
+    prod >>= WSIZE;
+    prod += (DWord) ((Word) (suml >> WSIZE))*(CONSTC << 1) + (accl >> WSIZE);
+    tmp = (Word) prod;
+    prod >>= WSIZE;
+    prod += (DWord) sume*(CONSTC << 1) + acce;
+    accl = (prod << WSIZE) | tmp;
+    acce = (Word) (prod >> WSIZE);
+  }
+  // accl is in [0, 2^(WSIZE+4)-1] and acce is 0
+  
+  // second step of modular reduction
+  msw = t[LEN-1] & MSB0MASK;  // 0x7FFFFFFF
+  prod = (DWord) CONSTC*((accl << 1) | (t[LEN-1] >> (WSIZE - 1)));
+  for (i = 0; i < LEN - 1; i++) {
+    prod += t[i];
+    r[i] = (Word) prod;
+    prod >>= WSIZE;
+  }
+  r[LEN-1] = msw + ((Word) prod);
+}
+
+
+#endif  // #if !defined(M25519_COMBA_MUL)
+
+
+// Multiplication of a field-element by a 32-bit value: $r = a \cdot b \bmod p$
+// ----------------------------------------------------------------------------
+// The multiplication of a $len$-word integer by a 32-bit integer follows the
+// operand-scanning method and yields a product consisting of $len+32/WSIZE$
+// words, which is stored in a temporary array `t` on the stack. The reduction
+// operation differs slightly from the reduction of the normal multiplication
+// in GF(p) and starts with a multiplication the $32/WSIZE$ higher words of `t`
+// by $2c$ and an addition of $c$ to this product if the MSB of t[len-1] is 1.
+// Then, the lower $32/WSIZE$ words of the obtained sum (which is $32/WSIZE+1$
+// words long) are added to the $32/WSIZE$ least-significant words of `t`. The
+// produced carry is added along with the highest sum-word to t[32/WSIZE] and
+// the resulting carry is propagated up to the most-significant word t[len-1],
+// whose MSB has been cleared before the carry propagation.
+
+void (gfp_mul32)(Word *r, const Word *a, const Word *b)
+{
+  Word t[LEN+1];
+  DWord prod = 0;
+  Word msw;
+  int i = 0, j;
+
+  M25519_PROF_KINC(GFP_MUL32);
+  // multiplication of A by b[0]
+  for (j = 0; j < LEN; j++) {
+    prod += (DWord) a[j]*b[0];
+    t[j] = (Word) prod;
+    prod >>= WSIZE;
+  }
+  t[j] = (Word) prod;
+  
+  msw = t[LEN-1] & MSB0MASK;  // 0x7FFFFFFF
+  prod = (DWord) CONSTC*(t[LEN-1] >> (WSIZE - 1));
+  // prod is either 0 or c
+  
+  // compute first 32 bits of result
+  prod += (DWord) t[i+LEN]*(CONSTC << 1) + t[i];
+  r[i] = (Word) prod;
+  prod >>= WSIZE;
+  
+  // compute r[i] = t[i] + carry
+  for (i = 1; i < LEN - 1; i++) {
+    prod += (DWord) t[i];
+    r[i] = (Word) prod;
+    prod >>= WSIZE;
+  }
+  r[LEN-1] = ((Word) prod) + msw;
+}
+
+#else  // fully unrolled variants for LEN = 8
+
+
+#if (LEN != 8)
+#error "M25519_C_UNROLLED requires LEN = 8 (i.e., 32-bit Words)"
+#endif
+
+
+// The functions below are fully unrolled versions of the performance-critical
+// field operations above, which are used instead of the rolled versions when
+// the macro `M25519_C_UNROLLED` is defined. They execute exactly the same
+// sequence of arithmetic operations as their rolled counterparts and produce
+// the same results, but all loops are written out via the macros below, so
+// that all array indices are compile-time constants. This allows compilers to
+// keep the operands and the intermediate product in registers and to translate
+// each macro into a short branch-free instruction sequence (e.g., `umaal` on
+// ARMv7E-M/ARMv8-M Mainline or an add-with-carry chain on other targets). The
+// carries are always propagated through a double-length accumulator and never
+// computed with comparisons, which is important for constant execution time.
+
+
+// ACC_ADDW: add word `w` to accumulator `acc`, store the lower word of `acc`
+// in `r` and shift `acc` one word to the right (`acc` may be signed).
+#define ACC_ADDW(acc, r, w) do { \
+  (acc) += (w); (r) = (Word) (acc); (acc) >>= WSIZE; } while (0)
+
+// MUL_ADDC: compute `r` = lower word and `c` = upper word of a*b + c
+#define MUL_ADDC(r, c, a, b) do { \
+  DWord p_ = (DWord) (a)*(b) + (c); \
+  (r) = (Word) p_; (c) = (Word) (p_ >> WSIZE); } while (0)
+
+// MUL_ACC2: compute `t` = lower word and `c` = upper word of a*b + t + c,
+// which can not overflow a DWord (and corresponds to `umaal` on ARM)
+#define MUL_ACC2(t, c, a, b) do { \
+  DWord p_ = (DWord) (a)*(b) + (t) + (c); \
+  (t) = (Word) p_; (c) = (Word) (p_ >> WSIZE); } while (0)
+
+// MUL_ROW0: t[0..8] = A*b (first row of the operand-scanning product)
+#define MUL_ROW0(t, a, b) do { Word c_ = 0; \
+  MUL_ADDC(t[0], c_, a[0], b); MUL_ADDC(t[1], c_, a[1], b); \
+  MUL_ADDC(t[2], c_, a[2], b); MUL_ADDC(t[3], c_, a[3], b); \
+  MUL_ADDC(t[4], c_, a[4], b); MUL_ADDC(t[5], c_, a[5], b); \
+  MUL_ADDC(t[6], c_, a[6], b); MUL_ADDC(t[7], c_, a[7], b); \
+  t[8] = c_; } while (0)
+
+// MUL_ROWI: t[i..i+8] = t[i..i+7] + A*b (row i of the product)
+#define MUL_ROWI(t, i, a, b) do { Word c_ = 0; \
+  MUL_ACC2(t[(i)+0], c_, a[0], b); MUL_ACC2(t[(i)+1], c_, a[1], b); \
+  MUL_ACC2(t[(i)+2], c_, a[2], b); MUL_ACC2(t[(i)+3], c_, a[3], b); \
+  MUL_ACC2(t[(i)+4], c_, a[4], b); MUL_ACC2(t[(i)+5], c_, a[5], b); \
+  MUL_ACC2(t[(i)+6], c_, a[6], b); MUL_ACC2(t[(i)+7], c_, a[7], b); \
+  t[(i)+8] = c_; } while (0)
+
+// RED_2STEP: reduction of the 16-word product `t` modulo p, the first step
+// adds t[8..15]*2c to t[0..7] and the second step folds the bits above bit
+// position 255 (multiplied by c) into the lower words; the result is put in r
+#define RED_2STEP(r, t) do { \
+  Word c_ = 0, msw_, hi_; DWord s_; \
+  MUL_ACC2(t[0], c_, t[8], (CONSTC << 1)); \
+  MUL_ACC2(t[1], c_, t[9], (CONSTC << 1)); \
+  MUL_ACC2(t[2], c_, t[10], (CONSTC << 1)); \
+  MUL_ACC2(t[3], c_, t[11], (CONSTC << 1)); \
+  MUL_ACC2(t[4], c_, t[12], (CONSTC << 1)); \
+  MUL_ACC2(t[5], c_, t[13], (CONSTC << 1)); \
+  MUL_ACC2(t[6], c_, t[14], (CONSTC << 1)); \
+  MUL_ACC2(t[7], c_, t[15], (CONSTC << 1)); \
+  msw_ = t[7] & MSB0MASK; \
+  hi_ = (c_ << 1) | (t[7] >> (WSIZE - 1)); \
+  s_ = (DWord) CONSTC*hi_; \
+  ACC_ADDW(s_, r[0], t[0]); ACC_ADDW(s_, r[1], t[1]); \
+  ACC_ADDW(s_, r[2], t[2]); ACC_ADDW(s_, r[3], t[3]); \
+  ACC_ADDW(s_, r[4], t[4]); ACC_ADDW(s_, r[5], t[5]); \
+  ACC_ADDW(s_, r[6], t[6]); \
+  r[7] = msw_ + ((Word) s_); } while (0)
+
+
+// Addition of two field-elements: $r = a + b \bmod p$ (unrolled version)
+
+M25519_INLINE void (gfp_add)(Word *r, const Word *a, const Word *b)
+{
+  DWord sum;
+  Word msw;
+
+  M25519_PROF_KINC(GFP_ADD);
+  sum = (DWord) a[7] + b[7];
+  msw = ((Word) sum) & MSB0MASK;  // 0x7FFFFFFF
+  sum = (DWord) CONSTC*((Word) (sum >> (WSIZE - 1)));
+  ACC_ADDW(sum, r[0], (DWord) a[0] + b[0]);
+  ACC_ADDW(sum, r[1], (DWord) a[1] + b[1]);
+  ACC_ADDW(sum, r[2], (DWord) a[2] + b[2]);
+  ACC_ADDW(sum, r[3], (DWord) a[3] + b[3]);
+  ACC_ADDW(sum, r[4], (DWord) a[4] + b[4]);
+  ACC_ADDW(sum, r[5], (DWord) a[5] + b[5]);
+  ACC_ADDW(sum, r[6], (DWord) a[6] + b[6]);
+  r[7] = msw + ((Word) sum);
+}
+
+
+// Subtraction of one field-element from another: $r = a - b \bmod p$
+// (unrolled version)
+
+M25519_INLINE void (gfp_sub)(Word *r, const Word *a, const Word *b)
+{
+  SDWord sum;  // signed!
+  Word msw;
+
+  M25519_PROF_KINC(GFP_SUB);
+  sum = (SDWord) FOURXPHI + a[7] - b[7];  // 0x1FFFFFFFC
+  msw = ((Word) sum) & MSB0MASK;  // 0x7FFFFFFF
+  sum = (SDWord) CONSTC*((Word) (sum >> (WSIZE - 1)));
+  sum = sum - (CONSTC << 2);
+  ACC_ADDW(sum, r[0], (SDWord) a[0] - b[0]);  // arithmetic shift!
+  ACC_ADDW(sum, r[1], (SDWord) a[1] - b[1]);
+  ACC_ADDW(sum, r[2], (SDWord) a[2] - b[2]);
+  ACC_ADDW(sum, r[3], (SDWord) a[3] - b[3]);
+  ACC_ADDW(sum, r[4], (SDWord) a[4] - b[4]);
+  ACC_ADDW(sum, r[5], (SDWord) a[5] - b[5]);
+  ACC_ADDW(sum, r[6], (SDWord) a[6] - b[6]);
+  r[7] = msw + ((Word) sum) + 4;
+}
+
+
+// Conditional negation of a field-element: $r = -a \bmod p$ or $r = a \bmod p$
+// (unrolled version)
+
+M25519_INLINE void (gfp_cneg)(Word *r, const Word *a, int neg)
+{
+  SDWord sum;  // signed!
+  Word msw, mask;
+
+  M25519_PROF_KINC(GFP_CNEG);
+  mask = 0 - (Word) (neg & 1);  // 0 or all-1
+  sum = (SDWord) MIN4MASK + (mask ^ a[7]);  // 0xFFFFFFFC
+  msw = ((Word) sum) & MSB0MASK;  // 0x7FFFFFFF
+  sum = (SDWord) CONSTC*((Word) (sum >> (WSIZE - 1)));
+  sum = sum - (CONSTC << 1) - (mask & ((CONSTC << 1) - 1));
+  ACC_ADDW(sum, r[0], (SDWord) (mask ^ a[0]));  // arithmetic shift!
+  ACC_ADDW(sum, r[1], (SDWord) (mask ^ a[1]));
+  ACC_ADDW(sum, r[2], (SDWord) (mask ^ a[2]));
+  ACC_ADDW(sum, r[3], (SDWord) (mask ^ a[3]));
+  ACC_ADDW(sum, r[4], (SDWord) (mask ^ a[4]));
+  ACC_ADDW(sum, r[5], (SDWord) (mask ^ a[5]));
+  ACC_ADDW(sum, r[6], (SDWord) (mask ^ a[6]));
+  r[7] = msw + ((Word) sum) + 4;
+}
+
+
+// Halving of a field-element: $r = a/2 \bmod p$ (unrolled version)
+// ----------------------------------------------------------------
+// The sums are stored in a temporary array `t` first, so that the 1-bit right-
+// shift can be performed afterwards without keeping track of the previous sum.
+
+M25519_INLINE void (gfp_hlv)(Word *r, const Word *a)
+{
+  SDWord sum;  // signed!
+  Word t[LEN], mask;
+
+  M25519_PROF_KINC(GFP_HLV);
+  // masked addition of prime p to a
+  mask = 0 - (a[0] & 1);  // 0 or all-1
+  sum = 0 - (SDWord) (CONSTC & mask);
+  ACC_ADDW(sum, t[0], (SDWord) a[0]);  // arithmetic shift!
+  ACC_ADDW(sum, t[1], (SDWord) a[1]);
+  ACC_ADDW(sum, t[2], (SDWord) a[2]);
+  ACC_ADDW(sum, t[3], (SDWord) a[3]);
+  ACC_ADDW(sum, t[4], (SDWord) a[4]);
+  ACC_ADDW(sum, t[5], (SDWord) a[5]);
+  ACC_ADDW(sum, t[6], (SDWord) a[6]);
+  sum += (SDWord) a[7] + (MSB1MASK & mask);  // 0x80000000
+  t[7] = (Word) sum;
+  // 1-bit right-shift of the (WSIZE*LEN+1)-bit sum
+  r[0] = (t[1] << (WSIZE - 1)) | (t[0] >> 1);
+  r[1] = (t[2] << (WSIZE - 1)) | (t[1] >> 1);
+  r[2] = (t[3] << (WSIZE - 1)) | (t[2] >> 1);
+  r[3] = (t[4] << (WSIZE - 1)) | (t[3] >> 1);
+  r[4] = (t[5] << (WSIZE - 1)) | (t[4] >> 1);
+  r[5] = (t[6] << (WSIZE - 1)) | (t[5] >> 1);
+  r[6] = (t[7] << (WSIZE - 1)) | (t[6] >> 1);
+  r[7] = (Word) (sum >> 1);
+}
+
+
+// Multiplication of two field-elements: $r = a \cdot b \bmod p$
+// (unrolled version of the operand-scanning multiplication)
+
+void (gfp_mul)(Word *r, const Word *a, const Word *b)
+{
+  Word t[2*LEN];
+
+  M25519_PROF_KINC(GFP_MUL);
+  MUL_ROW0(t, a, b[0]);
+  MUL_ROWI(t, 1, a, b[1]);
+  MUL_ROWI(t, 2, a, b[2]);
+  MUL_ROWI(t, 3, a, b[3]);
+  MUL_ROWI(t, 4, a, b[4]);
+  MUL_ROWI(t, 5, a, b[5]);
+  MUL_ROWI(t, 6, a, b[6]);
+  MUL_ROWI(t, 7, a, b[7]);
+  RED_2STEP(r, t);
+}
+
+
+// Squaring of a field-element: $r = a^2 \bmod p$
+// (unrolled version of the operand-scanning squaring)
+
+void (gfp_sqr)(Word *r, const Word *a)
+{
+  Word t[2*LEN], c;
+  DWord prod, sum = 0;
+
+  M25519_PROF_KINC(GFP_SQR);
+  // partial products a[j]*a[i] with j > i, row by row
+  c = 0;
+  MUL_ADDC(t[1], c, a[1], a[0]); MUL_ADDC(t[2], c, a[2], a[0]);
+  MUL_ADDC(t[3], c, a[3], a[0]); MUL_ADDC(t[4], c, a[4], a[0]);
+  MUL_ADDC(t[5], c, a[5], a[0]); MUL_ADDC(t[6], c, a[6], a[0]);
+  MUL_ADDC(t[7], c, a[7], a[0]); t[8] = c;
+  c = 0;
+  MUL_ACC2(t[3], c, a[2], a[1]); MUL_ACC2(t[4], c, a[3], a[1]);
+  MUL_ACC2(t[5], c, a[4], a[1]); MUL_ACC2(t[6], c, a[5], a[1]);
+  MUL_ACC2(t[7], c, a[6], a[1]); MUL_ACC2(t[8], c, a[7], a[1]);
+  t[9] = c;
+  c = 0;
+  MUL_ACC2(t[5], c, a[3], a[2]); MUL_ACC2(t[6], c, a[4], a[2]);
+  MUL_ACC2(t[7], c, a[5], a[2]); MUL_ACC2(t[8], c, a[6], a[2]);
+  MUL_ACC2(t[9], c, a[7], a[2]); t[10] = c;
+  c = 0;
+  MUL_ACC2(t[7], c, a[4], a[3]); MUL_ACC2(t[8], c, a[5], a[3]);
+  MUL_ACC2(t[9], c, a[6], a[3]); MUL_ACC2(t[10], c, a[7], a[3]);
+  t[11] = c;
+  c = 0;
+  MUL_ACC2(t[9], c, a[5], a[4]); MUL_ACC2(t[10], c, a[6], a[4]);
+  MUL_ACC2(t[11], c, a[7], a[4]); t[12] = c;
+  c = 0;
+  MUL_ACC2(t[11], c, a[6], a[5]); MUL_ACC2(t[12], c, a[7], a[5]);
+  t[13] = c;
+  c = 0;
+  MUL_ACC2(t[13], c, a[7], a[6]); t[14] = c;
+  t[0] = 0; t[15] = 0;
+  
+  // double existing result, add squares a[i]^2 for 0 <= i < LEN
+#define SQR_DIAG(i) do { \
+  prod = (DWord) a[i]*a[i]; \
+  sum += (DWord) ((Word) prod) + t[2*(i)] + t[2*(i)]; \
+  t[2*(i)] = (Word) sum; sum >>= WSIZE; \
+  sum += (DWord) ((Word) (prod >> WSIZE)) + t[2*(i)+1] + t[2*(i)+1]; \
+  t[2*(i)+1] = (Word) sum; sum >>= WSIZE; } while (0)
+  SQR_DIAG(0); SQR_DIAG(1); SQR_DIAG(2); SQR_DIAG(3);
+  SQR_DIAG(4); SQR_DIAG(5); SQR_DIAG(6); SQR_DIAG(7);
+#undef SQR_DIAG
+  
+  RED_2STEP(r, t);
+}
+
+
+// Multiplication of a field-element by a 32-bit value: $r = a \cdot b \bmod p$
+// (unrolled version)
+
+void (gfp_mul32)(Word *r, const Word *a, const Word *b)
+{
+  Word t[LEN+1], msw;
+  DWord prod;
+
+  M25519_PROF_KINC(GFP_MUL32);
+  MUL_ROW0(t, a, b[0]);
+  msw = t[7] & MSB0MASK;  // 0x7FFFFFFF
+  prod = (DWord) CONSTC*(t[7] >> (WSIZE - 1));
+  // prod is either 0 or c
+  ACC_ADDW(prod, r[0], (DWord) t[8]*(CONSTC << 1) + t[0]);
+  ACC_ADDW(prod, r[1], t[1]);
+  ACC_ADDW(prod, r[2], t[2]);
+  ACC_ADDW(prod, r[3], t[3]);
+  ACC_ADDW(prod, r[4], t[4]);
+  ACC_ADDW(prod, r[5], t[5]);
+  ACC_ADDW(prod, r[6], t[6]);
+  r[7] = ((Word) prod) + msw;
+}
+
+
+#undef ACC_ADDW
+#undef MUL_ADDC
+#undef MUL_ACC2
+#undef MUL_ROW0
+#undef MUL_ROWI
+#undef RED_2STEP
+
+#endif  // #if !defined(M25519_C_UNROLLED)
+
+
+#endif  // #if ((!defined(M25519_ASSEMBLY) && !defined(M25519_HOST64)) || ...
+#if !defined(M25519_ASSEMBLY_EXT)
+
+
+// The functions below have an Assembly implementation, but their C version is
+// shared by the generic 32-bit and the 64-bit C implementation. The first two
+// are "lazy-reduction" variants of the addition and subtraction in GF(p),
+// which do not perform any reduction modulo $p$ at all and can, therefore,
+// only be used when the operands are known to be bounded (e.g., fully
+// reduced). They operate on the 32-bit Word-arrays directly.
+
+
+// Non-reducing addition of two field-elements: $r = a + b$
+// --------------------------------------------------------
+// This function performs a plain 256-bit addition, i.e., the reduction of the
+// sum (including the computation of the most-significant word at the start)
+// of `gfp_add` is omitted. The result is only correct (i.e., congruent to $a +
+// b \bmod p$) when $a + b < 2^{k+1}$, which is the case, e.g., when both $a$
+// and $b$ are less than $2^k$. Note that the sum is not necessarily in the
+// range $[0, 2p-1]$, but it can be used as operand of all other arithmetic
+// functions in this file since they accept any input that is below $2^{k+1}$.
+
+M25519_INLINE void gfp_add_nr(Word *r, const Word *a, const Word *b)
+{
+  DWord sum = 0;
+  int i;
+  
+  M25519_PROF_INC(GFP_ADD_NR);
+  for (i = 0; i < LEN; i++) {
+    sum += (DWord) a[i] + b[i];
+    r[i] = (Word) sum;
+    sum >>= WSIZE;
+    // sum is in [0, 1]
+  }
+  // the final carry is 0 when $a + b < 2^{k+1}$
+}
+
+
+// Non-reducing subtraction of two field-elements: $r = a - b + p$
+// ---------------------------------------------------------------
+// This function computes $r = a - b + p = a - b + 2^k - c$ as a plain 256-bit
+// operation, i.e., the reduction of the most-significant word of `gfp_sub` is
+// omitted. The constant $-c$ is included as initial value of the (signed) sum
+// and the most-significant word of $2^k$ is added to r[len-1]. The result is
+// only correct when $0 \leq a - b + p < 2^{k+1}$, which is the case, e.g.,
+// when $b \leq p$ and $a < 2^k + c$ (in particular when both operands are
+// fully reduced, whereby $r$ is in the range $[1, 2p]$).
+
+M25519_INLINE void gfp_sub_nr(Word *r, const Word *a, const Word *b)
+{
+  SDWord sum = -((SDWord) CONSTC);  // signed!
+  int i;
+  
+  M25519_PROF_INC(GFP_SUB_NR);
+  for (i = 0; i < LEN - 1; i++) {
+    sum += (SDWord) a[i] - b[i];
+    r[i] = (Word) sum;
+    sum >>= WSIZE;  // arithmetic shift!
+    // sum is in [-2, 1]
+  }
+  r[LEN-1] = a[LEN-1] - b[LEN-1] + ((Word) sum) + MSB1MASK;
+  // 0x80000000 = MSW of 2^k
+}
+
+
+#endif  // #if !defined(M25519_ASSEMBLY_EXT)
+#if (!defined(M25519_ASSEMBLY_EXT) || defined(M25519_OPSTBL))
+
+
+// Repeated squaring of a field-element: $r = a^{2^n} \bmod p$
+// -----------------------------------------------------------
+// This function squares a field-element $n$ times in succession, which is the
+// main operation of exponentiations with a fixed addition chain like that of
+// `gfp_exp_p58`. The C version simply calls `gfp_sqr` $n$ times, whereas the
+// Assembly versions keep the loop inside the function and pass the result of
+// a squaring in registers to the next squaring. When $n \leq 0$, the operand
+// $a$ is copied to $r$. The number of squarings is assumed to be public. In
+// ops-table mode, the C version is used so that the squarings are performed
+// by the installed `gfp_sqr` kernel.
+
+void gfp_sqrn(Word *r, const Word *a, int n)
+{
+  int i;
+  
+  M25519_PROF_INC(GFP_SQRN);
+  if (n <= 0) {
+    mpi_copy(r, a, LEN);
+    return;
+  }
+  gfp_sqr(r, a);
+  for (i = 1; i < n; i++) gfp_sqr(r, r);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+#endif /////////////// COMPOSITE PRIME-FIELD OPERATIONS ///////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// The following functions are non-leaf functions, i.e., they are composed of
+// other field-arithmetic or MPI functions. Only the field-inversion `gfp_inv`
+// is performance-critical.
+
+
+// Full reduction of a field-element: $r = a \bmod p$
+// --------------------------------------------------
+// This function computes the least non-negative residue of a field-element by
+// subtracting the prime $p$ (via `mpi_sub`) and re-adding it if the difference
+// was negative (`mpi_cadd`). Each GF(p) arithmetic function provided in this
+// file produces a result in the range $[0, 2p-1]$, i.e., a single subtraction
+// of $p$ should be sufficient, but an externally assigned field-element can be
+// greater than $2p$. To ensure constant execution time, two subtractions (and
+// two conditional re-additions) of $p$ are performed.
+
+void gfp_fred(Word *r, const Word *a)
+{
+  Word p[LEN];
+  int rbit;  // borrow
+  
+  gfp_setp(p);
+  rbit = mpi_sub(r, a, p, LEN);
+  mpi_cadd(r, r, p, rbit, LEN);
+  rbit = mpi_sub(r, r, p, LEN);
+  mpi_cadd(r, r, p, rbit, LEN);
+}
+
+
+// Comparison of two field-elements: $a \stackrel{?}{=} b$
+// -------------------------------------------------------
+// This function compares two (potentially incompletely reduced) field-elements
+// $a$ and $b$. The return value is `1` when $a > b$, `0` when $a = b$, or `-1`
+// when $a < b$. Each field-element is first fully reduced via two subtractions
+// (and conditional re-additions) of the prime $p$, similar to `gfp_fred`. The
+// comparison is implemented with the goal of having constant (i.e., operand-
+// independent) execution time.
+
+int gfp_cmp(const Word *a, const Word *b)
+{
+  Word tmp[3*LEN];  // temporary space for three gfp elements
+  Word *p = tmp, *ar = &tmp[LEN], *br = &tmp[2*LEN];
+  int rbit;  // borrow
+  
+  gfp_setp(p);
+  // full reduction of a
+  rbit = mpi_sub(ar, a, p, LEN);
+  mpi_cadd(ar, ar, p, rbit, LEN);
+  rbit = mpi_sub(ar, ar, p, LEN);
+  mpi_cadd(ar, ar, p, rbit, LEN);
+  // full reduction of b
+  rbit = mpi_sub(br, b, p, LEN);
+  mpi_cadd(br, br, p, rbit, LEN);
+  rbit = mpi_sub(br, br, p, LEN);
+  mpi_cadd(br, br, p, rbit, LEN);
+  // comparison of a and b
+  rbit = mpi_cmp(ar, br, LEN);
+  
+  return rbit;
+}
+
+
+// Conditional swap of two field-elements: $(a, b) = (b, a)$ or $(a, b)$
+// ---------------------------------------------------------------------
+// This function swaps the field-elements $a$ and $b$ when `swap` is 1 and
+// leaves them unchanged when `swap` is 0. The swap is performed via an AND-
+// masked XOR of the words of $a$ and $b$ so that the execution time and the
+// memory-access pattern do not depend on `swap`.
+
+M25519_INLINE void gfp_cswap(Word *a, Word *b, int swap)
+{
+  Word mask = (Word) (0 - (swap & 1));
+  Word tmp;
+  int i;
+  
+  for (i = 0; i < LEN; i++) {
+    tmp = (a[i] ^ b[i]) & mask;
+    a[i] ^= tmp;
+    b[i] ^= tmp;
+  }
+}
+
+
+#if defined(M25519_SAFEGCD_INV)
+
+
+// Number of divsteps per call of `mpi_divsteps` and number of batches needed
+// to reach $g = 0$ for any $a < p$ (at most 590 divsteps for 256-bit inputs).
+#define DIVSTEPS (WSIZE - 2)
+#define NUMBATCH ((590 + DIVSTEPS - 1)/DIVSTEPS)
+
+// Constant $2^{-600} \bmod p$ to remove the factor $2^{DIVSTEPS \cdot NUMBATCH}$
+static const Word C2M600[LEN] = {
+  0x88DD407E, 0x65683E67, 0xCFC744C9, 0x90AA31A3,
+  0x4E016B14, 0x855B1B22, 0x2C905DC1, 0x4469D942
+};
+
+
+// Update of $f$ and $g$ after a batch of divsteps: $(f, g) = M(f, g)/2^{30}$
+// --------------------------------------------------------------------------
+// The two MPIs $f$ and $g$ are signed integers in two's complement form with
+// an absolute value of less than $2^{255}$. The transition matrix $M$ in `t`,
+// which was obtained by `mpi_divsteps`, consists of four signed words $u, v,
+// q, r$ with $|u| + |v| \leq 2^{30}$ and $|q| + |r| \leq 2^{30}$, so that the
+// products and sums below never overflow a signed double-length word. Since
+// the 30 least-significant bits of $u f + v g$ and $q f + r g$ are always 0,
+// the division by $2^{30}$ is simply a right-shift, which is merged into the
+// loop (the result-words are written one position lower than the operands).
+
+static void gfp_divupd(Word *f, Word *g, const Word *t)
+{
+  SDWord cf, cg;  // signed!
+  Word lf, lg;
+  int32_t u = (int32_t) t[0], v = (int32_t) t[1];
+  int32_t q = (int32_t) t[2], r = (int32_t) t[3];
+  int i;
+  
+  cf = (SDWord) u*f[0] + (SDWord) v*g[0];
+  cg = (SDWord) q*f[0] + (SDWord) r*g[0];
+  lf = (Word) cf; lg = (Word) cg;
+  cf >>= WSIZE; cg >>= WSIZE;  // arithmetic shift!
+  
+  for (i = 1; i < LEN - 1; i++) {
+    cf += (SDWord) u*f[i] + (SDWord) v*g[i];
+    cg += (SDWord) q*f[i] + (SDWord) r*g[i];
+    f[i-1] = (((Word) cf) << 2) | (lf >> DIVSTEPS);
+    g[i-1] = (((Word) cg) << 2) | (lg >> DIVSTEPS);
+    lf = (Word) cf; lg = (Word) cg;
+    cf >>= WSIZE; cg >>= WSIZE;  // arithmetic shift!
+  }
+  // most-significant words of f and g are signed
+  cf += (SDWord) u*((int32_t) f[LEN-1]) + (SDWord) v*((int32_t) g[LEN-1]);
+  cg += (SDWord) q*((int32_t) f[LEN-1]) + (SDWord) r*((int32_t) g[LEN-1]);
+  f[LEN-2] = (((Word) cf) << 2) | (lf >> DIVSTEPS);
+  g[LEN-2] = (((Word) cg) << 2) | (lg >> DIVSTEPS);
+  f[LEN-1] = (Word) (cf >> DIVSTEPS);
+  g[LEN-1] = (Word) (cg >> DIVSTEPS);
+}
+
+
+// Multiplication of a field-element by a signed 32-bit value: $r = a \cdot s$
+// ---------------------------------------------------------------------------
+// The absolute value of `s` is computed without branches and multiplied by
+// $a$ using `gfp_mul32`, and the product is then negated when `s` is negative.
+
+static void gfp_smul32(Word *r, const Word *a, Word s)
+{
+  Word mask = 0 - (s >> (WSIZE - 1));  // 0 or all-1
+  Word abs = (s ^ mask) - mask;
+  
+  gfp_mul32(r, a, &abs);
+  gfp_cneg(r, r, (int) (mask & 1));
+}
+
+
+// Inversion of a non-0 field-element: $r = a^{-1} \bmod p$
+// --------------------------------------------------------
+// This function computes the multiplicative inverse of a non-0 field-element
+// modulo the prime $p$ using the "safegcd" algorithm of Bernstein and Yang in
+// the variant with half-delta (here $\zeta = -\delta - 1/2$), as described in
+// "Fast constant-time gcd computation and modular inversion" (TCHES 2019). The
+// algorithm starts with $f = p$, $g = a \bmod p$, $d = 0$, and $e = 1$, and
+// processes `NUMBATCH` batches of 30 divsteps, each of which is carried out by
+// `mpi_divsteps` on the least-significant words of $f$ and $g$ only, yielding
+// a 2x2 transition matrix $M$. This matrix is then applied to the MPIs $f$ and
+// $g$ (including a division by $2^{30}$) and to the field-elements $d$ and $e$
+// (without division, i.e., only modulo $p$). Hence, after batch $i$, it holds
+// that $f \cdot 2^{30i} \equiv d \cdot a$. The bound of 590 divsteps for 256-bit
+// inputs guarantees that $g = 0$ and $f = \pm 1$ at the end, which means that
+// $a^{-1} = \pm d \cdot 2^{-600} \bmod p$.
+// NOTE: Unlike the EEA-based inversion, this inversion always executes the
+// same sequence of operations, irrespective of the operand, and therefore has
+// constant execution time. No multiplicative masking is needed.
+// NOTE: The function returns `M25519_ERR_INVERS` if the field-element to be
+// inverted is `0` (in which case $r = 0$) and `M25519_NO_ERROR` otherwise.
+
+int gfp_inv(Word *r, const Word *a)
+{
+  Word tmp[6*LEN];  // temporary space for six gfp elements
+  Word *f = tmp, *g = &tmp[LEN], *d = &tmp[2*LEN], *e = &tmp[3*LEN];
+  Word *s1 = &tmp[4*LEN], *s2 = &tmp[5*LEN];
+  Word t[4];  // transition matrix
+  int zeta = -1, retval, i;
+  
+  M25519_PROF_INC(GFP_INV);
+  gfp_setp(f);           // set f = p
+  gfp_fred(g, a);        // set g = a mod p
+  mpi_setw(d, 0, LEN);   // set d = 0
+  mpi_setw(e, 1, LEN);   // set e = 1
+  retval = (mpi_cmpw(g, 0, LEN) == 0) ? M25519_ERR_INVERS : M25519_NO_ERROR;
+  
+  for (i = 0; i < NUMBATCH; i++) {
+    M25519_PROF_INC(GFP_INV_ITER);
+    zeta = mpi_divsteps(t, f[0], g[0], zeta);
+    gfp_divupd(f, g, t);
+    // (d, e) = M*(d, e) mod p
+    gfp_smul32(s1, d, t[0]);  // s1 = u*d
+    gfp_smul32(s2, d, t[2]);  // s2 = q*d
+    gfp_smul32(d, e, t[1]);   // d = v*e
+    gfp_add(d, d, s1);        // d = u*d + v*e
+    gfp_smul32(s1, e, t[3]);  // s1 = r*e
+    gfp_add(e, s1, s2);       // e = q*d + r*e
+  }
+  
+  // now f is either 1 or -1 (or p when a = 0)
+  gfp_mul(r, d, C2M600);
+  gfp_cneg(r, r, (int) (f[LEN-1] >> (WSIZE - 1)));
+  
+  return retval;
+}
+
+
+#else  // EEA-based inversion
+
+
+// Inversion of a non-0 field-element: $r = a^{-1} \bmod p$
+// --------------------------------------------------------
+// This function computes the multiplicative inverse of a non-0 field-element
+// modulo the prime $p$ using an optimized variant of the Extended Euclidean
+// Algorithm (EEA). One of these optimizations is to keep track of the actual
+// length of intermediate results (i.e., `ux` and `vx`) and perform the right-
+// shift operations (`mpi_shr`) and subtractions (`mpi_sub`) only with their
+// non-0 words, which reduces the total execution time as these intermediate
+// results become gradually shorter.
+// NOTE: The EEA has an operand-dependent execution pattern and, therefore, an
+// operand-dependent execution time. However, `gfp_inv` can be efficiently and
+// effectively protected against timing attacks by applying a multiplicative
+// masking technique as follows: the field-element $x$ to be inverted is first
+// multiplied by a field-element $u$ that is unknown to the attacker, then the
+// product $x \cdot u$ is inverted, and finally the inverse $(x \cdot u)^{−1}$
+// is multiplied by $u$ to get $x^{−1}$.
+// NOTE: The function returns `M25519_ERR_INVERS` if the field-element to be
+// inverted is `0` and `M25519_NO_ERROR` otherwise.
+
+int gfp_inv(Word *r, const Word *a)
+{
+  Word tmp[3*LEN];  // temporary space for three gfp elements
+  Word *ux = tmp, *vx = &tmp[LEN], *x1 = &tmp[2*LEN], *x2 = r;
+  int uvlen = LEN;
+  
+  M25519_PROF_INC(GFP_INV);
+  mpi_copy(ux, a, LEN);  // set ux = a
+  gfp_setp(vx);          // set vx = p
+  mpi_setw(x1, 1, LEN);  // set x1 = 1
+  mpi_setw(x2, 0, LEN);  // set x2 = 0
+  
+  while (mpi_cmp(ux, vx, LEN) >= 0) mpi_sub(ux, ux, vx, LEN);
+  if (mpi_cmpw(ux, 0, LEN) == 0) return M25519_ERR_INVERS;
+  
+  while(mpi_cmpw(ux, 1, uvlen) && mpi_cmpw(vx, 1, uvlen)) {
+    M25519_PROF_INC(GFP_INV_ITER);
+    while((ux[0] & 1) == 0) {  // ux is even
+      mpi_shr(ux, ux, uvlen);
+      gfp_hlv(x1, x1);
+    }
+    while((vx[0] & 1) == 0) {  // vx is even
+      mpi_shr(vx, vx, uvlen);
+      gfp_hlv(x2, x2);
+    }
+    // now both ux and vx are odd
+    if (mpi_cmp(ux, vx, uvlen) >= 0) {
+      mpi_sub(ux, ux, vx, uvlen);
+      gfp_sub(x1, x1, x2);
+    } else {
+      mpi_sub(vx, vx, ux, uvlen);
+      gfp_sub(x2, x2, x1);
+    }
+    if ((ux[uvlen-1] == 0) && (vx[uvlen-1] == 0)) uvlen--;
+  }
+  
+  if (mpi_cmpw(ux, 1, LEN) == 0) mpi_copy(r, x1, LEN);
+  return M25519_NO_ERROR;
+}
+
+
+// Constant-time inversion of a field-element: $r = a^{p-2} \bmod p$
+// -----------------------------------------------------------------
+// The exponent $p-2 = 2^{255} - 21$ is processed with the addition chain of
+// Ref10, which consists of 254 squarings and 11 multiplications and shares
+// its first part (up to $a^{2^{250}-1}$) with the chain of `gfp_exp_p58`. The
+// execution time does not depend on $a$, and the result is 0 if $a = 0$.
+
+static void gfp_inv_exp(Word *r, const Word *a)
+{
+  Word tmp[4*LEN];  // temporary space for four gfp elements
+  Word *t0 = tmp, *t1 = &tmp[LEN], *t2 = &tmp[2*LEN], *t3 = &tmp[3*LEN];
+
+  gfp_sqr(t0, a);                               // t0 = a^2
+  gfp_sqrn(t1, t0, 2);                          // t1 = a^8
+  gfp_mul(t1, a, t1);                           // t1 = a^9
+  gfp_mul(t0, t0, t1);                          // t0 = a^11
+  gfp_sqr(t3, t0);                              // t3 = a^22
+  gfp_mul(t3, t1, t3);                          // t3 = a^(2^5-1)
+  gfp_sqrn(t1, t3, 5);
+  gfp_mul(t3, t1, t3);                          // t3 = a^(2^10-1)
+  gfp_sqrn(t1, t3, 10);
+  gfp_mul(t1, t1, t3);                          // t1 = a^(2^20-1)
+  gfp_sqrn(t2, t1, 20);
+  gfp_mul(t1, t2, t1);                          // t1 = a^(2^40-1)
+  gfp_sqrn(t1, t1, 10);
+  gfp_mul(t3, t1, t3);                          // t3 = a^(2^50-1)
+  gfp_sqrn(t1, t3, 50);
+  gfp_mul(t1, t1, t3);                          // t1 = a^(2^100-1)
+  gfp_sqrn(t2, t1, 100);
+  gfp_mul(t1, t2, t1);                          // t1 = a^(2^200-1)
+  gfp_sqrn(t1, t1, 50);
+  gfp_mul(t3, t1, t3);                          // t3 = a^(2^250-1)
+  gfp_sqrn(t3, t3, 5);                          // t3 = a^(2^255-32)
+  gfp_mul(r, t3, t0);                           // r = a^(2^255-21)
+}
+
+
+#endif
+
+
+// Simultaneous inversion of `n` field-elements: $r_i = a_i^{-1} \bmod p$
+// ----------------------------------------------------------------------
+// This function inverts `n` field-elements, which are stored one after the
+// other in the array `a`, using Montgomery's trick, i.e., with only a single
+// inversion and $3(n-1)$ multiplications in GF(p). In a first step, the
+// products $c_i = b_0 \cdot b_1 \cdots b_i$ are computed and stored in the
+// array `scratch`, where $b_i = a_i$, except when $a_i = 0$, in which case
+// $b_i = 1$ (this replacement is carried out with a mask, similar to the zero
+// check itself). Then, the product $c_{n-1}$ of all $b_i$ is inverted, and in
+// a second step, the inverses $r_i = c_{n-1}^{-1} \cdot c_{i-1} \cdot
+// \prod_{j>i} b_j$ are obtained by walking backwards through the array. An
+// inverse $r_i$ is finally set to 0 when $a_i = 0$, which corresponds to the
+// behavior of `gfp_inv`. The arrays `r` and `a` may be the same.
+// NOTE: The product $c_{n-1}$ is inverted in constant time, i.e., with the
+// divsteps-based `gfp_inv` when `M25519_SAFEGCD_INV` is defined and otherwise
+// via the exponentiation $c_{n-1}^{p-2}$ (see `gfp_inv_exp`), since the
+// field-elements are typically coordinates of points that depend on secret
+// scalars (e.g., the Z-coordinates of a batch of X25519 ladders).
+// NOTE: The function returns `M25519_ERR_INVERS` if at least one of the `n`
+// field-elements is `0` and `M25519_NO_ERROR` otherwise. The elements that are
+// `0` can be identified by their result $r_i = 0$.
+
+int gfp_inv_batch(Word *r, const Word *a, int n, Word *scratch)
+{
+  Word inv[LEN], tmp[LEN];
+  Word is0, any0 = 0;
+  int i, j;
+  
+  if (n <= 0) return M25519_NO_ERROR;
+  
+  // c_i = b_0 * b_1 * ... * b_i
+  for (i = 0; i < n; i++) {
+    gfp_fred(tmp, &a[i*LEN]);
+    is0 = (mpi_cmpw(tmp, 0, LEN) == 0);
+    tmp[0] |= is0;  // b_i = 1 when a_i = 0
+    any0 |= is0;
+    if (i == 0) mpi_copy(scratch, tmp, LEN);
+    else gfp_mul(&scratch[i*LEN], &scratch[(i-1)*LEN], tmp);
+  }
+  
+#if defined(M25519_SAFEGCD_INV)
+  gfp_inv(inv, &scratch[(n-1)*LEN]);
+#else
+  gfp_inv_exp(inv, &scratch[(n-1)*LEN]);
+#endif
+  
+  // r_i = (b_0 * ... * b_i)^-1 * (b_0 * ... * b_(i-1))
+  for (i = n - 1; i >= 0; i--) {
+    gfp_fred(tmp, &a[i*LEN]);
+    is0 = 0 - (Word) (mpi_cmpw(tmp, 0, LEN) == 0);  // 0 or all-1
+    tmp[0] |= (is0 & 1);
+    if (i > 0) {
+      gfp_mul(tmp, inv, tmp);  // (b_0 * ... * b_(i-1))^-1
+      gfp_mul(&r[i*LEN], inv, &scratch[(i-1)*LEN]);
+      mpi_copy(inv, tmp, LEN);
+    } else {
+      mpi_copy(r, inv, LEN);
+    }
+    for (j = 0; j < LEN; j++) r[i*LEN+j] &= ~is0;
+  }
+  
+  return (any0 ? M25519_ERR_INVERS : M25519_NO_ERROR);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+////////////////// ADDITIONAL OR ALTERNATIVE IMPLEMENTATIONS //////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+// Subtraction of one field-element from another: $r = a - b \bmod p$
+// ------------------------------------------------------------------
+// The optimized `gfp_sub` function from above requires the right-shift of the
+// signed integer `sum` (inside the loop) to be an arithmetic shift so that its
+// sign is preserved. However, according to the ISO C23 standard, the result of
+// a right-shift depends on the compiler (resp., architecture) when the shifted
+// operand is of a signed type and has a negative value. The function below is
+// an alternative implementation of `gfp_sub` that uses an unsigned `sum` and,
+// thus, avoids shifting a signed type. The modified loop is a bit slower, but
+// more portable, than the original `gfp_sub`.
+
+void gfp_sub_v2(Word *r, const Word *a, const Word *b)
+{
+  DWord sum;
+  Word msw;
+  int i;
+  
+  sum = (DWord) FOURXPHI + a[LEN-1] - b[LEN-1];  // 0x1FFFFFFFC
+  msw = ((Word) sum) & MSB0MASK;  // 0x7FFFFFFF
+  sum = (DWord) CONSTC*((Word) (sum >> (WSIZE - 1)));
+
+  sum += (DWord) FOURXPLO + a[0] - b[0];  // 0x3FFFFFFB4
+  r[0] = (Word) sum;
+  sum >>= WSIZE;
+  
+  for (i = 1; i < LEN - 1; i++) {
+    sum += (DWord) FOURXPMI + a[i] - b[i];  // 0x3FFFFFFFC
+    r[i] = (Word) sum;
+    sum >>= WSIZE;
+  }
+  r[LEN-1] = msw + ((Word) sum);
+}
+
+
+// Conditional negation of a field-element: $r = -a \bmod p$ or $r = a \bmod p$
+// ----------------------------------------------------------------------------
+// The optimized `gfp_cneg` function from above requires the right-shift of the
+// signed integer `sum` (inside the loop) to be an arithmetic shift so that its
+// sign is preserved. However, according to the ISO C23 standard, the result of
+// a right-shift depends on the compiler (resp., architecture) when the shifted
+// operand is of a signed type and has a negative value. The function below is
+// an alternative implementation of `gfp_cneg` that uses an unsigned `sum` and,
+// thus, avoids shifting a signed type. The modified loop is a bit slower, but
+// more portable, than the original `gfp_cneg`.
+
+void gfp_cneg_v2(Word *r, const Word *a, int neg)
+{
+  DWord sum;
+  Word msw, mask;
+  int i;
+
+  mask = 0 - (Word) (neg & 1);  // 0 or all-1
+  sum = (DWord) (FOURXPHI >> 1) + (mask ^ a[LEN-1]);  // 0xFFFFFFFE
+  msw = ((Word) sum) & MSB0MASK;  // 0x7FFFFFFF
+  sum = (DWord) CONSTC*((Word) (sum >> (WSIZE - 1)));
+  sum = sum - (mask & ((CONSTC << 1) - 1));
+
+  sum += (DWord) (FOURXPLO >> 1) + (mask ^ a[0]);  // 0x1FFFFFFDA
+  r[0] = (Word) sum;
+  sum >>= WSIZE;
+
+  for (i = 1; i < LEN - 1; i++) {
+    sum += (DWord) (FOURXPMI >> 1) + (mask ^ a[i]);  // 0x1FFFFFFFE
+    r[i] = (Word) sum;
+    sum >>= WSIZE;
+  }
+  r[LEN-1] = msw + ((Word) sum);
+}
+
+
+// Halving of a field-element: $r = a/2 \bmod p$
+// ---------------------------------------------
+// The optimized `gfp_hlv` function from above requires the right-shift of the
+// signed integer `sum` (inside the loop) to be an arithmetic shift so that its
+// sign is preserved. However, according to the ISO C23 standard, the result of
+// a right-shift depends on the compiler (resp., architecture) when the shifted
+// operand is of a signed type and has a negative value. The function below is
+// an alternative implementation of `gfp_hlv` that uses an unsigned `sum` and,
+// thus, avoids shifting a signed type. The modified loop is a bit slower, but
+// more portable, than the original `gfp_hlv`.
+
+void gfp_hlv_v2(Word *r, const Word *a)
+{
+  DWord sum;
+  Word tmp, mask;
+  int i;
+  
+  // masked addition of prime p to a
+  mask = 0 - (a[0] & 1);  // 0 or all-1
+  sum = (DWord) a[0] + ((0 - CONSTC) & mask);
+  tmp = (Word) sum;
+  sum >>= WSIZE;
+  
+  for (i = 1; i < LEN - 1; i++) {
+    sum += (DWord) a[i] + mask;
+    r[i-1] = (((Word) sum) << (WSIZE - 1)) | (tmp >> 1);
+    tmp = (Word) sum;
+    sum >>= WSIZE;
+  }
+  sum += (DWord) a[LEN-1] + (MSB0MASK & mask);  // 0x7FFFFFFF
+  r[LEN-2] = (((Word) sum) << (WSIZE - 1)) | (tmp >> 1);
+  r[LEN-1] = (Word) (sum >> 1);
+}
+
+
+// Reduction of a product of two field-elements: $r = a \bmod p$
+// -------------------------------------------------------------
+// This function reduces a product of two field-elements, which has a length of
+// $2len$ words, modulo the pseudo-Mersenne prime $p = 2^k - c$. Such a modular
+// reduction is included in `gfp_mul` above. The modular reduction consists of
+// two steps; the first step involves multiplying the higher $len$ words of `a`
+// by $2c$ and adding the product to the lower $len$ words of `a`. The obtained
+// intermediate result comprises $len+1$ words, of which the most-significant
+// word is up to $WSIZE-1$ bits long. Thereafter, the second step is similar to
+// the reduction-step of the addition in GF(p).
+
+void gfp_red(Word *r, const Word *a)
+{
+  DWord sum, prod = 0;
+  Word msw;
+  int i;
+  
+  // first step of modular reduction
+  for (i = 0; i < LEN - 1; i++) {
+    prod += (DWord) a[i+LEN]*(CONSTC << 1) + a[i];
+    r[i] = (Word) prod;
+    prod >>= WSIZE;
+  }
+  prod += (DWord) a[2*LEN-1]*(CONSTC << 1) + a[LEN-1];
+  // prod is in [0, 2^(2*WSIZE-1)-1]
+  
+  // second step of modular reduction
+  msw = ((Word) prod) & MSB0MASK;  // 0x7FFFFFFF
+  sum = (DWord) CONSTC*(prod >> (WSIZE - 1));
+  for (i = 0; i < LEN - 1; i++) {
+    sum += r[i];
+    r[i] = (Word) sum;
+    sum >>= WSIZE;
+  }
+  r[LEN-1] = msw + ((Word) sum);
+}
+
+
+// Reduction of a product of a field-element by a 32-bit value: $r = a \bmod p$
+// ----------------------------------------------------------------------------
+// This function reduces a product of a field-element and a 32-bit value, which
+// has a length of $len+32/WSIZE$ words, modulo the pseudo-Mersenne prime $p =
+// 2^k - c$. Such a modular reduction is included in `gfp_mul32` above. This
+// reduction differs slightly from the reduction of the normal multiplication
+// in GF(p) and starts with a multiplication the $32/WSIZE$ higher words of `a`
+// by $2c$ and an addition of $c$ to this product if the MSB of a[len-1] is 1.
+// Then, the lower $32/WSIZE$ words of the obtained sum (which is $32/WSIZE+1$
+// words long) are added to the $32/WSIZE$ least-significant words of `a`. The
+// produced carry is added along with the highest sum-word to a[32/WSIZE] and
+// the resulting carry is propagated up to the most-significant word a[len-1],
+// whose MSB has been cleared before the carry propagation.
+
+void gfp_red32(Word *r, const Word *a)
+{
+  DWord prod;
+  Word msw;
+  int i;
+  
+  prod = (DWord) CONSTC*(a[LEN-1] >> (WSIZE - 1));
+  msw = a[LEN-1] & MSB0MASK;  // 0x7FFFFFFF
+  
+  // compute first 32 bits of result
+  prod += (DWord) a[LEN]*(CONSTC << 1) + a[0];
+  r[0] = (Word) prod;
+  prod >>= WSIZE;
+  
+  // compute r[i] = a[i] + carry
+  for (i = 1; i < LEN - 1; i++) {
+    prod += (DWord) a[i];
+    r[i] = (Word) prod;
+    prod >>= WSIZE;
+  }
+  r[LEN-1] = ((Word) prod) + msw;
+}
+*/
+
+#undef ALL1MASK
+#undef MSB1MASK
+#undef MSB0MASK
+#undef MIN4MASK
+#undef FOURXPHI
+#undef FOURXPMI
+#undef FOURXPLO
+#undef MAX
+#undef ACC_ADDW
+#undef MUL_ADDC
+#undef MUL_ACC2
+#undef MUL_ROW0
+#undef MUL_ROWI
+#undef RED_2STEP
+#undef SQR_DIAG
+#undef DIVSTEPS
+#undef NUMBATCH
+
+///////////////////////////////////////////////////////////////////////////////
+// src/host64/gfparith51.c                                                   //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+// This file contains 64-bit C implementations of the performance-critical
+// arithmetic operations in the prime field GF(p) with $p = 2^{255} - 19$ for
+// "host-class" processors like x86-64 or AArch64, which have a 64-bit integer
+// multiplier that produces a 128-bit product. These functions replace their
+// generic 32-bit counterparts in `gfparith.c` when `M25519_HOST64` is defined
+// (see `config.h`). The field-elements are passed in the same way as on 32-bit
+// platforms, i.e., as Word-arrays of length `LEN` = 8, which means the API of
+// the library is not affected at all. However, the functions below access the
+// Word-arrays in pairs of two words, i.e., as four 64-bit words.
+
+// The addition, subtraction, conditional negation and halving operate on four
+// 64-bit words and use the same algorithms as the 32-bit functions. On the
+// other hand, the multiplication, squaring and multiplication by a 32-bit
+// integer convert their operands to a radix-$2^{51}$ representation with five
+// limbs (i.e., 51-bit chunks stored in 64-bit words), which leaves enough room
+// to accumulate the limb-products in 128-bit words without carry propagation.
+// The pre-multiplication of the upper limbs by $c = 19$ integrates a major
+// part of the reduction modulo $p$ into the product computation. The result
+// is converted back to the radix-$2^{32}$ representation and is in the range
+// $[0, 2p-1]$, similar to the 32-bit functions.
+
+
+
+
+#if defined(M25519_HOST64)
+
+
+// `QWord` is an unsigned and `SQWord` a signed quad-length word (128 bits)
+typedef unsigned __int128 QWord;
+typedef __int128 SQWord;
+
+// Number of 64-bit words and 51-bit limbs of a field-element
+#define LEN64 (LEN/2)
+#define LEN51 5
+
+// All-1 Mask: 0xFFFFFFFFFFFFFFFF
+#define ALL1MASK ((DWord) -1LL)
+// MSB-1 Mask: 0x8000000000000000
+#define MSB1MASK ((DWord) (1ULL << 63))
+// MSB-0 Mask: 0x7FFFFFFFFFFFFFFF
+#define MSB0MASK (ALL1MASK >> 1)
+// Minus-4 Mask: 0xFFFFFFFFFFFFFFFC
+#define MIN4MASK ((DWord) -4LL)
+// 4*p[LEN64-1]: 0x1FFFFFFFFFFFFFFFC (65 bits long)
+#define FOURXPHI (((QWord) MSB0MASK) << 2)
+// Limb Mask: 0x7FFFFFFFFFFFF (51 bits)
+#define LIMBMASK (ALL1MASK >> 13)
+
+
+// Loading and storing of a 64-bit word from/to a Word-array
+// ---------------------------------------------------------
+// These two helper functions combine the two 32-bit words a[2i] and a[2i+1]
+// to a 64-bit word and split a 64-bit word into two 32-bit words. Compilers
+// for little-endian targets translate them into a single load or store.
+
+static DWord gfp_ld64(const Word *a, int i)
+{
+  return (((DWord) a[2*i+1]) << 32) | a[2*i];
+}
+
+static void gfp_st64(Word *r, int i, DWord w)
+{
+  r[2*i] = (Word) w;
+  r[2*i+1] = (Word) (w >> 32);
+}
+
+
+// Conversion of a field-element to radix-$2^{51}$ representation
+// ---------------------------------------------------------------
+// The operand $a$, which can be up to 256 bits long, is split up into five
+// limbs, of which the lower four are 51 bits long and the highest limb has a
+// length of up to 52 bits.
+
+static void gfp_to51(DWord *l, const Word *a)
+{
+  DWord w0 = gfp_ld64(a, 0), w1 = gfp_ld64(a, 1);
+  DWord w2 = gfp_ld64(a, 2), w3 = gfp_ld64(a, 3);
+  
+  l[0] = w0 & LIMBMASK;
+  l[1] = ((w0 >> 51) | (w1 << 13)) & LIMBMASK;
+  l[2] = ((w1 >> 38) | (w2 << 26)) & LIMBMASK;
+  l[3] = ((w2 >> 25) | (w3 << 39)) & LIMBMASK;
+  l[4] = w3 >> 12;  // up to 52 bits
+}
+
+
+// Carry propagation and conversion to radix-$2^{32}$ representation
+// -----------------------------------------------------------------
+// The five column-sums in `t`, each of which can be up to 115 bits long, are
+// reduced to 51-bit limbs through a carry propagation from t[0] to t[4]. The
+// carry from t[4] (representing a multiple of $2^{255}$) is multiplied by $c$
+// and added to the lowest limb, which yields a result that is less than $2p$.
+// Finally, the limbs are packed into four 64-bit words stored in array `r`.
+
+static void gfp_from51(Word *r, QWord *t)
+{
+  DWord l[LEN51];
+  QWord sum;
+  int i;
+  
+  for (i = 0; i < LEN51 - 1; i++) {
+    t[i+1] += (DWord) (t[i] >> 51);
+    l[i] = ((DWord) t[i]) & LIMBMASK;
+  }
+  l[LEN51-1] = ((DWord) t[LEN51-1]) & LIMBMASK;
+  sum = (QWord) CONSTC*((DWord) (t[LEN51-1] >> 51)) + l[0];
+  l[0] = ((DWord) sum) & LIMBMASK;
+  l[1] += (DWord) (sum >> 51);
+  // r is in [0, 2^255 + 2^67], i.e., less than 2p
+  
+  sum = (QWord) l[0] + (((QWord) l[1]) << 51);
+  gfp_st64(r, 0, (DWord) sum);
+  sum = (sum >> 64) + (((QWord) l[2]) << 38);
+  gfp_st64(r, 1, (DWord) sum);
+  sum = (sum >> 64) + (((QWord) l[3]) << 25);
+  gfp_st64(r, 2, (DWord) sum);
+  sum = (sum >> 64) + (((QWord) l[4]) << 12);
+  gfp_st64(r, 3, (DWord) sum);
+}
+
+
+// Addition of two field-elements: $r = a + b \bmod p$
+// ---------------------------------------------------
+// This function uses the same algorithm as the 32-bit version in `gfparith.c`
+// (i.e., the reduction is integrated into the addition, which starts with the
+// most-significant words) but operates on 64-bit words.
+
+M25519_INLINE void gfp_add(Word *r, const Word *a, const Word *b)
+{
+  QWord sum;
+  DWord msw;
+  int i;
+  
+  M25519_PROF_INC(GFP_ADD);
+  sum = (QWord) gfp_ld64(a, LEN64-1) + gfp_ld64(b, LEN64-1);
+  msw = ((DWord) sum) & MSB0MASK;  // 0x7FFFFFFFFFFFFFFF
+  sum = (QWord) CONSTC*((DWord) (sum >> 63));
+  // sum is in [0, 3*c]
+  
+  for (i = 0; i < LEN64 - 1; i++) {
+    sum += (QWord) gfp_ld64(a, i) + gfp_ld64(b, i);
+    gfp_st64(r, i, (DWord) sum);
+    sum >>= 64;
+    // sum is in [0, 2]
+  }
+  gfp_st64(r, LEN64-1, msw + ((DWord) sum));
+}
+
+
+// Subtraction of one field-element from another: $r = a - b \bmod p$
+// ------------------------------------------------------------------
+// This function uses the same algorithm as the 32-bit version in `gfparith.c`
+// (i.e., $4p$ is added to the difference to ensure the result is positive),
+// but operates on 64-bit words.
+
+M25519_INLINE void gfp_sub(Word *r, const Word *a, const Word *b)
+{
+  SQWord sum;  // signed!
+  DWord msw;
+  int i;
+  
+  M25519_PROF_INC(GFP_SUB);
+  sum = (SQWord) FOURXPHI + gfp_ld64(a, LEN64-1) - gfp_ld64(b, LEN64-1);
+  msw = ((DWord) sum) & MSB0MASK;  // 0x7FFFFFFFFFFFFFFF
+  sum = (SQWord) CONSTC*((DWord) (sum >> 63));
+  sum = sum - (CONSTC << 2);
+  // sum is in [-3*c, c]
+  
+  for (i = 0; i < LEN64 - 1; i++) {
+    sum += (SQWord) gfp_ld64(a, i) - gfp_ld64(b, i);
+    gfp_st64(r, i, (DWord) sum);
+    sum >>= 64;  // arithmetic shift!
+    // sum is in [-2, 1]
+  }
+  gfp_st64(r, LEN64-1, msw + ((DWord) sum) + 4);
+}
+
+
+// Conditional negation of a field-element: $r = -a \bmod p$ or $r = a \bmod p$
+// ----------------------------------------------------------------------------
+// This function uses the same algorithm as the 32-bit version in `gfparith.c`
+// (i.e., $r = 4p - a$ or $r = 2p + a$ is computed), but operates on 64-bit
+// words.
+
+M25519_INLINE void gfp_cneg(Word *r, const Word *a, int neg)
+{
+  SQWord sum;  // signed!
+  DWord msw, mask;
+  int i;
+  
+  M25519_PROF_INC(GFP_CNEG);
+  mask = 0 - (DWord) (neg & 1);  // 0 or all-1
+  sum = (SQWord) MIN4MASK + (mask ^ gfp_ld64(a, LEN64-1));
+  msw = ((DWord) sum) & MSB0MASK;  // 0x7FFFFFFFFFFFFFFF
+  sum = (SQWord) CONSTC*((DWord) (sum >> 63));
+  sum = sum - (CONSTC << 1) - (mask & ((CONSTC << 1) - 1));
+  
+  for (i = 0; i < LEN64 - 1; i++) {
+    sum += (SQWord) (mask ^ gfp_ld64(a, i));
+    gfp_st64(r, i, (DWord) sum);
+    sum >>= 64;  // arithmetic shift!
+    // sum is in [-1, 1]
+  }
+  gfp_st64(r, LEN64-1, msw + ((DWord) sum) + 4);
+}
+
+
+// Halving of a field-element: $r = a/2 \bmod p$
+// ---------------------------------------------
+// This function uses the same algorithm as the 32-bit version in `gfparith.c`
+// (i.e., $p$ is added to $a$ if $a$ is odd, followed by a 1-bit right-shift),
+// but operates on 64-bit words.
+
+M25519_INLINE void gfp_hlv(Word *r, const Word *a)
+{
+  SQWord sum;  // signed!
+  DWord tmp, mask;
+  int i;
+  
+  M25519_PROF_INC(GFP_HLV);
+  // masked addition of prime p to a
+  mask = 0 - (gfp_ld64(a, 0) & 1);  // 0 or all-1
+  sum = (SQWord) gfp_ld64(a, 0) - (CONSTC & mask);
+  tmp = (DWord) sum;
+  sum >>= 64;  // arithmetic shift!
+  // sum is in [-1, 0]
+  
+  for (i = 1; i < LEN64 - 1; i++) {
+    sum += (SQWord) gfp_ld64(a, i);
+    gfp_st64(r, i-1, (((DWord) sum) << 63) | (tmp >> 1));
+    tmp = (DWord) sum;
+    sum >>= 64;  // arithmetic shift!
+    // sum is in [-1, 0]
+  }
+  sum += (SQWord) gfp_ld64(a, LEN64-1) + (MSB1MASK & mask);
+  gfp_st64(r, LEN64-2, (((DWord) sum) << 63) | (tmp >> 1));
+  gfp_st64(r, LEN64-1, (DWord) (sum >> 1));
+}
+
+
+// Multiplication of two field-elements: $r = a \cdot b \bmod p$
+// -------------------------------------------------------------
+// Both operands are converted to radix-$2^{51}$ representation, whereby the
+// limbs of $b$ are additionally multiplied by $c = 19$. Each of the five
+// column-sums t[i] is the sum of the products a[j]*b[i-j] for $j \le i$ and
+// a[j]*19*b[5+i-j] for $j > i$ (since $2^{255} \equiv 19 \bmod p$). A column-
+// sum consists of five products of up to 109 bits and fits in a `QWord`.
+
+void gfp_mul(Word *r, const Word *a, const Word *b)
+{
+  DWord al[LEN51], bl[LEN51], bc[LEN51];
+  QWord t[LEN51];
+  int i, j;
+  
+  M25519_PROF_INC(GFP_MUL);
+  gfp_to51(al, a);
+  gfp_to51(bl, b);
+  for (i = 0; i < LEN51; i++) bc[i] = CONSTC*bl[i];
+  
+  for (i = 0; i < LEN51; i++) {
+    t[i] = 0;
+    for (j = 0; j <= i; j++) t[i] += (QWord) al[j]*bl[i-j];
+    for (j = i + 1; j < LEN51; j++) t[i] += (QWord) al[j]*bc[LEN51+i-j];
+  }
+  
+  gfp_from51(r, t);
+}
+
+
+// Squaring of a field-element: $r = a^2 \bmod p$
+// ----------------------------------------------
+// The squaring is similar to the multiplication, but exploits the fact that
+// each product a[i]*a[j] with $i \ne j$ appears twice, which means only 15
+// instead of 25 limb-products have to be computed.
+
+void gfp_sqr(Word *r, const Word *a)
+{
+  DWord al[LEN51], ad[LEN51], ac[LEN51];
+  QWord t[LEN51];
+  int i;
+  
+  M25519_PROF_INC(GFP_SQR);
+  gfp_to51(al, a);
+  for (i = 0; i < LEN51; i++) {
+    ad[i] = al[i] << 1;    // 2*a[i]
+    ac[i] = CONSTC*al[i];  // 19*a[i]
+  }
+  
+  t[0] = (QWord) al[0]*al[0] + (QWord) ad[1]*ac[4] + (QWord) ad[2]*ac[3];
+  t[1] = (QWord) ad[0]*al[1] + (QWord) ad[2]*ac[4] + (QWord) al[3]*ac[3];
+  t[2] = (QWord) ad[0]*al[2] + (QWord) al[1]*al[1] + (QWord) ad[3]*ac[4];
+  t[3] = (QWord) ad[0]*al[3] + (QWord) ad[1]*al[2] + (QWord) al[4]*ac[4];
+  t[4] = (QWord) ad[0]*al[4] + (QWord) ad[1]*al[3] + (QWord) al[2]*al[2];
+  
+  gfp_from51(r, t);
+}
+
+
+// Multiplication of a field-element by a 32-bit value: $r = a \cdot b \bmod p$
+// ----------------------------------------------------------------------------
+// Operand $a$ is converted to radix-$2^{51}$ representation and each limb is
+// multiplied by the 32-bit integer b[0], which yields five products of up to
+// 84 bits that are reduced in the same way as the column-sums of `gfp_mul`.
+
+void gfp_mul32(Word *r, const Word *a, const Word *b)
+{
+  DWord al[LEN51];
+  QWord t[LEN51];
+  int i;
+  
+  M25519_PROF_INC(GFP_MUL32);
+  gfp_to51(al, a);
+  for (i = 0; i < LEN51; i++) t[i] = (QWord) al[i]*b[0];
+  
+  gfp_from51(r, t);
+}
+
+
+#endif  // #if defined(M25519_HOST64)
+
+#undef LEN64
+#undef LEN51
+#undef ALL1MASK
+#undef MSB1MASK
+#undef MSB0MASK
+#undef MIN4MASK
+#undef FOURXPHI
+#undef LIMBMASK
+
+///////////////////////////////////////////////////////////////////////////////
+// src/gfparith4.c                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#define gfp4_carry gfparith4_gfp4_carry
+
+
+// The functions in this file perform arithmetic operations on four independent
+// elements of the prime field GF(p) with $p = 2^{255} - 19$ at once, which is
+// useful for server-class processors that execute many X25519 computations (or
+// other scalar multiplications) in parallel. A vector of four field-elements
+// is stored in a Word-array of length `LEN4` = 40. Each field-element consists
+// of ten limbs in radix $2^{25.5}$, i.e., the limbs with an even index are 26
+// bits long and the limbs with an odd index 25 bits, and the limbs are stored
+// lane-interleaved: a[4*i+j] is the i-th limb of the element in lane j. This
+// layout allows a SIMD implementation to load the i-th limbs of all four lanes
+// with a single (128-bit) load instruction. Vectors are converted from/to the
+// conventional Word-array representation with `gfp4_pack` and `gfp4_unpack`.
+
+// The representation in radix $2^{25.5}$ leaves enough headroom in the 32-bit
+// words to pre-multiply a limb by $2 \cdot 19$ and to accumulate the 64-bit
+// limb-products of a multiplication without carry propagation. All functions
+// end with a carry propagation that consists of two interleaved chains (from
+// limb 0 and limb 5), which yields a result whose limbs are 26 or 25 bits long,
+// except of limb 1 and limb 6, which may exceed this length by a small carry
+// of at most 16 bits. Every function accepts operands in this form, and the
+// result of `gfp4_unpack` is in the range $[0, 2p-1]$, similar to the results
+// of the arithmetic functions in `gfparith.c`.
+
+// The C implementations below process the four lanes one after the other and
+// serve as reference for (and produce exactly the same limbs as) the AVX2 and
+// NEON implementations in `simd/gfparith4_avx2.c` and `simd/gfparith4_neon.c`,
+// which are used instead when `M25519_SIMD` is defined (see `config.h`).
+
+
+
+
+// Limb masks: 0x3FFFFFF (26 bits) and 0x1FFFFFF (25 bits)
+#define MASK26 ((Word) 0x3FFFFFFUL)
+#define MASK25 ((Word) 0x1FFFFFFUL)
+// Limbs of 2*p: 0x7FFFFDA (limb 0), 0x7FFFFFE (even), 0x3FFFFFE (odd)
+#define TWOPL0 ((Word) 0x7FFFFDAUL)
+#define TWOPEV ((Word) 0x7FFFFFEUL)
+#define TWOPOD ((Word) 0x3FFFFFEUL)
+
+
+// Conversion of four field-elements to a vector: $r = (a_0, a_1, a_2, a_3)$
+// --------------------------------------------------------------------------
+// The four field-elements are stored consecutively in array `a` (i.e., `a` has
+// a length of 4*LEN words) and can be up to 256 bits long. The MSB (bit 255)
+// of each element is reduced modulo $p$ by adding $19$ to the lowest limb and
+// the remaining 255 bits are split up into ten limbs at the bit-positions
+// $\lceil 25.5i \rceil$, i.e., 0, 26, 51, 77, 102, 128, 153, 179, 204, 230.
+
+void gfp4_pack(Word *r, const Word *a)
+{
+  DWord tmp;
+  int i, j, pos;
+
+  for (j = 0; j < NUMLANES; j++) {
+    for (i = 0; i < NUMLIMBS; i++) {
+      pos = (51*i + 1) >> 1;  // bit-position of i-th limb
+      tmp = (DWord) a[pos/WSIZE];
+      if (pos/WSIZE < LEN - 1) tmp |= ((DWord) a[pos/WSIZE+1]) << WSIZE;
+      r[NUMLANES*i+j] = ((Word) (tmp >> (pos % WSIZE))) & \
+                        ((i & 1) ? MASK25 : MASK26);
+    }
+    r[j] += CONSTC*(a[LEN-1] >> (WSIZE - 1));
+    a += LEN;
+  }
+}
+
+
+// Conversion of a vector to four field-elements: $(r_0, r_1, r_2, r_3) = a$
+// --------------------------------------------------------------------------
+// The ten limbs of each lane are shifted to their bit-position and added up
+// in 64-bit words so that limbs exceeding their nominal length are handled
+// properly. The obtained field-elements are stored consecutively in array `r`
+// and are in the range $[0, 2p-1]$.
+
+void gfp4_unpack(Word *r, const Word *a)
+{
+  DWord t[LEN], sum;
+  int i, j, pos;
+
+  for (j = 0; j < NUMLANES; j++) {
+    for (i = 0; i < LEN; i++) t[i] = 0;
+    for (i = 0; i < NUMLIMBS; i++) {
+      pos = (51*i + 1) >> 1;  // bit-position of i-th limb
+      sum = ((DWord) a[NUMLANES*i+j]) << (pos % WSIZE);
+      t[pos/WSIZE] += (Word) sum;
+      // highest limb does not exceed the 256-bit range
+      if (pos/WSIZE < LEN - 1) t[pos/WSIZE+1] += sum >> WSIZE;
+    }
+    sum = 0;
+    for (i = 0; i < LEN; i++) {
+      sum += t[i];
+      r[i] = (Word) sum;
+      sum >>= WSIZE;
+    }
+    r += LEN;
+  }
+}
+
+
+// Conditional swap of two vectors: $(a_j, b_j) = (b_j, a_j)$ or $(a_j, b_j)$
+// --------------------------------------------------------------------------
+// Bit j of operand `swap` specifies whether the field-elements in lane j of
+// $a$ and $b$ are swapped (bit is 1) or not (bit is 0). Similar to `gfp_cswap`,
+// the swap is performed via an AND-masked XOR. Since the lanes are interleaved,
+// the mask for a[i] depends only on $i \bmod 4$.
+
+void gfp4_cswap(Word *a, Word *b, int swap)
+{
+  Word mask[NUMLANES], tmp;
+  int i;
+
+  for (i = 0; i < NUMLANES; i++) mask[i] = 0 - ((Word) ((swap >> i) & 1));
+
+  for (i = 0; i < LEN4; i++) {
+    tmp = (a[i] ^ b[i]) & mask[i % NUMLANES];
+    a[i] ^= tmp;
+    b[i] ^= tmp;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//////////////////// PERFORMANCE-CRITICAL PRIME-FIELD OPERATIONS //////////////
+#if !defined(M25519_SIMD) /////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Carry propagation of the limbs of a single lane
+// -----------------------------------------------
+// The ten 64-bit limbs in `h` are carried in two interleaved chains starting
+// at limb 0 and limb 5, respectively. The carry out of limb 9 is multiplied by
+// $c = 19$ and added to limb 0. The limbs of the result are stored in lane `j`
+// of vector `r`.
+
+static void gfp4_carry(Word *r, DWord *h, int j)
+{
+  int i;
+
+  for (i = 0; i < NUMLIMBS/2; i++) {
+    h[i+1] += h[i] >> (26 - (i & 1));
+    h[i] &= ((i & 1) ? MASK25 : MASK26);
+    if (i + 6 < NUMLIMBS) {
+      h[i+6] += h[i+5] >> (25 + (i & 1));
+      h[i+5] &= ((i & 1) ? MASK26 : MASK25);
+    }
+  }
+  h[0] += CONSTC*(h[NUMLIMBS-1] >> 25);
+  h[NUMLIMBS-1] &= MASK25;
+  h[6] += h[5] >> 25;
+  h[5] &= MASK25;
+  h[1] += h[0] >> 26;
+  h[0] &= MASK26;
+
+  for (i = 0; i < NUMLIMBS; i++) r[NUMLANES*i+j] = (Word) h[i];
+}
+
+
+// Addition of two vectors: $r = a + b \bmod p$
+// --------------------------------------------
+// The limbs of $a$ and $b$ are added lane-wise and the sums are carried.
+
+void gfp4_add(Word *r, const Word *a, const Word *b)
+{
+  DWord h[NUMLIMBS];
+  int i, j;
+
+  for (j = 0; j < NUMLANES; j++) {
+    for (i = 0; i < NUMLIMBS; i++) {
+      h[i] = (DWord) a[NUMLANES*i+j] + b[NUMLANES*i+j];
+    }
+    gfp4_carry(r, h, j);
+  }
+}
+
+
+// Subtraction of two vectors: $r = a - b \bmod p$
+// -----------------------------------------------
+// To ensure that the limbs of the difference are positive, $2p$ is included
+// in the subtraction, i.e., $r = a + 2p - b$ is computed limb-wise. Each limb
+// of $2p$ is at least as big as the corresponding limb of $b$.
+
+void gfp4_sub(Word *r, const Word *a, const Word *b)
+{
+  DWord h[NUMLIMBS];
+  int i, j;
+
+  for (j = 0; j < NUMLANES; j++) {
+    h[0] = (DWord) a[j] + TWOPL0 - b[j];
+    for (i = 1; i < NUMLIMBS; i++) {
+      h[i] = (DWord) a[NUMLANES*i+j] + ((i & 1) ? TWOPOD : TWOPEV) - \
+             b[NUMLANES*i+j];
+    }
+    gfp4_carry(r, h, j);
+  }
+}
+
+
+// Conditional negation of a vector: $r = -a \bmod p$ or $r = a \bmod p$
+// ---------------------------------------------------------------------
+// Bit j of operand `neg` specifies whether the element in lane j is negated
+// (bit is 1) or not (bit is 0). The negation is computed as $2p - a$ and then
+// selected with an AND-mask, so that the execution time is independent of
+// `neg`.
+
+void gfp4_cneg(Word *r, const Word *a, int neg)
+{
+  DWord h[NUMLIMBS];
+  Word ai, msk;
+  int i, j;
+
+  for (j = 0; j < NUMLANES; j++) {
+    msk = 0 - ((Word) ((neg >> j) & 1));
+    ai = a[j];
+    h[0] = ai ^ ((ai ^ (TWOPL0 - ai)) & msk);
+    for (i = 1; i < NUMLIMBS; i++) {
+      ai = a[NUMLANES*i+j];
+      h[i] = ai ^ ((ai ^ (((i & 1) ? TWOPOD : TWOPEV) - ai)) & msk);
+    }
+    gfp4_carry(r, h, j);
+  }
+}
+
+
+// Multiplication of two vectors: $r = a \cdot b \bmod p$
+// ------------------------------------------------------
+// The limb-product a[i]*b[k] contributes to column $i+k$ when $i+k < 10$ and
+// to column $i+k-10$ (after a multiplication by $c = 19$) otherwise. Because
+// of the radix $2^{25.5}$, the product of two odd-indexed limbs has to be
+// doubled. Both factors, i.e., $2 a_i$ and $19 b_k$, fit into 32 bits, and
+// the column-sums do not exceed 61 bits.
+
+void gfp4_mul(Word *r, const Word *a, const Word *b)
+{
+  DWord h[NUMLIMBS];
+  Word al[NUMLIMBS], bl[NUMLIMBS], b19[NUMLIMBS];
+  int i, j, k;
+
+  for (j = 0; j < NUMLANES; j++) {
+    for (i = 0; i < NUMLIMBS; i++) {
+      al[i] = a[NUMLANES*i+j];
+      bl[i] = b[NUMLANES*i+j];
+      b19[i] = CONSTC*bl[i];
+      h[i] = 0;
+    }
+    for (i = 0; i < NUMLIMBS; i++) {
+      for (k = 0; k < NUMLIMBS - i; k++) {
+        h[i+k] += (DWord) (al[i] << (i & k & 1))*bl[k];
+      }
+      for (k = NUMLIMBS - i; k < NUMLIMBS; k++) {
+        h[i+k-NUMLIMBS] += (DWord) (al[i] << (i & k & 1))*b19[k];
+      }
+    }
+    gfp4_carry(r, h, j);
+  }
+}
+
+
+// Squaring of a vector: $r = a^2 \bmod p$
+// ---------------------------------------
+// Similar to the multiplication, but only the limb-products a[i]*a[k] with
+// $i \leq k$ are computed and the products with $i < k$ are doubled. The
+// factors $2 a_i$ and $a_k$ (pre-multiplied by 2, 19 or 38) fit into 32 bits.
+
+void gfp4_sqr(Word *r, const Word *a)
+{
+  DWord h[NUMLIMBS];
+  Word al[NUMLIMBS], ak;
+  int i, j, k;
+
+  for (j = 0; j < NUMLANES; j++) {
+    for (i = 0; i < NUMLIMBS; i++) {
+      al[i] = a[NUMLANES*i+j];
+      h[i] = 0;
+    }
+    for (i = 0; i < NUMLIMBS; i++) {
+      for (k = i; k < NUMLIMBS; k++) {
+        ak = al[k] << (i & k & 1);
+        if (i + k < NUMLIMBS) {
+          h[i+k] += (DWord) (al[i] << (i != k))*ak;
+        } else {
+          h[i+k-NUMLIMBS] += (DWord) (al[i] << (i != k))*(CONSTC*ak);
+        }
+      }
+    }
+    gfp4_carry(r, h, j);
+  }
+}
+
+
+// Multiplication of a vector by a 32-bit value: $r = a \cdot b \bmod p$
+// ---------------------------------------------------------------------
+// All four lanes are multiplied by the same 32-bit integer b[0], i.e., `b` is
+// a single Word (like in `gfp_mul32`) and not a vector.
+
+void gfp4_mul32(Word *r, const Word *a, const Word *b)
+{
+  DWord h[NUMLIMBS];
+  int i, j;
+
+  for (j = 0; j < NUMLANES; j++) {
+    for (i = 0; i < NUMLIMBS; i++) h[i] = (DWord) a[NUMLANES*i+j]*b[0];
+    gfp4_carry(r, h, j);
+  }
+}
+
+
+#endif /////////////// PERFORMANCE-CRITICAL PRIME-FIELD OPERATIONS /////////////
+
+#undef MASK26
+#undef MASK25
+#undef TWOPL0
+#undef TWOPEV
+#undef TWOPOD
+#undef gfp4_carry
+
+///////////////////////////////////////////////////////////////////////////////
+// src/simd/gfparith4_avx2.c                                                 //
+///////////////////////////////////////////////////////////////////////////////
+
+#define gfp4_carry gfparith4_avx2_gfp4_carry
+
+
+// This file contains AVX2 implementations of the four-way parallel arithmetic
+// operations in GF(p), which replace the C versions in `gfparith4.c` when
+// `M25519_SIMD` is defined and the compiler targets an x86-64 processor with
+// AVX2 extension (see `config.h`). The i-th limbs of the four lanes (stored
+// in four consecutive 32-bit words) are loaded into a 256-bit register and
+// zero-extended to four 64-bit words, so that the `vpmuludq` instruction can
+// compute four 32 x 32 -> 64-bit limb-products at once. The algorithms (and
+// the order of the carry propagation) are exactly the same as those of the C
+// versions, i.e., both implementations produce identical results.
+
+
+
+
+#if (defined(M25519_SIMD) && defined(__AVX2__))
+
+
+#include <immintrin.h>
+
+
+// Limb masks: 0x3FFFFFF (26 bits) and 0x1FFFFFF (25 bits)
+#define MASK26 0x3FFFFFFLL
+#define MASK25 0x1FFFFFFLL
+// Limbs of 2*p: 0x7FFFFDA (limb 0), 0x7FFFFFE (even), 0x3FFFFFE (odd)
+#define TWOPL0 0x7FFFFDALL
+#define TWOPEV 0x7FFFFFELL
+#define TWOPOD 0x3FFFFFELL
+
+
+// Loading and storing of the i-th limbs of the four lanes
+// -------------------------------------------------------
+// The four 32-bit limbs a[4*i], ..., a[4*i+3] are zero-extended to 64 bits
+// when loaded. Before storing, the lower 32-bit halves of the four 64-bit words
+// are gathered in the lower 128 bits of the register.
+
+static __m256i gfp4_ld(const Word *a, int i)
+{
+  return _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *) &a[4*i]));
+}
+
+static void gfp4_st(Word *r, int i, __m256i x)
+{
+  x = _mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7));
+  _mm_storeu_si128((__m128i *) &r[4*i], _mm256_castsi256_si128(x));
+}
+
+
+// Carry propagation of the limbs of all four lanes
+// ------------------------------------------------
+// Same as in `gfparith4.c`: two interleaved chains starting at limb 0 and limb
+// 5. The multiplication of the carry out of limb 9 by $c = 19$ is performed
+// with shifts and additions since this carry can be longer than 32 bits.
+
+static void gfp4_carry(Word *r, __m256i *h)
+{
+  const __m256i m26 = _mm256_set1_epi64x(MASK26);
+  const __m256i m25 = _mm256_set1_epi64x(MASK25);
+  __m256i c;
+  int i;
+
+  for (i = 0; i < NUMLIMBS/2; i++) {
+    c = _mm256_srli_epi64(h[i], 26 - (i & 1));
+    h[i] = _mm256_and_si256(h[i], (i & 1) ? m25 : m26);
+    h[i+1] = _mm256_add_epi64(h[i+1], c);
+    if (i + 6 < NUMLIMBS) {
+      c = _mm256_srli_epi64(h[i+5], 25 + (i & 1));
+      h[i+5] = _mm256_and_si256(h[i+5], (i & 1) ? m26 : m25);
+      h[i+6] = _mm256_add_epi64(h[i+6], c);
+    }
+  }
+  c = _mm256_srli_epi64(h[NUMLIMBS-1], 25);
+  h[NUMLIMBS-1] = _mm256_and_si256(h[NUMLIMBS-1], m25);
+  c = _mm256_add_epi64(c, _mm256_add_epi64(_mm256_slli_epi64(c, 1), \
+                                           _mm256_slli_epi64(c, 4)));
+  h[0] = _mm256_add_epi64(h[0], c);
+  c = _mm256_srli_epi64(h[5], 25);
+  h[5] = _mm256_and_si256(h[5], m25);
+  h[6] = _mm256_add_epi64(h[6], c);
+  c = _mm256_srli_epi64(h[0], 26);
+  h[0] = _mm256_and_si256(h[0], m26);
+  h[1] = _mm256_add_epi64(h[1], c);
+
+  for (i = 0; i < NUMLIMBS; i++) gfp4_st(r, i, h[i]);
+}
+
+
+// Addition of two vectors: $r = a + b \bmod p$
+
+void gfp4_add(Word *r, const Word *a, const Word *b)
+{
+  __m256i h[NUMLIMBS];
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    h[i] = _mm256_add_epi64(gfp4_ld(a, i), gfp4_ld(b, i));
+  }
+  gfp4_carry(r, h);
+}
+
+
+// Subtraction of two vectors: $r = a - b \bmod p$ (computed as $a + 2p - b$)
+
+void gfp4_sub(Word *r, const Word *a, const Word *b)
+{
+  __m256i h[NUMLIMBS], tp;
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    tp = _mm256_set1_epi64x((i == 0) ? TWOPL0 : ((i & 1) ? TWOPOD : TWOPEV));
+    h[i] = _mm256_sub_epi64(_mm256_add_epi64(gfp4_ld(a, i), tp), \
+                            gfp4_ld(b, i));
+  }
+  gfp4_carry(r, h);
+}
+
+
+// Conditional negation of a vector: $r = -a \bmod p$ or $r = a \bmod p$
+// ---------------------------------------------------------------------
+// Bit j of operand `neg` specifies whether lane j is negated. The four bits
+// are expanded to four 64-bit AND-masks with a variable shift and a compare.
+
+void gfp4_cneg(Word *r, const Word *a, int neg)
+{
+  __m256i h[NUMLIMBS], ai, tp, msk;
+  int i;
+
+  msk = _mm256_srlv_epi64(_mm256_set1_epi64x(neg), \
+                          _mm256_setr_epi64x(0, 1, 2, 3));
+  msk = _mm256_and_si256(msk, _mm256_set1_epi64x(1));
+  msk = _mm256_cmpeq_epi64(msk, _mm256_set1_epi64x(1));
+  for (i = 0; i < NUMLIMBS; i++) {
+    tp = _mm256_set1_epi64x((i == 0) ? TWOPL0 : ((i & 1) ? TWOPOD : TWOPEV));
+    ai = gfp4_ld(a, i);
+    tp = _mm256_sub_epi64(tp, ai);
+    h[i] = _mm256_xor_si256(ai, _mm256_and_si256(_mm256_xor_si256(ai, tp), \
+                                                 msk));
+  }
+  gfp4_carry(r, h);
+}
+
+
+// Multiplication of two vectors: $r = a \cdot b \bmod p$
+// ------------------------------------------------------
+// The limbs of $a$ are doubled and the limbs of $b$ are multiplied by $c = 19$
+// in advance, so that each of the 100 limb-products requires only one
+// `vpmuludq` and one `vpaddq` instruction. The product a[i]*b[k] is added to
+// column $(i+k) \bmod 10$ and uses the doubled a[i] when both $i$ and $k$ are
+// odd, and the pre-multiplied b[k] when $i+k \geq 10$.
+
+void gfp4_mul(Word *r, const Word *a, const Word *b)
+{
+  __m256i h[NUMLIMBS], al[NUMLIMBS], ad[NUMLIMBS], bl[NUMLIMBS], bc[NUMLIMBS];
+  const __m256i c19 = _mm256_set1_epi64x(CONSTC);
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    al[i] = gfp4_ld(a, i);
+    ad[i] = _mm256_slli_epi64(al[i], 1);
+    bl[i] = gfp4_ld(b, i);
+    bc[i] = _mm256_mul_epu32(bl[i], c19);
+  }
+
+  h[0] = _mm256_mul_epu32(al[0], bl[0]);
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(ad[1], bc[9]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(al[2], bc[8]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(ad[3], bc[7]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(al[4], bc[6]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(ad[5], bc[5]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(al[6], bc[4]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(ad[7], bc[3]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(al[8], bc[2]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(ad[9], bc[1]));
+  h[1] = _mm256_mul_epu32(al[0], bl[1]);
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(al[1], bl[0]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(al[2], bc[9]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(al[3], bc[8]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(al[4], bc[7]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(al[5], bc[6]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(al[6], bc[5]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(al[7], bc[4]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(al[8], bc[3]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(al[9], bc[2]));
+  h[2] = _mm256_mul_epu32(al[0], bl[2]);
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(ad[1], bl[1]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(al[2], bl[0]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(ad[3], bc[9]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(al[4], bc[8]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(ad[5], bc[7]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(al[6], bc[6]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(ad[7], bc[5]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(al[8], bc[4]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(ad[9], bc[3]));
+  h[3] = _mm256_mul_epu32(al[0], bl[3]);
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(al[1], bl[2]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(al[2], bl[1]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(al[3], bl[0]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(al[4], bc[9]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(al[5], bc[8]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(al[6], bc[7]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(al[7], bc[6]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(al[8], bc[5]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(al[9], bc[4]));
+  h[4] = _mm256_mul_epu32(al[0], bl[4]);
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(ad[1], bl[3]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(al[2], bl[2]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(ad[3], bl[1]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(al[4], bl[0]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(ad[5], bc[9]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(al[6], bc[8]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(ad[7], bc[7]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(al[8], bc[6]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(ad[9], bc[5]));
+  h[5] = _mm256_mul_epu32(al[0], bl[5]);
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(al[1], bl[4]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(al[2], bl[3]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(al[3], bl[2]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(al[4], bl[1]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(al[5], bl[0]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(al[6], bc[9]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(al[7], bc[8]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(al[8], bc[7]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(al[9], bc[6]));
+  h[6] = _mm256_mul_epu32(al[0], bl[6]);
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(ad[1], bl[5]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(al[2], bl[4]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(ad[3], bl[3]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(al[4], bl[2]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(ad[5], bl[1]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(al[6], bl[0]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(ad[7], bc[9]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(al[8], bc[8]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(ad[9], bc[7]));
+  h[7] = _mm256_mul_epu32(al[0], bl[7]);
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(al[1], bl[6]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(al[2], bl[5]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(al[3], bl[4]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(al[4], bl[3]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(al[5], bl[2]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(al[6], bl[1]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(al[7], bl[0]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(al[8], bc[9]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(al[9], bc[8]));
+  h[8] = _mm256_mul_epu32(al[0], bl[8]);
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(ad[1], bl[7]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(al[2], bl[6]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(ad[3], bl[5]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(al[4], bl[4]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(ad[5], bl[3]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(al[6], bl[2]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(ad[7], bl[1]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(al[8], bl[0]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(ad[9], bc[9]));
+  h[9] = _mm256_mul_epu32(al[0], bl[9]);
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(al[1], bl[8]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(al[2], bl[7]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(al[3], bl[6]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(al[4], bl[5]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(al[5], bl[4]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(al[6], bl[3]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(al[7], bl[2]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(al[8], bl[1]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(al[9], bl[0]));
+
+  gfp4_carry(r, h);
+}
+
+
+// Squaring of a vector: $r = a^2 \bmod p$
+// ---------------------------------------
+// Only the 55 limb-products a[i]*a[k] with $i \leq k$ are computed, whereby
+// the doubling of the products with $i < k$ is applied to a[i], while the
+// factors 2 (both indices odd) and 19 (reduction) are applied to a[k], which
+// means a[k] is needed in four versions: $a_k$, $2 a_k$, $19 a_k$, $38 a_k$.
+
+void gfp4_sqr(Word *r, const Word *a)
+{
+  __m256i h[NUMLIMBS], al[NUMLIMBS], ad[NUMLIMBS], ac[NUMLIMBS], adc[NUMLIMBS];
+  const __m256i c19 = _mm256_set1_epi64x(CONSTC);
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    al[i] = gfp4_ld(a, i);
+    ad[i] = _mm256_slli_epi64(al[i], 1);
+    ac[i] = _mm256_mul_epu32(al[i], c19);
+    adc[i] = _mm256_mul_epu32(ad[i], c19);
+  }
+
+  h[0] = _mm256_mul_epu32(al[0], al[0]);
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(ad[1], adc[9]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(ad[2], ac[8]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(ad[3], adc[7]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(ad[4], ac[6]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(al[5], adc[5]));
+  h[1] = _mm256_mul_epu32(ad[0], al[1]);
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(ad[2], ac[9]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(ad[3], ac[8]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(ad[4], ac[7]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(ad[5], ac[6]));
+  h[2] = _mm256_mul_epu32(ad[0], al[2]);
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(al[1], ad[1]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(ad[3], adc[9]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(ad[4], ac[8]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(ad[5], adc[7]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(al[6], ac[6]));
+  h[3] = _mm256_mul_epu32(ad[0], al[3]);
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(ad[1], al[2]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(ad[4], ac[9]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(ad[5], ac[8]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(ad[6], ac[7]));
+  h[4] = _mm256_mul_epu32(ad[0], al[4]);
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(ad[1], ad[3]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(al[2], al[2]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(ad[5], adc[9]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(ad[6], ac[8]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(al[7], adc[7]));
+  h[5] = _mm256_mul_epu32(ad[0], al[5]);
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(ad[1], al[4]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(ad[2], al[3]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(ad[6], ac[9]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(ad[7], ac[8]));
+  h[6] = _mm256_mul_epu32(ad[0], al[6]);
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(ad[1], ad[5]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(ad[2], al[4]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(al[3], ad[3]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(ad[7], adc[9]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(al[8], ac[8]));
+  h[7] = _mm256_mul_epu32(ad[0], al[7]);
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(ad[1], al[6]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(ad[2], al[5]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(ad[3], al[4]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(ad[8], ac[9]));
+  h[8] = _mm256_mul_epu32(ad[0], al[8]);
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(ad[1], ad[7]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(ad[2], al[6]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(ad[3], ad[5]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(al[4], al[4]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(al[9], adc[9]));
+  h[9] = _mm256_mul_epu32(ad[0], al[9]);
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(ad[1], al[8]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(ad[2], al[7]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(ad[3], al[6]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(ad[4], al[5]));
+
+  gfp4_carry(r, h);
+}
+
+
+// Multiplication of a vector by a 32-bit value: $r = a \cdot b \bmod p$
+
+void gfp4_mul32(Word *r, const Word *a, const Word *b)
+{
+  __m256i h[NUMLIMBS];
+  const __m256i bw = _mm256_set1_epi64x(b[0]);
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) h[i] = _mm256_mul_epu32(gfp4_ld(a, i), bw);
+  gfp4_carry(r, h);
+}
+
+
+#endif  // #if (defined(M25519_SIMD) && defined(__AVX2__))
+
+#undef MASK26
+#undef MASK25
+#undef TWOPL0
+#undef TWOPEV
+#undef TWOPOD
+#undef gfp4_carry
+
+///////////////////////////////////////////////////////////////////////////////
+// src/simd/gfparith4_neon.c                                                 //
+///////////////////////////////////////////////////////////////////////////////
+
+#define gfp4_carry gfparith4_neon_gfp4_carry
+
+
+// This file contains NEON implementations of the four-way parallel arithmetic
+// operations in GF(p), which replace the C versions in `gfparith4.c` when
+// `M25519_SIMD` is defined and the compiler targets an ARM processor (ARMv7-A
+// or AArch64) with NEON extension (see `config.h`). The i-th limbs of the four
+// lanes are loaded into a 128-bit register, and the limb-products are computed
+// with `vmull_u32` and `vmlal_u32`, each of which performs two 32 x 32 -> 64-
+// bit multiplications (i.e., the column-sums of the lower and upper two lanes
+// are kept in separate 128-bit registers). The algorithms (and the order of
+// the carry propagation) are exactly the same as those of the C versions, i.e.,
+// both implementations produce identical results.
+
+
+
+
+#if (defined(M25519_SIMD) && !defined(__AVX2__) && \
+    (defined(__ARM_NEON) || defined(__ARM_NEON__)))
+
+
+#include <arm_neon.h>
+
+
+// Limb masks: 0x3FFFFFF (26 bits) and 0x1FFFFFF (25 bits)
+#define MASK26 0x3FFFFFFULL
+#define MASK25 0x1FFFFFFULL
+
+// Limbs of 2*p: 0x7FFFFDA (limb 0), 0x7FFFFFE (even), 0x3FFFFFE (odd)
+static const Word TWOP[NUMLIMBS] = { 0x7FFFFDA, 0x3FFFFFE, 0x7FFFFFE, \
+  0x3FFFFFE, 0x7FFFFFE, 0x3FFFFFE, 0x7FFFFFE, 0x3FFFFFE, 0x7FFFFFE, 0x3FFFFFE };
+
+
+// Computation of limb-products in the lower and upper two lanes
+// --------------------------------------------------------------
+// `gfp4_mull` computes the four products of the 32-bit words in `x` and `y`
+// and `gfp4_mlal` adds them to the 64-bit column-sums in h[0] (lanes 0 and 1)
+// and h[1] (lanes 2 and 3).
+
+static void gfp4_mull(uint64x2_t *h, uint32x4_t x, uint32x4_t y)
+{
+  h[0] = vmull_u32(vget_low_u32(x), vget_low_u32(y));
+  h[1] = vmull_u32(vget_high_u32(x), vget_high_u32(y));
+}
+
+static void gfp4_mlal(uint64x2_t *h, uint32x4_t x, uint32x4_t y)
+{
+  h[0] = vmlal_u32(h[0], vget_low_u32(x), vget_low_u32(y));
+  h[1] = vmlal_u32(h[1], vget_high_u32(x), vget_high_u32(y));
+}
+
+
+// Carry propagation from limb i (26 or 25 bits long) to limb k
+// ------------------------------------------------------------
+// The shift distance of the NEON shift instructions has to be a compile-time
+// constant, which is the reason for having two versions of this function.
+
+static void gfp4_c26(uint64x2_t *h, int i, int k)
+{
+  const uint64x2_t m26 = vdupq_n_u64(MASK26);
+
+  h[2*k] = vsraq_n_u64(h[2*k], h[2*i], 26);
+  h[2*k+1] = vsraq_n_u64(h[2*k+1], h[2*i+1], 26);
+  h[2*i] = vandq_u64(h[2*i], m26);
+  h[2*i+1] = vandq_u64(h[2*i+1], m26);
+}
+
+static void gfp4_c25(uint64x2_t *h, int i, int k)
+{
+  const uint64x2_t m25 = vdupq_n_u64(MASK25);
+
+  h[2*k] = vsraq_n_u64(h[2*k], h[2*i], 25);
+  h[2*k+1] = vsraq_n_u64(h[2*k+1], h[2*i+1], 25);
+  h[2*i] = vandq_u64(h[2*i], m25);
+  h[2*i+1] = vandq_u64(h[2*i+1], m25);
+}
+
+
+// Carry propagation of the limbs of all four lanes
+// ------------------------------------------------
+// Same as in `gfparith4.c`: two interleaved chains starting at limb 0 and limb
+// 5. The multiplication of the carry out of limb 9 by $c = 19$ is performed
+// with shifts and additions since this carry can be longer than 32 bits.
+
+static void gfp4_carry(Word *r, uint64x2_t *h)
+{
+  const uint64x2_t m25 = vdupq_n_u64(MASK25);
+  uint64x2_t c;
+  int i;
+
+  gfp4_c26(h, 0, 1); gfp4_c25(h, 5, 6);
+  gfp4_c25(h, 1, 2); gfp4_c26(h, 6, 7);
+  gfp4_c26(h, 2, 3); gfp4_c25(h, 7, 8);
+  gfp4_c25(h, 3, 4); gfp4_c26(h, 8, 9);
+  gfp4_c26(h, 4, 5);
+  for (i = 0; i < 2; i++) {
+    c = vshrq_n_u64(h[2*NUMLIMBS-2+i], 25);
+    h[2*NUMLIMBS-2+i] = vandq_u64(h[2*NUMLIMBS-2+i], m25);
+    h[i] = vaddq_u64(h[i], c);
+    h[i] = vaddq_u64(h[i], vshlq_n_u64(c, 1));
+    h[i] = vaddq_u64(h[i], vshlq_n_u64(c, 4));
+  }
+  gfp4_c25(h, 5, 6);
+  gfp4_c26(h, 0, 1);
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    vst1q_u32(&r[4*i], vcombine_u32(vmovn_u64(h[2*i]), vmovn_u64(h[2*i+1])));
+  }
+}
+
+
+// Addition of two vectors: $r = a + b \bmod p$
+
+void gfp4_add(Word *r, const Word *a, const Word *b)
+{
+  uint64x2_t h[2*NUMLIMBS];
+  uint32x4_t ai, bi;
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    ai = vld1q_u32(&a[4*i]);
+    bi = vld1q_u32(&b[4*i]);
+    h[2*i] = vaddl_u32(vget_low_u32(ai), vget_low_u32(bi));
+    h[2*i+1] = vaddl_u32(vget_high_u32(ai), vget_high_u32(bi));
+  }
+  gfp4_carry(r, h);
+}
+
+
+// Subtraction of two vectors: $r = a - b \bmod p$ (computed as $a + 2p - b$)
+
+void gfp4_sub(Word *r, const Word *a, const Word *b)
+{
+  uint64x2_t h[2*NUMLIMBS];
+  uint32x4_t ti;
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    ti = vaddq_u32(vld1q_u32(&a[4*i]), vdupq_n_u32(TWOP[i]));
+    ti = vsubq_u32(ti, vld1q_u32(&b[4*i]));
+    h[2*i] = vmovl_u32(vget_low_u32(ti));
+    h[2*i+1] = vmovl_u32(vget_high_u32(ti));
+  }
+  gfp4_carry(r, h);
+}
+
+
+// Conditional negation of a vector: $r = -a \bmod p$ or $r = a \bmod p$
+// ---------------------------------------------------------------------
+// Bit j of operand `neg` specifies whether lane j is negated. The four bits
+// are expanded to four 32-bit AND-masks with a single `vtstq_u32`.
+
+void gfp4_cneg(Word *r, const Word *a, int neg)
+{
+  static const Word lbit[NUMLANES] = { 1, 2, 4, 8 };
+  uint64x2_t h[2*NUMLIMBS];
+  uint32x4_t ai, ti, msk;
+  int i;
+
+  msk = vtstq_u32(vdupq_n_u32((Word) neg), vld1q_u32(lbit));
+  for (i = 0; i < NUMLIMBS; i++) {
+    ai = vld1q_u32(&a[4*i]);
+    ti = vsubq_u32(vdupq_n_u32(TWOP[i]), ai);
+    ti = veorq_u32(ai, vandq_u32(veorq_u32(ai, ti), msk));
+    h[2*i] = vmovl_u32(vget_low_u32(ti));
+    h[2*i+1] = vmovl_u32(vget_high_u32(ti));
+  }
+  gfp4_carry(r, h);
+}
+
+
+// Multiplication of two vectors: $r = a \cdot b \bmod p$
+// ------------------------------------------------------
+// The limbs of $a$ are doubled and the limbs of $b$ are multiplied by $c = 19$
+// in advance (both fit into 32 bits). The product a[i]*b[k] is added to column
+// $(i+k) \bmod 10$ and uses the doubled a[i] when both $i$ and $k$ are odd,
+// and the pre-multiplied b[k] when $i+k \geq 10$.
+
+void gfp4_mul(Word *r, const Word *a, const Word *b)
+{
+  uint64x2_t h[2*NUMLIMBS];
+  uint32x4_t al[NUMLIMBS], ad[NUMLIMBS], bl[NUMLIMBS], bc[NUMLIMBS];
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    al[i] = vld1q_u32(&a[4*i]);
+    ad[i] = vshlq_n_u32(al[i], 1);
+    bl[i] = vld1q_u32(&b[4*i]);
+    bc[i] = vmulq_n_u32(bl[i], CONSTC);
+  }
+
+  gfp4_mull(&h[0], al[0], bl[0]);
+  gfp4_mlal(&h[0], ad[1], bc[9]);
+  gfp4_mlal(&h[0], al[2], bc[8]);
+  gfp4_mlal(&h[0], ad[3], bc[7]);
+  gfp4_mlal(&h[0], al[4], bc[6]);
+  gfp4_mlal(&h[0], ad[5], bc[5]);
+  gfp4_mlal(&h[0], al[6], bc[4]);
+  gfp4_mlal(&h[0], ad[7], bc[3]);
+  gfp4_mlal(&h[0], al[8], bc[2]);
+  gfp4_mlal(&h[0], ad[9], bc[1]);
+  gfp4_mull(&h[2], al[0], bl[1]);
+  gfp4_mlal(&h[2], al[1], bl[0]);
+  gfp4_mlal(&h[2], al[2], bc[9]);
+  gfp4_mlal(&h[2], al[3], bc[8]);
+  gfp4_mlal(&h[2], al[4], bc[7]);
+  gfp4_mlal(&h[2], al[5], bc[6]);
+  gfp4_mlal(&h[2], al[6], bc[5]);
+  gfp4_mlal(&h[2], al[7], bc[4]);
+  gfp4_mlal(&h[2], al[8], bc[3]);
+  gfp4_mlal(&h[2], al[9], bc[2]);
+  gfp4_mull(&h[4], al[0], bl[2]);
+  gfp4_mlal(&h[4], ad[1], bl[1]);
+  gfp4_mlal(&h[4], al[2], bl[0]);
+  gfp4_mlal(&h[4], ad[3], bc[9]);
+  gfp4_mlal(&h[4], al[4], bc[8]);
+  gfp4_mlal(&h[4], ad[5], bc[7]);
+  gfp4_mlal(&h[4], al[6], bc[6]);
+  gfp4_mlal(&h[4], ad[7], bc[5]);
+  gfp4_mlal(&h[4], al[8], bc[4]);
+  gfp4_mlal(&h[4], ad[9], bc[3]);
+  gfp4_mull(&h[6], al[0], bl[3]);
+  gfp4_mlal(&h[6], al[1], bl[2]);
+  gfp4_mlal(&h[6], al[2], bl[1]);
+  gfp4_mlal(&h[6], al[3], bl[0]);
+  gfp4_mlal(&h[6], al[4], bc[9]);
+  gfp4_mlal(&h[6], al[5], bc[8]);
+  gfp4_mlal(&h[6], al[6], bc[7]);
+  gfp4_mlal(&h[6], al[7], bc[6]);
+  gfp4_mlal(&h[6], al[8], bc[5]);
+  gfp4_mlal(&h[6], al[9], bc[4]);
+  gfp4_mull(&h[8], al[0], bl[4]);
+  gfp4_mlal(&h[8], ad[1], bl[3]);
+  gfp4_mlal(&h[8], al[2], bl[2]);
+  gfp4_mlal(&h[8], ad[3], bl[1]);
+  gfp4_mlal(&h[8], al[4], bl[0]);
+  gfp4_mlal(&h[8], ad[5], bc[9]);
+  gfp4_mlal(&h[8], al[6], bc[8]);
+  gfp4_mlal(&h[8], ad[7], bc[7]);
+  gfp4_mlal(&h[8], al[8], bc[6]);
+  gfp4_mlal(&h[8], ad[9], bc[5]);
+  gfp4_mull(&h[10], al[0], bl[5]);
+  gfp4_mlal(&h[10], al[1], bl[4]);
+  gfp4_mlal(&h[10], al[2], bl[3]);
+  gfp4_mlal(&h[10], al[3], bl[2]);
+  gfp4_mlal(&h[10], al[4], bl[1]);
+  gfp4_mlal(&h[10], al[5], bl[0]);
+  gfp4_mlal(&h[10], al[6], bc[9]);
+  gfp4_mlal(&h[10], al[7], bc[8]);
+  gfp4_mlal(&h[10], al[8], bc[7]);
+  gfp4_mlal(&h[10], al[9], bc[6]);
+  gfp4_mull(&h[12], al[0], bl[6]);
+  gfp4_mlal(&h[12], ad[1], bl[5]);
+  gfp4_mlal(&h[12], al[2], bl[4]);
+  gfp4_mlal(&h[12], ad[3], bl[3]);
+  gfp4_mlal(&h[12], al[4], bl[2]);
+  gfp4_mlal(&h[12], ad[5], bl[1]);
+  gfp4_mlal(&h[12], al[6], bl[0]);
+  gfp4_mlal(&h[12], ad[7], bc[9]);
+  gfp4_mlal(&h[12], al[8], bc[8]);
+  gfp4_mlal(&h[12], ad[9], bc[7]);
+  gfp4_mull(&h[14], al[0], bl[7]);
+  gfp4_mlal(&h[14], al[1], bl[6]);
+  gfp4_mlal(&h[14], al[2], bl[5]);
+  gfp4_mlal(&h[14], al[3], bl[4]);
+  gfp4_mlal(&h[14], al[4], bl[3]);
+  gfp4_mlal(&h[14], al[5], bl[2]);
+  gfp4_mlal(&h[14], al[6], bl[1]);
+  gfp4_mlal(&h[14], al[7], bl[0]);
+  gfp4_mlal(&h[14], al[8], bc[9]);
+  gfp4_mlal(&h[14], al[9], bc[8]);
+  gfp4_mull(&h[16], al[0], bl[8]);
+  gfp4_mlal(&h[16], ad[1], bl[7]);
+  gfp4_mlal(&h[16], al[2], bl[6]);
+  gfp4_mlal(&h[16], ad[3], bl[5]);
+  gfp4_mlal(&h[16], al[4], bl[4]);
+  gfp4_mlal(&h[16], ad[5], bl[3]);
+  gfp4_mlal(&h[16], al[6], bl[2]);
+  gfp4_mlal(&h[16], ad[7], bl[1]);
+  gfp4_mlal(&h[16], al[8], bl[0]);
+  gfp4_mlal(&h[16], ad[9], bc[9]);
+  gfp4_mull(&h[18], al[0], bl[9]);
+  gfp4_mlal(&h[18], al[1], bl[8]);
+  gfp4_mlal(&h[18], al[2], bl[7]);
+  gfp4_mlal(&h[18], al[3], bl[6]);
+  gfp4_mlal(&h[18], al[4], bl[5]);
+  gfp4_mlal(&h[18], al[5], bl[4]);
+  gfp4_mlal(&h[18], al[6], bl[3]);
+  gfp4_mlal(&h[18], al[7], bl[2]);
+  gfp4_mlal(&h[18], al[8], bl[1]);
+  gfp4_mlal(&h[18], al[9], bl[0]);
+
+  gfp4_carry(r, h);
+}
+
+
+// Squaring of a vector: $r = a^2 \bmod p$
+// ---------------------------------------
+// Only the 55 limb-products a[i]*a[k] with $i \leq k$ are computed, whereby
+// the doubling of the products with $i < k$ is applied to a[i], while the
+// factors 2 (both indices odd) and 19 (reduction) are applied to a[k], which
+// means a[k] is needed in four versions: $a_k$, $2 a_k$, $19 a_k$, $38 a_k$.
+
+void gfp4_sqr(Word *r, const Word *a)
+{
+  uint64x2_t h[2*NUMLIMBS];
+  uint32x4_t al[NUMLIMBS], ad[NUMLIMBS], ac[NUMLIMBS], adc[NUMLIMBS];
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    al[i] = vld1q_u32(&a[4*i]);
+    ad[i] = vshlq_n_u32(al[i], 1);
+    ac[i] = vmulq_n_u32(al[i], CONSTC);
+    adc[i] = vmulq_n_u32(ad[i], CONSTC);
+  }
+
+  gfp4_mull(&h[0], al[0], al[0]);
+  gfp4_mlal(&h[0], ad[1], adc[9]);
+  gfp4_mlal(&h[0], ad[2], ac[8]);
+  gfp4_mlal(&h[0], ad[3], adc[7]);
+  gfp4_mlal(&h[0], ad[4], ac[6]);
+  gfp4_mlal(&h[0], al[5], adc[5]);
+  gfp4_mull(&h[2], ad[0], al[1]);
+  gfp4_mlal(&h[2], ad[2], ac[9]);
+  gfp4_mlal(&h[2], ad[3], ac[8]);
+  gfp4_mlal(&h[2], ad[4], ac[7]);
+  gfp4_mlal(&h[2], ad[5], ac[6]);
+  gfp4_mull(&h[4], ad[0], al[2]);
+  gfp4_mlal(&h[4], al[1], ad[1]);
+  gfp4_mlal(&h[4], ad[3], adc[9]);
+  gfp4_mlal(&h[4], ad[4], ac[8]);
+  gfp4_mlal(&h[4], ad[5], adc[7]);
+  gfp4_mlal(&h[4], al[6], ac[6]);
+  gfp4_mull(&h[6], ad[0], al[3]);
+  gfp4_mlal(&h[6], ad[1], al[2]);
+  gfp4_mlal(&h[6], ad[4], ac[9]);
+  gfp4_mlal(&h[6], ad[5], ac[8]);
+  gfp4_mlal(&h[6], ad[6], ac[7]);
+  gfp4_mull(&h[8], ad[0], al[4]);
+  gfp4_mlal(&h[8], ad[1], ad[3]);
+  gfp4_mlal(&h[8], al[2], al[2]);
+  gfp4_mlal(&h[8], ad[5], adc[9]);
+  gfp4_mlal(&h[8], ad[6], ac[8]);
+  gfp4_mlal(&h[8], al[7], adc[7]);
+  gfp4_mull(&h[10], ad[0], al[5]);
+  gfp4_mlal(&h[10], ad[1], al[4]);
+  gfp4_mlal(&h[10], ad[2], al[3]);
+  gfp4_mlal(&h[10], ad[6], ac[9]);
+  gfp4_mlal(&h[10], ad[7], ac[8]);
+  gfp4_mull(&h[12], ad[0], al[6]);
+  gfp4_mlal(&h[12], ad[1], ad[5]);
+  gfp4_mlal(&h[12], ad[2], al[4]);
+  gfp4_mlal(&h[12], al[3], ad[3]);
+  gfp4_mlal(&h[12], ad[7], adc[9]);
+  gfp4_mlal(&h[12], al[8], ac[8]);
+  gfp4_mull(&h[14], ad[0], al[7]);
+  gfp4_mlal(&h[14], ad[1], al[6]);
+  gfp4_mlal(&h[14], ad[2], al[5]);
+  gfp4_mlal(&h[14], ad[3], al[4]);
+  gfp4_mlal(&h[14], ad[8], ac[9]);
+  gfp4_mull(&h[16], ad[0], al[8]);
+  gfp4_mlal(&h[16], ad[1], ad[7]);
+  gfp4_mlal(&h[16], ad[2], al[6]);
+  gfp4_mlal(&h[16], ad[3], ad[5]);
+  gfp4_mlal(&h[16], al[4], al[4]);
+  gfp4_mlal(&h[16], al[9], adc[9]);
+  gfp4_mull(&h[18], ad[0], al[9]);
+  gfp4_mlal(&h[18], ad[1], al[8]);
+  gfp4_mlal(&h[18], ad[2], al[7]);
+  gfp4_mlal(&h[18], ad[3], al[6]);
+  gfp4_mlal(&h[18], ad[4], al[5]);
+
+  gfp4_carry(r, h);
+}
+
+
+// Multiplication of a vector by a 32-bit value: $r = a \cdot b \bmod p$
+
+void gfp4_mul32(Word *r, const Word *a, const Word *b)
+{
+  uint64x2_t h[2*NUMLIMBS];
+  uint32x4_t ai;
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    ai = vld1q_u32(&a[4*i]);
+    h[2*i] = vmull_n_u32(vget_low_u32(ai), b[0]);
+    h[2*i+1] = vmull_n_u32(vget_high_u32(ai), b[0]);
+  }
+  gfp4_carry(r, h);
+}
+
+
+#endif  // #if (defined(M25519_SIMD) && ...
+
+#undef MASK26
+#undef MASK25
+#undef gfp4_carry
+
+///////////////////////////////////////////////////////////////////////////////
+// src/backend.c                                                             //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+// The ops table `m25519_ops` is only available when `M25519_USE_OPS_TABLE` is
+// defined in `config.h` (and the 64-bit C implementation is not used). It is
+// initialized with the Assembly kernels when they are available for the target
+// architecture, and with the C kernels otherwise, so that Micro25519 can be
+// used without calling one of the functions below. A kernel is only installed
+// in the table after its results have been compared with those of the C kernel
+// for a pseudo-random operand. The table is a global variable, which means it
+// must not be changed while another thread or an interrupt handler executes a
+// field-arithmetic function.
+
+
+#include <stddef.h>
+
+
+#if defined(M25519_OPSTBL)
+
+
+// Number of kernel calls per measurement and number of measurements per kernel
+// (the minimum of the measured values is taken)
+
+#define KRN_RUNS 8
+#define KRN_MEAS 3
+
+
+// Built-in backends and the ops table, which initially contains the Assembly
+// kernels (if available) or the C kernels
+
+const ArithOps m25519_ops_c99 = { "c99", gfp_add, gfp_sub, gfp_cneg, gfp_hlv, \
+  gfp_mul, gfp_mul32, gfp_sqr };
+
+#if defined(M25519_ASSEMBLY)
+const ArithOps m25519_ops_asm = { "asm", gfp_add_asm, gfp_sub_asm, \
+  gfp_cneg_asm, gfp_hlv_asm, gfp_mul_asm, gfp_mul32_asm, gfp_sqr_asm };
+ArithOps m25519_ops = { "asm", gfp_add_asm, gfp_sub_asm, gfp_cneg_asm, \
+  gfp_hlv_asm, gfp_mul_asm, gfp_mul32_asm, gfp_sqr_asm };
+#define DEFAULT_NAME "asm"
+#else
+ArithOps m25519_ops = { "c99", gfp_add, gfp_sub, gfp_cneg, gfp_hlv, gfp_mul, \
+  gfp_mul32, gfp_sqr };
+#define DEFAULT_NAME "c99"
+#endif
+
+// names of the backends from which the installed kernels originate
+static const char *m25519_krn_src[M25519_KRN_NUM] = { DEFAULT_NAME, \
+  DEFAULT_NAME, DEFAULT_NAME, DEFAULT_NAME, DEFAULT_NAME, DEFAULT_NAME, \
+  DEFAULT_NAME };
+
+
+// Helper functions to check whether a backend contains the kernel with index
+// `k`, to install this kernel in the ops table, and to execute it
+
+static int krn_avail(const ArithOps *ops, int k)
+{
+  switch (k) {
+    case M25519_KRN_ADD:   return (ops->add != NULL);
+    case M25519_KRN_SUB:   return (ops->sub != NULL);
+    case M25519_KRN_CNEG:  return (ops->cneg != NULL);
+    case M25519_KRN_HLV:   return (ops->hlv != NULL);
+    case M25519_KRN_MUL:   return (ops->mul != NULL);
+    case M25519_KRN_MUL32: return (ops->mul32 != NULL);
+    case M25519_KRN_SQR:   return (ops->sqr != NULL);
+  }
+  return 0;
+}
+
+
+static void krn_install(const ArithOps *ops, int k)
+{
+  switch (k) {
+    case M25519_KRN_ADD:   m25519_ops.add = ops->add; break;
+    case M25519_KRN_SUB:   m25519_ops.sub = ops->sub; break;
+    case M25519_KRN_CNEG:  m25519_ops.cneg = ops->cneg; break;
+    case M25519_KRN_HLV:   m25519_ops.hlv = ops->hlv; break;
+    case M25519_KRN_MUL:   m25519_ops.mul = ops->mul; break;
+    case M25519_KRN_MUL32: m25519_ops.mul32 = ops->mul32; break;
+    case M25519_KRN_SQR:   m25519_ops.sqr = ops->sqr; break;
+  }
+  m25519_krn_src[k] = (ops->name != NULL) ? ops->name : "unnamed";
+}
+
+
+static void krn_exec(const ArithOps *ops, int k, Word *r, const Word *a, \
+  const Word *b)
+{
+  switch (k) {
+    case M25519_KRN_ADD:   ops->add(r, a, b); break;
+    case M25519_KRN_SUB:   ops->sub(r, a, b); break;
+    case M25519_KRN_CNEG:  ops->cneg(r, a, (int) (b[0] & 1)); break;
+    case M25519_KRN_HLV:   ops->hlv(r, a); break;
+    case M25519_KRN_MUL:   ops->mul(r, a, b); break;
+    case M25519_KRN_MUL32: ops->mul32(r, a, b); break;
+    case M25519_KRN_SQR:   ops->sqr(r, a); break;
+  }
+}
+
+
+// Initialization of the two operands of a kernel with pseudo-random words
+// (xorshift32); the operands are not reduced, i.e., they can be up to 256 bits
+// long, and the LSB of `b[0]` is set so that `cneg` performs a negation
+
+static void krn_operands(Word *a, Word *b)
+{
+  uint32_t x = 0x2545F491UL;
+  int i;
+  
+  for (i = 0; i < LEN; i++) {
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    a[i] = (Word) x;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    b[i] = (Word) x;
+  }
+  a[LEN-1] |= (Word) 1 << (WSIZE - 1);
+  b[0] |= 1;
+}
+
+
+// Known-answer test of the kernel with index `k` of a backend: the result is
+// compared with that of the C kernel after full reduction modulo $p$, and 0
+// is returned if they match
+
+static int krn_check(const ArithOps *ops, int k)
+{
+  Word a[LEN], b[LEN], r[LEN], e[LEN];
+  
+  krn_operands(a, b);
+  krn_exec(ops, k, r, a, b);
+  krn_exec(&m25519_ops_c99, k, e, a, b);
+  gfp_fred(r, r);
+  gfp_fred(e, e);
+  return mpi_cmp(r, e, LEN);
+}
+
+
+// Measurement of the execution time of the kernel with index `k` of a backend
+// (for `KRN_RUNS` calls) with the timer-function `timer`
+
+static uint32_t krn_time(const ArithOps *ops, int k, uint32_t (*timer)(void))
+{
+  Word a[LEN], b[LEN], r[LEN];
+  uint32_t t0, t1, tmin = 0;
+  int i, j;
+  
+  krn_operands(a, b);
+  for (i = 0; i < KRN_MEAS; i++) {
+    t0 = timer();
+    for (j = 0; j < KRN_RUNS; j++) krn_exec(ops, k, r, a, b);
+    t1 = timer() - t0;
+    if ((i == 0) || (t1 < tmin)) tmin = t1;
+  }
+  return tmin;
+}
+
+
+// Update of the name of the ops table: the name of the backend if all kernels
+// originate from the same backend, or "mixed" otherwise
+
+static void ops_update_name(void)
+{
+  int k;
+  
+  m25519_ops.name = m25519_krn_src[0];
+  for (k = 1; k < M25519_KRN_NUM; k++) {
+    if (m25519_krn_src[k] != m25519_krn_src[0]) m25519_ops.name = "mixed";
+  }
+}
+
+
+// Installation of the kernels of a backend
+// ----------------------------------------
+// All kernels of the backend `ops` that are not NULL and pass the known-answer
+// test are installed in the ops table. M25519_ERR_BACKEND is returned if one
+// of the kernels failed the test (it is then not installed).
+
+int m25519_set_backend(const ArithOps *ops)
+{
+  int k, err = M25519_NO_ERROR;
+  
+  if (ops == NULL) return M25519_ERR_BACKEND;
+  for (k = 0; k < M25519_KRN_NUM; k++) {
+    if (!krn_avail(ops, k)) continue;
+    if (krn_check(ops, k) != 0) {
+      err = M25519_ERR_BACKEND;
+      continue;
+    }
+    krn_install(ops, k);
+  }
+  ops_update_name();
+  
+  return err;
+}
+
+
+// Selection of the fastest kernels of a list of backends
+// ------------------------------------------------------
+// For each of the seven kernels, the corresponding entries of the `num`
+// backends in `list` are tested and their execution time is measured with the
+// timer-function `timer` (e.g., a function that reads a cycle counter), and
+// the fastest of them is installed in the ops table. The list should only
+// contain backends that are supported by the hardware, i.e., the application
+// is responsible for probing the CPU features or the presence of a crypto
+// coprocessor. When `list` is NULL, the built-in backends (C99 and, if the
+// Assembly functions are available, ASM) are used. When `timer` is NULL, no
+// measurements are performed and the kernels of the last backend in `list`
+// that contains them are installed. In the case of equal execution times, the
+// backend that comes later in `list` is preferred. M25519_ERR_BACKEND is
+// returned if one of the kernels failed the known-answer test (it is then
+// not considered).
+
+int m25519_select_backend(const ArithOps *const *list, int num, \
+  uint32_t (*timer)(void))
+{
+  const ArithOps *blt[2], *best;
+  uint32_t t, tbest = 0;
+  int i, k, err = M25519_NO_ERROR;
+  
+  if (list == NULL) {
+    blt[0] = &m25519_ops_c99;
+    num = 1;
+#if defined(M25519_ASSEMBLY)
+    blt[1] = &m25519_ops_asm;
+    num = 2;
+#endif
+    list = blt;
+  }
+  
+  for (k = 0; k < M25519_KRN_NUM; k++) {
+    best = NULL;
+    for (i = 0; i < num; i++) {
+      if ((list[i] == NULL) || !krn_avail(list[i], k)) continue;
+      if (krn_check(list[i], k) != 0) {
+        err = M25519_ERR_BACKEND;
+        continue;
+      }
+      t = (timer != NULL) ? krn_time(list[i], k, timer) : 0;
+      if ((best == NULL) || (t <= tbest)) {
+        best = list[i];
+        tbest = t;
+      }
+    }
+    if (best != NULL) krn_install(best, k);
+  }
+  ops_update_name();
+  
+  return err;
+}
+
+
+// Name of the backend from which the installed kernel with index `kernel`
+// originates (NULL is returned if the index is invalid)
+
+const char *m25519_backend_name(int kernel)
+{
+  if ((kernel < 0) || (kernel >= M25519_KRN_NUM)) return NULL;
+  return m25519_krn_src[kernel];
+}
+
+
+#endif // #if defined(M25519_OPSTBL)
+
+#undef KRN_RUNS
+#undef KRN_MEAS
+#undef DEFAULT_NAME
+
+///////////////////////////////////////////////////////////////////////////////
+// src/moncurve.c                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+// The functions below operate on points of the Montgomery curve Curve25519,
+// which is given by the equation $y^2 = x^3 + A x^2 + x$ with $A = 486662$
+// over the prime field GF(p) with $p = 2^{255} - 19$. The Montgomery ladder
+// uses only the projective $X$ and $Z$-coordinates of two points $R$ and $S$,
+// whose difference $S - R$ remains constant during the whole ladder. These
+// four coordinates are stored in a single Word-array (e.g., the coordinates-
+// array of a `Point` of dimension 4) in the order $X_R, X_S, Z_R, Z_S$.
+
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+#if (!defined(M25519_ASSEMBLY_EXT) || defined(M25519_OPSTBL)) ////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Step of the Montgomery ladder: $S = R + S$ and $R = 2R$
+// -------------------------------------------------------
+// A single ladder step combines a differential point addition with a point
+// doubling and consists of five multiplications, four squarings, one multi-
+// plication by the 32-bit constant $a_{24} = (A+2)/4$, as well as four field-
+// additions and four field-subtractions. When `swap` is 1, the points $R$ and
+// $S$ are swapped (in constant time) before the computation, which means the
+// caller has to pass the XOR of the current and the previous bit of the scalar
+// and perform a final swap after the last ladder step. The formulas are taken
+// from RFC 7748 and compute $A = X_R + Z_R$, $B = X_R - Z_R$, $C = X_S + Z_S$,
+// $D = X_S - Z_S$, $X_S = (DA + CB)^2$, $Z_S = x_D (DA - CB)^2$, $X_R = AA
+// \cdot BB$ and $Z_R = E (BB + a_{24} E)$ with $E = AA - BB$. The Assembly
+// implementations of this function keep the callee-saved registers on the
+// stack for the whole step and fuse the conditional swap as well as several
+// additions and subtractions with the surrounding field-operations. In ops-
+// table mode, the C version is used so that the ladder step is carried out
+// with the installed kernels.
+
+void mon_ladder_step(Word *xz, const Word *xd, const Word *a24, int swap)
+{
+  Word tmp[6*LEN];  // temporary space for six gfp elements
+  Word *t0 = tmp, *t1 = &tmp[LEN], *t2 = &tmp[2*LEN], *t3 = &tmp[3*LEN];
+  Word *t4 = &tmp[4*LEN], *t5 = &tmp[5*LEN];
+  Word *xr = xz, *xs = &xz[LEN], *zr = &xz[2*LEN], *zs = &xz[3*LEN];
+  
+  M25519_PROF_INC(MON_LADDER_STEP);
+  gfp_cswap(xr, xs, swap);
+  gfp_cswap(zr, zs, swap);
+  
+  gfp_add(t0, xr, zr);    // t0 = A = X_R + Z_R
+  gfp_sub(t1, xr, zr);    // t1 = B = X_R - Z_R
+  gfp_add(t2, xs, zs);    // t2 = C = X_S + Z_S
+  gfp_sub(t3, xs, zs);    // t3 = D = X_S - Z_S
+  gfp_mul(t4, t3, t0);    // t4 = DA = D*A
+  gfp_mul(t5, t2, t1);    // t5 = CB = C*B
+  gfp_sqr(t0, t0);        // t0 = AA = A^2
+  gfp_sqr(t1, t1);        // t1 = BB = B^2
+  gfp_add(t2, t4, t5);    // t2 = DA + CB
+  gfp_sub(t3, t4, t5);    // t3 = DA - CB
+  gfp_sqr(xs, t2);        // X_S = (DA + CB)^2
+  gfp_sqr(t3, t3);        // t3 = (DA - CB)^2
+  gfp_mul(zs, t3, xd);    // Z_S = xd*(DA - CB)^2
+  gfp_mul(xr, t0, t1);    // X_R = AA*BB
+  gfp_sub(t4, t0, t1);    // t4 = E = AA - BB
+  gfp_mul32(t5, t4, a24); // t5 = a24*E
+  gfp_add(t5, t5, t1);    // t5 = BB + a24*E
+  gfp_mul(zr, t4, t5);    // Z_R = E*(BB + a24*E)
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+#endif /////////////// PERFORMANCE-CRITICAL POINT ARITHMETIC //////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Four-way step of the Montgomery ladder: $S_j = R_j + S_j$ and $R_j = 2R_j$
+// ---------------------------------------------------------------------------
+// This function performs a ladder step on four independent pairs of points at
+// once, using the same formulas and sequence of field-operations as the scalar
+// `mon_ladder_step`, but with the four-way parallel functions of `gfparith4.c`
+// (which can be SIMD-accelerated). The array `xz` contains four vectors (each
+// of length `LEN4`) with the coordinates $X_R, X_S, Z_R, Z_S$ of all lanes,
+// and `xd` is a vector with the $x$-coordinates of the four differences. Bit
+// j of `swap` specifies whether $R_j$ and $S_j$ are swapped before the step.
+
+void mon_ladder_step4(Word *xz, const Word *xd, const Word *a24, int swap)
+{
+  Word tmp[6*LEN4];  // temporary space for six gfp4 vectors
+  Word *t0 = tmp, *t1 = &tmp[LEN4], *t2 = &tmp[2*LEN4], *t3 = &tmp[3*LEN4];
+  Word *t4 = &tmp[4*LEN4], *t5 = &tmp[5*LEN4];
+  Word *xr = xz, *xs = &xz[LEN4], *zr = &xz[2*LEN4], *zs = &xz[3*LEN4];
+  
+  gfp4_cswap(xr, xs, swap);
+  gfp4_cswap(zr, zs, swap);
+  
+  gfp4_add(t0, xr, zr);    // t0 = A = X_R + Z_R
+  gfp4_sub(t1, xr, zr);    // t1 = B = X_R - Z_R
+  gfp4_add(t2, xs, zs);    // t2 = C = X_S + Z_S
+  gfp4_sub(t3, xs, zs);    // t3 = D = X_S - Z_S
+  gfp4_mul(t4, t3, t0);    // t4 = DA = D*A
+  gfp4_mul(t5, t2, t1);    // t5 = CB = C*B
+  gfp4_sqr(t0, t0);        // t0 = AA = A^2
+  gfp4_sqr(t1, t1);        // t1 = BB = B^2
+  gfp4_add(t2, t4, t5);    // t2 = DA + CB
+  gfp4_sub(t3, t4, t5);    // t3 = DA - CB
+  gfp4_sqr(xs, t2);        // X_S = (DA + CB)^2
+  gfp4_sqr(t3, t3);        // t3 = (DA - CB)^2
+  gfp4_mul(zs, t3, xd);    // Z_S = xd*(DA - CB)^2
+  gfp4_mul(xr, t0, t1);    // X_R = AA*BB
+  gfp4_sub(t4, t0, t1);    // t4 = E = AA - BB
+  gfp4_mul32(t5, t4, a24); // t5 = a24*E
+  gfp4_add(t5, t5, t1);    // t5 = BB + a24*E
+  gfp4_mul(zr, t4, t5);    // Z_R = E*(BB + a24*E)
+}
+
+
+// Batch conversion from projective to affine coordinates: $R_i = (x_i,y_i)$
+// -------------------------------------------------------------------------
+// The $Z$-coordinate of a point $P_i$ is the second coordinate when `p[i].dim`
+// is 2 (i.e., $[X:Z]$) and the third coordinate otherwise, which covers both
+// $[X:Y:Z]$ and the layout $X_R, X_S, Z_R, Z_S$ of the Montgomery ladder. All
+// $Z_i$ are inverted together by `gfp_inv_batch` (in constant time), so that
+// the conversion of $n$ points costs a single inversion and $3(n-1)$ plus one
+// or two multiplications per point. The affine $x_i = X_i/Z_i$ is always
+// computed, and $y_i = Y_i/Z_i$ only when `r[i].dim` is at least 2 and
+// `p[i].dim` is 3, i.e., $P_i = [X:Y:Z]$ (e.g., after recovery of the $Y$-
+// coordinate). For the ladder layout (`p[i].dim` = 4), the second coordinate
+// is $X_S$ and no $y$-coordinate is defined, which means the second coordinate
+// of $R_i$ is not written. The coordinates of the results are
+// fully reduced. The array `scratch` must be able to accommodate `2*n*LEN`
+// words, and `r` may be the same as `p`. The parameter `d` is not used by
+// this implementation. The return value is `M25519_ERR_MPOINT` if $Z_i = 0$
+// for at least one point (whose coordinates are then 0) and `M25519_NO_ERROR`
+// otherwise.
+
+int mon_conv_p2a_batch(Point *r, const Point *p, int n, Word *scratch, \
+  const ECDomPar *d)
+{
+  Word *zi = scratch;
+  int i, err;
+
+  (void) d;
+  if (n <= 0) return M25519_NO_ERROR;
+
+  for (i = 0; i < n; i++) {
+    mpi_copy(&zi[i*LEN], &p[i].xyz[((p[i].dim == 2) ? 1 : 2)*LEN], LEN);
+  }
+  err = gfp_inv_batch(zi, zi, n, &scratch[n*LEN]);
+  for (i = 0; i < n; i++) {
+    gfp_mul(r[i].xyz, p[i].xyz, &zi[i*LEN]);
+    gfp_fred(r[i].xyz, r[i].xyz);
+    if ((r[i].dim >= 2) && (p[i].dim == 3)) {
+      gfp_mul(&r[i].xyz[LEN], &p[i].xyz[LEN], &zi[i*LEN]);
+      gfp_fred(&r[i].xyz[LEN], &r[i].xyz[LEN]);
+    }
+  }
+
+  return (err == M25519_NO_ERROR) ? M25519_NO_ERROR : M25519_ERR_MPOINT;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// src/tedcurve.c                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#define CONSTA24 tedcurve_CONSTA24
+
+
+// The functions below operate on points of the twisted Edwards (TED) curve
+// Edwards25519, which is given by the equation $-x^2 + y^2 = 1 + d x^2 y^2$
+// with $d = -121665/121666$ over the prime field GF(p) with $p = 2^{255} -
+// 19$. Points are represented in affine $(x,y)$, extended affine $(u,v,w) =
+// ((x+y)/2, (y-x)/2, d x y)$, projective $[X:Y:Z]$ or extended projective
+// $[X:Y:Z:E:H]$ coordinates with $E H = T = X Y/Z$ (see `Point` in `config.h`).
+// The addition law of Edwards25519 is complete, i.e., the same formulas can be
+// used for all inputs, including the neutral element $O = (0,1)$ and $P = Q$.
+
+
+#include <stddef.h>
+
+#ifndef _TEDCOMB_H
+#define _TEDCOMB_H
+
+
+// Number of teeth and number of tables of the comb method
+
+#define TEDCOMB_TEETH 4
+#define TEDCOMB_TABLES 1
+
+// Table T_b[x] = 2^(256*b)*(G + sum_i (-1)^(1-x_i)*2^(64*i)*G)
+// with i = 1, ..., 3 and x_i = bit i-1 of x in extended affine (u,v,w)
+// coordinates (8 points, 768 bytes)
+
+static const Word TEDCOMBTBL[8*3*LEN] = {
+  // T_0[0]
+  0x138D08C5, 0x043F3A58, 0x85870FA1, 0xB3E07013,
+  0x8695B247, 0xF76E41CE, 0x7DCE4545, 0x7573504B,
+  0x0AB029D1, 0x82BD9764, 0x797EC894, 0x86D65A13,
+  0x5E886EEA, 0x7186C690, 0x83CDD997, 0x13DBCB4E,
+  0xB7B93EB6, 0x2C6DE0D2, 0xB8573997, 0xC68F3992,
+  0x703911A9, 0x868E0BE2, 0xA1384261, 0x07976122,
+  // T_0[1]
+  0xC24A250D, 0x4131C7C8, 0xCBC11802, 0x30AA5756,
+  0x97E05677, 0x3C51A4EF, 0x23F02CE0, 0x48D56ED2,
+  0xEC5F863D, 0xFBC48D8F, 0xCF85D764, 0xD9A913C5,
+  0xD666F119, 0x04130B9C, 0x796CE42E, 0x773443AA,
+  0x06D5981A, 0xAE4E6613, 0xF9081E12, 0xA083E1D5,
+  0x05481AAE, 0x38B4839E, 0x5A442922, 0x1E99A6EE,
+  // T_0[2]
+  0xAD06EADB, 0x8F998DB2, 0xE4C315E9, 0x85AA2FB0,
+  0x8AB9BC19, 0x1CCBC4D9, 0x3BA1EA2E, 0x49A839C8,
+  0xD60223B7, 0x4C8A1F02, 0x63394329, 0x2AC07ED3,
+  0x860ADE69, 0x9F7A426C, 0x2467132B, 0x4ECECE0F,
+  0x052970A1, 0xF60FBCE8, 0x37C71742, 0x0082CE23,
+  0x063EB98A, 0x93E44CB6, 0x5AD17D52, 0x3AD48C27,
+  // T_0[3]
+  0xEDC4684D, 0xF1F15409, 0xADD8A6E0, 0x37A0589E,
+  0xAA8F15E9, 0xE338AA12, 0x62321CB6, 0x6002DBD7,
+  0x12399C1F, 0x25D85164, 0x69CD242A, 0xC5C9EC8E,
+  0x5522C5A8, 0xB241E177, 0x24043413, 0x25E74A23,
+  0xD209C35F, 0x19BF8F3E, 0xA84944ED, 0x8FA5AB17,
+  0x682268B3, 0xCF596541, 0xCE2CDE12, 0x71C42244,
+  // T_0[4]
+  0xD71F346A, 0x8B695AAC, 0xAC23D65E, 0xB7E2B139,
+  0x4B14843A, 0x5CC48FAA, 0xB7F9C533, 0x61D47EE7,
+  0xCEB89A58, 0xF4EF693A, 0xAA3D8506, 0xF3DE5AC9,
+  0x0139A27D, 0xAF5E32F8, 0xC4DE4053, 0x33279AC7,
+  0x338AF5DA, 0x9EEA1CB2, 0x9DF251F8, 0x88A6C978,
+  0xABEA60AC, 0xF0A1C5B3, 0x3E77B642, 0x28DABE4E,
+  // T_0[5]
+  0x12AFC64E, 0x56E7E735, 0xE4A24477, 0xC5EC3BA0,
+  0x02222DFE, 0x049D4A6A, 0xFE748A45, 0x3D9288F9,
+  0xDF91AD9F, 0x8921237B, 0x0F6C3EE5, 0x743F372A,
+  0x609C2AC9, 0xBC29761A, 0x32A12F89, 0x3E0C2D44,
+  0x4F6CD7EE, 0xCBA7C0C7, 0xB5833E0C, 0x81999C80,
+  0xD0B2F852, 0xA23E4D6E, 0x0A0C2BDA, 0x6CB20250,
+  // T_0[6]
+  0x3BFEEC90, 0x66697EB4, 0x21BACF21, 0x413BB77F,
+  0xF24BE1BA, 0x6F627A4F, 0xA412460D, 0x6F2234AB,
+  0x17CD38CC, 0x31FC4062, 0x4881031D, 0xA285C8D8,
+  0x6A148DE8, 0x2374BE41, 0xFC547DB7, 0x61E97F59,
+  0x4B848FFF, 0x145E8B3A, 0x4EA5D384, 0x3814CAE8,
+  0x2F8076CA, 0x7D9BE98D, 0xCF8A095E, 0x0AA77DF7,
+  // T_0[7]
+  0xA3FDDC21, 0x89BF75B3, 0xB0408D45, 0x3CEFAE3A,
+  0xB8FC644D, 0x2D15D3B7, 0x1DE47FE1, 0x04CA952B,
+  0xEE3F7C1E, 0x515465A5, 0x2FC9E113, 0xCB5AE37D,
+  0x833271D2, 0xEA75F58D, 0x72E36797, 0x204DA56E,
+  0xC1A1A862, 0x226A9EDC, 0xD2FA82DA, 0xC494C982,
+  0x2CA4FF97, 0x7D917D51, 0x8232BEB2, 0x34DCB453
+};
+
+#endif
+
+
+#if ((TEDCOMB_TEETH != M25519_COMB_TEETH) || \
+     (TEDCOMB_TABLES != M25519_COMB_TABLES))
+#error "tedcomb.h does not match M25519_COMB_TEETH and M25519_COMB_TABLES"
+#endif
+
+#if ((M25519_COMB_TEETH < 2) || (M25519_COMB_TEETH > 8) || \
+     (M25519_COMB_TEETH*M25519_COMB_TABLES > 32))
+#error "M25519_COMB_TEETH must be in [2, 8] and TEETH*TABLES at most 32"
+#endif
+
+#if ((M25519_TED_WINDOW < 3) || (M25519_TED_WINDOW > 7))
+#error "M25519_TED_WINDOW must be in [3, 7]"
+#endif
+
+
+// Constant $a_{24} = (A+2)/4$ of Curve25519
+static const Word CONSTA24[1] = { 121666 };
+
+// Parameter $d = -121665/121666 \bmod p$ of Edwards25519
+static const Word CONSTD[LEN] = {
+  0x135978A3, 0x75EB4DCA, 0x4141D8AB, 0x00700A4D,
+  0x7779E898, 0x8CC74079, 0x2B6FFE73, 0x52036CEE
+};
+
+// Root of $-(A+2) = -486664 \bmod p$ for the mapping MON <-> TED
+static const Word CONSTRMA[LEN] = {
+  0xFF457E06, 0xCC6E04AA, 0x4B7D1A82, 0xC5A1D3D1,
+  0x03FC4F7E, 0xD27B08DC, 0x60A006BB, 0x0F26EDF4
+};
+
+// Root of $-1$, i.e., $2^{(p-1)/4} \bmod p$
+static const Word CONSTRM1[LEN] = {
+  0x4A0EA0B0, 0xC4EE1B27, 0xAD2FE478, 0x2F431806,
+  0x3DFBD7A7, 0x2B4D0099, 0x4FC1DF0B, 0x2B832480
+};
+
+// Cardinality $8 \ell$ of the elliptic-curve group
+static const Word CONSTCAR[LEN] = {
+  0xE7AE9F68, 0xC09318D2, 0x17BCE6B2, 0xA6F7CEF5,
+  0x00000000, 0x00000000, 0x00000000, 0x80000000
+};
+
+// Barrett constant $\lfloor 2^{512}/(8 \ell) \rfloor$ (257 bits long)
+static const Word CONSTCBR[LEN+1] = {
+  0x61458263, 0xFDB39CB4, 0xA10C6534, 0x6420C42B,
+  0xFFFFFFFD, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+  0x00000001
+};
+
+// Generator $G$ of Edwards25519 in extended affine coordinates $(u,v,w)$
+const Word TEDGENEA[3*LEN] = {
+  0x7AC61DB9, 0x97DE49E3, 0x7DC6070C, 0x67C996E3,
+  0x321EA161, 0x9385A44C, 0x19EA5D32, 0x43E7CE9D,
+  0xEBA0489F, 0xCE881C82, 0xE8A05F59, 0xFE9CCF82,
+  0x3447C504, 0xD2E0C21A, 0x4C7C0933, 0x227E97C9,
+  0xC3BD5534, 0x55E48902, 0xE655624F, 0x136CF411,
+  0xEEA1ACC6, 0x2D0DBEE5, 0x4F8632D4, 0x3788BDB4
+};
+
+const ECDomPar ECDOMPAR25519 = { CONSTK, CONSTC, CONSTA24, CONSTD, CONSTRMA, \
+  CONSTRM1, CONSTCAR, CONSTCBR, TEDCOMBTBL };
+
+
+// Bitlength of the recoded scalar processed by the comb method (at most 285
+// bits, i.e., the recoded scalar fits into LEN+1 words)
+
+#define COMBBITS (M25519_COMB_TEETH*M25519_COMB_TABLES*TED_COMBSPACE)
+
+// Maximum window-width used by `ted_mul_multi` (i.e., $2^{MAXWIN-1}$ buckets),
+// which is 5 only when `TED_MAXMULTI` allows 96 or more points
+#if (TED_MAXMULTI < 96)
+#define MAXWIN 4
+#else
+#define MAXWIN 5
+#endif
+
+// Maximum number of (signed) windows of a 256-bit scalar, which is reached for
+// the smallest window-width of 2
+#define MAXNUMWIN ((WSIZE*LEN)/2 + 1)
+
+// Number of Words needed to store one carry-bit per window
+#define CBITWORDS ((MAXNUMWIN + WSIZE)/WSIZE)
+
+// Number of digits of the wNAF of a 256-bit scalar (see `TED_NAFLEN`)
+#define NAFLEN TED_NAFLEN
+
+#if defined(M25519_DUAL_CORE)
+// Platform hook for running a job on the second core and for waiting until
+// the job has finished (both are NULL when no hook is registered)
+static void (*ted_core1_run)(TedJob job, void *arg) = NULL;
+static void (*ted_core1_wait)(void) = NULL;
+
+// Arguments of a (partial) scalar multiplication executed on the second core
+typedef struct tedjobarg {
+  Point *r;             // result in extended projective coordinates
+  const Word *s;        // scalar (wNAF) or recoded scalar (comb)
+  const Point *p;       // base point in extended affine coordinates (wNAF)
+  const Word *tbl;      // comb table (comb)
+  int b0, b1;           // range of sub-tables processed (comb)
+  const ECDomPar *d;    // domain parameters
+} TedJobArg;
+#endif
+
+// Number of signed windows of `M25519_TED_WINDOW-1` bits of a 256-bit scalar
+// processed by `ted_mul_varbase`
+#define NUMFIXWIN ((WSIZE*LEN + M25519_TED_WINDOW - 2)/(M25519_TED_WINDOW - 1))
+
+
+///////////////////////////////////////////////////////////////////////////////
+//////////////// UTILITY FUNCTIONS: INITIALIZATION, COPYING, ETC. /////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Initialization of a point with the neutral element: $R = O$
+// -----------------------------------------------------------
+// $O$ is $(0,1)$ in affine coordinates, $[0:1:1]$ in projective coordinates,
+// and $[0:1:1:0:1]$ in extended projective coordinates.
+
+void ted_set0(Point *r)
+{
+  Word *x = r->xyz, *y = &r->xyz[LEN], *z = &r->xyz[2*LEN];
+  Word *e = &r->xyz[3*LEN], *h = &r->xyz[4*LEN];
+
+  mpi_setw(x, 0, LEN);
+  mpi_setw(y, 1, LEN);
+  if (r->dim >= 3) mpi_setw(z, 1, LEN);
+  if (r->dim >= 5) {
+    mpi_setw(e, 0, LEN);
+    mpi_setw(h, 1, LEN);
+  }
+}
+
+
+// Copying of a point: $R = P$
+// ---------------------------
+// The dimensions of `r` and `p` may differ, except that `r->dim` must not be
+// 2. When `r` is in extended projective and `p` in (conventional) projective
+// coordinates, the coordinates of `p` are multiplied by $Z$, i.e., $R = [XZ:
+// YZ:Z^2:X:Y]$, so that $E H = T$ holds.
+
+void ted_copy(Point *r, const Point *p)
+{
+  Word *xr = r->xyz, *yr = &r->xyz[LEN], *zr = &r->xyz[2*LEN];
+  Word *er = &r->xyz[3*LEN], *hr = &r->xyz[4*LEN];
+  const Word *xp = p->xyz, *yp = &p->xyz[LEN], *zp = &p->xyz[2*LEN];
+
+  if (p->dim == 2) {  // affine source
+    mpi_copy(xr, xp, LEN);
+    mpi_copy(yr, yp, LEN);
+    mpi_setw(zr, 1, LEN);
+    if (r->dim >= 5) {
+      mpi_copy(er, xp, LEN);
+      mpi_copy(hr, yp, LEN);
+    }
+  } else if ((p->dim <= 4) && (r->dim >= 5)) {  // projective source
+    mpi_copy(er, xp, LEN);
+    mpi_copy(hr, yp, LEN);
+    gfp_mul(xr, xp, zp);
+    gfp_mul(yr, yp, zp);
+    gfp_sqr(zr, zp);
+  } else {  // same coordinate system or extended -> conventional projective
+    mpi_copy(r->xyz, p->xyz, ((r->dim >= 5) ? 5 : 3)*LEN);
+  }
+}
+
+
+// Loading of a point from the pre-computed table: $R = \pm \mathrm{Tbl}[i]$
+// ---------------------------------------------------------------------------
+// The table `tbl` consists of `TED_COMBSIZE` points in extended affine $(u,v,
+// w)$ coordinates (i.e., $3 \cdot$ LEN words each). The `M25519_COMB_TEETH-1`
+// least-significant bits of `idx` determine the index of the point that is
+// loaded and the next bit determines whether the point gets negated, i.e.,
+// $u$ and $v$ are swapped and $w$ is negated. To resist timing attacks (and
+// simple cache attacks), all points of the table are read and the requested
+// point is selected via AND-masks by `mpi_select` so that the memory-access
+// pattern does not depend on `idx`. Note that `r->dim` must be (at least) 3.
+
+void ted_load_point(Point *r, const Word *tbl, int idx)
+{
+  Word *u = r->xyz, *v = &r->xyz[LEN], *w = &r->xyz[2*LEN];
+  int neg = (idx >> (M25519_COMB_TEETH - 1)) & 1;
+
+  mpi_select(r->xyz, tbl, idx & (TED_COMBSIZE - 1), TED_COMBSIZE, 3*LEN);
+  gfp_cswap(u, v, neg);
+  gfp_cneg(w, w, neg);
+}
+
+
+// Loading of a point in ext. projective coordinates: $R = \pm \mathrm{Tbl}[i]$
+// ----------------------------------------------------------------------------
+// This function combines `ted_load_point` with the conversion to extended
+// projective coordinates of `ted_conv_ea2ep`, i.e., $R = [u-v:u+v:1:u-v:u+v]$
+// for the selected point $(u,v,w)$. Since the negation of the point swaps $u$
+// and $v$, it is merged into the conversion and no `gfp_cneg` is needed (the
+// coordinate $w$ is not used). The selection is performed in the array of
+// `r` itself, i.e., no temporary point is needed. Note that `r->dim` must be
+// (at least) 5.
+
+void ted_load_point_ep(Point *r, const Word *tbl, int idx)
+{
+  Word *u = r->xyz, *v = &r->xyz[LEN], *z = &r->xyz[2*LEN];
+  Word *e = &r->xyz[3*LEN], *h = &r->xyz[4*LEN];
+  int neg = (idx >> (M25519_COMB_TEETH - 1)) & 1;
+
+  mpi_select(r->xyz, tbl, idx & (TED_COMBSIZE - 1), TED_COMBSIZE, 3*LEN);
+  gfp_cswap(u, v, neg);
+  gfp_sub(e, u, v);     // E = u - v
+  gfp_add(h, u, v);     // H = u + v
+  mpi_copy(u, e, LEN);  // X = E
+  mpi_copy(v, h, LEN);  // Y = H
+  mpi_setw(z, 1, LEN);  // Z = 1
+}
+
+
+// Conversion from affine to extended affine coordinates: $R = (u,v,w)$
+// --------------------------------------------------------------------
+// This function computes the extended affine coordinates $(u,v,w) = ((x+y)/2,
+// (y-x)/2, d x y)$ of an affine point $P = (x,y)$. The parameter `d` is needed
+// to access the curve parameter $d$. Note that `r->dim` must be (at least) 3.
+
+void ted_conv_a2ea(Point *r, const Point *p, const ECDomPar *d)
+{
+  Word *u = r->xyz, *v = &r->xyz[LEN], *w = &r->xyz[2*LEN];
+  const Word *x = p->xyz, *y = &p->xyz[LEN];
+
+  gfp_mul(w, x, y);     // w = x*y
+  gfp_mul(w, w, d->dte);  // w = d*x*y
+  gfp_add(u, y, x);     // u = y + x
+  gfp_sub(v, y, x);     // v = y - x
+  gfp_hlv(u, u);        // u = (y + x)/2
+  gfp_hlv(v, v);        // v = (y - x)/2
+}
+
+
+// Conversion from extended affine to extended projective: $R = [X:Y:Z:E:H]$
+// -------------------------------------------------------------------------
+// Since $x = u - v$ and $y = u + v$, the conversion does not require any
+// multiplication, i.e., $R = [u-v:u+v:1:u-v:u+v]$.
+
+void ted_conv_ea2ep(Point *r, const Point *p)
+{
+  Word *x = r->xyz, *y = &r->xyz[LEN], *z = &r->xyz[2*LEN];
+  Word *e = &r->xyz[3*LEN], *h = &r->xyz[4*LEN];
+  const Word *u = p->xyz, *v = &p->xyz[LEN];
+
+  gfp_sub(x, u, v);     // X = u - v
+  gfp_add(y, u, v);     // Y = u + v
+  mpi_setw(z, 1, LEN);  // Z = 1
+  mpi_copy(e, x, LEN);  // E = X
+  mpi_copy(h, y, LEN);  // H = Y
+}
+
+
+#if defined(M25519_DUAL_CORE)
+
+// Registration of the platform hook for the second core
+// -----------------------------------------------------
+// The function `run` has to start the execution of `job(arg)` on the second
+// core and return immediately, while `wait` has to block until this job has
+// finished. Both have to act as memory barriers (as is the case for the
+// inter-core FIFOs, semaphores, or event groups of the common SDKs), so that
+// the result of the job is visible to the calling core after `wait`. At most
+// one job is started at a time. The hook is removed when `run` or `wait` is
+// NULL.
+
+void ted_set_core1(void (*run)(TedJob job, void *arg), void (*wait)(void))
+{
+  if ((run == NULL) || (wait == NULL)) {
+    run = NULL;
+    wait = NULL;
+  }
+  ted_core1_run = run;
+  ted_core1_wait = wait;
+}
+
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+/////////////////////// POINT ADDITION AND POINT DOUBLING /////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Mixed point addition: $R = R + P$
+// ---------------------------------
+// The point $R$ is given in extended projective $[X:Y:Z:E:H]$ and $P$ in
+// extended affine $(u,v,w)$ coordinates. The formulas are those of Hisil et
+// al. for $a = -1$ with $Z_P = 1$, whereby the factors of 2 are absorbed in
+// the coordinates $u, v, w$ of $P$ (i.e., all intermediate values are halved,
+// which yields the same projective point). A mixed addition computes $T = EH$,
+// $A = (Y-X)v$, $B = (Y+X)u$, $C = Tw$, $E' = B-A$, $H' = B+A$, $F = Z-C$,
+// $G = Z+C$, $X' = E'F$, $Y' = GH'$, $Z' = FG$ and costs seven multiplications.
+// The sixth coordinate of `r` is used to store intermediate results.
+
+void ted_add(Point *r, const Point *p)
+{
+  Word *x = r->xyz, *y = &r->xyz[LEN], *z = &r->xyz[2*LEN];
+  Word *e = &r->xyz[3*LEN], *h = &r->xyz[4*LEN], *t = &r->xyz[5*LEN];
+  const Word *u = p->xyz, *v = &p->xyz[LEN], *w = &p->xyz[2*LEN];
+
+  gfp_mul(t, e, h);     // t = T = E*H
+  gfp_sub(e, y, x);     // e = Y - X
+  gfp_add(h, y, x);     // h = Y + X
+  gfp_mul(e, e, v);     // e = A = (Y - X)*v
+  gfp_mul(h, h, u);     // h = B = (Y + X)*u
+  gfp_mul(t, t, w);     // t = C = T*w
+  gfp_sub(x, h, e);     // x = E' = B - A
+  gfp_add(h, h, e);     // h = H' = B + A
+  mpi_copy(e, x, LEN);  // e = E'
+  gfp_add(y, z, t);     // y = G = Z + C
+  gfp_sub(t, z, t);     // t = F = Z - C
+  gfp_mul(z, t, y);     // Z' = F*G
+  gfp_mul(x, x, t);     // X' = E'*F
+  gfp_mul(y, y, h);     // Y' = G*H'
+}
+
+
+// Extended projective point addition: $R = R + P$
+// -----------------------------------------------
+// Both $R$ and $P$ are given in extended projective $[X:Y:Z:E:H]$ coordinates
+// and `p->dim` must be (at least) 5. The formulas are the same as for the
+// mixed addition, but with $A = (Y_R-X_R)(Y_P-X_P)$, $B = (Y_R+X_R)(Y_P+X_P)$,
+// $C = 2d T_R T_P$ and $D = 2 Z_R Z_P$ in place of $Z$, which costs ten
+// multiplications. The parameter `d` is needed to access the curve parameter
+// $d$. The sixth coordinate of `r` is used to store intermediate results.
+
+void ted_add_ep(Point *r, const Point *p, const ECDomPar *d)
+{
+  Word tmp[2*LEN];  // temporary space for two gfp elements
+  Word *t0 = tmp, *t1 = &tmp[LEN];
+  Word *x = r->xyz, *y = &r->xyz[LEN], *z = &r->xyz[2*LEN];
+  Word *e = &r->xyz[3*LEN], *h = &r->xyz[4*LEN], *t = &r->xyz[5*LEN];
+  const Word *xp = p->xyz, *yp = &p->xyz[LEN], *zp = &p->xyz[2*LEN];
+  const Word *ep = &p->xyz[3*LEN], *hp = &p->xyz[4*LEN];
+
+  gfp_mul(t, e, h);     // t = T_R = E_R*H_R
+  gfp_mul(t0, ep, hp);  // t0 = T_P = E_P*H_P
+  gfp_mul(t, t, t0);    // t = T_R*T_P
+  gfp_mul(t, t, d->dte);  // t = d*T_R*T_P
+  gfp_add(t, t, t);     // t = C = 2*d*T_R*T_P
+  gfp_sub(t0, yp, xp);  // t0 = Y_P - X_P
+  gfp_sub(t1, y, x);    // t1 = Y_R - X_R
+  gfp_mul(e, t1, t0);   // e = A = (Y_R - X_R)*(Y_P - X_P)
+  gfp_add(t0, yp, xp);  // t0 = Y_P + X_P
+  gfp_add(t1, y, x);    // t1 = Y_R + X_R
+  gfp_mul(h, t1, t0);   // h = B = (Y_R + X_R)*(Y_P + X_P)
+  gfp_mul(z, z, zp);    // z = Z_R*Z_P
+  gfp_add(z, z, z);     // z = D = 2*Z_R*Z_P
+  gfp_sub(x, h, e);     // x = E' = B - A
+  gfp_add(h, h, e);     // h = H' = B + A
+  mpi_copy(e, x, LEN);  // e = E'
+  gfp_add(y, z, t);     // y = G = D + C
+  gfp_sub(t, z, t);     // t = F = D - C
+  gfp_mul(z, t, y);     // Z' = F*G
+  gfp_mul(x, x, t);     // X' = E'*F
+  gfp_mul(y, y, h);     // Y' = G*H'
+}
+
+
+// Extended projective point doubling: $R = 2R$
+// --------------------------------------------
+// The doubling formulas of Hisil et al. for $a = -1$ compute $A = X^2$, $B =
+// Y^2$, $C = 2Z^2$, $E' = (X+Y)^2 - A - B$, $G = B - A$, $F = G - C$ and $H' =
+// -A - B$. To save two negations, the signs of $F$ and $H'$ are flipped (i.e.,
+// $F = C - G$ and $H' = A + B$), which scales $X'$, $Y'$, $Z'$ and $T' = E'H'$
+// all by $-1$ and, thus, yields the same projective point. A doubling costs
+// four squarings and three multiplications. The sixth coordinate of `r` is
+// used to store intermediate results.
+
+void ted_double(Point *r)
+{
+  Word *x = r->xyz, *y = &r->xyz[LEN], *z = &r->xyz[2*LEN];
+  Word *e = &r->xyz[3*LEN], *h = &r->xyz[4*LEN], *t = &r->xyz[5*LEN];
+
+  gfp_add(t, x, y);     // t = X + Y
+  gfp_sqr(t, t);        // t = (X + Y)^2
+  gfp_sqr(x, x);        // x = A = X^2
+  gfp_sqr(y, y);        // y = B = Y^2
+  gfp_sqr(z, z);        // z = Z^2
+  gfp_add(z, z, z);     // z = C = 2*Z^2
+  gfp_add(h, x, y);     // h = H' = A + B
+  gfp_sub(e, t, h);     // e = E' = (X + Y)^2 - A - B
+  gfp_sub(y, y, x);     // y = G = B - A
+  gfp_sub(t, z, y);     // t = F = C - G
+  gfp_mul(x, e, t);     // X' = E'*F
+  gfp_mul(z, t, y);     // Z' = F*G
+  gfp_mul(y, y, h);     // Y' = G*H'
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+////////////////////// (MULTI-)SCALAR MULTIPLICATION //////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Recoding of a scalar for the comb method
+// ----------------------------------------
+// The scalar $l$ is reduced modulo $\ell$ (via conditional subtractions of $8
+// \ell$, $4 \ell$, $2 \ell$ and $\ell$) and made odd by adding $\ell$ when
+// it is even, which yields $l' < 2^{254}$ with $l' G = l G$. The odd scalar
+// $l'$ is recoded as $m = (l' + 2^n - 1)/2$ with $n$ = `COMBBITS` so that $l'
+// = \sum_i (2 m_i - 1) 2^i$, i.e., each bit $m_i$ represents a digit $\pm 1$.
+// The array `m` must have a length of LEN+1 words.
+
+static void ted_comb_recode(Word *m, const Word *l, const ECDomPar *d)
+{
+  Word ell[LEN];
+  int i, bit;
+
+  mpi_copy(ell, d->car, LEN);
+  mpi_copy(m, l, LEN);
+  for (i = 0; i < 4; i++) {
+    if (i > 0) mpi_shr(ell, ell, LEN);
+    bit = mpi_sub(m, m, ell, LEN);
+    mpi_cadd(m, m, ell, bit, LEN);
+  }
+  // l' = l + ell if l is even, then m = (l' - 1)/2 + 2^(n-1)
+  mpi_cadd(m, m, ell, (int) (1 - (m[0] & 1)), LEN);
+  mpi_shr(m, m, LEN);
+  m[LEN] = 0;
+  m[(COMBBITS-1)/WSIZE] |= ((Word) 1) << ((COMBBITS - 1) % WSIZE);
+}
+
+
+// Index of the table-entry for column `j` of table `b` of a recoded scalar
+// ------------------------------------------------------------------------
+// The first digit of the column determines the sign (i.e., the bit at
+// position `M25519_COMB_TEETH-1` of the index is set when the first digit is
+// $-1$) and the other digits, XORed with the first, the index of the point.
+
+static int ted_comb_index(const Word *m, int j, int b)
+{
+  int i, pos, lead, bit, idx;
+
+  pos = j + b*M25519_COMB_TEETH*TED_COMBSPACE;
+  lead = (int) ((m[pos/WSIZE] >> (pos % WSIZE)) & 1);
+  idx = (1 - lead) << (M25519_COMB_TEETH - 1);
+  for (i = 1; i < M25519_COMB_TEETH; i++) {
+    pos += TED_COMBSPACE;
+    bit = (int) ((m[pos/WSIZE] >> (pos % WSIZE)) & 1);
+    idx |= (1 ^ lead ^ bit) << (i - 1);
+  }
+
+  return idx;
+}
+
+
+// Column `j` of the comb method with the sub-tables `b0` to `b1-1`
+// ------------------------------------------------------------------
+// This function processes one column of the recoded scalar `m`, i.e., it
+// doubles $R$ and adds the points of the sub-tables in the range [`b0`, `b1`)
+// of the table `tbl`. For the very first column (`j` = `TED_COMBSPACE-1`),
+// the doubling is omitted and the point of sub-table `b0` is loaded directly
+// in extended projective coordinates. `r->dim` must be 6.
+
+static void ted_comb_column(Point *r, const Word *m, const Word *tbl, int j, \
+  int b0, int b1)
+{
+  Word tmp[3*LEN];
+  Point tp = { 3, tmp };
+  int b = b0, idx;
+
+  if (j == TED_COMBSPACE - 1) {
+    idx = ted_comb_index(m, j, b0);
+    ted_load_point_ep(r, &tbl[b0*TED_COMBSIZE*3*LEN], idx);
+    b++;
+  } else {
+    ted_double(r);
+  }
+  for (; b < b1; b++) {
+    idx = ted_comb_index(m, j, b);
+    ted_load_point(&tp, &tbl[b*TED_COMBSIZE*3*LEN], idx);
+    ted_add(r, &tp);
+  }
+}
+
+
+// Comb method with the sub-tables `b0` to `b1-1` of a recoded scalar
+// ------------------------------------------------------------------
+// This function executes the main loop of the comb method (i.e., all columns
+// from `TED_COMBSPACE-1` down to 0) for the sub-tables in the range [`b0`,
+// `b1`) of the table `tbl` and the recoded scalar `m`. `r->dim` must be 6.
+
+static void ted_comb_part(Point *r, const Word *m, const Word *tbl, int b0, \
+  int b1)
+{
+  int j;
+
+  for (j = TED_COMBSPACE - 1; j >= 0; j--) {
+    ted_comb_column(r, m, tbl, j, b0, b1);
+  }
+}
+
+
+#if defined(M25519_DUAL_CORE)
+
+// Job for the second core that executes `ted_comb_part`
+static void ted_comb_job(void *arg)
+{
+  TedJobArg *a = (TedJobArg *) arg;
+
+  ted_comb_part(a->r, a->s, a->tbl, a->b0, a->b1);
+}
+
+#endif
+
+
+// Fixed-base comb method: $R = l G$
+// ---------------------------------
+// This function implements a signed-digit comb method with `M25519_COMB_TEETH`
+// teeth and `M25519_COMB_TABLES` tables, which is configured in `config.h`.
+// The scalar $l$ is first recoded by `ted_comb_recode` into $n$ = `COMBBITS`
+// digits $\pm 1$, which are split into `M25519_COMB_TEETH*M25519_COMB_TABLES`
+// rows of `TED_COMBSPACE` digits. Every column of `M25519_COMB_TEETH` rows
+// belongs to one table, which contains the `TED_COMBSIZE` points $2^{e t b} (G
+// + \sum_i \pm 2^{e i} G)$ (where $e$ is the spacing, $t$ the number of teeth,
+// and $b$ the table). Each iteration of the main loop performs one doubling
+// and `M25519_COMB_TABLES` mixed additions of points obtained via
+// `ted_load_point`, except that the very first point is loaded directly in
+// extended projective coordinates by `ted_load_point_ep` (i.e., the addition
+// to $O$ is omitted). All operations, including the loading of points, have an
+// operand-independent execution profile. The result $R$ is given in extended
+// projective coordinates, i.e., `r->dim` must be 6. The parameter `d` is
+// needed to access the group order and the table. When `M25519_DUAL_CORE` is
+// defined, a hook for the second core is registered, and there are at least
+// two tables, the upper half of the tables is processed on the second core
+// (with its own doublings) and the two partial results are added at the end.
+// The recoded scalar is wiped before the function returns.
+
+void ted_mul_combNb(Point *r, const Word *l, const ECDomPar *d)
+{
+  Word m[LEN+1];
+#if (defined(M25519_DUAL_CORE) && (M25519_COMB_TABLES > 1))
+  Word tmp[6*LEN];
+  Point tp = { 6, tmp };
+  TedJobArg arg;
+#endif
+
+  ted_comb_recode(m, l, d);
+#if (defined(M25519_DUAL_CORE) && (M25519_COMB_TABLES > 1))
+  if (ted_core1_run != NULL) {
+    arg.r = &tp;
+    arg.s = m;
+    arg.p = NULL;
+    arg.tbl = d->tbl;
+    arg.b0 = M25519_COMB_TABLES/2;
+    arg.b1 = M25519_COMB_TABLES;
+    arg.d = d;
+    ted_core1_run(ted_comb_job, &arg);
+    ted_comb_part(r, m, d->tbl, 0, M25519_COMB_TABLES/2);
+    ted_core1_wait();
+    ted_add_ep(r, &tp, d);
+  } else
+#endif
+  ted_comb_part(r, m, d->tbl, 0, M25519_COMB_TABLES);
+  mpi_setw(m, 0, LEN+1);  // the recoded scalar is as secret as $l$
+}
+
+
+// Pre-computation of a comb table for an arbitrary point $P$
+// ----------------------------------------------------------
+// This function computes a table of the same format as `ECDomPar.tbl` (i.e.,
+// `M25519_COMB_TABLES` sub-tables of `TED_COMBSIZE` points in extended affine
+// coordinates) for the affine point $P$ instead of $G$, so that the array
+// `tbl` must be able to accommodate `TED_COMBWORDS` words. The multiples
+// $2^{e i} P$ for the teeth of one sub-table are obtained by repeated doubling
+// and converted to extended affine coordinates, then each entry is computed
+// with `M25519_COMB_TEETH-1` mixed additions and converted as well. The
+// parameter `d` is needed to access the curve parameter $d$.
+// NOTE: The execution time of this function is not constant. It is intended
+// for public points (e.g., the public key of a signer).
+
+void ted_comb_table(Word *tbl, const Point *p, const ECDomPar *d)
+{
+  Word q[M25519_COMB_TEETH*3*LEN], cur[6*LEN], sum[6*LEN], neg[3*LEN];
+  Word aff[2*LEN];
+  Point curp = { 6, cur }, sump = { 6, sum }, qp = { 3, NULL };
+  Point negp = { 3, neg }, affp = { 2, aff };
+  int b, i, j, x;
+
+  ted_copy(&curp, p);
+  for (b = 0; b < M25519_COMB_TABLES; b++) {
+    // multiples 2^(e*(t*b+i))*P for the teeth of table b
+    for (i = 0; i < M25519_COMB_TEETH; i++) {
+      ted_conv_p2a(&affp, &curp, d);
+      qp.xyz = &q[i*3*LEN];
+      ted_conv_a2ea(&qp, &affp, d);
+      if ((b < M25519_COMB_TABLES - 1) || (i < M25519_COMB_TEETH - 1))
+        for (j = 0; j < TED_COMBSPACE; j++) ted_double(&curp);
+    }
+    // entries P_0 +/- P_1 +/- ... +/- P_(t-1) of table b
+    for (x = 0; x < TED_COMBSIZE; x++) {
+      qp.xyz = q;
+      ted_conv_ea2ep(&sump, &qp);
+      for (i = 1; i < M25519_COMB_TEETH; i++) {
+        if ((x >> (i - 1)) & 1) {
+          qp.xyz = &q[i*3*LEN];
+          ted_add(&sump, &qp);
+        } else {  // -P = (v,u,-w)
+          mpi_copy(neg, &q[i*3*LEN+LEN], LEN);
+          mpi_copy(&neg[LEN], &q[i*3*LEN], LEN);
+          gfp_cneg(&neg[2*LEN], &q[i*3*LEN+2*LEN], 1);
+          ted_add(&sump, &negp);
+        }
+      }
+      ted_conv_p2a(&affp, &sump, d);
+      qp.xyz = &tbl[(b*TED_COMBSIZE+x)*3*LEN];
+      ted_conv_a2ea(&qp, &affp, d);
+    }
+  }
+}
+
+
+// Double-base comb method with two tables: $R = l G + k P$
+// ---------------------------------------------------------
+// Both scalars are recoded by `ted_comb_recode` and processed with the same
+// sequence of doublings, i.e., each iteration of the main loop performs one
+// doubling and $2 \cdot$ `M25519_COMB_TABLES` mixed additions. The comb table
+// of $P$ must have been computed with `ted_comb_table`, and the one of $G$ is
+// accessed via `d`. Since $k$ is reduced modulo $\ell$ and possibly increased
+// by $\ell$, the result differs from $l G + k P$ by a point of order 1, 2, 4,
+// or 8 when $P$ is not in the subgroup of order $\ell$; this does not matter
+// for the "cofactored" verification of signatures. The result $R$ is given in
+// extended projective coordinates, i.e., `r->dim` must be 6.
+// When a hook for the second core is registered (see `M25519_DUAL_CORE`),
+// $k P$ is computed with `ted_comb_part` on the second core and $l G$ with
+// `ted_comb_part` on the calling core, i.e., each core executes its own
+// doublings, and the two products are added at the end.
+// NOTE: The points are taken directly from the tables (i.e., without reading
+// all entries), so the execution time of this function depends on the
+// scalars. It must only be used when both scalars are public.
+
+void ted_mul_dblbase_tbl(Point *r, const Word *l, const Word *k, \
+  const Word *tbl, const ECDomPar *d)
+{
+  Word ml[LEN+1], mk[LEN+1], neg[3*LEN];
+  const Word *tab[2], *ent;
+  const Word *m[2];
+  Point tp = { 3, NULL };
+  int i, j, b, idx;
+#if defined(M25519_DUAL_CORE)
+  Word tmp[6*LEN];
+  Point kp = { 6, tmp };
+  TedJobArg arg;
+#endif
+
+  ted_comb_recode(ml, l, d);
+  ted_comb_recode(mk, k, d);
+#if defined(M25519_DUAL_CORE)
+  if (ted_core1_run != NULL) {
+    arg.r = &kp;
+    arg.s = mk;
+    arg.p = NULL;
+    arg.tbl = tbl;
+    arg.b0 = 0;
+    arg.b1 = M25519_COMB_TABLES;
+    arg.d = d;
+    ted_core1_run(ted_comb_job, &arg);
+    ted_comb_part(r, ml, d->tbl, 0, M25519_COMB_TABLES);
+    ted_core1_wait();
+    ted_add_ep(r, &kp, d);
+    return;
+  }
+#endif
+  m[0] = ml; m[1] = mk;
+  tab[0] = d->tbl; tab[1] = tbl;
+
+  ted_set0(r);
+  for (j = TED_COMBSPACE - 1; j >= 0; j--) {
+    if (j < TED_COMBSPACE - 1) ted_double(r);
+    for (b = 0; b < M25519_COMB_TABLES; b++) {
+      for (i = 0; i < 2; i++) {
+        idx = ted_comb_index(m[i], j, b);
+        ent = &tab[i][(b*TED_COMBSIZE+(idx&(TED_COMBSIZE-1)))*3*LEN];
+        if (idx & TED_COMBSIZE) {  // -P = (v,u,-w)
+          mpi_copy(neg, &ent[LEN], LEN);
+          mpi_copy(&neg[LEN], ent, LEN);
+          gfp_cneg(&neg[2*LEN], &ent[2*LEN], 1);
+          ent = neg;
+        }
+        tp.xyz = (Word *) ent;
+        ted_add(r, &tp);
+      }
+    }
+  }
+}
+
+
+// Conversion from projective to affine coordinates: $R = (x,y)$
+// -------------------------------------------------------------
+// The inverse of $Z$ is computed by `gfp_inv` when `M25519_SAFEGCD_INV` is
+// defined (since this inversion has constant execution time) and otherwise as
+// $Z^{p-2} = (Z^{(p-5)/8})^8 Z^3$ with `gfp_exp_p58`, which also has constant
+// execution time and does not require a random field-element for masking. The
+// coordinates $x = X/Z$ and $y = Y/Z$ are fully reduced. The parameter `d` is
+// not used by this implementation. The return value is `M25519_ERR_TPOINT`
+// if $Z = 0$ and `M25519_NO_ERROR` otherwise.
+
+int ted_conv_p2a(Point *r, const Point *p, const ECDomPar *d)
+{
+  Word zi[LEN], t[LEN];
+  Word *x = r->xyz, *y = &r->xyz[LEN];
+  const Word *zp = &p->xyz[2*LEN];
+  int err;
+
+  (void) d;
+  mpi_setw(t, 0, LEN);
+  err = (gfp_cmp(zp, t) == 0) ? M25519_ERR_TPOINT : M25519_NO_ERROR;
+#if defined(M25519_SAFEGCD_INV)
+  gfp_inv(zi, zp);
+#else
+  gfp_exp_p58(zi, zp);  // zi = Z^((p-5)/8)
+  gfp_sqrn(zi, zi, 3);  // zi = Z^(p-5)
+  gfp_sqr(t, zp);       // t = Z^2
+  gfp_mul(t, t, zp);    // t = Z^3
+  gfp_mul(zi, zi, t);   // zi = Z^(p-2) = 1/Z
+#endif
+  gfp_mul(x, p->xyz, zi);
+  gfp_mul(y, &p->xyz[LEN], zi);
+  gfp_fred(x, x);
+  gfp_fred(y, y);
+
+  return err;
+}
+
+
+// Batch conversion from projective to affine coordinates: $R_i = (x_i,y_i)$
+// -------------------------------------------------------------------------
+// The `n` points $P_i$ must be given in projective coordinates (`p[i].dim` at
+// least 3), and the results $R_i$ need a dimension of at least 2. All $Z_i$
+// are inverted together by `gfp_inv_batch`, i.e., with a single inversion
+// that has constant execution time (like that of `ted_conv_p2a`) and $3(n-1)$
+// multiplications instead of $n$ inversions. The coordinates $x_i = X_i/Z_i$
+// and $y_i = Y_i/Z_i$ are fully reduced. The array `scratch` must be able to
+// accommodate `2*n*LEN` words, and `r` may be the same as `p`. The parameter
+// `d` is not used by this implementation. The return value is
+// `M25519_ERR_TPOINT` if $Z_i = 0$ for at least one point (whose coordinates
+// are then 0) and `M25519_NO_ERROR` otherwise.
+
+int ted_conv_p2a_batch(Point *r, const Point *p, int n, Word *scratch, \
+  const ECDomPar *d)
+{
+  Word *zi = scratch;
+  int i, err;
+
+  (void) d;
+  if (n <= 0) return M25519_NO_ERROR;
+
+  for (i = 0; i < n; i++) mpi_copy(&zi[i*LEN], &p[i].xyz[2*LEN], LEN);
+  err = gfp_inv_batch(zi, zi, n, &scratch[n*LEN]);
+  for (i = 0; i < n; i++) {
+    gfp_mul(r[i].xyz, p[i].xyz, &zi[i*LEN]);
+    gfp_mul(&r[i].xyz[LEN], &p[i].xyz[LEN], &zi[i*LEN]);
+    gfp_fred(r[i].xyz, r[i].xyz);
+    gfp_fred(&r[i].xyz[LEN], &r[i].xyz[LEN]);
+  }
+
+  return (err == M25519_NO_ERROR) ? M25519_NO_ERROR : M25519_ERR_TPOINT;
+}
+
+
+// Fixed-base scalar multiplication: $R = l G$
+// -------------------------------------------
+// The scalar $l$ (eight words) must not be 0. The result $R$ is given in
+// affine coordinates and is checked not to be the neutral element $O$. The
+// return value is `M25519_ERR_SCALAR` if $l = 0$, `M25519_ERR_TPOINT` if $R =
+// O$ (i.e., $l$ is a multiple of $\ell$), and `M25519_NO_ERROR` otherwise.
+
+int ted_mul_fixbase(Point *r, const Word *l, const ECDomPar *d)
+{
+  Word tmp[6*LEN];
+  Point tp = { 6, tmp };
+  int err;
+
+  if (mpi_cmpw(l, 0, LEN) == 0) return M25519_ERR_SCALAR;
+  ted_mul_combNb(&tp, l, d);
+  err = ted_conv_p2a(r, &tp, d);
+  if ((mpi_cmpw(r->xyz, 0, LEN) == 0) && (mpi_cmpw(&r->xyz[LEN], 1, LEN) == 0))
+    err = M25519_ERR_TPOINT;
+
+  return err;
+}
+
+
+// Check whether a projective point $P$ is the neutral element $O$
+// ---------------------------------------------------------------
+// $P = (X:Y:Z)$ is $O$ if and only if $X = 0$ and $Y = Z$ (which implies $Z
+// \neq 0$ for valid points). The comparisons have constant execution time.
+
+static int ted_is_neutral(const Point *p)
+{
+  Word zero[LEN];
+  int neutral;
+
+  mpi_setw(zero, 0, LEN);
+  neutral = (gfp_cmp(p->xyz, zero) == 0);
+  neutral &= (gfp_cmp(&p->xyz[LEN], &p->xyz[2*LEN]) == 0);
+
+  return neutral;
+}
+
+
+// Fixed-base scalar multiplication with projective result: $R = l G$
+// ------------------------------------------------------------------
+// This function computes the same point as `ted_mul_fixbase`, but $R$ is left
+// in extended projective coordinates $[X:Y:Z:E:H]$ (i.e., `r->dim` must be 6)
+// so that the inversion of `ted_conv_p2a` can be omitted when $R$ is used in
+// further point operations, or shared by several points when they are
+// compressed with `ted_compress_batch`. The return value is the same as that
+// of `ted_mul_fixbase`; when $l = 0$, $R$ is not written.
+
+int ted_mul_fixbase_proj(Point *r, const Word *l, const ECDomPar *d)
+{
+  if (mpi_cmpw(l, 0, LEN) == 0) return M25519_ERR_SCALAR;
+  ted_mul_combNb(r, l, d);
+
+  return ted_is_neutral(r) ? M25519_ERR_TPOINT : M25519_NO_ERROR;
+}
+
+
+// Resumable fixed-base scalar multiplication: $R = l G$
+// -----------------------------------------------------
+// These three functions compute the same result as `ted_mul_fixbase`, but
+// the comb method is split into `TED_COMBSPACE` steps (one column of the comb,
+// i.e., one doubling and `M25519_COMB_TABLES` mixed additions) so that a
+// caller can interleave the scalar multiplication with other tasks. The init
+// function checks and recodes the scalar $l$, and every step function
+// processes up to `n` columns and returns the number of columns that are
+// still to be processed (0 when the comb method is complete). Each column has
+// an operand-independent execution profile, and the number of processed
+// columns only depends on `n`. The final function converts the result to
+// affine coordinates (which costs about as much as 20 columns in the default
+// configuration), checks it, and wipes the context. The return value of the
+// init and the final function is the same as that of `ted_mul_fixbase`,
+// except that the final function
+// returns `M25519_ERR_STREAM` when the comb method is not complete yet (or the
+// context has already been finalized).
+
+int ted_mul_fixbase_init(TedFixCtx *ctx, const Word *l, const ECDomPar *d)
+{
+  ctx->err = M25519_NO_ERROR;
+  ctx->pos = TED_COMBSPACE - 1;
+  ted_comb_recode(ctx->m, l, d);
+  if (mpi_cmpw(l, 0, LEN) == 0) {
+    ctx->err = M25519_ERR_SCALAR;
+    ctx->pos = -1;
+  }
+
+  return ctx->err;
+}
+
+
+int ted_mul_fixbase_step(TedFixCtx *ctx, int n, const ECDomPar *d)
+{
+  Point rp = { 6, ctx->xyz };
+
+  for (; (n > 0) && (ctx->pos >= 0); n--, ctx->pos--) {
+    ted_comb_column(&rp, ctx->m, d->tbl, ctx->pos, 0, M25519_COMB_TABLES);
+  }
+
+  return ctx->pos + 1;
+}
+
+
+int ted_mul_fixbase_final(Point *r, TedFixCtx *ctx, const ECDomPar *d)
+{
+  Point tp = { 6, ctx->xyz };
+  int err = ctx->err;
+
+  if ((err == M25519_NO_ERROR) && (ctx->pos >= 0)) err = M25519_ERR_STREAM;
+  if (err == M25519_NO_ERROR) {
+    err = ted_conv_p2a(r, &tp, d);
+    if ((mpi_cmpw(r->xyz, 0, LEN) == 0) && \
+        (mpi_cmpw(&r->xyz[LEN], 1, LEN) == 0)) err = M25519_ERR_TPOINT;
+  }
+  mpi_setw(ctx->xyz, 0, 6*LEN);
+  mpi_setw(ctx->m, 0, LEN+1);
+  ctx->pos = -1;
+  ctx->err = M25519_ERR_STREAM;
+
+  return err;
+}
+
+
+// Extraction of `c` bits of a 256-bit scalar, starting at position `pos`
+// ----------------------------------------------------------------------
+// Bits at a position of 256 or higher are 0.
+
+static int ted_getbits(const Word *k, int pos, int c)
+{
+  Word bits;
+  int i = pos/WSIZE, j = pos % WSIZE;
+
+  if (i >= LEN) return 0;
+  bits = k[i] >> j;
+  if ((j + c > WSIZE) && (i + 1 < LEN)) bits |= k[i+1] << (WSIZE - j);
+
+  return (int) (bits & ((((Word) 1) << c) - 1));
+}
+
+
+// Multi-scalar multiplication: $R = \sum_i k_i P_i$
+// --------------------------------------------------
+// This function implements the bucket method of Pippenger with signed digits.
+// Each 256-bit scalar $k_i$ is recoded into windows of `c` bits with digits
+// in the range $[-2^{c-1}, 2^{c-1}-1]$, whereby only the carry-bits of the
+// recoding are stored (the digits are re-computed from the scalar and the
+// carries). Starting with the most-significant window, the points $\pm P_i$
+// are added (mixed additions) to the bucket $|d_i|-1$ selected by their digit
+// $d_i$, and the weighted sum $\sum_j (j+1) B_j$ of the buckets is computed
+// with two running sums and added to $R$, which is doubled `c` times before
+// each window. The window-width `c` is chosen depending on the number of
+// points `n` (at most `TED_MAXMULTI`) so that roughly $256/c \cdot (n +
+// 2^c)$ point additions are needed instead of $256 \cdot n/2$ for `n`
+// separate double-and-add scalar multiplications. The points $P_i$ must be
+// given in extended affine $(u,v,w)$ coordinates, and the result $R$ is in
+// extended projective coordinates, i.e., `r->dim` must be 6. The parameter
+// `d` is needed to access the curve parameter $d$.
+// NOTE: The execution time of this function depends on the scalars (and the
+// points may be neutral elements), i.e., it must not be used with secret
+// scalars. Its main application is the verification of signatures.
+
+void ted_mul_multi(Point *r, const Word *k, const Point *p, int n, \
+  const ECDomPar *d)
+{
+  Word bkt[(1 << (MAXWIN - 1))*6*LEN], run[6*LEN], sum[6*LEN], neg[3*LEN];
+  Word cbits[TED_MAXMULTI*CBITWORDS];
+  Point bp = { 6, NULL }, runp = { 6, run }, sump = { 6, sum };
+  Point negp = { 3, neg };
+  int used[1 << (MAXWIN - 1)];
+  int c, numwin, half, i, j, w, dig, carry, rset = 0, bset, sset;
+
+  c = (n < 8) ? 2 : ((n < 24) ? 3 : ((n < 96) ? 4 : 5));
+  numwin = (WSIZE*LEN + c - 1)/c + 1;
+  half = 1 << (c - 1);
+
+  // signed recoding of the scalars: only the carry-bits are stored
+  for (i = 0; i < n; i++) {
+    mpi_setw(&cbits[i*CBITWORDS], 0, CBITWORDS);
+    carry = 0;
+    for (w = 0; w < numwin - 1; w++) {
+      carry = ((ted_getbits(&k[i*LEN], w*c, c) + carry) >= half);
+      cbits[i*CBITWORDS+(w+1)/WSIZE] |= ((Word) carry) << ((w + 1) % WSIZE);
+    }
+  }
+
+  ted_set0(r);
+  for (w = numwin - 1; w >= 0; w--) {
+    if (rset) for (j = 0; j < c; j++) ted_double(r);
+    // accumulation of the points in the buckets
+    for (j = 0; j < half; j++) used[j] = 0;
+    for (i = 0; i < n; i++) {
+      dig = ted_getbits(&k[i*LEN], w*c, c);
+      dig += (cbits[i*CBITWORDS+w/WSIZE] >> (w % WSIZE)) & 1;
+      dig -= ((cbits[i*CBITWORDS+(w+1)/WSIZE] >> ((w + 1) % WSIZE)) & 1) << c;
+      if (dig == 0) continue;
+      if (dig > 0) {
+        negp.xyz = p[i].xyz;
+      } else {  // -P = (v,u,-w)
+        mpi_copy(neg, &p[i].xyz[LEN], LEN);
+        mpi_copy(&neg[LEN], p[i].xyz, LEN);
+        gfp_cneg(&neg[2*LEN], &p[i].xyz[2*LEN], 1);
+        negp.xyz = neg;
+        dig = -dig;
+      }
+      bp.xyz = &bkt[(dig-1)*6*LEN];
+      if (used[dig-1]) ted_add(&bp, &negp);
+      else ted_conv_ea2ep(&bp, &negp);
+      used[dig-1] = 1;
+    }
+    // weighted sum of the buckets: sum = 1*B_0 + 2*B_1 + ... + half*B_half-1
+    bset = sset = 0;
+    for (j = half - 1; j >= 0; j--) {
+      bp.xyz = &bkt[j*6*LEN];
+      if (used[j]) {
+        if (bset) ted_add_ep(&runp, &bp, d);
+        else ted_copy(&runp, &bp);
+        bset = 1;
+      }
+      if (bset) {
+        if (sset) ted_add_ep(&sump, &runp, d);
+        else ted_copy(&sump, &runp);
+        sset = 1;
+      }
+    }
+    if (sset) {
+      if (rset) ted_add_ep(r, &sump, d);
+      else ted_copy(r, &sump);
+      rset = 1;
+    }
+  }
+}
+
+
+// Pre-computation of the odd multiples $P, 3P, \ldots, (2^{W-1}-1)P$
+// ------------------------------------------------------------------
+// The point $P$ is given in extended projective coordinates (`p->dim` must be
+// at least 5), and the `TED_WINSIZE` multiples are written to `tbl` in the
+// same coordinates (i.e., $5 \cdot$ LEN words each). One doubling and
+// `TED_WINSIZE-1` extended projective additions are executed, independent of
+// the point $P$.
+
+static void ted_odd_table(Word *tbl, const Point *p, const ECDomPar *d)
+{
+  Word dbl[6*LEN], sum[6*LEN];
+  Point dblp = { 6, dbl }, sump = { 6, sum }, tp = { 5, tbl };
+  int i;
+
+  ted_copy(&tp, p);
+  ted_copy(&dblp, p);
+  ted_double(&dblp);
+  for (i = 1; i < TED_WINSIZE; i++) {
+    ted_copy(&sump, &tp);
+    ted_add_ep(&sump, &dblp, d);
+    tp.xyz = &tbl[i*5*LEN];
+    ted_copy(&tp, &sump);
+  }
+}
+
+
+// Loading of an odd multiple from the table: $R = \pm \mathrm{Tbl}[i]$
+// ---------------------------------------------------------------------
+// Like `ted_load_point`, this function reads all `TED_WINSIZE` points of the
+// table and selects the requested one via AND-masks (with `mpi_select`), so
+// that neither the memory-access pattern nor the execution time depend on
+// `idx` or `neg`. The point is negated (i.e., $-[X:Y:Z:E:H] = [-X:Y:Z:-E:H]$)
+// when `neg` is 1. Note that `r->dim` must be (at least) 5.
+
+static void ted_load_odd(Point *r, const Word *tbl, int idx, int neg)
+{
+  Word *x = r->xyz, *e = &r->xyz[3*LEN];
+
+  mpi_select(r->xyz, tbl, idx, TED_WINSIZE, 5*LEN);
+  gfp_cneg(x, x, neg);
+  gfp_cneg(e, e, neg);
+}
+
+
+// Variable-base scalar multiplication with signed fixed windows: $R = k P$
+// -------------------------------------------------------------------------
+// An odd scalar $k$ can be written as $k = \sum_i d_i 2^{(W-1)i}$ with odd
+// digits $d_i \in [-(2^{W-1}-1), 2^{W-1}-1]$ (where $W$ is the window-width
+// `M25519_TED_WINDOW`), and digit $d_i$ is obtained from $W$ bits of $k$ at
+// position $(W-1)i$ with the least-significant bit set to 1 (i.e., no carries
+// have to be propagated).
+// Since all digits are non-zero, every window costs exactly $W-1$ doublings
+// and one addition of a point loaded with `ted_load_odd`. An even scalar is
+// made odd by setting bit 0 and the result is corrected by adding either $-P$
+// or $O$, which are selected via masks. Thus, the sequence of operations and
+// the memory accesses do not depend on $k$. The point $P$ has to be given in
+// extended projective coordinates, and the result $R$ is in extended
+// projective coordinates, i.e., `r->dim` must be 6.
+
+static void ted_mul_fixwin(Point *r, const Word *k, const Point *p, \
+  const ECDomPar *d)
+{
+  Word tbl[TED_WINSIZE*5*LEN], kodd[LEN], tmp[5*LEN], zero[5*LEN];
+  Point tp = { 5, tmp }, zp = { 5, zero };
+  Word mask;
+  int i, j, bits, neg, even = (int) (1 - (k[0] & 1));
+  const int low = (1 << (M25519_TED_WINDOW - 1)) - 1;
+
+  ted_odd_table(tbl, p, d);
+  mpi_copy(kodd, k, LEN);
+  kodd[0] |= 1;
+
+  // the most-significant digit is always positive
+  bits = ted_getbits(kodd, (NUMFIXWIN - 1)*(M25519_TED_WINDOW - 1), \
+    M25519_TED_WINDOW) | 1;
+  ted_load_odd(&tp, tbl, bits >> 1, 0);
+  ted_copy(r, &tp);
+  for (i = NUMFIXWIN - 2; i >= 0; i--) {
+    for (j = 0; j < M25519_TED_WINDOW - 1; j++) ted_double(r);
+    bits = ted_getbits(kodd, i*(M25519_TED_WINDOW - 1), M25519_TED_WINDOW) | 1;
+    neg = 1 - (bits >> (M25519_TED_WINDOW - 1));
+    ted_load_odd(&tp, tbl, ((bits ^ (0 - neg)) & low) >> 1, neg);
+    ted_add_ep(r, &tp, d);
+  }
+
+  // R = R - P if k is even and R = R + O otherwise
+  ted_load_odd(&tp, tbl, 0, 1);
+  ted_set0(&zp);
+  mask = 0 - ((Word) even);
+  for (j = 0; j < 5*LEN; j++) tmp[j] = (tmp[j] & mask) | (zero[j] & ~mask);
+  ted_add_ep(r, &tp, d);
+}
+
+
+// Check whether an affine point $P$ has low order, i.e., $8P = O$
+// ---------------------------------------------------------------
+// $8P$ has $X = 0$ if and only if it is $O$ since the group of Edwards25519
+// has no point of order 16.
+
+static int ted_low_order(const Point *p)
+{
+  Word tmp[6*LEN], zero[LEN];
+  Point tp = { 6, tmp };
+
+  ted_copy(&tp, p);
+  ted_double(&tp);
+  ted_double(&tp);
+  ted_double(&tp);
+  mpi_setw(zero, 0, LEN);
+
+  return (gfp_cmp(tmp, zero) == 0);
+}
+
+
+// Variable-base scalar multiplication: $R = k P$
+// ----------------------------------------------
+// The scalar $k$ (eight words) must not be 0 and the affine point $P$ must
+// not have low order. The product is computed with `ted_mul_fixwin`, which
+// has an operand-independent execution profile, and converted to affine
+// coordinates. The return value is `M25519_ERR_SCALAR` if $k = 0$,
+// `M25519_ERR_TPOINT` if $P$ has low order or $R = O$, and `M25519_NO_ERROR`
+// otherwise.
+
+int ted_mul_varbase(Point *r, const Word *k, const Point *p, \
+  const ECDomPar *d)
+{
+  Word tmp[6*LEN], pep[5*LEN];
+  Point tp = { 6, tmp }, pp = { 5, pep };
+  int err;
+
+  if (mpi_cmpw(k, 0, LEN) == 0) return M25519_ERR_SCALAR;
+  if (ted_low_order(p)) return M25519_ERR_TPOINT;
+  ted_copy(&pp, p);
+  ted_mul_fixwin(&tp, k, &pp, d);
+  err = ted_conv_p2a(r, &tp, d);
+  if ((mpi_cmpw(r->xyz, 0, LEN) == 0) && (mpi_cmpw(&r->xyz[LEN], 1, LEN) == 0))
+    err = M25519_ERR_TPOINT;
+
+  return err;
+}
+
+
+// Variable-base scalar multiplication with projective result: $R = k P$
+// ---------------------------------------------------------------------
+// This function computes the same point as `ted_mul_varbase`, but $R$ is left
+// in extended projective coordinates $[X:Y:Z:E:H]$ (i.e., `r->dim` must be
+// 6). The return value is the same as that of `ted_mul_varbase`; when $k = 0$
+// or $P$ has low order, $R$ is not written.
+
+int ted_mul_varbase_proj(Point *r, const Word *k, const Point *p, \
+  const ECDomPar *d)
+{
+  Word pep[5*LEN];
+  Point pp = { 5, pep };
+
+  if (mpi_cmpw(k, 0, LEN) == 0) return M25519_ERR_SCALAR;
+  if (ted_low_order(p)) return M25519_ERR_TPOINT;
+  ted_copy(&pp, p);
+  ted_mul_fixwin(r, k, &pp, d);
+
+  return ted_is_neutral(r) ? M25519_ERR_TPOINT : M25519_NO_ERROR;
+}
+
+
+// Recoding of a 256-bit scalar into its width-$W$ NAF
+// ---------------------------------------------------
+// Every non-zero digit of the wNAF is odd and in the range $[-(2^{W-1}-1),
+// 2^{W-1}-1]$, and it is followed by at least $W-1$ zero digits. The digits
+// are computed from $W$ bits of $k$ and a carry, i.e., $k$ is not modified.
+// The array `naf` must be able to accommodate `NAFLEN` digits. The return
+// value is the number of digits up to and including the most-significant
+// non-zero digit (0 if $k = 0$).
+// NOTE: The execution time of this function depends on $k$.
+
+static int ted_wnaf(signed char *naf, const Word *k)
+{
+  int i, pos = 0, carry = 0, dig, len = 0;
+
+  for (i = 0; i < NAFLEN; i++) naf[i] = 0;
+  while ((pos < WSIZE*LEN) || (carry && (pos < NAFLEN))) {
+    if (ted_getbits(k, pos, 1) == carry) {  // digit 0
+      pos++;
+      continue;
+    }
+    dig = ted_getbits(k, pos, M25519_TED_WINDOW) + carry;
+    carry = (dig >> (M25519_TED_WINDOW - 1)) & 1;
+    dig -= carry << M25519_TED_WINDOW;
+    naf[pos] = (signed char) dig;
+    len = pos + 1;
+    pos += M25519_TED_WINDOW;
+  }
+
+  return len;
+}
+
+
+// Digit `i` of the (interleaved) wNAF method: $R = 2R + \sum_j k_{j,i} P_j$
+// ------------------------------------------------------------------------
+// This function doubles $R$ (unless `rset` is 0, i.e., $R$ is still $O$) and
+// adds the odd multiples of $P_j$ selected (and possibly negated) by the
+// non-zero digits at position `i` of the `n` wNAFs in `naf`, which are taken
+// from the $j$-th sub-table of `tbl` computed with `ted_odd_table`. The
+// return value is the updated `rset`. `r->dim` must be 6.
+// NOTE: The execution time of this function depends on the wNAFs.
+
+static int ted_wnaf_digit(Point *r, signed char (*naf)[NAFLEN], \
+  const Word *tbl, int n, int i, int rset, const ECDomPar *d)
+{
+  Word neg[5*LEN];
+  Point ep = { 5, NULL };
+  const Word *ent;
+  int j, dig;
+
+  if (rset) ted_double(r);
+  for (j = 0; j < n; j++) {
+    dig = naf[j][i];
+    if (dig == 0) continue;
+    ent = &tbl[(j*TED_WINSIZE+((dig < 0) ? -dig : dig)/2)*5*LEN];
+    if (dig < 0) {  // -P = [-X:Y:Z:-E:H]
+      mpi_copy(neg, ent, 5*LEN);
+      gfp_cneg(neg, neg, 1);
+      gfp_cneg(&neg[3*LEN], &neg[3*LEN], 1);
+      ent = neg;
+    }
+    ep.xyz = (Word *) ent;
+    if (rset) ted_add_ep(r, &ep, d);
+    else ted_copy(r, &ep);
+    rset = 1;
+  }
+
+  return rset;
+}
+
+
+// Main loop of the (interleaved) wNAF method: $R = \sum_j k_j P_j$
+// ----------------------------------------------------------------
+// The `n` wNAFs in `naf` (with up to `len` digits) are processed with a single
+// sequence of doublings by `ted_wnaf_digit`, starting with $R = O$. `r->dim`
+// must be 6.
+// NOTE: The execution time of this function depends on the wNAFs.
+
+static void ted_wnaf_loop(Point *r, signed char (*naf)[NAFLEN], \
+  const Word *tbl, int n, int len, const ECDomPar *d)
+{
+  int i, rset = 0;
+
+  ted_set0(r);
+  for (i = len - 1; i >= 0; i--) {
+    rset = ted_wnaf_digit(r, naf, tbl, n, i, rset, d);
+  }
+}
+
+
+#if defined(M25519_DUAL_CORE)
+
+// Job for the second core that computes $R = k P$ with a single wNAF, where
+// $P$ is given in extended affine coordinates
+static void ted_wnaf_job(void *arg)
+{
+  TedJobArg *a = (TedJobArg *) arg;
+  Word tbl[TED_WINSIZE*5*LEN], tmp[6*LEN];
+  signed char naf[1][NAFLEN];
+  Point tp = { 6, tmp };
+  int len;
+
+  ted_conv_ea2ep(&tp, a->p);
+  ted_odd_table(tbl, &tp, a->d);
+  len = ted_wnaf(naf[0], a->s);
+  ted_wnaf_loop(a->r, naf, tbl, 1, len, a->d);
+}
+
+#endif
+
+
+// Double-base scalar multiplication with interleaved wNAFs: $R = l G + k P$
+// --------------------------------------------------------------------------
+// Both scalars (eight words each) are recoded into their width-$W$ NAF and
+// processed with a single sequence of doublings (method of Straus-Shamir),
+// whereby the non-zero digits select (and possibly negate) the odd multiples
+// of $G$ and $P$, which are computed at run time with `ted_odd_table`. On
+// average, one in $W+1$ digits is non-zero, i.e., $256 \cdot 2/(W+1)$
+// extended projective additions are executed instead of $256/c \cdot (2 +
+// 2^c)$ of the bucket method in `ted_mul_multi`. The point $P$ must be given
+// in extended affine $(u,v,w)$ coordinates, and the result $R$ is in extended
+// projective coordinates, i.e., `r->dim` must be 6. The parameter `d` is
+// needed to access the curve parameter $d$. When a hook for the second core
+// is registered (see `M25519_DUAL_CORE`), $k P$ is computed with a single wNAF
+// on the second core and $l G$ with the comb method on the calling core, and
+// the two products are added at the end.
+// NOTE: The execution time of this function depends on the scalars, i.e., it
+// must only be used when both scalars are public (e.g., for the verification
+// of signatures).
+
+void ted_mul_dblbase_wnaf(Point *r, const Word *l, const Word *k, \
+  const Point *p, const ECDomPar *d)
+{
+  Word tbl[2*TED_WINSIZE*5*LEN], tmp[6*LEN];
+  signed char naf[2][NAFLEN];
+  Point tp = { 6, tmp }, gp = { 3, (Word *) TEDGENEA };
+  int i, len;
+#if defined(M25519_DUAL_CORE)
+  Word m[LEN+1];
+  TedJobArg arg;
+
+  if (ted_core1_run != NULL) {
+    arg.r = &tp;
+    arg.s = k;
+    arg.p = p;
+    arg.tbl = NULL;
+    arg.b0 = arg.b1 = 0;
+    arg.d = d;
+    ted_core1_run(ted_wnaf_job, &arg);
+    ted_comb_recode(m, l, d);
+    ted_comb_part(r, m, d->tbl, 0, M25519_COMB_TABLES);
+    ted_core1_wait();
+    ted_add_ep(r, &tp, d);
+    return;
+  }
+#endif
+
+  ted_conv_ea2ep(&tp, &gp);
+  ted_odd_table(tbl, &tp, d);
+  ted_conv_ea2ep(&tp, p);
+  ted_odd_table(&tbl[TED_WINSIZE*5*LEN], &tp, d);
+  len = ted_wnaf(naf[0], l);
+  i = ted_wnaf(naf[1], k);
+  if (i > len) len = i;
+  ted_wnaf_loop(r, naf, tbl, 2, len, d);
+}
+
+
+// Double-scalar multiplication: $R = l G - k P$
+// ---------------------------------------------
+// The scalars $l$ and $k$ (eight words each) must not be 0 and the affine
+// point $P$ must not have low order. The point $-P$ is converted to extended
+// affine coordinates, the sum $l G + k(-P)$ is computed with
+// `ted_mul_dblbase_wnaf` and converted to affine coordinates. The return value
+// is `M25519_ERR_SCALAR` if $l = 0$ or $k = 0$, `M25519_ERR_TPOINT` if $P$
+// has low order or $R = O$, and `M25519_NO_ERROR` otherwise.
+// NOTE: The execution time of this function is not constant, i.e., it must
+// only be used when both scalars are public.
+
+int ted_mul_dblbase(Point *r, const Word *l, const Word *k, const Point *p, \
+  const ECDomPar *d)
+{
+  Word tmp[6*LEN], pea[3*LEN], neg[2*LEN];
+  Point tp = { 6, tmp }, pp = { 3, pea }, np = { 2, neg };
+  int err;
+
+  if ((mpi_cmpw(l, 0, LEN) == 0) || (mpi_cmpw(k, 0, LEN) == 0))
+    return M25519_ERR_SCALAR;
+  if (ted_low_order(p)) return M25519_ERR_TPOINT;
+  gfp_cneg(neg, p->xyz, 1);  // -P = (-x,y)
+  mpi_copy(&neg[LEN], &p->xyz[LEN], LEN);
+  ted_conv_a2ea(&pp, &np, d);
+  ted_mul_dblbase_wnaf(&tp, l, k, &pp, d);
+  err = ted_conv_p2a(r, &tp, d);
+  if ((mpi_cmpw(r->xyz, 0, LEN) == 0) && (mpi_cmpw(&r->xyz[LEN], 1, LEN) == 0))
+    err = M25519_ERR_TPOINT;
+
+  return err;
+}
+
+
+// Resumable double-scalar multiplication: $R = l G - k P$
+// -------------------------------------------------------
+// These three functions compute the same result as `ted_mul_dblbase`, but
+// the interleaved wNAF method is split into steps of one digit (i.e., one
+// doubling and up to two extended projective additions) so that a caller can
+// interleave the scalar multiplication with other tasks. The init function
+// checks the inputs, computes the tables of odd multiples of $G$ and $-P$
+// (i.e., $2^{W-1}$ point operations), and recodes both scalars. Every
+// step function processes up to `n` digits and returns the number of digits
+// that are still to be processed (0 when the main loop is complete), and the
+// final function converts the result to affine coordinates and checks it.
+// The return value of the init and the final function is the same as that of
+// `ted_mul_dblbase`, except that the final function returns
+// `M25519_ERR_STREAM` when the main loop is not complete yet. The final
+// function invalidates the context (also when the main loop is not complete),
+// i.e., further calls of the step function return 0 and a further call of the
+// final function returns `M25519_ERR_STREAM` until the context is initialized
+// again. The dual-core split of `ted_mul_dblbase_wnaf` is not used by these
+// functions.
+// NOTE: The execution time of the steps depends on the scalars, i.e., these
+// functions must only be used when both scalars are public.
+
+int ted_mul_dblbase_init(TedDblCtx *ctx, const Word *l, const Word *k, \
+  const Point *p, const ECDomPar *d)
+{
+  Word tmp[6*LEN], pea[3*LEN], neg[2*LEN];
+  Point tp = { 6, tmp }, pp = { 3, pea }, np = { 2, neg };
+  Point gp = { 3, (Word *) TEDGENEA }, rp = { 6, ctx->xyz };
+  int len, i;
+
+  ctx->pos = -1;
+  ctx->rset = 0;
+  ctx->err = M25519_NO_ERROR;
+  ted_set0(&rp);
+  if ((mpi_cmpw(l, 0, LEN) == 0) || (mpi_cmpw(k, 0, LEN) == 0))
+    ctx->err = M25519_ERR_SCALAR;
+  else if (ted_low_order(p)) ctx->err = M25519_ERR_TPOINT;
+  if (ctx->err != M25519_NO_ERROR) return ctx->err;
+
+  gfp_cneg(neg, p->xyz, 1);  // -P = (-x,y)
+  mpi_copy(&neg[LEN], &p->xyz[LEN], LEN);
+  ted_conv_a2ea(&pp, &np, d);
+  ted_conv_ea2ep(&tp, &gp);
+  ted_odd_table(ctx->tbl, &tp, d);
+  ted_conv_ea2ep(&tp, &pp);
+  ted_odd_table(&ctx->tbl[TED_WINSIZE*5*LEN], &tp, d);
+  len = ted_wnaf(ctx->naf[0], l);
+  i = ted_wnaf(ctx->naf[1], k);
+  ctx->pos = ((i > len) ? i : len) - 1;
+
+  return ctx->err;
+}
+
+
+int ted_mul_dblbase_step(TedDblCtx *ctx, int n, const ECDomPar *d)
+{
+  Point rp = { 6, ctx->xyz };
+
+  for (; (n > 0) && (ctx->pos >= 0); n--, ctx->pos--) {
+    ctx->rset = ted_wnaf_digit(&rp, ctx->naf, ctx->tbl, 2, ctx->pos, \
+      ctx->rset, d);
+  }
+
+  return ctx->pos + 1;
+}
+
+
+int ted_mul_dblbase_final(Point *r, TedDblCtx *ctx, const ECDomPar *d)
+{
+  Point tp = { 6, ctx->xyz };
+  int err = ctx->err;
+
+  if ((err == M25519_NO_ERROR) && (ctx->pos >= 0)) err = M25519_ERR_STREAM;
+  if (err == M25519_NO_ERROR) {
+    err = ted_conv_p2a(r, &tp, d);
+    if ((mpi_cmpw(r->xyz, 0, LEN) == 0) && \
+        (mpi_cmpw(&r->xyz[LEN], 1, LEN) == 0)) err = M25519_ERR_TPOINT;
+  }
+  ctx->pos = -1;
+  ctx->rset = 0;
+  ctx->err = M25519_ERR_STREAM;
+
+  return err;
+}
+
+#undef COMBBITS
+#undef MAXWIN
+#undef MAXNUMWIN
+#undef CBITWORDS
+#undef NAFLEN
+#undef NUMFIXWIN
+#undef CONSTA24
+
+///////////////////////////////////////////////////////////////////////////////
+// src/x25519.c                                                              //
+///////////////////////////////////////////////////////////////////////////////
+
+#define CONSTA24 x25519_CONSTA24
+
+
+// The functions in this file implement X25519 key exchange as specified in RFC
+// 7748, i.e., the shared secret is the $x$-coordinate of the point $k \cdot P$
+// on Curve25519 computed with the Montgomery ladder. `x25519_batch` computes
+// a batch of shared secrets, whereby up to `X25519_MAXBATCH` ladders (each
+// for a different private key and public key) are executed in lockstep. When
+// `M25519_SIMD` is defined, groups of four ladders are executed with the four-
+// way parallel step `mon_ladder_step4` (and AVX2 or NEON instructions). The
+// remaining ladders (or all ladders when `M25519_SIMD` is not defined) are
+// interleaved, i.e., the scalar `mon_ladder_step` is executed for each ladder
+// before moving on to the next bit of the scalars. In both cases, the
+// inversions of the final Z-coordinates are performed together by
+// `gfp_inv_batch` with Montgomery's trick. The key-pair pool functions move
+// the generation of ephemeral key-pairs (fixed-base comb method on
+// Edwards25519 and mapping of the result to Curve25519) out of the critical
+// path of a key exchange. This file also contains the SHA-512 implementation
+// (FIPS 180-4) used by X25519 and Ed25519.
+
+
+#include <stddef.h>
+#include <string.h>
+
+
+// Constant $a_{24} = (A+2)/4$ of Curve25519
+static const Word CONSTA24[1] = { 121666 };
+
+// Number of vectors of four lanes needed for `X25519_MAXBATCH` ladders
+#define NUMVEC ((X25519_MAXBATCH + NUMLANES - 1)/NUMLANES)
+
+
+// Initial hash value and round constants of SHA-512 (FIPS 180-4)
+
+static const uint64_t SHA512IV[8] = {
+  0x6A09E667F3BCC908ULL, 0xBB67AE8584CAA73BULL, 0x3C6EF372FE94F82BULL,
+  0xA54FF53A5F1D36F1ULL, 0x510E527FADE682D1ULL, 0x9B05688C2B3E6C1FULL,
+  0x1F83D9ABFB41BD6BULL, 0x5BE0CD19137E2179ULL
+};
+
+static const uint64_t SHA512RC[80] = {
+  0x428A2F98D728AE22ULL, 0x7137449123EF65CDULL, 0xB5C0FBCFEC4D3B2FULL,
+  0xE9B5DBA58189DBBCULL, 0x3956C25BF348B538ULL, 0x59F111F1B605D019ULL,
+  0x923F82A4AF194F9BULL, 0xAB1C5ED5DA6D8118ULL, 0xD807AA98A3030242ULL,
+  0x12835B0145706FBEULL, 0x243185BE4EE4B28CULL, 0x550C7DC3D5FFB4E2ULL,
+  0x72BE5D74F27B896FULL, 0x80DEB1FE3B1696B1ULL, 0x9BDC06A725C71235ULL,
+  0xC19BF174CF692694ULL, 0xE49B69C19EF14AD2ULL, 0xEFBE4786384F25E3ULL,
+  0x0FC19DC68B8CD5B5ULL, 0x240CA1CC77AC9C65ULL, 0x2DE92C6F592B0275ULL,
+  0x4A7484AA6EA6E483ULL, 0x5CB0A9DCBD41FBD4ULL, 0x76F988DA831153B5ULL,
+  0x983E5152EE66DFABULL, 0xA831C66D2DB43210ULL, 0xB00327C898FB213FULL,
+  0xBF597FC7BEEF0EE4ULL, 0xC6E00BF33DA88FC2ULL, 0xD5A79147930AA725ULL,
+  0x06CA6351E003826FULL, 0x142929670A0E6E70ULL, 0x27B70A8546D22FFCULL,
+  0x2E1B21385C26C926ULL, 0x4D2C6DFC5AC42AEDULL, 0x53380D139D95B3DFULL,
+  0x650A73548BAF63DEULL, 0x766A0ABB3C77B2A8ULL, 0x81C2C92E47EDAEE6ULL,
+  0x92722C851482353BULL, 0xA2BFE8A14CF10364ULL, 0xA81A664BBC423001ULL,
+  0xC24B8B70D0F89791ULL, 0xC76C51A30654BE30ULL, 0xD192E819D6EF5218ULL,
+  0xD69906245565A910ULL, 0xF40E35855771202AULL, 0x106AA07032BBD1B8ULL,
+  0x19A4C116B8D2D0C8ULL, 0x1E376C085141AB53ULL, 0x2748774CDF8EEB99ULL,
+  0x34B0BCB5E19B48A8ULL, 0x391C0CB3C5C95A63ULL, 0x4ED8AA4AE3418ACBULL,
+  0x5B9CCA4F7763E373ULL, 0x682E6FF3D6B2B8A3ULL, 0x748F82EE5DEFB2FCULL,
+  0x78A5636F43172F60ULL, 0x84C87814A1F0AB72ULL, 0x8CC702081A6439ECULL,
+  0x90BEFFFA23631E28ULL, 0xA4506CEBDE82BDE9ULL, 0xBEF9A3F7B2C67915ULL,
+  0xC67178F2E372532BULL, 0xCA273ECEEA26619CULL, 0xD186B8C721C0C207ULL,
+  0xEADA7DD6CDE0EB1EULL, 0xF57D4F7FEE6ED178ULL, 0x06F067AA72176FBAULL,
+  0x0A637DC5A2C898A6ULL, 0x113F9804BEF90DAEULL, 0x1B710B35131C471BULL,
+  0x28DB77F523047D84ULL, 0x32CAAB7B40C72493ULL, 0x3C9EBE0A15C9BEBCULL,
+  0x431D67C49C100D4CULL, 0x4CC5D4BECB3E42B6ULL, 0x597F299CFC657E2AULL,
+  0x5FCB6FAB3AD6FAECULL, 0x6C44198C4A475817ULL
+};
+
+// Rotation of a 64-bit word by `n` bits to the right
+#define ROTR64(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+
+// Memory barrier that orders the accesses to a slot of a key-pair pool with
+// respect to the update of the read or write index. `__sync_synchronize` is a
+// compiler barrier and also emits a fence instruction where needed (e.g.,
+// `dmb` on ARM or `fence` on RISC-V). Compilers other than GCC and Clang have
+// to define `M25519_POOL_BARRIER` (e.g., as `__DMB()` with CMSIS) when the
+// pool is shared between different execution contexts.
+#if !defined(M25519_POOL_BARRIER)
+#if defined(__GNUC__)
+#define M25519_POOL_BARRIER() __sync_synchronize()
+#else
+#define M25519_POOL_BARRIER()
+#endif
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+////////////////////////////// SHA-512 HASH FUNCTION //////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Compression of a 128-byte block of the message
+// ----------------------------------------------
+// The message block is contained in `mbuf` as 16 big-Endian 64-bit words. The
+// message schedule is computed on the fly in a circular buffer of 16 words,
+// which keeps the RAM footprint small (i.e., `mbuf` is overwritten).
+
+static void sha512_compress(SHA512Ctx *ctx)
+{
+  uint64_t a, b, c, d, e, f, g, h, t1, t2, s0, s1;
+  uint64_t *w = ctx->mbuf;
+  int i;
+
+  a = ctx->hdig[0]; b = ctx->hdig[1]; c = ctx->hdig[2]; d = ctx->hdig[3];
+  e = ctx->hdig[4]; f = ctx->hdig[5]; g = ctx->hdig[6]; h = ctx->hdig[7];
+
+  for (i = 0; i < 80; i++) {
+    if (i >= 16) {
+      s0 = w[(i+1)&15];
+      s0 = ROTR64(s0, 1) ^ ROTR64(s0, 8) ^ (s0 >> 7);
+      s1 = w[(i+14)&15];
+      s1 = ROTR64(s1, 19) ^ ROTR64(s1, 61) ^ (s1 >> 6);
+      w[i&15] += s0 + s1 + w[(i+9)&15];
+    }
+    t1 = h + (ROTR64(e, 14) ^ ROTR64(e, 18) ^ ROTR64(e, 41));
+    t1 += ((e & f) ^ (~e & g)) + SHA512RC[i] + w[i&15];
+    t2 = (ROTR64(a, 28) ^ ROTR64(a, 34) ^ ROTR64(a, 39));
+    t2 += (a & b) ^ (a & c) ^ (b & c);
+    h = g; g = f; f = e; e = d + t1;
+    d = c; c = b; b = a; a = t1 + t2;
+  }
+
+  ctx->hdig[0] += a; ctx->hdig[1] += b; ctx->hdig[2] += c; ctx->hdig[3] += d;
+  ctx->hdig[4] += e; ctx->hdig[5] += f; ctx->hdig[6] += g; ctx->hdig[7] += h;
+}
+
+
+// Initialization of a SHA-512 context
+// -----------------------------------
+
+void sha512_init(SHA512Ctx *ctx)
+{
+  int i;
+
+  for (i = 0; i < 8; i++) ctx->hdig[i] = SHA512IV[i];
+  for (i = 0; i < 16; i++) ctx->mbuf[i] = 0;
+  ctx->length = 0;
+  ctx->mbytes = 0;
+}
+
+
+// Update of a SHA-512 context with data
+// -------------------------------------
+// The bytes are shifted into the 64-bit words of `mbuf` one after the other,
+// which makes the implementation independent of the endianness of the target.
+// A block is compressed as soon as `mbuf` contains 128 bytes.
+
+void sha512_update(SHA512Ctx *ctx, const Byte *data, size_t dlen)
+{
+  size_t i;
+  int j;
+
+  for (i = 0; i < dlen; i++) {
+    j = ctx->mbytes >> 3;
+    ctx->mbuf[j] = (ctx->mbuf[j] << 8) | data[i];
+    if (++ctx->mbytes == 128) {
+      sha512_compress(ctx);
+      ctx->mbytes = 0;
+    }
+  }
+  ctx->length += 8*dlen;
+}
+
+
+// Finalization of a SHA-512 context to obtain the digest
+// ------------------------------------------------------
+// The padding consists of a 1-bit, followed by 0-bits up to a length of 112
+// (mod 128) bytes and the 128-bit length of the message (in bits). At the end,
+// the context is re-initialized, which also wipes the message buffer.
+
+void sha512_final(SHA512Ctx *ctx, Byte *digest)
+{
+  size_t length = ctx->length;
+  Byte pad = 0x80;
+  int i;
+
+  do {
+    sha512_update(ctx, &pad, 1);
+    pad = 0;
+  } while (ctx->mbytes != 112);
+  ctx->mbuf[14] = 0;  // upper 64 bits of the length
+  ctx->mbuf[15] = (uint64_t) length;
+  sha512_compress(ctx);
+
+  for (i = 0; i < 64; i++) digest[i] = (Byte) (ctx->hdig[i/8] >> (56-8*(i%8)));
+  sha512_init(ctx);
+}
+
+
+// Computation of the SHA-512 digest of data
+// -----------------------------------------
+
+void sha512_hash(Byte *digest, const Byte *data, size_t dlen)
+{
+  SHA512Ctx ctx;
+
+  sha512_init(&ctx);
+  sha512_update(&ctx, data, dlen);
+  sha512_final(&ctx, digest);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+/////////////////////////// X25519 KEY EXCHANGE ///////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Conversion of 32 bytes (in little-Endian order) to an 8-word array and vice
+// versa. When `M25519_LEBYTES` is defined (see `config.h`), the byte order of
+// the target is the same as that of the arrays and the conversion is a copy.
+// Otherwise, the conversions are independent of the endianness of the target.
+
+#if defined(M25519_LEBYTES)
+
+static void x25519_from_bytes(Word *r, const Byte *a)
+{
+  memcpy(r, a, 4*LEN);
+}
+
+static void x25519_to_bytes(Byte *r, const Word *a)
+{
+  memcpy(r, a, 4*LEN);
+}
+
+#else
+
+static void x25519_from_bytes(Word *r, const Byte *a)
+{
+  int i;
+
+  for (i = 0; i < LEN; i++) {
+    r[i] = ((Word) a[4*i]) | (((Word) a[4*i+1]) << 8) | \
+           (((Word) a[4*i+2]) << 16) | (((Word) a[4*i+3]) << 24);
+  }
+}
+
+static void x25519_to_bytes(Byte *r, const Word *a)
+{
+  int i;
+
+  for (i = 0; i < 4*LEN; i++) r[i] = (Byte) (a[i/4] >> (8*(i % 4)));
+}
+
+#endif
+
+
+// Batch of (up to `X25519_MAXBATCH`) Montgomery ladders: $R_j = k_j \cdot P_j$
+// ----------------------------------------------------------------------------
+// The arrays `k` and `xd` contain the `m` (pruned) scalars and $x$-coordinates
+// of the base points, respectively. After the ladder, the projective $X$ and
+// $Z$-coordinates of $R_j$ are stored in the arrays `xr` and `zr`. All ladders
+// execute the same sequence of operations for each of the 255 scalar bits, and
+// their coordinates are wiped at the end.
+
+static void x25519_ladders(Word *xr, Word *zr, const Word *k, const Word *xd, \
+  int m)
+{
+  Word xz[X25519_MAXBATCH*4*LEN];
+  int i, j, bit, prev[X25519_MAXBATCH];
+
+  for (j = 0; j < m; j++) {
+    mpi_setw(&xz[j*4*LEN], 1, LEN);              // X_R = 1
+    mpi_copy(&xz[j*4*LEN+LEN], &xd[j*LEN], LEN);  // X_S = x_D
+    mpi_setw(&xz[j*4*LEN+2*LEN], 0, LEN);        // Z_R = 0
+    mpi_setw(&xz[j*4*LEN+3*LEN], 1, LEN);        // Z_S = 1
+    prev[j] = 0;
+  }
+
+  for (i = CONSTK - 1; i >= 0; i--) {
+    for (j = 0; j < m; j++) {
+      bit = (k[j*LEN+i/WSIZE] >> (i % WSIZE)) & 1;
+      mon_ladder_step(&xz[j*4*LEN], &xd[j*LEN], CONSTA24, bit ^ prev[j]);
+      prev[j] = bit;
+    }
+  }
+
+  for (j = 0; j < m; j++) {
+    gfp_cswap(&xz[j*4*LEN], &xz[j*4*LEN+LEN], prev[j]);
+    gfp_cswap(&xz[j*4*LEN+2*LEN], &xz[j*4*LEN+3*LEN], prev[j]);
+    mpi_copy(&xr[j*LEN], &xz[j*4*LEN], LEN);
+    mpi_copy(&zr[j*LEN], &xz[j*4*LEN+2*LEN], LEN);
+  }
+  mpi_setw(xz, 0, X25519_MAXBATCH*4*LEN);
+}
+
+
+#if defined(M25519_SIMD)
+
+// Same as `x25519_ladders`, but the ladders are executed in groups of four
+// with `mon_ladder_step4`, i.e., `m` must be a multiple of four. Bit j of the
+// `swap` operand of `mon_ladder_step4` is the swap-bit of the ladder in lane j.
+
+static void x25519_ladders4(Word *xr, Word *zr, const Word *k, \
+  const Word *xd, int m)
+{
+  Word xz[NUMVEC*4*LEN4], xdv[NUMVEC*LEN4], one[NUMLANES*LEN];
+  int i, j, v, bits, prev[NUMVEC];
+  int nvec = m/NUMLANES;
+
+  for (j = 0; j < NUMLANES*LEN; j++) one[j] = ((j % LEN) == 0);
+  for (v = 0; v < nvec; v++) {
+    gfp4_pack(&xdv[v*LEN4], &xd[v*NUMLANES*LEN]);
+    gfp4_pack(&xz[v*4*LEN4], one);                     // X_R = 1
+    mpi_copy(&xz[v*4*LEN4+LEN4], &xdv[v*LEN4], LEN4);  // X_S = x_D
+    mpi_setw(&xz[v*4*LEN4+2*LEN4], 0, LEN4);           // Z_R = 0
+    gfp4_pack(&xz[v*4*LEN4+3*LEN4], one);              // Z_S = 1
+    prev[v] = 0;
+  }
+
+  for (i = CONSTK - 1; i >= 0; i--) {
+    for (v = 0; v < nvec; v++) {
+      bits = 0;
+      for (j = 0; j < NUMLANES; j++) {
+        bits |= ((k[(NUMLANES*v+j)*LEN+i/WSIZE] >> (i % WSIZE)) & 1) << j;
+      }
+      mon_ladder_step4(&xz[v*4*LEN4], &xdv[v*LEN4], CONSTA24, bits ^ prev[v]);
+      prev[v] = bits;
+    }
+  }
+
+  for (v = 0; v < nvec; v++) {
+    gfp4_cswap(&xz[v*4*LEN4], &xz[v*4*LEN4+LEN4], prev[v]);
+    gfp4_cswap(&xz[v*4*LEN4+2*LEN4], &xz[v*4*LEN4+3*LEN4], prev[v]);
+    gfp4_unpack(&xr[v*NUMLANES*LEN], &xz[v*4*LEN4]);
+    gfp4_unpack(&zr[v*NUMLANES*LEN], &xz[v*4*LEN4+2*LEN4]);
+  }
+  mpi_setw(xz, 0, NUMVEC*4*LEN4);
+}
+
+#endif
+
+
+// Computation of a batch of X25519 shared secrets
+// -----------------------------------------------
+// The `n` private keys and public keys are processed in groups of (at most)
+// `X25519_MAXBATCH`. For each group, the private keys are pruned and the MSB
+// of the public keys is masked (as described in RFC 7748), then the ladders
+// are executed in lockstep and the Z-coordinates of all results are inverted
+// with a single `gfp_inv_batch` call. A shared secret of 0 indicates that the
+// public key is a point of low order, in which case err[j] is set to
+// `M25519_ERR_MPOINT` (the check is performed without branches). The shared
+// inversion has constant execution time (see `gfp_inv_batch`), and all arrays
+// containing secret data (including the Montgomery ladders) are wiped.
+
+int x25519_batch(Byte *shared[], const Byte *sk[], const Byte *pk[], int n, \
+  int *err)
+{
+  Word k[X25519_MAXBATCH*LEN], xd[X25519_MAXBATCH*LEN];
+  Word xr[X25519_MAXBATCH*LEN], zr[X25519_MAXBATCH*LEN];
+  Word scratch[X25519_MAXBATCH*LEN];
+  Word acc;
+  int base, i, j, m, m4, e, rval = M25519_NO_ERROR;
+
+  for (base = 0; base < n; base += X25519_MAXBATCH) {
+    m = ((n - base) < X25519_MAXBATCH) ? (n - base) : X25519_MAXBATCH;
+    for (j = 0; j < m; j++) {
+      x25519_from_bytes(&k[j*LEN], sk[base+j]);
+      k[j*LEN] &= 0xFFFFFFF8UL;         // clear three lowest bits
+      k[j*LEN+LEN-1] &= 0x7FFFFFFFUL;   // clear bit 255
+      k[j*LEN+LEN-1] |= 0x40000000UL;   // set bit 254
+      x25519_from_bytes(&xd[j*LEN], pk[base+j]);
+      xd[j*LEN+LEN-1] &= 0x7FFFFFFFUL;  // mask bit 255
+    }
+
+#if defined(M25519_SIMD)  // full groups of four ladders in SIMD lanes
+    m4 = m - (m % NUMLANES);
+    x25519_ladders4(xr, zr, k, xd, m4);
+#else
+    m4 = 0;
+#endif
+    x25519_ladders(&xr[m4*LEN], &zr[m4*LEN], &k[m4*LEN], &xd[m4*LEN], m - m4);
+    gfp_inv_batch(zr, zr, m, scratch);
+
+    for (j = 0; j < m; j++) {
+      gfp_mul(&xr[j*LEN], &xr[j*LEN], &zr[j*LEN]);
+      gfp_fred(&xr[j*LEN], &xr[j*LEN]);
+      x25519_to_bytes(shared[base+j], &xr[j*LEN]);
+      acc = 0;
+      for (i = 0; i < LEN; i++) acc |= xr[j*LEN+i];
+      // e = M25519_ERR_MPOINT if acc = 0, else e = 0
+      e = (int) (((Word) M25519_ERR_MPOINT) & (((acc | (0 - acc)) >> 31) - 1));
+      if (err != NULL) err[base+j] = e;
+      rval |= e;
+    }
+  }
+
+  mpi_setw(k, 0, X25519_MAXBATCH*LEN);
+  mpi_setw(xr, 0, X25519_MAXBATCH*LEN);
+  mpi_setw(zr, 0, X25519_MAXBATCH*LEN);
+  mpi_setw(scratch, 0, X25519_MAXBATCH*LEN);
+
+  return rval;
+}
+
+
+// Generation of an X25519 key-pair from 32 random bytes
+// -----------------------------------------------------
+// The random bytes are pruned as described in RFC 7748 to get the private key
+// $k$, and $Q = k G$ is computed with the fixed-base comb method on
+// Edwards25519. The $u$-coordinate of the corresponding point on Curve25519 is
+// $u = (1 + y)/(1 - y) = (Z + Y)/(Z - Y)$, which is obtained with a single
+// inversion by passing the projective point $[Z+Y:Y:Z-Y]$ to `ted_conv_p2a`
+// (i.e., the $x$-coordinate computed by `ted_conv_p2a` is $u$). All
+// intermediate values are wiped. The return value is `M25519_ERR_TPOINT` if
+// $Q$ is the neutral element (which happens with negligible probability) and
+// `M25519_NO_ERROR` otherwise.
+
+static int x25519_pool_keygen(Byte *privkey, Byte *pubkey, const Byte *rbytes)
+{
+  Word k[LEN], tmp[6*LEN], uy[2*LEN];
+  Point tp = { 6, tmp }, up = { 2, uy };
+  int err;
+
+  x25519_from_bytes(k, rbytes);
+  k[0] &= 0xFFFFFFF8UL;      // clear three lowest bits
+  k[LEN-1] &= 0x7FFFFFFFUL;  // clear bit 255
+  k[LEN-1] |= 0x40000000UL;  // set bit 254
+  ted_mul_combNb(&tp, k, &ECDOMPAR25519);
+  gfp_add(tmp, &tmp[2*LEN], &tmp[LEN]);          // X = Z + Y
+  gfp_sub(&tmp[2*LEN], &tmp[2*LEN], &tmp[LEN]);  // Z = Z - Y
+  err = ted_conv_p2a(&up, &tp, &ECDOMPAR25519);  // u = X/Z
+  x25519_to_bytes(privkey, k);
+  x25519_to_bytes(pubkey, uy);
+
+  mpi_setw(k, 0, LEN);
+  mpi_setw(tmp, 0, 6*LEN);
+  mpi_setw(uy, 0, 2*LEN);
+
+  return err;
+}
+
+
+// Initialization of a key-pair pool
+// ---------------------------------
+// All slots are wiped and the pool is empty afterwards. This function can also
+// be used to discard all pre-computed key-pairs of a pool.
+
+void x25519_pool_init(X25519Pool *pool)
+{
+  int i, j;
+
+  for (i = 0; i < X25519_POOLSIZE; i++) {
+    for (j = 0; j < 32; j++) {
+      pool->sk[i][j] = 0;
+      pool->pk[i][j] = 0;
+    }
+  }
+  pool->rd = pool->wr = 0;
+}
+
+
+// Number of key-pairs in a pool
+// -----------------------------
+
+int x25519_pool_count(const X25519Pool *pool)
+{
+  return (pool->wr - pool->rd + 2*X25519_POOLSIZE) % (2*X25519_POOLSIZE);
+}
+
+
+// Addition of a key-pair to a pool
+// --------------------------------
+// One key-pair is generated from the 32 random bytes in `rbytes` and stored in
+// the next free slot, so that the execution time of a call is roughly that of
+// one fixed-base scalar multiplication. When the pool is full, the random
+// bytes are not used and the pool remains unchanged. The write index is only
+// updated after the key-pair has been completely stored, which is enforced by
+// a memory barrier between the stores to the slot and the store to `wr`. The
+// return value is `M25519_ERR_TPOINT` if the public key is invalid (in which
+// case the slot is wiped again) and `M25519_NO_ERROR` otherwise.
+// NOTE: `x25519_pool_refill` and `x25519_pool_take` may be called from
+// different execution contexts (e.g., an idle loop and an interrupt handler,
+// or two cores) without locking, provided that only one context refills the
+// pool and only one context takes key-pairs from it (single producer, single
+// consumer), and that `M25519_POOL_BARRIER` is a memory barrier.
+
+int x25519_pool_refill(X25519Pool *pool, const Byte *rbytes)
+{
+  int slot, err, j;
+
+  if (x25519_pool_count(pool) == X25519_POOLSIZE) return M25519_NO_ERROR;
+
+  M25519_POOL_BARRIER();  // slot is free before it is overwritten
+  slot = pool->wr % X25519_POOLSIZE;
+  err = x25519_pool_keygen(pool->sk[slot], pool->pk[slot], rbytes);
+  if (err != M25519_NO_ERROR) {
+    for (j = 0; j < 32; j++) {
+      pool->sk[slot][j] = 0;
+      pool->pk[slot][j] = 0;
+    }
+    return err;
+  }
+  M25519_POOL_BARRIER();  // key-pair is stored before it is published
+  pool->wr = (pool->wr + 1) % (2*X25519_POOLSIZE);
+
+  return M25519_NO_ERROR;
+}
+
+
+// Removal of a key-pair from a pool
+// ---------------------------------
+// The oldest key-pair is copied to `privkey` and `pubkey` (32 bytes each) and
+// its slot is wiped, i.e., each key-pair is handed out only once. The return
+// value is `M25519_ERR_POOLEMPTY` if the pool is empty (in which case
+// `privkey` and `pubkey` are not modified) and `M25519_NO_ERROR` otherwise.
+// The slot is only read after `wr` has been read and only released (i.e.,
+// `rd` is updated) after it has been wiped, with a memory barrier in between.
+
+int x25519_pool_take(X25519Pool *pool, Byte *privkey, Byte *pubkey)
+{
+  int slot, j;
+
+  if (x25519_pool_count(pool) == 0) return M25519_ERR_POOLEMPTY;
+
+  M25519_POOL_BARRIER();  // key-pair is read after it has been published
+  slot = pool->rd % X25519_POOLSIZE;
+  for (j = 0; j < 32; j++) {
+    privkey[j] = pool->sk[slot][j];
+    pubkey[j] = pool->pk[slot][j];
+    pool->sk[slot][j] = 0;
+    pool->pk[slot][j] = 0;
+  }
+  M25519_POOL_BARRIER();  // slot is wiped before it is released
+  pool->rd = (pool->rd + 1) % (2*X25519_POOLSIZE);
+
+  return M25519_NO_ERROR;
+}
+
+
+// Resumable computation of an X25519 shared secret
+// ------------------------------------------------
+// These three functions compute the same shared secret as `x25519_batch` for
+// a single private key and public key, but the Montgomery ladder is split
+// into `CONSTK` steps (one `mon_ladder_step` per bit of the pruned private
+// key) so that a caller can interleave the key exchange with other tasks. The
+// init function prunes the private key and masks the MSB of the public key
+// (as described in RFC 7748), and every step function executes up to `n`
+// ladder steps and returns the number of ladder steps that are still to be
+// executed (0 when the ladder is complete). Each ladder step executes the same
+// sequence of operations, and the number of executed ladder steps only
+// depends on `n`. The final function performs the last conditional swap,
+// computes $u = X_R/Z_R$ with the constant-time inversion of `ted_conv_p2a`
+// (which costs about as much as 25 ladder steps), stores the shared secret in
+// `shared`, and wipes the context. The return value of the final function is
+// `M25519_ERR_STREAM` if the ladder is not complete yet (in which case
+// `shared` is not modified), `M25519_ERR_MPOINT` if the shared secret is 0
+// (i.e., the public key is a point of low order), and `M25519_NO_ERROR`
+// otherwise. A context that has already been finalized yields a shared secret
+// of 0.
+
+void x25519_init(X25519Ctx *ctx, const Byte *sk, const Byte *pk)
+{
+  Word *xz = ctx->xz;
+
+  x25519_from_bytes(ctx->k, sk);
+  ctx->k[0] &= 0xFFFFFFF8UL;      // clear three lowest bits
+  ctx->k[LEN-1] &= 0x7FFFFFFFUL;  // clear bit 255
+  ctx->k[LEN-1] |= 0x40000000UL;  // set bit 254
+  x25519_from_bytes(ctx->xd, pk);
+  ctx->xd[LEN-1] &= 0x7FFFFFFFUL;  // mask bit 255
+
+  mpi_setw(xz, 1, LEN);                 // X_R = 1
+  mpi_copy(&xz[LEN], ctx->xd, LEN);     // X_S = x_D
+  mpi_setw(&xz[2*LEN], 0, LEN);         // Z_R = 0
+  mpi_setw(&xz[3*LEN], 1, LEN);         // Z_S = 1
+  ctx->pos = CONSTK - 1;
+  ctx->prev = 0;
+}
+
+
+int x25519_step(X25519Ctx *ctx, int n)
+{
+  int bit;
+
+  for (; (n > 0) && (ctx->pos >= 0); n--, ctx->pos--) {
+    bit = (ctx->k[ctx->pos/WSIZE] >> (ctx->pos % WSIZE)) & 1;
+    mon_ladder_step(ctx->xz, ctx->xd, CONSTA24, bit ^ ctx->prev);
+    ctx->prev = bit;
+  }
+
+  return ctx->pos + 1;
+}
+
+
+int x25519_final(Byte *shared, X25519Ctx *ctx)
+{
+  Word tmp[3*LEN], u[2*LEN];
+  Point tp = { 3, tmp }, up = { 2, u };
+  Word acc = 0;
+  int i, err = M25519_ERR_STREAM;
+
+  if (ctx->pos < 0) {
+    gfp_cswap(ctx->xz, &ctx->xz[LEN], ctx->prev);
+    gfp_cswap(&ctx->xz[2*LEN], &ctx->xz[3*LEN], ctx->prev);
+    mpi_copy(tmp, ctx->xz, LEN);                   // X = X_R
+    mpi_copy(&tmp[2*LEN], &ctx->xz[2*LEN], LEN);   // Z = Z_R
+    mpi_setw(&tmp[LEN], 0, LEN);
+    ted_conv_p2a(&up, &tp, &ECDOMPAR25519);        // u = X/Z (0 if Z = 0)
+    x25519_to_bytes(shared, u);
+    for (i = 0; i < LEN; i++) acc |= u[i];
+    // err = M25519_ERR_MPOINT if acc = 0, else err = 0
+    err = (int) (((Word) M25519_ERR_MPOINT) & (((acc | (0 - acc)) >> 31) - 1));
+  }
+
+  mpi_setw(ctx->xz, 0, 4*LEN);
+  mpi_setw(ctx->k, 0, LEN);
+  ctx->pos = -1;
+  ctx->prev = 0;
+  mpi_setw(tmp, 0, 3*LEN);
+  mpi_setw(u, 0, 2*LEN);
+
+  return err;
+}
+
+#undef NUMVEC
+#undef ROTR64
+#undef M25519_POOL_BARRIER
+#undef CONSTA24
+
+///////////////////////////////////////////////////////////////////////////////
+// src/ed25519.c                                                             //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+// The functions in this file implement the generation and verification of
+// Ed25519 signatures as specified in RFC 8032 (with one-shot and incremental
+// interfaces), along with the signature-specific operations for
+// the (de)compression of points, the exponentiation needed for decompression,
+// and the arithmetic modulo the group order $\ell = 2^{252} +
+// 27742317777372353535851937790883648493$. All verifications use the
+// "cofactored" equation $8 s G = 8 R + 8 h A$ with $h = \mathrm{SHA512}(R \|
+// A \| M) \bmod \ell$, which is also the equation checked by the random linear
+// combination of `ed25519_verify_batch`, so that the result of a batch
+// verification is always consistent with individual verifications. Values
+// modulo $\ell$ are actually reduced modulo the cardinality $8 \ell$ (which
+// is a 256-bit integer) and only fully reduced modulo $\ell$ when needed.
+
+
+#include <stddef.h>
+#include <string.h>
+
+
+// Conversion of `4*len` bytes (in little-Endian order) to a `len`-word array
+// and vice versa. When `M25519_LEBYTES` is defined (see `config.h`), the byte
+// order of the target is the same as that of the arrays and the conversion is
+// a copy. Otherwise, the conversions are independent of the endianness of the
+// target.
+
+#if defined(M25519_LEBYTES)
+
+static void ed25519_from_bytes(Word *r, const Byte *a, int len)
+{
+  memcpy(r, a, 4*((size_t) len));
+}
+
+static void ed25519_to_bytes(Byte *r, const Word *a, int len)
+{
+  memcpy(r, a, 4*((size_t) len));
+}
+
+#else
+
+static void ed25519_from_bytes(Word *r, const Byte *a, int len)
+{
+  int i;
+
+  for (i = 0; i < len; i++) {
+    r[i] = ((Word) a[4*i]) | (((Word) a[4*i+1]) << 8) | \
+           (((Word) a[4*i+2]) << 16) | (((Word) a[4*i+3]) << 24);
+  }
+}
+
+static void ed25519_to_bytes(Byte *r, const Word *a, int len)
+{
+  int i;
+
+  for (i = 0; i < 4*len; i++) r[i] = (Byte) (a[i/4] >> (8*(i % 4)));
+}
+
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+////////////// SIGNATURE-SPECIFIC FIELD AND POINT ARITHMETIC //////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Exponentiation of a field-element: $r = a^{(p-5)/8} \bmod p$
+// ------------------------------------------------------------
+// The exponent $(p-5)/8 = 2^{252} - 3$ is processed with the addition chain
+// also used in Ref10, which consists of 251 squarings and 11 multiplications.
+// The runs of consecutive squarings are executed with `gfp_sqrn`.
+
+void gfp_exp_p58(Word *r, const Word *a)
+{
+  Word tmp[3*LEN];  // temporary space for three gfp elements
+  Word *t0 = tmp, *t1 = &tmp[LEN], *t2 = &tmp[2*LEN];
+
+  gfp_sqr(t0, a);                               // t0 = a^2
+  gfp_sqrn(t1, t0, 2);                          // t1 = a^8
+  gfp_mul(t1, a, t1);                           // t1 = a^9
+  gfp_mul(t0, t0, t1);                          // t0 = a^11
+  gfp_sqr(t0, t0);                              // t0 = a^22
+  gfp_mul(t0, t1, t0);                          // t0 = a^(2^5-1)
+  gfp_sqrn(t1, t0, 5);
+  gfp_mul(t0, t1, t0);                          // t0 = a^(2^10-1)
+  gfp_sqrn(t1, t0, 10);
+  gfp_mul(t1, t1, t0);                          // t1 = a^(2^20-1)
+  gfp_sqrn(t2, t1, 20);
+  gfp_mul(t1, t2, t1);                          // t1 = a^(2^40-1)
+  gfp_sqrn(t1, t1, 10);
+  gfp_mul(t0, t1, t0);                          // t0 = a^(2^50-1)
+  gfp_sqrn(t1, t0, 50);
+  gfp_mul(t1, t1, t0);                          // t1 = a^(2^100-1)
+  gfp_sqrn(t2, t1, 100);
+  gfp_mul(t1, t2, t1);                          // t1 = a^(2^200-1)
+  gfp_sqrn(t1, t1, 50);
+  gfp_mul(t0, t1, t0);                          // t0 = a^(2^250-1)
+  gfp_sqrn(t0, t0, 2);                          // t0 = a^(2^252-4)
+  gfp_mul(r, t0, a);                            // r = a^(2^252-3)
+}
+
+
+// Compression of a point: $r = y + 2^{255} (x \bmod 2)$
+// -----------------------------------------------------
+// The point $P$ must be given in affine coordinates. Both coordinates are
+// fully reduced before the compression.
+
+void ted_compress(Word *r, const Point *a)
+{
+  Word x[LEN];
+
+  gfp_fred(x, a->xyz);
+  gfp_fred(r, &a->xyz[LEN]);
+  r[LEN-1] |= (x[0] & 1) << (WSIZE - 1);
+}
+
+
+// Compression of a batch of points: $r_i = y_i + 2^{255} (x_i \bmod 2)$
+// ---------------------------------------------------------------------
+// The `n` points $P_i$ must be given in projective coordinates (`p[i].dim` at
+// least 3), e.g., as computed by `ted_mul_fixbase_proj`, and the compressed
+// points are stored in the array `r` of `n*LEN` words, which must not overlap
+// with the points. The affine coordinates $x_i = X_i/Z_i$ and $y_i = Y_i/Z_i$
+// are obtained with one batch inversion of all $Z_i$ (see `gfp_inv_batch`),
+// which means that compressing $n$ points costs a single inversion and $5n -
+// 3$ multiplications in GF(p) instead of $n$ inversions. The array `scratch`
+// must be able to accommodate `2*n*LEN` words. The return value is
+// `M25519_ERR_TPOINT` if $Z_i = 0$ for at least one point (whose compressed
+// value is then 0) and `M25519_NO_ERROR` otherwise. Like `ted_conv_p2a`, the
+// batch inversion has constant execution time, i.e., the points may be the
+// results of scalar multiplications with secret scalars.
+
+int ted_compress_batch(Word *r, const Point *p, int n, Word *scratch)
+{
+  Word x[LEN], y[LEN];
+  Word *zi = scratch;
+  int i, err;
+
+  if (n <= 0) return M25519_NO_ERROR;
+
+  for (i = 0; i < n; i++) mpi_copy(&zi[i*LEN], &p[i].xyz[2*LEN], LEN);
+  err = gfp_inv_batch(zi, zi, n, &scratch[n*LEN]);
+  for (i = 0; i < n; i++) {
+    gfp_mul(x, p[i].xyz, &zi[i*LEN]);
+    gfp_mul(y, &p[i].xyz[LEN], &zi[i*LEN]);
+    gfp_fred(x, x);
+    gfp_fred(&r[i*LEN], y);
+    r[i*LEN+LEN-1] |= (x[0] & 1) << (WSIZE - 1);
+  }
+
+  return (err == M25519_NO_ERROR) ? M25519_NO_ERROR : M25519_ERR_TPOINT;
+}
+
+
+// Decompression of a point: $R = (x,y)$
+// -------------------------------------
+// The decompression follows Section 5.1.3 of RFC 8032, i.e., the candidate
+// root $x = u v^3 (u v^7)^{(p-5)/8}$ of $x^2 = u/v$ with $u = y^2 - 1$ and
+// $v = d y^2 + 1$ is computed first, and then multiplied by $\sqrt{-1}$ if
+// $v x^2 = -u$. The decompression fails when $y \geq p$, when $u/v$ is not a
+// square, or when $x = 0$ and the sign-bit is 1. The coordinates of the result
+// are fully reduced. The parameter `d` is needed to access the curve parameter
+// $d$ and the root of $-1$.
+// NOTE: The execution time of this function is not constant, which is fine
+// since it operates on public values (e.g., public keys or signatures) only.
+
+int ted_decompress(Point *r, const Word *a, const ECDomPar *d)
+{
+  Word tmp[4*LEN];  // temporary space for four gfp elements
+  Word *u = tmp, *v = &tmp[LEN], *t0 = &tmp[2*LEN], *t1 = &tmp[3*LEN];
+  Word *x = r->xyz, *y = &r->xyz[LEN];
+  int sign = (int) (a[LEN-1] >> (WSIZE - 1));
+
+  mpi_copy(y, a, LEN);
+  y[LEN-1] &= ~(((Word) 1) << (WSIZE - 1));
+  if (gfp_cmpp(y) >= 0) return M25519_ERR_DECOMP;
+
+  mpi_setw(t0, 1, LEN);
+  gfp_sqr(t1, y);               // t1 = y^2
+  gfp_sub(u, t1, t0);           // u = y^2 - 1
+  gfp_mul(v, t1, d->dte);       // v = d*y^2
+  gfp_add(v, v, t0);            // v = d*y^2 + 1
+  gfp_sqr(t0, v);               // t0 = v^2
+  gfp_mul(t0, t0, v);           // t0 = v^3
+  gfp_sqr(t1, t0);              // t1 = v^6
+  gfp_mul(t1, t1, v);           // t1 = v^7
+  gfp_mul(t1, t1, u);           // t1 = u*v^7
+  gfp_exp_p58(t1, t1);          // t1 = (u*v^7)^((p-5)/8)
+  gfp_mul(t0, t0, u);           // t0 = u*v^3
+  gfp_mul(x, t0, t1);           // x = u*v^3*(u*v^7)^((p-5)/8)
+
+  gfp_sqr(t0, x);               // t0 = x^2
+  gfp_mul(t0, t0, v);           // t0 = v*x^2
+  if (gfp_cmp(t0, u) != 0) {
+    gfp_add(t0, t0, u);         // t0 = v*x^2 + u
+    mpi_setw(t1, 0, LEN);
+    if (gfp_cmp(t0, t1) != 0) return M25519_ERR_DECOMP;
+    gfp_mul(x, x, d->rm1);      // x = x*sqrt(-1)
+  }
+
+  gfp_fred(x, x);
+  if ((mpi_cmpw(x, 0, LEN) == 0) && sign) return M25519_ERR_DECOMP;
+  gfp_cneg(x, x, ((int) (x[0] & 1)) ^ sign);
+  gfp_fred(x, x);
+
+  return M25519_NO_ERROR;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+/////////////////// ARITHMETIC MODULO THE GROUP ORDER /////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Addition of two MPIs modulo the group order: $r = a + b \bmod \ell$
+// -------------------------------------------------------------------
+// The sum $a + b$ (which can be up to 257 bits long) is reduced modulo the
+// cardinality $8 \ell$ by (at most) two subtractions of $8 \ell$, which are
+// only carried out when the sum is 257 bits long. The subtractions and re-
+// additions are controlled by the carry-bit so that the execution time does
+// not depend on the operands.
+
+void ed25519_add_order(Word *r, const Word *a, const Word *b, \
+  const ECDomPar *d)
+{
+  int i, carry, rbit;
+
+  carry = mpi_add(r, a, b, LEN);
+  for (i = 0; i < 2; i++) {
+    rbit = mpi_sub(r, r, d->car, LEN);
+    mpi_cadd(r, r, d->car, 1 - carry, LEN);
+    carry &= 1 - rbit;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+#if !defined(M25519_ASSEMBLY_EXT) // PERFORMANCE-CRITICAL ORDER ARITHMETIC ////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Reduction of a double-length MPI modulo the group order: $r = a \bmod \ell$
+// ---------------------------------------------------------------------------
+// The 512-bit MPI $a$ is reduced modulo the cardinality $m = 8 \ell$, which is
+// 256 bits long (i.e., $2^{255} < m < 2^{256}$), with Barrett's algorithm and
+// the 257-bit constant $\mu = \lfloor 2^{512}/m \rfloor$. The quotient
+// estimate is $q = \lfloor \lfloor a/2^{224} \rfloor \mu / 2^{288} \rfloor$
+// and the remainder $a - q m$ is computed modulo $2^{288}$ (i.e., with nine
+// words) and is smaller than $3m$. Therefore, two constant-time subtractions
+// of $m$ (with conditional re-additions) suffice to get a result in $[0, m)$.
+// The Assembly version (see `M25519_ASSEMBLY_EXT`) exploits that the words 4 to 6
+// of $m$ are 0 and fuses the second multiplication with the subtraction.
+
+void ed25519_mod_order(Word *r, const Word *a, const ECDomPar *d)
+{
+  Word q[2*(LEN+1)], t[2*(LEN+1)], m[LEN+1];
+  int i, rbit;
+
+  mpi_copy(m, d->car, LEN);
+  m[LEN] = 0;
+  mpi_mul9(q, &a[LEN-1], d->cbr);  // q = (a >> 224)*mu
+  mpi_mul9(t, &q[LEN+1], m);       // t = (q >> 288)*m
+  mpi_sub(t, a, t, LEN + 1);       // t = (a - q*m) mod 2^288
+  for (i = 0; i < 2; i++) {
+    rbit = mpi_sub(t, t, m, LEN + 1);
+    mpi_cadd(t, t, m, rbit, LEN + 1);
+  }
+  mpi_copy(r, t, LEN);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+#endif ///////////////// ADDITIONAL ORDER ARITHMETIC //////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Full reduction of an MPI modulo the group order: $r = a \bmod \ell$
+// -------------------------------------------------------------------
+// Since $a < 2^{256} < 16 \ell$, the least non-negative residue is obtained
+// by conditional subtractions of $8 \ell$, $4 \ell$, $2 \ell$ and $\ell$
+// (in this order), which are performed in constant time.
+
+void ed25519_fred_order(Word *r, const Word *a, const ECDomPar *d)
+{
+  Word m[LEN];
+  int i, rbit;
+
+  mpi_copy(m, d->car, LEN);
+  mpi_copy(r, a, LEN);
+  for (i = 0; i < 4; i++) {
+    rbit = mpi_sub(r, r, m, LEN);
+    mpi_cadd(r, r, m, rbit, LEN);
+    mpi_shr(m, m, LEN);
+  }
+}
+
+
+// Reduction of a SHA-512 digest modulo the group order: $h = H \bmod \ell$
+// ------------------------------------------------------------------------
+// The 64 bytes of the digest are interpreted as a 512-bit integer in little-
+// Endian order, which is fully reduced modulo $\ell$.
+
+static void ed25519_hash_order(Word *h, const Byte *digest)
+{
+  Word hdig[2*LEN];
+  const ECDomPar *d = &ECDOMPAR25519;
+
+  ed25519_from_bytes(hdig, digest, 2*LEN);
+  ed25519_mod_order(h, hdig, d);
+  ed25519_fred_order(h, h, d);
+  mpi_setw(hdig, 0, 2*LEN);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+////////////////////// GENERATION OF ED25519 SIGNATURES ///////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Wiping of secret data
+// ----------------------
+// The `len` bytes at `p` are set to 0 through a volatile pointer so that the
+// stores can not be removed by the compiler (e.g., when `p` is a local array
+// that is not used anymore). The execution time only depends on `len`.
+
+static void ed25519_wipe(void *p, size_t len)
+{
+  volatile Byte *b = (volatile Byte *) p;
+  size_t i;
+
+  for (i = 0; i < len; i++) b[i] = 0;
+}
+
+
+// Expansion of a private key
+// --------------------------
+// The 32-byte private key is hashed with SHA-512 (Section 5.1.5 of RFC 8032).
+// The first half of the digest is pruned and yields the secret scalar $a$,
+// while the second half is the prefix for the computation of the nonce.
+
+static void ed25519_expand(Word *a, Byte *prefix, const Byte *privkey)
+{
+  Byte digest[64];
+  int i;
+
+  sha512_hash(digest, privkey, 32);
+  digest[0] &= 0xF8;                           // clear three lowest bits
+  digest[31] = (digest[31] & 0x7F) | 0x40;     // clear bit 255, set bit 254
+  ed25519_from_bytes(a, digest, LEN);
+  for (i = 0; i < 32; i++) prefix[i] = digest[32+i];
+  ed25519_wipe(digest, 64);
+}
+
+
+// Computation of the point $R$ of a signature: $R = r G$
+// ------------------------------------------------------
+// The nonce $r$ is obtained by reducing the digest of $\mathrm{prefix} \| M$
+// modulo $\ell$, and $R = r G$ is computed with `ted_mul_fixbase` and stored
+// in compressed form in the 32-byte array `rc`. The return value is the error
+// code of `ted_mul_fixbase` (i.e., `M25519_NO_ERROR` except when $r \equiv 0
+// \bmod \ell$, which happens with negligible probability).
+
+static int ed25519_commit(Byte *rc, Word *r, const Byte *digest)
+{
+  Word tmp[2*LEN];
+  Point rp = { 2, tmp };
+  int err;
+
+  ed25519_hash_order(r, digest);
+  err = ted_mul_fixbase(&rp, r, &ECDOMPAR25519);
+  ted_compress(tmp, &rp);
+  ed25519_to_bytes(rc, tmp, LEN);
+
+  return err;
+}
+
+
+// Computation of the scalar $s$ of a signature: $s = r + h a \bmod \ell$
+// ----------------------------------------------------------------------
+// The value $h$ is obtained by reducing the digest of $R \| A \| M$ modulo
+// $\ell$. The product $h a$ is reduced with `ed25519_mod_order` and the sum
+// $r + h a$ with `ed25519_add_order` and `ed25519_fred_order`, all of which
+// have constant execution time. The result is stored in the 32-byte array `s`.
+
+static void ed25519_respond(Byte *s, const Word *r, const Byte *digest, \
+  const Word *a)
+{
+  Word h[LEN], prod[2*LEN];
+  const ECDomPar *d = &ECDOMPAR25519;
+
+  ed25519_hash_order(h, digest);
+  mpi_mul8(prod, h, a);
+  ed25519_mod_order(h, prod, d);
+  ed25519_add_order(h, h, r, d);
+  ed25519_fred_order(h, h, d);
+  ed25519_to_bytes(s, h, LEN);
+  mpi_setw(h, 0, LEN);
+  mpi_setw(prod, 0, 2*LEN);
+}
+
+
+// Initialization of a signing context
+// -----------------------------------
+// The private key is expanded with `ed25519_expand`, i.e., the scalar $a$ and
+// the prefix are stored in the context. When `pubkey` is `NULL`, the public
+// key $A = a G$ is computed with `ted_mul_fixbase` and compressed, otherwise
+// it is copied from `pubkey` (which must be the compressed public key of
+// `privkey`). The return value is the error code of `ted_mul_fixbase`.
+
+int ed25519_sign_ctx_init(Ed25519SCtx *ctx, const Byte *privkey, \
+  const Byte *pubkey)
+{
+  Word tmp[2*LEN];
+  Point ap = { 2, tmp };
+  int err = M25519_NO_ERROR, i;
+
+  ed25519_expand(ctx->a, ctx->prefix, privkey);
+  if (pubkey == NULL) {
+    err = ted_mul_fixbase(&ap, ctx->a, &ECDOMPAR25519);
+    ted_compress(tmp, &ap);
+    ed25519_to_bytes(ctx->pk, tmp, LEN);
+  } else {
+    for (i = 0; i < 32; i++) ctx->pk[i] = pubkey[i];
+  }
+
+  return err;
+}
+
+
+// Wiping of a signing context
+// ---------------------------
+
+void ed25519_sign_ctx_wipe(Ed25519SCtx *ctx)
+{
+  ed25519_wipe(ctx, sizeof(Ed25519SCtx));
+}
+
+
+// Serialization of a signing context
+// ----------------------------------
+// The context is written to the byte-array `buf` of `ED25519_SCTXBYTES` bytes
+// as $a \| \mathrm{prefix} \| A$, with $a$ in little-Endian order, so that the
+// stored context does not depend on the endianness of the target.
+
+void ed25519_sign_ctx_store(Byte *buf, const Ed25519SCtx *ctx)
+{
+  int i;
+
+  ed25519_to_bytes(buf, ctx->a, LEN);
+  for (i = 0; i < 32; i++) {
+    buf[32+i] = ctx->prefix[i];
+    buf[64+i] = ctx->pk[i];
+  }
+}
+
+
+// De-serialization of a signing context
+// -------------------------------------
+// The context is read from a byte-array written by `ed25519_sign_ctx_store`.
+// The return value is `M25519_ERR_SCALAR` if $a$ is not a pruned scalar (in
+// which case the context is wiped) and `M25519_NO_ERROR` otherwise.
+
+int ed25519_sign_ctx_load(Ed25519SCtx *ctx, const Byte *buf)
+{
+  int i;
+
+  if (((buf[0] & 0x07) != 0) || ((buf[31] & 0xC0) != 0x40)) {
+    ed25519_sign_ctx_wipe(ctx);
+    return M25519_ERR_SCALAR;
+  }
+  ed25519_from_bytes(ctx->a, buf, LEN);
+  for (i = 0; i < 32; i++) {
+    ctx->prefix[i] = buf[32+i];
+    ctx->pk[i] = buf[64+i];
+  }
+
+  return M25519_NO_ERROR;
+}
+
+
+// Computation of an Ed25519 signature with a signing context
+// ----------------------------------------------------------
+// Since the private key has already been expanded, a signature costs one
+// fixed-base scalar multiplication, two SHA-512 computations over the message
+// (plus 32 and 64 bytes, respectively), and the arithmetic modulo $\ell$. The
+// nonce $r$ is wiped at the end. The return value is the error code of
+// `ed25519_commit`.
+
+int ed25519_sign_ctx(Byte *signature, const Byte *message, size_t mlen, \
+  const Ed25519SCtx *ctx)
+{
+  Word r[LEN];
+  SHA512Ctx hctx;
+  Byte digest[64];
+  int err;
+
+  sha512_init(&hctx);
+  sha512_update(&hctx, ctx->prefix, 32);
+  sha512_update(&hctx, message, mlen);
+  sha512_final(&hctx, digest);
+  err = ed25519_commit(signature, r, digest);
+
+  sha512_init(&hctx);
+  sha512_update(&hctx, signature, 32);
+  sha512_update(&hctx, ctx->pk, 32);
+  sha512_update(&hctx, message, mlen);
+  sha512_final(&hctx, digest);
+  ed25519_respond(&signature[32], r, digest, ctx->a);
+
+  ed25519_wipe(r, sizeof(r));
+
+  return err;
+}
+
+
+// Computation of an Ed25519 signature
+// -----------------------------------
+// The key-pair consists of the 32-byte private key followed by the 32-byte
+// compressed public key $A$. The private key is expanded into a (temporary)
+// signing context, which is wiped at the end. The return value is the error
+// code of `ed25519_commit`.
+
+int ed25519_sign(Byte *signature, const Byte *message, size_t mlen, \
+  const Byte *keypair)
+{
+  Ed25519SCtx key;
+  int err;
+
+  ed25519_sign_ctx_init(&key, keypair, &keypair[32]);
+  err = ed25519_sign_ctx(signature, message, mlen, &key);
+  ed25519_sign_ctx_wipe(&key);
+
+  return err;
+}
+
+
+// Initialization of an incremental signature generation
+// -----------------------------------------------------
+// The private key of the key-pair (same format as for `ed25519_sign`) is
+// expanded and the first pass over the message (i.e., the computation of the
+// nonce) is started.
+
+void ed25519_sign_init(Ed25519SStream *ctx, const Byte *keypair)
+{
+  int i;
+
+  ed25519_expand(ctx->a, ctx->prefix, keypair);
+  for (i = 0; i < 32; i++) ctx->pk[i] = keypair[32+i];
+  sha512_init(&ctx->hctx);
+  sha512_update(&ctx->hctx, ctx->prefix, 32);
+  sha512_init(&ctx->cctx);
+  ctx->pass = 1;
+}
+
+
+// Update of an incremental signature generation with a part of the message
+// ------------------------------------------------------------------------
+// In the first pass, the data is only hashed for the nonce. In the second
+// pass, it is hashed for $h$ and for the re-computation of the nonce.
+
+void ed25519_sign_update(Ed25519SStream *ctx, const Byte *data, size_t dlen)
+{
+  if (ctx->pass >= 1) sha512_update(&ctx->hctx, data, dlen);
+  if (ctx->pass == 2) sha512_update(&ctx->cctx, data, dlen);
+}
+
+
+// Transition from the first to the second pass over the message
+// -------------------------------------------------------------
+// The nonce $r$ and the point $R = r G$ are computed (see `ed25519_commit`),
+// and the hashes for $h = \mathrm{SHA512}(R \| A \| M)$ and the re-computation
+// of the nonce are started. The return value is `M25519_ERR_STREAM` if the
+// context is not in the first pass and the error code of `ed25519_commit`
+// otherwise.
+
+int ed25519_sign_commit(Ed25519SStream *ctx)
+{
+  Byte digest[64];
+  int err;
+
+  if (ctx->pass != 1) return M25519_ERR_STREAM;
+
+  sha512_final(&ctx->hctx, digest);
+  err = ed25519_commit(ctx->rc, ctx->r, digest);
+  sha512_update(&ctx->hctx, ctx->rc, 32);
+  sha512_update(&ctx->hctx, ctx->pk, 32);
+  sha512_update(&ctx->cctx, ctx->prefix, 32);
+  ctx->pass = 2;
+  ed25519_wipe(digest, 64);
+
+  return err;
+}
+
+
+// Finalization of an incremental signature generation
+// ---------------------------------------------------
+// The nonce is re-computed from the data of the second pass and compared
+// (in constant time) with the nonce of the first pass. When they match, $s = r
+// + h a \bmod \ell$ is computed and the signature $R \| s$ is written to the
+// 64-byte array `signature`; otherwise, the signature is all-0 since the same
+// $r$ must never be used with different messages (this would reveal $a$). In
+// both cases, the whole context is wiped. The return value is
+// `M25519_ERR_STREAM` if the context is not in the second pass or if the
+// message of the second pass differs from that of the first pass, and
+// `M25519_NO_ERROR` otherwise.
+
+int ed25519_sign_final(Ed25519SStream *ctx, Byte *signature)
+{
+  Word r[LEN], diff = 0;
+  Byte digest[64];
+  int err = M25519_ERR_STREAM;
+  size_t i;
+
+  if (ctx->pass == 2) {
+    sha512_final(&ctx->cctx, digest);
+    ed25519_hash_order(r, digest);
+    for (i = 0; i < LEN; i++) diff |= r[i] ^ ctx->r[i];
+    if (diff == 0) {
+      sha512_final(&ctx->hctx, digest);
+      for (i = 0; i < 32; i++) signature[i] = ctx->rc[i];
+      ed25519_respond(&signature[32], ctx->r, digest, ctx->a);
+      err = M25519_NO_ERROR;
+    }
+    ed25519_wipe(r, sizeof(r));
+    ed25519_wipe(digest, 64);
+  }
+  if (err != M25519_NO_ERROR) ed25519_wipe(signature, 64);
+  ed25519_wipe(ctx, sizeof(Ed25519SStream));
+
+  return err;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+////////////////////// VERIFICATION OF ED25519 SIGNATURES /////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Decoding of the point $R$ and the scalar $s$ of a signature
+// ------------------------------------------------------------
+// This function decompresses the point $R$ of the signature and checks that
+// $s < \ell$. The point $-R$ is stored in extended affine coordinates in the
+// array `rn`. The return value is `M25519_ERR_SIGVER` if $R$ can not be
+// decompressed or $s \geq \ell$.
+
+static int ed25519_decode_rs(Word *rn, Word *s, const Byte *sig)
+{
+  Word tmp[2*LEN];
+  Point a = { 2, tmp }, p = { 3, rn };
+  const ECDomPar *d = &ECDOMPAR25519;
+
+  ed25519_from_bytes(tmp, sig, LEN);
+  if (ted_decompress(&a, tmp, d) != M25519_NO_ERROR) return M25519_ERR_SIGVER;
+  gfp_cneg(tmp, tmp, 1);  // -R = (-x,y)
+  ted_conv_a2ea(&p, &a, d);
+
+  ed25519_from_bytes(s, &sig[32], LEN);
+  ed25519_fred_order(tmp, s, d);
+  if (mpi_cmp(tmp, s, LEN) != 0) return M25519_ERR_SIGVER;
+
+  return M25519_NO_ERROR;
+}
+
+
+// Decoding of a public key
+// ------------------------
+// This function decompresses the public key $A$ and stores $-A$ in extended
+// affine coordinates in the array `an`. The return value is
+// `M25519_ERR_DECOMP` if $A$ can not be decompressed.
+
+static int ed25519_decode_pk(Word *an, const Byte *pk)
+{
+  Word tmp[2*LEN];
+  Point a = { 2, tmp }, p = { 3, an };
+  const ECDomPar *d = &ECDOMPAR25519;
+
+  ed25519_from_bytes(tmp, pk, LEN);
+  if (ted_decompress(&a, tmp, d) != M25519_NO_ERROR) return M25519_ERR_DECOMP;
+  gfp_cneg(tmp, tmp, 1);  // -A = (-x,y)
+  ted_conv_a2ea(&p, &a, d);
+
+  return M25519_NO_ERROR;
+}
+
+
+// Decoding of a signature
+// -----------------------
+// This function decodes $R$ and $s$ with `ed25519_decode_rs` and computes $h
+// = \mathrm{SHA512}(R \| A \| M) \bmod \ell$ with the compressed public key
+// $A$ given by `pk`. The digest of $R \| A \| M$ is also stored in `dig` when
+// `dig` is not `NULL`. The return value is `M25519_ERR_SIGVER` if $R$ can not
+// be decompressed or $s \geq \ell$.
+
+static int ed25519_decode_sig(Word *rn, Word *s, Word *h, Byte *dig, \
+  const Byte *sig, const Byte *msg, size_t mlen, const Byte *pk)
+{
+  SHA512Ctx ctx;
+  Byte digest[64];
+  int i;
+
+  if (ed25519_decode_rs(rn, s, sig) != M25519_NO_ERROR) \
+    return M25519_ERR_SIGVER;
+
+  sha512_init(&ctx);
+  sha512_update(&ctx, sig, 32);
+  sha512_update(&ctx, pk, 32);
+  sha512_update(&ctx, msg, mlen);
+  sha512_final(&ctx, digest);
+  if (dig != NULL) for (i = 0; i < 64; i++) dig[i] = digest[i];
+  ed25519_hash_order(h, digest);
+
+  return M25519_NO_ERROR;
+}
+
+
+// Decoding of a signature and the public key
+// ------------------------------------------
+// This function decodes the public key with `ed25519_decode_pk` and then the
+// signature with `ed25519_decode_sig`. The return value is `M25519_ERR_DECOMP`
+// if $A$ can not be decompressed and `M25519_ERR_SIGVER` if $R$ can not be
+// decompressed or $s \geq \ell$.
+
+static int ed25519_decode(Word *rn, Word *an, Word *s, Word *h, Byte *dig, \
+  const Byte *sig, const Byte *msg, size_t mlen, const Byte *pk)
+{
+  if (ed25519_decode_pk(an, pk) != M25519_NO_ERROR) return M25519_ERR_DECOMP;
+
+  return ed25519_decode_sig(rn, s, h, dig, sig, msg, mlen, pk);
+}
+
+
+// Check whether $8 P = O$ for a point in extended projective coordinates
+// ----------------------------------------------------------------------
+// The point $P$ is doubled three times (i.e., `p` is overwritten) and the
+// result is compared with $O = [0:1:1]$, i.e., $X = 0$ and $Y = Z$ mod p.
+
+static int ed25519_is_small(Point *p)
+{
+  Word zero[LEN];
+
+  ted_double(p);
+  ted_double(p);
+  ted_double(p);
+  mpi_setw(zero, 0, LEN);
+
+  return ((gfp_cmp(p->xyz, zero) == 0) && \
+    (gfp_cmp(&p->xyz[LEN], &p->xyz[2*LEN]) == 0));
+}
+
+
+// Verification of a decoded signature: $8(sG - hA - R) \stackrel{?}{=} O$
+// ------------------------------------------------------------------------
+// The sum $sG + h(-A)$ is computed with the interleaved wNAF method of
+// `ted_mul_dblbase_wnaf`, then $-R$ is added and the result is multiplied by
+// the cofactor 8.
+
+static int ed25519_check(const Word *s, const Word *h, const Word *rn, \
+  const Word *an)
+{
+  Word tmp[6*LEN];
+  Point r = { 6, tmp }, p = { 3, (Word *) an }, q = { 3, (Word *) rn };
+
+  ted_mul_dblbase_wnaf(&r, s, h, &p, &ECDOMPAR25519);
+  ted_add(&r, &q);
+
+  return (ed25519_is_small(&r) ? M25519_NO_ERROR : M25519_ERR_SIGVER);
+}
+
+
+// Verification of an Ed25519 signature
+// ------------------------------------
+// The return value is `M25519_ERR_DECOMP` when the public key can not be
+// decompressed and `M25519_ERR_SIGVER` when the signature is invalid.
+
+int ed25519_verify(const Byte *signature, const Byte *message, size_t mlen, \
+  const Byte *pubkey)
+{
+  Word rn[3*LEN], an[3*LEN], s[LEN], h[LEN];
+  int err;
+
+  err = ed25519_decode(rn, an, s, h, NULL, signature, message, mlen, pubkey);
+  if (err != M25519_NO_ERROR) return err;
+
+  return ed25519_check(s, h, rn, an);
+}
+
+
+// Initialization of a verification context
+// -----------------------------------------
+// The public key $A$ is decompressed and the comb table of $-A$ is computed
+// with `ted_comb_table`. The return value is `M25519_ERR_DECOMP` when the
+// public key can not be decompressed.
+
+int ed25519_verify_ctx_init(Ed25519VCtx *ctx, const Byte *pubkey)
+{
+  Word tmp[2*LEN];
+  Point a = { 2, tmp };
+  const ECDomPar *d = &ECDOMPAR25519;
+  int i;
+
+  ed25519_from_bytes(tmp, pubkey, LEN);
+  if (ted_decompress(&a, tmp, d) != M25519_NO_ERROR) return M25519_ERR_DECOMP;
+  gfp_cneg(tmp, tmp, 1);  // -A = (-x,y)
+  ted_comb_table(ctx->tbl, &a, d);
+  for (i = 0; i < 32; i++) ctx->pk[i] = pubkey[i];
+
+  return M25519_NO_ERROR;
+}
+
+
+// Verification of an Ed25519 signature with a verification context
+// -----------------------------------------------------------------
+// The sum $sG + h(-A)$ is computed with the double-base comb method, which
+// shares all doublings between the two scalars and takes the multiples of $-A$
+// from the table of the context. Then $-R$ is added and the result is
+// multiplied by the cofactor 8. The return value is `M25519_ERR_SIGVER` when
+// the signature is invalid.
+
+int ed25519_verify_ctx(const Byte *signature, const Byte *message, \
+  size_t mlen, const Ed25519VCtx *ctx)
+{
+  Word rn[3*LEN], s[LEN], h[LEN], tmp[6*LEN];
+  Point r = { 6, tmp }, q = { 3, rn };
+  int err;
+
+  err = ed25519_decode_sig(rn, s, h, NULL, signature, message, mlen, ctx->pk);
+  if (err != M25519_NO_ERROR) return err;
+  ted_mul_dblbase_tbl(&r, s, h, ctx->tbl, &ECDOMPAR25519);
+  ted_add(&r, &q);
+
+  return (ed25519_is_small(&r) ? M25519_NO_ERROR : M25519_ERR_SIGVER);
+}
+
+
+// Initialization of an incremental signature verification
+// --------------------------------------------------------
+// The public key and the points $R$ and $s$ of the signature are decoded (see
+// `ed25519_decode_pk` and `ed25519_decode_rs`), and the hash of $R \| A \| M$
+// is started. When the decoding fails, the error code is kept in the context
+// and returned by `ed25519_verify_final`, i.e., the message can be passed to
+// `ed25519_verify_update` nevertheless.
+
+void ed25519_verify_init(Ed25519VStream *ctx, const Byte *signature, \
+  const Byte *pubkey)
+{
+  ctx->err = ed25519_decode_pk(ctx->an, pubkey);
+  if (ctx->err == M25519_NO_ERROR) \
+    ctx->err = ed25519_decode_rs(ctx->rn, ctx->s, signature);
+  sha512_init(&ctx->hctx);
+  sha512_update(&ctx->hctx, signature, 32);
+  sha512_update(&ctx->hctx, pubkey, 32);
+}
+
+
+// Update of an incremental signature verification with a part of the message
+// ---------------------------------------------------------------------------
+
+void ed25519_verify_update(Ed25519VStream *ctx, const Byte *data, size_t dlen)
+{
+  sha512_update(&ctx->hctx, data, dlen);
+}
+
+
+// Finalization of an incremental signature verification
+// -----------------------------------------------------
+// The value $h$ is obtained from the hash of $R \| A \| M$ and the same
+// cofactored verification equation as in `ed25519_verify` is checked. The
+// return value is `M25519_ERR_DECOMP` when the public key can not be
+// decompressed and `M25519_ERR_SIGVER` when the signature is invalid.
+
+int ed25519_verify_final(Ed25519VStream *ctx)
+{
+  Word h[LEN];
+  Byte digest[64];
+
+  sha512_final(&ctx->hctx, digest);
+  if (ctx->err != M25519_NO_ERROR) return ctx->err;
+  ed25519_hash_order(h, digest);
+
+  return ed25519_check(ctx->s, h, ctx->rn, ctx->an);
+}
+
+
+// Batch verification of Ed25519 signatures
+// ----------------------------------------
+// The `n` signatures are processed in groups of (at most) `ED25519_MAXBATCH`.
+// For each group, the signatures that can be decoded are combined with 128-
+// bit coefficients $z_i$ to the single equation $8((\sum_i z_i s_i) G -
+// \sum_i z_i R_i - \sum_i (z_i h_i) A_i) = O$, which is checked with one
+// multi-scalar multiplication of $2m + 1$ points. The coefficients are derived
+// from a SHA-512 digest of all signatures, public keys and digests $h_i$ of the
+// group (i.e., they are unpredictable for anyone who can not find a batch with
+// a forged signature that hashes to "suitable" coefficients), and bit 127 of
+// each $z_i$ is set so that $z_i \neq 0$. When the combined equation does not
+// hold, each signature of the group is verified separately (re-using the
+// decoded points and scalars) to find the invalid ones. The error code of the
+// i-th signature is written to err[i] when `err` is not `NULL`, and the return
+// value is the OR of the error codes of all signatures. The decoded points
+// and the scalars of a group are kept in the array `scratch` provided by the
+// caller (`ED25519_BATCHWORDS` words, i.e., about 10 kB with the default value
+// of `TED_MAXMULTI`), so that the stack usage is dominated by that of
+// `ted_mul_multi` and does not grow with `ED25519_MAXBATCH` (apart from the
+// array of `Point` structures and the error codes of a group).
+
+int ed25519_verify_batch(const Byte *sig[], const Byte *msg[], \
+  const size_t mlen[], const Byte *pk[], int n, int *err, Word *scratch)
+{
+  Word *pts = scratch, *k = &scratch[(2*ED25519_MAXBATCH+1)*3*LEN];
+  Word *s = &k[(2*ED25519_MAXBATCH+1)*LEN], *h = &s[ED25519_MAXBATCH*LEN];
+  Word z[2*LEN], prod[2*LEN], tmp[6*LEN], idx;
+  Point p[2*ED25519_MAXBATCH+1], r = { 6, tmp };
+  const ECDomPar *d = &ECDOMPAR25519;
+  SHA512Ctx ctx;
+  Byte seed[64+4], dig[64];
+  int e[ED25519_MAXBATCH];
+  int base, j, m, np, rval = M25519_NO_ERROR;
+
+  for (base = 0; base < n; base += ED25519_MAXBATCH) {
+    m = ((n - base) < ED25519_MAXBATCH) ? (n - base) : ED25519_MAXBATCH;
+
+    // decoding of the signatures and public keys
+    sha512_init(&ctx);
+    for (j = 0; j < m; j++) {
+      e[j] = ed25519_decode(&pts[(2*j+1)*3*LEN], &pts[(2*j+2)*3*LEN], \
+        &s[j*LEN], &h[j*LEN], dig, sig[base+j], msg[base+j], mlen[base+j], \
+        pk[base+j]);
+      if (e[j] != M25519_NO_ERROR) continue;
+      sha512_update(&ctx, sig[base+j], 64);
+      sha512_update(&ctx, pk[base+j], 32);
+      sha512_update(&ctx, dig, 64);
+    }
+    sha512_final(&ctx, seed);
+
+    // random linear combination of the valid signatures
+    np = 1;
+    p[0].dim = 3;
+    p[0].xyz = (Word *) TEDGENEA;
+    mpi_setw(k, 0, LEN);
+    mpi_setw(z, 0, 2*LEN);
+    for (j = 0; j < m; j++) {
+      if (e[j] != M25519_NO_ERROR) continue;
+      idx = (Word) j;
+      ed25519_to_bytes(&seed[64], &idx, 1);
+      sha512_hash(dig, seed, 64 + 4);
+      ed25519_from_bytes(z, dig, 4);
+      z[3] |= ((Word) 1) << (WSIZE - 1);
+      // coefficient of G: sum of z_i*s_i
+      mpi_mul8(prod, z, &s[j*LEN]);
+      ed25519_mod_order(prod, prod, d);
+      ed25519_add_order(k, k, prod, d);
+      // coefficient of -R_i: z_i
+      p[np].dim = 3;
+      p[np].xyz = &pts[(2*j+1)*3*LEN];
+      mpi_copy(&k[np*LEN], z, LEN);
+      np++;
+      // coefficient of -A_i: z_i*h_i
+      mpi_mul8(prod, z, &h[j*LEN]);
+      p[np].dim = 3;
+      p[np].xyz = &pts[(2*j+2)*3*LEN];
+      ed25519_mod_order(&k[np*LEN], prod, d);
+      ed25519_fred_order(&k[np*LEN], &k[np*LEN], d);
+      np++;
+    }
+    ed25519_fred_order(k, k, d);
+
+    if (np > 1) {
+      ted_mul_multi(&r, k, p, np, d);
+      if (!ed25519_is_small(&r)) {
+        // fall back to the verification of each signature of the group
+        for (j = 0; j < m; j++) {
+          if (e[j] != M25519_NO_ERROR) continue;
+          e[j] = ed25519_check(&s[j*LEN], &h[j*LEN], &pts[(2*j+1)*3*LEN], \
+            &pts[(2*j+2)*3*LEN]);
+        }
+      }
+    }
+
+    for (j = 0; j < m; j++) {
+      if (err != NULL) err[base+j] = e[j];
+      rval |= e[j];
+    }
+  }
+
+  return rval;
+}
@@ -0,0 +1,1064 @@
+///////////////////////////////////////////////////////////////////////////////
+// micro25519_all.h: All header files of Micro25519 (amalgamation).          //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// DO NOT EDIT: generated by `test/gen_amalgam.py` from the files in `src`.  //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _MICRO25519_ALL_H
+#define _MICRO25519_ALL_H
+
+///////////////////////////////////////////////////////////////////////////////
+// src/config.h                                                              //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+#ifndef _CONFIG_H
+#define _CONFIG_H
+
+
+#include <stdint.h>
+
+
+// Micro25519 uses the pseudo-Mersenne prime $p = 2^k - c$ with $k = 255$ and
+// $c = 19$. This prime has a length of 255 bits, which means an element of the
+// prime field GF(p) can be stored in a Word-array consisting of eight words of
+// WSIZE = 32 bits (see below).
+
+#define CONSTK 255
+#define CONSTC 19
+
+
+// Micro25519 will use optimized Assembly implementations of the performance-
+// critical MPI and field arithmetic if `M25519_USE_ASM` is defined, provided
+// that the target architecture is either AVR8, MSP430, ARMv7-M, or RV32IM. If
+// this is not the case, or when `M25519_USE_ASM` is not defined, the ordinary
+// C implementation of the MPI and field arithmetic will be used.
+
+// #define M25519_USE_ASM
+
+
+// Micro25519 will use a 64-bit C implementation of the performance-critical
+// field arithmetic (based on a radix-$2^{51}$ representation with 128-bit
+// products) if `M25519_USE_HOST64` is defined, provided that the target is
+// a 64-bit "host-class" processor (x86-64 or AArch64) and the compiler
+// supports the type `unsigned __int128`. The field-elements are stored in
+// the same Word-arrays as on 32-bit targets (i.e., the API does not change)
+// and are converted to five 51-bit limbs inside the multiplication and
+// squaring. This option has no effect when Assembly code is used.
+
+// #define M25519_USE_HOST64
+
+
+// Micro25519 will use SIMD implementations of the four-way parallel field
+// arithmetic in `gfparith4.c` if `M25519_USE_SIMD` is defined, provided that
+// the target is an x86-64 processor with AVX2 extension or an ARM processor
+// with NEON extension (and the compiler has been invoked with the respective
+// options, e.g., `-mavx2`). Otherwise, the four-way operations are executed
+// (lane after lane) by ordinary C code. This option neither affects the API
+// nor the scalar field arithmetic.
+
+// #define M25519_USE_SIMD
+
+
+// Micro25519 will use Variable-Length Arrays (VLAs) for temporary/intermediate
+// operands if `M25519_USE_VLA` is defined and the length of these operands is
+// not known or not fixed at compile time. If `M25519_USE_VLA` is not defined,
+// static arrays of a certain maximum length will be used.
+
+// #define M25519_USE_VLA
+
+
+// Micro25519 uses a product-scanning (Comba) implementation of the C functions
+// `gfp_mul` and `gfp_sqr` with integrated first reduction step if the macro
+// `M25519_COMBA_MUL` is defined. This variant only needs an 8-word temporary
+// array on the stack instead of a 16-word array for the full product, which
+// is intended to reduce the RAM footprint on 8/16-bit microcontrollers.
+// Otherwise, the operand-scanning implementation is used. Note that neither
+// the stack usage nor the execution time of this variant has been measured on
+// an 8/16-bit target (e.g., AVR or MSP430) yet; on an x86-64 host, its
+// `gfp_sqr` was slower (120 vs. 86 cycles) and had a larger stack frame (144
+// vs. 96 bytes) than the operand-scanning version, see `doc/api/gfparith.md`.
+// This option has no effect when Assembly code or the 64-bit C implementation
+// is used.
+
+// #define M25519_COMBA_MUL
+
+
+// Micro25519 uses fully unrolled C implementations of the field operations
+// `gfp_add`, `gfp_sub`, `gfp_cneg`, `gfp_hlv`, `gfp_mul`, `gfp_sqr`, and
+// `gfp_mul32` if the macro `M25519_C_UNROLLED` is defined. These variants are
+// specialized for `LEN` = 8 and allow compilers to keep operands in registers
+// and to generate branch-free carry chains, which makes them faster than the
+// rolled versions on targets without Assembly code (at the expense of a
+// larger code size). `M25519_COMBA_MUL` has no effect when this option is
+// set. This option has no effect when Assembly code or the 64-bit C
+// implementation is used.
+
+// #define M25519_C_UNROLLED
+
+
+// Micro25519 converts the byte arrays of the X25519 and Ed25519 API (keys,
+// points, signatures, and digests in little-Endian byte order) to Word-arrays
+// and vice versa with `memcpy` if `M25519_USE_LE_BYTES` is defined and the
+// target is little-Endian. Otherwise, or when the byte order of the target
+// can not be determined at compile time, every Word is assembled from four
+// bytes with shifts, which is independent of the endianness. The `memcpy`
+// does not impose any alignment requirements on the byte arrays, but it is
+// not necessarily faster (see `doc/api/x25519.md`), hence the option is
+// disabled by default.
+
+// #define M25519_USE_LE_BYTES
+
+
+// Micro25519 will use a constant-time inversion in GF(p) based on the divsteps
+// ("safegcd") algorithm of Bernstein and Yang if `M25519_SAFEGCD_INV` is
+// defined. Otherwise, the inversion is performed with the Extended Euclidean
+// Algorithm (EEA), which is faster but has an operand-dependent execution time
+// and, therefore, needs to be protected via multiplicative masking.
+
+// #define M25519_SAFEGCD_INV
+
+
+// Micro25519 counts how often the main field-arithmetic and MPI functions
+// (e.g., `gfp_mul`, `gfp_sqr`, `gfp_inv`, `mpi_sub`, `mpi_shr`) are executed,
+// as well as the number of iterations of the inversion, if `M25519_PROFILE`
+// is defined. The counters can be read and reset via the functions declared
+// in `profile.h`. When `M25519_PROFILE` is not defined, the counting code is
+// removed completely by the pre-processor, i.e., there is no overhead.
+
+// #define M25519_PROFILE
+
+
+// Micro25519 calls the performance-critical field-arithmetic functions (e.g.,
+// `gfp_mul`, `gfp_sqr`) via a table of function pointers if the macro
+// `M25519_USE_OPS_TABLE` is defined. This table can be filled at run time
+// with the fastest of the available implementations (C99, Assembly, or the
+// kernels of a crypto coprocessor provided by the application) by calling
+// `m25519_select_backend`, see `backend.h`, which allows one firmware image
+// to be used on different hardware. This option is ignored when the 64-bit C
+// implementation is used. When `M25519_USE_OPS_TABLE` is not defined, the
+// functions are bound at compile time (i.e., there is no overhead).
+
+// #define M25519_USE_OPS_TABLE
+
+
+// The fixed-base scalar multiplication on Edwards25519 uses a comb method with
+// `M25519_COMB_TEETH` teeth and `M25519_COMB_TABLES` tables of pre-computed
+// points. Each table contains $2^{TEETH-1}$ points of 96 bytes, and a scalar
+// multiplication requires about $254/(TEETH \cdot TABLES)$ point doublings and
+// $254/TEETH$ mixed additions. The default (four teeth, one table) occupies
+// 768 bytes of flash. The table in `tedcomb.h` must be re-generated with the
+// script `test/gentbl_ted_comb.py` when one of these values is changed.
+
+#ifndef M25519_COMB_TEETH
+#define M25519_COMB_TEETH 4
+#endif
+#ifndef M25519_COMB_TABLES
+#define M25519_COMB_TABLES 1
+#endif
+
+
+// The variable-base scalar multiplication `ted_mul_varbase` (signed fixed
+// windows, constant time) and the double-base scalar multiplication used for
+// the verification of signatures (interleaved wNAF, variable time) compute a
+// table of $2^{W-2}$ odd multiples $P, 3P, \ldots$ of each base point on the
+// stack, with $W$ = `M25519_TED_WINDOW` in the range [3, 7]. Every point takes
+// 160 bytes, i.e., the tables occupy $160 \cdot 2^{W-2}$ bytes of RAM for
+// `ted_mul_varbase` and twice as much for the verification. The default ($W =
+// 4$) needs 640 and 1280 bytes, and increasing $W$ by 1 doubles the RAM but
+// saves about 20% of the point additions.
+
+#ifndef M25519_TED_WINDOW
+#define M25519_TED_WINDOW 4
+#endif
+
+
+// On dual-core microcontrollers (e.g., RP2040, ESP32, or STM32H7 dual-core),
+// the double-base scalar multiplication $l G + k P$ used for the verification
+// of signatures can be split into two independent scalar multiplications, and
+// the fixed-base comb method into two halves of the tables, which are then
+// executed in parallel on the two cores. When `M25519_DUAL_CORE` is defined,
+// the platform can register a hook for running a job on the second core with
+// `ted_set_core1` (see `tedcurve.h`); as long as no hook is registered, all
+// scalar multiplications are executed on the calling core as usual. The comb
+// method is only split when `M25519_COMB_TABLES` is at least 2.
+
+// #define M25519_DUAL_CORE
+
+
+// When Micro25519 is compiled for one of the five target architectures that
+// are supported with optimized Assembly code (AVR8, MSP430, ARMv6-M, ARMv7-M,
+// RV32IM) and `M25519_USE_ASM` is defined, then the Assembly implementation of
+// the performance-critical field/integer arithmetic is used. On RV32 cores
+// that support the bit-manipulation extensions Zba and Zbs (i.e., when the
+// compiler is invoked with, e.g., `-march=rv32imc_zba_zbb_zbs`), the RISC-V
+// Assembly files use alternative versions of some macros with `sh1add`,
+// `sh3add`, and `bclri`, which is indicated by `M25519_TARGET` = `RV32IMB`.
+// ARMv6-M (Cortex-M0/M0+) has to be checked before the other ARM processors
+// since it only supports the Thumb-1 instruction set and a 32-bit `muls`.
+// The RV32 backend provides some additional Assembly functions (e.g., the
+// non-reducing addition/subtraction, the repeated squaring, the divsteps, and
+// the order arithmetic of Edwards25519), which is indicated by the macro
+// `M25519_ASSEMBLY_EXT`; on all other targets, the C versions are used.
+
+#if defined(M25519_USE_ASM)
+#if (defined(__AVR) || defined(__AVR__))
+#define M25519_TARGET AVR8BIT
+#define M25519_ASSEMBLY
+#elif (defined(__MSP430__) || defined(__ICC430__))
+#define M25519_TARGET MSP430
+#define M25519_ASSEMBLY
+#elif (defined(__ARM_ARCH_6M__) || (defined(__ARM_ARCH_PROFILE) && \
+  (__ARM_ARCH_PROFILE == 'M') && (__ARM_ARCH == 6)))
+#define M25519_TARGET ARMV6M
+#define M25519_ASSEMBLY
+#elif (defined(__arm__) || defined(_M_ARM))
+#define M25519_TARGET ARMV7M
+#define M25519_ASSEMBLY
+#elif (defined(__riscv) && (__riscv_xlen == 32))
+#if (defined(__riscv_zba) && defined(__riscv_zbs))
+#define M25519_TARGET RV32IMB
+#else
+#define M25519_TARGET RV32IM
+#endif
+#define M25519_ASSEMBLY
+#define M25519_ASSEMBLY_EXT
+#endif // #if (defined(__AVR) || ...
+#endif // #if defined(M25519_USE_ASM)
+
+
+// When Micro25519 is compiled for a 64-bit host-class processor (x86-64 or
+// AArch64) and `M25519_USE_HOST64` is defined, then the 64-bit C implementation
+// of the performance-critical field arithmetic (in `host64/gfparith51.c`) is
+// used instead of the generic 32-bit C implementation.
+
+#if (defined(M25519_USE_HOST64) && !defined(M25519_ASSEMBLY))
+#if defined(__SIZEOF_INT128__)
+#if (defined(__x86_64__) || defined(_M_X64))
+#define M25519_TARGET X86_64
+#define M25519_HOST64
+#elif (defined(__aarch64__) || defined(_M_ARM64))
+#define M25519_TARGET AARCH64
+#define M25519_HOST64
+#endif // #if (defined(__x86_64__) || ...
+#endif // #if defined(__SIZEOF_INT128__)
+#endif // #if (defined(M25519_USE_HOST64) && ...
+
+
+// When `M25519_USE_OPS_TABLE` is defined and the 64-bit C implementation is
+// not used, then the performance-critical field arithmetic is called via the
+// table of function pointers `m25519_ops` (in `backend.c`), which initially
+// contains the Assembly functions (if available) or the C functions.
+
+#if (defined(M25519_USE_OPS_TABLE) && !defined(M25519_HOST64))
+#define M25519_OPSTBL
+#endif
+
+
+// When Micro25519 is compiled for a processor with a supported SIMD extension
+// (AVX2 or NEON) and `M25519_USE_SIMD` is defined, then the SIMD version of
+// the four-way parallel field arithmetic (in `simd/gfparith4_avx2.c` or in
+// `simd/gfparith4_neon.c`) is used instead of the C version in `gfparith4.c`.
+
+#if defined(M25519_USE_SIMD)
+#if defined(__AVX2__)
+#define M25519_SIMDEXT AVX2
+#define M25519_SIMD
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define M25519_SIMDEXT NEON
+#define M25519_SIMD
+#endif // #if defined(__AVX2__) ...
+#endif // #if defined(M25519_USE_SIMD)
+
+
+// When `M25519_USE_LE_BYTES` is defined and the target is little-Endian, which
+// is determined from `__BYTE_ORDER__` (GCC and Clang) or from the pre-defined
+// macros of other compilers for the supported architectures, then the byte
+// arrays of the API are converted with `memcpy` (see `x25519.c` and
+// `ed25519.c`).
+
+#if defined(M25519_USE_LE_BYTES)
+#if defined(__BYTE_ORDER__)
+#if (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define M25519_LEBYTES
+#endif
+#elif (defined(__AVR) || defined(__AVR__) || defined(__MSP430__) || \
+  defined(__ICC430__) || defined(__riscv) || defined(_M_IX86) || \
+  defined(_M_X64) || defined(_M_ARM) || defined(_M_ARM64))
+#define M25519_LEBYTES
+#elif defined(__ICCARM__)
+#if (__LITTLE_ENDIAN__ == 1)
+#define M25519_LEBYTES
+#endif
+#elif defined(__arm__)
+#if (!defined(__ARM_BIG_ENDIAN) && !defined(__BIG_ENDIAN))
+#define M25519_LEBYTES
+#endif
+#endif // #if defined(__BYTE_ORDER__) ...
+#endif // #if defined(M25519_USE_LE_BYTES)
+
+
+//#ifndef NDEBUG
+#define M25519_DBG_PRINT
+//#endif
+
+
+// Error codes
+
+#define M25519_NO_ERROR   0
+#define M25519_ERR_HEXSTR 1
+#define M25519_ERR_INVERS 2
+#define M25519_ERR_MPOINT 4
+#define M25519_ERR_TPOINT 8
+#define M25519_ERR_SCALAR 16
+#define M25519_ERR_TVFILE 32
+#define M25519_ERR_DECOMP 64
+#define M25519_ERR_SIGVER 128
+#define M25519_ERR_BACKEND 256
+#define M25519_ERR_POOLEMPTY 512
+#define M25519_ERR_STREAM 1024
+
+
+// `Word` is the basic data type used to represent a multiple-precision integer
+// or an element of a prime field.
+
+typedef uint32_t Word;     // a single-length word is 32 bits long
+typedef uint64_t DWord;    // a double-length word is 64 bits long
+typedef int64_t SDWord;    // a signed double-length word is 64 bits long
+#define WSIZE 32           // the word-size is 32 bits
+
+
+// `Byte` is the data type of byte-arrays like keys, shared secrets, digests,
+// or signatures, which are passed to the high-level X25519/Ed25519 functions.
+
+typedef unsigned char Byte;
+
+
+// An element of the prime field GF(p) with $p = 2^k - c$ is stored in a Word-
+// array consisting of `LEN` Words.
+
+#define LEN ((CONSTK + WSIZE - 1)/WSIZE)
+
+
+// `Point` is a simple but highly flexible C structure to represent a point on
+// an elliptic curve in affine, projective, or extended projective coordinates.
+// Other ECC libraries use different data structures for affine and projective
+// points, commonly a `struct` with two or three fixed-length `Word` arrays for
+// the coordinates, but a `struct` composed of an integer specifying the number
+// of coordinates (i.e., the dimension of the point) and a pointer to a single
+// `Word` array containing all coordinates offers more flexibility when curves
+// and fields of varying order have to be supported. Typical use cases for the
+// different dimensions are as follows:
+// dim = 1: x-coordinate only (e.g., X25519 key exchange)
+// dim = 2: conventional affine (x,y) or projective [X:Z] coordinate system
+// dim = 3: projective [X:Y:Z] or extended affine (u,v,w) coordinate system
+// dim = 4: same as dim = 3, but with further space for an intermediate result
+// dim = 5: extended projective [X:Y:Z:E:H] coordinate system (where E*H = T)
+// dim = 6: same as dim = 5, but with further space for an intermediate result
+
+typedef struct point {
+  int dim;    // dimension: 1 <= dim <= 6
+  Word *xyz;  // pointer to coordinates-array
+} Point;
+
+
+// `ECDomPar` is a C structure that combines the domain parameters of the two
+// curve models (Montgomery and TED) and various curve-dependent constants so
+// that they are accessible from one place. All arrays are placed in non-
+// volatile memory (i.e., flash) to reduce the RAM footprint.
+
+typedef struct ecdompar {  // elliptic curve domain parameters
+  const int k;      // bitlength of the prime ($k = 255$)
+  const Word c;     // constant $c = 19$ defining the prime $p = 2^k - c$
+  const Word *a24;  // constant $(A+2)/4 = 121666$ of the Montgomery curve
+  const Word *dte;  // parameter $d$ of corresponding TED curve with $a = -1$
+  const Word *rma;  // root of $-a = -(A+2)/B$ for point-mappings MON <-> TED
+  const Word *rm1;  // root of $-1$ ($2^{(p-1)/4} \bmod p$) for decompression
+  const Word *car;  // cardinality of elliptic-curve group ($8 \cdot \ell$)
+  const Word *cbr;  // constant for Barrett reduction modulo the cardinality
+  const Word *tbl;  // table of pre-computed points for fixed-base comb method
+} ECDomPar;
+
+
+#endif  // _CONFIG_H
+
+///////////////////////////////////////////////////////////////////////////////
+// src/profile.h                                                             //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+#ifndef _PROFILE_H
+#define _PROFILE_H
+
+
+// Indices of the operation counters; the counter `GFP_INV_ITER` counts the
+// iterations of the outer loop of the EEA-based inversion (or the batches of
+// divsteps when `M25519_SAFEGCD_INV` is defined)
+
+#define M25519_PROF_GFP_ADD          0
+#define M25519_PROF_GFP_ADD_NR       1
+#define M25519_PROF_GFP_SUB          2
+#define M25519_PROF_GFP_SUB_NR       3
+#define M25519_PROF_GFP_CNEG         4
+#define M25519_PROF_GFP_HLV          5
+#define M25519_PROF_GFP_MUL          6
+#define M25519_PROF_GFP_MUL32        7
+#define M25519_PROF_GFP_SQR          8
+#define M25519_PROF_GFP_SQRN         9
+#define M25519_PROF_GFP_INV         10
+#define M25519_PROF_GFP_INV_ITER    11
+#define M25519_PROF_MPI_SUB         12
+#define M25519_PROF_MPI_SHR         13
+#define M25519_PROF_MPI_DIVSTEPS    14
+#define M25519_PROF_MON_LADDER_STEP 15
+#define M25519_PROF_MPI_MUL8        16
+#define M25519_PROF_MPI_MUL9        17
+#define M25519_PROF_MPI_SELECT      18
+#define M25519_PROF_NUM             19
+
+// When `M25519_PROFILE` is defined, `M25519_PROF_INC` increments a counter,
+// `M25519_PROF_ADD` adds a non-negative value to a counter, and the macro
+// `M25519_PROF_CALL` increments a counter before executing a function call
+// (used to wrap the mapping of functions to their ASM versions). The macro
+// `M25519_PROF_KINC` is used by the C kernels that can be installed in the
+// ops table (see `backend.h`); in ops-table mode, it vanishes since the calls
+// are then counted by the macros in `gfparith.h`. When `M25519_PROFILE` is
+// not defined, these macros vanish without any overhead.
+
+#if defined(M25519_PROFILE)
+extern uint32_t m25519_prof_cnt[M25519_PROF_NUM];
+#define M25519_PROF_INC(id) ((void) m25519_prof_cnt[M25519_PROF_##id]++)
+#define M25519_PROF_ADD(id, k) \
+  ((void) (m25519_prof_cnt[M25519_PROF_##id] += (((k) > 0) ? (k) : 0)))
+#define M25519_PROF_CALL(id, call) (M25519_PROF_INC(id), (call))
+#if defined(M25519_OPSTBL)
+#define M25519_PROF_KINC(id) ((void) 0)
+#else
+#define M25519_PROF_KINC(id) M25519_PROF_INC(id)
+#endif
+#else
+#define M25519_PROF_INC(id) ((void) 0)
+#define M25519_PROF_ADD(id, k) ((void) 0)
+#define M25519_PROF_CALL(id, call) (call)
+#define M25519_PROF_KINC(id) ((void) 0)
+#endif
+
+// prototypes of functions with C implementations only
+#if defined(M25519_PROFILE)
+uint32_t m25519_prof_get(int id);
+const char *m25519_prof_name(int id);
+void m25519_prof_reset(void);
+#endif
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// src/backend.h                                                             //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+#ifndef _BACKEND_H
+#define _BACKEND_H
+
+
+// `ArithOps` is a table of pointers to the seven performance-critical field-
+// arithmetic functions ("kernels") of a backend. When `M25519_USE_OPS_TABLE`
+// is defined, the macros `gfp_add`, `gfp_mul`, etc. in `gfparith.h` call the
+// kernels via the global table `m25519_ops`, whose entries can be replaced at
+// run time. A backend provided by the application (e.g., a driver for a crypto
+// coprocessor) may leave entries NULL, which are then not replaced. All other
+// functions (e.g., `gfp_add_nr`, `gfp_inv`, and the MPI arithmetic) are still
+// bound at compile time.
+
+#if defined(M25519_OPSTBL)
+
+typedef struct arithops {
+  const char *name;  // name of the backend (e.g., "c99" or "asm")
+  void (*add)(Word *r, const Word *a, const Word *b);
+  void (*sub)(Word *r, const Word *a, const Word *b);
+  void (*cneg)(Word *r, const Word *a, int neg);
+  void (*hlv)(Word *r, const Word *a);
+  void (*mul)(Word *r, const Word *a, const Word *b);
+  void (*mul32)(Word *r, const Word *a, const Word *b);
+  void (*sqr)(Word *r, const Word *a);
+} ArithOps;
+
+// indices of the kernels (e.g., for `m25519_backend_name`)
+#define M25519_KRN_ADD   0
+#define M25519_KRN_SUB   1
+#define M25519_KRN_CNEG  2
+#define M25519_KRN_HLV   3
+#define M25519_KRN_MUL   4
+#define M25519_KRN_MUL32 5
+#define M25519_KRN_SQR   6
+#define M25519_KRN_NUM   7
+
+// the installed kernels and the built-in backends
+extern ArithOps m25519_ops;
+extern const ArithOps m25519_ops_c99;
+#if defined(M25519_ASSEMBLY)
+extern const ArithOps m25519_ops_asm;
+#endif
+
+// prototypes of functions with C implementations only
+int m25519_set_backend(const ArithOps *ops);
+int m25519_select_backend(const ArithOps *const *list, int num, \
+  uint32_t (*timer)(void));
+const char *m25519_backend_name(int kernel);
+
+#endif
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// src/mpiarith.h                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _MPIARITH_H
+#define _MPIARITH_H
+
+
+// utility functions (only in C)
+int  mpi_from_hex(Word *r, const char *hexstr, int len);
+void mpi_to_hex(char *hexstr, const Word *a, int len);
+void mpi_print(const char *prefix, const Word *a, int len);
+void mpi_copy(Word *r, const Word *a, int len);
+void mpi_setw(Word *r, Word a, int len);
+int  mpi_cmpw(const Word *a, Word b, int len);
+int  mpi_cmp(const Word *a, const Word *b, int len);
+
+// arithmetic functions with C implementations only
+int  mpi_add(Word *r, const Word *a, const Word *b, int len);
+int  mpi_cadd(Word *r, const Word *a, const Word *b, int add, int len);
+void mpi_mul(Word *r, const Word *a, const Word *b, int len);
+
+// arithmetic functions with C and ASM implementations
+#if defined(M25519_ASSEMBLY)  // ASM functions are available
+extern int mpi_shr_asm(Word *r, const Word *a, int len);
+#define mpi_shr(r, a, len) \
+  M25519_PROF_CALL(MPI_SHR, mpi_shr_asm((r), (a), (len)))
+extern int mpi_sub_asm(Word *r, const Word *a, const Word *b, int len);
+#define mpi_sub(r, a, b, len) \
+  M25519_PROF_CALL(MPI_SUB, mpi_sub_asm((r), (a), (b), (len)))
+#else  // ASM functions are not available or not used
+int mpi_shr(Word *r, const Word *a, int len);
+int mpi_sub(Word *r, const Word *a, const Word *b, int len);
+#endif
+#if defined(M25519_ASSEMBLY_EXT)  // additional ASM functions are available
+extern int mpi_divsteps_asm(Word *t, Word f0, Word g0, int zeta);
+#define mpi_divsteps(t, f0, g0, zeta) \
+  M25519_PROF_CALL(MPI_DIVSTEPS, mpi_divsteps_asm((t), (f0), (g0), (zeta)))
+extern void mpi_mul8_asm(Word *r, const Word *a, const Word *b);
+#define mpi_mul8(r, a, b) \
+  M25519_PROF_CALL(MPI_MUL8, mpi_mul8_asm((r), (a), (b)))
+extern void mpi_mul9_asm(Word *r, const Word *a, const Word *b);
+#define mpi_mul9(r, a, b) \
+  M25519_PROF_CALL(MPI_MUL9, mpi_mul9_asm((r), (a), (b)))
+extern void mpi_select_asm(Word *r, const Word *tbl, int idx, int num, \
+  int len);
+#define mpi_select(r, tbl, idx, num, len) \
+  M25519_PROF_CALL(MPI_SELECT, mpi_select_asm((r), (tbl), (idx), (num), (len)))
+#else  // additional ASM functions are not available or not used
+int mpi_divsteps(Word *t, Word f0, Word g0, int zeta);
+void mpi_mul8(Word *r, const Word *a, const Word *b);
+void mpi_mul9(Word *r, const Word *a, const Word *b);
+void mpi_select(Word *r, const Word *tbl, int idx, int num, int len);
+#endif
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// src/gfparith.h                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _GFPARITH_H
+#define _GFPARITH_H
+
+
+// prototypes of functions with C implementations only
+void gfp_setp(Word *r);
+int  gfp_cmpp(const Word *a);
+void gfp_fred(Word *r, const Word *a);
+int  gfp_cmp(const Word *a, const Word *b);
+void gfp_cswap(Word *a, Word *b, int swap);
+int  gfp_inv(Word *r, const Word *a);
+int  gfp_inv_batch(Word *r, const Word *a, int n, Word *scratch);
+
+// prototypes of functions with C and ASM implementations
+#if defined(M25519_OPSTBL)  // kernels are called via the ops table
+void gfp_add(Word *r, const Word *a, const Word *b);
+void gfp_cneg(Word *r, const Word *a, int neg);
+void gfp_hlv(Word *r, const Word *a);
+void gfp_mul(Word *r, const Word *a, const Word *b);
+void gfp_mul32(Word *r, const Word *a, const Word *b);
+void gfp_sqr(Word *r, const Word *a);
+void gfp_sqrn(Word *r, const Word *a, int n);
+void gfp_sub(Word *r, const Word *a, const Word *b);
+#define gfp_add(r, a, b) \
+  M25519_PROF_CALL(GFP_ADD, m25519_ops.add((r), (a), (b)))
+#define gfp_cneg(r, a, neg) \
+  M25519_PROF_CALL(GFP_CNEG, m25519_ops.cneg((r), (a), (neg)))
+#define gfp_hlv(r, a) \
+  M25519_PROF_CALL(GFP_HLV, m25519_ops.hlv((r), (a)))
+#define gfp_mul(r, a, b) \
+  M25519_PROF_CALL(GFP_MUL, m25519_ops.mul((r), (a), (b)))
+#define gfp_mul32(r, a, b) \
+  M25519_PROF_CALL(GFP_MUL32, m25519_ops.mul32((r), (a), (b)))
+#define gfp_sqr(r, a) \
+  M25519_PROF_CALL(GFP_SQR, m25519_ops.sqr((r), (a)))
+#define gfp_sub(r, a, b) \
+  M25519_PROF_CALL(GFP_SUB, m25519_ops.sub((r), (a), (b)))
+#if defined(M25519_ASSEMBLY)  // ASM kernels for the ops table are available
+extern void gfp_add_asm(Word *r, const Word *a, const Word *b);
+extern void gfp_cneg_asm(Word *r, const Word *a, int neg);
+extern void gfp_hlv_asm(Word *r, const Word *a);
+extern void gfp_mul_asm(Word *r, const Word *a, const Word *b);
+extern void gfp_mul32_asm(Word *r, const Word *a, const Word *b);
+extern void gfp_sqr_asm(Word *r, const Word *a);
+extern void gfp_sub_asm(Word *r, const Word *a, const Word *b);
+#endif
+#if defined(M25519_ASSEMBLY_EXT)  // additional ASM functions are available
+extern void gfp_add_nr_asm(Word *r, const Word *a, const Word *b);
+#define gfp_add_nr(r, a, b) \
+  M25519_PROF_CALL(GFP_ADD_NR, gfp_add_nr_asm((r), (a), (b)))
+extern void gfp_sub_nr_asm(Word *r, const Word *a, const Word *b);
+#define gfp_sub_nr(r, a, b) \
+  M25519_PROF_CALL(GFP_SUB_NR, gfp_sub_nr_asm((r), (a), (b)))
+#else
+void gfp_add_nr(Word *r, const Word *a, const Word *b);
+void gfp_sub_nr(Word *r, const Word *a, const Word *b);
+#endif
+#elif defined(M25519_ASSEMBLY)  // ASM functions are available
+extern void gfp_add_asm(Word *r, const Word *a, const Word *b);
+#define gfp_add(r, a, b) \
+  M25519_PROF_CALL(GFP_ADD, gfp_add_asm((r), (a), (b)))
+extern void gfp_cneg_asm(Word *r, const Word *a, int neg);
+#define gfp_cneg(r, a, neg) \
+  M25519_PROF_CALL(GFP_CNEG, gfp_cneg_asm((r), (a), (neg)))
+extern void gfp_hlv_asm(Word *r, const Word *a);
+#define gfp_hlv(r, a) \
+  M25519_PROF_CALL(GFP_HLV, gfp_hlv_asm((r), (a)))
+extern void gfp_mul_asm(Word *r, const Word *a, const Word *b);
+#define gfp_mul(r, a, b) \
+  M25519_PROF_CALL(GFP_MUL, gfp_mul_asm((r), (a), (b)))
+extern void gfp_mul32_asm(Word *r, const Word *a, const Word *b);
+#define gfp_mul32(r, a, b) \
+  M25519_PROF_CALL(GFP_MUL32, gfp_mul32_asm((r), (a), (b)))
+extern void gfp_sqr_asm(Word *r, const Word *a);
+#define gfp_sqr(r, a) \
+  M25519_PROF_CALL(GFP_SQR, gfp_sqr_asm((r), (a)))
+extern void gfp_sub_asm(Word *r, const Word *a, const Word *b);
+#define gfp_sub(r, a, b) \
+  M25519_PROF_CALL(GFP_SUB, gfp_sub_asm((r), (a), (b)))
+#if defined(M25519_ASSEMBLY_EXT)  // additional ASM functions are available
+extern void gfp_add_nr_asm(Word *r, const Word *a, const Word *b);
+#define gfp_add_nr(r, a, b) \
+  M25519_PROF_CALL(GFP_ADD_NR, gfp_add_nr_asm((r), (a), (b)))
+extern void gfp_sqrn_asm(Word *r, const Word *a, int n);
+#define gfp_sqrn(r, a, n) (M25519_PROF_ADD(GFP_SQR, (n)), \
+  M25519_PROF_CALL(GFP_SQRN, gfp_sqrn_asm((r), (a), (n))))
+extern void gfp_sub_nr_asm(Word *r, const Word *a, const Word *b);
+#define gfp_sub_nr(r, a, b) \
+  M25519_PROF_CALL(GFP_SUB_NR, gfp_sub_nr_asm((r), (a), (b)))
+#else
+void gfp_add_nr(Word *r, const Word *a, const Word *b);
+void gfp_sqrn(Word *r, const Word *a, int n);
+void gfp_sub_nr(Word *r, const Word *a, const Word *b);
+#endif
+#else  // ASM functions are not available or not used
+void gfp_add(Word *r, const Word *a, const Word *b);
+void gfp_add_nr(Word *r, const Word *a, const Word *b);
+void gfp_cneg(Word *r, const Word *a, int neg);
+void gfp_hlv(Word *r, const Word *a);
+void gfp_mul(Word *r, const Word *a, const Word *b);
+void gfp_mul32(Word *r, const Word *a, const Word *b);
+void gfp_sqr(Word *r, const Word *a);
+void gfp_sqrn(Word *r, const Word *a, int n);
+void gfp_sub(Word *r, const Word *a, const Word *b);
+void gfp_sub_nr(Word *r, const Word *a, const Word *b);
+#endif
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// src/gfparith4.h                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _GFPARITH4_H
+#define _GFPARITH4_H
+
+
+// A vector of four field-elements consists of `LEN4` Words: ten limbs in
+// radix $2^{25.5}$ per element, stored lane-interleaved, i.e., a[4*i+j] is
+// the i-th limb of the field-element in lane j.
+
+#define NUMLANES 4
+#define NUMLIMBS 10
+#define LEN4 (NUMLANES*NUMLIMBS)
+
+// prototypes of functions with C implementations only
+void gfp4_pack(Word *r, const Word *a);
+void gfp4_unpack(Word *r, const Word *a);
+void gfp4_cswap(Word *a, Word *b, int swap);
+
+// prototypes of functions with C and SIMD implementations
+void gfp4_add(Word *r, const Word *a, const Word *b);
+void gfp4_cneg(Word *r, const Word *a, int neg);
+void gfp4_mul(Word *r, const Word *a, const Word *b);
+void gfp4_mul32(Word *r, const Word *a, const Word *b);
+void gfp4_sqr(Word *r, const Word *a);
+void gfp4_sub(Word *r, const Word *a, const Word *b);
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// src/moncurve.h                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _MONCURVE_H
+#define _MONCURVE_H
+
+
+// prototypes of functions with C implementations only
+void mon_ladder_step4(Word *xz, const Word *xd, const Word *a24, int swap);
+int  mon_conv_p2a_batch(Point *r, const Point *p, int n, Word *scratch, \
+  const ECDomPar *d);
+
+// prototypes of functions with C and ASM implementations; when profiling, the
+// field-operations fused in the ASM version of `mon_ladder_step` are counted
+// like those of the C version (4 additions, 4 subtractions, 5 multiplications,
+// 4 squarings, and one multiplication by a 32-bit constant)
+#if (defined(M25519_ASSEMBLY_EXT) && !defined(M25519_OPSTBL))  // ASM is used
+extern void mon_ladder_step_asm(Word *xz, const Word *xd, const Word *a24, \
+  int swap);
+#define mon_ladder_step(xz, xd, a24, swap) (M25519_PROF_ADD(GFP_ADD, 4), \
+  M25519_PROF_ADD(GFP_SUB, 4), M25519_PROF_ADD(GFP_MUL, 5), \
+  M25519_PROF_ADD(GFP_SQR, 4), M25519_PROF_ADD(GFP_MUL32, 1), \
+  M25519_PROF_CALL(MON_LADDER_STEP, \
+  mon_ladder_step_asm((xz), (xd), (a24), (swap))))
+#else  // ASM functions are not available or not used
+void mon_ladder_step(Word *xz, const Word *xd, const Word *a24, int swap);
+#endif
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// src/tedcurve.h                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _TEDCURVE_H
+#define _TEDCURVE_H
+
+
+// Maximum number of points (and scalars) that can be processed by a single
+// call of the multi-scalar multiplication `ted_mul_multi`
+
+#define TED_MAXMULTI 65
+
+// Number of points per table and spacing of the teeth of the fixed-base comb
+// method (see `M25519_COMB_TEETH` and `M25519_COMB_TABLES` in `config.h`)
+
+#define TED_COMBSIZE (1 << (M25519_COMB_TEETH - 1))
+#define TED_COMBSPACE ((254 + M25519_COMB_TEETH*M25519_COMB_TABLES - 1)/ \
+  (M25519_COMB_TEETH*M25519_COMB_TABLES))
+
+// Number of Words of a complete comb table (all sub-tables)
+
+#define TED_COMBWORDS (M25519_COMB_TABLES*TED_COMBSIZE*3*LEN)
+
+// Number of odd multiples per table of the window methods used by the
+// variable-base and double-base scalar multiplication (see `M25519_TED_WINDOW`
+// in `config.h`)
+
+#define TED_WINSIZE (1 << (M25519_TED_WINDOW - 2))
+
+// Number of digits of the wNAF of a 256-bit scalar (at most one more digit
+// than the scalar has bits)
+
+#define TED_NAFLEN (WSIZE*LEN + 1)
+
+// Context of a resumable fixed-base scalar multiplication (see
+// `ted_mul_fixbase_init`): the current point and the recoded scalar of the
+// comb method. A context contains secret data and is wiped by
+// `ted_mul_fixbase_final`.
+
+typedef struct ted_fix_ctx {
+  Word xyz[6*LEN];  // current point in extended projective coordinates
+  Word m[LEN+1];    // recoded scalar (see `ted_comb_recode`)
+  int pos;          // next column of the comb, -1 when all are processed
+  int err;          // error code of the initialization
+} TedFixCtx;
+
+// Context of a resumable double-base scalar multiplication (see
+// `ted_mul_dblbase_init`): the current point, the tables of odd multiples
+// of $G$ and $-P$, and the wNAFs of both scalars.
+
+typedef struct ted_dbl_ctx {
+  Word xyz[6*LEN];                   // current point (extended projective)
+  Word tbl[2*TED_WINSIZE*5*LEN];     // odd multiples of G and -P
+  signed char naf[2][TED_NAFLEN];    // wNAFs of l and k
+  int pos;                           // next digit, -1 when all are processed
+  int rset;                          // 1 when current point is not O
+  int err;                           // error code of the initialization
+} TedDblCtx;
+
+// domain parameters and pre-computed constants of Curve25519/Edwards25519
+extern const ECDomPar ECDOMPAR25519;
+
+// generator of Edwards25519 in extended affine coordinates
+extern const Word TEDGENEA[3*LEN];
+
+#if defined(M25519_DUAL_CORE)
+// job executed on the second core of a dual-core microcontroller
+typedef void (*TedJob)(void *arg);
+// registration of the platform hook for running a job on the second core
+void ted_set_core1(void (*run)(TedJob job, void *arg), void (*wait)(void));
+#endif
+
+// prototypes of functions with C implementations only
+void ted_set0(Point *r);
+void ted_copy(Point *r, const Point *p);
+void ted_load_point(Point *r, const Word *tbl, int idx);
+void ted_load_point_ep(Point *r, const Word *tbl, int idx);
+void ted_conv_a2ea(Point *r, const Point *p, const ECDomPar *d);
+void ted_conv_ea2ep(Point *r, const Point *p);
+void ted_add(Point *r, const Point *p);
+void ted_add_ep(Point *r, const Point *p, const ECDomPar *d);
+void ted_double(Point *r);
+void ted_mul_combNb(Point *r, const Word *l, const ECDomPar *d);
+void ted_comb_table(Word *tbl, const Point *p, const ECDomPar *d);
+void ted_mul_dblbase_tbl(Point *r, const Word *l, const Word *k, \
+  const Word *tbl, const ECDomPar *d);
+int  ted_conv_p2a(Point *r, const Point *p, const ECDomPar *d);
+int  ted_conv_p2a_batch(Point *r, const Point *p, int n, Word *scratch, \
+  const ECDomPar *d);
+int  ted_mul_fixbase(Point *r, const Word *l, const ECDomPar *d);
+void ted_mul_multi(Point *r, const Word *k, const Point *p, int n, \
+  const ECDomPar *d);
+void ted_mul_dblbase_wnaf(Point *r, const Word *l, const Word *k, \
+  const Point *p, const ECDomPar *d);
+int  ted_mul_dblbase(Point *r, const Word *l, const Word *k, const Point *p, \
+  const ECDomPar *d);
+int  ted_mul_varbase(Point *r, const Word *k, const Point *p, \
+  const ECDomPar *d);
+int  ted_mul_fixbase_proj(Point *r, const Word *l, const ECDomPar *d);
+int  ted_mul_varbase_proj(Point *r, const Word *k, const Point *p, \
+  const ECDomPar *d);
+int  ted_mul_fixbase_init(TedFixCtx *ctx, const Word *l, const ECDomPar *d);
+int  ted_mul_fixbase_step(TedFixCtx *ctx, int n, const ECDomPar *d);
+int  ted_mul_fixbase_final(Point *r, TedFixCtx *ctx, const ECDomPar *d);
+int  ted_mul_dblbase_init(TedDblCtx *ctx, const Word *l, const Word *k, \
+  const Point *p, const ECDomPar *d);
+int  ted_mul_dblbase_step(TedDblCtx *ctx, int n, const ECDomPar *d);
+int  ted_mul_dblbase_final(Point *r, TedDblCtx *ctx, const ECDomPar *d);
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// src/x25519.h                                                              //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _X25519_H
+#define _X25519_H
+
+#include <stddef.h>
+
+// Context of SHA-512 (i.e., current state of the hash function) for an init-
+// update-final computation of the digest
+
+typedef struct sha512_ctx {
+  uint64_t hdig[8];   // current (i.e., intermediate) hash digest
+  uint64_t mbuf[16];  // buffer for a 128-byte block of the message
+  size_t length;      // overall length of hashed message (in bits)
+  int mbytes;         // number of bytes contained in mbuf-array
+} SHA512Ctx;
+
+// Maximum number of Montgomery ladders executed in lockstep (and number of
+// Z-coordinates inverted simultaneously) by `x25519_batch`
+
+#define X25519_MAXBATCH 16
+
+// Number of X25519 key-pairs that can be held by a key-pair pool (see
+// `x25519_pool_refill` and `x25519_pool_take`)
+
+#define X25519_POOLSIZE 4
+
+// Pool of pre-computed (ephemeral) X25519 key-pairs, which is organized as a
+// single-producer/single-consumer ring buffer. The read index `rd` is only
+// modified by `x25519_pool_take` and the write index `wr` only by
+// `x25519_pool_refill`. Both indices are kept modulo 2*X25519_POOLSIZE so that
+// a full and an empty pool can be told apart, and they are `volatile` since
+// the two functions may be executed in different contexts (see
+// `M25519_POOL_BARRIER` in `x25519.c`). Free slots are always all-0.
+
+typedef struct x25519_pool {
+  Byte sk[X25519_POOLSIZE][32];  // private keys (pruned)
+  Byte pk[X25519_POOLSIZE][32];  // public keys
+  volatile int rd;               // read index (oldest key-pair)
+  volatile int wr;               // write index (next free slot)
+} X25519Pool;
+
+// Context of a resumable computation of an X25519 shared secret (see
+// `x25519_init`): the coordinates $X_R, X_S, Z_R, Z_S$ of the Montgomery
+// ladder, the $x$-coordinate of the public key, and the pruned private key.
+// A context contains secret data and is wiped by `x25519_final`.
+
+typedef struct x25519_ctx {
+  Word xz[4*LEN];  // X_R, X_S, Z_R, Z_S
+  Word xd[LEN];    // x-coordinate of the public key
+  Word k[LEN];     // private key (pruned)
+  int pos;         // next bit of the private key, -1 when ladder is complete
+  int prev;        // previous bit of the private key (for the final swap)
+} X25519Ctx;
+
+// prototypes of functions with C implementations only
+void sha512_init(SHA512Ctx *ctx);
+void sha512_update(SHA512Ctx *ctx, const Byte *data, size_t dlen);
+void sha512_final(SHA512Ctx *ctx, Byte *digest);
+void sha512_hash(Byte *digest, const Byte *data, size_t dlen);
+int  x25519_batch(Byte *shared[], const Byte *sk[], const Byte *pk[], int n, \
+  int *err);
+void x25519_pool_init(X25519Pool *pool);
+int  x25519_pool_count(const X25519Pool *pool);
+int  x25519_pool_refill(X25519Pool *pool, const Byte *rbytes);
+int  x25519_pool_take(X25519Pool *pool, Byte *privkey, Byte *pubkey);
+void x25519_init(X25519Ctx *ctx, const Byte *sk, const Byte *pk);
+int  x25519_step(X25519Ctx *ctx, int n);
+int  x25519_final(Byte *shared, X25519Ctx *ctx);
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// src/ed25519.h                                                             //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _ED25519_H
+#define _ED25519_H
+
+#include <stddef.h>
+
+// Maximum number of signatures that are verified together (i.e., with a
+// single multi-scalar multiplication) by `ed25519_verify_batch`
+
+#define ED25519_MAXBATCH ((TED_MAXMULTI - 1)/2)
+
+// Number of Words of the scratch space that the caller of the batch
+// verification has to provide: the decoded points $-R_i$ and $-A_i$ (plus
+// the base point), the scalars of the multi-scalar multiplication, and the
+// values $s_i$ and $h_i$ of a group of `ED25519_MAXBATCH` signatures
+
+#define ED25519_BATCHWORDS ((2*ED25519_MAXBATCH + 1)*4*LEN + \
+  2*ED25519_MAXBATCH*LEN)
+
+// Verification context of a public key: the compressed public key $A$ (which
+// is hashed together with $R$ and the message) and the comb table of $-A$.
+// A context only contains constant data and can be placed in flash memory.
+
+typedef struct ed25519_vctx {
+  Byte pk[32];              // compressed public key
+  Word tbl[TED_COMBWORDS];  // comb table of -A (see `ted_comb_table`)
+} Ed25519VCtx;
+
+// Signing context of a private key: the expanded private key (i.e., the
+// pruned scalar $a$ and the prefix for the nonce) and the compressed public
+// key $A$. A context contains secret data and must be wiped with
+// `ed25519_sign_ctx_wipe` when it is not needed anymore. The serialized form
+// of a context (see `ed25519_sign_ctx_store`) has `ED25519_SCTXBYTES` bytes.
+
+typedef struct ed25519_sctx {
+  Word a[LEN];      // secret scalar (pruned)
+  Byte prefix[32];  // second half of the hashed private key
+  Byte pk[32];      // compressed public key
+} Ed25519SCtx;
+
+#define ED25519_SCTXBYTES 96
+
+// Context of an incremental (two-pass) signature generation: the message is
+// hashed in a first pass to get the nonce $r$ and in a second pass to get $h
+// = \mathrm{SHA512}(R \| A \| M)$. In the second pass, the hash of the first
+// pass is re-computed in `cctx` so that a modified message can be detected.
+
+typedef struct ed25519_sstream {
+  SHA512Ctx hctx;   // hash of nonce (1st pass) or of challenge (2nd pass)
+  SHA512Ctx cctx;   // re-computation of the nonce in the 2nd pass
+  Word a[LEN];      // secret scalar
+  Word r[LEN];      // nonce (modulo 8*l)
+  Byte prefix[32];  // second half of the hashed private key
+  Byte pk[32];      // compressed public key
+  Byte rc[32];      // compressed point R
+  int pass;         // current pass (1 or 2), 0 when not initialized
+} Ed25519SStream;
+
+// Context of an incremental (one-pass) signature verification: the decoded
+// points $-R$ and $-A$, the scalar $s$, and the hash of $R \| A \| M$.
+
+typedef struct ed25519_vstream {
+  SHA512Ctx hctx;   // hash of challenge
+  Word rn[3*LEN];   // point -R in extended affine coordinates
+  Word an[3*LEN];   // point -A in extended affine coordinates
+  Word s[LEN];      // scalar s of the signature
+  int err;          // error code of the decoding
+} Ed25519VStream;
+
+// prototypes of functions with C implementations only
+void gfp_exp_p58(Word *r, const Word *a);
+void ted_compress(Word *r, const Point *a);
+int  ted_compress_batch(Word *r, const Point *p, int n, Word *scratch);
+int  ted_decompress(Point *r, const Word *a, const ECDomPar *d);
+void ed25519_add_order(Word *r, const Word *a, const Word *b, \
+  const ECDomPar *d);
+void ed25519_fred_order(Word *r, const Word *a, const ECDomPar *d);
+int  ed25519_sign(Byte *signature, const Byte *message, size_t mlen, \
+  const Byte *keypair);
+int  ed25519_sign_ctx_init(Ed25519SCtx *ctx, const Byte *privkey, \
+  const Byte *pubkey);
+void ed25519_sign_ctx_wipe(Ed25519SCtx *ctx);
+void ed25519_sign_ctx_store(Byte *buf, const Ed25519SCtx *ctx);
+int  ed25519_sign_ctx_load(Ed25519SCtx *ctx, const Byte *buf);
+int  ed25519_sign_ctx(Byte *signature, const Byte *message, size_t mlen, \
+  const Ed25519SCtx *ctx);
+void ed25519_sign_init(Ed25519SStream *ctx, const Byte *keypair);
+void ed25519_sign_update(Ed25519SStream *ctx, const Byte *data, size_t dlen);
+int  ed25519_sign_commit(Ed25519SStream *ctx);
+int  ed25519_sign_final(Ed25519SStream *ctx, Byte *signature);
+int  ed25519_verify(const Byte *signature, const Byte *message, size_t mlen, \
+  const Byte *pubkey);
+void ed25519_verify_init(Ed25519VStream *ctx, const Byte *signature, \
+  const Byte *pubkey);
+void ed25519_verify_update(Ed25519VStream *ctx, const Byte *data, \
+  size_t dlen);
+int  ed25519_verify_final(Ed25519VStream *ctx);
+
+// prototypes of functions with C and ASM implementations (the ASM version of
+// `ed25519_mod_order` is specific to the group order of Edwards25519 and does
+// not use the domain parameters); when profiling, the ASM version is counted
+// like the C version, i.e., as two calls of `mpi_mul9` and three of `mpi_sub`
+#if defined(M25519_ASSEMBLY_EXT)  // ASM functions are available
+extern void ed25519_mod_order_asm(Word *r, const Word *a);
+#define ed25519_mod_order(r, a, d) ((void) (d), \
+  M25519_PROF_ADD(MPI_MUL9, 2), M25519_PROF_ADD(MPI_SUB, 3), \
+  ed25519_mod_order_asm((r), (a)))
+#else  // ASM functions are not available or not used
+void ed25519_mod_order(Word *r, const Word *a, const ECDomPar *d);
+#endif
+int  ed25519_verify_ctx_init(Ed25519VCtx *ctx, const Byte *pubkey);
+int  ed25519_verify_ctx(const Byte *signature, const Byte *message, \
+  size_t mlen, const Ed25519VCtx *ctx);
+int  ed25519_verify_batch(const Byte *sig[], const Byte *msg[], \
+  const size_t mlen[], const Byte *pk[], int n, int *err, Word *scratch);
+
+#endif
+
+#endif
@@ -0,0 +1,280 @@
+///////////////////////////////////////////////////////////////////////////////
+// backend.c: Run-time selection of the field-arithmetic kernels.            //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// The ops table `m25519_ops` is only available when `M25519_USE_OPS_TABLE` is
+// defined in `config.h` (and the 64-bit C implementation is not used). It is
+// initialized with the Assembly kernels when they are available for the target
+// architecture, and with the C kernels otherwise, so that Micro25519 can be
+// used without calling one of the functions below. A kernel is only installed
+// in the table after its results have been compared with those of the C kernel
+// for a pseudo-random operand. The table is a global variable, which means it
+// must not be changed while another thread or an interrupt handler executes a
+// field-arithmetic function.
+
+
+#include <stddef.h>
+#include "mpiarith.h"
+#include "gfparith.h"
+
+
+#if defined(M25519_OPSTBL)
+
+
+// Number of kernel calls per measurement and number of measurements per kernel
+// (the minimum of the measured values is taken)
+
+#define KRN_RUNS 8
+#define KRN_MEAS 3
+
+
+// Built-in backends and the ops table, which initially contains the Assembly
+// kernels (if available) or the C kernels
+
+const ArithOps m25519_ops_c99 = { "c99", gfp_add, gfp_sub, gfp_cneg, gfp_hlv, \
+  gfp_mul, gfp_mul32, gfp_sqr };
+
+#if defined(M25519_ASSEMBLY)
+const ArithOps m25519_ops_asm = { "asm", gfp_add_asm, gfp_sub_asm, \
+  gfp_cneg_asm, gfp_hlv_asm, gfp_mul_asm, gfp_mul32_asm, gfp_sqr_asm };
+ArithOps m25519_ops = { "asm", gfp_add_asm, gfp_sub_asm, gfp_cneg_asm, \
+  gfp_hlv_asm, gfp_mul_asm, gfp_mul32_asm, gfp_sqr_asm };
+#define DEFAULT_NAME "asm"
+#else
+ArithOps m25519_ops = { "c99", gfp_add, gfp_sub, gfp_cneg, gfp_hlv, gfp_mul, \
+  gfp_mul32, gfp_sqr };
+#define DEFAULT_NAME "c99"
+#endif
+
+// names of the backends from which the installed kernels originate
+static const char *m25519_krn_src[M25519_KRN_NUM] = { DEFAULT_NAME, \
+  DEFAULT_NAME, DEFAULT_NAME, DEFAULT_NAME, DEFAULT_NAME, DEFAULT_NAME, \
+  DEFAULT_NAME };
+
+
+// Helper functions to check whether a backend contains the kernel with index
+// `k`, to install this kernel in the ops table, and to execute it
+
+static int krn_avail(const ArithOps *ops, int k)
+{
+  switch (k) {
+    case M25519_KRN_ADD:   return (ops->add != NULL);
+    case M25519_KRN_SUB:   return (ops->sub != NULL);
+    case M25519_KRN_CNEG:  return (ops->cneg != NULL);
+    case M25519_KRN_HLV:   return (ops->hlv != NULL);
+    case M25519_KRN_MUL:   return (ops->mul != NULL);
+    case M25519_KRN_MUL32: return (ops->mul32 != NULL);
+    case M25519_KRN_SQR:   return (ops->sqr != NULL);
+  }
+  return 0;
+}
+
+
+static void krn_install(const ArithOps *ops, int k)
+{
+  switch (k) {
+    case M25519_KRN_ADD:   m25519_ops.add = ops->add; break;
+    case M25519_KRN_SUB:   m25519_ops.sub = ops->sub; break;
+    case M25519_KRN_CNEG:  m25519_ops.cneg = ops->cneg; break;
+    case M25519_KRN_HLV:   m25519_ops.hlv = ops->hlv; break;
+    case M25519_KRN_MUL:   m25519_ops.mul = ops->mul; break;
+    case M25519_KRN_MUL32: m25519_ops.mul32 = ops->mul32; break;
+    case M25519_KRN_SQR:   m25519_ops.sqr = ops->sqr; break;
+  }
+  m25519_krn_src[k] = (ops->name != NULL) ? ops->name : "unnamed";
+}
+
+
+static void krn_exec(const ArithOps *ops, int k, Word *r, const Word *a, \
+  const Word *b)
+{
+  switch (k) {
+    case M25519_KRN_ADD:   ops->add(r, a, b); break;
+    case M25519_KRN_SUB:   ops->sub(r, a, b); break;
+    case M25519_KRN_CNEG:  ops->cneg(r, a, (int) (b[0] & 1)); break;
+    case M25519_KRN_HLV:   ops->hlv(r, a); break;
+    case M25519_KRN_MUL:   ops->mul(r, a, b); break;
+    case M25519_KRN_MUL32: ops->mul32(r, a, b); break;
+    case M25519_KRN_SQR:   ops->sqr(r, a); break;
+  }
+}
+
+
+// Initialization of the two operands of a kernel with pseudo-random words
+// (xorshift32); the operands are not reduced, i.e., they can be up to 256 bits
+// long, and the LSB of `b[0]` is set so that `cneg` performs a negation
+
+static void krn_operands(Word *a, Word *b)
+{
+  uint32_t x = 0x2545F491UL;
+  int i;
+  
+  for (i = 0; i < LEN; i++) {
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    a[i] = (Word) x;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    b[i] = (Word) x;
+  }
+  a[LEN-1] |= (Word) 1 << (WSIZE - 1);
+  b[0] |= 1;
+}
+
+
+// Known-answer test of the kernel with index `k` of a backend: the result is
+// compared with that of the C kernel after full reduction modulo $p$, and 0
+// is returned if they match
+
+static int krn_check(const ArithOps *ops, int k)
+{
+  Word a[LEN], b[LEN], r[LEN], e[LEN];
+  
+  krn_operands(a, b);
+  krn_exec(ops, k, r, a, b);
+  krn_exec(&m25519_ops_c99, k, e, a, b);
+  gfp_fred(r, r);
+  gfp_fred(e, e);
+  return mpi_cmp(r, e, LEN);
+}
+
+
+// Measurement of the execution time of the kernel with index `k` of a backend
+// (for `KRN_RUNS` calls) with the timer-function `timer`
+
+static uint32_t krn_time(const ArithOps *ops, int k, uint32_t (*timer)(void))
+{
+  Word a[LEN], b[LEN], r[LEN];
+  uint32_t t0, t1, tmin = 0;
+  int i, j;
+  
+  krn_operands(a, b);
+  for (i = 0; i < KRN_MEAS; i++) {
+    t0 = timer();
+    for (j = 0; j < KRN_RUNS; j++) krn_exec(ops, k, r, a, b);
+    t1 = timer() - t0;
+    if ((i == 0) || (t1 < tmin)) tmin = t1;
+  }
+  return tmin;
+}
+
+
+// Update of the name of the ops table: the name of the backend if all kernels
+// originate from the same backend, or "mixed" otherwise
+
+static void ops_update_name(void)
+{
+  int k;
+  
+  m25519_ops.name = m25519_krn_src[0];
+  for (k = 1; k < M25519_KRN_NUM; k++) {
+    if (m25519_krn_src[k] != m25519_krn_src[0]) m25519_ops.name = "mixed";
+  }
+}
+
+
+// Installation of the kernels of a backend
+// ----------------------------------------
+// All kernels of the backend `ops` that are not NULL and pass the known-answer
+// test are installed in the ops table. M25519_ERR_BACKEND is returned if one
+// of the kernels failed the test (it is then not installed).
+
+int m25519_set_backend(const ArithOps *ops)
+{
+  int k, err = M25519_NO_ERROR;
+  
+  if (ops == NULL) return M25519_ERR_BACKEND;
+  for (k = 0; k < M25519_KRN_NUM; k++) {
+    if (!krn_avail(ops, k)) continue;
+    if (krn_check(ops, k) != 0) {
+      err = M25519_ERR_BACKEND;
+      continue;
+    }
+    krn_install(ops, k);
+  }
+  ops_update_name();
+  
+  return err;
+}
+
+
+// Selection of the fastest kernels of a list of backends
+// ------------------------------------------------------
+// For each of the seven kernels, the corresponding entries of the `num`
+// backends in `list` are tested and their execution time is measured with the
+// timer-function `timer` (e.g., a function that reads a cycle counter), and
+// the fastest of them is installed in the ops table. The list should only
+// contain backends that are supported by the hardware, i.e., the application
+// is responsible for probing the CPU features or the presence of a crypto
+// coprocessor. When `list` is NULL, the built-in backends (C99 and, if the
+// Assembly functions are available, ASM) are used. When `timer` is NULL, no
+// measurements are performed and the kernels of the last backend in `list`
+// that contains them are installed. In the case of equal execution times, the
+// backend that comes later in `list` is preferred. M25519_ERR_BACKEND is
+// returned if one of the kernels failed the known-answer test (it is then
+// not considered).
+
+int m25519_select_backend(const ArithOps *const *list, int num, \
+  uint32_t (*timer)(void))
+{
+  const ArithOps *blt[2], *best;
+  uint32_t t, tbest = 0;
+  int i, k, err = M25519_NO_ERROR;
+  
+  if (list == NULL) {
+    blt[0] = &m25519_ops_c99;
+    num = 1;
+#if defined(M25519_ASSEMBLY)
+    blt[1] = &m25519_ops_asm;
+    num = 2;
+#endif
+    list = blt;
+  }
+  
+  for (k = 0; k < M25519_KRN_NUM; k++) {
+    best = NULL;
+    for (i = 0; i < num; i++) {
+      if ((list[i] == NULL) || !krn_avail(list[i], k)) continue;
+      if (krn_check(list[i], k) != 0) {
+        err = M25519_ERR_BACKEND;
+        continue;
+      }
+      t = (timer != NULL) ? krn_time(list[i], k, timer) : 0;
+      if ((best == NULL) || (t <= tbest)) {
+        best = list[i];
+        tbest = t;
+      }
+    }
+    if (best != NULL) krn_install(best, k);
+  }
+  ops_update_name();
+  
+  return err;
+}
+
+
+// Name of the backend from which the installed kernel with index `kernel`
+// originates (NULL is returned if the index is invalid)
+
+const char *m25519_backend_name(int kernel)
+{
+  if ((kernel < 0) || (kernel >= M25519_KRN_NUM)) return NULL;
+  return m25519_krn_src[kernel];
+}
+
+
+#endif // #if defined(M25519_OPSTBL)
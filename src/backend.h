@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////
+// backend.h: Run-time selection of the field-arithmetic kernels.            //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _BACKEND_H
+#define _BACKEND_H
+
+#include "config.h"
+
+// `ArithOps` is a table of pointers to the seven performance-critical field-
+// arithmetic functions ("kernels") of a backend. When `M25519_USE_OPS_TABLE`
+// is defined, the macros `gfp_add`, `gfp_mul`, etc. in `gfparith.h` call the
+// kernels via the global table `m25519_ops`, whose entries can be replaced at
+// run time. A backend provided by the application (e.g., a driver for a crypto
+// coprocessor) may leave entries NULL, which are then not replaced. All other
+// functions (e.g., `gfp_add_nr`, `gfp_inv`, and the MPI arithmetic) are still
+// bound at compile time.
+
+#if defined(M25519_OPSTBL)
+
+typedef struct arithops {
+  const char *name;  // name of the backend (e.g., "c99" or "asm")
+  void (*add)(Word *r, const Word *a, const Word *b);
+  void (*sub)(Word *r, const Word *a, const Word *b);
+  void (*cneg)(Word *r, const Word *a, int neg);
+  void (*hlv)(Word *r, const Word *a);
+  void (*mul)(Word *r, const Word *a, const Word *b);
+  void (*mul32)(Word *r, const Word *a, const Word *b);
+  void (*sqr)(Word *r, const Word *a);
+} ArithOps;
+
+// indices of the kernels (e.g., for `m25519_backend_name`)
+#define M25519_KRN_ADD   0
+#define M25519_KRN_SUB   1
+#define M25519_KRN_CNEG  2
+#define M25519_KRN_HLV   3
+#define M25519_KRN_MUL   4
+#define M25519_KRN_MUL32 5
+#define M25519_KRN_SQR   6
+#define M25519_KRN_NUM   7
+
+// the installed kernels and the built-in backends
+extern ArithOps m25519_ops;
+extern const ArithOps m25519_ops_c99;
+#if defined(M25519_ASSEMBLY)
+extern const ArithOps m25519_ops_asm;
+#endif
+
+// prototypes of functions with C implementations only
+int m25519_set_backend(const ArithOps *ops);
+int m25519_select_backend(const ArithOps *const *list, int num, \
+  uint32_t (*timer)(void));
+const char *m25519_backend_name(int kernel);
+
+#endif
+
+#endif
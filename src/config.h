@@ -43,6 +43,29 @@
 // #define M25519_USE_ASM
 
 
+// Micro25519 will use a 64-bit C implementation of the performance-critical
+// field arithmetic (based on a radix-$2^{51}$ representation with 128-bit
+// products) if `M25519_USE_HOST64` is defined, provided that the target is
+// a 64-bit "host-class" processor (x86-64 or AArch64) and the compiler
+// supports the type `unsigned __int128`. The field-elements are stored in
+// the same Word-arrays as on 32-bit targets (i.e., the API does not change)
+// and are converted to five 51-bit limbs inside the multiplication and
+// squaring. This option has no effect when Assembly code is used.
+
+// #define M25519_USE_HOST64
+
+
+// Micro25519 will use SIMD implementations of the four-way parallel field
+// arithmetic in `gfparith4.c` if `M25519_USE_SIMD` is defined, provided that
+// the target is an x86-64 processor with AVX2 extension or an ARM processor
+// with NEON extension (and the compiler has been invoked with the respective
+// options, e.g., `-mavx2`). Otherwise, the four-way operations are executed
+// (lane after lane) by ordinary C code. This option neither affects the API
+// nor the scalar field arithmetic.
+
+// #define M25519_USE_SIMD
+
+
 // Micro25519 will use Variable-Length Arrays (VLAs) for temporary/intermediate
 // operands if `M25519_USE_VLA` is defined and the length of these operands is
 // not known or not fixed at compile time. If `M25519_USE_VLA` is not defined,
@@ -51,10 +74,138 @@
 // #define M25519_USE_VLA
 
 
-// When Micro25519 is compiled for one of the four target architectures that
-// are supported with optimized Assembly code (AVR8, MSP430, ARMv7-M, RV32IM)
-// and `M25519_USE_ASM` is defined, then the Assembly implementation of the
-// performance-critical field/integer arithmetic is used.
+// Micro25519 uses a product-scanning (Comba) implementation of the C functions
+// `gfp_mul` and `gfp_sqr` with integrated first reduction step if the macro
+// `M25519_COMBA_MUL` is defined. This variant only needs an 8-word temporary
+// array on the stack instead of a 16-word array for the full product, which
+// is intended to reduce the RAM footprint on 8/16-bit microcontrollers.
+// Otherwise, the operand-scanning implementation is used. Note that neither
+// the stack usage nor the execution time of this variant has been measured on
+// an 8/16-bit target (e.g., AVR or MSP430) yet; on an x86-64 host, its
+// `gfp_sqr` was slower (120 vs. 86 cycles) and had a larger stack frame (144
+// vs. 96 bytes) than the operand-scanning version, see `doc/api/gfparith.md`.
+// This option has no effect when Assembly code or the 64-bit C implementation
+// is used.
+
+// #define M25519_COMBA_MUL
+
+
+// Micro25519 uses fully unrolled C implementations of the field operations
+// `gfp_add`, `gfp_sub`, `gfp_cneg`, `gfp_hlv`, `gfp_mul`, `gfp_sqr`, and
+// `gfp_mul32` if the macro `M25519_C_UNROLLED` is defined. These variants are
+// specialized for `LEN` = 8 and allow compilers to keep operands in registers
+// and to generate branch-free carry chains, which makes them faster than the
+// rolled versions on targets without Assembly code (at the expense of a
+// larger code size). `M25519_COMBA_MUL` has no effect when this option is
+// set. This option has no effect when Assembly code or the 64-bit C
+// implementation is used.
+
+// #define M25519_C_UNROLLED
+
+
+// Micro25519 converts the byte arrays of the X25519 and Ed25519 API (keys,
+// points, signatures, and digests in little-Endian byte order) to Word-arrays
+// and vice versa with `memcpy` if `M25519_USE_LE_BYTES` is defined and the
+// target is little-Endian. Otherwise, or when the byte order of the target
+// can not be determined at compile time, every Word is assembled from four
+// bytes with shifts, which is independent of the endianness. The `memcpy`
+// does not impose any alignment requirements on the byte arrays, but it is
+// not necessarily faster (see `doc/api/x25519.md`), hence the option is
+// disabled by default.
+
+// #define M25519_USE_LE_BYTES
+
+
+// Micro25519 will use a constant-time inversion in GF(p) based on the divsteps
+// ("safegcd") algorithm of Bernstein and Yang if `M25519_SAFEGCD_INV` is
+// defined. Otherwise, the inversion is performed with the Extended Euclidean
+// Algorithm (EEA), which is faster but has an operand-dependent execution time
+// and, therefore, needs to be protected via multiplicative masking.
+
+// #define M25519_SAFEGCD_INV
+
+
+// Micro25519 counts how often the main field-arithmetic and MPI functions
+// (e.g., `gfp_mul`, `gfp_sqr`, `gfp_inv`, `mpi_sub`, `mpi_shr`) are executed,
+// as well as the number of iterations of the inversion, if `M25519_PROFILE`
+// is defined. The counters can be read and reset via the functions declared
+// in `profile.h`. When `M25519_PROFILE` is not defined, the counting code is
+// removed completely by the pre-processor, i.e., there is no overhead.
+
+// #define M25519_PROFILE
+
+
+// Micro25519 calls the performance-critical field-arithmetic functions (e.g.,
+// `gfp_mul`, `gfp_sqr`) via a table of function pointers if the macro
+// `M25519_USE_OPS_TABLE` is defined. This table can be filled at run time
+// with the fastest of the available implementations (C99, Assembly, or the
+// kernels of a crypto coprocessor provided by the application) by calling
+// `m25519_select_backend`, see `backend.h`, which allows one firmware image
+// to be used on different hardware. This option is ignored when the 64-bit C
+// implementation is used. When `M25519_USE_OPS_TABLE` is not defined, the
+// functions are bound at compile time (i.e., there is no overhead).
+
+// #define M25519_USE_OPS_TABLE
+
+
+// The fixed-base scalar multiplication on Edwards25519 uses a comb method with
+// `M25519_COMB_TEETH` teeth and `M25519_COMB_TABLES` tables of pre-computed
+// points. Each table contains $2^{TEETH-1}$ points of 96 bytes, and a scalar
+// multiplication requires about $254/(TEETH \cdot TABLES)$ point doublings and
+// $254/TEETH$ mixed additions. The default (four teeth, one table) occupies
+// 768 bytes of flash. The table in `tedcomb.h` must be re-generated with the
+// script `test/gentbl_ted_comb.py` when one of these values is changed.
+
+#ifndef M25519_COMB_TEETH
+#define M25519_COMB_TEETH 4
+#endif
+#ifndef M25519_COMB_TABLES
+#define M25519_COMB_TABLES 1
+#endif
+
+
+// The variable-base scalar multiplication `ted_mul_varbase` (signed fixed
+// windows, constant time) and the double-base scalar multiplication used for
+// the verification of signatures (interleaved wNAF, variable time) compute a
+// table of $2^{W-2}$ odd multiples $P, 3P, \ldots$ of each base point on the
+// stack, with $W$ = `M25519_TED_WINDOW` in the range [3, 7]. Every point takes
+// 160 bytes, i.e., the tables occupy $160 \cdot 2^{W-2}$ bytes of RAM for
+// `ted_mul_varbase` and twice as much for the verification. The default ($W =
+// 4$) needs 640 and 1280 bytes, and increasing $W$ by 1 doubles the RAM but
+// saves about 20% of the point additions.
+
+#ifndef M25519_TED_WINDOW
+#define M25519_TED_WINDOW 4
+#endif
+
+
+// On dual-core microcontrollers (e.g., RP2040, ESP32, or STM32H7 dual-core),
+// the double-base scalar multiplication $l G + k P$ used for the verification
+// of signatures can be split into two independent scalar multiplications, and
+// the fixed-base comb method into two halves of the tables, which are then
+// executed in parallel on the two cores. When `M25519_DUAL_CORE` is defined,
+// the platform can register a hook for running a job on the second core with
+// `ted_set_core1` (see `tedcurve.h`); as long as no hook is registered, all
+// scalar multiplications are executed on the calling core as usual. The comb
+// method is only split when `M25519_COMB_TABLES` is at least 2.
+
+// #define M25519_DUAL_CORE
+
+
+// When Micro25519 is compiled for one of the five target architectures that
+// are supported with optimized Assembly code (AVR8, MSP430, ARMv6-M, ARMv7-M,
+// RV32IM) and `M25519_USE_ASM` is defined, then the Assembly implementation of
+// the performance-critical field/integer arithmetic is used. On RV32 cores
+// that support the bit-manipulation extensions Zba and Zbs (i.e., when the
+// compiler is invoked with, e.g., `-march=rv32imc_zba_zbb_zbs`), the RISC-V
+// Assembly files use alternative versions of some macros with `sh1add`,
+// `sh3add`, and `bclri`, which is indicated by `M25519_TARGET` = `RV32IMB`.
+// ARMv6-M (Cortex-M0/M0+) has to be checked before the other ARM processors
+// since it only supports the Thumb-1 instruction set and a 32-bit `muls`.
+// The RV32 backend provides some additional Assembly functions (e.g., the
+// non-reducing addition/subtraction, the repeated squaring, the divsteps, and
+// the order arithmetic of Edwards25519), which is indicated by the macro
+// `M25519_ASSEMBLY_EXT`; on all other targets, the C versions are used.
 
 #if defined(M25519_USE_ASM)
 #if (defined(__AVR) || defined(__AVR__))
@@ -63,16 +214,96 @@
 #elif (defined(__MSP430__) || defined(__ICC430__))
 #define M25519_TARGET MSP430
 #define M25519_ASSEMBLY
+#elif (defined(__ARM_ARCH_6M__) || (defined(__ARM_ARCH_PROFILE) && \
+  (__ARM_ARCH_PROFILE == 'M') && (__ARM_ARCH == 6)))
+#define M25519_TARGET ARMV6M
+#define M25519_ASSEMBLY
 #elif (defined(__arm__) || defined(_M_ARM))
 #define M25519_TARGET ARMV7M
 #define M25519_ASSEMBLY
 #elif (defined(__riscv) && (__riscv_xlen == 32))
+#if (defined(__riscv_zba) && defined(__riscv_zbs))
+#define M25519_TARGET RV32IMB
+#else
 #define M25519_TARGET RV32IM
+#endif
 #define M25519_ASSEMBLY
+#define M25519_ASSEMBLY_EXT
 #endif // #if (defined(__AVR) || ...
 #endif // #if defined(M25519_USE_ASM)
 
 
+// When Micro25519 is compiled for a 64-bit host-class processor (x86-64 or
+// AArch64) and `M25519_USE_HOST64` is defined, then the 64-bit C implementation
+// of the performance-critical field arithmetic (in `host64/gfparith51.c`) is
+// used instead of the generic 32-bit C implementation.
+
+#if (defined(M25519_USE_HOST64) && !defined(M25519_ASSEMBLY))
+#if defined(__SIZEOF_INT128__)
+#if (defined(__x86_64__) || defined(_M_X64))
+#define M25519_TARGET X86_64
+#define M25519_HOST64
+#elif (defined(__aarch64__) || defined(_M_ARM64))
+#define M25519_TARGET AARCH64
+#define M25519_HOST64
+#endif // #if (defined(__x86_64__) || ...
+#endif // #if defined(__SIZEOF_INT128__)
+#endif // #if (defined(M25519_USE_HOST64) && ...
+
+
+// When `M25519_USE_OPS_TABLE` is defined and the 64-bit C implementation is
+// not used, then the performance-critical field arithmetic is called via the
+// table of function pointers `m25519_ops` (in `backend.c`), which initially
+// contains the Assembly functions (if available) or the C functions.
+
+#if (defined(M25519_USE_OPS_TABLE) && !defined(M25519_HOST64))
+#define M25519_OPSTBL
+#endif
+
+
+// When Micro25519 is compiled for a processor with a supported SIMD extension
+// (AVX2 or NEON) and `M25519_USE_SIMD` is defined, then the SIMD version of
+// the four-way parallel field arithmetic (in `simd/gfparith4_avx2.c` or in
+// `simd/gfparith4_neon.c`) is used instead of the C version in `gfparith4.c`.
+
+#if defined(M25519_USE_SIMD)
+#if defined(__AVX2__)
+#define M25519_SIMDEXT AVX2
+#define M25519_SIMD
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define M25519_SIMDEXT NEON
+#define M25519_SIMD
+#endif // #if defined(__AVX2__) ...
+#endif // #if defined(M25519_USE_SIMD)
+
+
+// When `M25519_USE_LE_BYTES` is defined and the target is little-Endian, which
+// is determined from `__BYTE_ORDER__` (GCC and Clang) or from the pre-defined
+// macros of other compilers for the supported architectures, then the byte
+// arrays of the API are converted with `memcpy` (see `x25519.c` and
+// `ed25519.c`).
+
+#if defined(M25519_USE_LE_BYTES)
+#if defined(__BYTE_ORDER__)
+#if (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define M25519_LEBYTES
+#endif
+#elif (defined(__AVR) || defined(__AVR__) || defined(__MSP430__) || \
+  defined(__ICC430__) || defined(__riscv) || defined(_M_IX86) || \
+  defined(_M_X64) || defined(_M_ARM) || defined(_M_ARM64))
+#define M25519_LEBYTES
+#elif defined(__ICCARM__)
+#if (__LITTLE_ENDIAN__ == 1)
+#define M25519_LEBYTES
+#endif
+#elif defined(__arm__)
+#if (!defined(__ARM_BIG_ENDIAN) && !defined(__BIG_ENDIAN))
+#define M25519_LEBYTES
+#endif
+#endif // #if defined(__BYTE_ORDER__) ...
+#endif // #if defined(M25519_USE_LE_BYTES)
+
+
 //#ifndef NDEBUG
 #define M25519_DBG_PRINT
 //#endif
@@ -87,6 +318,11 @@
 #define M25519_ERR_TPOINT 8
 #define M25519_ERR_SCALAR 16
 #define M25519_ERR_TVFILE 32
+#define M25519_ERR_DECOMP 64
+#define M25519_ERR_SIGVER 128
+#define M25519_ERR_BACKEND 256
+#define M25519_ERR_POOLEMPTY 512
+#define M25519_ERR_STREAM 1024
 
 
 // `Word` is the basic data type used to represent a multiple-precision integer
@@ -98,6 +334,12 @@ typedef int64_t SDWord;    // a signed double-length word is 64 bits long
 #define WSIZE 32           // the word-size is 32 bits
 
 
+// `Byte` is the data type of byte-arrays like keys, shared secrets, digests,
+// or signatures, which are passed to the high-level X25519/Ed25519 functions.
+
+typedef unsigned char Byte;
+
+
 // An element of the prime field GF(p) with $p = 2^k - c$ is stored in a Word-
 // array consisting of `LEN` Words.
 
@@ -126,4 +368,22 @@ typedef struct point {
 } Point;
 
 
+// `ECDomPar` is a C structure that combines the domain parameters of the two
+// curve models (Montgomery and TED) and various curve-dependent constants so
+// that they are accessible from one place. All arrays are placed in non-
+// volatile memory (i.e., flash) to reduce the RAM footprint.
+
+typedef struct ecdompar {  // elliptic curve domain parameters
+  const int k;      // bitlength of the prime ($k = 255$)
+  const Word c;     // constant $c = 19$ defining the prime $p = 2^k - c$
+  const Word *a24;  // constant $(A+2)/4 = 121666$ of the Montgomery curve
+  const Word *dte;  // parameter $d$ of corresponding TED curve with $a = -1$
+  const Word *rma;  // root of $-a = -(A+2)/B$ for point-mappings MON <-> TED
+  const Word *rm1;  // root of $-1$ ($2^{(p-1)/4} \bmod p$) for decompression
+  const Word *car;  // cardinality of elliptic-curve group ($8 \cdot \ell$)
+  const Word *cbr;  // constant for Barrett reduction modulo the cardinality
+  const Word *tbl;  // table of pre-computed points for fixed-base comb method
+} ECDomPar;
+
+
 #endif  // _CONFIG_H
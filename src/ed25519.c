@@ -0,0 +1,1007 @@
+///////////////////////////////////////////////////////////////////////////////
+// ed25519.c: Ed25519 signatures using the curve Edwards25519.               //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// The functions in this file implement the generation and verification of
+// Ed25519 signatures as specified in RFC 8032 (with one-shot and incremental
+// interfaces), along with the signature-specific operations for
+// the (de)compression of points, the exponentiation needed for decompression,
+// and the arithmetic modulo the group order $\ell = 2^{252} +
+// 27742317777372353535851937790883648493$. All verifications use the
+// "cofactored" equation $8 s G = 8 R + 8 h A$ with $h = \mathrm{SHA512}(R \|
+// A \| M) \bmod \ell$, which is also the equation checked by the random linear
+// combination of `ed25519_verify_batch`, so that the result of a batch
+// verification is always consistent with individual verifications. Values
+// modulo $\ell$ are actually reduced modulo the cardinality $8 \ell$ (which
+// is a 256-bit integer) and only fully reduced modulo $\ell$ when needed.
+
+
+#include <stddef.h>
+#include <string.h>
+#include "mpiarith.h"
+#include "gfparith.h"
+#include "tedcurve.h"
+#include "x25519.h"
+#include "ed25519.h"
+
+
+// Conversion of `4*len` bytes (in little-Endian order) to a `len`-word array
+// and vice versa. When `M25519_LEBYTES` is defined (see `config.h`), the byte
+// order of the target is the same as that of the arrays and the conversion is
+// a copy. Otherwise, the conversions are independent of the endianness of the
+// target.
+
+#if defined(M25519_LEBYTES)
+
+static void ed25519_from_bytes(Word *r, const Byte *a, int len)
+{
+  memcpy(r, a, 4*((size_t) len));
+}
+
+static void ed25519_to_bytes(Byte *r, const Word *a, int len)
+{
+  memcpy(r, a, 4*((size_t) len));
+}
+
+#else
+
+static void ed25519_from_bytes(Word *r, const Byte *a, int len)
+{
+  int i;
+
+  for (i = 0; i < len; i++) {
+    r[i] = ((Word) a[4*i]) | (((Word) a[4*i+1]) << 8) | \
+           (((Word) a[4*i+2]) << 16) | (((Word) a[4*i+3]) << 24);
+  }
+}
+
+static void ed25519_to_bytes(Byte *r, const Word *a, int len)
+{
+  int i;
+
+  for (i = 0; i < 4*len; i++) r[i] = (Byte) (a[i/4] >> (8*(i % 4)));
+}
+
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+////////////// SIGNATURE-SPECIFIC FIELD AND POINT ARITHMETIC //////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Exponentiation of a field-element: $r = a^{(p-5)/8} \bmod p$
+// ------------------------------------------------------------
+// The exponent $(p-5)/8 = 2^{252} - 3$ is processed with the addition chain
+// also used in Ref10, which consists of 251 squarings and 11 multiplications.
+// The runs of consecutive squarings are executed with `gfp_sqrn`.
+
+void gfp_exp_p58(Word *r, const Word *a)
+{
+  Word tmp[3*LEN];  // temporary space for three gfp elements
+  Word *t0 = tmp, *t1 = &tmp[LEN], *t2 = &tmp[2*LEN];
+
+  gfp_sqr(t0, a);                               // t0 = a^2
+  gfp_sqrn(t1, t0, 2);                          // t1 = a^8
+  gfp_mul(t1, a, t1);                           // t1 = a^9
+  gfp_mul(t0, t0, t1);                          // t0 = a^11
+  gfp_sqr(t0, t0);                              // t0 = a^22
+  gfp_mul(t0, t1, t0);                          // t0 = a^(2^5-1)
+  gfp_sqrn(t1, t0, 5);
+  gfp_mul(t0, t1, t0);                          // t0 = a^(2^10-1)
+  gfp_sqrn(t1, t0, 10);
+  gfp_mul(t1, t1, t0);                          // t1 = a^(2^20-1)
+  gfp_sqrn(t2, t1, 20);
+  gfp_mul(t1, t2, t1);                          // t1 = a^(2^40-1)
+  gfp_sqrn(t1, t1, 10);
+  gfp_mul(t0, t1, t0);                          // t0 = a^(2^50-1)
+  gfp_sqrn(t1, t0, 50);
+  gfp_mul(t1, t1, t0);                          // t1 = a^(2^100-1)
+  gfp_sqrn(t2, t1, 100);
+  gfp_mul(t1, t2, t1);                          // t1 = a^(2^200-1)
+  gfp_sqrn(t1, t1, 50);
+  gfp_mul(t0, t1, t0);                          // t0 = a^(2^250-1)
+  gfp_sqrn(t0, t0, 2);                          // t0 = a^(2^252-4)
+  gfp_mul(r, t0, a);                            // r = a^(2^252-3)
+}
+
+
+// Compression of a point: $r = y + 2^{255} (x \bmod 2)$
+// -----------------------------------------------------
+// The point $P$ must be given in affine coordinates. Both coordinates are
+// fully reduced before the compression.
+
+void ted_compress(Word *r, const Point *a)
+{
+  Word x[LEN];
+
+  gfp_fred(x, a->xyz);
+  gfp_fred(r, &a->xyz[LEN]);
+  r[LEN-1] |= (x[0] & 1) << (WSIZE - 1);
+}
+
+
+// Compression of a batch of points: $r_i = y_i + 2^{255} (x_i \bmod 2)$
+// ---------------------------------------------------------------------
+// The `n` points $P_i$ must be given in projective coordinates (`p[i].dim` at
+// least 3), e.g., as computed by `ted_mul_fixbase_proj`, and the compressed
+// points are stored in the array `r` of `n*LEN` words, which must not overlap
+// with the points. The affine coordinates $x_i = X_i/Z_i$ and $y_i = Y_i/Z_i$
+// are obtained with one batch inversion of all $Z_i$ (see `gfp_inv_batch`),
+// which means that compressing $n$ points costs a single inversion and $5n -
+// 3$ multiplications in GF(p) instead of $n$ inversions. The array `scratch`
+// must be able to accommodate `2*n*LEN` words. The return value is
+// `M25519_ERR_TPOINT` if $Z_i = 0$ for at least one point (whose compressed
+// value is then 0) and `M25519_NO_ERROR` otherwise. Like `ted_conv_p2a`, the
+// batch inversion has constant execution time, i.e., the points may be the
+// results of scalar multiplications with secret scalars.
+
+int ted_compress_batch(Word *r, const Point *p, int n, Word *scratch)
+{
+  Word x[LEN], y[LEN];
+  Word *zi = scratch;
+  int i, err;
+
+  if (n <= 0) return M25519_NO_ERROR;
+
+  for (i = 0; i < n; i++) mpi_copy(&zi[i*LEN], &p[i].xyz[2*LEN], LEN);
+  err = gfp_inv_batch(zi, zi, n, &scratch[n*LEN]);
+  for (i = 0; i < n; i++) {
+    gfp_mul(x, p[i].xyz, &zi[i*LEN]);
+    gfp_mul(y, &p[i].xyz[LEN], &zi[i*LEN]);
+    gfp_fred(x, x);
+    gfp_fred(&r[i*LEN], y);
+    r[i*LEN+LEN-1] |= (x[0] & 1) << (WSIZE - 1);
+  }
+
+  return (err == M25519_NO_ERROR) ? M25519_NO_ERROR : M25519_ERR_TPOINT;
+}
+
+
+// Decompression of a point: $R = (x,y)$
+// -------------------------------------
+// The decompression follows Section 5.1.3 of RFC 8032, i.e., the candidate
+// root $x = u v^3 (u v^7)^{(p-5)/8}$ of $x^2 = u/v$ with $u = y^2 - 1$ and
+// $v = d y^2 + 1$ is computed first, and then multiplied by $\sqrt{-1}$ if
+// $v x^2 = -u$. The decompression fails when $y \geq p$, when $u/v$ is not a
+// square, or when $x = 0$ and the sign-bit is 1. The coordinates of the result
+// are fully reduced. The parameter `d` is needed to access the curve parameter
+// $d$ and the root of $-1$.
+// NOTE: The execution time of this function is not constant, which is fine
+// since it operates on public values (e.g., public keys or signatures) only.
+
+int ted_decompress(Point *r, const Word *a, const ECDomPar *d)
+{
+  Word tmp[4*LEN];  // temporary space for four gfp elements
+  Word *u = tmp, *v = &tmp[LEN], *t0 = &tmp[2*LEN], *t1 = &tmp[3*LEN];
+  Word *x = r->xyz, *y = &r->xyz[LEN];
+  int sign = (int) (a[LEN-1] >> (WSIZE - 1));
+
+  mpi_copy(y, a, LEN);
+  y[LEN-1] &= ~(((Word) 1) << (WSIZE - 1));
+  if (gfp_cmpp(y) >= 0) return M25519_ERR_DECOMP;
+
+  mpi_setw(t0, 1, LEN);
+  gfp_sqr(t1, y);               // t1 = y^2
+  gfp_sub(u, t1, t0);           // u = y^2 - 1
+  gfp_mul(v, t1, d->dte);       // v = d*y^2
+  gfp_add(v, v, t0);            // v = d*y^2 + 1
+  gfp_sqr(t0, v);               // t0 = v^2
+  gfp_mul(t0, t0, v);           // t0 = v^3
+  gfp_sqr(t1, t0);              // t1 = v^6
+  gfp_mul(t1, t1, v);           // t1 = v^7
+  gfp_mul(t1, t1, u);           // t1 = u*v^7
+  gfp_exp_p58(t1, t1);          // t1 = (u*v^7)^((p-5)/8)
+  gfp_mul(t0, t0, u);           // t0 = u*v^3
+  gfp_mul(x, t0, t1);           // x = u*v^3*(u*v^7)^((p-5)/8)
+
+  gfp_sqr(t0, x);               // t0 = x^2
+  gfp_mul(t0, t0, v);           // t0 = v*x^2
+  if (gfp_cmp(t0, u) != 0) {
+    gfp_add(t0, t0, u);         // t0 = v*x^2 + u
+    mpi_setw(t1, 0, LEN);
+    if (gfp_cmp(t0, t1) != 0) return M25519_ERR_DECOMP;
+    gfp_mul(x, x, d->rm1);      // x = x*sqrt(-1)
+  }
+
+  gfp_fred(x, x);
+  if ((mpi_cmpw(x, 0, LEN) == 0) && sign) return M25519_ERR_DECOMP;
+  gfp_cneg(x, x, ((int) (x[0] & 1)) ^ sign);
+  gfp_fred(x, x);
+
+  return M25519_NO_ERROR;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+/////////////////// ARITHMETIC MODULO THE GROUP ORDER /////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Addition of two MPIs modulo the group order: $r = a + b \bmod \ell$
+// -------------------------------------------------------------------
+// The sum $a + b$ (which can be up to 257 bits long) is reduced modulo the
+// cardinality $8 \ell$ by (at most) two subtractions of $8 \ell$, which are
+// only carried out when the sum is 257 bits long. The subtractions and re-
+// additions are controlled by the carry-bit so that the execution time does
+// not depend on the operands.
+
+void ed25519_add_order(Word *r, const Word *a, const Word *b, \
+  const ECDomPar *d)
+{
+  int i, carry, rbit;
+
+  carry = mpi_add(r, a, b, LEN);
+  for (i = 0; i < 2; i++) {
+    rbit = mpi_sub(r, r, d->car, LEN);
+    mpi_cadd(r, r, d->car, 1 - carry, LEN);
+    carry &= 1 - rbit;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+#if !defined(M25519_ASSEMBLY_EXT) // PERFORMANCE-CRITICAL ORDER ARITHMETIC ////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Reduction of a double-length MPI modulo the group order: $r = a \bmod \ell$
+// ---------------------------------------------------------------------------
+// The 512-bit MPI $a$ is reduced modulo the cardinality $m = 8 \ell$, which is
+// 256 bits long (i.e., $2^{255} < m < 2^{256}$), with Barrett's algorithm and
+// the 257-bit constant $\mu = \lfloor 2^{512}/m \rfloor$. The quotient
+// estimate is $q = \lfloor \lfloor a/2^{224} \rfloor \mu / 2^{288} \rfloor$
+// and the remainder $a - q m$ is computed modulo $2^{288}$ (i.e., with nine
+// words) and is smaller than $3m$. Therefore, two constant-time subtractions
+// of $m$ (with conditional re-additions) suffice to get a result in $[0, m)$.
+// The Assembly version (see `M25519_ASSEMBLY_EXT`) exploits that the words 4 to 6
+// of $m$ are 0 and fuses the second multiplication with the subtraction.
+
+void ed25519_mod_order(Word *r, const Word *a, const ECDomPar *d)
+{
+  Word q[2*(LEN+1)], t[2*(LEN+1)], m[LEN+1];
+  int i, rbit;
+
+  mpi_copy(m, d->car, LEN);
+  m[LEN] = 0;
+  mpi_mul9(q, &a[LEN-1], d->cbr);  // q = (a >> 224)*mu
+  mpi_mul9(t, &q[LEN+1], m);       // t = (q >> 288)*m
+  mpi_sub(t, a, t, LEN + 1);       // t = (a - q*m) mod 2^288
+  for (i = 0; i < 2; i++) {
+    rbit = mpi_sub(t, t, m, LEN + 1);
+    mpi_cadd(t, t, m, rbit, LEN + 1);
+  }
+  mpi_copy(r, t, LEN);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+#endif ///////////////// ADDITIONAL ORDER ARITHMETIC //////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Full reduction of an MPI modulo the group order: $r = a \bmod \ell$
+// -------------------------------------------------------------------
+// Since $a < 2^{256} < 16 \ell$, the least non-negative residue is obtained
+// by conditional subtractions of $8 \ell$, $4 \ell$, $2 \ell$ and $\ell$
+// (in this order), which are performed in constant time.
+
+void ed25519_fred_order(Word *r, const Word *a, const ECDomPar *d)
+{
+  Word m[LEN];
+  int i, rbit;
+
+  mpi_copy(m, d->car, LEN);
+  mpi_copy(r, a, LEN);
+  for (i = 0; i < 4; i++) {
+    rbit = mpi_sub(r, r, m, LEN);
+    mpi_cadd(r, r, m, rbit, LEN);
+    mpi_shr(m, m, LEN);
+  }
+}
+
+
+// Reduction of a SHA-512 digest modulo the group order: $h = H \bmod \ell$
+// ------------------------------------------------------------------------
+// The 64 bytes of the digest are interpreted as a 512-bit integer in little-
+// Endian order, which is fully reduced modulo $\ell$.
+
+static void ed25519_hash_order(Word *h, const Byte *digest)
+{
+  Word hdig[2*LEN];
+  const ECDomPar *d = &ECDOMPAR25519;
+
+  ed25519_from_bytes(hdig, digest, 2*LEN);
+  ed25519_mod_order(h, hdig, d);
+  ed25519_fred_order(h, h, d);
+  mpi_setw(hdig, 0, 2*LEN);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+////////////////////// GENERATION OF ED25519 SIGNATURES ///////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Wiping of secret data
+// ----------------------
+// The `len` bytes at `p` are set to 0 through a volatile pointer so that the
+// stores can not be removed by the compiler (e.g., when `p` is a local array
+// that is not used anymore). The execution time only depends on `len`.
+
+static void ed25519_wipe(void *p, size_t len)
+{
+  volatile Byte *b = (volatile Byte *) p;
+  size_t i;
+
+  for (i = 0; i < len; i++) b[i] = 0;
+}
+
+
+// Expansion of a private key
+// --------------------------
+// The 32-byte private key is hashed with SHA-512 (Section 5.1.5 of RFC 8032).
+// The first half of the digest is pruned and yields the secret scalar $a$,
+// while the second half is the prefix for the computation of the nonce.
+
+static void ed25519_expand(Word *a, Byte *prefix, const Byte *privkey)
+{
+  Byte digest[64];
+  int i;
+
+  sha512_hash(digest, privkey, 32);
+  digest[0] &= 0xF8;                           // clear three lowest bits
+  digest[31] = (digest[31] & 0x7F) | 0x40;     // clear bit 255, set bit 254
+  ed25519_from_bytes(a, digest, LEN);
+  for (i = 0; i < 32; i++) prefix[i] = digest[32+i];
+  ed25519_wipe(digest, 64);
+}
+
+
+// Computation of the point $R$ of a signature: $R = r G$
+// ------------------------------------------------------
+// The nonce $r$ is obtained by reducing the digest of $\mathrm{prefix} \| M$
+// modulo $\ell$, and $R = r G$ is computed with `ted_mul_fixbase` and stored
+// in compressed form in the 32-byte array `rc`. The return value is the error
+// code of `ted_mul_fixbase` (i.e., `M25519_NO_ERROR` except when $r \equiv 0
+// \bmod \ell$, which happens with negligible probability).
+
+static int ed25519_commit(Byte *rc, Word *r, const Byte *digest)
+{
+  Word tmp[2*LEN];
+  Point rp = { 2, tmp };
+  int err;
+
+  ed25519_hash_order(r, digest);
+  err = ted_mul_fixbase(&rp, r, &ECDOMPAR25519);
+  ted_compress(tmp, &rp);
+  ed25519_to_bytes(rc, tmp, LEN);
+
+  return err;
+}
+
+
+// Computation of the scalar $s$ of a signature: $s = r + h a \bmod \ell$
+// ----------------------------------------------------------------------
+// The value $h$ is obtained by reducing the digest of $R \| A \| M$ modulo
+// $\ell$. The product $h a$ is reduced with `ed25519_mod_order` and the sum
+// $r + h a$ with `ed25519_add_order` and `ed25519_fred_order`, all of which
+// have constant execution time. The result is stored in the 32-byte array `s`.
+
+static void ed25519_respond(Byte *s, const Word *r, const Byte *digest, \
+  const Word *a)
+{
+  Word h[LEN], prod[2*LEN];
+  const ECDomPar *d = &ECDOMPAR25519;
+
+  ed25519_hash_order(h, digest);
+  mpi_mul8(prod, h, a);
+  ed25519_mod_order(h, prod, d);
+  ed25519_add_order(h, h, r, d);
+  ed25519_fred_order(h, h, d);
+  ed25519_to_bytes(s, h, LEN);
+  mpi_setw(h, 0, LEN);
+  mpi_setw(prod, 0, 2*LEN);
+}
+
+
+// Initialization of a signing context
+// -----------------------------------
+// The private key is expanded with `ed25519_expand`, i.e., the scalar $a$ and
+// the prefix are stored in the context. When `pubkey` is `NULL`, the public
+// key $A = a G$ is computed with `ted_mul_fixbase` and compressed, otherwise
+// it is copied from `pubkey` (which must be the compressed public key of
+// `privkey`). The return value is the error code of `ted_mul_fixbase`.
+
+int ed25519_sign_ctx_init(Ed25519SCtx *ctx, const Byte *privkey, \
+  const Byte *pubkey)
+{
+  Word tmp[2*LEN];
+  Point ap = { 2, tmp };
+  int err = M25519_NO_ERROR, i;
+
+  ed25519_expand(ctx->a, ctx->prefix, privkey);
+  if (pubkey == NULL) {
+    err = ted_mul_fixbase(&ap, ctx->a, &ECDOMPAR25519);
+    ted_compress(tmp, &ap);
+    ed25519_to_bytes(ctx->pk, tmp, LEN);
+  } else {
+    for (i = 0; i < 32; i++) ctx->pk[i] = pubkey[i];
+  }
+
+  return err;
+}
+
+
+// Wiping of a signing context
+// ---------------------------
+
+void ed25519_sign_ctx_wipe(Ed25519SCtx *ctx)
+{
+  ed25519_wipe(ctx, sizeof(Ed25519SCtx));
+}
+
+
+// Serialization of a signing context
+// ----------------------------------
+// The context is written to the byte-array `buf` of `ED25519_SCTXBYTES` bytes
+// as $a \| \mathrm{prefix} \| A$, with $a$ in little-Endian order, so that the
+// stored context does not depend on the endianness of the target.
+
+void ed25519_sign_ctx_store(Byte *buf, const Ed25519SCtx *ctx)
+{
+  int i;
+
+  ed25519_to_bytes(buf, ctx->a, LEN);
+  for (i = 0; i < 32; i++) {
+    buf[32+i] = ctx->prefix[i];
+    buf[64+i] = ctx->pk[i];
+  }
+}
+
+
+// De-serialization of a signing context
+// -------------------------------------
+// The context is read from a byte-array written by `ed25519_sign_ctx_store`.
+// The return value is `M25519_ERR_SCALAR` if $a$ is not a pruned scalar (in
+// which case the context is wiped) and `M25519_NO_ERROR` otherwise.
+
+int ed25519_sign_ctx_load(Ed25519SCtx *ctx, const Byte *buf)
+{
+  int i;
+
+  if (((buf[0] & 0x07) != 0) || ((buf[31] & 0xC0) != 0x40)) {
+    ed25519_sign_ctx_wipe(ctx);
+    return M25519_ERR_SCALAR;
+  }
+  ed25519_from_bytes(ctx->a, buf, LEN);
+  for (i = 0; i < 32; i++) {
+    ctx->prefix[i] = buf[32+i];
+    ctx->pk[i] = buf[64+i];
+  }
+
+  return M25519_NO_ERROR;
+}
+
+
+// Computation of an Ed25519 signature with a signing context
+// ----------------------------------------------------------
+// Since the private key has already been expanded, a signature costs one
+// fixed-base scalar multiplication, two SHA-512 computations over the message
+// (plus 32 and 64 bytes, respectively), and the arithmetic modulo $\ell$. The
+// nonce $r$ is wiped at the end. The return value is the error code of
+// `ed25519_commit`.
+
+int ed25519_sign_ctx(Byte *signature, const Byte *message, size_t mlen, \
+  const Ed25519SCtx *ctx)
+{
+  Word r[LEN];
+  SHA512Ctx hctx;
+  Byte digest[64];
+  int err;
+
+  sha512_init(&hctx);
+  sha512_update(&hctx, ctx->prefix, 32);
+  sha512_update(&hctx, message, mlen);
+  sha512_final(&hctx, digest);
+  err = ed25519_commit(signature, r, digest);
+
+  sha512_init(&hctx);
+  sha512_update(&hctx, signature, 32);
+  sha512_update(&hctx, ctx->pk, 32);
+  sha512_update(&hctx, message, mlen);
+  sha512_final(&hctx, digest);
+  ed25519_respond(&signature[32], r, digest, ctx->a);
+
+  ed25519_wipe(r, sizeof(r));
+
+  return err;
+}
+
+
+// Computation of an Ed25519 signature
+// -----------------------------------
+// The key-pair consists of the 32-byte private key followed by the 32-byte
+// compressed public key $A$. The private key is expanded into a (temporary)
+// signing context, which is wiped at the end. The return value is the error
+// code of `ed25519_commit`.
+
+int ed25519_sign(Byte *signature, const Byte *message, size_t mlen, \
+  const Byte *keypair)
+{
+  Ed25519SCtx key;
+  int err;
+
+  ed25519_sign_ctx_init(&key, keypair, &keypair[32]);
+  err = ed25519_sign_ctx(signature, message, mlen, &key);
+  ed25519_sign_ctx_wipe(&key);
+
+  return err;
+}
+
+
+// Initialization of an incremental signature generation
+// -----------------------------------------------------
+// The private key of the key-pair (same format as for `ed25519_sign`) is
+// expanded and the first pass over the message (i.e., the computation of the
+// nonce) is started.
+
+void ed25519_sign_init(Ed25519SStream *ctx, const Byte *keypair)
+{
+  int i;
+
+  ed25519_expand(ctx->a, ctx->prefix, keypair);
+  for (i = 0; i < 32; i++) ctx->pk[i] = keypair[32+i];
+  sha512_init(&ctx->hctx);
+  sha512_update(&ctx->hctx, ctx->prefix, 32);
+  sha512_init(&ctx->cctx);
+  ctx->pass = 1;
+}
+
+
+// Update of an incremental signature generation with a part of the message
+// ------------------------------------------------------------------------
+// In the first pass, the data is only hashed for the nonce. In the second
+// pass, it is hashed for $h$ and for the re-computation of the nonce.
+
+void ed25519_sign_update(Ed25519SStream *ctx, const Byte *data, size_t dlen)
+{
+  if (ctx->pass >= 1) sha512_update(&ctx->hctx, data, dlen);
+  if (ctx->pass == 2) sha512_update(&ctx->cctx, data, dlen);
+}
+
+
+// Transition from the first to the second pass over the message
+// -------------------------------------------------------------
+// The nonce $r$ and the point $R = r G$ are computed (see `ed25519_commit`),
+// and the hashes for $h = \mathrm{SHA512}(R \| A \| M)$ and the re-computation
+// of the nonce are started. The return value is `M25519_ERR_STREAM` if the
+// context is not in the first pass and the error code of `ed25519_commit`
+// otherwise.
+
+int ed25519_sign_commit(Ed25519SStream *ctx)
+{
+  Byte digest[64];
+  int err;
+
+  if (ctx->pass != 1) return M25519_ERR_STREAM;
+
+  sha512_final(&ctx->hctx, digest);
+  err = ed25519_commit(ctx->rc, ctx->r, digest);
+  sha512_update(&ctx->hctx, ctx->rc, 32);
+  sha512_update(&ctx->hctx, ctx->pk, 32);
+  sha512_update(&ctx->cctx, ctx->prefix, 32);
+  ctx->pass = 2;
+  ed25519_wipe(digest, 64);
+
+  return err;
+}
+
+
+// Finalization of an incremental signature generation
+// ---------------------------------------------------
+// The nonce is re-computed from the data of the second pass and compared
+// (in constant time) with the nonce of the first pass. When they match, $s = r
+// + h a \bmod \ell$ is computed and the signature $R \| s$ is written to the
+// 64-byte array `signature`; otherwise, the signature is all-0 since the same
+// $r$ must never be used with different messages (this would reveal $a$). In
+// both cases, the whole context is wiped. The return value is
+// `M25519_ERR_STREAM` if the context is not in the second pass or if the
+// message of the second pass differs from that of the first pass, and
+// `M25519_NO_ERROR` otherwise.
+
+int ed25519_sign_final(Ed25519SStream *ctx, Byte *signature)
+{
+  Word r[LEN], diff = 0;
+  Byte digest[64];
+  int err = M25519_ERR_STREAM;
+  size_t i;
+
+  if (ctx->pass == 2) {
+    sha512_final(&ctx->cctx, digest);
+    ed25519_hash_order(r, digest);
+    for (i = 0; i < LEN; i++) diff |= r[i] ^ ctx->r[i];
+    if (diff == 0) {
+      sha512_final(&ctx->hctx, digest);
+      for (i = 0; i < 32; i++) signature[i] = ctx->rc[i];
+      ed25519_respond(&signature[32], ctx->r, digest, ctx->a);
+      err = M25519_NO_ERROR;
+    }
+    ed25519_wipe(r, sizeof(r));
+    ed25519_wipe(digest, 64);
+  }
+  if (err != M25519_NO_ERROR) ed25519_wipe(signature, 64);
+  ed25519_wipe(ctx, sizeof(Ed25519SStream));
+
+  return err;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+////////////////////// VERIFICATION OF ED25519 SIGNATURES /////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Decoding of the point $R$ and the scalar $s$ of a signature
+// ------------------------------------------------------------
+// This function decompresses the point $R$ of the signature and checks that
+// $s < \ell$. The point $-R$ is stored in extended affine coordinates in the
+// array `rn`. The return value is `M25519_ERR_SIGVER` if $R$ can not be
+// decompressed or $s \geq \ell$.
+
+static int ed25519_decode_rs(Word *rn, Word *s, const Byte *sig)
+{
+  Word tmp[2*LEN];
+  Point a = { 2, tmp }, p = { 3, rn };
+  const ECDomPar *d = &ECDOMPAR25519;
+
+  ed25519_from_bytes(tmp, sig, LEN);
+  if (ted_decompress(&a, tmp, d) != M25519_NO_ERROR) return M25519_ERR_SIGVER;
+  gfp_cneg(tmp, tmp, 1);  // -R = (-x,y)
+  ted_conv_a2ea(&p, &a, d);
+
+  ed25519_from_bytes(s, &sig[32], LEN);
+  ed25519_fred_order(tmp, s, d);
+  if (mpi_cmp(tmp, s, LEN) != 0) return M25519_ERR_SIGVER;
+
+  return M25519_NO_ERROR;
+}
+
+
+// Decoding of a public key
+// ------------------------
+// This function decompresses the public key $A$ and stores $-A$ in extended
+// affine coordinates in the array `an`. The return value is
+// `M25519_ERR_DECOMP` if $A$ can not be decompressed.
+
+static int ed25519_decode_pk(Word *an, const Byte *pk)
+{
+  Word tmp[2*LEN];
+  Point a = { 2, tmp }, p = { 3, an };
+  const ECDomPar *d = &ECDOMPAR25519;
+
+  ed25519_from_bytes(tmp, pk, LEN);
+  if (ted_decompress(&a, tmp, d) != M25519_NO_ERROR) return M25519_ERR_DECOMP;
+  gfp_cneg(tmp, tmp, 1);  // -A = (-x,y)
+  ted_conv_a2ea(&p, &a, d);
+
+  return M25519_NO_ERROR;
+}
+
+
+// Decoding of a signature
+// -----------------------
+// This function decodes $R$ and $s$ with `ed25519_decode_rs` and computes $h
+// = \mathrm{SHA512}(R \| A \| M) \bmod \ell$ with the compressed public key
+// $A$ given by `pk`. The digest of $R \| A \| M$ is also stored in `dig` when
+// `dig` is not `NULL`. The return value is `M25519_ERR_SIGVER` if $R$ can not
+// be decompressed or $s \geq \ell$.
+
+static int ed25519_decode_sig(Word *rn, Word *s, Word *h, Byte *dig, \
+  const Byte *sig, const Byte *msg, size_t mlen, const Byte *pk)
+{
+  SHA512Ctx ctx;
+  Byte digest[64];
+  int i;
+
+  if (ed25519_decode_rs(rn, s, sig) != M25519_NO_ERROR) \
+    return M25519_ERR_SIGVER;
+
+  sha512_init(&ctx);
+  sha512_update(&ctx, sig, 32);
+  sha512_update(&ctx, pk, 32);
+  sha512_update(&ctx, msg, mlen);
+  sha512_final(&ctx, digest);
+  if (dig != NULL) for (i = 0; i < 64; i++) dig[i] = digest[i];
+  ed25519_hash_order(h, digest);
+
+  return M25519_NO_ERROR;
+}
+
+
+// Decoding of a signature and the public key
+// ------------------------------------------
+// This function decodes the public key with `ed25519_decode_pk` and then the
+// signature with `ed25519_decode_sig`. The return value is `M25519_ERR_DECOMP`
+// if $A$ can not be decompressed and `M25519_ERR_SIGVER` if $R$ can not be
+// decompressed or $s \geq \ell$.
+
+static int ed25519_decode(Word *rn, Word *an, Word *s, Word *h, Byte *dig, \
+  const Byte *sig, const Byte *msg, size_t mlen, const Byte *pk)
+{
+  if (ed25519_decode_pk(an, pk) != M25519_NO_ERROR) return M25519_ERR_DECOMP;
+
+  return ed25519_decode_sig(rn, s, h, dig, sig, msg, mlen, pk);
+}
+
+
+// Check whether $8 P = O$ for a point in extended projective coordinates
+// ----------------------------------------------------------------------
+// The point $P$ is doubled three times (i.e., `p` is overwritten) and the
+// result is compared with $O = [0:1:1]$, i.e., $X = 0$ and $Y = Z$ mod p.
+
+static int ed25519_is_small(Point *p)
+{
+  Word zero[LEN];
+
+  ted_double(p);
+  ted_double(p);
+  ted_double(p);
+  mpi_setw(zero, 0, LEN);
+
+  return ((gfp_cmp(p->xyz, zero) == 0) && \
+    (gfp_cmp(&p->xyz[LEN], &p->xyz[2*LEN]) == 0));
+}
+
+
+// Verification of a decoded signature: $8(sG - hA - R) \stackrel{?}{=} O$
+// ------------------------------------------------------------------------
+// The sum $sG + h(-A)$ is computed with the interleaved wNAF method of
+// `ted_mul_dblbase_wnaf`, then $-R$ is added and the result is multiplied by
+// the cofactor 8.
+
+static int ed25519_check(const Word *s, const Word *h, const Word *rn, \
+  const Word *an)
+{
+  Word tmp[6*LEN];
+  Point r = { 6, tmp }, p = { 3, (Word *) an }, q = { 3, (Word *) rn };
+
+  ted_mul_dblbase_wnaf(&r, s, h, &p, &ECDOMPAR25519);
+  ted_add(&r, &q);
+
+  return (ed25519_is_small(&r) ? M25519_NO_ERROR : M25519_ERR_SIGVER);
+}
+
+
+// Verification of an Ed25519 signature
+// ------------------------------------
+// The return value is `M25519_ERR_DECOMP` when the public key can not be
+// decompressed and `M25519_ERR_SIGVER` when the signature is invalid.
+
+int ed25519_verify(const Byte *signature, const Byte *message, size_t mlen, \
+  const Byte *pubkey)
+{
+  Word rn[3*LEN], an[3*LEN], s[LEN], h[LEN];
+  int err;
+
+  err = ed25519_decode(rn, an, s, h, NULL, signature, message, mlen, pubkey);
+  if (err != M25519_NO_ERROR) return err;
+
+  return ed25519_check(s, h, rn, an);
+}
+
+
+// Initialization of a verification context
+// -----------------------------------------
+// The public key $A$ is decompressed and the comb table of $-A$ is computed
+// with `ted_comb_table`. The return value is `M25519_ERR_DECOMP` when the
+// public key can not be decompressed.
+
+int ed25519_verify_ctx_init(Ed25519VCtx *ctx, const Byte *pubkey)
+{
+  Word tmp[2*LEN];
+  Point a = { 2, tmp };
+  const ECDomPar *d = &ECDOMPAR25519;
+  int i;
+
+  ed25519_from_bytes(tmp, pubkey, LEN);
+  if (ted_decompress(&a, tmp, d) != M25519_NO_ERROR) return M25519_ERR_DECOMP;
+  gfp_cneg(tmp, tmp, 1);  // -A = (-x,y)
+  ted_comb_table(ctx->tbl, &a, d);
+  for (i = 0; i < 32; i++) ctx->pk[i] = pubkey[i];
+
+  return M25519_NO_ERROR;
+}
+
+
+// Verification of an Ed25519 signature with a verification context
+// -----------------------------------------------------------------
+// The sum $sG + h(-A)$ is computed with the double-base comb method, which
+// shares all doublings between the two scalars and takes the multiples of $-A$
+// from the table of the context. Then $-R$ is added and the result is
+// multiplied by the cofactor 8. The return value is `M25519_ERR_SIGVER` when
+// the signature is invalid.
+
+int ed25519_verify_ctx(const Byte *signature, const Byte *message, \
+  size_t mlen, const Ed25519VCtx *ctx)
+{
+  Word rn[3*LEN], s[LEN], h[LEN], tmp[6*LEN];
+  Point r = { 6, tmp }, q = { 3, rn };
+  int err;
+
+  err = ed25519_decode_sig(rn, s, h, NULL, signature, message, mlen, ctx->pk);
+  if (err != M25519_NO_ERROR) return err;
+  ted_mul_dblbase_tbl(&r, s, h, ctx->tbl, &ECDOMPAR25519);
+  ted_add(&r, &q);
+
+  return (ed25519_is_small(&r) ? M25519_NO_ERROR : M25519_ERR_SIGVER);
+}
+
+
+// Initialization of an incremental signature verification
+// --------------------------------------------------------
+// The public key and the points $R$ and $s$ of the signature are decoded (see
+// `ed25519_decode_pk` and `ed25519_decode_rs`), and the hash of $R \| A \| M$
+// is started. When the decoding fails, the error code is kept in the context
+// and returned by `ed25519_verify_final`, i.e., the message can be passed to
+// `ed25519_verify_update` nevertheless.
+
+void ed25519_verify_init(Ed25519VStream *ctx, const Byte *signature, \
+  const Byte *pubkey)
+{
+  ctx->err = ed25519_decode_pk(ctx->an, pubkey);
+  if (ctx->err == M25519_NO_ERROR) \
+    ctx->err = ed25519_decode_rs(ctx->rn, ctx->s, signature);
+  sha512_init(&ctx->hctx);
+  sha512_update(&ctx->hctx, signature, 32);
+  sha512_update(&ctx->hctx, pubkey, 32);
+}
+
+
+// Update of an incremental signature verification with a part of the message
+// ---------------------------------------------------------------------------
+
+void ed25519_verify_update(Ed25519VStream *ctx, const Byte *data, size_t dlen)
+{
+  sha512_update(&ctx->hctx, data, dlen);
+}
+
+
+// Finalization of an incremental signature verification
+// -----------------------------------------------------
+// The value $h$ is obtained from the hash of $R \| A \| M$ and the same
+// cofactored verification equation as in `ed25519_verify` is checked. The
+// return value is `M25519_ERR_DECOMP` when the public key can not be
+// decompressed and `M25519_ERR_SIGVER` when the signature is invalid.
+
+int ed25519_verify_final(Ed25519VStream *ctx)
+{
+  Word h[LEN];
+  Byte digest[64];
+
+  sha512_final(&ctx->hctx, digest);
+  if (ctx->err != M25519_NO_ERROR) return ctx->err;
+  ed25519_hash_order(h, digest);
+
+  return ed25519_check(ctx->s, h, ctx->rn, ctx->an);
+}
+
+
+// Batch verification of Ed25519 signatures
+// ----------------------------------------
+// The `n` signatures are processed in groups of (at most) `ED25519_MAXBATCH`.
+// For each group, the signatures that can be decoded are combined with 128-
+// bit coefficients $z_i$ to the single equation $8((\sum_i z_i s_i) G -
+// \sum_i z_i R_i - \sum_i (z_i h_i) A_i) = O$, which is checked with one
+// multi-scalar multiplication of $2m + 1$ points. The coefficients are derived
+// from a SHA-512 digest of all signatures, public keys and digests $h_i$ of the
+// group (i.e., they are unpredictable for anyone who can not find a batch with
+// a forged signature that hashes to "suitable" coefficients), and bit 127 of
+// each $z_i$ is set so that $z_i \neq 0$. When the combined equation does not
+// hold, each signature of the group is verified separately (re-using the
+// decoded points and scalars) to find the invalid ones. The error code of the
+// i-th signature is written to err[i] when `err` is not `NULL`, and the return
+// value is the OR of the error codes of all signatures. The decoded points
+// and the scalars of a group are kept in the array `scratch` provided by the
+// caller (`ED25519_BATCHWORDS` words, i.e., about 10 kB with the default value
+// of `TED_MAXMULTI`), so that the stack usage is dominated by that of
+// `ted_mul_multi` and does not grow with `ED25519_MAXBATCH` (apart from the
+// array of `Point` structures and the error codes of a group).
+
+int ed25519_verify_batch(const Byte *sig[], const Byte *msg[], \
+  const size_t mlen[], const Byte *pk[], int n, int *err, Word *scratch)
+{
+  Word *pts = scratch, *k = &scratch[(2*ED25519_MAXBATCH+1)*3*LEN];
+  Word *s = &k[(2*ED25519_MAXBATCH+1)*LEN], *h = &s[ED25519_MAXBATCH*LEN];
+  Word z[2*LEN], prod[2*LEN], tmp[6*LEN], idx;
+  Point p[2*ED25519_MAXBATCH+1], r = { 6, tmp };
+  const ECDomPar *d = &ECDOMPAR25519;
+  SHA512Ctx ctx;
+  Byte seed[64+4], dig[64];
+  int e[ED25519_MAXBATCH];
+  int base, j, m, np, rval = M25519_NO_ERROR;
+
+  for (base = 0; base < n; base += ED25519_MAXBATCH) {
+    m = ((n - base) < ED25519_MAXBATCH) ? (n - base) : ED25519_MAXBATCH;
+
+    // decoding of the signatures and public keys
+    sha512_init(&ctx);
+    for (j = 0; j < m; j++) {
+      e[j] = ed25519_decode(&pts[(2*j+1)*3*LEN], &pts[(2*j+2)*3*LEN], \
+        &s[j*LEN], &h[j*LEN], dig, sig[base+j], msg[base+j], mlen[base+j], \
+        pk[base+j]);
+      if (e[j] != M25519_NO_ERROR) continue;
+      sha512_update(&ctx, sig[base+j], 64);
+      sha512_update(&ctx, pk[base+j], 32);
+      sha512_update(&ctx, dig, 64);
+    }
+    sha512_final(&ctx, seed);
+
+    // random linear combination of the valid signatures
+    np = 1;
+    p[0].dim = 3;
+    p[0].xyz = (Word *) TEDGENEA;
+    mpi_setw(k, 0, LEN);
+    mpi_setw(z, 0, 2*LEN);
+    for (j = 0; j < m; j++) {
+      if (e[j] != M25519_NO_ERROR) continue;
+      idx = (Word) j;
+      ed25519_to_bytes(&seed[64], &idx, 1);
+      sha512_hash(dig, seed, 64 + 4);
+      ed25519_from_bytes(z, dig, 4);
+      z[3] |= ((Word) 1) << (WSIZE - 1);
+      // coefficient of G: sum of z_i*s_i
+      mpi_mul8(prod, z, &s[j*LEN]);
+      ed25519_mod_order(prod, prod, d);
+      ed25519_add_order(k, k, prod, d);
+      // coefficient of -R_i: z_i
+      p[np].dim = 3;
+      p[np].xyz = &pts[(2*j+1)*3*LEN];
+      mpi_copy(&k[np*LEN], z, LEN);
+      np++;
+      // coefficient of -A_i: z_i*h_i
+      mpi_mul8(prod, z, &h[j*LEN]);
+      p[np].dim = 3;
+      p[np].xyz = &pts[(2*j+2)*3*LEN];
+      ed25519_mod_order(&k[np*LEN], prod, d);
+      ed25519_fred_order(&k[np*LEN], &k[np*LEN], d);
+      np++;
+    }
+    ed25519_fred_order(k, k, d);
+
+    if (np > 1) {
+      ted_mul_multi(&r, k, p, np, d);
+      if (!ed25519_is_small(&r)) {
+        // fall back to the verification of each signature of the group
+        for (j = 0; j < m; j++) {
+          if (e[j] != M25519_NO_ERROR) continue;
+          e[j] = ed25519_check(&s[j*LEN], &h[j*LEN], &pts[(2*j+1)*3*LEN], \
+            &pts[(2*j+2)*3*LEN]);
+        }
+      }
+    }
+
+    for (j = 0; j < m; j++) {
+      if (err != NULL) err[base+j] = e[j];
+      rval |= e[j];
+    }
+  }
+
+  return rval;
+}
@@ -0,0 +1,139 @@
+///////////////////////////////////////////////////////////////////////////////
+// ed25519.h: Ed25519 signatures using the curve Edwards25519.               //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ED25519_H
+#define _ED25519_H
+
+#include <stddef.h>
+#include "config.h"
+#include "profile.h"
+#include "tedcurve.h"
+#include "x25519.h"
+
+// Maximum number of signatures that are verified together (i.e., with a
+// single multi-scalar multiplication) by `ed25519_verify_batch`
+
+#define ED25519_MAXBATCH ((TED_MAXMULTI - 1)/2)
+
+// Number of Words of the scratch space that the caller of the batch
+// verification has to provide: the decoded points $-R_i$ and $-A_i$ (plus
+// the base point), the scalars of the multi-scalar multiplication, and the
+// values $s_i$ and $h_i$ of a group of `ED25519_MAXBATCH` signatures
+
+#define ED25519_BATCHWORDS ((2*ED25519_MAXBATCH + 1)*4*LEN + \
+  2*ED25519_MAXBATCH*LEN)
+
+// Verification context of a public key: the compressed public key $A$ (which
+// is hashed together with $R$ and the message) and the comb table of $-A$.
+// A context only contains constant data and can be placed in flash memory.
+
+typedef struct ed25519_vctx {
+  Byte pk[32];              // compressed public key
+  Word tbl[TED_COMBWORDS];  // comb table of -A (see `ted_comb_table`)
+} Ed25519VCtx;
+
+// Signing context of a private key: the expanded private key (i.e., the
+// pruned scalar $a$ and the prefix for the nonce) and the compressed public
+// key $A$. A context contains secret data and must be wiped with
+// `ed25519_sign_ctx_wipe` when it is not needed anymore. The serialized form
+// of a context (see `ed25519_sign_ctx_store`) has `ED25519_SCTXBYTES` bytes.
+
+typedef struct ed25519_sctx {
+  Word a[LEN];      // secret scalar (pruned)
+  Byte prefix[32];  // second half of the hashed private key
+  Byte pk[32];      // compressed public key
+} Ed25519SCtx;
+
+#define ED25519_SCTXBYTES 96
+
+// Context of an incremental (two-pass) signature generation: the message is
+// hashed in a first pass to get the nonce $r$ and in a second pass to get $h
+// = \mathrm{SHA512}(R \| A \| M)$. In the second pass, the hash of the first
+// pass is re-computed in `cctx` so that a modified message can be detected.
+
+typedef struct ed25519_sstream {
+  SHA512Ctx hctx;   // hash of nonce (1st pass) or of challenge (2nd pass)
+  SHA512Ctx cctx;   // re-computation of the nonce in the 2nd pass
+  Word a[LEN];      // secret scalar
+  Word r[LEN];      // nonce (modulo 8*l)
+  Byte prefix[32];  // second half of the hashed private key
+  Byte pk[32];      // compressed public key
+  Byte rc[32];      // compressed point R
+  int pass;         // current pass (1 or 2), 0 when not initialized
+} Ed25519SStream;
+
+// Context of an incremental (one-pass) signature verification: the decoded
+// points $-R$ and $-A$, the scalar $s$, and the hash of $R \| A \| M$.
+
+typedef struct ed25519_vstream {
+  SHA512Ctx hctx;   // hash of challenge
+  Word rn[3*LEN];   // point -R in extended affine coordinates
+  Word an[3*LEN];   // point -A in extended affine coordinates
+  Word s[LEN];      // scalar s of the signature
+  int err;          // error code of the decoding
+} Ed25519VStream;
+
+// prototypes of functions with C implementations only
+void gfp_exp_p58(Word *r, const Word *a);
+void ted_compress(Word *r, const Point *a);
+int  ted_compress_batch(Word *r, const Point *p, int n, Word *scratch);
+int  ted_decompress(Point *r, const Word *a, const ECDomPar *d);
+void ed25519_add_order(Word *r, const Word *a, const Word *b, \
+  const ECDomPar *d);
+void ed25519_fred_order(Word *r, const Word *a, const ECDomPar *d);
+int  ed25519_sign(Byte *signature, const Byte *message, size_t mlen, \
+  const Byte *keypair);
+int  ed25519_sign_ctx_init(Ed25519SCtx *ctx, const Byte *privkey, \
+  const Byte *pubkey);
+void ed25519_sign_ctx_wipe(Ed25519SCtx *ctx);
+void ed25519_sign_ctx_store(Byte *buf, const Ed25519SCtx *ctx);
+int  ed25519_sign_ctx_load(Ed25519SCtx *ctx, const Byte *buf);
+int  ed25519_sign_ctx(Byte *signature, const Byte *message, size_t mlen, \
+  const Ed25519SCtx *ctx);
+void ed25519_sign_init(Ed25519SStream *ctx, const Byte *keypair);
+void ed25519_sign_update(Ed25519SStream *ctx, const Byte *data, size_t dlen);
+int  ed25519_sign_commit(Ed25519SStream *ctx);
+int  ed25519_sign_final(Ed25519SStream *ctx, Byte *signature);
+int  ed25519_verify(const Byte *signature, const Byte *message, size_t mlen, \
+  const Byte *pubkey);
+void ed25519_verify_init(Ed25519VStream *ctx, const Byte *signature, \
+  const Byte *pubkey);
+void ed25519_verify_update(Ed25519VStream *ctx, const Byte *data, \
+  size_t dlen);
+int  ed25519_verify_final(Ed25519VStream *ctx);
+
+// prototypes of functions with C and ASM implementations (the ASM version of
+// `ed25519_mod_order` is specific to the group order of Edwards25519 and does
+// not use the domain parameters); when profiling, the ASM version is counted
+// like the C version, i.e., as two calls of `mpi_mul9` and three of `mpi_sub`
+#if defined(M25519_ASSEMBLY_EXT)  // ASM functions are available
+extern void ed25519_mod_order_asm(Word *r, const Word *a);
+#define ed25519_mod_order(r, a, d) ((void) (d), \
+  M25519_PROF_ADD(MPI_MUL9, 2), M25519_PROF_ADD(MPI_SUB, 3), \
+  ed25519_mod_order_asm((r), (a)))
+#else  // ASM functions are not available or not used
+void ed25519_mod_order(Word *r, const Word *a, const ECDomPar *d);
+#endif
+int  ed25519_verify_ctx_init(Ed25519VCtx *ctx, const Byte *pubkey);
+int  ed25519_verify_ctx(const Byte *signature, const Byte *message, \
+  size_t mlen, const Ed25519VCtx *ctx);
+int  ed25519_verify_batch(const Byte *sig[], const Byte *msg[], \
+  const size_t mlen[], const Byte *pk[], int n, int *err, Word *scratch);
+
+#endif
@@ -138,7 +138,9 @@ int gfp_cmpp(const Word *a)
 
 
 ///////////////////////////////////////////////////////////////////////////////
-#if !defined(M25519_ASSEMBLY) // PERFORMANCE-CRITICAL PRIME-FIELD OPERATIONS //
+//////////////////// PERFORMANCE-CRITICAL PRIME-FIELD OPERATIONS //////////////
+#if ((!defined(M25519_ASSEMBLY) && !defined(M25519_HOST64)) || \
+     defined(M25519_OPSTBL)) //////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
 
@@ -147,7 +149,15 @@ int gfp_cmpp(const Word *a)
 // or fixed-base comb method) or the main loop of the inversion in GF(p) based
 // on the extended Euclidean algorithm. In addition to the C implementations,
 // there exist also highly-optimized Assembly versions of these functions (for
-// certain target architectures like AVR, MSP430, ARMv7-M or RV32IM).
+// certain target architectures like AVR, MSP430, ARMv7-M or RV32IM) and a
+// 64-bit C implementation for x86-64 and AArch64 in `host64/gfparith51.c`.
+// In ops-table mode (`M25519_OPSTBL`), the C functions are always compiled
+// and are part of the C99 backend, even when Assembly versions are available.
+// Their names are put in parentheses so that the function-like macros that
+// call the kernels via the ops table (see `gfparith.h`) are not expanded.
+
+
+#if !defined(M25519_C_UNROLLED)  // rolled (size-optimized) variants
 
 
 // Addition of two field-elements: $r = a + b \bmod p$
@@ -163,12 +173,13 @@ int gfp_cmpp(const Word *a)
 // the constant `c` and the product, which fits in a single word, is included
 // in the addition of the two operands.
 
-void gfp_add(Word *r, const Word *a, const Word *b)
+void (gfp_add)(Word *r, const Word *a, const Word *b)
 {
   DWord sum;
   Word msw;
   int i;
 
+  M25519_PROF_KINC(GFP_ADD);
   sum = (DWord) a[LEN-1] + b[LEN-1];
   msw = ((Word) sum) & MSB0MASK;  // 0x7FFFFFFF
   sum = (DWord) CONSTC*((Word) (sum >> (WSIZE - 1)));
@@ -199,12 +210,13 @@ void gfp_add(Word *r, const Word *a, const Word *b)
 // latter part is added after the subtraction-loop (to ensure that a negative
 // sum from the loop does not make r[len-1] negative).
 
-void gfp_sub(Word *r, const Word *a, const Word *b)
+void (gfp_sub)(Word *r, const Word *a, const Word *b)
 {
   SDWord sum;  // signed!
   Word msw;
   int i;
 
+  M25519_PROF_KINC(GFP_SUB);
   sum = (SDWord) FOURXPHI + a[LEN-1] - b[LEN-1];  // 0x1FFFFFFFC
   msw = ((Word) sum) & MSB0MASK;  // 0x7FFFFFFF
   sum = (SDWord) CONSTC*((Word) (sum >> (WSIZE - 1)));
@@ -237,12 +249,13 @@ void gfp_sub(Word *r, const Word *a, const Word *b)
 // `a`, or 0, which leaves operand $a$ unmodified. Furthermore, a conditional
 // (i.e., AND-masked) subtraction of $2c - 1$ is included in the computation.
 
-void gfp_cneg(Word *r, const Word *a, int neg)
+void (gfp_cneg)(Word *r, const Word *a, int neg)
 {
   SDWord sum;  // signed!
   Word msw, mask;
   int i;
 
+  M25519_PROF_KINC(GFP_CNEG);
   mask = 0 - (Word) (neg & 1);  // 0 or all-1
   sum = (SDWord) MIN4MASK + (mask ^ a[LEN-1]);  // 0xFFFFFFFC
   msw = ((Word) sum) & MSB0MASK;  // 0x7FFFFFFF
@@ -274,12 +287,13 @@ void gfp_cneg(Word *r, const Word *a, int neg)
 // (i.e., the sum of the last iteration) to be able to perform the 1-bit right-
 // shift. Due to the right-shift, the result will always fit into $len$ words.
 
-void gfp_hlv(Word *r, const Word *a)
+void (gfp_hlv)(Word *r, const Word *a)
 {
   SDWord sum;  // signed!
   Word tmp, mask;
   int i;
 
+  M25519_PROF_KINC(GFP_HLV);
   // masked addition of prime p to a
   mask = 0 - (a[0] & 1);  // 0 or all-1
   sum = (SDWord) a[0] - (CONSTC & mask);
@@ -300,6 +314,9 @@ void gfp_hlv(Word *r, const Word *a)
 }
 
 
+#if !defined(M25519_COMBA_MUL)  // operand-scanning variants
+
+
 // Multiplication of two field-elements: $r = a \cdot b \bmod p$
 // -------------------------------------------------------------
 // The multiplication in GF(p) consists of an "ordinary" multiplication of the
@@ -315,13 +332,14 @@ void gfp_hlv(Word *r, const Word *a)
 // significant word is up to $WSIZE-1$ bits long. Thereafter, the second step
 // is similar to the reduction-step of the addition in GF(p).
 
-void gfp_mul(Word *r, const Word *a, const Word *b)
+void (gfp_mul)(Word *r, const Word *a, const Word *b)
 {
   Word t[2*LEN];
   DWord prod = 0;
   Word msw;
   int i, j;
 
+  M25519_PROF_KINC(GFP_MUL);
   // multiplication of A by b[0]
   for (j = 0; j < LEN; j++) {
     prod += (DWord) a[j]*b[0];
@@ -379,13 +397,14 @@ void gfp_mul(Word *r, const Word *a, const Word *b)
 // reduction modulo $p$ is performed in the same way as for the multiplication
 // in GF(p).
 
-void gfp_sqr(Word *r, const Word *a)
+void (gfp_sqr)(Word *r, const Word *a)
 {
   Word t[2*LEN];
   DWord prod = 0, sum = 0;
   Word msw;
   int i, j;
 
+  M25519_PROF_KINC(GFP_SQR);
   // multiplication of A[1,...,LEN-1] by a[0] (to avoid r <- 0)
   t[0] = 0;
   for (j = 1; j < LEN; j++) {
@@ -441,6 +460,150 @@ void gfp_sqr(Word *r, const Word *a)
   r[LEN-1] = msw + ((Word) prod);
 }
 
+#else  // product-scanning (Comba) multiplication and squaring
+
+
+// Multiplication of two field-elements: $r = a \cdot b \bmod p$
+// -------------------------------------------------------------
+// This variant of the multiplication in GF(p), which is used when the macro
+// `M25519_COMBA_MUL` is defined, is based on the product-scanning technique
+// and integrates the first step of the modular reduction into the computation
+// of the partial products. In each iteration $k$ of the outer loop, column $k$
+// (i.e., the partial products a[i]*b[j] with $i + j = k$) is accumulated in a
+// three-word accumulator, which also holds the carry from the previous column.
+// Then, column $k+len$ is computed in a second three-word accumulator and its
+// sum is multiplied by $2c$ and added to the first one, after which the lowest
+// word of the first accumulator is stored in `t[k]` and the accumulator is
+// shifted one word to the right. Consequently, only $len$ words of temporary
+// space are needed on the stack (for the case that `r` is the same array as
+// `a` or `b`) instead of $2len$ words, and the partial products are not loaded
+// from and stored to RAM, which reduces the memory traffic on 8/16-bit targets.
+// The second step of the modular reduction is the same as in the operand-
+// scanning variant, whereby the carry from the last column is included.
+
+void (gfp_mul)(Word *r, const Word *a, const Word *b)
+{
+  Word t[LEN];
+  DWord prod, accl = 0, suml;
+  Word acce = 0, sume, tmp, msw;
+  int i, k;
+  
+  M25519_PROF_KINC(GFP_MUL);
+  for (k = 0; k < LEN; k++) {
+    // column k of the product: a[i]*b[k-i] for 0 <= i <= k
+    for (i = 0; i <= k; i++) {
+      prod = (DWord) a[i]*b[k-i];
+      accl += prod;
+      acce += (accl < prod);
+    }
+    // column k+LEN of the product: a[i]*b[k+LEN-i] for k < i < LEN
+    suml = 0; sume = 0;
+    for (i = k + 1; i < LEN; i++) {
+      prod = (DWord) a[i]*b[k+LEN-i];
+      suml += prod;
+      sume += (suml < prod);
+    }
+    // first step of modular reduction: column k+LEN times 2c plus column k
+    prod = (DWord) ((Word) suml)*(CONSTC << 1) + ((Word) accl);
+    t[k] = (Word) prod;
+    prod >>= WSIZE;
+    prod += (DWord) ((Word) (suml >> WSIZE))*(CONSTC << 1) + (accl >> WSIZE);
+    tmp = (Word) prod;
+    prod >>= WSIZE;
+    prod += (DWord) sume*(CONSTC << 1) + acce;
+    accl = (prod << WSIZE) | tmp;
+    acce = (Word) (prod >> WSIZE);
+  }
+  // accl is in [0, 2^(WSIZE+4)-1] and acce is 0
+  
+  // second step of modular reduction
+  msw = t[LEN-1] & MSB0MASK;  // 0x7FFFFFFF
+  prod = (DWord) CONSTC*((accl << 1) | (t[LEN-1] >> (WSIZE - 1)));
+  for (i = 0; i < LEN - 1; i++) {
+    prod += t[i];
+    r[i] = (Word) prod;
+    prod >>= WSIZE;
+  }
+  r[LEN-1] = msw + ((Word) prod);
+}
+
+
+// Squaring of a field-element: $r = a^2 \bmod p$
+// ----------------------------------------------
+// The product-scanning variant of the squaring has the same structure as the
+// multiplication above, but computes each partial product a[i]*a[j] with $i <
+// j$ only once. These partial products are summed up in the second three-word
+// accumulator, which is then doubled and added to the first accumulator (for
+// column $k$) or multiplied by $2c$ after the addition of the square in the
+// main diagonal (for column $k+len$).
+
+void (gfp_sqr)(Word *r, const Word *a)
+{
+  Word t[LEN];
+  DWord prod, accl = 0, suml;
+  Word acce = 0, sume, tmp, msw;
+  int i, k;
+  
+  M25519_PROF_KINC(GFP_SQR);
+  for (k = 0; k < LEN; k++) {
+    // column k of the square: 2*a[i]*a[k-i] for 0 <= i < k-i and a[k/2]^2
+    suml = 0; sume = 0;
+    for (i = 0; 2*i < k; i++) {
+      prod = (DWord) a[i]*a[k-i];
+      suml += prod;
+      sume += (suml < prod);
+    }
+    sume = (sume << 1) | ((Word) (suml >> (2*WSIZE - 1)));
+    suml <<= 1;
+    accl += suml;
+    acce += sume + (accl < suml);
+    if ((k & 1) == 0) {
+      prod = (DWord) a[k>>1]*a[k>>1];
+      accl += prod;
+      acce += (accl < prod);
+    }
+    // column k+LEN of the square: 2*a[i]*a[k+LEN-i] for k < i < k+LEN-i and
+    // a[(k+LEN)/2]^2
+    suml = 0; sume = 0;
+    for (i = k + 1; 2*i < k + LEN; i++) {
+      prod = (DWord) a[i]*a[k+LEN-i];
+      suml += prod;
+      sume += (suml < prod);
+    }
+    sume = (sume << 1) | ((Word) (suml >> (2*WSIZE - 1)));
+    suml <<= 1;
+    if ((((k + LEN) & 1) == 0) && (k < LEN - 1)) {
+      prod = (DWord) a[(k+LEN)>>1]*a[(k+LEN)>>1];
+      suml += prod;
+      sume += (suml < prod);
+    }
+    // first step of modular reduction: column k+LEN times 2c plus column k
+    prod = (DWord) ((Word) suml)*(CONSTC << 1) + ((Word) accl);
+    t[k] = (Word) prod;
+    prod >>= WSIZE;
+    prod += (DWord) ((Word) (suml >> WSIZE))*(CONSTC << 1) + (accl >> WSIZE);
+    tmp = (Word) prod;
+    prod >>= WSIZE;
+    prod += (DWord) sume*(CONSTC << 1) + acce;
+    accl = (prod << WSIZE) | tmp;
+    acce = (Word) (prod >> WSIZE);
+  }
+  // accl is in [0, 2^(WSIZE+4)-1] and acce is 0
+  
+  // second step of modular reduction
+  msw = t[LEN-1] & MSB0MASK;  // 0x7FFFFFFF
+  prod = (DWord) CONSTC*((accl << 1) | (t[LEN-1] >> (WSIZE - 1)));
+  for (i = 0; i < LEN - 1; i++) {
+    prod += t[i];
+    r[i] = (Word) prod;
+    prod >>= WSIZE;
+  }
+  r[LEN-1] = msw + ((Word) prod);
+}
+
+
+#endif  // #if !defined(M25519_COMBA_MUL)
+
 
 // Multiplication of a field-element by a 32-bit value: $r = a \cdot b \bmod p$
 // ----------------------------------------------------------------------------
@@ -456,13 +619,14 @@ void gfp_sqr(Word *r, const Word *a)
 // the resulting carry is propagated up to the most-significant word t[len-1],
 // whose MSB has been cleared before the carry propagation.
 
-void gfp_mul32(Word *r, const Word *a, const Word *b)
+void (gfp_mul32)(Word *r, const Word *a, const Word *b)
 {
   Word t[LEN+1];
   DWord prod = 0;
   Word msw;
   int i = 0, j;
 
+  M25519_PROF_KINC(GFP_MUL32);
   // multiplication of A by b[0]
   for (j = 0; j < LEN; j++) {
     prod += (DWord) a[j]*b[0];
@@ -489,6 +653,388 @@ void gfp_mul32(Word *r, const Word *a, const Word *b)
   r[LEN-1] = ((Word) prod) + msw;
 }
 
+#else  // fully unrolled variants for LEN = 8
+
+
+#if (LEN != 8)
+#error "M25519_C_UNROLLED requires LEN = 8 (i.e., 32-bit Words)"
+#endif
+
+
+// The functions below are fully unrolled versions of the performance-critical
+// field operations above, which are used instead of the rolled versions when
+// the macro `M25519_C_UNROLLED` is defined. They execute exactly the same
+// sequence of arithmetic operations as their rolled counterparts and produce
+// the same results, but all loops are written out via the macros below, so
+// that all array indices are compile-time constants. This allows compilers to
+// keep the operands and the intermediate product in registers and to translate
+// each macro into a short branch-free instruction sequence (e.g., `umaal` on
+// ARMv7E-M/ARMv8-M Mainline or an add-with-carry chain on other targets). The
+// carries are always propagated through a double-length accumulator and never
+// computed with comparisons, which is important for constant execution time.
+
+
+// ACC_ADDW: add word `w` to accumulator `acc`, store the lower word of `acc`
+// in `r` and shift `acc` one word to the right (`acc` may be signed).
+#define ACC_ADDW(acc, r, w) do { \
+  (acc) += (w); (r) = (Word) (acc); (acc) >>= WSIZE; } while (0)
+
+// MUL_ADDC: compute `r` = lower word and `c` = upper word of a*b + c
+#define MUL_ADDC(r, c, a, b) do { \
+  DWord p_ = (DWord) (a)*(b) + (c); \
+  (r) = (Word) p_; (c) = (Word) (p_ >> WSIZE); } while (0)
+
+// MUL_ACC2: compute `t` = lower word and `c` = upper word of a*b + t + c,
+// which can not overflow a DWord (and corresponds to `umaal` on ARM)
+#define MUL_ACC2(t, c, a, b) do { \
+  DWord p_ = (DWord) (a)*(b) + (t) + (c); \
+  (t) = (Word) p_; (c) = (Word) (p_ >> WSIZE); } while (0)
+
+// MUL_ROW0: t[0..8] = A*b (first row of the operand-scanning product)
+#define MUL_ROW0(t, a, b) do { Word c_ = 0; \
+  MUL_ADDC(t[0], c_, a[0], b); MUL_ADDC(t[1], c_, a[1], b); \
+  MUL_ADDC(t[2], c_, a[2], b); MUL_ADDC(t[3], c_, a[3], b); \
+  MUL_ADDC(t[4], c_, a[4], b); MUL_ADDC(t[5], c_, a[5], b); \
+  MUL_ADDC(t[6], c_, a[6], b); MUL_ADDC(t[7], c_, a[7], b); \
+  t[8] = c_; } while (0)
+
+// MUL_ROWI: t[i..i+8] = t[i..i+7] + A*b (row i of the product)
+#define MUL_ROWI(t, i, a, b) do { Word c_ = 0; \
+  MUL_ACC2(t[(i)+0], c_, a[0], b); MUL_ACC2(t[(i)+1], c_, a[1], b); \
+  MUL_ACC2(t[(i)+2], c_, a[2], b); MUL_ACC2(t[(i)+3], c_, a[3], b); \
+  MUL_ACC2(t[(i)+4], c_, a[4], b); MUL_ACC2(t[(i)+5], c_, a[5], b); \
+  MUL_ACC2(t[(i)+6], c_, a[6], b); MUL_ACC2(t[(i)+7], c_, a[7], b); \
+  t[(i)+8] = c_; } while (0)
+
+// RED_2STEP: reduction of the 16-word product `t` modulo p, the first step
+// adds t[8..15]*2c to t[0..7] and the second step folds the bits above bit
+// position 255 (multiplied by c) into the lower words; the result is put in r
+#define RED_2STEP(r, t) do { \
+  Word c_ = 0, msw_, hi_; DWord s_; \
+  MUL_ACC2(t[0], c_, t[8], (CONSTC << 1)); \
+  MUL_ACC2(t[1], c_, t[9], (CONSTC << 1)); \
+  MUL_ACC2(t[2], c_, t[10], (CONSTC << 1)); \
+  MUL_ACC2(t[3], c_, t[11], (CONSTC << 1)); \
+  MUL_ACC2(t[4], c_, t[12], (CONSTC << 1)); \
+  MUL_ACC2(t[5], c_, t[13], (CONSTC << 1)); \
+  MUL_ACC2(t[6], c_, t[14], (CONSTC << 1)); \
+  MUL_ACC2(t[7], c_, t[15], (CONSTC << 1)); \
+  msw_ = t[7] & MSB0MASK; \
+  hi_ = (c_ << 1) | (t[7] >> (WSIZE - 1)); \
+  s_ = (DWord) CONSTC*hi_; \
+  ACC_ADDW(s_, r[0], t[0]); ACC_ADDW(s_, r[1], t[1]); \
+  ACC_ADDW(s_, r[2], t[2]); ACC_ADDW(s_, r[3], t[3]); \
+  ACC_ADDW(s_, r[4], t[4]); ACC_ADDW(s_, r[5], t[5]); \
+  ACC_ADDW(s_, r[6], t[6]); \
+  r[7] = msw_ + ((Word) s_); } while (0)
+
+
+// Addition of two field-elements: $r = a + b \bmod p$ (unrolled version)
+
+void (gfp_add)(Word *r, const Word *a, const Word *b)
+{
+  DWord sum;
+  Word msw;
+
+  M25519_PROF_KINC(GFP_ADD);
+  sum = (DWord) a[7] + b[7];
+  msw = ((Word) sum) & MSB0MASK;  // 0x7FFFFFFF
+  sum = (DWord) CONSTC*((Word) (sum >> (WSIZE - 1)));
+  ACC_ADDW(sum, r[0], (DWord) a[0] + b[0]);
+  ACC_ADDW(sum, r[1], (DWord) a[1] + b[1]);
+  ACC_ADDW(sum, r[2], (DWord) a[2] + b[2]);
+  ACC_ADDW(sum, r[3], (DWord) a[3] + b[3]);
+  ACC_ADDW(sum, r[4], (DWord) a[4] + b[4]);
+  ACC_ADDW(sum, r[5], (DWord) a[5] + b[5]);
+  ACC_ADDW(sum, r[6], (DWord) a[6] + b[6]);
+  r[7] = msw + ((Word) sum);
+}
+
+
+// Subtraction of one field-element from another: $r = a - b \bmod p$
+// (unrolled version)
+
+void (gfp_sub)(Word *r, const Word *a, const Word *b)
+{
+  SDWord sum;  // signed!
+  Word msw;
+
+  M25519_PROF_KINC(GFP_SUB);
+  sum = (SDWord) FOURXPHI + a[7] - b[7];  // 0x1FFFFFFFC
+  msw = ((Word) sum) & MSB0MASK;  // 0x7FFFFFFF
+  sum = (SDWord) CONSTC*((Word) (sum >> (WSIZE - 1)));
+  sum = sum - (CONSTC << 2);
+  ACC_ADDW(sum, r[0], (SDWord) a[0] - b[0]);  // arithmetic shift!
+  ACC_ADDW(sum, r[1], (SDWord) a[1] - b[1]);
+  ACC_ADDW(sum, r[2], (SDWord) a[2] - b[2]);
+  ACC_ADDW(sum, r[3], (SDWord) a[3] - b[3]);
+  ACC_ADDW(sum, r[4], (SDWord) a[4] - b[4]);
+  ACC_ADDW(sum, r[5], (SDWord) a[5] - b[5]);
+  ACC_ADDW(sum, r[6], (SDWord) a[6] - b[6]);
+  r[7] = msw + ((Word) sum) + 4;
+}
+
+
+// Conditional negation of a field-element: $r = -a \bmod p$ or $r = a \bmod p$
+// (unrolled version)
+
+void (gfp_cneg)(Word *r, const Word *a, int neg)
+{
+  SDWord sum;  // signed!
+  Word msw, mask;
+
+  M25519_PROF_KINC(GFP_CNEG);
+  mask = 0 - (Word) (neg & 1);  // 0 or all-1
+  sum = (SDWord) MIN4MASK + (mask ^ a[7]);  // 0xFFFFFFFC
+  msw = ((Word) sum) & MSB0MASK;  // 0x7FFFFFFF
+  sum = (SDWord) CONSTC*((Word) (sum >> (WSIZE - 1)));
+  sum = sum - (CONSTC << 1) - (mask & ((CONSTC << 1) - 1));
+  ACC_ADDW(sum, r[0], (SDWord) (mask ^ a[0]));  // arithmetic shift!
+  ACC_ADDW(sum, r[1], (SDWord) (mask ^ a[1]));
+  ACC_ADDW(sum, r[2], (SDWord) (mask ^ a[2]));
+  ACC_ADDW(sum, r[3], (SDWord) (mask ^ a[3]));
+  ACC_ADDW(sum, r[4], (SDWord) (mask ^ a[4]));
+  ACC_ADDW(sum, r[5], (SDWord) (mask ^ a[5]));
+  ACC_ADDW(sum, r[6], (SDWord) (mask ^ a[6]));
+  r[7] = msw + ((Word) sum) + 4;
+}
+
+
+// Halving of a field-element: $r = a/2 \bmod p$ (unrolled version)
+// ----------------------------------------------------------------
+// The sums are stored in a temporary array `t` first, so that the 1-bit right-
+// shift can be performed afterwards without keeping track of the previous sum.
+
+void (gfp_hlv)(Word *r, const Word *a)
+{
+  SDWord sum;  // signed!
+  Word t[LEN], mask;
+
+  M25519_PROF_KINC(GFP_HLV);
+  // masked addition of prime p to a
+  mask = 0 - (a[0] & 1);  // 0 or all-1
+  sum = 0 - (SDWord) (CONSTC & mask);
+  ACC_ADDW(sum, t[0], (SDWord) a[0]);  // arithmetic shift!
+  ACC_ADDW(sum, t[1], (SDWord) a[1]);
+  ACC_ADDW(sum, t[2], (SDWord) a[2]);
+  ACC_ADDW(sum, t[3], (SDWord) a[3]);
+  ACC_ADDW(sum, t[4], (SDWord) a[4]);
+  ACC_ADDW(sum, t[5], (SDWord) a[5]);
+  ACC_ADDW(sum, t[6], (SDWord) a[6]);
+  sum += (SDWord) a[7] + (MSB1MASK & mask);  // 0x80000000
+  t[7] = (Word) sum;
+  // 1-bit right-shift of the (WSIZE*LEN+1)-bit sum
+  r[0] = (t[1] << (WSIZE - 1)) | (t[0] >> 1);
+  r[1] = (t[2] << (WSIZE - 1)) | (t[1] >> 1);
+  r[2] = (t[3] << (WSIZE - 1)) | (t[2] >> 1);
+  r[3] = (t[4] << (WSIZE - 1)) | (t[3] >> 1);
+  r[4] = (t[5] << (WSIZE - 1)) | (t[4] >> 1);
+  r[5] = (t[6] << (WSIZE - 1)) | (t[5] >> 1);
+  r[6] = (t[7] << (WSIZE - 1)) | (t[6] >> 1);
+  r[7] = (Word) (sum >> 1);
+}
+
+
+// Multiplication of two field-elements: $r = a \cdot b \bmod p$
+// (unrolled version of the operand-scanning multiplication)
+
+void (gfp_mul)(Word *r, const Word *a, const Word *b)
+{
+  Word t[2*LEN];
+
+  M25519_PROF_KINC(GFP_MUL);
+  MUL_ROW0(t, a, b[0]);
+  MUL_ROWI(t, 1, a, b[1]);
+  MUL_ROWI(t, 2, a, b[2]);
+  MUL_ROWI(t, 3, a, b[3]);
+  MUL_ROWI(t, 4, a, b[4]);
+  MUL_ROWI(t, 5, a, b[5]);
+  MUL_ROWI(t, 6, a, b[6]);
+  MUL_ROWI(t, 7, a, b[7]);
+  RED_2STEP(r, t);
+}
+
+
+// Squaring of a field-element: $r = a^2 \bmod p$
+// (unrolled version of the operand-scanning squaring)
+
+void (gfp_sqr)(Word *r, const Word *a)
+{
+  Word t[2*LEN], c;
+  DWord prod, sum = 0;
+
+  M25519_PROF_KINC(GFP_SQR);
+  // partial products a[j]*a[i] with j > i, row by row
+  c = 0;
+  MUL_ADDC(t[1], c, a[1], a[0]); MUL_ADDC(t[2], c, a[2], a[0]);
+  MUL_ADDC(t[3], c, a[3], a[0]); MUL_ADDC(t[4], c, a[4], a[0]);
+  MUL_ADDC(t[5], c, a[5], a[0]); MUL_ADDC(t[6], c, a[6], a[0]);
+  MUL_ADDC(t[7], c, a[7], a[0]); t[8] = c;
+  c = 0;
+  MUL_ACC2(t[3], c, a[2], a[1]); MUL_ACC2(t[4], c, a[3], a[1]);
+  MUL_ACC2(t[5], c, a[4], a[1]); MUL_ACC2(t[6], c, a[5], a[1]);
+  MUL_ACC2(t[7], c, a[6], a[1]); MUL_ACC2(t[8], c, a[7], a[1]);
+  t[9] = c;
+  c = 0;
+  MUL_ACC2(t[5], c, a[3], a[2]); MUL_ACC2(t[6], c, a[4], a[2]);
+  MUL_ACC2(t[7], c, a[5], a[2]); MUL_ACC2(t[8], c, a[6], a[2]);
+  MUL_ACC2(t[9], c, a[7], a[2]); t[10] = c;
+  c = 0;
+  MUL_ACC2(t[7], c, a[4], a[3]); MUL_ACC2(t[8], c, a[5], a[3]);
+  MUL_ACC2(t[9], c, a[6], a[3]); MUL_ACC2(t[10], c, a[7], a[3]);
+  t[11] = c;
+  c = 0;
+  MUL_ACC2(t[9], c, a[5], a[4]); MUL_ACC2(t[10], c, a[6], a[4]);
+  MUL_ACC2(t[11], c, a[7], a[4]); t[12] = c;
+  c = 0;
+  MUL_ACC2(t[11], c, a[6], a[5]); MUL_ACC2(t[12], c, a[7], a[5]);
+  t[13] = c;
+  c = 0;
+  MUL_ACC2(t[13], c, a[7], a[6]); t[14] = c;
+  t[0] = 0; t[15] = 0;
+  
+  // double existing result, add squares a[i]^2 for 0 <= i < LEN
+#define SQR_DIAG(i) do { \
+  prod = (DWord) a[i]*a[i]; \
+  sum += (DWord) ((Word) prod) + t[2*(i)] + t[2*(i)]; \
+  t[2*(i)] = (Word) sum; sum >>= WSIZE; \
+  sum += (DWord) ((Word) (prod >> WSIZE)) + t[2*(i)+1] + t[2*(i)+1]; \
+  t[2*(i)+1] = (Word) sum; sum >>= WSIZE; } while (0)
+  SQR_DIAG(0); SQR_DIAG(1); SQR_DIAG(2); SQR_DIAG(3);
+  SQR_DIAG(4); SQR_DIAG(5); SQR_DIAG(6); SQR_DIAG(7);
+#undef SQR_DIAG
+  
+  RED_2STEP(r, t);
+}
+
+
+// Multiplication of a field-element by a 32-bit value: $r = a \cdot b \bmod p$
+// (unrolled version)
+
+void (gfp_mul32)(Word *r, const Word *a, const Word *b)
+{
+  Word t[LEN+1], msw;
+  DWord prod;
+
+  M25519_PROF_KINC(GFP_MUL32);
+  MUL_ROW0(t, a, b[0]);
+  msw = t[7] & MSB0MASK;  // 0x7FFFFFFF
+  prod = (DWord) CONSTC*(t[7] >> (WSIZE - 1));
+  // prod is either 0 or c
+  ACC_ADDW(prod, r[0], (DWord) t[8]*(CONSTC << 1) + t[0]);
+  ACC_ADDW(prod, r[1], t[1]);
+  ACC_ADDW(prod, r[2], t[2]);
+  ACC_ADDW(prod, r[3], t[3]);
+  ACC_ADDW(prod, r[4], t[4]);
+  ACC_ADDW(prod, r[5], t[5]);
+  ACC_ADDW(prod, r[6], t[6]);
+  r[7] = ((Word) prod) + msw;
+}
+
+
+#undef ACC_ADDW
+#undef MUL_ADDC
+#undef MUL_ACC2
+#undef MUL_ROW0
+#undef MUL_ROWI
+#undef RED_2STEP
+
+#endif  // #if !defined(M25519_C_UNROLLED)
+
+
+#endif  // #if ((!defined(M25519_ASSEMBLY) && !defined(M25519_HOST64)) || ...
+#if !defined(M25519_ASSEMBLY_EXT)
+
+
+// The functions below have an Assembly implementation, but their C version is
+// shared by the generic 32-bit and the 64-bit C implementation. The first two
+// are "lazy-reduction" variants of the addition and subtraction in GF(p),
+// which do not perform any reduction modulo $p$ at all and can, therefore,
+// only be used when the operands are known to be bounded (e.g., fully
+// reduced). They operate on the 32-bit Word-arrays directly.
+
+
+// Non-reducing addition of two field-elements: $r = a + b$
+// --------------------------------------------------------
+// This function performs a plain 256-bit addition, i.e., the reduction of the
+// sum (including the computation of the most-significant word at the start)
+// of `gfp_add` is omitted. The result is only correct (i.e., congruent to $a +
+// b \bmod p$) when $a + b < 2^{k+1}$, which is the case, e.g., when both $a$
+// and $b$ are less than $2^k$. Note that the sum is not necessarily in the
+// range $[0, 2p-1]$, but it can be used as operand of all other arithmetic
+// functions in this file since they accept any input that is below $2^{k+1}$.
+
+void gfp_add_nr(Word *r, const Word *a, const Word *b)
+{
+  DWord sum = 0;
+  int i;
+  
+  M25519_PROF_INC(GFP_ADD_NR);
+  for (i = 0; i < LEN; i++) {
+    sum += (DWord) a[i] + b[i];
+    r[i] = (Word) sum;
+    sum >>= WSIZE;
+    // sum is in [0, 1]
+  }
+  // the final carry is 0 when $a + b < 2^{k+1}$
+}
+
+
+// Non-reducing subtraction of two field-elements: $r = a - b + p$
+// ---------------------------------------------------------------
+// This function computes $r = a - b + p = a - b + 2^k - c$ as a plain 256-bit
+// operation, i.e., the reduction of the most-significant word of `gfp_sub` is
+// omitted. The constant $-c$ is included as initial value of the (signed) sum
+// and the most-significant word of $2^k$ is added to r[len-1]. The result is
+// only correct when $0 \leq a - b + p < 2^{k+1}$, which is the case, e.g.,
+// when $b \leq p$ and $a < 2^k + c$ (in particular when both operands are
+// fully reduced, whereby $r$ is in the range $[1, 2p]$).
+
+void gfp_sub_nr(Word *r, const Word *a, const Word *b)
+{
+  SDWord sum = -((SDWord) CONSTC);  // signed!
+  int i;
+  
+  M25519_PROF_INC(GFP_SUB_NR);
+  for (i = 0; i < LEN - 1; i++) {
+    sum += (SDWord) a[i] - b[i];
+    r[i] = (Word) sum;
+    sum >>= WSIZE;  // arithmetic shift!
+    // sum is in [-2, 1]
+  }
+  r[LEN-1] = a[LEN-1] - b[LEN-1] + ((Word) sum) + MSB1MASK;
+  // 0x80000000 = MSW of 2^k
+}
+
+
+#endif  // #if !defined(M25519_ASSEMBLY_EXT)
+#if (!defined(M25519_ASSEMBLY_EXT) || defined(M25519_OPSTBL))
+
+
+// Repeated squaring of a field-element: $r = a^{2^n} \bmod p$
+// -----------------------------------------------------------
+// This function squares a field-element $n$ times in succession, which is the
+// main operation of exponentiations with a fixed addition chain like that of
+// `gfp_exp_p58`. The C version simply calls `gfp_sqr` $n$ times, whereas the
+// Assembly versions keep the loop inside the function and pass the result of
+// a squaring in registers to the next squaring. When $n \leq 0$, the operand
+// $a$ is copied to $r$. The number of squarings is assumed to be public. In
+// ops-table mode, the C version is used so that the squarings are performed
+// by the installed `gfp_sqr` kernel.
+
+void gfp_sqrn(Word *r, const Word *a, int n)
+{
+  int i;
+  
+  M25519_PROF_INC(GFP_SQRN);
+  if (n <= 0) {
+    mpi_copy(r, a, LEN);
+    return;
+  }
+  gfp_sqr(r, a);
+  for (i = 1; i < n; i++) gfp_sqr(r, r);
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 #endif /////////////// COMPOSITE PRIME-FIELD OPERATIONS ///////////////////////
@@ -556,6 +1102,159 @@ int gfp_cmp(const Word *a, const Word *b)
 }
 
 
+// Conditional swap of two field-elements: $(a, b) = (b, a)$ or $(a, b)$
+// ---------------------------------------------------------------------
+// This function swaps the field-elements $a$ and $b$ when `swap` is 1 and
+// leaves them unchanged when `swap` is 0. The swap is performed via an AND-
+// masked XOR of the words of $a$ and $b$ so that the execution time and the
+// memory-access pattern do not depend on `swap`.
+
+void gfp_cswap(Word *a, Word *b, int swap)
+{
+  Word mask = (Word) (0 - (swap & 1));
+  Word tmp;
+  int i;
+  
+  for (i = 0; i < LEN; i++) {
+    tmp = (a[i] ^ b[i]) & mask;
+    a[i] ^= tmp;
+    b[i] ^= tmp;
+  }
+}
+
+
+#if defined(M25519_SAFEGCD_INV)
+
+
+// Number of divsteps per call of `mpi_divsteps` and number of batches needed
+// to reach $g = 0$ for any $a < p$ (at most 590 divsteps for 256-bit inputs).
+#define DIVSTEPS (WSIZE - 2)
+#define NUMBATCH ((590 + DIVSTEPS - 1)/DIVSTEPS)
+
+// Constant $2^{-600} \bmod p$ to remove the factor $2^{DIVSTEPS \cdot NUMBATCH}$
+static const Word C2M600[LEN] = {
+  0x88DD407E, 0x65683E67, 0xCFC744C9, 0x90AA31A3,
+  0x4E016B14, 0x855B1B22, 0x2C905DC1, 0x4469D942
+};
+
+
+// Update of $f$ and $g$ after a batch of divsteps: $(f, g) = M(f, g)/2^{30}$
+// --------------------------------------------------------------------------
+// The two MPIs $f$ and $g$ are signed integers in two's complement form with
+// an absolute value of less than $2^{255}$. The transition matrix $M$ in `t`,
+// which was obtained by `mpi_divsteps`, consists of four signed words $u, v,
+// q, r$ with $|u| + |v| \leq 2^{30}$ and $|q| + |r| \leq 2^{30}$, so that the
+// products and sums below never overflow a signed double-length word. Since
+// the 30 least-significant bits of $u f + v g$ and $q f + r g$ are always 0,
+// the division by $2^{30}$ is simply a right-shift, which is merged into the
+// loop (the result-words are written one position lower than the operands).
+
+static void gfp_divupd(Word *f, Word *g, const Word *t)
+{
+  SDWord cf, cg;  // signed!
+  Word lf, lg;
+  int32_t u = (int32_t) t[0], v = (int32_t) t[1];
+  int32_t q = (int32_t) t[2], r = (int32_t) t[3];
+  int i;
+  
+  cf = (SDWord) u*f[0] + (SDWord) v*g[0];
+  cg = (SDWord) q*f[0] + (SDWord) r*g[0];
+  lf = (Word) cf; lg = (Word) cg;
+  cf >>= WSIZE; cg >>= WSIZE;  // arithmetic shift!
+  
+  for (i = 1; i < LEN - 1; i++) {
+    cf += (SDWord) u*f[i] + (SDWord) v*g[i];
+    cg += (SDWord) q*f[i] + (SDWord) r*g[i];
+    f[i-1] = (((Word) cf) << 2) | (lf >> DIVSTEPS);
+    g[i-1] = (((Word) cg) << 2) | (lg >> DIVSTEPS);
+    lf = (Word) cf; lg = (Word) cg;
+    cf >>= WSIZE; cg >>= WSIZE;  // arithmetic shift!
+  }
+  // most-significant words of f and g are signed
+  cf += (SDWord) u*((int32_t) f[LEN-1]) + (SDWord) v*((int32_t) g[LEN-1]);
+  cg += (SDWord) q*((int32_t) f[LEN-1]) + (SDWord) r*((int32_t) g[LEN-1]);
+  f[LEN-2] = (((Word) cf) << 2) | (lf >> DIVSTEPS);
+  g[LEN-2] = (((Word) cg) << 2) | (lg >> DIVSTEPS);
+  f[LEN-1] = (Word) (cf >> DIVSTEPS);
+  g[LEN-1] = (Word) (cg >> DIVSTEPS);
+}
+
+
+// Multiplication of a field-element by a signed 32-bit value: $r = a \cdot s$
+// ---------------------------------------------------------------------------
+// The absolute value of `s` is computed without branches and multiplied by
+// $a$ using `gfp_mul32`, and the product is then negated when `s` is negative.
+
+static void gfp_smul32(Word *r, const Word *a, Word s)
+{
+  Word mask = 0 - (s >> (WSIZE - 1));  // 0 or all-1
+  Word abs = (s ^ mask) - mask;
+  
+  gfp_mul32(r, a, &abs);
+  gfp_cneg(r, r, (int) (mask & 1));
+}
+
+
+// Inversion of a non-0 field-element: $r = a^{-1} \bmod p$
+// --------------------------------------------------------
+// This function computes the multiplicative inverse of a non-0 field-element
+// modulo the prime $p$ using the "safegcd" algorithm of Bernstein and Yang in
+// the variant with half-delta (here $\zeta = -\delta - 1/2$), as described in
+// "Fast constant-time gcd computation and modular inversion" (TCHES 2019). The
+// algorithm starts with $f = p$, $g = a \bmod p$, $d = 0$, and $e = 1$, and
+// processes `NUMBATCH` batches of 30 divsteps, each of which is carried out by
+// `mpi_divsteps` on the least-significant words of $f$ and $g$ only, yielding
+// a 2x2 transition matrix $M$. This matrix is then applied to the MPIs $f$ and
+// $g$ (including a division by $2^{30}$) and to the field-elements $d$ and $e$
+// (without division, i.e., only modulo $p$). Hence, after batch $i$, it holds
+// that $f \cdot 2^{30i} \equiv d \cdot a$. The bound of 590 divsteps for 256-bit
+// inputs guarantees that $g = 0$ and $f = \pm 1$ at the end, which means that
+// $a^{-1} = \pm d \cdot 2^{-600} \bmod p$.
+// NOTE: Unlike the EEA-based inversion, this inversion always executes the
+// same sequence of operations, irrespective of the operand, and therefore has
+// constant execution time. No multiplicative masking is needed.
+// NOTE: The function returns `M25519_ERR_INVERS` if the field-element to be
+// inverted is `0` (in which case $r = 0$) and `M25519_NO_ERROR` otherwise.
+
+int gfp_inv(Word *r, const Word *a)
+{
+  Word tmp[6*LEN];  // temporary space for six gfp elements
+  Word *f = tmp, *g = &tmp[LEN], *d = &tmp[2*LEN], *e = &tmp[3*LEN];
+  Word *s1 = &tmp[4*LEN], *s2 = &tmp[5*LEN];
+  Word t[4];  // transition matrix
+  int zeta = -1, retval, i;
+  
+  M25519_PROF_INC(GFP_INV);
+  gfp_setp(f);           // set f = p
+  gfp_fred(g, a);        // set g = a mod p
+  mpi_setw(d, 0, LEN);   // set d = 0
+  mpi_setw(e, 1, LEN);   // set e = 1
+  retval = (mpi_cmpw(g, 0, LEN) == 0) ? M25519_ERR_INVERS : M25519_NO_ERROR;
+  
+  for (i = 0; i < NUMBATCH; i++) {
+    M25519_PROF_INC(GFP_INV_ITER);
+    zeta = mpi_divsteps(t, f[0], g[0], zeta);
+    gfp_divupd(f, g, t);
+    // (d, e) = M*(d, e) mod p
+    gfp_smul32(s1, d, t[0]);  // s1 = u*d
+    gfp_smul32(s2, d, t[2]);  // s2 = q*d
+    gfp_smul32(d, e, t[1]);   // d = v*e
+    gfp_add(d, d, s1);        // d = u*d + v*e
+    gfp_smul32(s1, e, t[3]);  // s1 = r*e
+    gfp_add(e, s1, s2);       // e = q*d + r*e
+  }
+  
+  // now f is either 1 or -1 (or p when a = 0)
+  gfp_mul(r, d, C2M600);
+  gfp_cneg(r, r, (int) (f[LEN-1] >> (WSIZE - 1)));
+  
+  return retval;
+}
+
+
+#else  // EEA-based inversion
+
+
 // Inversion of a non-0 field-element: $r = a^{-1} \bmod p$
 // --------------------------------------------------------
 // This function computes the multiplicative inverse of a non-0 field-element
@@ -581,6 +1280,7 @@ int gfp_inv(Word *r, const Word *a)
   Word *ux = tmp, *vx = &tmp[LEN], *x1 = &tmp[2*LEN], *x2 = r;
   int uvlen = LEN;
   
+  M25519_PROF_INC(GFP_INV);
   mpi_copy(ux, a, LEN);  // set ux = a
   gfp_setp(vx);          // set vx = p
   mpi_setw(x1, 1, LEN);  // set x1 = 1
@@ -590,6 +1290,7 @@ int gfp_inv(Word *r, const Word *a)
   if (mpi_cmpw(ux, 0, LEN) == 0) return M25519_ERR_INVERS;
   
   while(mpi_cmpw(ux, 1, uvlen) && mpi_cmpw(vx, 1, uvlen)) {
+    M25519_PROF_INC(GFP_INV_ITER);
     while((ux[0] & 1) == 0) {  // ux is even
       mpi_shr(ux, ux, uvlen);
       gfp_hlv(x1, x1);
@@ -614,6 +1315,111 @@ int gfp_inv(Word *r, const Word *a)
 }
 
 
+// Constant-time inversion of a field-element: $r = a^{p-2} \bmod p$
+// -----------------------------------------------------------------
+// The exponent $p-2 = 2^{255} - 21$ is processed with the addition chain of
+// Ref10, which consists of 254 squarings and 11 multiplications and shares
+// its first part (up to $a^{2^{250}-1}$) with the chain of `gfp_exp_p58`. The
+// execution time does not depend on $a$, and the result is 0 if $a = 0$.
+
+static void gfp_inv_exp(Word *r, const Word *a)
+{
+  Word tmp[4*LEN];  // temporary space for four gfp elements
+  Word *t0 = tmp, *t1 = &tmp[LEN], *t2 = &tmp[2*LEN], *t3 = &tmp[3*LEN];
+
+  gfp_sqr(t0, a);                               // t0 = a^2
+  gfp_sqrn(t1, t0, 2);                          // t1 = a^8
+  gfp_mul(t1, a, t1);                           // t1 = a^9
+  gfp_mul(t0, t0, t1);                          // t0 = a^11
+  gfp_sqr(t3, t0);                              // t3 = a^22
+  gfp_mul(t3, t1, t3);                          // t3 = a^(2^5-1)
+  gfp_sqrn(t1, t3, 5);
+  gfp_mul(t3, t1, t3);                          // t3 = a^(2^10-1)
+  gfp_sqrn(t1, t3, 10);
+  gfp_mul(t1, t1, t3);                          // t1 = a^(2^20-1)
+  gfp_sqrn(t2, t1, 20);
+  gfp_mul(t1, t2, t1);                          // t1 = a^(2^40-1)
+  gfp_sqrn(t1, t1, 10);
+  gfp_mul(t3, t1, t3);                          // t3 = a^(2^50-1)
+  gfp_sqrn(t1, t3, 50);
+  gfp_mul(t1, t1, t3);                          // t1 = a^(2^100-1)
+  gfp_sqrn(t2, t1, 100);
+  gfp_mul(t1, t2, t1);                          // t1 = a^(2^200-1)
+  gfp_sqrn(t1, t1, 50);
+  gfp_mul(t3, t1, t3);                          // t3 = a^(2^250-1)
+  gfp_sqrn(t3, t3, 5);                          // t3 = a^(2^255-32)
+  gfp_mul(r, t3, t0);                           // r = a^(2^255-21)
+}
+
+
+#endif
+
+
+// Simultaneous inversion of `n` field-elements: $r_i = a_i^{-1} \bmod p$
+// ----------------------------------------------------------------------
+// This function inverts `n` field-elements, which are stored one after the
+// other in the array `a`, using Montgomery's trick, i.e., with only a single
+// inversion and $3(n-1)$ multiplications in GF(p). In a first step, the
+// products $c_i = b_0 \cdot b_1 \cdots b_i$ are computed and stored in the
+// array `scratch`, where $b_i = a_i$, except when $a_i = 0$, in which case
+// $b_i = 1$ (this replacement is carried out with a mask, similar to the zero
+// check itself). Then, the product $c_{n-1}$ of all $b_i$ is inverted, and in
+// a second step, the inverses $r_i = c_{n-1}^{-1} \cdot c_{i-1} \cdot
+// \prod_{j>i} b_j$ are obtained by walking backwards through the array. An
+// inverse $r_i$ is finally set to 0 when $a_i = 0$, which corresponds to the
+// behavior of `gfp_inv`. The arrays `r` and `a` may be the same.
+// NOTE: The product $c_{n-1}$ is inverted in constant time, i.e., with the
+// divsteps-based `gfp_inv` when `M25519_SAFEGCD_INV` is defined and otherwise
+// via the exponentiation $c_{n-1}^{p-2}$ (see `gfp_inv_exp`), since the
+// field-elements are typically coordinates of points that depend on secret
+// scalars (e.g., the Z-coordinates of a batch of X25519 ladders).
+// NOTE: The function returns `M25519_ERR_INVERS` if at least one of the `n`
+// field-elements is `0` and `M25519_NO_ERROR` otherwise. The elements that are
+// `0` can be identified by their result $r_i = 0$.
+
+int gfp_inv_batch(Word *r, const Word *a, int n, Word *scratch)
+{
+  Word inv[LEN], tmp[LEN];
+  Word is0, any0 = 0;
+  int i, j;
+  
+  if (n <= 0) return M25519_NO_ERROR;
+  
+  // c_i = b_0 * b_1 * ... * b_i
+  for (i = 0; i < n; i++) {
+    gfp_fred(tmp, &a[i*LEN]);
+    is0 = (mpi_cmpw(tmp, 0, LEN) == 0);
+    tmp[0] |= is0;  // b_i = 1 when a_i = 0
+    any0 |= is0;
+    if (i == 0) mpi_copy(scratch, tmp, LEN);
+    else gfp_mul(&scratch[i*LEN], &scratch[(i-1)*LEN], tmp);
+  }
+  
+#if defined(M25519_SAFEGCD_INV)
+  gfp_inv(inv, &scratch[(n-1)*LEN]);
+#else
+  gfp_inv_exp(inv, &scratch[(n-1)*LEN]);
+#endif
+  
+  // r_i = (b_0 * ... * b_i)^-1 * (b_0 * ... * b_(i-1))
+  for (i = n - 1; i >= 0; i--) {
+    gfp_fred(tmp, &a[i*LEN]);
+    is0 = 0 - (Word) (mpi_cmpw(tmp, 0, LEN) == 0);  // 0 or all-1
+    tmp[0] |= (is0 & 1);
+    if (i > 0) {
+      gfp_mul(tmp, inv, tmp);  // (b_0 * ... * b_(i-1))^-1
+      gfp_mul(&r[i*LEN], inv, &scratch[(i-1)*LEN]);
+      mpi_copy(inv, tmp, LEN);
+    } else {
+      mpi_copy(r, inv, LEN);
+    }
+    for (j = 0; j < LEN; j++) r[i*LEN+j] &= ~is0;
+  }
+  
+  return (any0 ? M25519_ERR_INVERS : M25519_NO_ERROR);
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 ////////////////// ADDITIONAL OR ALTERNATIVE IMPLEMENTATIONS //////////////////
 ///////////////////////////////////////////////////////////////////////////////
@@ -21,38 +21,110 @@
 #define _GFPARITH_H
 
 #include "config.h"
+#include "profile.h"
 
 // prototypes of functions with C implementations only
 void gfp_setp(Word *r);
 int  gfp_cmpp(const Word *a);
 void gfp_fred(Word *r, const Word *a);
 int  gfp_cmp(const Word *a, const Word *b);
+void gfp_cswap(Word *a, Word *b, int swap);
 int  gfp_inv(Word *r, const Word *a);
+int  gfp_inv_batch(Word *r, const Word *a, int n, Word *scratch);
 
 // prototypes of functions with C and ASM implementations
-#if defined(M25519_ASSEMBLY)  // ASM functions are available
+#if defined(M25519_OPSTBL)  // kernels are called via the ops table
+#include "backend.h"
+void gfp_add(Word *r, const Word *a, const Word *b);
+void gfp_cneg(Word *r, const Word *a, int neg);
+void gfp_hlv(Word *r, const Word *a);
+void gfp_mul(Word *r, const Word *a, const Word *b);
+void gfp_mul32(Word *r, const Word *a, const Word *b);
+void gfp_sqr(Word *r, const Word *a);
+void gfp_sqrn(Word *r, const Word *a, int n);
+void gfp_sub(Word *r, const Word *a, const Word *b);
+#define gfp_add(r, a, b) \
+  M25519_PROF_CALL(GFP_ADD, m25519_ops.add((r), (a), (b)))
+#define gfp_cneg(r, a, neg) \
+  M25519_PROF_CALL(GFP_CNEG, m25519_ops.cneg((r), (a), (neg)))
+#define gfp_hlv(r, a) \
+  M25519_PROF_CALL(GFP_HLV, m25519_ops.hlv((r), (a)))
+#define gfp_mul(r, a, b) \
+  M25519_PROF_CALL(GFP_MUL, m25519_ops.mul((r), (a), (b)))
+#define gfp_mul32(r, a, b) \
+  M25519_PROF_CALL(GFP_MUL32, m25519_ops.mul32((r), (a), (b)))
+#define gfp_sqr(r, a) \
+  M25519_PROF_CALL(GFP_SQR, m25519_ops.sqr((r), (a)))
+#define gfp_sub(r, a, b) \
+  M25519_PROF_CALL(GFP_SUB, m25519_ops.sub((r), (a), (b)))
+#if defined(M25519_ASSEMBLY)  // ASM kernels for the ops table are available
 extern void gfp_add_asm(Word *r, const Word *a, const Word *b);
-#define gfp_add(r, a, b) gfp_add_asm((r), (a), (b))
 extern void gfp_cneg_asm(Word *r, const Word *a, int neg);
-#define gfp_cneg(r, a, neg) gfp_cneg_asm((r), (a), (neg))
 extern void gfp_hlv_asm(Word *r, const Word *a);
-#define gfp_hlv(r, a) gfp_hlv_asm((r), (a))
 extern void gfp_mul_asm(Word *r, const Word *a, const Word *b);
-#define gfp_mul(r, a, b) gfp_mul_asm((r), (a), (b))
 extern void gfp_mul32_asm(Word *r, const Word *a, const Word *b);
-#define gfp_mul32(r, a, b) gfp_mul32_asm((r), (a), (b))
 extern void gfp_sqr_asm(Word *r, const Word *a);
-#define gfp_sqr(r, a) gfp_sqr_asm((r), (a))
 extern void gfp_sub_asm(Word *r, const Word *a, const Word *b);
-#define gfp_sub(r, a, b) gfp_sub_asm((r), (a), (b))
+#endif
+#if defined(M25519_ASSEMBLY_EXT)  // additional ASM functions are available
+extern void gfp_add_nr_asm(Word *r, const Word *a, const Word *b);
+#define gfp_add_nr(r, a, b) \
+  M25519_PROF_CALL(GFP_ADD_NR, gfp_add_nr_asm((r), (a), (b)))
+extern void gfp_sub_nr_asm(Word *r, const Word *a, const Word *b);
+#define gfp_sub_nr(r, a, b) \
+  M25519_PROF_CALL(GFP_SUB_NR, gfp_sub_nr_asm((r), (a), (b)))
+#else
+void gfp_add_nr(Word *r, const Word *a, const Word *b);
+void gfp_sub_nr(Word *r, const Word *a, const Word *b);
+#endif
+#elif defined(M25519_ASSEMBLY)  // ASM functions are available
+extern void gfp_add_asm(Word *r, const Word *a, const Word *b);
+#define gfp_add(r, a, b) \
+  M25519_PROF_CALL(GFP_ADD, gfp_add_asm((r), (a), (b)))
+extern void gfp_cneg_asm(Word *r, const Word *a, int neg);
+#define gfp_cneg(r, a, neg) \
+  M25519_PROF_CALL(GFP_CNEG, gfp_cneg_asm((r), (a), (neg)))
+extern void gfp_hlv_asm(Word *r, const Word *a);
+#define gfp_hlv(r, a) \
+  M25519_PROF_CALL(GFP_HLV, gfp_hlv_asm((r), (a)))
+extern void gfp_mul_asm(Word *r, const Word *a, const Word *b);
+#define gfp_mul(r, a, b) \
+  M25519_PROF_CALL(GFP_MUL, gfp_mul_asm((r), (a), (b)))
+extern void gfp_mul32_asm(Word *r, const Word *a, const Word *b);
+#define gfp_mul32(r, a, b) \
+  M25519_PROF_CALL(GFP_MUL32, gfp_mul32_asm((r), (a), (b)))
+extern void gfp_sqr_asm(Word *r, const Word *a);
+#define gfp_sqr(r, a) \
+  M25519_PROF_CALL(GFP_SQR, gfp_sqr_asm((r), (a)))
+extern void gfp_sub_asm(Word *r, const Word *a, const Word *b);
+#define gfp_sub(r, a, b) \
+  M25519_PROF_CALL(GFP_SUB, gfp_sub_asm((r), (a), (b)))
+#if defined(M25519_ASSEMBLY_EXT)  // additional ASM functions are available
+extern void gfp_add_nr_asm(Word *r, const Word *a, const Word *b);
+#define gfp_add_nr(r, a, b) \
+  M25519_PROF_CALL(GFP_ADD_NR, gfp_add_nr_asm((r), (a), (b)))
+extern void gfp_sqrn_asm(Word *r, const Word *a, int n);
+#define gfp_sqrn(r, a, n) (M25519_PROF_ADD(GFP_SQR, (n)), \
+  M25519_PROF_CALL(GFP_SQRN, gfp_sqrn_asm((r), (a), (n))))
+extern void gfp_sub_nr_asm(Word *r, const Word *a, const Word *b);
+#define gfp_sub_nr(r, a, b) \
+  M25519_PROF_CALL(GFP_SUB_NR, gfp_sub_nr_asm((r), (a), (b)))
+#else
+void gfp_add_nr(Word *r, const Word *a, const Word *b);
+void gfp_sqrn(Word *r, const Word *a, int n);
+void gfp_sub_nr(Word *r, const Word *a, const Word *b);
+#endif
 #else  // ASM functions are not available or not used
 void gfp_add(Word *r, const Word *a, const Word *b);
+void gfp_add_nr(Word *r, const Word *a, const Word *b);
 void gfp_cneg(Word *r, const Word *a, int neg);
 void gfp_hlv(Word *r, const Word *a);
 void gfp_mul(Word *r, const Word *a, const Word *b);
 void gfp_mul32(Word *r, const Word *a, const Word *b);
 void gfp_sqr(Word *r, const Word *a);
+void gfp_sqrn(Word *r, const Word *a, int n);
 void gfp_sub(Word *r, const Word *a, const Word *b);
+void gfp_sub_nr(Word *r, const Word *a, const Word *b);
 #endif
 
 #endif
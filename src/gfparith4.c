@@ -0,0 +1,327 @@
+///////////////////////////////////////////////////////////////////////////////
+// gfparith4.c: Four-way parallel (SIMD) arithmetic in prime field GF(p).    //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// The functions in this file perform arithmetic operations on four independent
+// elements of the prime field GF(p) with $p = 2^{255} - 19$ at once, which is
+// useful for server-class processors that execute many X25519 computations (or
+// other scalar multiplications) in parallel. A vector of four field-elements
+// is stored in a Word-array of length `LEN4` = 40. Each field-element consists
+// of ten limbs in radix $2^{25.5}$, i.e., the limbs with an even index are 26
+// bits long and the limbs with an odd index 25 bits, and the limbs are stored
+// lane-interleaved: a[4*i+j] is the i-th limb of the element in lane j. This
+// layout allows a SIMD implementation to load the i-th limbs of all four lanes
+// with a single (128-bit) load instruction. Vectors are converted from/to the
+// conventional Word-array representation with `gfp4_pack` and `gfp4_unpack`.
+
+// The representation in radix $2^{25.5}$ leaves enough headroom in the 32-bit
+// words to pre-multiply a limb by $2 \cdot 19$ and to accumulate the 64-bit
+// limb-products of a multiplication without carry propagation. All functions
+// end with a carry propagation that consists of two interleaved chains (from
+// limb 0 and limb 5), which yields a result whose limbs are 26 or 25 bits long,
+// except of limb 1 and limb 6, which may exceed this length by a small carry
+// of at most 16 bits. Every function accepts operands in this form, and the
+// result of `gfp4_unpack` is in the range $[0, 2p-1]$, similar to the results
+// of the arithmetic functions in `gfparith.c`.
+
+// The C implementations below process the four lanes one after the other and
+// serve as reference for (and produce exactly the same limbs as) the AVX2 and
+// NEON implementations in `simd/gfparith4_avx2.c` and `simd/gfparith4_neon.c`,
+// which are used instead when `M25519_SIMD` is defined (see `config.h`).
+
+
+#include "gfparith4.h"
+
+
+// Limb masks: 0x3FFFFFF (26 bits) and 0x1FFFFFF (25 bits)
+#define MASK26 ((Word) 0x3FFFFFFUL)
+#define MASK25 ((Word) 0x1FFFFFFUL)
+// Limbs of 2*p: 0x7FFFFDA (limb 0), 0x7FFFFFE (even), 0x3FFFFFE (odd)
+#define TWOPL0 ((Word) 0x7FFFFDAUL)
+#define TWOPEV ((Word) 0x7FFFFFEUL)
+#define TWOPOD ((Word) 0x3FFFFFEUL)
+
+
+// Conversion of four field-elements to a vector: $r = (a_0, a_1, a_2, a_3)$
+// --------------------------------------------------------------------------
+// The four field-elements are stored consecutively in array `a` (i.e., `a` has
+// a length of 4*LEN words) and can be up to 256 bits long. The MSB (bit 255)
+// of each element is reduced modulo $p$ by adding $19$ to the lowest limb and
+// the remaining 255 bits are split up into ten limbs at the bit-positions
+// $\lceil 25.5i \rceil$, i.e., 0, 26, 51, 77, 102, 128, 153, 179, 204, 230.
+
+void gfp4_pack(Word *r, const Word *a)
+{
+  DWord tmp;
+  int i, j, pos;
+
+  for (j = 0; j < NUMLANES; j++) {
+    for (i = 0; i < NUMLIMBS; i++) {
+      pos = (51*i + 1) >> 1;  // bit-position of i-th limb
+      tmp = (DWord) a[pos/WSIZE];
+      if (pos/WSIZE < LEN - 1) tmp |= ((DWord) a[pos/WSIZE+1]) << WSIZE;
+      r[NUMLANES*i+j] = ((Word) (tmp >> (pos % WSIZE))) & \
+                        ((i & 1) ? MASK25 : MASK26);
+    }
+    r[j] += CONSTC*(a[LEN-1] >> (WSIZE - 1));
+    a += LEN;
+  }
+}
+
+
+// Conversion of a vector to four field-elements: $(r_0, r_1, r_2, r_3) = a$
+// --------------------------------------------------------------------------
+// The ten limbs of each lane are shifted to their bit-position and added up
+// in 64-bit words so that limbs exceeding their nominal length are handled
+// properly. The obtained field-elements are stored consecutively in array `r`
+// and are in the range $[0, 2p-1]$.
+
+void gfp4_unpack(Word *r, const Word *a)
+{
+  DWord t[LEN], sum;
+  int i, j, pos;
+
+  for (j = 0; j < NUMLANES; j++) {
+    for (i = 0; i < LEN; i++) t[i] = 0;
+    for (i = 0; i < NUMLIMBS; i++) {
+      pos = (51*i + 1) >> 1;  // bit-position of i-th limb
+      sum = ((DWord) a[NUMLANES*i+j]) << (pos % WSIZE);
+      t[pos/WSIZE] += (Word) sum;
+      // highest limb does not exceed the 256-bit range
+      if (pos/WSIZE < LEN - 1) t[pos/WSIZE+1] += sum >> WSIZE;
+    }
+    sum = 0;
+    for (i = 0; i < LEN; i++) {
+      sum += t[i];
+      r[i] = (Word) sum;
+      sum >>= WSIZE;
+    }
+    r += LEN;
+  }
+}
+
+
+// Conditional swap of two vectors: $(a_j, b_j) = (b_j, a_j)$ or $(a_j, b_j)$
+// --------------------------------------------------------------------------
+// Bit j of operand `swap` specifies whether the field-elements in lane j of
+// $a$ and $b$ are swapped (bit is 1) or not (bit is 0). Similar to `gfp_cswap`,
+// the swap is performed via an AND-masked XOR. Since the lanes are interleaved,
+// the mask for a[i] depends only on $i \bmod 4$.
+
+void gfp4_cswap(Word *a, Word *b, int swap)
+{
+  Word mask[NUMLANES], tmp;
+  int i;
+
+  for (i = 0; i < NUMLANES; i++) mask[i] = 0 - ((Word) ((swap >> i) & 1));
+
+  for (i = 0; i < LEN4; i++) {
+    tmp = (a[i] ^ b[i]) & mask[i % NUMLANES];
+    a[i] ^= tmp;
+    b[i] ^= tmp;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//////////////////// PERFORMANCE-CRITICAL PRIME-FIELD OPERATIONS //////////////
+#if !defined(M25519_SIMD) /////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Carry propagation of the limbs of a single lane
+// -----------------------------------------------
+// The ten 64-bit limbs in `h` are carried in two interleaved chains starting
+// at limb 0 and limb 5, respectively. The carry out of limb 9 is multiplied by
+// $c = 19$ and added to limb 0. The limbs of the result are stored in lane `j`
+// of vector `r`.
+
+static void gfp4_carry(Word *r, DWord *h, int j)
+{
+  int i;
+
+  for (i = 0; i < NUMLIMBS/2; i++) {
+    h[i+1] += h[i] >> (26 - (i & 1));
+    h[i] &= ((i & 1) ? MASK25 : MASK26);
+    if (i + 6 < NUMLIMBS) {
+      h[i+6] += h[i+5] >> (25 + (i & 1));
+      h[i+5] &= ((i & 1) ? MASK26 : MASK25);
+    }
+  }
+  h[0] += CONSTC*(h[NUMLIMBS-1] >> 25);
+  h[NUMLIMBS-1] &= MASK25;
+  h[6] += h[5] >> 25;
+  h[5] &= MASK25;
+  h[1] += h[0] >> 26;
+  h[0] &= MASK26;
+
+  for (i = 0; i < NUMLIMBS; i++) r[NUMLANES*i+j] = (Word) h[i];
+}
+
+
+// Addition of two vectors: $r = a + b \bmod p$
+// --------------------------------------------
+// The limbs of $a$ and $b$ are added lane-wise and the sums are carried.
+
+void gfp4_add(Word *r, const Word *a, const Word *b)
+{
+  DWord h[NUMLIMBS];
+  int i, j;
+
+  for (j = 0; j < NUMLANES; j++) {
+    for (i = 0; i < NUMLIMBS; i++) {
+      h[i] = (DWord) a[NUMLANES*i+j] + b[NUMLANES*i+j];
+    }
+    gfp4_carry(r, h, j);
+  }
+}
+
+
+// Subtraction of two vectors: $r = a - b \bmod p$
+// -----------------------------------------------
+// To ensure that the limbs of the difference are positive, $2p$ is included
+// in the subtraction, i.e., $r = a + 2p - b$ is computed limb-wise. Each limb
+// of $2p$ is at least as big as the corresponding limb of $b$.
+
+void gfp4_sub(Word *r, const Word *a, const Word *b)
+{
+  DWord h[NUMLIMBS];
+  int i, j;
+
+  for (j = 0; j < NUMLANES; j++) {
+    h[0] = (DWord) a[j] + TWOPL0 - b[j];
+    for (i = 1; i < NUMLIMBS; i++) {
+      h[i] = (DWord) a[NUMLANES*i+j] + ((i & 1) ? TWOPOD : TWOPEV) - \
+             b[NUMLANES*i+j];
+    }
+    gfp4_carry(r, h, j);
+  }
+}
+
+
+// Conditional negation of a vector: $r = -a \bmod p$ or $r = a \bmod p$
+// ---------------------------------------------------------------------
+// Bit j of operand `neg` specifies whether the element in lane j is negated
+// (bit is 1) or not (bit is 0). The negation is computed as $2p - a$ and then
+// selected with an AND-mask, so that the execution time is independent of
+// `neg`.
+
+void gfp4_cneg(Word *r, const Word *a, int neg)
+{
+  DWord h[NUMLIMBS];
+  Word ai, msk;
+  int i, j;
+
+  for (j = 0; j < NUMLANES; j++) {
+    msk = 0 - ((Word) ((neg >> j) & 1));
+    ai = a[j];
+    h[0] = ai ^ ((ai ^ (TWOPL0 - ai)) & msk);
+    for (i = 1; i < NUMLIMBS; i++) {
+      ai = a[NUMLANES*i+j];
+      h[i] = ai ^ ((ai ^ (((i & 1) ? TWOPOD : TWOPEV) - ai)) & msk);
+    }
+    gfp4_carry(r, h, j);
+  }
+}
+
+
+// Multiplication of two vectors: $r = a \cdot b \bmod p$
+// ------------------------------------------------------
+// The limb-product a[i]*b[k] contributes to column $i+k$ when $i+k < 10$ and
+// to column $i+k-10$ (after a multiplication by $c = 19$) otherwise. Because
+// of the radix $2^{25.5}$, the product of two odd-indexed limbs has to be
+// doubled. Both factors, i.e., $2 a_i$ and $19 b_k$, fit into 32 bits, and
+// the column-sums do not exceed 61 bits.
+
+void gfp4_mul(Word *r, const Word *a, const Word *b)
+{
+  DWord h[NUMLIMBS];
+  Word al[NUMLIMBS], bl[NUMLIMBS], b19[NUMLIMBS];
+  int i, j, k;
+
+  for (j = 0; j < NUMLANES; j++) {
+    for (i = 0; i < NUMLIMBS; i++) {
+      al[i] = a[NUMLANES*i+j];
+      bl[i] = b[NUMLANES*i+j];
+      b19[i] = CONSTC*bl[i];
+      h[i] = 0;
+    }
+    for (i = 0; i < NUMLIMBS; i++) {
+      for (k = 0; k < NUMLIMBS - i; k++) {
+        h[i+k] += (DWord) (al[i] << (i & k & 1))*bl[k];
+      }
+      for (k = NUMLIMBS - i; k < NUMLIMBS; k++) {
+        h[i+k-NUMLIMBS] += (DWord) (al[i] << (i & k & 1))*b19[k];
+      }
+    }
+    gfp4_carry(r, h, j);
+  }
+}
+
+
+// Squaring of a vector: $r = a^2 \bmod p$
+// ---------------------------------------
+// Similar to the multiplication, but only the limb-products a[i]*a[k] with
+// $i \leq k$ are computed and the products with $i < k$ are doubled. The
+// factors $2 a_i$ and $a_k$ (pre-multiplied by 2, 19 or 38) fit into 32 bits.
+
+void gfp4_sqr(Word *r, const Word *a)
+{
+  DWord h[NUMLIMBS];
+  Word al[NUMLIMBS], ak;
+  int i, j, k;
+
+  for (j = 0; j < NUMLANES; j++) {
+    for (i = 0; i < NUMLIMBS; i++) {
+      al[i] = a[NUMLANES*i+j];
+      h[i] = 0;
+    }
+    for (i = 0; i < NUMLIMBS; i++) {
+      for (k = i; k < NUMLIMBS; k++) {
+        ak = al[k] << (i & k & 1);
+        if (i + k < NUMLIMBS) {
+          h[i+k] += (DWord) (al[i] << (i != k))*ak;
+        } else {
+          h[i+k-NUMLIMBS] += (DWord) (al[i] << (i != k))*(CONSTC*ak);
+        }
+      }
+    }
+    gfp4_carry(r, h, j);
+  }
+}
+
+
+// Multiplication of a vector by a 32-bit value: $r = a \cdot b \bmod p$
+// ---------------------------------------------------------------------
+// All four lanes are multiplied by the same 32-bit integer b[0], i.e., `b` is
+// a single Word (like in `gfp_mul32`) and not a vector.
+
+void gfp4_mul32(Word *r, const Word *a, const Word *b)
+{
+  DWord h[NUMLIMBS];
+  int i, j;
+
+  for (j = 0; j < NUMLANES; j++) {
+    for (i = 0; i < NUMLIMBS; i++) h[i] = (DWord) a[NUMLANES*i+j]*b[0];
+    gfp4_carry(r, h, j);
+  }
+}
+
+
+#endif /////////////// PERFORMANCE-CRITICAL PRIME-FIELD OPERATIONS /////////////
@@ -0,0 +1,46 @@
+///////////////////////////////////////////////////////////////////////////////
+// gfparith4.h: Four-way parallel (SIMD) arithmetic in prime field GF(p).    //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _GFPARITH4_H
+#define _GFPARITH4_H
+
+#include "config.h"
+
+// A vector of four field-elements consists of `LEN4` Words: ten limbs in
+// radix $2^{25.5}$ per element, stored lane-interleaved, i.e., a[4*i+j] is
+// the i-th limb of the field-element in lane j.
+
+#define NUMLANES 4
+#define NUMLIMBS 10
+#define LEN4 (NUMLANES*NUMLIMBS)
+
+// prototypes of functions with C implementations only
+void gfp4_pack(Word *r, const Word *a);
+void gfp4_unpack(Word *r, const Word *a);
+void gfp4_cswap(Word *a, Word *b, int swap);
+
+// prototypes of functions with C and SIMD implementations
+void gfp4_add(Word *r, const Word *a, const Word *b);
+void gfp4_cneg(Word *r, const Word *a, int neg);
+void gfp4_mul(Word *r, const Word *a, const Word *b);
+void gfp4_mul32(Word *r, const Word *a, const Word *b);
+void gfp4_sqr(Word *r, const Word *a);
+void gfp4_sub(Word *r, const Word *a, const Word *b);
+
+#endif
@@ -0,0 +1,340 @@
+///////////////////////////////////////////////////////////////////////////////
+// gfparith51.c: 64-bit (radix-2^51) arithmetic in the prime field GF(p).   //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// This file contains 64-bit C implementations of the performance-critical
+// arithmetic operations in the prime field GF(p) with $p = 2^{255} - 19$ for
+// "host-class" processors like x86-64 or AArch64, which have a 64-bit integer
+// multiplier that produces a 128-bit product. These functions replace their
+// generic 32-bit counterparts in `gfparith.c` when `M25519_HOST64` is defined
+// (see `config.h`). The field-elements are passed in the same way as on 32-bit
+// platforms, i.e., as Word-arrays of length `LEN` = 8, which means the API of
+// the library is not affected at all. However, the functions below access the
+// Word-arrays in pairs of two words, i.e., as four 64-bit words.
+
+// The addition, subtraction, conditional negation and halving operate on four
+// 64-bit words and use the same algorithms as the 32-bit functions. On the
+// other hand, the multiplication, squaring and multiplication by a 32-bit
+// integer convert their operands to a radix-$2^{51}$ representation with five
+// limbs (i.e., 51-bit chunks stored in 64-bit words), which leaves enough room
+// to accumulate the limb-products in 128-bit words without carry propagation.
+// The pre-multiplication of the upper limbs by $c = 19$ integrates a major
+// part of the reduction modulo $p$ into the product computation. The result
+// is converted back to the radix-$2^{32}$ representation and is in the range
+// $[0, 2p-1]$, similar to the 32-bit functions.
+
+
+#include "../gfparith.h"
+
+
+#if defined(M25519_HOST64)
+
+
+// `QWord` is an unsigned and `SQWord` a signed quad-length word (128 bits)
+typedef unsigned __int128 QWord;
+typedef __int128 SQWord;
+
+// Number of 64-bit words and 51-bit limbs of a field-element
+#define LEN64 (LEN/2)
+#define LEN51 5
+
+// All-1 Mask: 0xFFFFFFFFFFFFFFFF
+#define ALL1MASK ((DWord) -1LL)
+// MSB-1 Mask: 0x8000000000000000
+#define MSB1MASK ((DWord) (1ULL << 63))
+// MSB-0 Mask: 0x7FFFFFFFFFFFFFFF
+#define MSB0MASK (ALL1MASK >> 1)
+// Minus-4 Mask: 0xFFFFFFFFFFFFFFFC
+#define MIN4MASK ((DWord) -4LL)
+// 4*p[LEN64-1]: 0x1FFFFFFFFFFFFFFFC (65 bits long)
+#define FOURXPHI (((QWord) MSB0MASK) << 2)
+// Limb Mask: 0x7FFFFFFFFFFFF (51 bits)
+#define LIMBMASK (ALL1MASK >> 13)
+
+
+// Loading and storing of a 64-bit word from/to a Word-array
+// ---------------------------------------------------------
+// These two helper functions combine the two 32-bit words a[2i] and a[2i+1]
+// to a 64-bit word and split a 64-bit word into two 32-bit words. Compilers
+// for little-endian targets translate them into a single load or store.
+
+static DWord gfp_ld64(const Word *a, int i)
+{
+  return (((DWord) a[2*i+1]) << 32) | a[2*i];
+}
+
+static void gfp_st64(Word *r, int i, DWord w)
+{
+  r[2*i] = (Word) w;
+  r[2*i+1] = (Word) (w >> 32);
+}
+
+
+// Conversion of a field-element to radix-$2^{51}$ representation
+// ---------------------------------------------------------------
+// The operand $a$, which can be up to 256 bits long, is split up into five
+// limbs, of which the lower four are 51 bits long and the highest limb has a
+// length of up to 52 bits.
+
+static void gfp_to51(DWord *l, const Word *a)
+{
+  DWord w0 = gfp_ld64(a, 0), w1 = gfp_ld64(a, 1);
+  DWord w2 = gfp_ld64(a, 2), w3 = gfp_ld64(a, 3);
+  
+  l[0] = w0 & LIMBMASK;
+  l[1] = ((w0 >> 51) | (w1 << 13)) & LIMBMASK;
+  l[2] = ((w1 >> 38) | (w2 << 26)) & LIMBMASK;
+  l[3] = ((w2 >> 25) | (w3 << 39)) & LIMBMASK;
+  l[4] = w3 >> 12;  // up to 52 bits
+}
+
+
+// Carry propagation and conversion to radix-$2^{32}$ representation
+// -----------------------------------------------------------------
+// The five column-sums in `t`, each of which can be up to 115 bits long, are
+// reduced to 51-bit limbs through a carry propagation from t[0] to t[4]. The
+// carry from t[4] (representing a multiple of $2^{255}$) is multiplied by $c$
+// and added to the lowest limb, which yields a result that is less than $2p$.
+// Finally, the limbs are packed into four 64-bit words stored in array `r`.
+
+static void gfp_from51(Word *r, QWord *t)
+{
+  DWord l[LEN51];
+  QWord sum;
+  int i;
+  
+  for (i = 0; i < LEN51 - 1; i++) {
+    t[i+1] += (DWord) (t[i] >> 51);
+    l[i] = ((DWord) t[i]) & LIMBMASK;
+  }
+  l[LEN51-1] = ((DWord) t[LEN51-1]) & LIMBMASK;
+  sum = (QWord) CONSTC*((DWord) (t[LEN51-1] >> 51)) + l[0];
+  l[0] = ((DWord) sum) & LIMBMASK;
+  l[1] += (DWord) (sum >> 51);
+  // r is in [0, 2^255 + 2^67], i.e., less than 2p
+  
+  sum = (QWord) l[0] + (((QWord) l[1]) << 51);
+  gfp_st64(r, 0, (DWord) sum);
+  sum = (sum >> 64) + (((QWord) l[2]) << 38);
+  gfp_st64(r, 1, (DWord) sum);
+  sum = (sum >> 64) + (((QWord) l[3]) << 25);
+  gfp_st64(r, 2, (DWord) sum);
+  sum = (sum >> 64) + (((QWord) l[4]) << 12);
+  gfp_st64(r, 3, (DWord) sum);
+}
+
+
+// Addition of two field-elements: $r = a + b \bmod p$
+// ---------------------------------------------------
+// This function uses the same algorithm as the 32-bit version in `gfparith.c`
+// (i.e., the reduction is integrated into the addition, which starts with the
+// most-significant words) but operates on 64-bit words.
+
+void gfp_add(Word *r, const Word *a, const Word *b)
+{
+  QWord sum;
+  DWord msw;
+  int i;
+  
+  M25519_PROF_INC(GFP_ADD);
+  sum = (QWord) gfp_ld64(a, LEN64-1) + gfp_ld64(b, LEN64-1);
+  msw = ((DWord) sum) & MSB0MASK;  // 0x7FFFFFFFFFFFFFFF
+  sum = (QWord) CONSTC*((DWord) (sum >> 63));
+  // sum is in [0, 3*c]
+  
+  for (i = 0; i < LEN64 - 1; i++) {
+    sum += (QWord) gfp_ld64(a, i) + gfp_ld64(b, i);
+    gfp_st64(r, i, (DWord) sum);
+    sum >>= 64;
+    // sum is in [0, 2]
+  }
+  gfp_st64(r, LEN64-1, msw + ((DWord) sum));
+}
+
+
+// Subtraction of one field-element from another: $r = a - b \bmod p$
+// ------------------------------------------------------------------
+// This function uses the same algorithm as the 32-bit version in `gfparith.c`
+// (i.e., $4p$ is added to the difference to ensure the result is positive),
+// but operates on 64-bit words.
+
+void gfp_sub(Word *r, const Word *a, const Word *b)
+{
+  SQWord sum;  // signed!
+  DWord msw;
+  int i;
+  
+  M25519_PROF_INC(GFP_SUB);
+  sum = (SQWord) FOURXPHI + gfp_ld64(a, LEN64-1) - gfp_ld64(b, LEN64-1);
+  msw = ((DWord) sum) & MSB0MASK;  // 0x7FFFFFFFFFFFFFFF
+  sum = (SQWord) CONSTC*((DWord) (sum >> 63));
+  sum = sum - (CONSTC << 2);
+  // sum is in [-3*c, c]
+  
+  for (i = 0; i < LEN64 - 1; i++) {
+    sum += (SQWord) gfp_ld64(a, i) - gfp_ld64(b, i);
+    gfp_st64(r, i, (DWord) sum);
+    sum >>= 64;  // arithmetic shift!
+    // sum is in [-2, 1]
+  }
+  gfp_st64(r, LEN64-1, msw + ((DWord) sum) + 4);
+}
+
+
+// Conditional negation of a field-element: $r = -a \bmod p$ or $r = a \bmod p$
+// ----------------------------------------------------------------------------
+// This function uses the same algorithm as the 32-bit version in `gfparith.c`
+// (i.e., $r = 4p - a$ or $r = 2p + a$ is computed), but operates on 64-bit
+// words.
+
+void gfp_cneg(Word *r, const Word *a, int neg)
+{
+  SQWord sum;  // signed!
+  DWord msw, mask;
+  int i;
+  
+  M25519_PROF_INC(GFP_CNEG);
+  mask = 0 - (DWord) (neg & 1);  // 0 or all-1
+  sum = (SQWord) MIN4MASK + (mask ^ gfp_ld64(a, LEN64-1));
+  msw = ((DWord) sum) & MSB0MASK;  // 0x7FFFFFFFFFFFFFFF
+  sum = (SQWord) CONSTC*((DWord) (sum >> 63));
+  sum = sum - (CONSTC << 1) - (mask & ((CONSTC << 1) - 1));
+  
+  for (i = 0; i < LEN64 - 1; i++) {
+    sum += (SQWord) (mask ^ gfp_ld64(a, i));
+    gfp_st64(r, i, (DWord) sum);
+    sum >>= 64;  // arithmetic shift!
+    // sum is in [-1, 1]
+  }
+  gfp_st64(r, LEN64-1, msw + ((DWord) sum) + 4);
+}
+
+
+// Halving of a field-element: $r = a/2 \bmod p$
+// ---------------------------------------------
+// This function uses the same algorithm as the 32-bit version in `gfparith.c`
+// (i.e., $p$ is added to $a$ if $a$ is odd, followed by a 1-bit right-shift),
+// but operates on 64-bit words.
+
+void gfp_hlv(Word *r, const Word *a)
+{
+  SQWord sum;  // signed!
+  DWord tmp, mask;
+  int i;
+  
+  M25519_PROF_INC(GFP_HLV);
+  // masked addition of prime p to a
+  mask = 0 - (gfp_ld64(a, 0) & 1);  // 0 or all-1
+  sum = (SQWord) gfp_ld64(a, 0) - (CONSTC & mask);
+  tmp = (DWord) sum;
+  sum >>= 64;  // arithmetic shift!
+  // sum is in [-1, 0]
+  
+  for (i = 1; i < LEN64 - 1; i++) {
+    sum += (SQWord) gfp_ld64(a, i);
+    gfp_st64(r, i-1, (((DWord) sum) << 63) | (tmp >> 1));
+    tmp = (DWord) sum;
+    sum >>= 64;  // arithmetic shift!
+    // sum is in [-1, 0]
+  }
+  sum += (SQWord) gfp_ld64(a, LEN64-1) + (MSB1MASK & mask);
+  gfp_st64(r, LEN64-2, (((DWord) sum) << 63) | (tmp >> 1));
+  gfp_st64(r, LEN64-1, (DWord) (sum >> 1));
+}
+
+
+// Multiplication of two field-elements: $r = a \cdot b \bmod p$
+// -------------------------------------------------------------
+// Both operands are converted to radix-$2^{51}$ representation, whereby the
+// limbs of $b$ are additionally multiplied by $c = 19$. Each of the five
+// column-sums t[i] is the sum of the products a[j]*b[i-j] for $j \le i$ and
+// a[j]*19*b[5+i-j] for $j > i$ (since $2^{255} \equiv 19 \bmod p$). A column-
+// sum consists of five products of up to 109 bits and fits in a `QWord`.
+
+void gfp_mul(Word *r, const Word *a, const Word *b)
+{
+  DWord al[LEN51], bl[LEN51], bc[LEN51];
+  QWord t[LEN51];
+  int i, j;
+  
+  M25519_PROF_INC(GFP_MUL);
+  gfp_to51(al, a);
+  gfp_to51(bl, b);
+  for (i = 0; i < LEN51; i++) bc[i] = CONSTC*bl[i];
+  
+  for (i = 0; i < LEN51; i++) {
+    t[i] = 0;
+    for (j = 0; j <= i; j++) t[i] += (QWord) al[j]*bl[i-j];
+    for (j = i + 1; j < LEN51; j++) t[i] += (QWord) al[j]*bc[LEN51+i-j];
+  }
+  
+  gfp_from51(r, t);
+}
+
+
+// Squaring of a field-element: $r = a^2 \bmod p$
+// ----------------------------------------------
+// The squaring is similar to the multiplication, but exploits the fact that
+// each product a[i]*a[j] with $i \ne j$ appears twice, which means only 15
+// instead of 25 limb-products have to be computed.
+
+void gfp_sqr(Word *r, const Word *a)
+{
+  DWord al[LEN51], ad[LEN51], ac[LEN51];
+  QWord t[LEN51];
+  int i;
+  
+  M25519_PROF_INC(GFP_SQR);
+  gfp_to51(al, a);
+  for (i = 0; i < LEN51; i++) {
+    ad[i] = al[i] << 1;    // 2*a[i]
+    ac[i] = CONSTC*al[i];  // 19*a[i]
+  }
+  
+  t[0] = (QWord) al[0]*al[0] + (QWord) ad[1]*ac[4] + (QWord) ad[2]*ac[3];
+  t[1] = (QWord) ad[0]*al[1] + (QWord) ad[2]*ac[4] + (QWord) al[3]*ac[3];
+  t[2] = (QWord) ad[0]*al[2] + (QWord) al[1]*al[1] + (QWord) ad[3]*ac[4];
+  t[3] = (QWord) ad[0]*al[3] + (QWord) ad[1]*al[2] + (QWord) al[4]*ac[4];
+  t[4] = (QWord) ad[0]*al[4] + (QWord) ad[1]*al[3] + (QWord) al[2]*al[2];
+  
+  gfp_from51(r, t);
+}
+
+
+// Multiplication of a field-element by a 32-bit value: $r = a \cdot b \bmod p$
+// ----------------------------------------------------------------------------
+// Operand $a$ is converted to radix-$2^{51}$ representation and each limb is
+// multiplied by the 32-bit integer b[0], which yields five products of up to
+// 84 bits that are reduced in the same way as the column-sums of `gfp_mul`.
+
+void gfp_mul32(Word *r, const Word *a, const Word *b)
+{
+  DWord al[LEN51];
+  QWord t[LEN51];
+  int i;
+  
+  M25519_PROF_INC(GFP_MUL32);
+  gfp_to51(al, a);
+  for (i = 0; i < LEN51; i++) t[i] = (QWord) al[i]*b[0];
+  
+  gfp_from51(r, t);
+}
+
+
+#endif  // #if defined(M25519_HOST64)
@@ -0,0 +1,179 @@
+///////////////////////////////////////////////////////////////////////////////
+// moncurve.c: Arithmetic on the Montgomery form of Curve25519.             //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// The functions below operate on points of the Montgomery curve Curve25519,
+// which is given by the equation $y^2 = x^3 + A x^2 + x$ with $A = 486662$
+// over the prime field GF(p) with $p = 2^{255} - 19$. The Montgomery ladder
+// uses only the projective $X$ and $Z$-coordinates of two points $R$ and $S$,
+// whose difference $S - R$ remains constant during the whole ladder. These
+// four coordinates are stored in a single Word-array (e.g., the coordinates-
+// array of a `Point` of dimension 4) in the order $X_R, X_S, Z_R, Z_S$.
+
+
+#include "mpiarith.h"
+#include "gfparith.h"
+#include "gfparith4.h"
+#include "moncurve.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+#if (!defined(M25519_ASSEMBLY_EXT) || defined(M25519_OPSTBL)) ////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Step of the Montgomery ladder: $S = R + S$ and $R = 2R$
+// -------------------------------------------------------
+// A single ladder step combines a differential point addition with a point
+// doubling and consists of five multiplications, four squarings, one multi-
+// plication by the 32-bit constant $a_{24} = (A+2)/4$, as well as four field-
+// additions and four field-subtractions. When `swap` is 1, the points $R$ and
+// $S$ are swapped (in constant time) before the computation, which means the
+// caller has to pass the XOR of the current and the previous bit of the scalar
+// and perform a final swap after the last ladder step. The formulas are taken
+// from RFC 7748 and compute $A = X_R + Z_R$, $B = X_R - Z_R$, $C = X_S + Z_S$,
+// $D = X_S - Z_S$, $X_S = (DA + CB)^2$, $Z_S = x_D (DA - CB)^2$, $X_R = AA
+// \cdot BB$ and $Z_R = E (BB + a_{24} E)$ with $E = AA - BB$. The Assembly
+// implementations of this function keep the callee-saved registers on the
+// stack for the whole step and fuse the conditional swap as well as several
+// additions and subtractions with the surrounding field-operations. In ops-
+// table mode, the C version is used so that the ladder step is carried out
+// with the installed kernels.
+
+void mon_ladder_step(Word *xz, const Word *xd, const Word *a24, int swap)
+{
+  Word tmp[6*LEN];  // temporary space for six gfp elements
+  Word *t0 = tmp, *t1 = &tmp[LEN], *t2 = &tmp[2*LEN], *t3 = &tmp[3*LEN];
+  Word *t4 = &tmp[4*LEN], *t5 = &tmp[5*LEN];
+  Word *xr = xz, *xs = &xz[LEN], *zr = &xz[2*LEN], *zs = &xz[3*LEN];
+  
+  M25519_PROF_INC(MON_LADDER_STEP);
+  gfp_cswap(xr, xs, swap);
+  gfp_cswap(zr, zs, swap);
+  
+  gfp_add(t0, xr, zr);    // t0 = A = X_R + Z_R
+  gfp_sub(t1, xr, zr);    // t1 = B = X_R - Z_R
+  gfp_add(t2, xs, zs);    // t2 = C = X_S + Z_S
+  gfp_sub(t3, xs, zs);    // t3 = D = X_S - Z_S
+  gfp_mul(t4, t3, t0);    // t4 = DA = D*A
+  gfp_mul(t5, t2, t1);    // t5 = CB = C*B
+  gfp_sqr(t0, t0);        // t0 = AA = A^2
+  gfp_sqr(t1, t1);        // t1 = BB = B^2
+  gfp_add(t2, t4, t5);    // t2 = DA + CB
+  gfp_sub(t3, t4, t5);    // t3 = DA - CB
+  gfp_sqr(xs, t2);        // X_S = (DA + CB)^2
+  gfp_sqr(t3, t3);        // t3 = (DA - CB)^2
+  gfp_mul(zs, t3, xd);    // Z_S = xd*(DA - CB)^2
+  gfp_mul(xr, t0, t1);    // X_R = AA*BB
+  gfp_sub(t4, t0, t1);    // t4 = E = AA - BB
+  gfp_mul32(t5, t4, a24); // t5 = a24*E
+  gfp_add(t5, t5, t1);    // t5 = BB + a24*E
+  gfp_mul(zr, t4, t5);    // Z_R = E*(BB + a24*E)
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+#endif /////////////// PERFORMANCE-CRITICAL POINT ARITHMETIC //////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Four-way step of the Montgomery ladder: $S_j = R_j + S_j$ and $R_j = 2R_j$
+// ---------------------------------------------------------------------------
+// This function performs a ladder step on four independent pairs of points at
+// once, using the same formulas and sequence of field-operations as the scalar
+// `mon_ladder_step`, but with the four-way parallel functions of `gfparith4.c`
+// (which can be SIMD-accelerated). The array `xz` contains four vectors (each
+// of length `LEN4`) with the coordinates $X_R, X_S, Z_R, Z_S$ of all lanes,
+// and `xd` is a vector with the $x$-coordinates of the four differences. Bit
+// j of `swap` specifies whether $R_j$ and $S_j$ are swapped before the step.
+
+void mon_ladder_step4(Word *xz, const Word *xd, const Word *a24, int swap)
+{
+  Word tmp[6*LEN4];  // temporary space for six gfp4 vectors
+  Word *t0 = tmp, *t1 = &tmp[LEN4], *t2 = &tmp[2*LEN4], *t3 = &tmp[3*LEN4];
+  Word *t4 = &tmp[4*LEN4], *t5 = &tmp[5*LEN4];
+  Word *xr = xz, *xs = &xz[LEN4], *zr = &xz[2*LEN4], *zs = &xz[3*LEN4];
+  
+  gfp4_cswap(xr, xs, swap);
+  gfp4_cswap(zr, zs, swap);
+  
+  gfp4_add(t0, xr, zr);    // t0 = A = X_R + Z_R
+  gfp4_sub(t1, xr, zr);    // t1 = B = X_R - Z_R
+  gfp4_add(t2, xs, zs);    // t2 = C = X_S + Z_S
+  gfp4_sub(t3, xs, zs);    // t3 = D = X_S - Z_S
+  gfp4_mul(t4, t3, t0);    // t4 = DA = D*A
+  gfp4_mul(t5, t2, t1);    // t5 = CB = C*B
+  gfp4_sqr(t0, t0);        // t0 = AA = A^2
+  gfp4_sqr(t1, t1);        // t1 = BB = B^2
+  gfp4_add(t2, t4, t5);    // t2 = DA + CB
+  gfp4_sub(t3, t4, t5);    // t3 = DA - CB
+  gfp4_sqr(xs, t2);        // X_S = (DA + CB)^2
+  gfp4_sqr(t3, t3);        // t3 = (DA - CB)^2
+  gfp4_mul(zs, t3, xd);    // Z_S = xd*(DA - CB)^2
+  gfp4_mul(xr, t0, t1);    // X_R = AA*BB
+  gfp4_sub(t4, t0, t1);    // t4 = E = AA - BB
+  gfp4_mul32(t5, t4, a24); // t5 = a24*E
+  gfp4_add(t5, t5, t1);    // t5 = BB + a24*E
+  gfp4_mul(zr, t4, t5);    // Z_R = E*(BB + a24*E)
+}
+
+
+// Batch conversion from projective to affine coordinates: $R_i = (x_i,y_i)$
+// -------------------------------------------------------------------------
+// The $Z$-coordinate of a point $P_i$ is the second coordinate when `p[i].dim`
+// is 2 (i.e., $[X:Z]$) and the third coordinate otherwise, which covers both
+// $[X:Y:Z]$ and the layout $X_R, X_S, Z_R, Z_S$ of the Montgomery ladder. All
+// $Z_i$ are inverted together by `gfp_inv_batch` (in constant time), so that
+// the conversion of $n$ points costs a single inversion and $3(n-1)$ plus one
+// or two multiplications per point. The affine $x_i = X_i/Z_i$ is always
+// computed, and $y_i = Y_i/Z_i$ only when `r[i].dim` is at least 2 and
+// `p[i].dim` is 3, i.e., $P_i = [X:Y:Z]$ (e.g., after recovery of the $Y$-
+// coordinate). For the ladder layout (`p[i].dim` = 4), the second coordinate
+// is $X_S$ and no $y$-coordinate is defined, which means the second coordinate
+// of $R_i$ is not written. The coordinates of the results are
+// fully reduced. The array `scratch` must be able to accommodate `2*n*LEN`
+// words, and `r` may be the same as `p`. The parameter `d` is not used by
+// this implementation. The return value is `M25519_ERR_MPOINT` if $Z_i = 0$
+// for at least one point (whose coordinates are then 0) and `M25519_NO_ERROR`
+// otherwise.
+
+int mon_conv_p2a_batch(Point *r, const Point *p, int n, Word *scratch, \
+  const ECDomPar *d)
+{
+  Word *zi = scratch;
+  int i, err;
+
+  (void) d;
+  if (n <= 0) return M25519_NO_ERROR;
+
+  for (i = 0; i < n; i++) {
+    mpi_copy(&zi[i*LEN], &p[i].xyz[((p[i].dim == 2) ? 1 : 2)*LEN], LEN);
+  }
+  err = gfp_inv_batch(zi, zi, n, &scratch[n*LEN]);
+  for (i = 0; i < n; i++) {
+    gfp_mul(r[i].xyz, p[i].xyz, &zi[i*LEN]);
+    gfp_fred(r[i].xyz, r[i].xyz);
+    if ((r[i].dim >= 2) && (p[i].dim == 3)) {
+      gfp_mul(&r[i].xyz[LEN], &p[i].xyz[LEN], &zi[i*LEN]);
+      gfp_fred(&r[i].xyz[LEN], &r[i].xyz[LEN]);
+    }
+  }
+
+  return (err == M25519_NO_ERROR) ? M25519_NO_ERROR : M25519_ERR_MPOINT;
+}
@@ -0,0 +1,47 @@
+///////////////////////////////////////////////////////////////////////////////
+// moncurve.h: Arithmetic on the Montgomery form of Curve25519.             //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _MONCURVE_H
+#define _MONCURVE_H
+
+#include "config.h"
+#include "profile.h"
+
+// prototypes of functions with C implementations only
+void mon_ladder_step4(Word *xz, const Word *xd, const Word *a24, int swap);
+int  mon_conv_p2a_batch(Point *r, const Point *p, int n, Word *scratch, \
+  const ECDomPar *d);
+
+// prototypes of functions with C and ASM implementations; when profiling, the
+// field-operations fused in the ASM version of `mon_ladder_step` are counted
+// like those of the C version (4 additions, 4 subtractions, 5 multiplications,
+// 4 squarings, and one multiplication by a 32-bit constant)
+#if (defined(M25519_ASSEMBLY_EXT) && !defined(M25519_OPSTBL))  // ASM is used
+extern void mon_ladder_step_asm(Word *xz, const Word *xd, const Word *a24, \
+  int swap);
+#define mon_ladder_step(xz, xd, a24, swap) (M25519_PROF_ADD(GFP_ADD, 4), \
+  M25519_PROF_ADD(GFP_SUB, 4), M25519_PROF_ADD(GFP_MUL, 5), \
+  M25519_PROF_ADD(GFP_SQR, 4), M25519_PROF_ADD(GFP_MUL32, 1), \
+  M25519_PROF_CALL(MON_LADDER_STEP, \
+  mon_ladder_step_asm((xz), (xd), (a24), (swap))))
+#else  // ASM functions are not available or not used
+void mon_ladder_step(Word *xz, const Word *xd, const Word *a24, int swap);
+#endif
+
+#endif
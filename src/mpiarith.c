@@ -305,10 +305,16 @@ void mpi_mul(Word *r, const Word *a, const Word *b, int len)
 
 
 // The following functions are performance-critical since they are executed in
-// the main loop of the inversion in GF(p) based on the EEA. In addition to the
-// C implementations, there exist also highly-optimized Assembly versions of
-// these functions (for certain target architectures like AVR, MSP430, ARMv7-M
-// or RV32IM).
+// the main loop of the inversion in GF(p) based on the EEA or, in the case of
+// `mpi_divsteps`, the constant-time inversion based on Bernstein-Yang divsteps
+// (see `M25519_SAFEGCD_INV` in `config.h`), or, in the case of `mpi_mul8` and
+// `mpi_mul9`, in the arithmetic modulo the group order of Edwards25519, and,
+// in the case of `mpi_select`, in the table look-ups of the scalar
+// multiplications on Edwards25519. In
+// addition to the C versions, there exist also highly-optimized Assembly
+// versions of these functions (for certain target architectures like AVR,
+// MSP430, ARMv6-M, ARMv7-M or RV32IM); the Assembly versions of the last four
+// functions are only available for RV32IM (see `M25519_ASSEMBLY_EXT`).
 
 
 // 1-bit right-shift of an MPI: $r = a \gg 1$
@@ -318,6 +324,7 @@ int mpi_shr(Word *r, const Word *a, int len)
 {
   int i, retval;
   
+  M25519_PROF_INC(MPI_SHR);
   retval = a[0] & 1;  // return value
   for (i = 0; i < len - 1; i++) r[i] = (a[i+1] << (WSIZE - 1)) | (a[i] >> 1);
   r[len-1] = a[len-1] >> 1;
@@ -334,6 +341,7 @@ int mpi_sub(Word *r, const Word *a, const Word *b, int len)
   DWord dif = 1;
   int i;
   
+  M25519_PROF_INC(MPI_SUB);
   for (i = 0; i < len; i++) {
     dif += (DWord) a[i] + (~b[i]);
     r[i] = (Word) dif;
@@ -344,6 +352,104 @@ int mpi_sub(Word *r, const Word *a, const Word *b, int len)
 }
 
 
+#endif  // #if !defined(M25519_ASSEMBLY)
+#if !defined(M25519_ASSEMBLY_EXT)
+
+
+// Batch of $WSIZE-2$ constant-time divsteps on the lowest words of $f$ and $g$
+// ----------------------------------------------------------------------------
+
+int mpi_divsteps(Word *t, Word f0, Word g0, int zeta)
+{
+  Word u = 1, v = 0, q = 0, r = 1;
+  Word f = f0, g = g0, x, y, z, mask1, mask2;
+  int32_t zt = (int32_t) zeta;
+  int i;
+  
+  M25519_PROF_INC(MPI_DIVSTEPS);
+  for (i = 0; i < WSIZE - 2; i++) {
+    mask1 = (Word) (zt >> 31);  // all-1 if zeta < 0
+    mask2 = 0 - (g & 1);        // all-1 if g is odd
+    // conditional negation of f, u, v
+    x = (f ^ mask1) - mask1;
+    y = (u ^ mask1) - mask1;
+    z = (v ^ mask1) - mask1;
+    // conditional addition of (-)f, u, v to g, q, r
+    g += x & mask2;
+    q += y & mask2;
+    r += z & mask2;
+    // mask1 is all-1 if zeta < 0 and g is odd
+    mask1 &= mask2;
+    zt = (zt ^ ((int32_t) mask1)) - 1;
+    // conditional addition of g, q, r to f, u, v
+    f += g & mask1;
+    u += q & mask1;
+    v += r & mask1;
+    // halving of g (resp., doubling of u, v)
+    g >>= 1;
+    u <<= 1;
+    v <<= 1;
+  }
+  t[0] = u; t[1] = v;
+  t[2] = q; t[3] = r;
+  
+  return (int) zt;
+}
+
+
+// Multiplication of two 8-word MPIs: $r = a \times b$
+// ---------------------------------------------------
+// The 16-word product is not reduced. The array `r` must not overlap with `a`
+// or `b`.
+
+void mpi_mul8(Word *r, const Word *a, const Word *b)
+{
+  M25519_PROF_INC(MPI_MUL8);
+  mpi_mul(r, a, b, LEN);
+}
+
+
+// Multiplication of two 9-word MPIs: $r = a \times b$
+// ---------------------------------------------------
+// The 18-word product is not reduced. The array `r` must not overlap with `a`
+// or `b`.
+
+void mpi_mul9(Word *r, const Word *a, const Word *b)
+{
+  M25519_PROF_INC(MPI_MUL9);
+  mpi_mul(r, a, b, LEN + 1);
+}
+
+
+// Constant-time selection of an MPI from a table: $r = \mathrm{Tbl}[i]$
+// ---------------------------------------------------------------------
+// The table `tbl` consists of `num` MPIs of `len` words each. All MPIs of the
+// table are read and the one with index `idx` is selected via AND-masks, so
+// that neither the memory-access pattern nor the execution time depends on
+// `idx`, which must be in the range [0, `num`-1]. The MPIs are processed in
+// blocks of four words, which are accumulated in local variables (i.e., in
+// registers) so that each word of the table is loaded exactly once and each
+// word of `r` is written exactly once. `len` must be a multiple of 4 (and a
+// multiple of 8 for the Assembly versions).
+
+void mpi_select(Word *r, const Word *tbl, int idx, int num, int len)
+{
+  Word mask, w[4];
+  int i, j, k;
+  
+  M25519_PROF_INC(MPI_SELECT);
+  for (j = 0; j < len; j += 4) {
+    w[0] = w[1] = w[2] = w[3] = 0;
+    for (i = 0; i < num; i++) {
+      mask = (Word) (i ^ idx);  // mask is 0 if i equals idx
+      mask = 0 - ((mask - 1) >> (WSIZE - 1));  // all-1 if i equals idx
+      for (k = 0; k < 4; k++) w[k] |= (tbl[i*len+j+k] & mask);
+    }
+    for (k = 0; k < 4; k++) r[j+k] = w[k];
+  }
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 #endif /////////// ADDITIONAL OR ALTERNATIVE IMPLEMENTATIONS //////////////////
 ///////////////////////////////////////////////////////////////////////////////
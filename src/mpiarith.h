@@ -21,6 +21,7 @@
 #define _MPIARITH_H
 
 #include "config.h"
+#include "profile.h"
 
 // utility functions (only in C)
 int  mpi_from_hex(Word *r, const char *hexstr, int len);
@@ -39,12 +40,34 @@ void mpi_mul(Word *r, const Word *a, const Word *b, int len);
 // arithmetic functions with C and ASM implementations
 #if defined(M25519_ASSEMBLY)  // ASM functions are available
 extern int mpi_shr_asm(Word *r, const Word *a, int len);
-#define mpi_shr(r, a, len) mpi_shr_asm((r), (a), (len))
+#define mpi_shr(r, a, len) \
+  M25519_PROF_CALL(MPI_SHR, mpi_shr_asm((r), (a), (len)))
 extern int mpi_sub_asm(Word *r, const Word *a, const Word *b, int len);
-#define mpi_sub(r, a, b, len) mpi_sub_asm((r), (a), (b), (len))
+#define mpi_sub(r, a, b, len) \
+  M25519_PROF_CALL(MPI_SUB, mpi_sub_asm((r), (a), (b), (len)))
 #else  // ASM functions are not available or not used
 int mpi_shr(Word *r, const Word *a, int len);
 int mpi_sub(Word *r, const Word *a, const Word *b, int len);
 #endif
+#if defined(M25519_ASSEMBLY_EXT)  // additional ASM functions are available
+extern int mpi_divsteps_asm(Word *t, Word f0, Word g0, int zeta);
+#define mpi_divsteps(t, f0, g0, zeta) \
+  M25519_PROF_CALL(MPI_DIVSTEPS, mpi_divsteps_asm((t), (f0), (g0), (zeta)))
+extern void mpi_mul8_asm(Word *r, const Word *a, const Word *b);
+#define mpi_mul8(r, a, b) \
+  M25519_PROF_CALL(MPI_MUL8, mpi_mul8_asm((r), (a), (b)))
+extern void mpi_mul9_asm(Word *r, const Word *a, const Word *b);
+#define mpi_mul9(r, a, b) \
+  M25519_PROF_CALL(MPI_MUL9, mpi_mul9_asm((r), (a), (b)))
+extern void mpi_select_asm(Word *r, const Word *tbl, int idx, int num, \
+  int len);
+#define mpi_select(r, tbl, idx, num, len) \
+  M25519_PROF_CALL(MPI_SELECT, mpi_select_asm((r), (tbl), (idx), (num), (len)))
+#else  // additional ASM functions are not available or not used
+int mpi_divsteps(Word *t, Word f0, Word g0, int zeta);
+void mpi_mul8(Word *r, const Word *a, const Word *b);
+void mpi_mul9(Word *r, const Word *a, const Word *b);
+void mpi_select(Word *r, const Word *tbl, int idx, int num, int len);
+#endif
 
 #endif
@@ -0,0 +1,87 @@
+///////////////////////////////////////////////////////////////////////////////
+// profile.c: Counters of field-arithmetic operations (profiling).           //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// The operation counters are only available when `M25519_PROFILE` is defined
+// in `config.h` (or on the command line of the compiler). Each counter is
+// incremented at the start of the C implementation of the respective function
+// or, for functions with an ASM implementation, by the macro that maps the
+// name of the function to its ASM version (see `gfparith.h`). The counters are
+// plain global variables, which means profiling is not thread-safe and should
+// be used in single-threaded test programs only.
+
+
+#include "profile.h"
+
+
+#if defined(M25519_PROFILE)
+
+
+// Counters and their names (i.e., the names of the counted functions)
+
+uint32_t m25519_prof_cnt[M25519_PROF_NUM];
+
+static const char *m25519_prof_str[M25519_PROF_NUM] = {
+  "gfp_add", "gfp_add_nr", "gfp_sub", "gfp_sub_nr", "gfp_cneg", "gfp_hlv",
+  "gfp_mul", "gfp_mul32", "gfp_sqr", "gfp_sqrn", "gfp_inv", "gfp_inv_iter",
+  "mpi_sub", "mpi_shr", "mpi_divsteps", "mon_ladder_step", "mpi_mul8",
+  "mpi_mul9", "mpi_select"
+};
+
+
+// Current value of a counter
+// --------------------------
+// This function returns the current value of the counter with index `id`
+// (i.e., `M25519_PROF_GFP_ADD` to `M25519_PROF_NUM-1`), or 0 when `id` is not
+// a valid index.
+
+uint32_t m25519_prof_get(int id)
+{
+  if ((id < 0) || (id >= M25519_PROF_NUM)) return 0;
+  
+  return m25519_prof_cnt[id];
+}
+
+
+// Name of a counter
+// -----------------
+// This function returns the name of the function counted by the counter with
+// index `id`, or `NULL` when `id` is not a valid index.
+
+const char *m25519_prof_name(int id)
+{
+  if ((id < 0) || (id >= M25519_PROF_NUM)) return (const char *) 0;
+  
+  return m25519_prof_str[id];
+}
+
+
+// Reset of all counters
+// ---------------------
+// This function sets all counters to 0.
+
+void m25519_prof_reset(void)
+{
+  int i;
+  
+  for (i = 0; i < M25519_PROF_NUM; i++) m25519_prof_cnt[i] = 0;
+}
+
+
+#endif  // #if defined(M25519_PROFILE)
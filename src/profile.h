@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////////
+// profile.h: Counters of field-arithmetic operations (profiling).           //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _PROFILE_H
+#define _PROFILE_H
+
+#include "config.h"
+
+// Indices of the operation counters; the counter `GFP_INV_ITER` counts the
+// iterations of the outer loop of the EEA-based inversion (or the batches of
+// divsteps when `M25519_SAFEGCD_INV` is defined)
+
+#define M25519_PROF_GFP_ADD          0
+#define M25519_PROF_GFP_ADD_NR       1
+#define M25519_PROF_GFP_SUB          2
+#define M25519_PROF_GFP_SUB_NR       3
+#define M25519_PROF_GFP_CNEG         4
+#define M25519_PROF_GFP_HLV          5
+#define M25519_PROF_GFP_MUL          6
+#define M25519_PROF_GFP_MUL32        7
+#define M25519_PROF_GFP_SQR          8
+#define M25519_PROF_GFP_SQRN         9
+#define M25519_PROF_GFP_INV         10
+#define M25519_PROF_GFP_INV_ITER    11
+#define M25519_PROF_MPI_SUB         12
+#define M25519_PROF_MPI_SHR         13
+#define M25519_PROF_MPI_DIVSTEPS    14
+#define M25519_PROF_MON_LADDER_STEP 15
+#define M25519_PROF_MPI_MUL8        16
+#define M25519_PROF_MPI_MUL9        17
+#define M25519_PROF_MPI_SELECT      18
+#define M25519_PROF_NUM             19
+
+// When `M25519_PROFILE` is defined, `M25519_PROF_INC` increments a counter,
+// `M25519_PROF_ADD` adds a non-negative value to a counter, and the macro
+// `M25519_PROF_CALL` increments a counter before executing a function call
+// (used to wrap the mapping of functions to their ASM versions). The macro
+// `M25519_PROF_KINC` is used by the C kernels that can be installed in the
+// ops table (see `backend.h`); in ops-table mode, it vanishes since the calls
+// are then counted by the macros in `gfparith.h`. When `M25519_PROFILE` is
+// not defined, these macros vanish without any overhead.
+
+#if defined(M25519_PROFILE)
+extern uint32_t m25519_prof_cnt[M25519_PROF_NUM];
+#define M25519_PROF_INC(id) ((void) m25519_prof_cnt[M25519_PROF_##id]++)
+#define M25519_PROF_ADD(id, k) \
+  ((void) (m25519_prof_cnt[M25519_PROF_##id] += (((k) > 0) ? (k) : 0)))
+#define M25519_PROF_CALL(id, call) (M25519_PROF_INC(id), (call))
+#if defined(M25519_OPSTBL)
+#define M25519_PROF_KINC(id) ((void) 0)
+#else
+#define M25519_PROF_KINC(id) M25519_PROF_INC(id)
+#endif
+#else
+#define M25519_PROF_INC(id) ((void) 0)
+#define M25519_PROF_ADD(id, k) ((void) 0)
+#define M25519_PROF_CALL(id, call) (call)
+#define M25519_PROF_KINC(id) ((void) 0)
+#endif
+
+// prototypes of functions with C implementations only
+#if defined(M25519_PROFILE)
+uint32_t m25519_prof_get(int id);
+const char *m25519_prof_name(int id);
+void m25519_prof_reset(void);
+#endif
+
+#endif
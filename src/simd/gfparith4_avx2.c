@@ -0,0 +1,381 @@
+///////////////////////////////////////////////////////////////////////////////
+// gfparith4_avx2.c: Four-way parallel arithmetic in GF(p) using AVX2.       //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// This file contains AVX2 implementations of the four-way parallel arithmetic
+// operations in GF(p), which replace the C versions in `gfparith4.c` when
+// `M25519_SIMD` is defined and the compiler targets an x86-64 processor with
+// AVX2 extension (see `config.h`). The i-th limbs of the four lanes (stored
+// in four consecutive 32-bit words) are loaded into a 256-bit register and
+// zero-extended to four 64-bit words, so that the `vpmuludq` instruction can
+// compute four 32 x 32 -> 64-bit limb-products at once. The algorithms (and
+// the order of the carry propagation) are exactly the same as those of the C
+// versions, i.e., both implementations produce identical results.
+
+
+#include "../gfparith4.h"
+
+
+#if (defined(M25519_SIMD) && defined(__AVX2__))
+
+
+#include <immintrin.h>
+
+
+// Limb masks: 0x3FFFFFF (26 bits) and 0x1FFFFFF (25 bits)
+#define MASK26 0x3FFFFFFLL
+#define MASK25 0x1FFFFFFLL
+// Limbs of 2*p: 0x7FFFFDA (limb 0), 0x7FFFFFE (even), 0x3FFFFFE (odd)
+#define TWOPL0 0x7FFFFDALL
+#define TWOPEV 0x7FFFFFELL
+#define TWOPOD 0x3FFFFFELL
+
+
+// Loading and storing of the i-th limbs of the four lanes
+// -------------------------------------------------------
+// The four 32-bit limbs a[4*i], ..., a[4*i+3] are zero-extended to 64 bits
+// when loaded. Before storing, the lower 32-bit halves of the four 64-bit words
+// are gathered in the lower 128 bits of the register.
+
+static __m256i gfp4_ld(const Word *a, int i)
+{
+  return _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *) &a[4*i]));
+}
+
+static void gfp4_st(Word *r, int i, __m256i x)
+{
+  x = _mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7));
+  _mm_storeu_si128((__m128i *) &r[4*i], _mm256_castsi256_si128(x));
+}
+
+
+// Carry propagation of the limbs of all four lanes
+// ------------------------------------------------
+// Same as in `gfparith4.c`: two interleaved chains starting at limb 0 and limb
+// 5. The multiplication of the carry out of limb 9 by $c = 19$ is performed
+// with shifts and additions since this carry can be longer than 32 bits.
+
+static void gfp4_carry(Word *r, __m256i *h)
+{
+  const __m256i m26 = _mm256_set1_epi64x(MASK26);
+  const __m256i m25 = _mm256_set1_epi64x(MASK25);
+  __m256i c;
+  int i;
+
+  for (i = 0; i < NUMLIMBS/2; i++) {
+    c = _mm256_srli_epi64(h[i], 26 - (i & 1));
+    h[i] = _mm256_and_si256(h[i], (i & 1) ? m25 : m26);
+    h[i+1] = _mm256_add_epi64(h[i+1], c);
+    if (i + 6 < NUMLIMBS) {
+      c = _mm256_srli_epi64(h[i+5], 25 + (i & 1));
+      h[i+5] = _mm256_and_si256(h[i+5], (i & 1) ? m26 : m25);
+      h[i+6] = _mm256_add_epi64(h[i+6], c);
+    }
+  }
+  c = _mm256_srli_epi64(h[NUMLIMBS-1], 25);
+  h[NUMLIMBS-1] = _mm256_and_si256(h[NUMLIMBS-1], m25);
+  c = _mm256_add_epi64(c, _mm256_add_epi64(_mm256_slli_epi64(c, 1), \
+                                           _mm256_slli_epi64(c, 4)));
+  h[0] = _mm256_add_epi64(h[0], c);
+  c = _mm256_srli_epi64(h[5], 25);
+  h[5] = _mm256_and_si256(h[5], m25);
+  h[6] = _mm256_add_epi64(h[6], c);
+  c = _mm256_srli_epi64(h[0], 26);
+  h[0] = _mm256_and_si256(h[0], m26);
+  h[1] = _mm256_add_epi64(h[1], c);
+
+  for (i = 0; i < NUMLIMBS; i++) gfp4_st(r, i, h[i]);
+}
+
+
+// Addition of two vectors: $r = a + b \bmod p$
+
+void gfp4_add(Word *r, const Word *a, const Word *b)
+{
+  __m256i h[NUMLIMBS];
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    h[i] = _mm256_add_epi64(gfp4_ld(a, i), gfp4_ld(b, i));
+  }
+  gfp4_carry(r, h);
+}
+
+
+// Subtraction of two vectors: $r = a - b \bmod p$ (computed as $a + 2p - b$)
+
+void gfp4_sub(Word *r, const Word *a, const Word *b)
+{
+  __m256i h[NUMLIMBS], tp;
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    tp = _mm256_set1_epi64x((i == 0) ? TWOPL0 : ((i & 1) ? TWOPOD : TWOPEV));
+    h[i] = _mm256_sub_epi64(_mm256_add_epi64(gfp4_ld(a, i), tp), \
+                            gfp4_ld(b, i));
+  }
+  gfp4_carry(r, h);
+}
+
+
+// Conditional negation of a vector: $r = -a \bmod p$ or $r = a \bmod p$
+// ---------------------------------------------------------------------
+// Bit j of operand `neg` specifies whether lane j is negated. The four bits
+// are expanded to four 64-bit AND-masks with a variable shift and a compare.
+
+void gfp4_cneg(Word *r, const Word *a, int neg)
+{
+  __m256i h[NUMLIMBS], ai, tp, msk;
+  int i;
+
+  msk = _mm256_srlv_epi64(_mm256_set1_epi64x(neg), \
+                          _mm256_setr_epi64x(0, 1, 2, 3));
+  msk = _mm256_and_si256(msk, _mm256_set1_epi64x(1));
+  msk = _mm256_cmpeq_epi64(msk, _mm256_set1_epi64x(1));
+  for (i = 0; i < NUMLIMBS; i++) {
+    tp = _mm256_set1_epi64x((i == 0) ? TWOPL0 : ((i & 1) ? TWOPOD : TWOPEV));
+    ai = gfp4_ld(a, i);
+    tp = _mm256_sub_epi64(tp, ai);
+    h[i] = _mm256_xor_si256(ai, _mm256_and_si256(_mm256_xor_si256(ai, tp), \
+                                                 msk));
+  }
+  gfp4_carry(r, h);
+}
+
+
+// Multiplication of two vectors: $r = a \cdot b \bmod p$
+// ------------------------------------------------------
+// The limbs of $a$ are doubled and the limbs of $b$ are multiplied by $c = 19$
+// in advance, so that each of the 100 limb-products requires only one
+// `vpmuludq` and one `vpaddq` instruction. The product a[i]*b[k] is added to
+// column $(i+k) \bmod 10$ and uses the doubled a[i] when both $i$ and $k$ are
+// odd, and the pre-multiplied b[k] when $i+k \geq 10$.
+
+void gfp4_mul(Word *r, const Word *a, const Word *b)
+{
+  __m256i h[NUMLIMBS], al[NUMLIMBS], ad[NUMLIMBS], bl[NUMLIMBS], bc[NUMLIMBS];
+  const __m256i c19 = _mm256_set1_epi64x(CONSTC);
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    al[i] = gfp4_ld(a, i);
+    ad[i] = _mm256_slli_epi64(al[i], 1);
+    bl[i] = gfp4_ld(b, i);
+    bc[i] = _mm256_mul_epu32(bl[i], c19);
+  }
+
+  h[0] = _mm256_mul_epu32(al[0], bl[0]);
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(ad[1], bc[9]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(al[2], bc[8]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(ad[3], bc[7]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(al[4], bc[6]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(ad[5], bc[5]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(al[6], bc[4]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(ad[7], bc[3]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(al[8], bc[2]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(ad[9], bc[1]));
+  h[1] = _mm256_mul_epu32(al[0], bl[1]);
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(al[1], bl[0]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(al[2], bc[9]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(al[3], bc[8]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(al[4], bc[7]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(al[5], bc[6]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(al[6], bc[5]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(al[7], bc[4]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(al[8], bc[3]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(al[9], bc[2]));
+  h[2] = _mm256_mul_epu32(al[0], bl[2]);
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(ad[1], bl[1]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(al[2], bl[0]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(ad[3], bc[9]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(al[4], bc[8]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(ad[5], bc[7]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(al[6], bc[6]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(ad[7], bc[5]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(al[8], bc[4]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(ad[9], bc[3]));
+  h[3] = _mm256_mul_epu32(al[0], bl[3]);
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(al[1], bl[2]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(al[2], bl[1]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(al[3], bl[0]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(al[4], bc[9]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(al[5], bc[8]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(al[6], bc[7]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(al[7], bc[6]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(al[8], bc[5]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(al[9], bc[4]));
+  h[4] = _mm256_mul_epu32(al[0], bl[4]);
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(ad[1], bl[3]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(al[2], bl[2]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(ad[3], bl[1]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(al[4], bl[0]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(ad[5], bc[9]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(al[6], bc[8]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(ad[7], bc[7]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(al[8], bc[6]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(ad[9], bc[5]));
+  h[5] = _mm256_mul_epu32(al[0], bl[5]);
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(al[1], bl[4]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(al[2], bl[3]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(al[3], bl[2]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(al[4], bl[1]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(al[5], bl[0]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(al[6], bc[9]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(al[7], bc[8]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(al[8], bc[7]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(al[9], bc[6]));
+  h[6] = _mm256_mul_epu32(al[0], bl[6]);
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(ad[1], bl[5]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(al[2], bl[4]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(ad[3], bl[3]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(al[4], bl[2]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(ad[5], bl[1]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(al[6], bl[0]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(ad[7], bc[9]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(al[8], bc[8]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(ad[9], bc[7]));
+  h[7] = _mm256_mul_epu32(al[0], bl[7]);
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(al[1], bl[6]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(al[2], bl[5]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(al[3], bl[4]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(al[4], bl[3]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(al[5], bl[2]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(al[6], bl[1]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(al[7], bl[0]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(al[8], bc[9]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(al[9], bc[8]));
+  h[8] = _mm256_mul_epu32(al[0], bl[8]);
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(ad[1], bl[7]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(al[2], bl[6]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(ad[3], bl[5]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(al[4], bl[4]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(ad[5], bl[3]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(al[6], bl[2]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(ad[7], bl[1]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(al[8], bl[0]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(ad[9], bc[9]));
+  h[9] = _mm256_mul_epu32(al[0], bl[9]);
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(al[1], bl[8]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(al[2], bl[7]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(al[3], bl[6]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(al[4], bl[5]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(al[5], bl[4]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(al[6], bl[3]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(al[7], bl[2]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(al[8], bl[1]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(al[9], bl[0]));
+
+  gfp4_carry(r, h);
+}
+
+
+// Squaring of a vector: $r = a^2 \bmod p$
+// ---------------------------------------
+// Only the 55 limb-products a[i]*a[k] with $i \leq k$ are computed, whereby
+// the doubling of the products with $i < k$ is applied to a[i], while the
+// factors 2 (both indices odd) and 19 (reduction) are applied to a[k], which
+// means a[k] is needed in four versions: $a_k$, $2 a_k$, $19 a_k$, $38 a_k$.
+
+void gfp4_sqr(Word *r, const Word *a)
+{
+  __m256i h[NUMLIMBS], al[NUMLIMBS], ad[NUMLIMBS], ac[NUMLIMBS], adc[NUMLIMBS];
+  const __m256i c19 = _mm256_set1_epi64x(CONSTC);
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    al[i] = gfp4_ld(a, i);
+    ad[i] = _mm256_slli_epi64(al[i], 1);
+    ac[i] = _mm256_mul_epu32(al[i], c19);
+    adc[i] = _mm256_mul_epu32(ad[i], c19);
+  }
+
+  h[0] = _mm256_mul_epu32(al[0], al[0]);
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(ad[1], adc[9]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(ad[2], ac[8]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(ad[3], adc[7]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(ad[4], ac[6]));
+  h[0] = _mm256_add_epi64(h[0], _mm256_mul_epu32(al[5], adc[5]));
+  h[1] = _mm256_mul_epu32(ad[0], al[1]);
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(ad[2], ac[9]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(ad[3], ac[8]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(ad[4], ac[7]));
+  h[1] = _mm256_add_epi64(h[1], _mm256_mul_epu32(ad[5], ac[6]));
+  h[2] = _mm256_mul_epu32(ad[0], al[2]);
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(al[1], ad[1]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(ad[3], adc[9]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(ad[4], ac[8]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(ad[5], adc[7]));
+  h[2] = _mm256_add_epi64(h[2], _mm256_mul_epu32(al[6], ac[6]));
+  h[3] = _mm256_mul_epu32(ad[0], al[3]);
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(ad[1], al[2]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(ad[4], ac[9]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(ad[5], ac[8]));
+  h[3] = _mm256_add_epi64(h[3], _mm256_mul_epu32(ad[6], ac[7]));
+  h[4] = _mm256_mul_epu32(ad[0], al[4]);
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(ad[1], ad[3]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(al[2], al[2]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(ad[5], adc[9]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(ad[6], ac[8]));
+  h[4] = _mm256_add_epi64(h[4], _mm256_mul_epu32(al[7], adc[7]));
+  h[5] = _mm256_mul_epu32(ad[0], al[5]);
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(ad[1], al[4]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(ad[2], al[3]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(ad[6], ac[9]));
+  h[5] = _mm256_add_epi64(h[5], _mm256_mul_epu32(ad[7], ac[8]));
+  h[6] = _mm256_mul_epu32(ad[0], al[6]);
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(ad[1], ad[5]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(ad[2], al[4]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(al[3], ad[3]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(ad[7], adc[9]));
+  h[6] = _mm256_add_epi64(h[6], _mm256_mul_epu32(al[8], ac[8]));
+  h[7] = _mm256_mul_epu32(ad[0], al[7]);
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(ad[1], al[6]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(ad[2], al[5]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(ad[3], al[4]));
+  h[7] = _mm256_add_epi64(h[7], _mm256_mul_epu32(ad[8], ac[9]));
+  h[8] = _mm256_mul_epu32(ad[0], al[8]);
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(ad[1], ad[7]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(ad[2], al[6]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(ad[3], ad[5]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(al[4], al[4]));
+  h[8] = _mm256_add_epi64(h[8], _mm256_mul_epu32(al[9], adc[9]));
+  h[9] = _mm256_mul_epu32(ad[0], al[9]);
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(ad[1], al[8]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(ad[2], al[7]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(ad[3], al[6]));
+  h[9] = _mm256_add_epi64(h[9], _mm256_mul_epu32(ad[4], al[5]));
+
+  gfp4_carry(r, h);
+}
+
+
+// Multiplication of a vector by a 32-bit value: $r = a \cdot b \bmod p$
+
+void gfp4_mul32(Word *r, const Word *a, const Word *b)
+{
+  __m256i h[NUMLIMBS];
+  const __m256i bw = _mm256_set1_epi64x(b[0]);
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) h[i] = _mm256_mul_epu32(gfp4_ld(a, i), bw);
+  gfp4_carry(r, h);
+}
+
+
+#endif  // #if (defined(M25519_SIMD) && defined(__AVX2__))
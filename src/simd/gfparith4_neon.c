@@ -0,0 +1,412 @@
+///////////////////////////////////////////////////////////////////////////////
+// gfparith4_neon.c: Four-way parallel arithmetic in GF(p) using NEON.       //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// This file contains NEON implementations of the four-way parallel arithmetic
+// operations in GF(p), which replace the C versions in `gfparith4.c` when
+// `M25519_SIMD` is defined and the compiler targets an ARM processor (ARMv7-A
+// or AArch64) with NEON extension (see `config.h`). The i-th limbs of the four
+// lanes are loaded into a 128-bit register, and the limb-products are computed
+// with `vmull_u32` and `vmlal_u32`, each of which performs two 32 x 32 -> 64-
+// bit multiplications (i.e., the column-sums of the lower and upper two lanes
+// are kept in separate 128-bit registers). The algorithms (and the order of
+// the carry propagation) are exactly the same as those of the C versions, i.e.,
+// both implementations produce identical results.
+
+
+#include "../gfparith4.h"
+
+
+#if (defined(M25519_SIMD) && !defined(__AVX2__) && \
+    (defined(__ARM_NEON) || defined(__ARM_NEON__)))
+
+
+#include <arm_neon.h>
+
+
+// Limb masks: 0x3FFFFFF (26 bits) and 0x1FFFFFF (25 bits)
+#define MASK26 0x3FFFFFFULL
+#define MASK25 0x1FFFFFFULL
+
+// Limbs of 2*p: 0x7FFFFDA (limb 0), 0x7FFFFFE (even), 0x3FFFFFE (odd)
+static const Word TWOP[NUMLIMBS] = { 0x7FFFFDA, 0x3FFFFFE, 0x7FFFFFE, \
+  0x3FFFFFE, 0x7FFFFFE, 0x3FFFFFE, 0x7FFFFFE, 0x3FFFFFE, 0x7FFFFFE, 0x3FFFFFE };
+
+
+// Computation of limb-products in the lower and upper two lanes
+// --------------------------------------------------------------
+// `gfp4_mull` computes the four products of the 32-bit words in `x` and `y`
+// and `gfp4_mlal` adds them to the 64-bit column-sums in h[0] (lanes 0 and 1)
+// and h[1] (lanes 2 and 3).
+
+static void gfp4_mull(uint64x2_t *h, uint32x4_t x, uint32x4_t y)
+{
+  h[0] = vmull_u32(vget_low_u32(x), vget_low_u32(y));
+  h[1] = vmull_u32(vget_high_u32(x), vget_high_u32(y));
+}
+
+static void gfp4_mlal(uint64x2_t *h, uint32x4_t x, uint32x4_t y)
+{
+  h[0] = vmlal_u32(h[0], vget_low_u32(x), vget_low_u32(y));
+  h[1] = vmlal_u32(h[1], vget_high_u32(x), vget_high_u32(y));
+}
+
+
+// Carry propagation from limb i (26 or 25 bits long) to limb k
+// ------------------------------------------------------------
+// The shift distance of the NEON shift instructions has to be a compile-time
+// constant, which is the reason for having two versions of this function.
+
+static void gfp4_c26(uint64x2_t *h, int i, int k)
+{
+  const uint64x2_t m26 = vdupq_n_u64(MASK26);
+
+  h[2*k] = vsraq_n_u64(h[2*k], h[2*i], 26);
+  h[2*k+1] = vsraq_n_u64(h[2*k+1], h[2*i+1], 26);
+  h[2*i] = vandq_u64(h[2*i], m26);
+  h[2*i+1] = vandq_u64(h[2*i+1], m26);
+}
+
+static void gfp4_c25(uint64x2_t *h, int i, int k)
+{
+  const uint64x2_t m25 = vdupq_n_u64(MASK25);
+
+  h[2*k] = vsraq_n_u64(h[2*k], h[2*i], 25);
+  h[2*k+1] = vsraq_n_u64(h[2*k+1], h[2*i+1], 25);
+  h[2*i] = vandq_u64(h[2*i], m25);
+  h[2*i+1] = vandq_u64(h[2*i+1], m25);
+}
+
+
+// Carry propagation of the limbs of all four lanes
+// ------------------------------------------------
+// Same as in `gfparith4.c`: two interleaved chains starting at limb 0 and limb
+// 5. The multiplication of the carry out of limb 9 by $c = 19$ is performed
+// with shifts and additions since this carry can be longer than 32 bits.
+
+static void gfp4_carry(Word *r, uint64x2_t *h)
+{
+  const uint64x2_t m25 = vdupq_n_u64(MASK25);
+  uint64x2_t c;
+  int i;
+
+  gfp4_c26(h, 0, 1); gfp4_c25(h, 5, 6);
+  gfp4_c25(h, 1, 2); gfp4_c26(h, 6, 7);
+  gfp4_c26(h, 2, 3); gfp4_c25(h, 7, 8);
+  gfp4_c25(h, 3, 4); gfp4_c26(h, 8, 9);
+  gfp4_c26(h, 4, 5);
+  for (i = 0; i < 2; i++) {
+    c = vshrq_n_u64(h[2*NUMLIMBS-2+i], 25);
+    h[2*NUMLIMBS-2+i] = vandq_u64(h[2*NUMLIMBS-2+i], m25);
+    h[i] = vaddq_u64(h[i], c);
+    h[i] = vaddq_u64(h[i], vshlq_n_u64(c, 1));
+    h[i] = vaddq_u64(h[i], vshlq_n_u64(c, 4));
+  }
+  gfp4_c25(h, 5, 6);
+  gfp4_c26(h, 0, 1);
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    vst1q_u32(&r[4*i], vcombine_u32(vmovn_u64(h[2*i]), vmovn_u64(h[2*i+1])));
+  }
+}
+
+
+// Addition of two vectors: $r = a + b \bmod p$
+
+void gfp4_add(Word *r, const Word *a, const Word *b)
+{
+  uint64x2_t h[2*NUMLIMBS];
+  uint32x4_t ai, bi;
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    ai = vld1q_u32(&a[4*i]);
+    bi = vld1q_u32(&b[4*i]);
+    h[2*i] = vaddl_u32(vget_low_u32(ai), vget_low_u32(bi));
+    h[2*i+1] = vaddl_u32(vget_high_u32(ai), vget_high_u32(bi));
+  }
+  gfp4_carry(r, h);
+}
+
+
+// Subtraction of two vectors: $r = a - b \bmod p$ (computed as $a + 2p - b$)
+
+void gfp4_sub(Word *r, const Word *a, const Word *b)
+{
+  uint64x2_t h[2*NUMLIMBS];
+  uint32x4_t ti;
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    ti = vaddq_u32(vld1q_u32(&a[4*i]), vdupq_n_u32(TWOP[i]));
+    ti = vsubq_u32(ti, vld1q_u32(&b[4*i]));
+    h[2*i] = vmovl_u32(vget_low_u32(ti));
+    h[2*i+1] = vmovl_u32(vget_high_u32(ti));
+  }
+  gfp4_carry(r, h);
+}
+
+
+// Conditional negation of a vector: $r = -a \bmod p$ or $r = a \bmod p$
+// ---------------------------------------------------------------------
+// Bit j of operand `neg` specifies whether lane j is negated. The four bits
+// are expanded to four 32-bit AND-masks with a single `vtstq_u32`.
+
+void gfp4_cneg(Word *r, const Word *a, int neg)
+{
+  static const Word lbit[NUMLANES] = { 1, 2, 4, 8 };
+  uint64x2_t h[2*NUMLIMBS];
+  uint32x4_t ai, ti, msk;
+  int i;
+
+  msk = vtstq_u32(vdupq_n_u32((Word) neg), vld1q_u32(lbit));
+  for (i = 0; i < NUMLIMBS; i++) {
+    ai = vld1q_u32(&a[4*i]);
+    ti = vsubq_u32(vdupq_n_u32(TWOP[i]), ai);
+    ti = veorq_u32(ai, vandq_u32(veorq_u32(ai, ti), msk));
+    h[2*i] = vmovl_u32(vget_low_u32(ti));
+    h[2*i+1] = vmovl_u32(vget_high_u32(ti));
+  }
+  gfp4_carry(r, h);
+}
+
+
+// Multiplication of two vectors: $r = a \cdot b \bmod p$
+// ------------------------------------------------------
+// The limbs of $a$ are doubled and the limbs of $b$ are multiplied by $c = 19$
+// in advance (both fit into 32 bits). The product a[i]*b[k] is added to column
+// $(i+k) \bmod 10$ and uses the doubled a[i] when both $i$ and $k$ are odd,
+// and the pre-multiplied b[k] when $i+k \geq 10$.
+
+void gfp4_mul(Word *r, const Word *a, const Word *b)
+{
+  uint64x2_t h[2*NUMLIMBS];
+  uint32x4_t al[NUMLIMBS], ad[NUMLIMBS], bl[NUMLIMBS], bc[NUMLIMBS];
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    al[i] = vld1q_u32(&a[4*i]);
+    ad[i] = vshlq_n_u32(al[i], 1);
+    bl[i] = vld1q_u32(&b[4*i]);
+    bc[i] = vmulq_n_u32(bl[i], CONSTC);
+  }
+
+  gfp4_mull(&h[0], al[0], bl[0]);
+  gfp4_mlal(&h[0], ad[1], bc[9]);
+  gfp4_mlal(&h[0], al[2], bc[8]);
+  gfp4_mlal(&h[0], ad[3], bc[7]);
+  gfp4_mlal(&h[0], al[4], bc[6]);
+  gfp4_mlal(&h[0], ad[5], bc[5]);
+  gfp4_mlal(&h[0], al[6], bc[4]);
+  gfp4_mlal(&h[0], ad[7], bc[3]);
+  gfp4_mlal(&h[0], al[8], bc[2]);
+  gfp4_mlal(&h[0], ad[9], bc[1]);
+  gfp4_mull(&h[2], al[0], bl[1]);
+  gfp4_mlal(&h[2], al[1], bl[0]);
+  gfp4_mlal(&h[2], al[2], bc[9]);
+  gfp4_mlal(&h[2], al[3], bc[8]);
+  gfp4_mlal(&h[2], al[4], bc[7]);
+  gfp4_mlal(&h[2], al[5], bc[6]);
+  gfp4_mlal(&h[2], al[6], bc[5]);
+  gfp4_mlal(&h[2], al[7], bc[4]);
+  gfp4_mlal(&h[2], al[8], bc[3]);
+  gfp4_mlal(&h[2], al[9], bc[2]);
+  gfp4_mull(&h[4], al[0], bl[2]);
+  gfp4_mlal(&h[4], ad[1], bl[1]);
+  gfp4_mlal(&h[4], al[2], bl[0]);
+  gfp4_mlal(&h[4], ad[3], bc[9]);
+  gfp4_mlal(&h[4], al[4], bc[8]);
+  gfp4_mlal(&h[4], ad[5], bc[7]);
+  gfp4_mlal(&h[4], al[6], bc[6]);
+  gfp4_mlal(&h[4], ad[7], bc[5]);
+  gfp4_mlal(&h[4], al[8], bc[4]);
+  gfp4_mlal(&h[4], ad[9], bc[3]);
+  gfp4_mull(&h[6], al[0], bl[3]);
+  gfp4_mlal(&h[6], al[1], bl[2]);
+  gfp4_mlal(&h[6], al[2], bl[1]);
+  gfp4_mlal(&h[6], al[3], bl[0]);
+  gfp4_mlal(&h[6], al[4], bc[9]);
+  gfp4_mlal(&h[6], al[5], bc[8]);
+  gfp4_mlal(&h[6], al[6], bc[7]);
+  gfp4_mlal(&h[6], al[7], bc[6]);
+  gfp4_mlal(&h[6], al[8], bc[5]);
+  gfp4_mlal(&h[6], al[9], bc[4]);
+  gfp4_mull(&h[8], al[0], bl[4]);
+  gfp4_mlal(&h[8], ad[1], bl[3]);
+  gfp4_mlal(&h[8], al[2], bl[2]);
+  gfp4_mlal(&h[8], ad[3], bl[1]);
+  gfp4_mlal(&h[8], al[4], bl[0]);
+  gfp4_mlal(&h[8], ad[5], bc[9]);
+  gfp4_mlal(&h[8], al[6], bc[8]);
+  gfp4_mlal(&h[8], ad[7], bc[7]);
+  gfp4_mlal(&h[8], al[8], bc[6]);
+  gfp4_mlal(&h[8], ad[9], bc[5]);
+  gfp4_mull(&h[10], al[0], bl[5]);
+  gfp4_mlal(&h[10], al[1], bl[4]);
+  gfp4_mlal(&h[10], al[2], bl[3]);
+  gfp4_mlal(&h[10], al[3], bl[2]);
+  gfp4_mlal(&h[10], al[4], bl[1]);
+  gfp4_mlal(&h[10], al[5], bl[0]);
+  gfp4_mlal(&h[10], al[6], bc[9]);
+  gfp4_mlal(&h[10], al[7], bc[8]);
+  gfp4_mlal(&h[10], al[8], bc[7]);
+  gfp4_mlal(&h[10], al[9], bc[6]);
+  gfp4_mull(&h[12], al[0], bl[6]);
+  gfp4_mlal(&h[12], ad[1], bl[5]);
+  gfp4_mlal(&h[12], al[2], bl[4]);
+  gfp4_mlal(&h[12], ad[3], bl[3]);
+  gfp4_mlal(&h[12], al[4], bl[2]);
+  gfp4_mlal(&h[12], ad[5], bl[1]);
+  gfp4_mlal(&h[12], al[6], bl[0]);
+  gfp4_mlal(&h[12], ad[7], bc[9]);
+  gfp4_mlal(&h[12], al[8], bc[8]);
+  gfp4_mlal(&h[12], ad[9], bc[7]);
+  gfp4_mull(&h[14], al[0], bl[7]);
+  gfp4_mlal(&h[14], al[1], bl[6]);
+  gfp4_mlal(&h[14], al[2], bl[5]);
+  gfp4_mlal(&h[14], al[3], bl[4]);
+  gfp4_mlal(&h[14], al[4], bl[3]);
+  gfp4_mlal(&h[14], al[5], bl[2]);
+  gfp4_mlal(&h[14], al[6], bl[1]);
+  gfp4_mlal(&h[14], al[7], bl[0]);
+  gfp4_mlal(&h[14], al[8], bc[9]);
+  gfp4_mlal(&h[14], al[9], bc[8]);
+  gfp4_mull(&h[16], al[0], bl[8]);
+  gfp4_mlal(&h[16], ad[1], bl[7]);
+  gfp4_mlal(&h[16], al[2], bl[6]);
+  gfp4_mlal(&h[16], ad[3], bl[5]);
+  gfp4_mlal(&h[16], al[4], bl[4]);
+  gfp4_mlal(&h[16], ad[5], bl[3]);
+  gfp4_mlal(&h[16], al[6], bl[2]);
+  gfp4_mlal(&h[16], ad[7], bl[1]);
+  gfp4_mlal(&h[16], al[8], bl[0]);
+  gfp4_mlal(&h[16], ad[9], bc[9]);
+  gfp4_mull(&h[18], al[0], bl[9]);
+  gfp4_mlal(&h[18], al[1], bl[8]);
+  gfp4_mlal(&h[18], al[2], bl[7]);
+  gfp4_mlal(&h[18], al[3], bl[6]);
+  gfp4_mlal(&h[18], al[4], bl[5]);
+  gfp4_mlal(&h[18], al[5], bl[4]);
+  gfp4_mlal(&h[18], al[6], bl[3]);
+  gfp4_mlal(&h[18], al[7], bl[2]);
+  gfp4_mlal(&h[18], al[8], bl[1]);
+  gfp4_mlal(&h[18], al[9], bl[0]);
+
+  gfp4_carry(r, h);
+}
+
+
+// Squaring of a vector: $r = a^2 \bmod p$
+// ---------------------------------------
+// Only the 55 limb-products a[i]*a[k] with $i \leq k$ are computed, whereby
+// the doubling of the products with $i < k$ is applied to a[i], while the
+// factors 2 (both indices odd) and 19 (reduction) are applied to a[k], which
+// means a[k] is needed in four versions: $a_k$, $2 a_k$, $19 a_k$, $38 a_k$.
+
+void gfp4_sqr(Word *r, const Word *a)
+{
+  uint64x2_t h[2*NUMLIMBS];
+  uint32x4_t al[NUMLIMBS], ad[NUMLIMBS], ac[NUMLIMBS], adc[NUMLIMBS];
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    al[i] = vld1q_u32(&a[4*i]);
+    ad[i] = vshlq_n_u32(al[i], 1);
+    ac[i] = vmulq_n_u32(al[i], CONSTC);
+    adc[i] = vmulq_n_u32(ad[i], CONSTC);
+  }
+
+  gfp4_mull(&h[0], al[0], al[0]);
+  gfp4_mlal(&h[0], ad[1], adc[9]);
+  gfp4_mlal(&h[0], ad[2], ac[8]);
+  gfp4_mlal(&h[0], ad[3], adc[7]);
+  gfp4_mlal(&h[0], ad[4], ac[6]);
+  gfp4_mlal(&h[0], al[5], adc[5]);
+  gfp4_mull(&h[2], ad[0], al[1]);
+  gfp4_mlal(&h[2], ad[2], ac[9]);
+  gfp4_mlal(&h[2], ad[3], ac[8]);
+  gfp4_mlal(&h[2], ad[4], ac[7]);
+  gfp4_mlal(&h[2], ad[5], ac[6]);
+  gfp4_mull(&h[4], ad[0], al[2]);
+  gfp4_mlal(&h[4], al[1], ad[1]);
+  gfp4_mlal(&h[4], ad[3], adc[9]);
+  gfp4_mlal(&h[4], ad[4], ac[8]);
+  gfp4_mlal(&h[4], ad[5], adc[7]);
+  gfp4_mlal(&h[4], al[6], ac[6]);
+  gfp4_mull(&h[6], ad[0], al[3]);
+  gfp4_mlal(&h[6], ad[1], al[2]);
+  gfp4_mlal(&h[6], ad[4], ac[9]);
+  gfp4_mlal(&h[6], ad[5], ac[8]);
+  gfp4_mlal(&h[6], ad[6], ac[7]);
+  gfp4_mull(&h[8], ad[0], al[4]);
+  gfp4_mlal(&h[8], ad[1], ad[3]);
+  gfp4_mlal(&h[8], al[2], al[2]);
+  gfp4_mlal(&h[8], ad[5], adc[9]);
+  gfp4_mlal(&h[8], ad[6], ac[8]);
+  gfp4_mlal(&h[8], al[7], adc[7]);
+  gfp4_mull(&h[10], ad[0], al[5]);
+  gfp4_mlal(&h[10], ad[1], al[4]);
+  gfp4_mlal(&h[10], ad[2], al[3]);
+  gfp4_mlal(&h[10], ad[6], ac[9]);
+  gfp4_mlal(&h[10], ad[7], ac[8]);
+  gfp4_mull(&h[12], ad[0], al[6]);
+  gfp4_mlal(&h[12], ad[1], ad[5]);
+  gfp4_mlal(&h[12], ad[2], al[4]);
+  gfp4_mlal(&h[12], al[3], ad[3]);
+  gfp4_mlal(&h[12], ad[7], adc[9]);
+  gfp4_mlal(&h[12], al[8], ac[8]);
+  gfp4_mull(&h[14], ad[0], al[7]);
+  gfp4_mlal(&h[14], ad[1], al[6]);
+  gfp4_mlal(&h[14], ad[2], al[5]);
+  gfp4_mlal(&h[14], ad[3], al[4]);
+  gfp4_mlal(&h[14], ad[8], ac[9]);
+  gfp4_mull(&h[16], ad[0], al[8]);
+  gfp4_mlal(&h[16], ad[1], ad[7]);
+  gfp4_mlal(&h[16], ad[2], al[6]);
+  gfp4_mlal(&h[16], ad[3], ad[5]);
+  gfp4_mlal(&h[16], al[4], al[4]);
+  gfp4_mlal(&h[16], al[9], adc[9]);
+  gfp4_mull(&h[18], ad[0], al[9]);
+  gfp4_mlal(&h[18], ad[1], al[8]);
+  gfp4_mlal(&h[18], ad[2], al[7]);
+  gfp4_mlal(&h[18], ad[3], al[6]);
+  gfp4_mlal(&h[18], ad[4], al[5]);
+
+  gfp4_carry(r, h);
+}
+
+
+// Multiplication of a vector by a 32-bit value: $r = a \cdot b \bmod p$
+
+void gfp4_mul32(Word *r, const Word *a, const Word *b)
+{
+  uint64x2_t h[2*NUMLIMBS];
+  uint32x4_t ai;
+  int i;
+
+  for (i = 0; i < NUMLIMBS; i++) {
+    ai = vld1q_u32(&a[4*i]);
+    h[2*i] = vmull_n_u32(vget_low_u32(ai), b[0]);
+    h[2*i+1] = vmull_n_u32(vget_high_u32(ai), b[0]);
+  }
+  gfp4_carry(r, h);
+}
+
+
+#endif  // #if (defined(M25519_SIMD) && ...
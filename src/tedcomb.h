@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////////
+// tedcomb.h: Pre-computed table for the fixed-base comb method.             //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This file has been generated by `test/gentbl_ted_comb.py`, do not edit.   //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _TEDCOMB_H
+#define _TEDCOMB_H
+
+#include "config.h"
+
+// Number of teeth and number of tables of the comb method
+
+#define TEDCOMB_TEETH 4
+#define TEDCOMB_TABLES 1
+
+// Table T_b[x] = 2^(256*b)*(G + sum_i (-1)^(1-x_i)*2^(64*i)*G)
+// with i = 1, ..., 3 and x_i = bit i-1 of x in extended affine (u,v,w)
+// coordinates (8 points, 768 bytes)
+
+static const Word TEDCOMBTBL[8*3*LEN] = {
+  // T_0[0]
+  0x138D08C5, 0x043F3A58, 0x85870FA1, 0xB3E07013,
+  0x8695B247, 0xF76E41CE, 0x7DCE4545, 0x7573504B,
+  0x0AB029D1, 0x82BD9764, 0x797EC894, 0x86D65A13,
+  0x5E886EEA, 0x7186C690, 0x83CDD997, 0x13DBCB4E,
+  0xB7B93EB6, 0x2C6DE0D2, 0xB8573997, 0xC68F3992,
+  0x703911A9, 0x868E0BE2, 0xA1384261, 0x07976122,
+  // T_0[1]
+  0xC24A250D, 0x4131C7C8, 0xCBC11802, 0x30AA5756,
+  0x97E05677, 0x3C51A4EF, 0x23F02CE0, 0x48D56ED2,
+  0xEC5F863D, 0xFBC48D8F, 0xCF85D764, 0xD9A913C5,
+  0xD666F119, 0x04130B9C, 0x796CE42E, 0x773443AA,
+  0x06D5981A, 0xAE4E6613, 0xF9081E12, 0xA083E1D5,
+  0x05481AAE, 0x38B4839E, 0x5A442922, 0x1E99A6EE,
+  // T_0[2]
+  0xAD06EADB, 0x8F998DB2, 0xE4C315E9, 0x85AA2FB0,
+  0x8AB9BC19, 0x1CCBC4D9, 0x3BA1EA2E, 0x49A839C8,
+  0xD60223B7, 0x4C8A1F02, 0x63394329, 0x2AC07ED3,
+  0x860ADE69, 0x9F7A426C, 0x2467132B, 0x4ECECE0F,
+  0x052970A1, 0xF60FBCE8, 0x37C71742, 0x0082CE23,
+  0x063EB98A, 0x93E44CB6, 0x5AD17D52, 0x3AD48C27,
+  // T_0[3]
+  0xEDC4684D, 0xF1F15409, 0xADD8A6E0, 0x37A0589E,
+  0xAA8F15E9, 0xE338AA12, 0x62321CB6, 0x6002DBD7,
+  0x12399C1F, 0x25D85164, 0x69CD242A, 0xC5C9EC8E,
+  0x5522C5A8, 0xB241E177, 0x24043413, 0x25E74A23,
+  0xD209C35F, 0x19BF8F3E, 0xA84944ED, 0x8FA5AB17,
+  0x682268B3, 0xCF596541, 0xCE2CDE12, 0x71C42244,
+  // T_0[4]
+  0xD71F346A, 0x8B695AAC, 0xAC23D65E, 0xB7E2B139,
+  0x4B14843A, 0x5CC48FAA, 0xB7F9C533, 0x61D47EE7,
+  0xCEB89A58, 0xF4EF693A, 0xAA3D8506, 0xF3DE5AC9,
+  0x0139A27D, 0xAF5E32F8, 0xC4DE4053, 0x33279AC7,
+  0x338AF5DA, 0x9EEA1CB2, 0x9DF251F8, 0x88A6C978,
+  0xABEA60AC, 0xF0A1C5B3, 0x3E77B642, 0x28DABE4E,
+  // T_0[5]
+  0x12AFC64E, 0x56E7E735, 0xE4A24477, 0xC5EC3BA0,
+  0x02222DFE, 0x049D4A6A, 0xFE748A45, 0x3D9288F9,
+  0xDF91AD9F, 0x8921237B, 0x0F6C3EE5, 0x743F372A,
+  0x609C2AC9, 0xBC29761A, 0x32A12F89, 0x3E0C2D44,
+  0x4F6CD7EE, 0xCBA7C0C7, 0xB5833E0C, 0x81999C80,
+  0xD0B2F852, 0xA23E4D6E, 0x0A0C2BDA, 0x6CB20250,
+  // T_0[6]
+  0x3BFEEC90, 0x66697EB4, 0x21BACF21, 0x413BB77F,
+  0xF24BE1BA, 0x6F627A4F, 0xA412460D, 0x6F2234AB,
+  0x17CD38CC, 0x31FC4062, 0x4881031D, 0xA285C8D8,
+  0x6A148DE8, 0x2374BE41, 0xFC547DB7, 0x61E97F59,
+  0x4B848FFF, 0x145E8B3A, 0x4EA5D384, 0x3814CAE8,
+  0x2F8076CA, 0x7D9BE98D, 0xCF8A095E, 0x0AA77DF7,
+  // T_0[7]
+  0xA3FDDC21, 0x89BF75B3, 0xB0408D45, 0x3CEFAE3A,
+  0xB8FC644D, 0x2D15D3B7, 0x1DE47FE1, 0x04CA952B,
+  0xEE3F7C1E, 0x515465A5, 0x2FC9E113, 0xCB5AE37D,
+  0x833271D2, 0xEA75F58D, 0x72E36797, 0x204DA56E,
+  0xC1A1A862, 0x226A9EDC, 0xD2FA82DA, 0xC494C982,
+  0x2CA4FF97, 0x7D917D51, 0x8232BEB2, 0x34DCB453
+};
+
+#endif
@@ -0,0 +1,1480 @@
+///////////////////////////////////////////////////////////////////////////////
+// tedcurve.c: Arithmetic on the twisted Edwards curve Edwards25519.         //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// The functions below operate on points of the twisted Edwards (TED) curve
+// Edwards25519, which is given by the equation $-x^2 + y^2 = 1 + d x^2 y^2$
+// with $d = -121665/121666$ over the prime field GF(p) with $p = 2^{255} -
+// 19$. Points are represented in affine $(x,y)$, extended affine $(u,v,w) =
+// ((x+y)/2, (y-x)/2, d x y)$, projective $[X:Y:Z]$ or extended projective
+// $[X:Y:Z:E:H]$ coordinates with $E H = T = X Y/Z$ (see `Point` in `config.h`).
+// The addition law of Edwards25519 is complete, i.e., the same formulas can be
+// used for all inputs, including the neutral element $O = (0,1)$ and $P = Q$.
+
+
+#include <stddef.h>
+#include "mpiarith.h"
+#include "gfparith.h"
+#include "tedcurve.h"
+#include "tedcomb.h"
+#include "ed25519.h"
+
+
+#if ((TEDCOMB_TEETH != M25519_COMB_TEETH) || \
+     (TEDCOMB_TABLES != M25519_COMB_TABLES))
+#error "tedcomb.h does not match M25519_COMB_TEETH and M25519_COMB_TABLES"
+#endif
+
+#if ((M25519_COMB_TEETH < 2) || (M25519_COMB_TEETH > 8) || \
+     (M25519_COMB_TEETH*M25519_COMB_TABLES > 32))
+#error "M25519_COMB_TEETH must be in [2, 8] and TEETH*TABLES at most 32"
+#endif
+
+#if ((M25519_TED_WINDOW < 3) || (M25519_TED_WINDOW > 7))
+#error "M25519_TED_WINDOW must be in [3, 7]"
+#endif
+
+
+// Constant $a_{24} = (A+2)/4$ of Curve25519
+static const Word CONSTA24[1] = { 121666 };
+
+// Parameter $d = -121665/121666 \bmod p$ of Edwards25519
+static const Word CONSTD[LEN] = {
+  0x135978A3, 0x75EB4DCA, 0x4141D8AB, 0x00700A4D,
+  0x7779E898, 0x8CC74079, 0x2B6FFE73, 0x52036CEE
+};
+
+// Root of $-(A+2) = -486664 \bmod p$ for the mapping MON <-> TED
+static const Word CONSTRMA[LEN] = {
+  0xFF457E06, 0xCC6E04AA, 0x4B7D1A82, 0xC5A1D3D1,
+  0x03FC4F7E, 0xD27B08DC, 0x60A006BB, 0x0F26EDF4
+};
+
+// Root of $-1$, i.e., $2^{(p-1)/4} \bmod p$
+static const Word CONSTRM1[LEN] = {
+  0x4A0EA0B0, 0xC4EE1B27, 0xAD2FE478, 0x2F431806,
+  0x3DFBD7A7, 0x2B4D0099, 0x4FC1DF0B, 0x2B832480
+};
+
+// Cardinality $8 \ell$ of the elliptic-curve group
+static const Word CONSTCAR[LEN] = {
+  0xE7AE9F68, 0xC09318D2, 0x17BCE6B2, 0xA6F7CEF5,
+  0x00000000, 0x00000000, 0x00000000, 0x80000000
+};
+
+// Barrett constant $\lfloor 2^{512}/(8 \ell) \rfloor$ (257 bits long)
+static const Word CONSTCBR[LEN+1] = {
+  0x61458263, 0xFDB39CB4, 0xA10C6534, 0x6420C42B,
+  0xFFFFFFFD, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+  0x00000001
+};
+
+// Generator $G$ of Edwards25519 in extended affine coordinates $(u,v,w)$
+const Word TEDGENEA[3*LEN] = {
+  0x7AC61DB9, 0x97DE49E3, 0x7DC6070C, 0x67C996E3,
+  0x321EA161, 0x9385A44C, 0x19EA5D32, 0x43E7CE9D,
+  0xEBA0489F, 0xCE881C82, 0xE8A05F59, 0xFE9CCF82,
+  0x3447C504, 0xD2E0C21A, 0x4C7C0933, 0x227E97C9,
+  0xC3BD5534, 0x55E48902, 0xE655624F, 0x136CF411,
+  0xEEA1ACC6, 0x2D0DBEE5, 0x4F8632D4, 0x3788BDB4
+};
+
+const ECDomPar ECDOMPAR25519 = { CONSTK, CONSTC, CONSTA24, CONSTD, CONSTRMA, \
+  CONSTRM1, CONSTCAR, CONSTCBR, TEDCOMBTBL };
+
+
+// Bitlength of the recoded scalar processed by the comb method (at most 285
+// bits, i.e., the recoded scalar fits into LEN+1 words)
+
+#define COMBBITS (M25519_COMB_TEETH*M25519_COMB_TABLES*TED_COMBSPACE)
+
+// Maximum window-width used by `ted_mul_multi` (i.e., $2^{MAXWIN-1}$ buckets),
+// which is 5 only when `TED_MAXMULTI` allows 96 or more points
+#if (TED_MAXMULTI < 96)
+#define MAXWIN 4
+#else
+#define MAXWIN 5
+#endif
+
+// Maximum number of (signed) windows of a 256-bit scalar, which is reached for
+// the smallest window-width of 2
+#define MAXNUMWIN ((WSIZE*LEN)/2 + 1)
+
+// Number of Words needed to store one carry-bit per window
+#define CBITWORDS ((MAXNUMWIN + WSIZE)/WSIZE)
+
+// Number of digits of the wNAF of a 256-bit scalar (see `TED_NAFLEN`)
+#define NAFLEN TED_NAFLEN
+
+#if defined(M25519_DUAL_CORE)
+// Platform hook for running a job on the second core and for waiting until
+// the job has finished (both are NULL when no hook is registered)
+static void (*ted_core1_run)(TedJob job, void *arg) = NULL;
+static void (*ted_core1_wait)(void) = NULL;
+
+// Arguments of a (partial) scalar multiplication executed on the second core
+typedef struct tedjobarg {
+  Point *r;             // result in extended projective coordinates
+  const Word *s;        // scalar (wNAF) or recoded scalar (comb)
+  const Point *p;       // base point in extended affine coordinates (wNAF)
+  const Word *tbl;      // comb table (comb)
+  int b0, b1;           // range of sub-tables processed (comb)
+  const ECDomPar *d;    // domain parameters
+} TedJobArg;
+#endif
+
+// Number of signed windows of `M25519_TED_WINDOW-1` bits of a 256-bit scalar
+// processed by `ted_mul_varbase`
+#define NUMFIXWIN ((WSIZE*LEN + M25519_TED_WINDOW - 2)/(M25519_TED_WINDOW - 1))
+
+
+///////////////////////////////////////////////////////////////////////////////
+//////////////// UTILITY FUNCTIONS: INITIALIZATION, COPYING, ETC. /////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Initialization of a point with the neutral element: $R = O$
+// -----------------------------------------------------------
+// $O$ is $(0,1)$ in affine coordinates, $[0:1:1]$ in projective coordinates,
+// and $[0:1:1:0:1]$ in extended projective coordinates.
+
+void ted_set0(Point *r)
+{
+  Word *x = r->xyz, *y = &r->xyz[LEN], *z = &r->xyz[2*LEN];
+  Word *e = &r->xyz[3*LEN], *h = &r->xyz[4*LEN];
+
+  mpi_setw(x, 0, LEN);
+  mpi_setw(y, 1, LEN);
+  if (r->dim >= 3) mpi_setw(z, 1, LEN);
+  if (r->dim >= 5) {
+    mpi_setw(e, 0, LEN);
+    mpi_setw(h, 1, LEN);
+  }
+}
+
+
+// Copying of a point: $R = P$
+// ---------------------------
+// The dimensions of `r` and `p` may differ, except that `r->dim` must not be
+// 2. When `r` is in extended projective and `p` in (conventional) projective
+// coordinates, the coordinates of `p` are multiplied by $Z$, i.e., $R = [XZ:
+// YZ:Z^2:X:Y]$, so that $E H = T$ holds.
+
+void ted_copy(Point *r, const Point *p)
+{
+  Word *xr = r->xyz, *yr = &r->xyz[LEN], *zr = &r->xyz[2*LEN];
+  Word *er = &r->xyz[3*LEN], *hr = &r->xyz[4*LEN];
+  const Word *xp = p->xyz, *yp = &p->xyz[LEN], *zp = &p->xyz[2*LEN];
+
+  if (p->dim == 2) {  // affine source
+    mpi_copy(xr, xp, LEN);
+    mpi_copy(yr, yp, LEN);
+    mpi_setw(zr, 1, LEN);
+    if (r->dim >= 5) {
+      mpi_copy(er, xp, LEN);
+      mpi_copy(hr, yp, LEN);
+    }
+  } else if ((p->dim <= 4) && (r->dim >= 5)) {  // projective source
+    mpi_copy(er, xp, LEN);
+    mpi_copy(hr, yp, LEN);
+    gfp_mul(xr, xp, zp);
+    gfp_mul(yr, yp, zp);
+    gfp_sqr(zr, zp);
+  } else {  // same coordinate system or extended -> conventional projective
+    mpi_copy(r->xyz, p->xyz, ((r->dim >= 5) ? 5 : 3)*LEN);
+  }
+}
+
+
+// Loading of a point from the pre-computed table: $R = \pm \mathrm{Tbl}[i]$
+// ---------------------------------------------------------------------------
+// The table `tbl` consists of `TED_COMBSIZE` points in extended affine $(u,v,
+// w)$ coordinates (i.e., $3 \cdot$ LEN words each). The `M25519_COMB_TEETH-1`
+// least-significant bits of `idx` determine the index of the point that is
+// loaded and the next bit determines whether the point gets negated, i.e.,
+// $u$ and $v$ are swapped and $w$ is negated. To resist timing attacks (and
+// simple cache attacks), all points of the table are read and the requested
+// point is selected via AND-masks by `mpi_select` so that the memory-access
+// pattern does not depend on `idx`. Note that `r->dim` must be (at least) 3.
+
+void ted_load_point(Point *r, const Word *tbl, int idx)
+{
+  Word *u = r->xyz, *v = &r->xyz[LEN], *w = &r->xyz[2*LEN];
+  int neg = (idx >> (M25519_COMB_TEETH - 1)) & 1;
+
+  mpi_select(r->xyz, tbl, idx & (TED_COMBSIZE - 1), TED_COMBSIZE, 3*LEN);
+  gfp_cswap(u, v, neg);
+  gfp_cneg(w, w, neg);
+}
+
+
+// Loading of a point in ext. projective coordinates: $R = \pm \mathrm{Tbl}[i]$
+// ----------------------------------------------------------------------------
+// This function combines `ted_load_point` with the conversion to extended
+// projective coordinates of `ted_conv_ea2ep`, i.e., $R = [u-v:u+v:1:u-v:u+v]$
+// for the selected point $(u,v,w)$. Since the negation of the point swaps $u$
+// and $v$, it is merged into the conversion and no `gfp_cneg` is needed (the
+// coordinate $w$ is not used). The selection is performed in the array of
+// `r` itself, i.e., no temporary point is needed. Note that `r->dim` must be
+// (at least) 5.
+
+void ted_load_point_ep(Point *r, const Word *tbl, int idx)
+{
+  Word *u = r->xyz, *v = &r->xyz[LEN], *z = &r->xyz[2*LEN];
+  Word *e = &r->xyz[3*LEN], *h = &r->xyz[4*LEN];
+  int neg = (idx >> (M25519_COMB_TEETH - 1)) & 1;
+
+  mpi_select(r->xyz, tbl, idx & (TED_COMBSIZE - 1), TED_COMBSIZE, 3*LEN);
+  gfp_cswap(u, v, neg);
+  gfp_sub(e, u, v);     // E = u - v
+  gfp_add(h, u, v);     // H = u + v
+  mpi_copy(u, e, LEN);  // X = E
+  mpi_copy(v, h, LEN);  // Y = H
+  mpi_setw(z, 1, LEN);  // Z = 1
+}
+
+
+// Conversion from affine to extended affine coordinates: $R = (u,v,w)$
+// --------------------------------------------------------------------
+// This function computes the extended affine coordinates $(u,v,w) = ((x+y)/2,
+// (y-x)/2, d x y)$ of an affine point $P = (x,y)$. The parameter `d` is needed
+// to access the curve parameter $d$. Note that `r->dim` must be (at least) 3.
+
+void ted_conv_a2ea(Point *r, const Point *p, const ECDomPar *d)
+{
+  Word *u = r->xyz, *v = &r->xyz[LEN], *w = &r->xyz[2*LEN];
+  const Word *x = p->xyz, *y = &p->xyz[LEN];
+
+  gfp_mul(w, x, y);     // w = x*y
+  gfp_mul(w, w, d->dte);  // w = d*x*y
+  gfp_add(u, y, x);     // u = y + x
+  gfp_sub(v, y, x);     // v = y - x
+  gfp_hlv(u, u);        // u = (y + x)/2
+  gfp_hlv(v, v);        // v = (y - x)/2
+}
+
+
+// Conversion from extended affine to extended projective: $R = [X:Y:Z:E:H]$
+// -------------------------------------------------------------------------
+// Since $x = u - v$ and $y = u + v$, the conversion does not require any
+// multiplication, i.e., $R = [u-v:u+v:1:u-v:u+v]$.
+
+void ted_conv_ea2ep(Point *r, const Point *p)
+{
+  Word *x = r->xyz, *y = &r->xyz[LEN], *z = &r->xyz[2*LEN];
+  Word *e = &r->xyz[3*LEN], *h = &r->xyz[4*LEN];
+  const Word *u = p->xyz, *v = &p->xyz[LEN];
+
+  gfp_sub(x, u, v);     // X = u - v
+  gfp_add(y, u, v);     // Y = u + v
+  mpi_setw(z, 1, LEN);  // Z = 1
+  mpi_copy(e, x, LEN);  // E = X
+  mpi_copy(h, y, LEN);  // H = Y
+}
+
+
+#if defined(M25519_DUAL_CORE)
+
+// Registration of the platform hook for the second core
+// -----------------------------------------------------
+// The function `run` has to start the execution of `job(arg)` on the second
+// core and return immediately, while `wait` has to block until this job has
+// finished. Both have to act as memory barriers (as is the case for the
+// inter-core FIFOs, semaphores, or event groups of the common SDKs), so that
+// the result of the job is visible to the calling core after `wait`. At most
+// one job is started at a time. The hook is removed when `run` or `wait` is
+// NULL.
+
+void ted_set_core1(void (*run)(TedJob job, void *arg), void (*wait)(void))
+{
+  if ((run == NULL) || (wait == NULL)) {
+    run = NULL;
+    wait = NULL;
+  }
+  ted_core1_run = run;
+  ted_core1_wait = wait;
+}
+
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+/////////////////////// POINT ADDITION AND POINT DOUBLING /////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Mixed point addition: $R = R + P$
+// ---------------------------------
+// The point $R$ is given in extended projective $[X:Y:Z:E:H]$ and $P$ in
+// extended affine $(u,v,w)$ coordinates. The formulas are those of Hisil et
+// al. for $a = -1$ with $Z_P = 1$, whereby the factors of 2 are absorbed in
+// the coordinates $u, v, w$ of $P$ (i.e., all intermediate values are halved,
+// which yields the same projective point). A mixed addition computes $T = EH$,
+// $A = (Y-X)v$, $B = (Y+X)u$, $C = Tw$, $E' = B-A$, $H' = B+A$, $F = Z-C$,
+// $G = Z+C$, $X' = E'F$, $Y' = GH'$, $Z' = FG$ and costs seven multiplications.
+// The sixth coordinate of `r` is used to store intermediate results.
+
+void ted_add(Point *r, const Point *p)
+{
+  Word *x = r->xyz, *y = &r->xyz[LEN], *z = &r->xyz[2*LEN];
+  Word *e = &r->xyz[3*LEN], *h = &r->xyz[4*LEN], *t = &r->xyz[5*LEN];
+  const Word *u = p->xyz, *v = &p->xyz[LEN], *w = &p->xyz[2*LEN];
+
+  gfp_mul(t, e, h);     // t = T = E*H
+  gfp_sub(e, y, x);     // e = Y - X
+  gfp_add(h, y, x);     // h = Y + X
+  gfp_mul(e, e, v);     // e = A = (Y - X)*v
+  gfp_mul(h, h, u);     // h = B = (Y + X)*u
+  gfp_mul(t, t, w);     // t = C = T*w
+  gfp_sub(x, h, e);     // x = E' = B - A
+  gfp_add(h, h, e);     // h = H' = B + A
+  mpi_copy(e, x, LEN);  // e = E'
+  gfp_add(y, z, t);     // y = G = Z + C
+  gfp_sub(t, z, t);     // t = F = Z - C
+  gfp_mul(z, t, y);     // Z' = F*G
+  gfp_mul(x, x, t);     // X' = E'*F
+  gfp_mul(y, y, h);     // Y' = G*H'
+}
+
+
+// Extended projective point addition: $R = R + P$
+// -----------------------------------------------
+// Both $R$ and $P$ are given in extended projective $[X:Y:Z:E:H]$ coordinates
+// and `p->dim` must be (at least) 5. The formulas are the same as for the
+// mixed addition, but with $A = (Y_R-X_R)(Y_P-X_P)$, $B = (Y_R+X_R)(Y_P+X_P)$,
+// $C = 2d T_R T_P$ and $D = 2 Z_R Z_P$ in place of $Z$, which costs ten
+// multiplications. The parameter `d` is needed to access the curve parameter
+// $d$. The sixth coordinate of `r` is used to store intermediate results.
+
+void ted_add_ep(Point *r, const Point *p, const ECDomPar *d)
+{
+  Word tmp[2*LEN];  // temporary space for two gfp elements
+  Word *t0 = tmp, *t1 = &tmp[LEN];
+  Word *x = r->xyz, *y = &r->xyz[LEN], *z = &r->xyz[2*LEN];
+  Word *e = &r->xyz[3*LEN], *h = &r->xyz[4*LEN], *t = &r->xyz[5*LEN];
+  const Word *xp = p->xyz, *yp = &p->xyz[LEN], *zp = &p->xyz[2*LEN];
+  const Word *ep = &p->xyz[3*LEN], *hp = &p->xyz[4*LEN];
+
+  gfp_mul(t, e, h);     // t = T_R = E_R*H_R
+  gfp_mul(t0, ep, hp);  // t0 = T_P = E_P*H_P
+  gfp_mul(t, t, t0);    // t = T_R*T_P
+  gfp_mul(t, t, d->dte);  // t = d*T_R*T_P
+  gfp_add(t, t, t);     // t = C = 2*d*T_R*T_P
+  gfp_sub(t0, yp, xp);  // t0 = Y_P - X_P
+  gfp_sub(t1, y, x);    // t1 = Y_R - X_R
+  gfp_mul(e, t1, t0);   // e = A = (Y_R - X_R)*(Y_P - X_P)
+  gfp_add(t0, yp, xp);  // t0 = Y_P + X_P
+  gfp_add(t1, y, x);    // t1 = Y_R + X_R
+  gfp_mul(h, t1, t0);   // h = B = (Y_R + X_R)*(Y_P + X_P)
+  gfp_mul(z, z, zp);    // z = Z_R*Z_P
+  gfp_add(z, z, z);     // z = D = 2*Z_R*Z_P
+  gfp_sub(x, h, e);     // x = E' = B - A
+  gfp_add(h, h, e);     // h = H' = B + A
+  mpi_copy(e, x, LEN);  // e = E'
+  gfp_add(y, z, t);     // y = G = D + C
+  gfp_sub(t, z, t);     // t = F = D - C
+  gfp_mul(z, t, y);     // Z' = F*G
+  gfp_mul(x, x, t);     // X' = E'*F
+  gfp_mul(y, y, h);     // Y' = G*H'
+}
+
+
+// Extended projective point doubling: $R = 2R$
+// --------------------------------------------
+// The doubling formulas of Hisil et al. for $a = -1$ compute $A = X^2$, $B =
+// Y^2$, $C = 2Z^2$, $E' = (X+Y)^2 - A - B$, $G = B - A$, $F = G - C$ and $H' =
+// -A - B$. To save two negations, the signs of $F$ and $H'$ are flipped (i.e.,
+// $F = C - G$ and $H' = A + B$), which scales $X'$, $Y'$, $Z'$ and $T' = E'H'$
+// all by $-1$ and, thus, yields the same projective point. A doubling costs
+// four squarings and three multiplications. The sixth coordinate of `r` is
+// used to store intermediate results.
+
+void ted_double(Point *r)
+{
+  Word *x = r->xyz, *y = &r->xyz[LEN], *z = &r->xyz[2*LEN];
+  Word *e = &r->xyz[3*LEN], *h = &r->xyz[4*LEN], *t = &r->xyz[5*LEN];
+
+  gfp_add(t, x, y);     // t = X + Y
+  gfp_sqr(t, t);        // t = (X + Y)^2
+  gfp_sqr(x, x);        // x = A = X^2
+  gfp_sqr(y, y);        // y = B = Y^2
+  gfp_sqr(z, z);        // z = Z^2
+  gfp_add(z, z, z);     // z = C = 2*Z^2
+  gfp_add(h, x, y);     // h = H' = A + B
+  gfp_sub(e, t, h);     // e = E' = (X + Y)^2 - A - B
+  gfp_sub(y, y, x);     // y = G = B - A
+  gfp_sub(t, z, y);     // t = F = C - G
+  gfp_mul(x, e, t);     // X' = E'*F
+  gfp_mul(z, t, y);     // Z' = F*G
+  gfp_mul(y, y, h);     // Y' = G*H'
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+////////////////////// (MULTI-)SCALAR MULTIPLICATION //////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Recoding of a scalar for the comb method
+// ----------------------------------------
+// The scalar $l$ is reduced modulo $\ell$ (via conditional subtractions of $8
+// \ell$, $4 \ell$, $2 \ell$ and $\ell$) and made odd by adding $\ell$ when
+// it is even, which yields $l' < 2^{254}$ with $l' G = l G$. The odd scalar
+// $l'$ is recoded as $m = (l' + 2^n - 1)/2$ with $n$ = `COMBBITS` so that $l'
+// = \sum_i (2 m_i - 1) 2^i$, i.e., each bit $m_i$ represents a digit $\pm 1$.
+// The array `m` must have a length of LEN+1 words.
+
+static void ted_comb_recode(Word *m, const Word *l, const ECDomPar *d)
+{
+  Word ell[LEN];
+  int i, bit;
+
+  mpi_copy(ell, d->car, LEN);
+  mpi_copy(m, l, LEN);
+  for (i = 0; i < 4; i++) {
+    if (i > 0) mpi_shr(ell, ell, LEN);
+    bit = mpi_sub(m, m, ell, LEN);
+    mpi_cadd(m, m, ell, bit, LEN);
+  }
+  // l' = l + ell if l is even, then m = (l' - 1)/2 + 2^(n-1)
+  mpi_cadd(m, m, ell, (int) (1 - (m[0] & 1)), LEN);
+  mpi_shr(m, m, LEN);
+  m[LEN] = 0;
+  m[(COMBBITS-1)/WSIZE] |= ((Word) 1) << ((COMBBITS - 1) % WSIZE);
+}
+
+
+// Index of the table-entry for column `j` of table `b` of a recoded scalar
+// ------------------------------------------------------------------------
+// The first digit of the column determines the sign (i.e., the bit at
+// position `M25519_COMB_TEETH-1` of the index is set when the first digit is
+// $-1$) and the other digits, XORed with the first, the index of the point.
+
+static int ted_comb_index(const Word *m, int j, int b)
+{
+  int i, pos, lead, bit, idx;
+
+  pos = j + b*M25519_COMB_TEETH*TED_COMBSPACE;
+  lead = (int) ((m[pos/WSIZE] >> (pos % WSIZE)) & 1);
+  idx = (1 - lead) << (M25519_COMB_TEETH - 1);
+  for (i = 1; i < M25519_COMB_TEETH; i++) {
+    pos += TED_COMBSPACE;
+    bit = (int) ((m[pos/WSIZE] >> (pos % WSIZE)) & 1);
+    idx |= (1 ^ lead ^ bit) << (i - 1);
+  }
+
+  return idx;
+}
+
+
+// Column `j` of the comb method with the sub-tables `b0` to `b1-1`
+// ------------------------------------------------------------------
+// This function processes one column of the recoded scalar `m`, i.e., it
+// doubles $R$ and adds the points of the sub-tables in the range [`b0`, `b1`)
+// of the table `tbl`. For the very first column (`j` = `TED_COMBSPACE-1`),
+// the doubling is omitted and the point of sub-table `b0` is loaded directly
+// in extended projective coordinates. `r->dim` must be 6.
+
+static void ted_comb_column(Point *r, const Word *m, const Word *tbl, int j, \
+  int b0, int b1)
+{
+  Word tmp[3*LEN];
+  Point tp = { 3, tmp };
+  int b = b0, idx;
+
+  if (j == TED_COMBSPACE - 1) {
+    idx = ted_comb_index(m, j, b0);
+    ted_load_point_ep(r, &tbl[b0*TED_COMBSIZE*3*LEN], idx);
+    b++;
+  } else {
+    ted_double(r);
+  }
+  for (; b < b1; b++) {
+    idx = ted_comb_index(m, j, b);
+    ted_load_point(&tp, &tbl[b*TED_COMBSIZE*3*LEN], idx);
+    ted_add(r, &tp);
+  }
+}
+
+
+// Comb method with the sub-tables `b0` to `b1-1` of a recoded scalar
+// ------------------------------------------------------------------
+// This function executes the main loop of the comb method (i.e., all columns
+// from `TED_COMBSPACE-1` down to 0) for the sub-tables in the range [`b0`,
+// `b1`) of the table `tbl` and the recoded scalar `m`. `r->dim` must be 6.
+
+static void ted_comb_part(Point *r, const Word *m, const Word *tbl, int b0, \
+  int b1)
+{
+  int j;
+
+  for (j = TED_COMBSPACE - 1; j >= 0; j--) {
+    ted_comb_column(r, m, tbl, j, b0, b1);
+  }
+}
+
+
+#if defined(M25519_DUAL_CORE)
+
+// Job for the second core that executes `ted_comb_part`
+static void ted_comb_job(void *arg)
+{
+  TedJobArg *a = (TedJobArg *) arg;
+
+  ted_comb_part(a->r, a->s, a->tbl, a->b0, a->b1);
+}
+
+#endif
+
+
+// Fixed-base comb method: $R = l G$
+// ---------------------------------
+// This function implements a signed-digit comb method with `M25519_COMB_TEETH`
+// teeth and `M25519_COMB_TABLES` tables, which is configured in `config.h`.
+// The scalar $l$ is first recoded by `ted_comb_recode` into $n$ = `COMBBITS`
+// digits $\pm 1$, which are split into `M25519_COMB_TEETH*M25519_COMB_TABLES`
+// rows of `TED_COMBSPACE` digits. Every column of `M25519_COMB_TEETH` rows
+// belongs to one table, which contains the `TED_COMBSIZE` points $2^{e t b} (G
+// + \sum_i \pm 2^{e i} G)$ (where $e$ is the spacing, $t$ the number of teeth,
+// and $b$ the table). Each iteration of the main loop performs one doubling
+// and `M25519_COMB_TABLES` mixed additions of points obtained via
+// `ted_load_point`, except that the very first point is loaded directly in
+// extended projective coordinates by `ted_load_point_ep` (i.e., the addition
+// to $O$ is omitted). All operations, including the loading of points, have an
+// operand-independent execution profile. The result $R$ is given in extended
+// projective coordinates, i.e., `r->dim` must be 6. The parameter `d` is
+// needed to access the group order and the table. When `M25519_DUAL_CORE` is
+// defined, a hook for the second core is registered, and there are at least
+// two tables, the upper half of the tables is processed on the second core
+// (with its own doublings) and the two partial results are added at the end.
+// The recoded scalar is wiped before the function returns.
+
+void ted_mul_combNb(Point *r, const Word *l, const ECDomPar *d)
+{
+  Word m[LEN+1];
+#if (defined(M25519_DUAL_CORE) && (M25519_COMB_TABLES > 1))
+  Word tmp[6*LEN];
+  Point tp = { 6, tmp };
+  TedJobArg arg;
+#endif
+
+  ted_comb_recode(m, l, d);
+#if (defined(M25519_DUAL_CORE) && (M25519_COMB_TABLES > 1))
+  if (ted_core1_run != NULL) {
+    arg.r = &tp;
+    arg.s = m;
+    arg.p = NULL;
+    arg.tbl = d->tbl;
+    arg.b0 = M25519_COMB_TABLES/2;
+    arg.b1 = M25519_COMB_TABLES;
+    arg.d = d;
+    ted_core1_run(ted_comb_job, &arg);
+    ted_comb_part(r, m, d->tbl, 0, M25519_COMB_TABLES/2);
+    ted_core1_wait();
+    ted_add_ep(r, &tp, d);
+  } else
+#endif
+  ted_comb_part(r, m, d->tbl, 0, M25519_COMB_TABLES);
+  mpi_setw(m, 0, LEN+1);  // the recoded scalar is as secret as $l$
+}
+
+
+// Pre-computation of a comb table for an arbitrary point $P$
+// ----------------------------------------------------------
+// This function computes a table of the same format as `ECDomPar.tbl` (i.e.,
+// `M25519_COMB_TABLES` sub-tables of `TED_COMBSIZE` points in extended affine
+// coordinates) for the affine point $P$ instead of $G$, so that the array
+// `tbl` must be able to accommodate `TED_COMBWORDS` words. The multiples
+// $2^{e i} P$ for the teeth of one sub-table are obtained by repeated doubling
+// and converted to extended affine coordinates, then each entry is computed
+// with `M25519_COMB_TEETH-1` mixed additions and converted as well. The
+// parameter `d` is needed to access the curve parameter $d$.
+// NOTE: The execution time of this function is not constant. It is intended
+// for public points (e.g., the public key of a signer).
+
+void ted_comb_table(Word *tbl, const Point *p, const ECDomPar *d)
+{
+  Word q[M25519_COMB_TEETH*3*LEN], cur[6*LEN], sum[6*LEN], neg[3*LEN];
+  Word aff[2*LEN];
+  Point curp = { 6, cur }, sump = { 6, sum }, qp = { 3, NULL };
+  Point negp = { 3, neg }, affp = { 2, aff };
+  int b, i, j, x;
+
+  ted_copy(&curp, p);
+  for (b = 0; b < M25519_COMB_TABLES; b++) {
+    // multiples 2^(e*(t*b+i))*P for the teeth of table b
+    for (i = 0; i < M25519_COMB_TEETH; i++) {
+      ted_conv_p2a(&affp, &curp, d);
+      qp.xyz = &q[i*3*LEN];
+      ted_conv_a2ea(&qp, &affp, d);
+      if ((b < M25519_COMB_TABLES - 1) || (i < M25519_COMB_TEETH - 1))
+        for (j = 0; j < TED_COMBSPACE; j++) ted_double(&curp);
+    }
+    // entries P_0 +/- P_1 +/- ... +/- P_(t-1) of table b
+    for (x = 0; x < TED_COMBSIZE; x++) {
+      qp.xyz = q;
+      ted_conv_ea2ep(&sump, &qp);
+      for (i = 1; i < M25519_COMB_TEETH; i++) {
+        if ((x >> (i - 1)) & 1) {
+          qp.xyz = &q[i*3*LEN];
+          ted_add(&sump, &qp);
+        } else {  // -P = (v,u,-w)
+          mpi_copy(neg, &q[i*3*LEN+LEN], LEN);
+          mpi_copy(&neg[LEN], &q[i*3*LEN], LEN);
+          gfp_cneg(&neg[2*LEN], &q[i*3*LEN+2*LEN], 1);
+          ted_add(&sump, &negp);
+        }
+      }
+      ted_conv_p2a(&affp, &sump, d);
+      qp.xyz = &tbl[(b*TED_COMBSIZE+x)*3*LEN];
+      ted_conv_a2ea(&qp, &affp, d);
+    }
+  }
+}
+
+
+// Double-base comb method with two tables: $R = l G + k P$
+// ---------------------------------------------------------
+// Both scalars are recoded by `ted_comb_recode` and processed with the same
+// sequence of doublings, i.e., each iteration of the main loop performs one
+// doubling and $2 \cdot$ `M25519_COMB_TABLES` mixed additions. The comb table
+// of $P$ must have been computed with `ted_comb_table`, and the one of $G$ is
+// accessed via `d`. Since $k$ is reduced modulo $\ell$ and possibly increased
+// by $\ell$, the result differs from $l G + k P$ by a point of order 1, 2, 4,
+// or 8 when $P$ is not in the subgroup of order $\ell$; this does not matter
+// for the "cofactored" verification of signatures. The result $R$ is given in
+// extended projective coordinates, i.e., `r->dim` must be 6.
+// When a hook for the second core is registered (see `M25519_DUAL_CORE`),
+// $k P$ is computed with `ted_comb_part` on the second core and $l G$ with
+// `ted_comb_part` on the calling core, i.e., each core executes its own
+// doublings, and the two products are added at the end.
+// NOTE: The points are taken directly from the tables (i.e., without reading
+// all entries), so the execution time of this function depends on the
+// scalars. It must only be used when both scalars are public.
+
+void ted_mul_dblbase_tbl(Point *r, const Word *l, const Word *k, \
+  const Word *tbl, const ECDomPar *d)
+{
+  Word ml[LEN+1], mk[LEN+1], neg[3*LEN];
+  const Word *tab[2], *ent;
+  const Word *m[2];
+  Point tp = { 3, NULL };
+  int i, j, b, idx;
+#if defined(M25519_DUAL_CORE)
+  Word tmp[6*LEN];
+  Point kp = { 6, tmp };
+  TedJobArg arg;
+#endif
+
+  ted_comb_recode(ml, l, d);
+  ted_comb_recode(mk, k, d);
+#if defined(M25519_DUAL_CORE)
+  if (ted_core1_run != NULL) {
+    arg.r = &kp;
+    arg.s = mk;
+    arg.p = NULL;
+    arg.tbl = tbl;
+    arg.b0 = 0;
+    arg.b1 = M25519_COMB_TABLES;
+    arg.d = d;
+    ted_core1_run(ted_comb_job, &arg);
+    ted_comb_part(r, ml, d->tbl, 0, M25519_COMB_TABLES);
+    ted_core1_wait();
+    ted_add_ep(r, &kp, d);
+    return;
+  }
+#endif
+  m[0] = ml; m[1] = mk;
+  tab[0] = d->tbl; tab[1] = tbl;
+
+  ted_set0(r);
+  for (j = TED_COMBSPACE - 1; j >= 0; j--) {
+    if (j < TED_COMBSPACE - 1) ted_double(r);
+    for (b = 0; b < M25519_COMB_TABLES; b++) {
+      for (i = 0; i < 2; i++) {
+        idx = ted_comb_index(m[i], j, b);
+        ent = &tab[i][(b*TED_COMBSIZE+(idx&(TED_COMBSIZE-1)))*3*LEN];
+        if (idx & TED_COMBSIZE) {  // -P = (v,u,-w)
+          mpi_copy(neg, &ent[LEN], LEN);
+          mpi_copy(&neg[LEN], ent, LEN);
+          gfp_cneg(&neg[2*LEN], &ent[2*LEN], 1);
+          ent = neg;
+        }
+        tp.xyz = (Word *) ent;
+        ted_add(r, &tp);
+      }
+    }
+  }
+}
+
+
+// Conversion from projective to affine coordinates: $R = (x,y)$
+// -------------------------------------------------------------
+// The inverse of $Z$ is computed by `gfp_inv` when `M25519_SAFEGCD_INV` is
+// defined (since this inversion has constant execution time) and otherwise as
+// $Z^{p-2} = (Z^{(p-5)/8})^8 Z^3$ with `gfp_exp_p58`, which also has constant
+// execution time and does not require a random field-element for masking. The
+// coordinates $x = X/Z$ and $y = Y/Z$ are fully reduced. The parameter `d` is
+// not used by this implementation. The return value is `M25519_ERR_TPOINT`
+// if $Z = 0$ and `M25519_NO_ERROR` otherwise.
+
+int ted_conv_p2a(Point *r, const Point *p, const ECDomPar *d)
+{
+  Word zi[LEN], t[LEN];
+  Word *x = r->xyz, *y = &r->xyz[LEN];
+  const Word *zp = &p->xyz[2*LEN];
+  int err;
+
+  (void) d;
+  mpi_setw(t, 0, LEN);
+  err = (gfp_cmp(zp, t) == 0) ? M25519_ERR_TPOINT : M25519_NO_ERROR;
+#if defined(M25519_SAFEGCD_INV)
+  gfp_inv(zi, zp);
+#else
+  gfp_exp_p58(zi, zp);  // zi = Z^((p-5)/8)
+  gfp_sqrn(zi, zi, 3);  // zi = Z^(p-5)
+  gfp_sqr(t, zp);       // t = Z^2
+  gfp_mul(t, t, zp);    // t = Z^3
+  gfp_mul(zi, zi, t);   // zi = Z^(p-2) = 1/Z
+#endif
+  gfp_mul(x, p->xyz, zi);
+  gfp_mul(y, &p->xyz[LEN], zi);
+  gfp_fred(x, x);
+  gfp_fred(y, y);
+
+  return err;
+}
+
+
+// Batch conversion from projective to affine coordinates: $R_i = (x_i,y_i)$
+// -------------------------------------------------------------------------
+// The `n` points $P_i$ must be given in projective coordinates (`p[i].dim` at
+// least 3), and the results $R_i$ need a dimension of at least 2. All $Z_i$
+// are inverted together by `gfp_inv_batch`, i.e., with a single inversion
+// that has constant execution time (like that of `ted_conv_p2a`) and $3(n-1)$
+// multiplications instead of $n$ inversions. The coordinates $x_i = X_i/Z_i$
+// and $y_i = Y_i/Z_i$ are fully reduced. The array `scratch` must be able to
+// accommodate `2*n*LEN` words, and `r` may be the same as `p`. The parameter
+// `d` is not used by this implementation. The return value is
+// `M25519_ERR_TPOINT` if $Z_i = 0$ for at least one point (whose coordinates
+// are then 0) and `M25519_NO_ERROR` otherwise.
+
+int ted_conv_p2a_batch(Point *r, const Point *p, int n, Word *scratch, \
+  const ECDomPar *d)
+{
+  Word *zi = scratch;
+  int i, err;
+
+  (void) d;
+  if (n <= 0) return M25519_NO_ERROR;
+
+  for (i = 0; i < n; i++) mpi_copy(&zi[i*LEN], &p[i].xyz[2*LEN], LEN);
+  err = gfp_inv_batch(zi, zi, n, &scratch[n*LEN]);
+  for (i = 0; i < n; i++) {
+    gfp_mul(r[i].xyz, p[i].xyz, &zi[i*LEN]);
+    gfp_mul(&r[i].xyz[LEN], &p[i].xyz[LEN], &zi[i*LEN]);
+    gfp_fred(r[i].xyz, r[i].xyz);
+    gfp_fred(&r[i].xyz[LEN], &r[i].xyz[LEN]);
+  }
+
+  return (err == M25519_NO_ERROR) ? M25519_NO_ERROR : M25519_ERR_TPOINT;
+}
+
+
+// Fixed-base scalar multiplication: $R = l G$
+// -------------------------------------------
+// The scalar $l$ (eight words) must not be 0. The result $R$ is given in
+// affine coordinates and is checked not to be the neutral element $O$. The
+// return value is `M25519_ERR_SCALAR` if $l = 0$, `M25519_ERR_TPOINT` if $R =
+// O$ (i.e., $l$ is a multiple of $\ell$), and `M25519_NO_ERROR` otherwise.
+
+int ted_mul_fixbase(Point *r, const Word *l, const ECDomPar *d)
+{
+  Word tmp[6*LEN];
+  Point tp = { 6, tmp };
+  int err;
+
+  if (mpi_cmpw(l, 0, LEN) == 0) return M25519_ERR_SCALAR;
+  ted_mul_combNb(&tp, l, d);
+  err = ted_conv_p2a(r, &tp, d);
+  if ((mpi_cmpw(r->xyz, 0, LEN) == 0) && (mpi_cmpw(&r->xyz[LEN], 1, LEN) == 0))
+    err = M25519_ERR_TPOINT;
+
+  return err;
+}
+
+
+// Check whether a projective point $P$ is the neutral element $O$
+// ---------------------------------------------------------------
+// $P = (X:Y:Z)$ is $O$ if and only if $X = 0$ and $Y = Z$ (which implies $Z
+// \neq 0$ for valid points). The comparisons have constant execution time.
+
+static int ted_is_neutral(const Point *p)
+{
+  Word zero[LEN];
+  int neutral;
+
+  mpi_setw(zero, 0, LEN);
+  neutral = (gfp_cmp(p->xyz, zero) == 0);
+  neutral &= (gfp_cmp(&p->xyz[LEN], &p->xyz[2*LEN]) == 0);
+
+  return neutral;
+}
+
+
+// Fixed-base scalar multiplication with projective result: $R = l G$
+// ------------------------------------------------------------------
+// This function computes the same point as `ted_mul_fixbase`, but $R$ is left
+// in extended projective coordinates $[X:Y:Z:E:H]$ (i.e., `r->dim` must be 6)
+// so that the inversion of `ted_conv_p2a` can be omitted when $R$ is used in
+// further point operations, or shared by several points when they are
+// compressed with `ted_compress_batch`. The return value is the same as that
+// of `ted_mul_fixbase`; when $l = 0$, $R$ is not written.
+
+int ted_mul_fixbase_proj(Point *r, const Word *l, const ECDomPar *d)
+{
+  if (mpi_cmpw(l, 0, LEN) == 0) return M25519_ERR_SCALAR;
+  ted_mul_combNb(r, l, d);
+
+  return ted_is_neutral(r) ? M25519_ERR_TPOINT : M25519_NO_ERROR;
+}
+
+
+// Resumable fixed-base scalar multiplication: $R = l G$
+// -----------------------------------------------------
+// These three functions compute the same result as `ted_mul_fixbase`, but
+// the comb method is split into `TED_COMBSPACE` steps (one column of the comb,
+// i.e., one doubling and `M25519_COMB_TABLES` mixed additions) so that a
+// caller can interleave the scalar multiplication with other tasks. The init
+// function checks and recodes the scalar $l$, and every step function
+// processes up to `n` columns and returns the number of columns that are
+// still to be processed (0 when the comb method is complete). Each column has
+// an operand-independent execution profile, and the number of processed
+// columns only depends on `n`. The final function converts the result to
+// affine coordinates (which costs about as much as 20 columns in the default
+// configuration), checks it, and wipes the context. The return value of the
+// init and the final function is the same as that of `ted_mul_fixbase`,
+// except that the final function
+// returns `M25519_ERR_STREAM` when the comb method is not complete yet (or the
+// context has already been finalized).
+
+int ted_mul_fixbase_init(TedFixCtx *ctx, const Word *l, const ECDomPar *d)
+{
+  ctx->err = M25519_NO_ERROR;
+  ctx->pos = TED_COMBSPACE - 1;
+  ted_comb_recode(ctx->m, l, d);
+  if (mpi_cmpw(l, 0, LEN) == 0) {
+    ctx->err = M25519_ERR_SCALAR;
+    ctx->pos = -1;
+  }
+
+  return ctx->err;
+}
+
+
+int ted_mul_fixbase_step(TedFixCtx *ctx, int n, const ECDomPar *d)
+{
+  Point rp = { 6, ctx->xyz };
+
+  for (; (n > 0) && (ctx->pos >= 0); n--, ctx->pos--) {
+    ted_comb_column(&rp, ctx->m, d->tbl, ctx->pos, 0, M25519_COMB_TABLES);
+  }
+
+  return ctx->pos + 1;
+}
+
+
+int ted_mul_fixbase_final(Point *r, TedFixCtx *ctx, const ECDomPar *d)
+{
+  Point tp = { 6, ctx->xyz };
+  int err = ctx->err;
+
+  if ((err == M25519_NO_ERROR) && (ctx->pos >= 0)) err = M25519_ERR_STREAM;
+  if (err == M25519_NO_ERROR) {
+    err = ted_conv_p2a(r, &tp, d);
+    if ((mpi_cmpw(r->xyz, 0, LEN) == 0) && \
+        (mpi_cmpw(&r->xyz[LEN], 1, LEN) == 0)) err = M25519_ERR_TPOINT;
+  }
+  mpi_setw(ctx->xyz, 0, 6*LEN);
+  mpi_setw(ctx->m, 0, LEN+1);
+  ctx->pos = -1;
+  ctx->err = M25519_ERR_STREAM;
+
+  return err;
+}
+
+
+// Extraction of `c` bits of a 256-bit scalar, starting at position `pos`
+// ----------------------------------------------------------------------
+// Bits at a position of 256 or higher are 0.
+
+static int ted_getbits(const Word *k, int pos, int c)
+{
+  Word bits;
+  int i = pos/WSIZE, j = pos % WSIZE;
+
+  if (i >= LEN) return 0;
+  bits = k[i] >> j;
+  if ((j + c > WSIZE) && (i + 1 < LEN)) bits |= k[i+1] << (WSIZE - j);
+
+  return (int) (bits & ((((Word) 1) << c) - 1));
+}
+
+
+// Multi-scalar multiplication: $R = \sum_i k_i P_i$
+// --------------------------------------------------
+// This function implements the bucket method of Pippenger with signed digits.
+// Each 256-bit scalar $k_i$ is recoded into windows of `c` bits with digits
+// in the range $[-2^{c-1}, 2^{c-1}-1]$, whereby only the carry-bits of the
+// recoding are stored (the digits are re-computed from the scalar and the
+// carries). Starting with the most-significant window, the points $\pm P_i$
+// are added (mixed additions) to the bucket $|d_i|-1$ selected by their digit
+// $d_i$, and the weighted sum $\sum_j (j+1) B_j$ of the buckets is computed
+// with two running sums and added to $R$, which is doubled `c` times before
+// each window. The window-width `c` is chosen depending on the number of
+// points `n` (at most `TED_MAXMULTI`) so that roughly $256/c \cdot (n +
+// 2^c)$ point additions are needed instead of $256 \cdot n/2$ for `n`
+// separate double-and-add scalar multiplications. The points $P_i$ must be
+// given in extended affine $(u,v,w)$ coordinates, and the result $R$ is in
+// extended projective coordinates, i.e., `r->dim` must be 6. The parameter
+// `d` is needed to access the curve parameter $d$.
+// NOTE: The execution time of this function depends on the scalars (and the
+// points may be neutral elements), i.e., it must not be used with secret
+// scalars. Its main application is the verification of signatures.
+
+void ted_mul_multi(Point *r, const Word *k, const Point *p, int n, \
+  const ECDomPar *d)
+{
+  Word bkt[(1 << (MAXWIN - 1))*6*LEN], run[6*LEN], sum[6*LEN], neg[3*LEN];
+  Word cbits[TED_MAXMULTI*CBITWORDS];
+  Point bp = { 6, NULL }, runp = { 6, run }, sump = { 6, sum };
+  Point negp = { 3, neg };
+  int used[1 << (MAXWIN - 1)];
+  int c, numwin, half, i, j, w, dig, carry, rset = 0, bset, sset;
+
+  c = (n < 8) ? 2 : ((n < 24) ? 3 : ((n < 96) ? 4 : 5));
+  numwin = (WSIZE*LEN + c - 1)/c + 1;
+  half = 1 << (c - 1);
+
+  // signed recoding of the scalars: only the carry-bits are stored
+  for (i = 0; i < n; i++) {
+    mpi_setw(&cbits[i*CBITWORDS], 0, CBITWORDS);
+    carry = 0;
+    for (w = 0; w < numwin - 1; w++) {
+      carry = ((ted_getbits(&k[i*LEN], w*c, c) + carry) >= half);
+      cbits[i*CBITWORDS+(w+1)/WSIZE] |= ((Word) carry) << ((w + 1) % WSIZE);
+    }
+  }
+
+  ted_set0(r);
+  for (w = numwin - 1; w >= 0; w--) {
+    if (rset) for (j = 0; j < c; j++) ted_double(r);
+    // accumulation of the points in the buckets
+    for (j = 0; j < half; j++) used[j] = 0;
+    for (i = 0; i < n; i++) {
+      dig = ted_getbits(&k[i*LEN], w*c, c);
+      dig += (cbits[i*CBITWORDS+w/WSIZE] >> (w % WSIZE)) & 1;
+      dig -= ((cbits[i*CBITWORDS+(w+1)/WSIZE] >> ((w + 1) % WSIZE)) & 1) << c;
+      if (dig == 0) continue;
+      if (dig > 0) {
+        negp.xyz = p[i].xyz;
+      } else {  // -P = (v,u,-w)
+        mpi_copy(neg, &p[i].xyz[LEN], LEN);
+        mpi_copy(&neg[LEN], p[i].xyz, LEN);
+        gfp_cneg(&neg[2*LEN], &p[i].xyz[2*LEN], 1);
+        negp.xyz = neg;
+        dig = -dig;
+      }
+      bp.xyz = &bkt[(dig-1)*6*LEN];
+      if (used[dig-1]) ted_add(&bp, &negp);
+      else ted_conv_ea2ep(&bp, &negp);
+      used[dig-1] = 1;
+    }
+    // weighted sum of the buckets: sum = 1*B_0 + 2*B_1 + ... + half*B_half-1
+    bset = sset = 0;
+    for (j = half - 1; j >= 0; j--) {
+      bp.xyz = &bkt[j*6*LEN];
+      if (used[j]) {
+        if (bset) ted_add_ep(&runp, &bp, d);
+        else ted_copy(&runp, &bp);
+        bset = 1;
+      }
+      if (bset) {
+        if (sset) ted_add_ep(&sump, &runp, d);
+        else ted_copy(&sump, &runp);
+        sset = 1;
+      }
+    }
+    if (sset) {
+      if (rset) ted_add_ep(r, &sump, d);
+      else ted_copy(r, &sump);
+      rset = 1;
+    }
+  }
+}
+
+
+// Pre-computation of the odd multiples $P, 3P, \ldots, (2^{W-1}-1)P$
+// ------------------------------------------------------------------
+// The point $P$ is given in extended projective coordinates (`p->dim` must be
+// at least 5), and the `TED_WINSIZE` multiples are written to `tbl` in the
+// same coordinates (i.e., $5 \cdot$ LEN words each). One doubling and
+// `TED_WINSIZE-1` extended projective additions are executed, independent of
+// the point $P$.
+
+static void ted_odd_table(Word *tbl, const Point *p, const ECDomPar *d)
+{
+  Word dbl[6*LEN], sum[6*LEN];
+  Point dblp = { 6, dbl }, sump = { 6, sum }, tp = { 5, tbl };
+  int i;
+
+  ted_copy(&tp, p);
+  ted_copy(&dblp, p);
+  ted_double(&dblp);
+  for (i = 1; i < TED_WINSIZE; i++) {
+    ted_copy(&sump, &tp);
+    ted_add_ep(&sump, &dblp, d);
+    tp.xyz = &tbl[i*5*LEN];
+    ted_copy(&tp, &sump);
+  }
+}
+
+
+// Loading of an odd multiple from the table: $R = \pm \mathrm{Tbl}[i]$
+// ---------------------------------------------------------------------
+// Like `ted_load_point`, this function reads all `TED_WINSIZE` points of the
+// table and selects the requested one via AND-masks (with `mpi_select`), so
+// that neither the memory-access pattern nor the execution time depend on
+// `idx` or `neg`. The point is negated (i.e., $-[X:Y:Z:E:H] = [-X:Y:Z:-E:H]$)
+// when `neg` is 1. Note that `r->dim` must be (at least) 5.
+
+static void ted_load_odd(Point *r, const Word *tbl, int idx, int neg)
+{
+  Word *x = r->xyz, *e = &r->xyz[3*LEN];
+
+  mpi_select(r->xyz, tbl, idx, TED_WINSIZE, 5*LEN);
+  gfp_cneg(x, x, neg);
+  gfp_cneg(e, e, neg);
+}
+
+
+// Variable-base scalar multiplication with signed fixed windows: $R = k P$
+// -------------------------------------------------------------------------
+// An odd scalar $k$ can be written as $k = \sum_i d_i 2^{(W-1)i}$ with odd
+// digits $d_i \in [-(2^{W-1}-1), 2^{W-1}-1]$ (where $W$ is the window-width
+// `M25519_TED_WINDOW`), and digit $d_i$ is obtained from $W$ bits of $k$ at
+// position $(W-1)i$ with the least-significant bit set to 1 (i.e., no carries
+// have to be propagated).
+// Since all digits are non-zero, every window costs exactly $W-1$ doublings
+// and one addition of a point loaded with `ted_load_odd`. An even scalar is
+// made odd by setting bit 0 and the result is corrected by adding either $-P$
+// or $O$, which are selected via masks. Thus, the sequence of operations and
+// the memory accesses do not depend on $k$. The point $P$ has to be given in
+// extended projective coordinates, and the result $R$ is in extended
+// projective coordinates, i.e., `r->dim` must be 6.
+
+static void ted_mul_fixwin(Point *r, const Word *k, const Point *p, \
+  const ECDomPar *d)
+{
+  Word tbl[TED_WINSIZE*5*LEN], kodd[LEN], tmp[5*LEN], zero[5*LEN];
+  Point tp = { 5, tmp }, zp = { 5, zero };
+  Word mask;
+  int i, j, bits, neg, even = (int) (1 - (k[0] & 1));
+  const int low = (1 << (M25519_TED_WINDOW - 1)) - 1;
+
+  ted_odd_table(tbl, p, d);
+  mpi_copy(kodd, k, LEN);
+  kodd[0] |= 1;
+
+  // the most-significant digit is always positive
+  bits = ted_getbits(kodd, (NUMFIXWIN - 1)*(M25519_TED_WINDOW - 1), \
+    M25519_TED_WINDOW) | 1;
+  ted_load_odd(&tp, tbl, bits >> 1, 0);
+  ted_copy(r, &tp);
+  for (i = NUMFIXWIN - 2; i >= 0; i--) {
+    for (j = 0; j < M25519_TED_WINDOW - 1; j++) ted_double(r);
+    bits = ted_getbits(kodd, i*(M25519_TED_WINDOW - 1), M25519_TED_WINDOW) | 1;
+    neg = 1 - (bits >> (M25519_TED_WINDOW - 1));
+    ted_load_odd(&tp, tbl, ((bits ^ (0 - neg)) & low) >> 1, neg);
+    ted_add_ep(r, &tp, d);
+  }
+
+  // R = R - P if k is even and R = R + O otherwise
+  ted_load_odd(&tp, tbl, 0, 1);
+  ted_set0(&zp);
+  mask = 0 - ((Word) even);
+  for (j = 0; j < 5*LEN; j++) tmp[j] = (tmp[j] & mask) | (zero[j] & ~mask);
+  ted_add_ep(r, &tp, d);
+}
+
+
+// Check whether an affine point $P$ has low order, i.e., $8P = O$
+// ---------------------------------------------------------------
+// $8P$ has $X = 0$ if and only if it is $O$ since the group of Edwards25519
+// has no point of order 16.
+
+static int ted_low_order(const Point *p)
+{
+  Word tmp[6*LEN], zero[LEN];
+  Point tp = { 6, tmp };
+
+  ted_copy(&tp, p);
+  ted_double(&tp);
+  ted_double(&tp);
+  ted_double(&tp);
+  mpi_setw(zero, 0, LEN);
+
+  return (gfp_cmp(tmp, zero) == 0);
+}
+
+
+// Variable-base scalar multiplication: $R = k P$
+// ----------------------------------------------
+// The scalar $k$ (eight words) must not be 0 and the affine point $P$ must
+// not have low order. The product is computed with `ted_mul_fixwin`, which
+// has an operand-independent execution profile, and converted to affine
+// coordinates. The return value is `M25519_ERR_SCALAR` if $k = 0$,
+// `M25519_ERR_TPOINT` if $P$ has low order or $R = O$, and `M25519_NO_ERROR`
+// otherwise.
+
+int ted_mul_varbase(Point *r, const Word *k, const Point *p, \
+  const ECDomPar *d)
+{
+  Word tmp[6*LEN], pep[5*LEN];
+  Point tp = { 6, tmp }, pp = { 5, pep };
+  int err;
+
+  if (mpi_cmpw(k, 0, LEN) == 0) return M25519_ERR_SCALAR;
+  if (ted_low_order(p)) return M25519_ERR_TPOINT;
+  ted_copy(&pp, p);
+  ted_mul_fixwin(&tp, k, &pp, d);
+  err = ted_conv_p2a(r, &tp, d);
+  if ((mpi_cmpw(r->xyz, 0, LEN) == 0) && (mpi_cmpw(&r->xyz[LEN], 1, LEN) == 0))
+    err = M25519_ERR_TPOINT;
+
+  return err;
+}
+
+
+// Variable-base scalar multiplication with projective result: $R = k P$
+// ---------------------------------------------------------------------
+// This function computes the same point as `ted_mul_varbase`, but $R$ is left
+// in extended projective coordinates $[X:Y:Z:E:H]$ (i.e., `r->dim` must be
+// 6). The return value is the same as that of `ted_mul_varbase`; when $k = 0$
+// or $P$ has low order, $R$ is not written.
+
+int ted_mul_varbase_proj(Point *r, const Word *k, const Point *p, \
+  const ECDomPar *d)
+{
+  Word pep[5*LEN];
+  Point pp = { 5, pep };
+
+  if (mpi_cmpw(k, 0, LEN) == 0) return M25519_ERR_SCALAR;
+  if (ted_low_order(p)) return M25519_ERR_TPOINT;
+  ted_copy(&pp, p);
+  ted_mul_fixwin(r, k, &pp, d);
+
+  return ted_is_neutral(r) ? M25519_ERR_TPOINT : M25519_NO_ERROR;
+}
+
+
+// Recoding of a 256-bit scalar into its width-$W$ NAF
+// ---------------------------------------------------
+// Every non-zero digit of the wNAF is odd and in the range $[-(2^{W-1}-1),
+// 2^{W-1}-1]$, and it is followed by at least $W-1$ zero digits. The digits
+// are computed from $W$ bits of $k$ and a carry, i.e., $k$ is not modified.
+// The array `naf` must be able to accommodate `NAFLEN` digits. The return
+// value is the number of digits up to and including the most-significant
+// non-zero digit (0 if $k = 0$).
+// NOTE: The execution time of this function depends on $k$.
+
+static int ted_wnaf(signed char *naf, const Word *k)
+{
+  int i, pos = 0, carry = 0, dig, len = 0;
+
+  for (i = 0; i < NAFLEN; i++) naf[i] = 0;
+  while ((pos < WSIZE*LEN) || (carry && (pos < NAFLEN))) {
+    if (ted_getbits(k, pos, 1) == carry) {  // digit 0
+      pos++;
+      continue;
+    }
+    dig = ted_getbits(k, pos, M25519_TED_WINDOW) + carry;
+    carry = (dig >> (M25519_TED_WINDOW - 1)) & 1;
+    dig -= carry << M25519_TED_WINDOW;
+    naf[pos] = (signed char) dig;
+    len = pos + 1;
+    pos += M25519_TED_WINDOW;
+  }
+
+  return len;
+}
+
+
+// Digit `i` of the (interleaved) wNAF method: $R = 2R + \sum_j k_{j,i} P_j$
+// ------------------------------------------------------------------------
+// This function doubles $R$ (unless `rset` is 0, i.e., $R$ is still $O$) and
+// adds the odd multiples of $P_j$ selected (and possibly negated) by the
+// non-zero digits at position `i` of the `n` wNAFs in `naf`, which are taken
+// from the $j$-th sub-table of `tbl` computed with `ted_odd_table`. The
+// return value is the updated `rset`. `r->dim` must be 6.
+// NOTE: The execution time of this function depends on the wNAFs.
+
+static int ted_wnaf_digit(Point *r, signed char (*naf)[NAFLEN], \
+  const Word *tbl, int n, int i, int rset, const ECDomPar *d)
+{
+  Word neg[5*LEN];
+  Point ep = { 5, NULL };
+  const Word *ent;
+  int j, dig;
+
+  if (rset) ted_double(r);
+  for (j = 0; j < n; j++) {
+    dig = naf[j][i];
+    if (dig == 0) continue;
+    ent = &tbl[(j*TED_WINSIZE+((dig < 0) ? -dig : dig)/2)*5*LEN];
+    if (dig < 0) {  // -P = [-X:Y:Z:-E:H]
+      mpi_copy(neg, ent, 5*LEN);
+      gfp_cneg(neg, neg, 1);
+      gfp_cneg(&neg[3*LEN], &neg[3*LEN], 1);
+      ent = neg;
+    }
+    ep.xyz = (Word *) ent;
+    if (rset) ted_add_ep(r, &ep, d);
+    else ted_copy(r, &ep);
+    rset = 1;
+  }
+
+  return rset;
+}
+
+
+// Main loop of the (interleaved) wNAF method: $R = \sum_j k_j P_j$
+// ----------------------------------------------------------------
+// The `n` wNAFs in `naf` (with up to `len` digits) are processed with a single
+// sequence of doublings by `ted_wnaf_digit`, starting with $R = O$. `r->dim`
+// must be 6.
+// NOTE: The execution time of this function depends on the wNAFs.
+
+static void ted_wnaf_loop(Point *r, signed char (*naf)[NAFLEN], \
+  const Word *tbl, int n, int len, const ECDomPar *d)
+{
+  int i, rset = 0;
+
+  ted_set0(r);
+  for (i = len - 1; i >= 0; i--) {
+    rset = ted_wnaf_digit(r, naf, tbl, n, i, rset, d);
+  }
+}
+
+
+#if defined(M25519_DUAL_CORE)
+
+// Job for the second core that computes $R = k P$ with a single wNAF, where
+// $P$ is given in extended affine coordinates
+static void ted_wnaf_job(void *arg)
+{
+  TedJobArg *a = (TedJobArg *) arg;
+  Word tbl[TED_WINSIZE*5*LEN], tmp[6*LEN];
+  signed char naf[1][NAFLEN];
+  Point tp = { 6, tmp };
+  int len;
+
+  ted_conv_ea2ep(&tp, a->p);
+  ted_odd_table(tbl, &tp, a->d);
+  len = ted_wnaf(naf[0], a->s);
+  ted_wnaf_loop(a->r, naf, tbl, 1, len, a->d);
+}
+
+#endif
+
+
+// Double-base scalar multiplication with interleaved wNAFs: $R = l G + k P$
+// --------------------------------------------------------------------------
+// Both scalars (eight words each) are recoded into their width-$W$ NAF and
+// processed with a single sequence of doublings (method of Straus-Shamir),
+// whereby the non-zero digits select (and possibly negate) the odd multiples
+// of $G$ and $P$, which are computed at run time with `ted_odd_table`. On
+// average, one in $W+1$ digits is non-zero, i.e., $256 \cdot 2/(W+1)$
+// extended projective additions are executed instead of $256/c \cdot (2 +
+// 2^c)$ of the bucket method in `ted_mul_multi`. The point $P$ must be given
+// in extended affine $(u,v,w)$ coordinates, and the result $R$ is in extended
+// projective coordinates, i.e., `r->dim` must be 6. The parameter `d` is
+// needed to access the curve parameter $d$. When a hook for the second core
+// is registered (see `M25519_DUAL_CORE`), $k P$ is computed with a single wNAF
+// on the second core and $l G$ with the comb method on the calling core, and
+// the two products are added at the end.
+// NOTE: The execution time of this function depends on the scalars, i.e., it
+// must only be used when both scalars are public (e.g., for the verification
+// of signatures).
+
+void ted_mul_dblbase_wnaf(Point *r, const Word *l, const Word *k, \
+  const Point *p, const ECDomPar *d)
+{
+  Word tbl[2*TED_WINSIZE*5*LEN], tmp[6*LEN];
+  signed char naf[2][NAFLEN];
+  Point tp = { 6, tmp }, gp = { 3, (Word *) TEDGENEA };
+  int i, len;
+#if defined(M25519_DUAL_CORE)
+  Word m[LEN+1];
+  TedJobArg arg;
+
+  if (ted_core1_run != NULL) {
+    arg.r = &tp;
+    arg.s = k;
+    arg.p = p;
+    arg.tbl = NULL;
+    arg.b0 = arg.b1 = 0;
+    arg.d = d;
+    ted_core1_run(ted_wnaf_job, &arg);
+    ted_comb_recode(m, l, d);
+    ted_comb_part(r, m, d->tbl, 0, M25519_COMB_TABLES);
+    ted_core1_wait();
+    ted_add_ep(r, &tp, d);
+    return;
+  }
+#endif
+
+  ted_conv_ea2ep(&tp, &gp);
+  ted_odd_table(tbl, &tp, d);
+  ted_conv_ea2ep(&tp, p);
+  ted_odd_table(&tbl[TED_WINSIZE*5*LEN], &tp, d);
+  len = ted_wnaf(naf[0], l);
+  i = ted_wnaf(naf[1], k);
+  if (i > len) len = i;
+  ted_wnaf_loop(r, naf, tbl, 2, len, d);
+}
+
+
+// Double-scalar multiplication: $R = l G - k P$
+// ---------------------------------------------
+// The scalars $l$ and $k$ (eight words each) must not be 0 and the affine
+// point $P$ must not have low order. The point $-P$ is converted to extended
+// affine coordinates, the sum $l G + k(-P)$ is computed with
+// `ted_mul_dblbase_wnaf` and converted to affine coordinates. The return value
+// is `M25519_ERR_SCALAR` if $l = 0$ or $k = 0$, `M25519_ERR_TPOINT` if $P$
+// has low order or $R = O$, and `M25519_NO_ERROR` otherwise.
+// NOTE: The execution time of this function is not constant, i.e., it must
+// only be used when both scalars are public.
+
+int ted_mul_dblbase(Point *r, const Word *l, const Word *k, const Point *p, \
+  const ECDomPar *d)
+{
+  Word tmp[6*LEN], pea[3*LEN], neg[2*LEN];
+  Point tp = { 6, tmp }, pp = { 3, pea }, np = { 2, neg };
+  int err;
+
+  if ((mpi_cmpw(l, 0, LEN) == 0) || (mpi_cmpw(k, 0, LEN) == 0))
+    return M25519_ERR_SCALAR;
+  if (ted_low_order(p)) return M25519_ERR_TPOINT;
+  gfp_cneg(neg, p->xyz, 1);  // -P = (-x,y)
+  mpi_copy(&neg[LEN], &p->xyz[LEN], LEN);
+  ted_conv_a2ea(&pp, &np, d);
+  ted_mul_dblbase_wnaf(&tp, l, k, &pp, d);
+  err = ted_conv_p2a(r, &tp, d);
+  if ((mpi_cmpw(r->xyz, 0, LEN) == 0) && (mpi_cmpw(&r->xyz[LEN], 1, LEN) == 0))
+    err = M25519_ERR_TPOINT;
+
+  return err;
+}
+
+
+// Resumable double-scalar multiplication: $R = l G - k P$
+// -------------------------------------------------------
+// These three functions compute the same result as `ted_mul_dblbase`, but
+// the interleaved wNAF method is split into steps of one digit (i.e., one
+// doubling and up to two extended projective additions) so that a caller can
+// interleave the scalar multiplication with other tasks. The init function
+// checks the inputs, computes the tables of odd multiples of $G$ and $-P$
+// (i.e., $2^{W-1}$ point operations), and recodes both scalars. Every
+// step function processes up to `n` digits and returns the number of digits
+// that are still to be processed (0 when the main loop is complete), and the
+// final function converts the result to affine coordinates and checks it.
+// The return value of the init and the final function is the same as that of
+// `ted_mul_dblbase`, except that the final function returns
+// `M25519_ERR_STREAM` when the main loop is not complete yet. The final
+// function invalidates the context (also when the main loop is not complete),
+// i.e., further calls of the step function return 0 and a further call of the
+// final function returns `M25519_ERR_STREAM` until the context is initialized
+// again. The dual-core split of `ted_mul_dblbase_wnaf` is not used by these
+// functions.
+// NOTE: The execution time of the steps depends on the scalars, i.e., these
+// functions must only be used when both scalars are public.
+
+int ted_mul_dblbase_init(TedDblCtx *ctx, const Word *l, const Word *k, \
+  const Point *p, const ECDomPar *d)
+{
+  Word tmp[6*LEN], pea[3*LEN], neg[2*LEN];
+  Point tp = { 6, tmp }, pp = { 3, pea }, np = { 2, neg };
+  Point gp = { 3, (Word *) TEDGENEA }, rp = { 6, ctx->xyz };
+  int len, i;
+
+  ctx->pos = -1;
+  ctx->rset = 0;
+  ctx->err = M25519_NO_ERROR;
+  ted_set0(&rp);
+  if ((mpi_cmpw(l, 0, LEN) == 0) || (mpi_cmpw(k, 0, LEN) == 0))
+    ctx->err = M25519_ERR_SCALAR;
+  else if (ted_low_order(p)) ctx->err = M25519_ERR_TPOINT;
+  if (ctx->err != M25519_NO_ERROR) return ctx->err;
+
+  gfp_cneg(neg, p->xyz, 1);  // -P = (-x,y)
+  mpi_copy(&neg[LEN], &p->xyz[LEN], LEN);
+  ted_conv_a2ea(&pp, &np, d);
+  ted_conv_ea2ep(&tp, &gp);
+  ted_odd_table(ctx->tbl, &tp, d);
+  ted_conv_ea2ep(&tp, &pp);
+  ted_odd_table(&ctx->tbl[TED_WINSIZE*5*LEN], &tp, d);
+  len = ted_wnaf(ctx->naf[0], l);
+  i = ted_wnaf(ctx->naf[1], k);
+  ctx->pos = ((i > len) ? i : len) - 1;
+
+  return ctx->err;
+}
+
+
+int ted_mul_dblbase_step(TedDblCtx *ctx, int n, const ECDomPar *d)
+{
+  Point rp = { 6, ctx->xyz };
+
+  for (; (n > 0) && (ctx->pos >= 0); n--, ctx->pos--) {
+    ctx->rset = ted_wnaf_digit(&rp, ctx->naf, ctx->tbl, 2, ctx->pos, \
+      ctx->rset, d);
+  }
+
+  return ctx->pos + 1;
+}
+
+
+int ted_mul_dblbase_final(Point *r, TedDblCtx *ctx, const ECDomPar *d)
+{
+  Point tp = { 6, ctx->xyz };
+  int err = ctx->err;
+
+  if ((err == M25519_NO_ERROR) && (ctx->pos >= 0)) err = M25519_ERR_STREAM;
+  if (err == M25519_NO_ERROR) {
+    err = ted_conv_p2a(r, &tp, d);
+    if ((mpi_cmpw(r->xyz, 0, LEN) == 0) && \
+        (mpi_cmpw(&r->xyz[LEN], 1, LEN) == 0)) err = M25519_ERR_TPOINT;
+  }
+  ctx->pos = -1;
+  ctx->rset = 0;
+  ctx->err = M25519_ERR_STREAM;
+
+  return err;
+}
@@ -0,0 +1,127 @@
+///////////////////////////////////////////////////////////////////////////////
+// tedcurve.h: Arithmetic on the twisted Edwards curve Edwards25519.         //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _TEDCURVE_H
+#define _TEDCURVE_H
+
+#include "config.h"
+
+// Maximum number of points (and scalars) that can be processed by a single
+// call of the multi-scalar multiplication `ted_mul_multi`
+
+#define TED_MAXMULTI 65
+
+// Number of points per table and spacing of the teeth of the fixed-base comb
+// method (see `M25519_COMB_TEETH` and `M25519_COMB_TABLES` in `config.h`)
+
+#define TED_COMBSIZE (1 << (M25519_COMB_TEETH - 1))
+#define TED_COMBSPACE ((254 + M25519_COMB_TEETH*M25519_COMB_TABLES - 1)/ \
+  (M25519_COMB_TEETH*M25519_COMB_TABLES))
+
+// Number of Words of a complete comb table (all sub-tables)
+
+#define TED_COMBWORDS (M25519_COMB_TABLES*TED_COMBSIZE*3*LEN)
+
+// Number of odd multiples per table of the window methods used by the
+// variable-base and double-base scalar multiplication (see `M25519_TED_WINDOW`
+// in `config.h`)
+
+#define TED_WINSIZE (1 << (M25519_TED_WINDOW - 2))
+
+// Number of digits of the wNAF of a 256-bit scalar (at most one more digit
+// than the scalar has bits)
+
+#define TED_NAFLEN (WSIZE*LEN + 1)
+
+// Context of a resumable fixed-base scalar multiplication (see
+// `ted_mul_fixbase_init`): the current point and the recoded scalar of the
+// comb method. A context contains secret data and is wiped by
+// `ted_mul_fixbase_final`.
+
+typedef struct ted_fix_ctx {
+  Word xyz[6*LEN];  // current point in extended projective coordinates
+  Word m[LEN+1];    // recoded scalar (see `ted_comb_recode`)
+  int pos;          // next column of the comb, -1 when all are processed
+  int err;          // error code of the initialization
+} TedFixCtx;
+
+// Context of a resumable double-base scalar multiplication (see
+// `ted_mul_dblbase_init`): the current point, the tables of odd multiples
+// of $G$ and $-P$, and the wNAFs of both scalars.
+
+typedef struct ted_dbl_ctx {
+  Word xyz[6*LEN];                   // current point (extended projective)
+  Word tbl[2*TED_WINSIZE*5*LEN];     // odd multiples of G and -P
+  signed char naf[2][TED_NAFLEN];    // wNAFs of l and k
+  int pos;                           // next digit, -1 when all are processed
+  int rset;                          // 1 when current point is not O
+  int err;                           // error code of the initialization
+} TedDblCtx;
+
+// domain parameters and pre-computed constants of Curve25519/Edwards25519
+extern const ECDomPar ECDOMPAR25519;
+
+// generator of Edwards25519 in extended affine coordinates
+extern const Word TEDGENEA[3*LEN];
+
+#if defined(M25519_DUAL_CORE)
+// job executed on the second core of a dual-core microcontroller
+typedef void (*TedJob)(void *arg);
+// registration of the platform hook for running a job on the second core
+void ted_set_core1(void (*run)(TedJob job, void *arg), void (*wait)(void));
+#endif
+
+// prototypes of functions with C implementations only
+void ted_set0(Point *r);
+void ted_copy(Point *r, const Point *p);
+void ted_load_point(Point *r, const Word *tbl, int idx);
+void ted_load_point_ep(Point *r, const Word *tbl, int idx);
+void ted_conv_a2ea(Point *r, const Point *p, const ECDomPar *d);
+void ted_conv_ea2ep(Point *r, const Point *p);
+void ted_add(Point *r, const Point *p);
+void ted_add_ep(Point *r, const Point *p, const ECDomPar *d);
+void ted_double(Point *r);
+void ted_mul_combNb(Point *r, const Word *l, const ECDomPar *d);
+void ted_comb_table(Word *tbl, const Point *p, const ECDomPar *d);
+void ted_mul_dblbase_tbl(Point *r, const Word *l, const Word *k, \
+  const Word *tbl, const ECDomPar *d);
+int  ted_conv_p2a(Point *r, const Point *p, const ECDomPar *d);
+int  ted_conv_p2a_batch(Point *r, const Point *p, int n, Word *scratch, \
+  const ECDomPar *d);
+int  ted_mul_fixbase(Point *r, const Word *l, const ECDomPar *d);
+void ted_mul_multi(Point *r, const Word *k, const Point *p, int n, \
+  const ECDomPar *d);
+void ted_mul_dblbase_wnaf(Point *r, const Word *l, const Word *k, \
+  const Point *p, const ECDomPar *d);
+int  ted_mul_dblbase(Point *r, const Word *l, const Word *k, const Point *p, \
+  const ECDomPar *d);
+int  ted_mul_varbase(Point *r, const Word *k, const Point *p, \
+  const ECDomPar *d);
+int  ted_mul_fixbase_proj(Point *r, const Word *l, const ECDomPar *d);
+int  ted_mul_varbase_proj(Point *r, const Word *k, const Point *p, \
+  const ECDomPar *d);
+int  ted_mul_fixbase_init(TedFixCtx *ctx, const Word *l, const ECDomPar *d);
+int  ted_mul_fixbase_step(TedFixCtx *ctx, int n, const ECDomPar *d);
+int  ted_mul_fixbase_final(Point *r, TedFixCtx *ctx, const ECDomPar *d);
+int  ted_mul_dblbase_init(TedDblCtx *ctx, const Word *l, const Word *k, \
+  const Point *p, const ECDomPar *d);
+int  ted_mul_dblbase_step(TedDblCtx *ctx, int n, const ECDomPar *d);
+int  ted_mul_dblbase_final(Point *r, TedDblCtx *ctx, const ECDomPar *d);
+
+#endif
@@ -0,0 +1,638 @@
+///////////////////////////////////////////////////////////////////////////////
+// x25519.c: X25519 key exchange using the Montgomery form of Curve25519.    //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// The functions in this file implement X25519 key exchange as specified in RFC
+// 7748, i.e., the shared secret is the $x$-coordinate of the point $k \cdot P$
+// on Curve25519 computed with the Montgomery ladder. `x25519_batch` computes
+// a batch of shared secrets, whereby up to `X25519_MAXBATCH` ladders (each
+// for a different private key and public key) are executed in lockstep. When
+// `M25519_SIMD` is defined, groups of four ladders are executed with the four-
+// way parallel step `mon_ladder_step4` (and AVX2 or NEON instructions). The
+// remaining ladders (or all ladders when `M25519_SIMD` is not defined) are
+// interleaved, i.e., the scalar `mon_ladder_step` is executed for each ladder
+// before moving on to the next bit of the scalars. In both cases, the
+// inversions of the final Z-coordinates are performed together by
+// `gfp_inv_batch` with Montgomery's trick. The key-pair pool functions move
+// the generation of ephemeral key-pairs (fixed-base comb method on
+// Edwards25519 and mapping of the result to Curve25519) out of the critical
+// path of a key exchange. This file also contains the SHA-512 implementation
+// (FIPS 180-4) used by X25519 and Ed25519.
+
+
+#include <stddef.h>
+#include <string.h>
+#include "mpiarith.h"
+#include "gfparith.h"
+#include "gfparith4.h"
+#include "moncurve.h"
+#include "tedcurve.h"
+#include "x25519.h"
+
+
+// Constant $a_{24} = (A+2)/4$ of Curve25519
+static const Word CONSTA24[1] = { 121666 };
+
+// Number of vectors of four lanes needed for `X25519_MAXBATCH` ladders
+#define NUMVEC ((X25519_MAXBATCH + NUMLANES - 1)/NUMLANES)
+
+
+// Initial hash value and round constants of SHA-512 (FIPS 180-4)
+
+static const uint64_t SHA512IV[8] = {
+  0x6A09E667F3BCC908ULL, 0xBB67AE8584CAA73BULL, 0x3C6EF372FE94F82BULL,
+  0xA54FF53A5F1D36F1ULL, 0x510E527FADE682D1ULL, 0x9B05688C2B3E6C1FULL,
+  0x1F83D9ABFB41BD6BULL, 0x5BE0CD19137E2179ULL
+};
+
+static const uint64_t SHA512RC[80] = {
+  0x428A2F98D728AE22ULL, 0x7137449123EF65CDULL, 0xB5C0FBCFEC4D3B2FULL,
+  0xE9B5DBA58189DBBCULL, 0x3956C25BF348B538ULL, 0x59F111F1B605D019ULL,
+  0x923F82A4AF194F9BULL, 0xAB1C5ED5DA6D8118ULL, 0xD807AA98A3030242ULL,
+  0x12835B0145706FBEULL, 0x243185BE4EE4B28CULL, 0x550C7DC3D5FFB4E2ULL,
+  0x72BE5D74F27B896FULL, 0x80DEB1FE3B1696B1ULL, 0x9BDC06A725C71235ULL,
+  0xC19BF174CF692694ULL, 0xE49B69C19EF14AD2ULL, 0xEFBE4786384F25E3ULL,
+  0x0FC19DC68B8CD5B5ULL, 0x240CA1CC77AC9C65ULL, 0x2DE92C6F592B0275ULL,
+  0x4A7484AA6EA6E483ULL, 0x5CB0A9DCBD41FBD4ULL, 0x76F988DA831153B5ULL,
+  0x983E5152EE66DFABULL, 0xA831C66D2DB43210ULL, 0xB00327C898FB213FULL,
+  0xBF597FC7BEEF0EE4ULL, 0xC6E00BF33DA88FC2ULL, 0xD5A79147930AA725ULL,
+  0x06CA6351E003826FULL, 0x142929670A0E6E70ULL, 0x27B70A8546D22FFCULL,
+  0x2E1B21385C26C926ULL, 0x4D2C6DFC5AC42AEDULL, 0x53380D139D95B3DFULL,
+  0x650A73548BAF63DEULL, 0x766A0ABB3C77B2A8ULL, 0x81C2C92E47EDAEE6ULL,
+  0x92722C851482353BULL, 0xA2BFE8A14CF10364ULL, 0xA81A664BBC423001ULL,
+  0xC24B8B70D0F89791ULL, 0xC76C51A30654BE30ULL, 0xD192E819D6EF5218ULL,
+  0xD69906245565A910ULL, 0xF40E35855771202AULL, 0x106AA07032BBD1B8ULL,
+  0x19A4C116B8D2D0C8ULL, 0x1E376C085141AB53ULL, 0x2748774CDF8EEB99ULL,
+  0x34B0BCB5E19B48A8ULL, 0x391C0CB3C5C95A63ULL, 0x4ED8AA4AE3418ACBULL,
+  0x5B9CCA4F7763E373ULL, 0x682E6FF3D6B2B8A3ULL, 0x748F82EE5DEFB2FCULL,
+  0x78A5636F43172F60ULL, 0x84C87814A1F0AB72ULL, 0x8CC702081A6439ECULL,
+  0x90BEFFFA23631E28ULL, 0xA4506CEBDE82BDE9ULL, 0xBEF9A3F7B2C67915ULL,
+  0xC67178F2E372532BULL, 0xCA273ECEEA26619CULL, 0xD186B8C721C0C207ULL,
+  0xEADA7DD6CDE0EB1EULL, 0xF57D4F7FEE6ED178ULL, 0x06F067AA72176FBAULL,
+  0x0A637DC5A2C898A6ULL, 0x113F9804BEF90DAEULL, 0x1B710B35131C471BULL,
+  0x28DB77F523047D84ULL, 0x32CAAB7B40C72493ULL, 0x3C9EBE0A15C9BEBCULL,
+  0x431D67C49C100D4CULL, 0x4CC5D4BECB3E42B6ULL, 0x597F299CFC657E2AULL,
+  0x5FCB6FAB3AD6FAECULL, 0x6C44198C4A475817ULL
+};
+
+// Rotation of a 64-bit word by `n` bits to the right
+#define ROTR64(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+
+// Memory barrier that orders the accesses to a slot of a key-pair pool with
+// respect to the update of the read or write index. `__sync_synchronize` is a
+// compiler barrier and also emits a fence instruction where needed (e.g.,
+// `dmb` on ARM or `fence` on RISC-V). Compilers other than GCC and Clang have
+// to define `M25519_POOL_BARRIER` (e.g., as `__DMB()` with CMSIS) when the
+// pool is shared between different execution contexts.
+#if !defined(M25519_POOL_BARRIER)
+#if defined(__GNUC__)
+#define M25519_POOL_BARRIER() __sync_synchronize()
+#else
+#define M25519_POOL_BARRIER()
+#endif
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+////////////////////////////// SHA-512 HASH FUNCTION //////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Compression of a 128-byte block of the message
+// ----------------------------------------------
+// The message block is contained in `mbuf` as 16 big-Endian 64-bit words. The
+// message schedule is computed on the fly in a circular buffer of 16 words,
+// which keeps the RAM footprint small (i.e., `mbuf` is overwritten).
+
+static void sha512_compress(SHA512Ctx *ctx)
+{
+  uint64_t a, b, c, d, e, f, g, h, t1, t2, s0, s1;
+  uint64_t *w = ctx->mbuf;
+  int i;
+
+  a = ctx->hdig[0]; b = ctx->hdig[1]; c = ctx->hdig[2]; d = ctx->hdig[3];
+  e = ctx->hdig[4]; f = ctx->hdig[5]; g = ctx->hdig[6]; h = ctx->hdig[7];
+
+  for (i = 0; i < 80; i++) {
+    if (i >= 16) {
+      s0 = w[(i+1)&15];
+      s0 = ROTR64(s0, 1) ^ ROTR64(s0, 8) ^ (s0 >> 7);
+      s1 = w[(i+14)&15];
+      s1 = ROTR64(s1, 19) ^ ROTR64(s1, 61) ^ (s1 >> 6);
+      w[i&15] += s0 + s1 + w[(i+9)&15];
+    }
+    t1 = h + (ROTR64(e, 14) ^ ROTR64(e, 18) ^ ROTR64(e, 41));
+    t1 += ((e & f) ^ (~e & g)) + SHA512RC[i] + w[i&15];
+    t2 = (ROTR64(a, 28) ^ ROTR64(a, 34) ^ ROTR64(a, 39));
+    t2 += (a & b) ^ (a & c) ^ (b & c);
+    h = g; g = f; f = e; e = d + t1;
+    d = c; c = b; b = a; a = t1 + t2;
+  }
+
+  ctx->hdig[0] += a; ctx->hdig[1] += b; ctx->hdig[2] += c; ctx->hdig[3] += d;
+  ctx->hdig[4] += e; ctx->hdig[5] += f; ctx->hdig[6] += g; ctx->hdig[7] += h;
+}
+
+
+// Initialization of a SHA-512 context
+// -----------------------------------
+
+void sha512_init(SHA512Ctx *ctx)
+{
+  int i;
+
+  for (i = 0; i < 8; i++) ctx->hdig[i] = SHA512IV[i];
+  for (i = 0; i < 16; i++) ctx->mbuf[i] = 0;
+  ctx->length = 0;
+  ctx->mbytes = 0;
+}
+
+
+// Update of a SHA-512 context with data
+// -------------------------------------
+// The bytes are shifted into the 64-bit words of `mbuf` one after the other,
+// which makes the implementation independent of the endianness of the target.
+// A block is compressed as soon as `mbuf` contains 128 bytes.
+
+void sha512_update(SHA512Ctx *ctx, const Byte *data, size_t dlen)
+{
+  size_t i;
+  int j;
+
+  for (i = 0; i < dlen; i++) {
+    j = ctx->mbytes >> 3;
+    ctx->mbuf[j] = (ctx->mbuf[j] << 8) | data[i];
+    if (++ctx->mbytes == 128) {
+      sha512_compress(ctx);
+      ctx->mbytes = 0;
+    }
+  }
+  ctx->length += 8*dlen;
+}
+
+
+// Finalization of a SHA-512 context to obtain the digest
+// ------------------------------------------------------
+// The padding consists of a 1-bit, followed by 0-bits up to a length of 112
+// (mod 128) bytes and the 128-bit length of the message (in bits). At the end,
+// the context is re-initialized, which also wipes the message buffer.
+
+void sha512_final(SHA512Ctx *ctx, Byte *digest)
+{
+  size_t length = ctx->length;
+  Byte pad = 0x80;
+  int i;
+
+  do {
+    sha512_update(ctx, &pad, 1);
+    pad = 0;
+  } while (ctx->mbytes != 112);
+  ctx->mbuf[14] = 0;  // upper 64 bits of the length
+  ctx->mbuf[15] = (uint64_t) length;
+  sha512_compress(ctx);
+
+  for (i = 0; i < 64; i++) digest[i] = (Byte) (ctx->hdig[i/8] >> (56-8*(i%8)));
+  sha512_init(ctx);
+}
+
+
+// Computation of the SHA-512 digest of data
+// -----------------------------------------
+
+void sha512_hash(Byte *digest, const Byte *data, size_t dlen)
+{
+  SHA512Ctx ctx;
+
+  sha512_init(&ctx);
+  sha512_update(&ctx, data, dlen);
+  sha512_final(&ctx, digest);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+/////////////////////////// X25519 KEY EXCHANGE ///////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Conversion of 32 bytes (in little-Endian order) to an 8-word array and vice
+// versa. When `M25519_LEBYTES` is defined (see `config.h`), the byte order of
+// the target is the same as that of the arrays and the conversion is a copy.
+// Otherwise, the conversions are independent of the endianness of the target.
+
+#if defined(M25519_LEBYTES)
+
+static void x25519_from_bytes(Word *r, const Byte *a)
+{
+  memcpy(r, a, 4*LEN);
+}
+
+static void x25519_to_bytes(Byte *r, const Word *a)
+{
+  memcpy(r, a, 4*LEN);
+}
+
+#else
+
+static void x25519_from_bytes(Word *r, const Byte *a)
+{
+  int i;
+
+  for (i = 0; i < LEN; i++) {
+    r[i] = ((Word) a[4*i]) | (((Word) a[4*i+1]) << 8) | \
+           (((Word) a[4*i+2]) << 16) | (((Word) a[4*i+3]) << 24);
+  }
+}
+
+static void x25519_to_bytes(Byte *r, const Word *a)
+{
+  int i;
+
+  for (i = 0; i < 4*LEN; i++) r[i] = (Byte) (a[i/4] >> (8*(i % 4)));
+}
+
+#endif
+
+
+// Batch of (up to `X25519_MAXBATCH`) Montgomery ladders: $R_j = k_j \cdot P_j$
+// ----------------------------------------------------------------------------
+// The arrays `k` and `xd` contain the `m` (pruned) scalars and $x$-coordinates
+// of the base points, respectively. After the ladder, the projective $X$ and
+// $Z$-coordinates of $R_j$ are stored in the arrays `xr` and `zr`. All ladders
+// execute the same sequence of operations for each of the 255 scalar bits, and
+// their coordinates are wiped at the end.
+
+static void x25519_ladders(Word *xr, Word *zr, const Word *k, const Word *xd, \
+  int m)
+{
+  Word xz[X25519_MAXBATCH*4*LEN];
+  int i, j, bit, prev[X25519_MAXBATCH];
+
+  for (j = 0; j < m; j++) {
+    mpi_setw(&xz[j*4*LEN], 1, LEN);              // X_R = 1
+    mpi_copy(&xz[j*4*LEN+LEN], &xd[j*LEN], LEN);  // X_S = x_D
+    mpi_setw(&xz[j*4*LEN+2*LEN], 0, LEN);        // Z_R = 0
+    mpi_setw(&xz[j*4*LEN+3*LEN], 1, LEN);        // Z_S = 1
+    prev[j] = 0;
+  }
+
+  for (i = CONSTK - 1; i >= 0; i--) {
+    for (j = 0; j < m; j++) {
+      bit = (k[j*LEN+i/WSIZE] >> (i % WSIZE)) & 1;
+      mon_ladder_step(&xz[j*4*LEN], &xd[j*LEN], CONSTA24, bit ^ prev[j]);
+      prev[j] = bit;
+    }
+  }
+
+  for (j = 0; j < m; j++) {
+    gfp_cswap(&xz[j*4*LEN], &xz[j*4*LEN+LEN], prev[j]);
+    gfp_cswap(&xz[j*4*LEN+2*LEN], &xz[j*4*LEN+3*LEN], prev[j]);
+    mpi_copy(&xr[j*LEN], &xz[j*4*LEN], LEN);
+    mpi_copy(&zr[j*LEN], &xz[j*4*LEN+2*LEN], LEN);
+  }
+  mpi_setw(xz, 0, X25519_MAXBATCH*4*LEN);
+}
+
+
+#if defined(M25519_SIMD)
+
+// Same as `x25519_ladders`, but the ladders are executed in groups of four
+// with `mon_ladder_step4`, i.e., `m` must be a multiple of four. Bit j of the
+// `swap` operand of `mon_ladder_step4` is the swap-bit of the ladder in lane j.
+
+static void x25519_ladders4(Word *xr, Word *zr, const Word *k, \
+  const Word *xd, int m)
+{
+  Word xz[NUMVEC*4*LEN4], xdv[NUMVEC*LEN4], one[NUMLANES*LEN];
+  int i, j, v, bits, prev[NUMVEC];
+  int nvec = m/NUMLANES;
+
+  for (j = 0; j < NUMLANES*LEN; j++) one[j] = ((j % LEN) == 0);
+  for (v = 0; v < nvec; v++) {
+    gfp4_pack(&xdv[v*LEN4], &xd[v*NUMLANES*LEN]);
+    gfp4_pack(&xz[v*4*LEN4], one);                     // X_R = 1
+    mpi_copy(&xz[v*4*LEN4+LEN4], &xdv[v*LEN4], LEN4);  // X_S = x_D
+    mpi_setw(&xz[v*4*LEN4+2*LEN4], 0, LEN4);           // Z_R = 0
+    gfp4_pack(&xz[v*4*LEN4+3*LEN4], one);              // Z_S = 1
+    prev[v] = 0;
+  }
+
+  for (i = CONSTK - 1; i >= 0; i--) {
+    for (v = 0; v < nvec; v++) {
+      bits = 0;
+      for (j = 0; j < NUMLANES; j++) {
+        bits |= ((k[(NUMLANES*v+j)*LEN+i/WSIZE] >> (i % WSIZE)) & 1) << j;
+      }
+      mon_ladder_step4(&xz[v*4*LEN4], &xdv[v*LEN4], CONSTA24, bits ^ prev[v]);
+      prev[v] = bits;
+    }
+  }
+
+  for (v = 0; v < nvec; v++) {
+    gfp4_cswap(&xz[v*4*LEN4], &xz[v*4*LEN4+LEN4], prev[v]);
+    gfp4_cswap(&xz[v*4*LEN4+2*LEN4], &xz[v*4*LEN4+3*LEN4], prev[v]);
+    gfp4_unpack(&xr[v*NUMLANES*LEN], &xz[v*4*LEN4]);
+    gfp4_unpack(&zr[v*NUMLANES*LEN], &xz[v*4*LEN4+2*LEN4]);
+  }
+  mpi_setw(xz, 0, NUMVEC*4*LEN4);
+}
+
+#endif
+
+
+// Computation of a batch of X25519 shared secrets
+// -----------------------------------------------
+// The `n` private keys and public keys are processed in groups of (at most)
+// `X25519_MAXBATCH`. For each group, the private keys are pruned and the MSB
+// of the public keys is masked (as described in RFC 7748), then the ladders
+// are executed in lockstep and the Z-coordinates of all results are inverted
+// with a single `gfp_inv_batch` call. A shared secret of 0 indicates that the
+// public key is a point of low order, in which case err[j] is set to
+// `M25519_ERR_MPOINT` (the check is performed without branches). The shared
+// inversion has constant execution time (see `gfp_inv_batch`), and all arrays
+// containing secret data (including the Montgomery ladders) are wiped.
+
+int x25519_batch(Byte *shared[], const Byte *sk[], const Byte *pk[], int n, \
+  int *err)
+{
+  Word k[X25519_MAXBATCH*LEN], xd[X25519_MAXBATCH*LEN];
+  Word xr[X25519_MAXBATCH*LEN], zr[X25519_MAXBATCH*LEN];
+  Word scratch[X25519_MAXBATCH*LEN];
+  Word acc;
+  int base, i, j, m, m4, e, rval = M25519_NO_ERROR;
+
+  for (base = 0; base < n; base += X25519_MAXBATCH) {
+    m = ((n - base) < X25519_MAXBATCH) ? (n - base) : X25519_MAXBATCH;
+    for (j = 0; j < m; j++) {
+      x25519_from_bytes(&k[j*LEN], sk[base+j]);
+      k[j*LEN] &= 0xFFFFFFF8UL;         // clear three lowest bits
+      k[j*LEN+LEN-1] &= 0x7FFFFFFFUL;   // clear bit 255
+      k[j*LEN+LEN-1] |= 0x40000000UL;   // set bit 254
+      x25519_from_bytes(&xd[j*LEN], pk[base+j]);
+      xd[j*LEN+LEN-1] &= 0x7FFFFFFFUL;  // mask bit 255
+    }
+
+#if defined(M25519_SIMD)  // full groups of four ladders in SIMD lanes
+    m4 = m - (m % NUMLANES);
+    x25519_ladders4(xr, zr, k, xd, m4);
+#else
+    m4 = 0;
+#endif
+    x25519_ladders(&xr[m4*LEN], &zr[m4*LEN], &k[m4*LEN], &xd[m4*LEN], m - m4);
+    gfp_inv_batch(zr, zr, m, scratch);
+
+    for (j = 0; j < m; j++) {
+      gfp_mul(&xr[j*LEN], &xr[j*LEN], &zr[j*LEN]);
+      gfp_fred(&xr[j*LEN], &xr[j*LEN]);
+      x25519_to_bytes(shared[base+j], &xr[j*LEN]);
+      acc = 0;
+      for (i = 0; i < LEN; i++) acc |= xr[j*LEN+i];
+      // e = M25519_ERR_MPOINT if acc = 0, else e = 0
+      e = (int) (((Word) M25519_ERR_MPOINT) & (((acc | (0 - acc)) >> 31) - 1));
+      if (err != NULL) err[base+j] = e;
+      rval |= e;
+    }
+  }
+
+  mpi_setw(k, 0, X25519_MAXBATCH*LEN);
+  mpi_setw(xr, 0, X25519_MAXBATCH*LEN);
+  mpi_setw(zr, 0, X25519_MAXBATCH*LEN);
+  mpi_setw(scratch, 0, X25519_MAXBATCH*LEN);
+
+  return rval;
+}
+
+
+// Generation of an X25519 key-pair from 32 random bytes
+// -----------------------------------------------------
+// The random bytes are pruned as described in RFC 7748 to get the private key
+// $k$, and $Q = k G$ is computed with the fixed-base comb method on
+// Edwards25519. The $u$-coordinate of the corresponding point on Curve25519 is
+// $u = (1 + y)/(1 - y) = (Z + Y)/(Z - Y)$, which is obtained with a single
+// inversion by passing the projective point $[Z+Y:Y:Z-Y]$ to `ted_conv_p2a`
+// (i.e., the $x$-coordinate computed by `ted_conv_p2a` is $u$). All
+// intermediate values are wiped. The return value is `M25519_ERR_TPOINT` if
+// $Q$ is the neutral element (which happens with negligible probability) and
+// `M25519_NO_ERROR` otherwise.
+
+static int x25519_pool_keygen(Byte *privkey, Byte *pubkey, const Byte *rbytes)
+{
+  Word k[LEN], tmp[6*LEN], uy[2*LEN];
+  Point tp = { 6, tmp }, up = { 2, uy };
+  int err;
+
+  x25519_from_bytes(k, rbytes);
+  k[0] &= 0xFFFFFFF8UL;      // clear three lowest bits
+  k[LEN-1] &= 0x7FFFFFFFUL;  // clear bit 255
+  k[LEN-1] |= 0x40000000UL;  // set bit 254
+  ted_mul_combNb(&tp, k, &ECDOMPAR25519);
+  gfp_add(tmp, &tmp[2*LEN], &tmp[LEN]);          // X = Z + Y
+  gfp_sub(&tmp[2*LEN], &tmp[2*LEN], &tmp[LEN]);  // Z = Z - Y
+  err = ted_conv_p2a(&up, &tp, &ECDOMPAR25519);  // u = X/Z
+  x25519_to_bytes(privkey, k);
+  x25519_to_bytes(pubkey, uy);
+
+  mpi_setw(k, 0, LEN);
+  mpi_setw(tmp, 0, 6*LEN);
+  mpi_setw(uy, 0, 2*LEN);
+
+  return err;
+}
+
+
+// Initialization of a key-pair pool
+// ---------------------------------
+// All slots are wiped and the pool is empty afterwards. This function can also
+// be used to discard all pre-computed key-pairs of a pool.
+
+void x25519_pool_init(X25519Pool *pool)
+{
+  int i, j;
+
+  for (i = 0; i < X25519_POOLSIZE; i++) {
+    for (j = 0; j < 32; j++) {
+      pool->sk[i][j] = 0;
+      pool->pk[i][j] = 0;
+    }
+  }
+  pool->rd = pool->wr = 0;
+}
+
+
+// Number of key-pairs in a pool
+// -----------------------------
+
+int x25519_pool_count(const X25519Pool *pool)
+{
+  return (pool->wr - pool->rd + 2*X25519_POOLSIZE) % (2*X25519_POOLSIZE);
+}
+
+
+// Addition of a key-pair to a pool
+// --------------------------------
+// One key-pair is generated from the 32 random bytes in `rbytes` and stored in
+// the next free slot, so that the execution time of a call is roughly that of
+// one fixed-base scalar multiplication. When the pool is full, the random
+// bytes are not used and the pool remains unchanged. The write index is only
+// updated after the key-pair has been completely stored, which is enforced by
+// a memory barrier between the stores to the slot and the store to `wr`. The
+// return value is `M25519_ERR_TPOINT` if the public key is invalid (in which
+// case the slot is wiped again) and `M25519_NO_ERROR` otherwise.
+// NOTE: `x25519_pool_refill` and `x25519_pool_take` may be called from
+// different execution contexts (e.g., an idle loop and an interrupt handler,
+// or two cores) without locking, provided that only one context refills the
+// pool and only one context takes key-pairs from it (single producer, single
+// consumer), and that `M25519_POOL_BARRIER` is a memory barrier.
+
+int x25519_pool_refill(X25519Pool *pool, const Byte *rbytes)
+{
+  int slot, err, j;
+
+  if (x25519_pool_count(pool) == X25519_POOLSIZE) return M25519_NO_ERROR;
+
+  M25519_POOL_BARRIER();  // slot is free before it is overwritten
+  slot = pool->wr % X25519_POOLSIZE;
+  err = x25519_pool_keygen(pool->sk[slot], pool->pk[slot], rbytes);
+  if (err != M25519_NO_ERROR) {
+    for (j = 0; j < 32; j++) {
+      pool->sk[slot][j] = 0;
+      pool->pk[slot][j] = 0;
+    }
+    return err;
+  }
+  M25519_POOL_BARRIER();  // key-pair is stored before it is published
+  pool->wr = (pool->wr + 1) % (2*X25519_POOLSIZE);
+
+  return M25519_NO_ERROR;
+}
+
+
+// Removal of a key-pair from a pool
+// ---------------------------------
+// The oldest key-pair is copied to `privkey` and `pubkey` (32 bytes each) and
+// its slot is wiped, i.e., each key-pair is handed out only once. The return
+// value is `M25519_ERR_POOLEMPTY` if the pool is empty (in which case
+// `privkey` and `pubkey` are not modified) and `M25519_NO_ERROR` otherwise.
+// The slot is only read after `wr` has been read and only released (i.e.,
+// `rd` is updated) after it has been wiped, with a memory barrier in between.
+
+int x25519_pool_take(X25519Pool *pool, Byte *privkey, Byte *pubkey)
+{
+  int slot, j;
+
+  if (x25519_pool_count(pool) == 0) return M25519_ERR_POOLEMPTY;
+
+  M25519_POOL_BARRIER();  // key-pair is read after it has been published
+  slot = pool->rd % X25519_POOLSIZE;
+  for (j = 0; j < 32; j++) {
+    privkey[j] = pool->sk[slot][j];
+    pubkey[j] = pool->pk[slot][j];
+    pool->sk[slot][j] = 0;
+    pool->pk[slot][j] = 0;
+  }
+  M25519_POOL_BARRIER();  // slot is wiped before it is released
+  pool->rd = (pool->rd + 1) % (2*X25519_POOLSIZE);
+
+  return M25519_NO_ERROR;
+}
+
+
+// Resumable computation of an X25519 shared secret
+// ------------------------------------------------
+// These three functions compute the same shared secret as `x25519_batch` for
+// a single private key and public key, but the Montgomery ladder is split
+// into `CONSTK` steps (one `mon_ladder_step` per bit of the pruned private
+// key) so that a caller can interleave the key exchange with other tasks. The
+// init function prunes the private key and masks the MSB of the public key
+// (as described in RFC 7748), and every step function executes up to `n`
+// ladder steps and returns the number of ladder steps that are still to be
+// executed (0 when the ladder is complete). Each ladder step executes the same
+// sequence of operations, and the number of executed ladder steps only
+// depends on `n`. The final function performs the last conditional swap,
+// computes $u = X_R/Z_R$ with the constant-time inversion of `ted_conv_p2a`
+// (which costs about as much as 25 ladder steps), stores the shared secret in
+// `shared`, and wipes the context. The return value of the final function is
+// `M25519_ERR_STREAM` if the ladder is not complete yet (in which case
+// `shared` is not modified), `M25519_ERR_MPOINT` if the shared secret is 0
+// (i.e., the public key is a point of low order), and `M25519_NO_ERROR`
+// otherwise. A context that has already been finalized yields a shared secret
+// of 0.
+
+void x25519_init(X25519Ctx *ctx, const Byte *sk, const Byte *pk)
+{
+  Word *xz = ctx->xz;
+
+  x25519_from_bytes(ctx->k, sk);
+  ctx->k[0] &= 0xFFFFFFF8UL;      // clear three lowest bits
+  ctx->k[LEN-1] &= 0x7FFFFFFFUL;  // clear bit 255
+  ctx->k[LEN-1] |= 0x40000000UL;  // set bit 254
+  x25519_from_bytes(ctx->xd, pk);
+  ctx->xd[LEN-1] &= 0x7FFFFFFFUL;  // mask bit 255
+
+  mpi_setw(xz, 1, LEN);                 // X_R = 1
+  mpi_copy(&xz[LEN], ctx->xd, LEN);     // X_S = x_D
+  mpi_setw(&xz[2*LEN], 0, LEN);         // Z_R = 0
+  mpi_setw(&xz[3*LEN], 1, LEN);         // Z_S = 1
+  ctx->pos = CONSTK - 1;
+  ctx->prev = 0;
+}
+
+
+int x25519_step(X25519Ctx *ctx, int n)
+{
+  int bit;
+
+  for (; (n > 0) && (ctx->pos >= 0); n--, ctx->pos--) {
+    bit = (ctx->k[ctx->pos/WSIZE] >> (ctx->pos % WSIZE)) & 1;
+    mon_ladder_step(ctx->xz, ctx->xd, CONSTA24, bit ^ ctx->prev);
+    ctx->prev = bit;
+  }
+
+  return ctx->pos + 1;
+}
+
+
+int x25519_final(Byte *shared, X25519Ctx *ctx)
+{
+  Word tmp[3*LEN], u[2*LEN];
+  Point tp = { 3, tmp }, up = { 2, u };
+  Word acc = 0;
+  int i, err = M25519_ERR_STREAM;
+
+  if (ctx->pos < 0) {
+    gfp_cswap(ctx->xz, &ctx->xz[LEN], ctx->prev);
+    gfp_cswap(&ctx->xz[2*LEN], &ctx->xz[3*LEN], ctx->prev);
+    mpi_copy(tmp, ctx->xz, LEN);                   // X = X_R
+    mpi_copy(&tmp[2*LEN], &ctx->xz[2*LEN], LEN);   // Z = Z_R
+    mpi_setw(&tmp[LEN], 0, LEN);
+    ted_conv_p2a(&up, &tp, &ECDOMPAR25519);        // u = X/Z (0 if Z = 0)
+    x25519_to_bytes(shared, u);
+    for (i = 0; i < LEN; i++) acc |= u[i];
+    // err = M25519_ERR_MPOINT if acc = 0, else err = 0
+    err = (int) (((Word) M25519_ERR_MPOINT) & (((acc | (0 - acc)) >> 31) - 1));
+  }
+
+  mpi_setw(ctx->xz, 0, 4*LEN);
+  mpi_setw(ctx->k, 0, LEN);
+  ctx->pos = -1;
+  ctx->prev = 0;
+  mpi_setw(tmp, 0, 3*LEN);
+  mpi_setw(u, 0, 2*LEN);
+
+  return err;
+}
@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////////////////////////////////
+// x25519.h: X25519 key exchange using the Montgomery form of Curve25519.    //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _X25519_H
+#define _X25519_H
+
+#include <stddef.h>
+#include "config.h"
+
+// Context of SHA-512 (i.e., current state of the hash function) for an init-
+// update-final computation of the digest
+
+typedef struct sha512_ctx {
+  uint64_t hdig[8];   // current (i.e., intermediate) hash digest
+  uint64_t mbuf[16];  // buffer for a 128-byte block of the message
+  size_t length;      // overall length of hashed message (in bits)
+  int mbytes;         // number of bytes contained in mbuf-array
+} SHA512Ctx;
+
+// Maximum number of Montgomery ladders executed in lockstep (and number of
+// Z-coordinates inverted simultaneously) by `x25519_batch`
+
+#define X25519_MAXBATCH 16
+
+// Number of X25519 key-pairs that can be held by a key-pair pool (see
+// `x25519_pool_refill` and `x25519_pool_take`)
+
+#define X25519_POOLSIZE 4
+
+// Pool of pre-computed (ephemeral) X25519 key-pairs, which is organized as a
+// single-producer/single-consumer ring buffer. The read index `rd` is only
+// modified by `x25519_pool_take` and the write index `wr` only by
+// `x25519_pool_refill`. Both indices are kept modulo 2*X25519_POOLSIZE so that
+// a full and an empty pool can be told apart, and they are `volatile` since
+// the two functions may be executed in different contexts (see
+// `M25519_POOL_BARRIER` in `x25519.c`). Free slots are always all-0.
+
+typedef struct x25519_pool {
+  Byte sk[X25519_POOLSIZE][32];  // private keys (pruned)
+  Byte pk[X25519_POOLSIZE][32];  // public keys
+  volatile int rd;               // read index (oldest key-pair)
+  volatile int wr;               // write index (next free slot)
+} X25519Pool;
+
+// Context of a resumable computation of an X25519 shared secret (see
+// `x25519_init`): the coordinates $X_R, X_S, Z_R, Z_S$ of the Montgomery
+// ladder, the $x$-coordinate of the public key, and the pruned private key.
+// A context contains secret data and is wiped by `x25519_final`.
+
+typedef struct x25519_ctx {
+  Word xz[4*LEN];  // X_R, X_S, Z_R, Z_S
+  Word xd[LEN];    // x-coordinate of the public key
+  Word k[LEN];     // private key (pruned)
+  int pos;         // next bit of the private key, -1 when ladder is complete
+  int prev;        // previous bit of the private key (for the final swap)
+} X25519Ctx;
+
+// prototypes of functions with C implementations only
+void sha512_init(SHA512Ctx *ctx);
+void sha512_update(SHA512Ctx *ctx, const Byte *data, size_t dlen);
+void sha512_final(SHA512Ctx *ctx, Byte *digest);
+void sha512_hash(Byte *digest, const Byte *data, size_t dlen);
+int  x25519_batch(Byte *shared[], const Byte *sk[], const Byte *pk[], int n, \
+  int *err);
+void x25519_pool_init(X25519Pool *pool);
+int  x25519_pool_count(const X25519Pool *pool);
+int  x25519_pool_refill(X25519Pool *pool, const Byte *rbytes);
+int  x25519_pool_take(X25519Pool *pool, Byte *privkey, Byte *pubkey);
+void x25519_init(X25519Ctx *ctx, const Byte *sk, const Byte *pk);
+int  x25519_step(X25519Ctx *ctx, int n);
+int  x25519_final(Byte *shared, X25519Ctx *ctx);
+
+#endif
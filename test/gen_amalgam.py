@@ -0,0 +1,161 @@
+###############################################################################
+###### Generation of the Single-Translation-Unit Amalgamation of Micro25519 ###
+###############################################################################
+
+# Usage: python3 gen_amalgam.py [--check]
+# The header files and C source files in `../src` (including `simd` and
+# `host64`) are concatenated into `../src/amalgam/micro25519_all.h` and
+# `../src/amalgam/micro25519_all.c`. With `--check`, nothing is written and
+# the exit status is 1 when the amalgamation is out of date. The script has
+# to be re-run after every change of the sources (including `config.h`).
+
+import os
+import re
+import sys
+
+SRCDIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src")
+OUTDIR = os.path.join(SRCDIR, "amalgam")
+
+# Header files in the order of their first inclusion (headers included by
+# another header are placed before it) and C source files in an order in
+# which the short helper functions are defined before their first use
+HEADERS = ["config.h", "profile.h", "backend.h", "mpiarith.h", "gfparith.h",
+           "gfparith4.h", "moncurve.h", "tedcurve.h", "x25519.h", "ed25519.h"]
+SOURCES = ["profile.c", "mpiarith.c", "gfparith.c", "host64/gfparith51.c",
+           "gfparith4.c", "simd/gfparith4_avx2.c", "simd/gfparith4_neon.c",
+           "backend.c", "moncurve.c", "tedcurve.c", "x25519.c", "ed25519.c"]
+
+# Short functions whose C definitions get the `M25519_INLINE` specifier so
+# that the compiler can inline them into the point arithmetic
+INLINE = ["mpi_copy", "mpi_setw", "mpi_cmpw", "gfp_add", "gfp_sub",
+          "gfp_add_nr", "gfp_sub_nr", "gfp_cneg", "gfp_hlv", "gfp_cswap"]
+
+LOCALINC = re.compile(r'^\s*#\s*include\s+"([^"]+)"')
+DEFINE = re.compile(r'^\s*#\s*define\s+(\w+)')
+FUNCDEF = re.compile(r'^(void|int)\s+(\(?)(\w+)(\)?)\s*\(')
+
+
+def header_line(text):
+    return "// " + text.ljust(73) + " //\n"
+
+
+def banner(filename, title):
+    text = "/" * 79 + "\n"
+    text += header_line(filename + ": " + title)
+    text += header_line("This file is part of Micro25519, a lightweight implementation of X25519")
+    text += header_line("key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.")
+    text += header_line("DO NOT EDIT: generated by `test/gen_amalgam.py` from the files in `src`.")
+    text += header_line("License: GPLv3 (see LICENSE file), other licenses available upon request.")
+    text += "/" * 79 + "\n\n"
+    return text
+
+
+def section_line(filename):
+    return "/" * 79 + "\n" + header_line("src/" + filename) + "/" * 79 + "\n"
+
+
+def read_body(filename):
+    with open(os.path.join(SRCDIR, filename)) as f:
+        lines = f.readlines()
+    # Skip the banner with the license (up to the second line of slashes)
+    if lines and lines[0].startswith("////"):
+        end = next(i for i in range(1, len(lines)) if lines[i].startswith("////"))
+        lines = lines[end+1:]
+    return lines
+
+
+def static_names(lines):
+    names = set()
+    for line in lines:
+        if not line.startswith("static "):
+            continue
+        line = re.sub(r'\(\s*\*\s*(\w+)\s*\)', r'\1', line[len("static "):])
+        m = re.search(r'\b(\w+)\s*[\[(=;]', line)
+        if m:
+            names.add(m.group(1))
+    return names
+
+
+def gen_header():
+    text = banner("micro25519_all.h", "All header files of Micro25519 (amalgamation).")
+    text += "#ifndef _MICRO25519_ALL_H\n#define _MICRO25519_ALL_H\n\n"
+    for hfile in HEADERS:
+        text += section_line(hfile) + "\n"
+        for line in read_body(hfile):
+            if LOCALINC.match(line):
+                continue
+            text += line
+        text += "\n"
+    text += "#endif\n"
+    return text
+
+
+def gen_source():
+    bodies = [read_body(cfile) for cfile in SOURCES]
+    # Names of static objects and functions that are defined in more than one
+    # source file are prefixed with the name of the file
+    count = {}
+    for body in bodies:
+        for name in static_names(body):
+            count[name] = count.get(name, 0) + 1
+    text = banner("micro25519_all.c", "All C source files of Micro25519 (amalgamation).")
+    text += "#include \"micro25519_all.h\"\n\n"
+    text += "// Specifier for short functions that should be inlined into their callers\n"
+    text += "#ifndef M25519_INLINE\n#define M25519_INLINE inline\n#endif\n\n"
+    for cfile, body in zip(SOURCES, bodies):
+        stem = os.path.splitext(os.path.basename(cfile))[0]
+        clash = sorted(n for n in static_names(body) if count[n] > 1)
+        macros = []
+        text += "\n" + section_line(cfile) + "\n"
+        for name in clash:
+            text += "#define " + name + " " + stem + "_" + name + "\n"
+        for line in body:
+            m = LOCALINC.match(line)
+            if m:
+                if os.path.basename(m.group(1)) in HEADERS:
+                    continue
+                # headers that belong to a single source file are inlined
+                for hline in read_body(os.path.basename(m.group(1))):
+                    if not LOCALINC.match(hline):
+                        text += hline
+                continue
+            m = DEFINE.match(line)
+            if m and (m.group(1) not in macros):
+                macros.append(m.group(1))
+            m = FUNCDEF.match(line)
+            if m and (m.group(3) in INLINE):
+                line = "M25519_INLINE " + line
+            text += line
+        # macros and renamings of a source file must not leak into the next
+        undefs = [n for n in macros] + clash
+        if undefs:
+            text += "\n"
+        for name in undefs:
+            text += "#undef " + name + "\n"
+    return text
+
+
+def main():
+    check = (len(sys.argv) > 1) and (sys.argv[1] == "--check")
+    outputs = [("micro25519_all.h", gen_header()), ("micro25519_all.c", gen_source())]
+    stale = 0
+    for outname, text in outputs:
+        outpath = os.path.join(OUTDIR, outname)
+        if check:
+            try:
+                with open(outpath) as f:
+                    if f.read() != text:
+                        stale = 1
+            except OSError:
+                stale = 1
+            continue
+        with open(outpath, "w") as f:
+            f.write(text)
+        print("amalgamation written to", os.path.normpath(outpath))
+    if check:
+        print("amalgamation is", "out of date" if stale else "up to date")
+    sys.exit(stale)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,104 @@
+###############################################################################
+###### Generation of the Pre-Computed Table for the Fixed-Base Comb Method ####
+###############################################################################
+
+# Usage: python3 gentbl_ted_comb.py [teeth] [tables]
+# The table is written to `../src/tedcomb.h` and must match the values of
+# `M25519_COMB_TEETH` and `M25519_COMB_TABLES` in `config.h` (the defaults
+# are 4 teeth and 1 table).
+
+import sys
+
+# Define the prime p, the group order l and the curve parameter d
+p = 2**255 - 19
+l = 2**252 + 27742317777372353535851937790883648493
+d = (-121665 * pow(121666, -1, p)) % p
+
+# Define the generator G of Edwards25519 with y = 4/5
+gy = (4 * pow(5, -1, p)) % p
+gx = pow((gy * gy - 1) * pow(d * gy * gy + 1, -1, p), (p + 3)//8, p)
+if ((gx * gx * (d * gy * gy + 1) - (gy * gy - 1)) % p != 0):
+    gx = (gx * pow(2, (p - 1)//4, p)) % p
+if (gx % 2 == 1): gx = p - gx
+G = (gx, gy)
+
+# Bitlength of the recoded scalars processed by the comb method
+SCALARBITS = 254
+
+
+def ted_add(P, Q):
+    x1, y1 = P
+    x2, y2 = Q
+    t = (d * x1 * x2 * y1 * y2) % p
+    x3 = ((x1 * y2 + x2 * y1) * pow(1 + t, -1, p)) % p
+    y3 = ((y1 * y2 + x1 * x2) * pow(1 - t, -1, p)) % p
+    return (x3, y3)
+
+
+def ted_mul(k, P):
+    R = (0, 1)
+    while (k > 0):
+        if (k & 1): R = ted_add(R, P)
+        P = ted_add(P, P)
+        k >>= 1
+    return R
+
+
+def header_line(text):
+    return "// " + text.ljust(73) + " //\n"
+
+
+def gentbl_ted_comb(tblfilename, teeth, tables):
+    spacing = (SCALARBITS + teeth*tables - 1)//(teeth*tables)
+    numpts = 1 << (teeth - 1)
+    inv2 = pow(2, -1, p)
+    # Open the output file
+    with open(tblfilename, "w") as tblfile:
+        tblfile.write("/" * 79 + "\n")
+        tblfile.write(header_line("tedcomb.h: Pre-computed table for the fixed-base comb method."))
+        tblfile.write(header_line("This file is part of Micro25519, a lightweight implementation of X25519"))
+        tblfile.write(header_line("key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers."))
+        tblfile.write(header_line("Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates."))
+        tblfile.write(header_line("License: GPLv3 (see LICENSE file), other licenses available upon request."))
+        tblfile.write(header_line("Author: Johann Groszschaedl (in personal capacity)."))
+        tblfile.write("// " + "-" * 73 + " //\n")
+        tblfile.write(header_line("This file has been generated by `test/gentbl_ted_comb.py`, do not edit."))
+        tblfile.write("/" * 79 + "\n\n")
+        tblfile.write("#ifndef _TEDCOMB_H\n#define _TEDCOMB_H\n\n")
+        tblfile.write("#include \"config.h\"\n\n")
+        tblfile.write("// Number of teeth and number of tables of the comb method\n\n")
+        tblfile.write(f"#define TEDCOMB_TEETH {teeth}\n")
+        tblfile.write(f"#define TEDCOMB_TABLES {tables}\n\n")
+        tblfile.write(f"// Table T_b[x] = 2^({teeth*spacing}*b)*(G + sum_i (-1)^(1-x_i)*2^({spacing}*i)*G)\n")
+        tblfile.write(f"// with i = 1, ..., {teeth-1} and x_i = bit i-1 of x in extended affine (u,v,w)\n")
+        tblfile.write(f"// coordinates ({tables*numpts} points, {tables*numpts*96} bytes)\n\n")
+        tblfile.write(f"static const Word TEDCOMBTBL[{tables*numpts}*3*LEN] = {{\n")
+        entries = []
+        for b in range(0, tables):
+            for x in range(0, numpts):
+                k = 1
+                for i in range(1, teeth):
+                    k += (1 if ((x >> (i - 1)) & 1) else -1) * 2**(spacing*i)
+                k = (k * 2**(teeth*spacing*b)) % l
+                px, py = ted_mul(k, G)
+                u = ((px + py) * inv2) % p
+                v = ((py - px) * inv2) % p
+                w = (d * px * py) % p
+                lines = []
+                for c in (u, v, w):
+                    words = [f"0x{(c >> (32*j)) & 0xFFFFFFFF:08X}" for j in range(0, 8)]
+                    lines.append("  " + ", ".join(words[0:4]))
+                    lines.append("  " + ", ".join(words[4:8]))
+                entries.append(f"  // T_{b}[{x}]\n" + ",\n".join(lines))
+        tblfile.write(",\n".join(entries))
+        tblfile.write("\n};\n\n#endif\n")
+        tblfile.close()
+    print(f"table with {tables*numpts} points written to {tblfilename}")
+
+
+if __name__ == "__main__":
+    teeth = int(sys.argv[1]) if (len(sys.argv) > 1) else 4
+    tables = int(sys.argv[2]) if (len(sys.argv) > 2) else 1
+    if (teeth < 2) or (teeth > 8) or (tables < 1) or (teeth*tables > 32):
+        sys.exit("teeth must be in [2, 8] and teeth*tables at most 32")
+    gentbl_ted_comb("../src/tedcomb.h", teeth, tables)
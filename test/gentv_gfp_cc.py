@@ -145,6 +145,19 @@ def gentv_gfp_cneg(tvfilename):
     print(f"{numtv} corner-case test-vectors written to {tvfilename}")
 
 
+def gentv_gfp_inv(tvfilename):
+    numtv = 0
+    with open(tvfilename, "w") as tvfile:
+        tvfile.write("# Corner-Case Test-Vectors (CCTV) for Modular Inversion\n")
+        for idx1, op1 in enumerate(operands):
+            res = pow(op1, -1, p) if (op1 % p) != 0 else 0
+            tvfile.write(f"op1: 0x{op1:064X}\n")
+            tvfile.write(f"res: 0x{res:064X}\n")
+            numtv += 1
+        tvfile.close()
+    print(f"{numtv} corner-case test-vectors written to {tvfilename}")
+
+
 if __name__ == "__main__":
     gentv_gfp_add("gfp_add_cc.tv")
     gentv_gfp_sub("gfp_sub_cc.tv")
@@ -153,3 +166,4 @@ if __name__ == "__main__":
     gentv_gfp_sqr("gfp_sqr_cc.tv")
     gentv_gfp_hlv("gfp_hlv_cc.tv")
     gentv_gfp_cneg("gfp_cneg_cc.tv")
+    gentv_gfp_inv("gfp_inv_cc.tv")
@@ -120,6 +120,20 @@ def gentv_gfp_cneg(tvfilename, numtv):
     print(f"{numtv} pseudo-random test-vectors written to {tvfilename}")
 
 
+def gentv_gfp_inv(tvfilename, numtv):
+    res1 = op1
+    # Open the output file
+    with open(tvfilename, "w") as tvfile:
+        tvfile.write("# Pseudo-Random Test-Vectors (PRTV) for Modular Inversion\n")
+        for idx in range (0, numtv):
+            tvfile.write(f"op1: 0x{res1:064X}\n")
+            res1 = pow(res1, -1, p)
+            tvfile.write(f"res: 0x{res1:064X}\n")
+            res1 = (res1 * res1 + op2) % p
+        tvfile.close()
+    print(f"{numtv} pseudo-random test-vectors written to {tvfilename}")
+
+
 if __name__ == "__main__":
     gentv_gfp_add("gfp_add_pr.tv", 1000)
     gentv_gfp_sub("gfp_sub_pr.tv", 1000)
@@ -128,3 +142,4 @@ if __name__ == "__main__":
     gentv_gfp_sqr("gfp_sqr_pr.tv", 1000)
     gentv_gfp_hlv("gfp_hlv_pr.tv", 1000)
     gentv_gfp_cneg("gfp_cneg_pr.tv", 1000)
+    gentv_gfp_inv("gfp_inv_pr.tv", 1000)
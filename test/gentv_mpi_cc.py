@@ -0,0 +1,110 @@
+###############################################################################
+##### Generation of Corner-Case Test-Vectors (CCTV) for Order Arithmetic ######
+###############################################################################
+
+# Define the group order l and the modulus m = 8*l of the Barrett reduction
+l = 2**252 + 27742317777372353535851937790883648493
+m = 8*l
+
+# Define corner-case operands of a length of 8 words
+operands8 = [
+    0,                                  # 0
+    1,                                  # 1
+    2,                                  # 2
+    2**256 - 1,                         # all words 0xFFFFFFFF
+    2**256 - 2,                         # all-1 except LSB
+    2**255,                             # MSB set, rest 0
+    2**255 - 1,                         # MSB cleared, rest 1
+    2**32 - 1,                          # a[0] = 0xFFFFFFFF, rest 0
+    2**256 - 2**32,                     # a[0] = 0, rest 0xFFFFFFFF
+    2**224 - 1,                         # a[7] = 0, rest 0xFFFFFFFF
+    2**256 - 2**224,                    # a[7] = 0xFFFFFFFF, rest 0
+    2**224 - 2**32,                     # a[0] = a[7] = 0, rest 0xFFFFFFFF
+    2**256 - (2**224 - 2**32) - 1,      # a[0] = a[7] = 0xFFFFFFFF, rest 0
+    0x5555555555555555555555555555555555555555555555555555555555555555,
+    0xAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA,
+    l,                                  # l
+    l - 1,                              # l-1
+    m,                                  # 8l
+    m - 1,                              # 8l-1
+    2**256 - m,                         # c = 2^256 - 8l
+    0x0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF,
+    0x89ABCDEF0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF01234567,
+]
+
+# Define corner-case operands of a length of 9 words
+operands9 = [
+    0,                                  # 0
+    1,                                  # 1
+    2**288 - 1,                         # all words 0xFFFFFFFF
+    2**287,                             # MSB set, rest 0
+    2**256,                             # a[8] = 1, rest 0
+    2**257 - 1,                         # a[8] = 1, rest 0xFFFFFFFF
+    2**256 - 1,                         # a[8] = 0, rest 0xFFFFFFFF
+    2**288 - 2**256,                    # a[8] = 0xFFFFFFFF, rest 0
+    2**32 - 1,                          # a[0] = 0xFFFFFFFF, rest 0
+    2**288 - 2**32,                     # a[0] = 0, rest 0xFFFFFFFF
+    2**512 // m,                        # mu = floor(2^512/(8l))
+    m,                                  # 8l
+    0x0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF01234567,
+    0x89ABCDEF0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF,
+]
+
+
+def gentv_mpi_mul8(tvfilename):
+    numtv = 0
+    with open(tvfilename, "w") as tvfile:
+        tvfile.write("# Corner-Case Test-Vectors (CCTV) for 8-Word Multiplication\n")
+        for idx1, op1 in enumerate(operands8):
+            for idx2, op2 in enumerate(operands8):
+                res = op1 * op2
+                tvfile.write(f"op1: 0x{op1:064X}\n")
+                tvfile.write(f"op2: 0x{op2:064X}\n")
+                tvfile.write(f"res: 0x{res:0128X}\n")
+                numtv += 1
+        tvfile.close()
+    print(f"{numtv} corner-case test-vectors written to {tvfilename}")
+
+
+def gentv_mpi_mul9(tvfilename):
+    numtv = 0
+    with open(tvfilename, "w") as tvfile:
+        tvfile.write("# Corner-Case Test-Vectors (CCTV) for 9-Word Multiplication\n")
+        for idx1, op1 in enumerate(operands9):
+            for idx2, op2 in enumerate(operands9):
+                res = op1 * op2
+                tvfile.write(f"op1: 0x{op1:072X}\n")
+                tvfile.write(f"op2: 0x{op2:072X}\n")
+                tvfile.write(f"res: 0x{res:0144X}\n")
+                numtv += 1
+        tvfile.close()
+    print(f"{numtv} corner-case test-vectors written to {tvfilename}")
+
+
+def gentv_mod_order(tvfilename):
+    numtv = 0
+    with open(tvfilename, "w") as tvfile:
+        tvfile.write("# Corner-Case Test-Vectors (CCTV) for Reduction modulo Order\n")
+        # products of two operands cover the 512-bit range (including the
+        # maximum 2^512 - 1 and multiples of 8l around the quotient limits)
+        for idx1, op1 in enumerate(operands8):
+            for idx2, op2 in enumerate(operands8):
+                if idx2 < idx1: continue
+                op = op1 * op2
+                res = op % m
+                tvfile.write(f"op1: 0x{op:0128X}\n")
+                tvfile.write(f"res: 0x{res:064X}\n")
+                numtv += 1
+        for op in [2**512 - 1, 2**511, m*2**256 - 1, m*(2**256 - 1)]:
+            res = op % m
+            tvfile.write(f"op1: 0x{op:0128X}\n")
+            tvfile.write(f"res: 0x{res:064X}\n")
+            numtv += 1
+        tvfile.close()
+    print(f"{numtv} corner-case test-vectors written to {tvfilename}")
+
+
+if __name__ == "__main__":
+    gentv_mpi_mul8("mpi_mul8_cc.tv")
+    gentv_mpi_mul9("mpi_mul9_cc.tv")
+    gentv_mod_order("mod_order_cc.tv")
@@ -0,0 +1,73 @@
+###############################################################################
+#### Generation of Pseudo-Random Test-Vectors (PRTV) for Order Arithmetic #####
+###############################################################################
+
+# Define the group order l and the modulus m = 8*l of the Barrett reduction
+l = 2**252 + 27742317777372353535851937790883648493
+m = 8*l
+
+# Define "pseudo-random" start operands
+op1 = 0x0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF
+op2 = 0x76543210FEDCBA9876543210FEDCBA9876543210FEDCBA9876543210FEDCBA98
+
+
+def gentv_mpi_mul8(tvfilename, numtv):
+    res1 = op1
+    res2 = op2
+    # Open the output file
+    with open(tvfilename, "w") as tvfile:
+        tvfile.write("# Pseudo-Random Test-Vectors (PRTV) for 8-Word Multiplication\n")
+        for idx in range (0, numtv):
+            res = res1 * res2
+            tvfile.write(f"op1: 0x{res1:064X}\n")
+            tvfile.write(f"op2: 0x{res2:064X}\n")
+            tvfile.write(f"res: 0x{res:0128X}\n")
+            # next operands are the middle part of the product and the XOR
+            # of the upper and lower half of the product plus 1
+            res1 = (res >> 128) % 2**256
+            res2 = (((res >> 256) ^ res) + 1) % 2**256
+        tvfile.close()
+    print(f"{numtv} pseudo-random test-vectors written to {tvfilename}")
+
+
+def gentv_mpi_mul9(tvfilename, numtv):
+    res1 = op1 << 32 | op2 >> 224
+    res2 = op2 << 32 | op1 >> 224
+    # Open the output file
+    with open(tvfilename, "w") as tvfile:
+        tvfile.write("# Pseudo-Random Test-Vectors (PRTV) for 9-Word Multiplication\n")
+        for idx in range (0, numtv):
+            res = res1 * res2
+            tvfile.write(f"op1: 0x{res1:072X}\n")
+            tvfile.write(f"op2: 0x{res2:072X}\n")
+            tvfile.write(f"res: 0x{res:0144X}\n")
+            # next operands are the middle part of the product and the XOR
+            # of the upper and lower half of the product plus 1
+            res1 = (res >> 144) % 2**288
+            res2 = (((res >> 288) ^ res) + 1) % 2**288
+        tvfile.close()
+    print(f"{numtv} pseudo-random test-vectors written to {tvfilename}")
+
+
+def gentv_mod_order(tvfilename, numtv):
+    res1 = op1
+    res2 = op2
+    # Open the output file
+    with open(tvfilename, "w") as tvfile:
+        tvfile.write("# Pseudo-Random Test-Vectors (PRTV) for Reduction modulo Order\n")
+        for idx in range (0, numtv):
+            op = (res1 << 256) | res2
+            res = op % m
+            tvfile.write(f"op1: 0x{op:0128X}\n")
+            tvfile.write(f"res: 0x{res:064X}\n")
+            # next operand consists of the square of the result and the sum
+            # of the result and the previous upper half
+            res1, res2 = (res * res) % 2**256, (res + res1) % 2**256
+        tvfile.close()
+    print(f"{numtv} pseudo-random test-vectors written to {tvfilename}")
+
+
+if __name__ == "__main__":
+    gentv_mpi_mul8("mpi_mul8_pr.tv", 1000)
+    gentv_mpi_mul9("mpi_mul9_pr.tv", 1000)
+    gentv_mod_order("mod_order_pr.tv", 1000)
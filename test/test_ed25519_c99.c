@@ -0,0 +1,830 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_ed25519_c99.c: Unit tests for C99 implementation of Ed25519.         //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdio.h>
+#include <string.h>
+#include "../src/mpiarith.h"
+#include "../src/x25519.h"
+#include "../src/ed25519.h"
+
+
+// Number of test-vectors; only the first `NUMVALID` have a valid signature
+
+#define NUMTV 6
+#define NUMVALID 3
+
+// Number of repetitions of the test-vectors so that a batch consists of more
+// than `ED25519_MAXBATCH` signatures (i.e., of several groups)
+
+#define NUMREP 8
+
+// Public keys, messages and signatures; the first three test-vectors are
+// TEST 1, TEST 2 and TEST 3 from Section 7.1 of RFC 8032. The fourth has the
+// signature of TEST 2 with a modified message, the fifth has the signature of
+// TEST 1 with $s + \ell$ instead of $s$, and the sixth has a public key that
+// can not be decompressed.
+
+static const char *tvpub[NUMTV] = {
+  "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a",
+  "3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c",
+  "fc51cd8e6218a1a38da47ed00230f0580816ed13ba3303ac5deb911548908025",
+  "3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c",
+  "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a",
+  "0200000000000000000000000000000000000000000000000000000000000000"
+};
+
+static const char *tvmsg[NUMTV] = { "", "72", "af82", "73", "", "" };
+
+static const char *tvsig[NUMTV] = {
+  "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e06522490155"
+  "5fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b",
+  "92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da"
+  "085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00",
+  "6291d657deec24024827e69c3abe01a30ce548a284743a445e3680d7db5ac3ac"
+  "18ff9b538d16f290ae67f760984dc6594a7c15e9716ed28dc027beceea1ec40a",
+  "92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da"
+  "085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00",
+  "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e06522490155"
+  "4c8c7872aa064e049dbb3013fbf29380d25bf5f0595bbe24655141438e7a101b",
+  "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e06522490155"
+  "5fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b"
+};
+
+static const int tverr[NUMTV] = { M25519_NO_ERROR, M25519_NO_ERROR, \
+  M25519_NO_ERROR, M25519_ERR_SIGVER, M25519_ERR_SIGVER, M25519_ERR_DECOMP };
+
+
+// Secret keys of TEST 1, TEST 2 and TEST 3 (their public keys are the first
+// three entries of `tvpub`)
+
+static const char *tvsec[NUMVALID] = {
+  "9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60",
+  "4ccd089b28ff96da9db6c346ec114e0f5b8a319f35aba624da8cf6ed4fb8a6fb",
+  "c5aa8df43f9f837bedb7442f31dcb7b166d38535076f094b85ce3a2e0b4458f7"
+};
+
+// Scalars (as big-endian hex-strings) for the fixed-base scalar multiplication
+// and the expected compressed results: $1$, $\ell - 1$, $2^{256} - 1$,
+// $2^{255} + 12345$, $0$ and $\ell$ (the last two are invalid)
+
+#define NUMSCL 6
+
+static const char *tvscl[NUMSCL] = {
+  "0x0000000000000000000000000000000000000000000000000000000000000001",
+  "0x1000000000000000000000000000000014DEF9DEA2F79CD65812631A5CF5D3EC",
+  "0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF",
+  "0x8000000000000000000000000000000000000000000000000000000000003039",
+  "0x0000000000000000000000000000000000000000000000000000000000000000",
+  "0x1000000000000000000000000000000014DEF9DEA2F79CD65812631A5CF5D3ED"
+};
+
+static const char *tvmul[NUMSCL] = {
+  "5866666666666666666666666666666666666666666666666666666666666666",
+  "58666666666666666666666666666666666666666666666666666666666666e6",
+  "db27fe4b7a4beb8c1b8c38a21e943a852304c9bb3035a5f36626b51162a68f9c",
+  "a9f88807a49c2a14497f5f2d05c19acca4deb0c3a424e8c36f091b3a56ace3b8",
+  "", ""
+};
+
+static const int tvmulerr[NUMSCL] = { M25519_NO_ERROR, M25519_NO_ERROR, \
+  M25519_NO_ERROR, M25519_NO_ERROR, M25519_ERR_SCALAR, M25519_ERR_TPOINT };
+
+// $y$-coordinate $p - 1$ of the point $(0,-1)$ of order 2
+static const char *tvlow = \
+  "0x7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEC";
+
+
+static size_t bytes_from_hex(Byte *r, const char *hexstr)
+{
+  unsigned int val;
+  size_t i, len = strlen(hexstr)/2;
+  
+  for (i = 0; i < len; i++) {
+    sscanf(&hexstr[2*i], "%2x", &val);
+    r[i] = (Byte) val;
+  }
+  
+  return len;
+}
+
+
+static void words_from_bytes(Word *r, const Byte *a)
+{
+  int i;
+  
+  for (i = 0; i < LEN; i++) {
+    r[i] = ((Word) a[4*i]) | (((Word) a[4*i+1]) << 8) | \
+      (((Word) a[4*i+2]) << 16) | (((Word) a[4*i+3]) << 24);
+  }
+}
+
+
+// The public keys of TEST 1 to TEST 3 are re-computed as $A = a G$ with the
+// pruned hash $a$ of the secret key, and six further scalars (including two
+// invalid ones) are multiplied by $G$.
+
+int test_ted_mul_fixbase(void)
+{
+  Byte sec[32], dig[64], exp[32];
+  Word l[LEN], r[2*LEN], c[LEN], e[LEN];
+  Point rp = { 2, r };
+  int numtv = 0, wrongtv = 0, i, err, experr;
+  
+  printf("Testing ted_mul_fixbase() with test-vectors ...\n");
+  
+  for (i = 0; i < NUMVALID + NUMSCL; i++) {
+    if (i < NUMVALID) {
+      bytes_from_hex(sec, tvsec[i]);
+      sha512_hash(dig, sec, 32);
+      dig[0] &= 0xF8;
+      dig[31] = (dig[31] & 0x7F) | 0x40;
+      words_from_bytes(l, dig);
+      bytes_from_hex(exp, tvpub[i]);
+      experr = M25519_NO_ERROR;
+    } else {
+      mpi_from_hex(l, tvscl[i-NUMVALID], LEN);
+      bytes_from_hex(exp, tvmul[i-NUMVALID]);
+      experr = tvmulerr[i-NUMVALID];
+    }
+    err = ted_mul_fixbase(&rp, l, &ECDOMPAR25519);
+    if (err == M25519_NO_ERROR) {
+      ted_compress(c, &rp);
+      words_from_bytes(e, exp);
+      if (mpi_cmp(c, e, LEN) != 0) err = -1;
+    }
+    if (err != experr) {
+      printf("Testvector verification failed !!!\n");
+      printf("Exp Result: %i\n", experr);
+      printf("Act Result: %i\n", err);
+      wrongtv++;
+    }
+    numtv++;
+  }
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+// The same scalars as in `test_ted_mul_fixbase` are multiplied by $G$ with
+// `ted_mul_varbase`, the valid ones are also computed as $(l + k) G - k G$
+// with `ted_mul_dblbase`, and $1 \cdot (0,-1)$ is rejected since $(0,-1)$ has
+// low order. The $y$-coordinate of the base point of `ted_mul_dblbase` is
+// incompletely reduced (i.e., $y + p$) to check that such inputs are handled
+// properly.
+
+int test_ted_mul_varbase(void)
+{
+  Byte sec[32], dig[64], exp[32];
+  Word l[LEN], k[LEN], g[2*LEN], h[2*LEN], r[2*LEN], c[LEN], e[LEN];
+  Point gp = { 2, g }, hp = { 2, h }, rp = { 2, r };
+  int numtv = 0, wrongtv = 0, i, err, experr;
+  
+  printf("Testing ted_mul_varbase() and ted_mul_dblbase() ...\n");
+  
+  bytes_from_hex(exp, tvmul[0]);
+  words_from_bytes(c, exp);
+  ted_decompress(&gp, c, &ECDOMPAR25519);
+  mpi_copy(h, g, 2*LEN);
+  gfp_setp(c);
+  mpi_add(&h[LEN], &h[LEN], c, LEN);  // y + p < 2^256
+  mpi_from_hex(k, tvscl[3], LEN);
+  for (i = 0; i < 2*(NUMVALID + NUMSCL) + 1; i++) {
+    if ((i % (NUMVALID + NUMSCL)) < NUMVALID) {
+      bytes_from_hex(sec, tvsec[i%(NUMVALID+NUMSCL)]);
+      sha512_hash(dig, sec, 32);
+      dig[0] &= 0xF8;
+      dig[31] = (dig[31] & 0x7F) | 0x40;
+      words_from_bytes(l, dig);
+      bytes_from_hex(exp, tvpub[i%(NUMVALID+NUMSCL)]);
+      experr = M25519_NO_ERROR;
+    } else {
+      mpi_from_hex(l, tvscl[(i%(NUMVALID+NUMSCL))-NUMVALID], LEN);
+      bytes_from_hex(exp, tvmul[(i%(NUMVALID+NUMSCL))-NUMVALID]);
+      experr = tvmulerr[(i%(NUMVALID+NUMSCL))-NUMVALID];
+    }
+    if (i < NUMVALID + NUMSCL) {
+      err = ted_mul_varbase(&rp, l, &gp, &ECDOMPAR25519);
+    } else if (i == 2*(NUMVALID + NUMSCL)) {  // P = (0,-1) has order 2
+      mpi_setw(r, 0, LEN);
+      mpi_from_hex(&r[LEN], tvlow, LEN);
+      err = ted_mul_varbase(&rp, l, &rp, &ECDOMPAR25519);
+      experr = M25519_ERR_TPOINT;
+    } else if (experr == M25519_NO_ERROR) {
+      ed25519_add_order(l, l, k, &ECDOMPAR25519);
+      err = ted_mul_dblbase(&rp, l, k, &hp, &ECDOMPAR25519);
+    } else {
+      continue;
+    }
+    if (err == M25519_NO_ERROR) {
+      ted_compress(c, &rp);
+      words_from_bytes(e, exp);
+      if (mpi_cmp(c, e, LEN) != 0) err = -1;
+    }
+    if (err != experr) {
+      printf("Testvector verification failed !!!\n");
+      printf("Exp Result: %i\n", experr);
+      printf("Act Result: %i\n", err);
+      wrongtv++;
+    }
+    numtv++;
+  }
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+// The scalars of `test_ted_mul_fixbase` are multiplied by $G$ with the
+// resumable fixed-base scalar multiplication, and the valid ones are also
+// computed as $(l + k) G - k G$ with the resumable double-base scalar
+// multiplication. The number of steps per call differs from scalar to scalar,
+// and a premature call of the final functions must be rejected.
+
+int test_ted_mul_step(void)
+{
+  TedFixCtx fctx;
+  TedDblCtx dctx;
+  Byte sec[32], dig[64], exp[32];
+  Word l[LEN], k[LEN], g[2*LEN], r[2*LEN], c[LEN], e[LEN];
+  Point gp = { 2, g }, rp = { 2, r };
+  int numtv = 0, wrongtv = 0, i, n, err, experr;
+  
+  printf("Testing ted_mul_fixbase_step() and ted_mul_dblbase_step() ...\n");
+  
+  bytes_from_hex(exp, tvmul[0]);
+  words_from_bytes(c, exp);
+  ted_decompress(&gp, c, &ECDOMPAR25519);
+  mpi_from_hex(k, tvscl[3], LEN);
+  for (i = 0; i < 2*(NUMVALID + NUMSCL); i++) {
+    if ((i % (NUMVALID + NUMSCL)) < NUMVALID) {
+      bytes_from_hex(sec, tvsec[i%(NUMVALID+NUMSCL)]);
+      sha512_hash(dig, sec, 32);
+      dig[0] &= 0xF8;
+      dig[31] = (dig[31] & 0x7F) | 0x40;
+      words_from_bytes(l, dig);
+      bytes_from_hex(exp, tvpub[i%(NUMVALID+NUMSCL)]);
+      experr = M25519_NO_ERROR;
+    } else {
+      mpi_from_hex(l, tvscl[(i%(NUMVALID+NUMSCL))-NUMVALID], LEN);
+      bytes_from_hex(exp, tvmul[(i%(NUMVALID+NUMSCL))-NUMVALID]);
+      experr = tvmulerr[(i%(NUMVALID+NUMSCL))-NUMVALID];
+    }
+    n = 1 + 5*(i % 4);
+    if (i < NUMVALID + NUMSCL) {
+      err = ted_mul_fixbase_init(&fctx, l, &ECDOMPAR25519);
+      while (ted_mul_fixbase_step(&fctx, n, &ECDOMPAR25519) > 0);
+      if (err == M25519_NO_ERROR) err = ted_mul_fixbase_final(&rp, &fctx, \
+        &ECDOMPAR25519);
+    } else if (experr == M25519_NO_ERROR) {
+      ed25519_add_order(l, l, k, &ECDOMPAR25519);
+      err = ted_mul_dblbase_init(&dctx, l, k, &gp, &ECDOMPAR25519);
+      while (ted_mul_dblbase_step(&dctx, n, &ECDOMPAR25519) > 0);
+      if (err == M25519_NO_ERROR) err = ted_mul_dblbase_final(&rp, &dctx, \
+        &ECDOMPAR25519);
+      // the context must be invalid after the final function
+      if ((ted_mul_dblbase_step(&dctx, n, &ECDOMPAR25519) != 0) || \
+          (ted_mul_dblbase_final(&rp, &dctx, &ECDOMPAR25519) != \
+          M25519_ERR_STREAM)) wrongtv++;
+    } else {
+      continue;
+    }
+    if (err == M25519_NO_ERROR) {
+      ted_compress(c, &rp);
+      words_from_bytes(e, exp);
+      if (mpi_cmp(c, e, LEN) != 0) err = -1;
+    }
+    if (err != experr) {
+      printf("Testvector verification failed !!!\n");
+      printf("Exp Result: %i\n", experr);
+      printf("Act Result: %i\n", err);
+      wrongtv++;
+    }
+    numtv++;
+  }
+  
+  ted_mul_fixbase_init(&fctx, l, &ECDOMPAR25519);
+  ted_mul_fixbase_step(&fctx, TED_COMBSPACE - 1, &ECDOMPAR25519);
+  if (ted_mul_fixbase_final(&rp, &fctx, &ECDOMPAR25519) != M25519_ERR_STREAM)
+    wrongtv++;
+  ted_mul_dblbase_init(&dctx, l, k, &gp, &ECDOMPAR25519);
+  ted_mul_dblbase_step(&dctx, 1, &ECDOMPAR25519);
+  if ((ted_mul_dblbase_final(&rp, &dctx, &ECDOMPAR25519) != \
+      M25519_ERR_STREAM) || (ted_mul_dblbase_step(&dctx, 1, \
+      &ECDOMPAR25519) != 0)) wrongtv++;
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+// The scalars of `test_ted_mul_fixbase` are multiplied by $G$ with the
+// projective-output variants of the fixed-base and variable-base scalar
+// multiplication, and all valid results are compressed with a single call of
+// `ted_compress_batch`, together with an invalid point with $Z = 0$ whose
+// compressed value must be 0.
+
+#define NUMPROJ (2*(NUMVALID + NUMSCL) + 1)
+
+int test_ted_mul_proj(void)
+{
+  Byte sec[32], dig[64], exp[NUMPROJ][32];
+  Word l[LEN], g[2*LEN], c[LEN], e[LEN];
+  Word xyz[NUMPROJ][6*LEN], cmp[NUMPROJ*LEN], scr[2*NUMPROJ*LEN];
+  Point gp = { 2, g }, pts[NUMPROJ];
+  int numtv = 0, wrongtv = 0, i, j, n = 0, err, experr;
+  
+  printf("Testing ted_mul_fixbase_proj() and ted_compress_batch() ...\n");
+  
+  bytes_from_hex(exp[0], tvmul[0]);
+  words_from_bytes(c, exp[0]);
+  ted_decompress(&gp, c, &ECDOMPAR25519);
+  for (i = 0; i < 2*(NUMVALID + NUMSCL); i++) {
+    j = i % (NUMVALID + NUMSCL);
+    pts[n].dim = 6;
+    pts[n].xyz = xyz[n];
+    if (j < NUMVALID) {
+      bytes_from_hex(sec, tvsec[j]);
+      sha512_hash(dig, sec, 32);
+      dig[0] &= 0xF8;
+      dig[31] = (dig[31] & 0x7F) | 0x40;
+      words_from_bytes(l, dig);
+      bytes_from_hex(exp[n], tvpub[j]);
+      experr = M25519_NO_ERROR;
+    } else {
+      mpi_from_hex(l, tvscl[j-NUMVALID], LEN);
+      bytes_from_hex(exp[n], tvmul[j-NUMVALID]);
+      experr = tvmulerr[j-NUMVALID];
+    }
+    if (i < NUMVALID + NUMSCL) {
+      err = ted_mul_fixbase_proj(&pts[n], l, &ECDOMPAR25519);
+    } else {
+      err = ted_mul_varbase_proj(&pts[n], l, &gp, &ECDOMPAR25519);
+    }
+    if (err != experr) {
+      printf("Testvector verification failed !!!\n");
+      printf("Exp Result: %i\n", experr);
+      printf("Act Result: %i\n", err);
+      wrongtv++;
+    }
+    if (err == M25519_NO_ERROR) n++;
+    numtv++;
+  }
+  
+  // a point with Z = 0 makes the batch fail, but not the other points
+  pts[n].dim = 6;
+  pts[n].xyz = xyz[n];
+  mpi_setw(xyz[n], 0, 6*LEN);
+  memset(exp[n], 0, 32);
+  n++;
+  err = ted_compress_batch(cmp, pts, n, scr);
+  if (err != M25519_ERR_TPOINT) wrongtv++;
+  for (i = 0; i < n; i++) {
+    words_from_bytes(e, exp[i]);
+    if (mpi_cmp(&cmp[i*LEN], e, LEN) != 0) {
+      printf("Testvector verification failed !!!\n");
+      printf("Point %i of the batch has a wrong compressed value\n", i);
+      wrongtv++;
+    }
+    numtv++;
+  }
+  if (ted_compress_batch(cmp, pts, n - 1, scr) != M25519_NO_ERROR) wrongtv++;
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+// The public keys of the valid test-vectors are computed as projective points
+// with `ted_mul_fixbase_proj` and converted in place to affine coordinates by
+// a single call of `ted_conv_p2a_batch`, together with an invalid point with
+// $Z = 0$ whose coordinates must be 0. The compressed affine points must be
+// equal to the public keys.
+
+int test_ted_conv_p2a_batch(void)
+{
+  Byte sec[32], dig[64], pub[32];
+  Word l[LEN], c[LEN], e[LEN];
+  Word xyz[NUMVALID+1][6*LEN], scr[2*(NUMVALID+1)*LEN];
+  Point pts[NUMVALID+1];
+  int numtv = 0, wrongtv = 0, i, err;
+  
+  printf("Testing ted_conv_p2a_batch() ...\n");
+  
+  for (i = 0; i < NUMVALID; i++) {
+    pts[i].dim = 6;
+    pts[i].xyz = xyz[i];
+    bytes_from_hex(sec, tvsec[i]);
+    sha512_hash(dig, sec, 32);
+    dig[0] &= 0xF8;
+    dig[31] = (dig[31] & 0x7F) | 0x40;
+    words_from_bytes(l, dig);
+    if (ted_mul_fixbase_proj(&pts[i], l, &ECDOMPAR25519) != M25519_NO_ERROR) {
+      wrongtv++;
+    }
+  }
+  pts[NUMVALID].dim = 6;
+  pts[NUMVALID].xyz = xyz[NUMVALID];
+  mpi_setw(xyz[NUMVALID], 1, 6*LEN);
+  mpi_setw(&xyz[NUMVALID][2*LEN], 0, LEN);
+  
+  err = ted_conv_p2a_batch(pts, pts, NUMVALID + 1, scr, &ECDOMPAR25519);
+  if (err != M25519_ERR_TPOINT) wrongtv++;
+  for (i = 0; i < NUMVALID; i++) {
+    ted_compress(c, &pts[i]);
+    bytes_from_hex(pub, tvpub[i]);
+    words_from_bytes(e, pub);
+    if (mpi_cmp(c, e, LEN) != 0) {
+      printf("Testvector verification failed !!!\n");
+      printf("Point %i of the batch has a wrong affine representation\n", i);
+      wrongtv++;
+    }
+    numtv++;
+  }
+  if ((mpi_cmpw(xyz[NUMVALID], 0, LEN) != 0) || \
+      (mpi_cmpw(&xyz[NUMVALID][LEN], 0, LEN) != 0)) wrongtv++;
+  numtv++;
+  err = ted_conv_p2a_batch(pts, pts, NUMVALID, scr, &ECDOMPAR25519);
+  if (err != M25519_NO_ERROR) wrongtv++;
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+int test_ed25519_verify(void)
+{
+  Byte pub[32], msg[2], sig[64];
+  size_t mlen;
+  int numtv = 0, wrongtv = 0, i, err;
+  
+  printf("Testing ed25519_verify() with test-vectors from RFC 8032 ...\n");
+  
+  for (i = 0; i < NUMTV; i++) {
+    bytes_from_hex(pub, tvpub[i]);
+    mlen = bytes_from_hex(msg, tvmsg[i]);
+    bytes_from_hex(sig, tvsig[i]);
+    err = ed25519_verify(sig, msg, mlen, pub);
+    if (err != tverr[i]) {
+      printf("Testvector verification failed !!!\n");
+      printf("Exp Result: %i\n", tverr[i]);
+      printf("Act Result: %i\n", err);
+      wrongtv++;
+    }
+    numtv++;
+  }
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+// A verification context is initialized with the public key of each test-
+// vector (which fails for the sixth one) and then used to verify the
+// signature.
+
+int test_ed25519_verify_ctx(void)
+{
+  static Ed25519VCtx vctx;
+  Byte pub[32], msg[2], sig[64];
+  size_t mlen;
+  int numtv = 0, wrongtv = 0, i, err;
+  
+  printf("Testing ed25519_verify_ctx() with test-vectors from RFC 8032 ...\n");
+  
+  for (i = 0; i < NUMTV; i++) {
+    bytes_from_hex(pub, tvpub[i]);
+    mlen = bytes_from_hex(msg, tvmsg[i]);
+    bytes_from_hex(sig, tvsig[i]);
+    err = ed25519_verify_ctx_init(&vctx, pub);
+    if (err == M25519_NO_ERROR) err = ed25519_verify_ctx(sig, msg, mlen, &vctx);
+    if (err != tverr[i]) {
+      printf("Testvector verification failed !!!\n");
+      printf("Exp Result: %i\n", tverr[i]);
+      printf("Act Result: %i\n", err);
+      wrongtv++;
+    }
+    numtv++;
+  }
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+// The batch is verified twice: first with only the valid signatures (so that
+// the combined check succeeds) and then with all test-vectors (so that the
+// verification falls back to individual checks in each group).
+
+int test_ed25519_verify_batch(void)
+{
+  static Word scratch[ED25519_BATCHWORDS];
+  Byte pub[NUMREP*NUMTV][32], msg[NUMREP*NUMTV][2], sig[NUMREP*NUMTV][64];
+  const Byte *pk[NUMREP*NUMTV], *m[NUMREP*NUMTV], *s[NUMREP*NUMTV];
+  size_t mlen[NUMREP*NUMTV];
+  int err[NUMREP*NUMTV];
+  int numtv = 0, wrongtv = 0, i, n, k;
+  
+  printf("Testing ed25519_verify_batch() with test-vectors from RFC 8032 ...\n");
+  
+  for (n = NUMREP*NUMVALID; n <= NUMREP*NUMTV; n += NUMREP*(NUMTV-NUMVALID)) {
+    k = n/NUMREP;  // number of different test-vectors in the batch
+    for (i = 0; i < n; i++) {
+      bytes_from_hex(pub[i], tvpub[i % k]);
+      mlen[i] = bytes_from_hex(msg[i], tvmsg[i % k]);
+      bytes_from_hex(sig[i], tvsig[i % k]);
+      pk[i] = pub[i];
+      m[i] = msg[i];
+      s[i] = sig[i];
+    }
+    ed25519_verify_batch(s, m, mlen, pk, n, err, scratch);
+    for (i = 0; i < n; i++) {
+      if (err[i] != tverr[i % k]) {
+        printf("Testvector verification failed !!!\n");
+        printf("Exp Result: %i\n", tverr[i % k]);
+        printf("Act Result: %i\n", err[i]);
+        wrongtv++;
+      }
+      numtv++;
+    }
+  }
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+// The signatures of TEST 1 to TEST 3 are re-computed from the key-pairs (i.e.,
+// the secret key followed by the public key) with `ed25519_sign`.
+
+int test_ed25519_sign(void)
+{
+  Byte kp[64], msg[2], sig[64], exp[64];
+  size_t mlen;
+  int numtv = 0, wrongtv = 0, i, err;
+  
+  printf("Testing ed25519_sign() with test-vectors from RFC 8032 ...\n");
+  
+  for (i = 0; i < NUMVALID; i++) {
+    bytes_from_hex(kp, tvsec[i]);
+    bytes_from_hex(&kp[32], tvpub[i]);
+    mlen = bytes_from_hex(msg, tvmsg[i]);
+    bytes_from_hex(exp, tvsig[i]);
+    err = ed25519_sign(sig, msg, mlen, kp);
+    if ((err != M25519_NO_ERROR) || (memcmp(sig, exp, 64) != 0)) {
+      printf("Testvector verification failed !!!\n");
+      printf("Exp Result: %i\n", M25519_NO_ERROR);
+      printf("Act Result: %i\n", (err != M25519_NO_ERROR) ? err : -1);
+      wrongtv++;
+    }
+    numtv++;
+  }
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+// A signing context is initialized with the secret key of TEST 1 to TEST 3
+// (which involves the computation of the public key), stored, loaded again,
+// and used to re-compute the signature. Then it is checked that a wiped
+// context is all-0 and that a serialized context with a scalar that is not
+// pruned is rejected.
+
+int test_ed25519_sign_ctx(void)
+{
+  Ed25519SCtx sctx;
+  Byte sec[32], pub[32], msg[2], sig[64], exp[64], buf[ED25519_SCTXBYTES];
+  size_t mlen, j;
+  int numtv = 0, wrongtv = 0, i, err, acc;
+  
+  printf("Testing ed25519_sign_ctx() with test-vectors from RFC 8032 ...\n");
+  
+  for (i = 0; i < NUMVALID; i++) {
+    bytes_from_hex(sec, tvsec[i]);
+    bytes_from_hex(pub, tvpub[i]);
+    mlen = bytes_from_hex(msg, tvmsg[i]);
+    bytes_from_hex(exp, tvsig[i]);
+    err = ed25519_sign_ctx_init(&sctx, sec, NULL);
+    if (memcmp(sctx.pk, pub, 32) != 0) err = -1;
+    ed25519_sign_ctx_store(buf, &sctx);
+    ed25519_sign_ctx_wipe(&sctx);
+    if (err == M25519_NO_ERROR) err = ed25519_sign_ctx_load(&sctx, buf);
+    if (err == M25519_NO_ERROR) err = ed25519_sign_ctx(sig, msg, mlen, &sctx);
+    if ((err != M25519_NO_ERROR) || (memcmp(sig, exp, 64) != 0)) {
+      printf("Testvector verification failed !!!\n");
+      printf("Exp Result: %i\n", M25519_NO_ERROR);
+      printf("Act Result: %i\n", (err != M25519_NO_ERROR) ? err : -1);
+      wrongtv++;
+    }
+    numtv++;
+  }
+  
+  ed25519_sign_ctx_wipe(&sctx);
+  acc = 0;
+  for (j = 0; j < sizeof(Ed25519SCtx); j++) acc |= ((Byte *) &sctx)[j];
+  buf[0] |= 1;
+  err = ed25519_sign_ctx_load(&sctx, buf);
+  if ((acc != 0) || (err != M25519_ERR_SCALAR)) {
+    printf("Testvector verification failed !!!\n");
+    printf("Exp Result: %i\n", M25519_ERR_SCALAR);
+    printf("Act Result: %i\n", (acc != 0) ? -1 : err);
+    wrongtv++;
+  }
+  numtv++;
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+// Length of the long message and size of the parts passed to the update
+// functions in the tests of the incremental interfaces
+
+#define LONGMSG 1000
+#define PARTLEN 7
+
+static void update_in_parts(void *ctx, int sign, const Byte *m, size_t mlen)
+{
+  size_t i, n;
+  
+  for (i = 0; i < mlen; i += n) {
+    n = ((mlen - i) < PARTLEN) ? (mlen - i) : PARTLEN;
+    if (sign) ed25519_sign_update((Ed25519SStream *) ctx, &m[i], n);
+    else ed25519_verify_update((Ed25519VStream *) ctx, &m[i], n);
+  }
+}
+
+
+// The signatures of TEST 1 to TEST 3 and of a long message (with the key-pair
+// of TEST 1) are computed with the incremental interface, passing the message
+// in parts of `PARTLEN` bytes, and compared with the results of
+// `ed25519_sign`. Then it is checked that a modified message in the second
+// pass and a wrong order of the calls are detected.
+
+int test_ed25519_sign_stream(void)
+{
+  Ed25519SStream sctx;
+  Byte kp[64], msg[LONGMSG], sig[64], exp[64];
+  size_t mlen;
+  int numtv = 0, wrongtv = 0, i, err, experr;
+  
+  printf("Testing ed25519_sign_final() with test-vectors from RFC 8032 ...\n");
+  
+  for (i = 0; i < NUMVALID + 3; i++) {
+    bytes_from_hex(kp, tvsec[(i < NUMVALID) ? i : 0]);
+    bytes_from_hex(&kp[32], tvpub[(i < NUMVALID) ? i : 0]);
+    if (i < NUMVALID) {
+      mlen = bytes_from_hex(msg, tvmsg[i]);
+    } else {
+      for (mlen = 0; mlen < LONGMSG; mlen++) msg[mlen] = (Byte) (mlen*mlen);
+    }
+    ed25519_sign(exp, msg, mlen, kp);
+    experr = M25519_NO_ERROR;
+    ed25519_sign_init(&sctx, kp);
+    if (i == NUMVALID + 2) {
+      // final without commit
+      experr = M25519_ERR_STREAM;
+      memset(exp, 0, 64);
+    } else {
+      update_in_parts(&sctx, 1, msg, mlen);
+      ed25519_sign_commit(&sctx);
+      if (i == NUMVALID + 1) {
+        // second pass with a modified message
+        msg[mlen/2] ^= 1;
+        experr = M25519_ERR_STREAM;
+        memset(exp, 0, 64);
+      }
+      update_in_parts(&sctx, 1, msg, mlen);
+    }
+    err = ed25519_sign_final(&sctx, sig);
+    if ((err != experr) || (memcmp(sig, exp, 64) != 0)) {
+      printf("Testvector verification failed !!!\n");
+      printf("Exp Result: %i\n", experr);
+      printf("Act Result: %i\n", (memcmp(sig, exp, 64) == 0) ? err : -1);
+      wrongtv++;
+    }
+    numtv++;
+  }
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+// The test-vectors and a signature of a long message are verified with the
+// incremental interface, passing the message in parts of `PARTLEN` bytes.
+
+int test_ed25519_verify_stream(void)
+{
+  Ed25519VStream vctx;
+  Byte kp[64], pub[32], msg[LONGMSG], sig[64];
+  size_t mlen;
+  int numtv = 0, wrongtv = 0, i, err, experr;
+  
+  printf("Testing ed25519_verify_final() with test-vectors from RFC 8032 ...\n");
+  
+  for (i = 0; i <= NUMTV; i++) {
+    if (i < NUMTV) {
+      bytes_from_hex(pub, tvpub[i]);
+      mlen = bytes_from_hex(msg, tvmsg[i]);
+      bytes_from_hex(sig, tvsig[i]);
+      experr = tverr[i];
+    } else {
+      bytes_from_hex(kp, tvsec[0]);
+      bytes_from_hex(&kp[32], tvpub[0]);
+      for (mlen = 0; mlen < LONGMSG; mlen++) msg[mlen] = (Byte) (mlen*mlen);
+      ed25519_sign(sig, msg, mlen, kp);
+      memcpy(pub, &kp[32], 32);
+      experr = M25519_NO_ERROR;
+    }
+    ed25519_verify_init(&vctx, sig, pub);
+    update_in_parts(&vctx, 0, msg, mlen);
+    err = ed25519_verify_final(&vctx);
+    if (err != experr) {
+      printf("Testvector verification failed !!!\n");
+      printf("Exp Result: %i\n", experr);
+      printf("Act Result: %i\n", err);
+      wrongtv++;
+    }
+    numtv++;
+  }
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+#if defined(M25519_DUAL_CORE)
+
+// Emulation of the second core of a dual-core microcontroller: a job is not
+// executed when it is started, but only when the calling core waits for it,
+// so that a partial result that is used before the call of `wait` (or a
+// scalar multiplication that does not wait at all) yields a wrong result.
+
+static TedJob core1_job = NULL;
+static void *core1_arg = NULL;
+
+static void core1_run(TedJob job, void *arg)
+{
+  core1_job = job;
+  core1_arg = arg;
+}
+
+static void core1_wait(void)
+{
+  if (core1_job != NULL) core1_job(core1_arg);
+  core1_job = NULL;
+}
+
+
+// The scalar multiplications, the verification of signatures, and signing are
+// tested with the emulated second core registered via `ted_set_core1`.
+
+int test_ted_dual_core(void)
+{
+  int numtv;
+  
+  printf("Testing dual-core split with emulated second core ...\n");
+  
+  ted_set_core1(core1_run, core1_wait);
+  numtv = test_ted_mul_fixbase();
+  numtv += test_ted_mul_varbase();
+  numtv += test_ed25519_verify();
+  numtv += test_ed25519_verify_ctx();
+  numtv += test_ed25519_sign();
+  ted_set_core1(NULL, NULL);
+  
+  return numtv;
+}
+
+#endif
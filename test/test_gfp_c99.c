@@ -22,6 +22,9 @@
 #include <string.h>
 #include "../src/mpiarith.h"
 #include "../src/gfparith.h"
+#include "../src/gfparith4.h"
+#include "../src/moncurve.h"
+#include "../src/ed25519.h"
 
 
 // Length of a line to be read from test-vector file
@@ -174,6 +177,104 @@ int test_gfp_sub(const char *tvname)
 }
 
 
+// The non-reducing functions `gfp_add_nr` and `gfp_sub_nr` require bounded
+// (e.g., fully reduced) operands, i.e., they must only be tested with the
+// pseudo-random test-vectors (files `*_pr.tv`) and not with the corner-case
+// test-vectors, which contain operands of up to 256 bits.
+
+
+int test_gfp_add_nr(const char *tvname)
+{
+  FILE *tvfile;
+  Word op1[LEN], op2[LEN], res[LEN];
+  int numtv = 0, wrongtv = 0;
+  char buffer[4*MAXLINE];
+  char *o1c = &(buffer[MAXLINE]);
+  char *o2c = &(buffer[2*MAXLINE]);
+  char *exp = &(buffer[3*MAXLINE]);
+  char *rval;  // for error checks
+  
+  tvfile = fopen(tvname, "r");
+  if (tvfile == NULL) {
+    printf("Test-vector file %s can not be openend!\n", tvname);
+    return M25519_ERR_TVFILE;
+  }
+  printf("Testing gfp_add_nr() with test-vector file %s ...\n", tvname);
+  
+  buffer[4*MAXLINE-1] = '\0';
+  rval = fgets(buffer, MAXLINE, tvfile);
+  if (rval == NULL) return M25519_ERR_TVFILE;
+  buffer[strcspn(buffer, "\r\n")] = '\0';
+  rval = strstr(buffer, "Addition");
+  if (rval == NULL) printf("Incorrect test-vector file!\n");
+  
+  while (rval != NULL) {
+    // get next testvector from tv-file
+    rval = get_vector(buffer, tvfile);
+    if (rval == NULL) break;
+    // extract operands from testvector
+    mpi_from_hex(op1, &(buffer[1*MAXLINE]), LEN);
+    mpi_from_hex(op2, &(buffer[2*MAXLINE]), LEN);
+    // execute the arithmetic operation
+    gfp_add_nr(res, op1, op2);
+    // check result and report mismatch
+    wrongtv += chk_vector(o1c, o2c, exp, res);
+    numtv++;
+  }
+  fclose(tvfile);
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+int test_gfp_sub_nr(const char *tvname)
+{
+  FILE *tvfile;
+  Word op1[LEN], op2[LEN], res[LEN];
+  int numtv = 0, wrongtv = 0;
+  char buffer[4*MAXLINE];
+  char *o1c = &(buffer[MAXLINE]);
+  char *o2c = &(buffer[2*MAXLINE]);
+  char *exp = &(buffer[3*MAXLINE]);
+  char *rval;  // for error checks
+  
+  tvfile = fopen(tvname, "r");
+  if (tvfile == NULL) {
+    printf("Test-vector file %s can not be openend!\n", tvname);
+    return M25519_ERR_TVFILE;
+  }
+  printf("Testing gfp_sub_nr() with test-vector file %s ...\n", tvname);
+  
+  buffer[4*MAXLINE-1] = '\0';
+  rval = fgets(buffer, MAXLINE, tvfile);
+  if (rval == NULL) return M25519_ERR_TVFILE;
+  buffer[strcspn(buffer, "\r\n")] = '\0';
+  rval = strstr(buffer, "Subtraction");
+  if (rval == NULL) printf("Incorrect test-vector file!\n");
+
+  while (rval != NULL) {
+    // get next testvector from tv-file
+    rval = get_vector(buffer, tvfile);
+    if (rval == NULL) break;
+    // extract operands from testvector
+    mpi_from_hex(op1, &(buffer[1*MAXLINE]), LEN);
+    mpi_from_hex(op2, &(buffer[2*MAXLINE]), LEN);
+    // execute the arithmetic operation
+    gfp_sub_nr(res, op1, op2);
+    // check result and report mismatch
+    wrongtv += chk_vector(o1c, o2c, exp, res);
+    numtv++;
+  }
+  fclose(tvfile);
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
 int test_gfp_mul(const char *tvname)
 {
   FILE *tvfile;
@@ -308,6 +409,60 @@ int test_gfp_sqr(const char *tvname)
 }
 
 
+int test_gfp_sqrn(const char *tvname)
+{
+  FILE *tvfile;
+  Word op1[LEN], res[LEN], ref[LEN];
+  int numtv = 0, wrongtv = 0, i, n;
+  char buffer[4*MAXLINE];
+  char *o1c = &(buffer[MAXLINE]);
+  char *exp = &(buffer[3*MAXLINE]);
+  char refc[MAXLINE];
+  char *rval;  // for error checks
+  
+  tvfile = fopen(tvname, "r");
+  if (tvfile == NULL) {
+    printf("Test-vector file %s can not be openend!\n", tvname);
+    return M25519_ERR_TVFILE;
+  }
+  printf("Testing gfp_sqrn() with test-vector file %s ...\n", tvname);
+  
+  buffer[4*MAXLINE-1] = '\0';
+  rval = fgets(buffer, MAXLINE, tvfile);
+  if (rval == NULL) return M25519_ERR_TVFILE;
+  buffer[strcspn(buffer, "\r\n")] = '\0';
+  rval = strstr(buffer, "Squaring");
+  if (rval == NULL) printf("Incorrect test-vector file!\n");
+
+  while (rval != NULL) {
+    // get next testvector from tv-file
+    rval = get_vector(buffer, tvfile);
+    if (rval == NULL) break;
+    // extract operands from testvector
+    mpi_from_hex(op1, &(buffer[1*MAXLINE]), LEN);
+    // execute the arithmetic operation with n = 1
+    gfp_sqrn(res, op1, 1);
+    // check result and report mismatch
+    wrongtv += chk_vector(o1c, NULL, exp, res);
+    // execute the arithmetic operation with n in [0, 7] and compare the
+    // result with that of n calls of `gfp_sqr`
+    n = numtv & 7;
+    gfp_sqrn(res, op1, n);
+    mpi_copy(ref, op1, LEN);
+    for (i = 0; i < n; i++) gfp_sqr(ref, ref);
+    gfp_fred(ref, ref);
+    mpi_to_hex(refc, ref, LEN);
+    wrongtv += chk_vector(o1c, NULL, refc, res);
+    numtv++;
+  }
+  fclose(tvfile);
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
 int test_gfp_hlv(const char *tvname)
 {
   FILE *tvfile;
@@ -394,3 +549,308 @@ int test_gfp_cneg(const char *tvname)
   printf("%i test-vectors wrong\n", wrongtv);
   return numtv;
 }
+
+
+int test_gfp_inv(const char *tvname)
+{
+  FILE *tvfile;
+  Word op1[LEN], res[LEN];
+  int numtv = 0, wrongtv = 0;
+  char buffer[4*MAXLINE];
+  char *o1c = &(buffer[MAXLINE]);
+  char *exp = &(buffer[3*MAXLINE]);
+  char *rval;  // for error checks
+  
+  tvfile = fopen(tvname, "r");
+  if (tvfile == NULL) {
+    printf("Test-vector file %s can not be openend!\n", tvname);
+    return M25519_ERR_TVFILE;
+  }
+  printf("Testing gfp_inv() with test-vector file %s ...\n", tvname);
+  
+  buffer[4*MAXLINE-1] = '\0';
+  rval = fgets(buffer, MAXLINE, tvfile);
+  if (rval == NULL) return M25519_ERR_TVFILE;
+  buffer[strcspn(buffer, "\r\n")] = '\0';
+  rval = strstr(buffer, "Inversion");
+  if (rval == NULL) printf("Incorrect test-vector file!\n");
+
+  while (rval != NULL) {
+    // get next testvector from tv-file
+    rval = get_vector(buffer, tvfile);
+    if (rval == NULL) break;
+    // extract operands from testvector
+    mpi_from_hex(op1, &(buffer[1*MAXLINE]), LEN);
+    // execute the arithmetic operation
+    gfp_inv(res, op1);
+    // check result and report mismatch
+    wrongtv += chk_vector(o1c, NULL, exp, res);
+    numtv++;
+  }
+  fclose(tvfile);
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+// Number of field-elements inverted simultaneously by `gfp_inv_batch`
+
+#define NUMBATCH 8
+
+
+int test_gfp_inv_batch(const char *tvname)
+{
+  FILE *tvfile;
+  Word op1[NUMBATCH*LEN], res[NUMBATCH*LEN], scratch[NUMBATCH*LEN];
+  int numtv = 0, wrongtv = 0, i, n;
+  char buffer[4*MAXLINE];
+  char expb[NUMBATCH][MAXLINE];
+  char *exp = &(buffer[3*MAXLINE]);
+  char *rval;  // for error checks
+  
+  tvfile = fopen(tvname, "r");
+  if (tvfile == NULL) {
+    printf("Test-vector file %s can not be openend!\n", tvname);
+    return M25519_ERR_TVFILE;
+  }
+  printf("Testing gfp_inv_batch() with test-vector file %s ...\n", tvname);
+  
+  buffer[4*MAXLINE-1] = '\0';
+  rval = fgets(buffer, MAXLINE, tvfile);
+  if (rval == NULL) return M25519_ERR_TVFILE;
+  buffer[strcspn(buffer, "\r\n")] = '\0';
+  rval = strstr(buffer, "Inversion");
+  if (rval == NULL) printf("Incorrect test-vector file!\n");
+
+  while (rval != NULL) {
+    // get up to NUMBATCH testvectors from tv-file
+    for (n = 0; n < NUMBATCH; n++) {
+      rval = get_vector(buffer, tvfile);
+      if (rval == NULL) break;
+      // extract operands from testvector
+      mpi_from_hex(&op1[n*LEN], &(buffer[1*MAXLINE]), LEN);
+      strcpy(expb[n], exp);
+    }
+    if (n == 0) break;
+    // execute the arithmetic operation
+    gfp_inv_batch(res, op1, n, scratch);
+    // check results and report mismatch
+    for (i = 0; i < n; i++) {
+      wrongtv += chk_vector(NULL, NULL, expb[i], &res[i*LEN]);
+      numtv++;
+    }
+  }
+  fclose(tvfile);
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+// Test of the four-way parallel functions `gfp4_*` with the test-vector files
+// of the corresponding scalar functions, whereby the operation is determined
+// from the headline of the file. Up to four test-vectors are packed into one
+// vector and unused lanes are filled with zero.
+
+int test_gfp4(const char *tvname)
+{
+  FILE *tvfile;
+  Word op1[NUMLANES*LEN], op2[NUMLANES*LEN], res[NUMLANES*LEN];
+  Word va[LEN4], vb[LEN4], vr[LEN4], m32[1] = { 121666 };
+  int numtv = 0, wrongtv = 0, i, n, op;
+  char buffer[4*MAXLINE];
+  char expb[NUMLANES][MAXLINE];
+  char *exp = &(buffer[3*MAXLINE]);
+  char *rval;  // for error checks
+  const char *opname[6] = { "Addition", "Subtraction", \
+    "Multiplication (32 bit)", "Multiplication", "Squaring", "Negation" };
+  
+  tvfile = fopen(tvname, "r");
+  if (tvfile == NULL) {
+    printf("Test-vector file %s can not be openend!\n", tvname);
+    return M25519_ERR_TVFILE;
+  }
+  printf("Testing gfp4 functions with test-vector file %s ...\n", tvname);
+  
+  buffer[4*MAXLINE-1] = '\0';
+  rval = fgets(buffer, MAXLINE, tvfile);
+  if (rval == NULL) return M25519_ERR_TVFILE;
+  buffer[strcspn(buffer, "\r\n")] = '\0';
+  for (op = 0; op < 6; op++) {
+    rval = strstr(buffer, opname[op]);
+    if (rval != NULL) break;
+  }
+  if (rval == NULL) printf("Incorrect test-vector file!\n");
+
+  while (rval != NULL) {
+    // get up to NUMLANES testvectors from tv-file
+    memset(op1, 0, sizeof(op1));
+    memset(op2, 0, sizeof(op2));
+    for (n = 0; n < NUMLANES; n++) {
+      rval = get_vector(buffer, tvfile);
+      if (rval == NULL) break;
+      // extract operands from testvector
+      mpi_from_hex(&op1[n*LEN], &(buffer[1*MAXLINE]), LEN);
+      if ((op < 2) || (op == 3))
+        mpi_from_hex(&op2[n*LEN], &(buffer[2*MAXLINE]), LEN);
+      strcpy(expb[n], exp);
+    }
+    if (n == 0) break;
+    // execute the arithmetic operation
+    gfp4_pack(va, op1);
+    gfp4_pack(vb, op2);
+    switch (op) {
+      case 0: gfp4_add(vr, va, vb); break;
+      case 1: gfp4_sub(vr, va, vb); break;
+      case 2: gfp4_mul32(vr, va, m32); break;
+      case 3: gfp4_mul(vr, va, vb); break;
+      case 4: gfp4_sqr(vr, va); break;
+      default: gfp4_cneg(vr, va, 0xA); break;  // lanes 1 and 3
+    }
+    gfp4_unpack(res, vr);
+    // check results and report mismatch
+    for (i = 0; i < n; i++) {
+      wrongtv += chk_vector(NULL, NULL, expb[i], &res[i*LEN]);
+      numtv++;
+    }
+  }
+  fclose(tvfile);
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+#if defined(M25519_OPSTBL)
+
+// Faulty multiplication kernel (the LSB of the result is flipped) to check
+// that kernels failing the known-answer test are not installed
+
+static void gfp_mul_faulty(Word *r, const Word *a, const Word *b)
+{
+  m25519_ops_c99.mul(r, a, b);
+  r[0] ^= 1;
+}
+
+
+// Pseudo timer-function that advances by one on each call, i.e., all kernels
+// appear to be equally fast and the later backend in the list is preferred
+
+static uint32_t fake_timer(void)
+{
+  static uint32_t ticks = 0;
+  
+  return ++ticks;
+}
+
+
+// Test of the run-time selection of the kernels in ops-table mode, followed
+// by a test of the installed `gfp_mul` kernel with a test-vector file
+
+int test_backend(const char *tvname)
+{
+  ArithOps faulty = { "faulty", NULL, NULL, NULL, NULL, gfp_mul_faulty, \
+    NULL, NULL };
+  const ArithOps *list[2];
+  int numtv = 0, wrongtv = 0;
+  
+  printf("Testing m25519_select_backend() ...\n");
+  list[0] = &m25519_ops_c99;
+  list[1] = &faulty;
+  // the faulty kernel must be rejected and the C kernel installed instead
+  if (m25519_select_backend(list, 2, fake_timer) != M25519_ERR_BACKEND)
+    wrongtv++;
+  wrongtv += (m25519_ops.mul == gfp_mul_faulty);
+  wrongtv += (strcmp(m25519_backend_name(M25519_KRN_MUL), "c99") != 0);
+  numtv += 3;
+  // the same applies to the direct installation of a backend
+  wrongtv += (m25519_set_backend(&faulty) != M25519_ERR_BACKEND);
+  wrongtv += (m25519_ops.mul == gfp_mul_faulty);
+  numtv += 2;
+  // the built-in backends pass the test (the last one is installed)
+  wrongtv += (m25519_select_backend(NULL, 0, NULL) != M25519_NO_ERROR);
+  wrongtv += (m25519_backend_name(M25519_KRN_NUM) != NULL);
+  numtv += 2;
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  if (wrongtv > 0) return M25519_ERR_BACKEND;
+  
+  return test_gfp_mul(tvname);
+}
+
+#endif // #if defined(M25519_OPSTBL)
+
+
+#if defined(M25519_PROFILE)
+
+// Test of the operation counters with a fixed sequence of operations; a call
+// of `gfp_sqrn` has to increment the counter of `gfp_sqrn` by one and that of
+// `gfp_sqr` by `n`, irrespective of whether the C or ASM version is used
+
+int test_profile(void)
+{
+  Word a[LEN], res[LEN], ref[LEN], xz[4*LEN];
+  const Word a24[1] = { 121666 };
+  int numtv = 0, wrongtv = 0, i;
+  
+  printf("Testing the operation counters ...\n");
+  for (i = 0; i < LEN; i++) a[i] = 0x9E3779B9UL*(i + 1);
+  a[LEN-1] &= 0x7FFFFFFFUL;
+  m25519_prof_reset();
+  gfp_sqrn(res, a, 5);
+  gfp_sqrn(res, res, 0);
+  gfp_sqrn(res, res, 1);
+  gfp_sqr(res, res);
+  gfp_mul(res, res, a);
+  for (i = 0; i < M25519_PROF_NUM; i++) {
+    switch (i) {
+      case M25519_PROF_GFP_SQRN: wrongtv += (m25519_prof_get(i) != 3); break;
+      case M25519_PROF_GFP_SQR:  wrongtv += (m25519_prof_get(i) != 7); break;
+      case M25519_PROF_GFP_MUL:  wrongtv += (m25519_prof_get(i) != 1); break;
+      default: wrongtv += (m25519_prof_get(i) != 0);
+    }
+    numtv++;
+  }
+  // the result must be $a^{2^7+1}$
+  mpi_copy(ref, a, LEN);
+  for (i = 0; i < 7; i++) gfp_sqr(ref, ref);
+  gfp_mul(ref, ref, a);
+  wrongtv += (gfp_cmp(res, ref) != 0);
+  numtv++;
+  // a ladder step and a reduction modulo the group order are counted like the
+  // C versions, irrespective of whether an Assembly version is used or not
+  m25519_prof_reset();
+  mpi_copy(xz, a, LEN); mpi_copy(&xz[LEN], ref, LEN);
+  mpi_copy(&xz[2*LEN], res, LEN); mpi_copy(&xz[3*LEN], a, LEN);
+  mon_ladder_step(xz, a, a24, 1);
+  ed25519_mod_order(res, xz, &ECDOMPAR25519);
+  for (i = 0; i < M25519_PROF_NUM; i++) {
+    switch (i) {
+      case M25519_PROF_GFP_ADD:   wrongtv += (m25519_prof_get(i) != 4); break;
+      case M25519_PROF_GFP_SUB:   wrongtv += (m25519_prof_get(i) != 4); break;
+      case M25519_PROF_GFP_MUL:   wrongtv += (m25519_prof_get(i) != 5); break;
+      case M25519_PROF_GFP_SQR:   wrongtv += (m25519_prof_get(i) != 4); break;
+      case M25519_PROF_GFP_MUL32: wrongtv += (m25519_prof_get(i) != 1); break;
+      case M25519_PROF_MPI_MUL9:  wrongtv += (m25519_prof_get(i) != 2); break;
+      case M25519_PROF_MPI_SUB:   wrongtv += (m25519_prof_get(i) != 3); break;
+      case M25519_PROF_MON_LADDER_STEP:
+        wrongtv += (m25519_prof_get(i) != 1); break;
+      default: wrongtv += (m25519_prof_get(i) != 0);
+    }
+    numtv++;
+  }
+  m25519_prof_reset();
+  wrongtv += (m25519_prof_get(M25519_PROF_GFP_SQR) != 0);
+  numtv++;
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+#endif // #if defined(M25519_PROFILE)
@@ -0,0 +1,260 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_mpi_c99.c: Unit tests for MPI multiplication and order reduction.    //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdio.h>
+#include <string.h>
+#include "../src/mpiarith.h"
+#include "../src/tedcurve.h"
+#include "../src/ed25519.h"
+
+
+// Length of a line to be read from test-vector file
+
+#define MAXLINE 160
+
+
+static char *get_vector(char *buffer, FILE *tvfile)
+{
+  char *op1 = &(buffer[MAXLINE]);
+  char *op2 = &(buffer[2*MAXLINE]);
+  char *exp = &(buffer[3*MAXLINE]);
+  char *rval;  // for error checks
+  int i;
+  
+  op1[0] = op2[0] = exp[0] = '\0';
+  
+  for (i = 0; i < 3; i++) {
+    rval = fgets(buffer, MAXLINE, tvfile);
+    if (rval == NULL) return NULL;
+    buffer[strcspn(buffer, "\r\n")] = '\0';
+    if (strstr(buffer, "op1:") != NULL) {
+      strcpy(op1, &(buffer[5]));
+      continue;
+    }
+    if (strstr(buffer, "op2:") != NULL) {
+      strcpy(op2, &(buffer[5]));
+      continue;
+    }
+    if (strstr(buffer, "res:") != NULL) {
+      strcpy(exp, &(buffer[5]));
+      return buffer;
+    }
+  }
+  return buffer;
+}
+
+
+// In contrast to the test of the GF(p) arithmetic, the result is compared as
+// it is (i.e., without a final reduction), and it has a length of `len` words
+
+static int chk_vector(const char *op1, const char *op2, const char *exp, \
+  const Word *res, int len)
+{
+  char buf[MAXLINE];
+  int wrong = 0;
+  
+  mpi_to_hex(buf, res, len);
+  
+  if (strcmp(exp, buf) != 0) {
+    printf("Testvector verification failed !!!\n");
+    if (op1 != NULL) printf("Operand #1: %s\n", op1);
+    if (op2 != NULL) printf("Operand #2: %s\n", op2);
+    printf("Exp Result: %s\n", exp);
+    printf("Act Result: %s\n", buf);
+    wrong = 1;
+  }
+  
+  return wrong;
+}
+
+
+int test_mpi_mul8(const char *tvname)
+{
+  FILE *tvfile;
+  Word op1[LEN], op2[LEN], res[2*LEN];
+  int numtv = 0, wrongtv = 0;
+  char buffer[4*MAXLINE];
+  char *o1c = &(buffer[MAXLINE]);
+  char *o2c = &(buffer[2*MAXLINE]);
+  char *exp = &(buffer[3*MAXLINE]);
+  char *rval;  // for error checks
+  
+  tvfile = fopen(tvname, "r");
+  if (tvfile == NULL) {
+    printf("Test-vector file %s can not be openend!\n", tvname);
+    return M25519_ERR_TVFILE;
+  }
+  printf("Testing mpi_mul8() with test-vector file %s ...\n", tvname);
+  
+  buffer[4*MAXLINE-1] = '\0';
+  rval = fgets(buffer, MAXLINE, tvfile);
+  if (rval == NULL) return M25519_ERR_TVFILE;
+  buffer[strcspn(buffer, "\r\n")] = '\0';
+  rval = strstr(buffer, "8-Word Multiplication");
+  if (rval == NULL) printf("Incorrect test-vector file!\n");
+  
+  while (rval != NULL) {
+    // get next testvector from tv-file
+    rval = get_vector(buffer, tvfile);
+    if (rval == NULL) break;
+    // extract operands from testvector
+    mpi_from_hex(op1, &(buffer[1*MAXLINE]), LEN);
+    mpi_from_hex(op2, &(buffer[2*MAXLINE]), LEN);
+    // execute the arithmetic operation
+    mpi_mul8(res, op1, op2);
+    // check result and report mismatch
+    wrongtv += chk_vector(o1c, o2c, exp, res, 2*LEN);
+    numtv++;
+  }
+  fclose(tvfile);
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+int test_mpi_mul9(const char *tvname)
+{
+  FILE *tvfile;
+  Word op1[LEN+1], op2[LEN+1], res[2*(LEN+1)];
+  int numtv = 0, wrongtv = 0;
+  char buffer[4*MAXLINE];
+  char *o1c = &(buffer[MAXLINE]);
+  char *o2c = &(buffer[2*MAXLINE]);
+  char *exp = &(buffer[3*MAXLINE]);
+  char *rval;  // for error checks
+  
+  tvfile = fopen(tvname, "r");
+  if (tvfile == NULL) {
+    printf("Test-vector file %s can not be openend!\n", tvname);
+    return M25519_ERR_TVFILE;
+  }
+  printf("Testing mpi_mul9() with test-vector file %s ...\n", tvname);
+  
+  buffer[4*MAXLINE-1] = '\0';
+  rval = fgets(buffer, MAXLINE, tvfile);
+  if (rval == NULL) return M25519_ERR_TVFILE;
+  buffer[strcspn(buffer, "\r\n")] = '\0';
+  rval = strstr(buffer, "9-Word Multiplication");
+  if (rval == NULL) printf("Incorrect test-vector file!\n");
+  
+  while (rval != NULL) {
+    // get next testvector from tv-file
+    rval = get_vector(buffer, tvfile);
+    if (rval == NULL) break;
+    // extract operands from testvector
+    mpi_from_hex(op1, &(buffer[1*MAXLINE]), LEN + 1);
+    mpi_from_hex(op2, &(buffer[2*MAXLINE]), LEN + 1);
+    // execute the arithmetic operation
+    mpi_mul9(res, op1, op2);
+    // check result and report mismatch
+    wrongtv += chk_vector(o1c, o2c, exp, res, 2*(LEN+1));
+    numtv++;
+  }
+  fclose(tvfile);
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+int test_ed25519_mod_order(const char *tvname)
+{
+  FILE *tvfile;
+  Word op1[2*LEN], res[LEN];
+  int numtv = 0, wrongtv = 0;
+  char buffer[4*MAXLINE];
+  char *o1c = &(buffer[MAXLINE]);
+  char *exp = &(buffer[3*MAXLINE]);
+  char *rval;  // for error checks
+  
+  tvfile = fopen(tvname, "r");
+  if (tvfile == NULL) {
+    printf("Test-vector file %s can not be openend!\n", tvname);
+    return M25519_ERR_TVFILE;
+  }
+  printf("Testing ed25519_mod_order() with test-vector file %s ...\n", tvname);
+  
+  buffer[4*MAXLINE-1] = '\0';
+  rval = fgets(buffer, MAXLINE, tvfile);
+  if (rval == NULL) return M25519_ERR_TVFILE;
+  buffer[strcspn(buffer, "\r\n")] = '\0';
+  rval = strstr(buffer, "modulo Order");
+  if (rval == NULL) printf("Incorrect test-vector file!\n");
+  
+  while (rval != NULL) {
+    // get next testvector from tv-file
+    rval = get_vector(buffer, tvfile);
+    if (rval == NULL) break;
+    // extract operands from testvector
+    mpi_from_hex(op1, &(buffer[1*MAXLINE]), 2*LEN);
+    // execute the arithmetic operation
+    ed25519_mod_order(res, op1, &ECDOMPAR25519);
+    // check result and report mismatch
+    wrongtv += chk_vector(o1c, NULL, exp, res, LEN);
+    numtv++;
+  }
+  fclose(tvfile);
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+// The table for `mpi_select` is filled with pseudo-random words, and every
+// entry is selected once and compared with the table; no test-vector file is
+// needed. The tested dimensions correspond to the look-ups of `ted_load_point`
+// (entries of 24 words) and of the window methods (entries of 40 words).
+
+int test_mpi_select(void)
+{
+  Word tbl[16*5*LEN], res[5*LEN+1];
+  uint32_t x = 0x12345678UL;
+  int num[2] = { 16, 8 }, len[2] = { 3*LEN, 5*LEN };
+  int numtv = 0, wrongtv = 0, i, j, k;
+  
+  printf("Testing mpi_select() with pseudo-random tables ...\n");
+  
+  for (k = 0; k < 2; k++) {
+    for (i = 0; i < num[k]*len[k]; i++) {
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      tbl[i] = (Word) x;
+    }
+    for (i = 0; i < num[k]; i++) {
+      res[len[k]] = 0xDEADBEEFUL;  // must not be overwritten
+      mpi_select(res, tbl, i, num[k], len[k]);
+      for (j = 0; j < len[k]; j++) if (res[j] != tbl[i*len[k]+j]) break;
+      if ((j != len[k]) || (res[len[k]] != 0xDEADBEEFUL)) {
+        printf("Selection of entry %i of %i failed !!!\n", i, num[k]);
+        wrongtv++;
+      }
+      numtv++;
+    }
+  }
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
@@ -0,0 +1,312 @@
+///////////////////////////////////////////////////////////////////////////////
+// test_x25519_c99.c: Unit tests for C99 implementation of batch X25519.     //
+// This file is part of Micro25519, a lightweight implementation of X25519   //
+// key exchange and Ed25519 signatures for 8/16/32-bit microcontrollers.     //
+// Version 1.0.0 (13-06-25), see <http://github.com/johgrolux/> for updates. //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Author: Johann Groszschaedl (in personal capacity).                       //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdio.h>
+#include <string.h>
+#include "../src/mpiarith.h"
+#include "../src/gfparith.h"
+#include "../src/moncurve.h"
+#include "../src/tedcurve.h"
+#include "../src/x25519.h"
+
+
+// Length of a hex-string of 32 bytes (including the terminating '\0')
+
+#define HEXLEN 65
+
+// Number of test-vectors; the last two have a public key of low order
+
+#define NUMTV 7
+
+// Private keys, public keys and shared secrets (in little-Endian order) from
+// RFC 7748 (Section 5.2 and Section 6.1)
+
+static const char *tvpriv[NUMTV] = {
+  "a546e36bf0527c9d3b16154b82465edd62144c0ac1fc5a18506a2244ba449ac4",
+  "4b66e9d4d1b4673c5ad22691957d6af5c11b6421e0ea01d42ca4169e7918ba0d",
+  "77076d0a7318a57d3c16c17251b26645df4c2f87ebc0992ab177fba51db92c2a",
+  "5dab087e624a8a4b79e17f8b83800ee66f3bb1292618b6fd1c2f8b27ff88e0eb",
+  "77076d0a7318a57d3c16c17251b26645df4c2f87ebc0992ab177fba51db92c2a",
+  "77076d0a7318a57d3c16c17251b26645df4c2f87ebc0992ab177fba51db92c2a",
+  "5dab087e624a8a4b79e17f8b83800ee66f3bb1292618b6fd1c2f8b27ff88e0eb"
+};
+
+static const char *tvpub[NUMTV] = {
+  "e6db6867583030db3594c1a424b15f7c726624ec26b3353b10a903a6d0ab1c4c",
+  "e5210f12786811d3f4b7959d0538ae2c31dbe7106fc03c3efc4cd549c715a493",
+  "0900000000000000000000000000000000000000000000000000000000000000",
+  "0900000000000000000000000000000000000000000000000000000000000000",
+  "de9edb7d7b7dc1b4d35b61c2ece435373f8343c85b78674dadfc7e146f882b4f",
+  "0000000000000000000000000000000000000000000000000000000000000000",
+  "0100000000000000000000000000000000000000000000000000000000000000"
+};
+
+static const char *tvsec[NUMTV] = {
+  "c3da55379de9c6908e94ea4df28d084f32eccf03491c71f754b4075577a28552",
+  "95cbde9476e8907d7aade45cb4b873f88b595a68799fa152e6f8f7647aac7957",
+  "8520f0098930a754748b7ddcb43ef75a0dbf3a0d26381af4eba4a98eaa9b4e6a",
+  "de9edb7d7b7dc1b4d35b61c2ece435373f8343c85b78674dadfc7e146f882b4f",
+  "4a5d9d5ba4ce2de1728e3bf480350f25e07e21c947d19e3376f09b3c1e161742",
+  "0000000000000000000000000000000000000000000000000000000000000000",
+  "0000000000000000000000000000000000000000000000000000000000000000"
+};
+
+
+static void bytes_from_hex(Byte *r, const char *hexstr)
+{
+  unsigned int val;
+  int i;
+  
+  for (i = 0; i < 32; i++) {
+    sscanf(&hexstr[2*i], "%2x", &val);
+    r[i] = (Byte) val;
+  }
+}
+
+
+static void bytes_to_hex(char *hexstr, const Byte *a)
+{
+  int i;
+  
+  for (i = 0; i < 32; i++) sprintf(&hexstr[2*i], "%02x", a[i]);
+}
+
+
+// The test-vectors are repeated several times so that the batch consists of
+// more than `X25519_MAXBATCH` entries and the last group of ladders does not
+// fill all lanes of a vector when `M25519_SIMD` is defined.
+
+int test_x25519_batch(void)
+{
+  Byte priv[3*NUMTV][32], pub[3*NUMTV][32], sec[3*NUMTV][32];
+  Byte *shared[3*NUMTV];
+  const Byte *sk[3*NUMTV], *pk[3*NUMTV];
+  int err[3*NUMTV];
+  int numtv = 0, wrongtv = 0, i, experr;
+  char buf[HEXLEN];
+  
+  printf("Testing x25519_batch() with test-vectors from RFC 7748 ...\n");
+  
+  for (i = 0; i < 3*NUMTV; i++) {
+    bytes_from_hex(priv[i], tvpriv[i % NUMTV]);
+    bytes_from_hex(pub[i], tvpub[i % NUMTV]);
+    sk[i] = priv[i];
+    pk[i] = pub[i];
+    shared[i] = sec[i];
+  }
+  
+  x25519_batch(shared, sk, pk, 3*NUMTV, err);
+  
+  for (i = 0; i < 3*NUMTV; i++) {
+    bytes_to_hex(buf, sec[i]);
+    experr = ((i % NUMTV) >= NUMTV - 2) ? M25519_ERR_MPOINT : M25519_NO_ERROR;
+    if ((strcmp(buf, tvsec[i % NUMTV]) != 0) || (err[i] != experr)) {
+      printf("Testvector verification failed !!!\n");
+      printf("Exp Result: %s (error %i)\n", tvsec[i % NUMTV], experr);
+      printf("Act Result: %s (error %i)\n", buf, err[i]);
+      wrongtv++;
+    }
+    numtv++;
+  }
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+// The private keys of Alice and Bob from RFC 7748 (Section 6.1) are used as
+// "random bytes" for the key-pair pool, i.e., the public keys must be equal to
+// the shared secrets of test-vectors 2 and 3 (for which the public key is the
+// base point). The pool is refilled more often than it has slots, and it is
+// checked that an empty pool is detected and that all slots are wiped.
+
+int test_x25519_pool(void)
+{
+  X25519Pool pool;
+  Byte rbytes[32], priv[32], pub[32];
+  int numtv = 0, wrongtv = 0, i, j, idx, err, acc;
+  char buf[HEXLEN];
+  
+  printf("Testing x25519_pool_take() with test-vectors from RFC 7748 ...\n");
+  
+  x25519_pool_init(&pool);
+  for (i = 0; i <= X25519_POOLSIZE; i++) {
+    bytes_from_hex(rbytes, tvpriv[2 + (i % 2)]);
+    x25519_pool_refill(&pool, rbytes);
+  }
+  
+  for (i = 0; i <= X25519_POOLSIZE; i++) {
+    idx = 2 + (i % 2);
+    err = x25519_pool_take(&pool, priv, pub);
+    if (i == X25519_POOLSIZE) {
+      // pool is empty, refill it with one key-pair
+      if (err != M25519_ERR_POOLEMPTY) wrongtv++;
+      bytes_from_hex(rbytes, tvpriv[idx]);
+      x25519_pool_refill(&pool, rbytes);
+      err = x25519_pool_take(&pool, priv, pub);
+    }
+    bytes_to_hex(buf, pub);
+    if ((strcmp(buf, tvsec[idx]) != 0) || (err != M25519_NO_ERROR)) {
+      printf("Testvector verification failed !!!\n");
+      printf("Exp Result: %s (error %i)\n", tvsec[idx], M25519_NO_ERROR);
+      printf("Act Result: %s (error %i)\n", buf, err);
+      wrongtv++;
+    }
+    numtv++;
+  }
+  
+  acc = x25519_pool_count(&pool);
+  for (i = 0; i < X25519_POOLSIZE; i++) {
+    for (j = 0; j < 32; j++) acc |= pool.sk[i][j] | pool.pk[i][j];
+  }
+  if (acc != 0) {
+    printf("Pool is not empty or not wiped !!!\n");
+    wrongtv++;
+  }
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+// The test-vectors are computed with the resumable functions, whereby the
+// number of ladder steps per call of `x25519_step` differs from test-vector
+// to test-vector (1 to 255). It is checked that the ladder is complete after
+// the expected number of calls and that a premature `x25519_final` is
+// rejected.
+
+int test_x25519_step(void)
+{
+  X25519Ctx ctx;
+  Byte priv[32], pub[32], sec[32];
+  int numtv = 0, wrongtv = 0, i, n, left, calls, err, experr;
+  char buf[HEXLEN];
+  
+  printf("Testing x25519_step() with test-vectors from RFC 7748 ...\n");
+  
+  for (i = 0; i < NUMTV; i++) {
+    bytes_from_hex(priv, tvpriv[i]);
+    bytes_from_hex(pub, tvpub[i]);
+    n = (i == 0) ? 1 : 1 + 42*i;
+    x25519_init(&ctx, priv, pub);
+    calls = 0;
+    do {
+      left = x25519_step(&ctx, n);
+      calls++;
+    } while (left > 0);
+    if (calls != (255 + n - 1)/n) wrongtv++;
+    err = x25519_final(sec, &ctx);
+    bytes_to_hex(buf, sec);
+    experr = (i >= NUMTV - 2) ? M25519_ERR_MPOINT : M25519_NO_ERROR;
+    if ((strcmp(buf, tvsec[i]) != 0) || (err != experr)) {
+      printf("Testvector verification failed !!!\n");
+      printf("Exp Result: %s (error %i)\n", tvsec[i], experr);
+      printf("Act Result: %s (error %i)\n", buf, err);
+      wrongtv++;
+    }
+    numtv++;
+  }
+  
+  x25519_init(&ctx, priv, pub);
+  x25519_step(&ctx, 254);
+  if (x25519_final(sec, &ctx) != M25519_ERR_STREAM) wrongtv++;
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}
+
+
+// The Montgomery ladders of the test-vectors are computed with the resumable
+// functions (the final swap is not needed since bit 0 of a pruned private key
+// is 0), and the results $[X_R, X_S, Z_R, Z_S]$, copies in the form $[X_R:
+// Z_R]$, and (artificial) projective points $[X_R:X_S:Z_R]$ are converted with
+// a single call of `mon_conv_p2a_batch` into points of dimension 2. The
+// $x$-coordinates must be the shared secrets, whereby the two points of low
+// order yield $Z_R = 0$ and thus a shared secret of 0. The $y$-coordinate must
+// be $X_S/Z_R$ for the projective points and must not be written otherwise.
+
+int test_mon_conv_p2a_batch(void)
+{
+  X25519Ctx ctx;
+  Byte priv[32], pub[32], sec[32];
+  Word xz[3*NUMTV][4*LEN], xy[3*NUMTV][2*LEN], scr[2*3*NUMTV*LEN];
+  Word y[LEN];
+  Point pts[3*NUMTV], res[3*NUMTV];
+  int numtv = 0, wrongtv = 0, i, j, err;
+  char buf[HEXLEN];
+  
+  printf("Testing mon_conv_p2a_batch() with test-vectors from RFC 7748 ...\n");
+  
+  for (i = 0; i < NUMTV; i++) {
+    bytes_from_hex(priv, tvpriv[i]);
+    bytes_from_hex(pub, tvpub[i]);
+    x25519_init(&ctx, priv, pub);
+    x25519_step(&ctx, 255);
+    mpi_copy(xz[i], ctx.xz, 4*LEN);
+    mpi_copy(xz[NUMTV+i], ctx.xz, LEN);                   // X = X_R
+    mpi_copy(&xz[NUMTV+i][LEN], &ctx.xz[2*LEN], LEN);     // Z = Z_R
+    mpi_copy(xz[2*NUMTV+i], ctx.xz, 3*LEN);               // [X_R:X_S:Z_R]
+    pts[i].dim = 4;
+    pts[NUMTV+i].dim = 2;
+    pts[2*NUMTV+i].dim = 3;
+    x25519_final(sec, &ctx);
+  }
+  for (i = 0; i < 3*NUMTV; i++) {
+    pts[i].xyz = xz[i];
+    res[i].dim = 2;
+    res[i].xyz = xy[i];
+    mpi_setw(&xy[i][LEN], 0xA5A5A5A5UL, LEN);
+  }
+  
+  err = mon_conv_p2a_batch(res, pts, 3*NUMTV, scr, &ECDOMPAR25519);
+  if (err != M25519_ERR_MPOINT) wrongtv++;
+  for (i = 0; i < 3*NUMTV; i++) {
+    for (j = 0; j < 32; j++) sec[j] = (Byte) (xy[i][j/4] >> (8*(j % 4)));
+    bytes_to_hex(buf, sec);
+    if (strcmp(buf, tvsec[i % NUMTV]) != 0) {
+      printf("Testvector verification failed !!!\n");
+      printf("Exp Result: %s\n", tvsec[i % NUMTV]);
+      printf("Act Result: %s\n", buf);
+      wrongtv++;
+    }
+    if (i < 2*NUMTV) {
+      mpi_setw(y, 0xA5A5A5A5UL, LEN);
+    } else if (gfp_inv(y, &xz[i][2*LEN]) == M25519_NO_ERROR) {
+      gfp_mul(y, y, &xz[i][LEN]);  // y = X_S/Z_R
+      gfp_fred(y, y);
+    } else {  // Z_R = 0
+      mpi_setw(y, 0, LEN);
+    }
+    if (mpi_cmp(&xy[i][LEN], y, LEN) != 0) {
+      printf("Testvector verification failed (y-coordinate) !!!\n");
+      wrongtv++;
+    }
+    numtv++;
+  }
+  err = mon_conv_p2a_batch(res, pts, NUMTV - 2, scr, &ECDOMPAR25519);
+  if (err != M25519_NO_ERROR) wrongtv++;
+  
+  printf(" -> %i test-vectors verified, ", numtv);
+  printf("%i test-vectors wrong\n", wrongtv);
+  return numtv;
+}